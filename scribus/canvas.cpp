@@ -19,6 +19,7 @@
 #include <cmath>
 
 // #include <QDebug>
+#include <QDataStream>
 #include <QToolTip>
 #include <QWidget>
 
@@ -32,9 +33,11 @@
 #include "prefsmanager.h"
 #include "scpage.h"
 #include "scpainter.h"
+#include "scrastercache.h"
 #include "scribusdoc.h"
 #include "scribusview.h"
 #include "selection.h"
+#include "text/specialchars.h"
 #include "ui/hruler.h"
 #include "ui/vruler.h"
 #include "util_math.h"
@@ -299,11 +302,11 @@ Canvas::FrameHandle Canvas::frameHitTest(QPointF canvasPoint, PageItem* item) co
 	double extraS = - item->visualLineWidth() / 2.0;
 //	if (item->lineColor() != CommonStrings::None)
 //		extraS = (item->lineWidth() / -2.0);
-	if (item->isTextFrame() && (m_doc->appMode == modeEdit) && !item->asTextFrame()->availableRegion().contains(item->getTransform().inverted().map(canvasPoint.toPoint())))
+	if (item->isTextFrame() && (m_doc->appMode == modeEdit) && !item->asTextFrame()->availableRegion().contains(item->getInverseTransform().map(canvasPoint.toPoint())))
 		return OUTSIDE;
 	QRectF visualRect = item->isLine() ? QRectF(0, extraS, item->visualWidth(), item->visualHeight()) 
 		                               : QRectF(extraS, extraS, item->visualWidth(), item->visualHeight());
-	Canvas::FrameHandle result = frameHitTest(item->getTransform().inverted().map(canvasPoint), visualRect);
+	Canvas::FrameHandle result = frameHitTest(item->getInverseTransform().map(canvasPoint), visualRect);
 //	qDebug() << "frameHitTest for item" << item->ItemNr 
 //		<< item->getTransform().inverted().map(canvasPoint) 
 //		<< item->getTransform().inverted() 
@@ -1370,79 +1373,191 @@ void Canvas::DrawMasterItems(ScPainter *painter, const ScPage *page, const ScLay
 	ScPage* Mp = m_doc->MasterPages.at(m_doc->MasterNames.value(page->masterPageName()));
 	if (((layer.blendMode != 0) || (layer.transparency != 1.0)) && (!layer.outlineMode))
 		painter->beginLayer(layer.transparency, layer.blendMode);
-	int pageFromMasterCount = page->FromMaster.count();
-	for (int a = 0; a < pageFromMasterCount; ++a)
+	if (!DrawMasterItems_Cached(painter, page, Mp, layer, cullingArea))
 	{
-		currItem = page->FromMaster.at(a);
-		if (currItem->m_layerID != layer.ID)
-			continue;
-		if ((currItem->OwnPage != -1) && (currItem->OwnPage != Mp->pageNr()))
-			continue;
-		if ((m_viewMode.previewMode) && (!currItem->printEnabled()))
-			continue;
-		if ((m_viewMode.viewAsPreview) && (!currItem->printEnabled()))
-			continue;
-		double oldX = currItem->xPos();
-		double oldY = currItem->yPos();
-		double oldBX = currItem->BoundingX;
-		double oldBY = currItem->BoundingY;
-		if (!currItem->ChangedMasterItem)
+		int pageFromMasterCount = page->FromMaster.count();
+		for (int a = 0; a < pageFromMasterCount; ++a)
 		{
-			//Hack to not check for undo changes, indicate drawing only
-			currItem->moveBy(-Mp->xOffset() + page->xOffset(), -Mp->yOffset() + page->yOffset(), true);
-			currItem->BoundingX = oldBX - Mp->xOffset() + page->xOffset();
-			currItem->BoundingY = oldBY - Mp->yOffset() + page->yOffset();
+			currItem = page->FromMaster.at(a);
+			if (!isMasterItemDrawn(currItem, Mp, layer))
+				continue;
+			DrawMasterItem(painter, currItem, page, Mp, cullingArea);
 		}
-		// Save PageItem's OwnPage and set its value to page number
-		// so that page number placed in text frames can work, also modify
-		// OwnPage of items embedded inside groups for same reason
-		currItem->savedOwnPage = currItem->OwnPage;
-		currItem->OwnPage = page->pageNr();
-		if (currItem->isGroup())
+	}
+	if (((layer.blendMode != 0) || (layer.transparency != 1.0)) && (!layer.outlineMode))
+		painter->endLayer();
+}
+
+bool Canvas::isMasterItemDrawn(const PageItem *currItem, const ScPage *masterPage, const ScLayer& layer) const
+{
+	if (currItem->m_layerID != layer.ID)
+		return false;
+	if ((currItem->OwnPage != -1) && (currItem->OwnPage != masterPage->pageNr()))
+		return false;
+	if ((m_viewMode.previewMode) && (!currItem->printEnabled()))
+		return false;
+	if ((m_viewMode.viewAsPreview) && (!currItem->printEnabled()))
+		return false;
+	return true;
+}
+
+void Canvas::DrawMasterItem(ScPainter *painter, PageItem *currItem, const ScPage *page, const ScPage *masterPage, const QRectF& cullingArea)
+{
+	double oldX = currItem->xPos();
+	double oldY = currItem->yPos();
+	double oldBX = currItem->BoundingX;
+	double oldBY = currItem->BoundingY;
+	if (!currItem->ChangedMasterItem)
+	{
+		//Hack to not check for undo changes, indicate drawing only
+		currItem->moveBy(-masterPage->xOffset() + page->xOffset(), -masterPage->yOffset() + page->yOffset(), true);
+		currItem->BoundingX = oldBX - masterPage->xOffset() + page->xOffset();
+		currItem->BoundingY = oldBY - masterPage->yOffset() + page->yOffset();
+	}
+	// Save PageItem's OwnPage and set its value to page number
+	// so that page number placed in text frames can work, also modify
+	// OwnPage of items embedded inside groups for same reason
+	currItem->savedOwnPage = currItem->OwnPage;
+	currItem->OwnPage = page->pageNr();
+	if (currItem->isGroup())
+	{
+		PageItem_Group *groupItem = currItem->asGroupFrame();
+		PageItemIterator itemIt(groupItem->groupItemList, PageItemIterator::IterateInGroups);
+		for ( ; *itemIt; ++itemIt)
 		{
-			PageItem_Group *groupItem = currItem->asGroupFrame();
-			PageItemIterator itemIt(groupItem->groupItemList, PageItemIterator::IterateInGroups);
-			for ( ; *itemIt; ++itemIt)
-			{
-				PageItem* item = *itemIt;
-				item->savedOwnPage = item->OwnPage;
-				item->OwnPage = page->pageNr();
-			}
+			PageItem* item = *itemIt;
+			item->savedOwnPage = item->OwnPage;
+			item->OwnPage = page->pageNr();
 		}
-		if (cullingArea.intersects(currItem->getBoundingRect().adjusted(0.0, 0.0, 1.0, 1.0)))
+	}
+	if (cullingArea.intersects(currItem->getBoundingRect().adjusted(0.0, 0.0, 1.0, 1.0)))
+	{
+		if (!((m_viewMode.operItemMoving) && (currItem->isSelected())))
 		{
-			if (!((m_viewMode.operItemMoving) && (currItem->isSelected())))
-			{
-				if (m_viewMode.forceRedraw)
-					currItem->invalidateLayout();
-				currItem->DrawObj(painter, cullingArea);
-				currItem->DrawObj_Decoration(painter);
-			}
-//			else 
-//				qDebug() << "skip masterpage item (move/resizeEdit/selected)" << m_viewMode.operItemMoving << currItem->isSelected();
+			if (m_viewMode.forceRedraw)
+				currItem->invalidateLayout();
+			currItem->DrawObj(painter, cullingArea);
+			currItem->DrawObj_Decoration(painter);
 		}
-		// Restore items' OwnPage including those of item embedded inside groups 
-		if (currItem->isGroup())
+//		else 
+//			qDebug() << "skip masterpage item (move/resizeEdit/selected)" << m_viewMode.operItemMoving << currItem->isSelected();
+	}
+	// Restore items' OwnPage including those of item embedded inside groups 
+	if (currItem->isGroup())
+	{
+		PageItem_Group *groupItem = currItem->asGroupFrame();
+		PageItemIterator itemIt(groupItem->groupItemList, PageItemIterator::IterateInGroups);
+		for ( ; *itemIt; ++itemIt)
 		{
-			PageItem_Group *groupItem = currItem->asGroupFrame();
-			PageItemIterator itemIt(groupItem->groupItemList, PageItemIterator::IterateInGroups);
-			for ( ; *itemIt; ++itemIt)
-			{
-				PageItem* item = *itemIt;
-				item->OwnPage = item->savedOwnPage;
-			}
+			PageItem* item = *itemIt;
+			item->OwnPage = item->savedOwnPage;
 		}
-		currItem->OwnPage = currItem->savedOwnPage;
-		if (!currItem->ChangedMasterItem)
+	}
+	currItem->OwnPage = currItem->savedOwnPage;
+	if (!currItem->ChangedMasterItem)
+	{
+		//Hack to not check for undo changes, indicate drawing only
+		currItem->setXYPos(oldX, oldY, true);
+		currItem->BoundingX = oldBX;
+		currItem->BoundingY = oldBY;
+	}
+}
+
+/**
+  returns true if drawing the item depends on the page it is drawn on,
+  i.e. it shows page numbers, page counts or marks
+ */
+static bool masterItemDependsOnPage(PageItem *currItem)
+{
+	if (currItem->isGroup())
+	{
+		PageItemIterator itemIt(currItem->asGroupFrame()->groupItemList, PageItemIterator::IterateInGroups);
+		for ( ; *itemIt; ++itemIt)
 		{
-			//Hack to not check for undo changes, indicate drawing only
-			currItem->setXYPos(oldX, oldY, true);
-			currItem->BoundingX = oldBX;
-			currItem->BoundingY = oldBY;
+			if (masterItemDependsOnPage(*itemIt))
+				return true;
 		}
-	}
-	if (((layer.blendMode != 0) || (layer.transparency != 1.0)) && (!layer.outlineMode))
-		painter->endLayer();
+		return false;
+	}
+	// Table cells may hold page numbers too, do not bother looking into them
+	if (currItem->isTable())
+		return true;
+	if (!currItem->isTextFrame() && !currItem->isPathText())
+		return false;
+	if (currItem->itemText.hasTextMarks())
+		return true;
+	QString text = currItem->itemText.plainText();
+	return text.contains(SpecialChars::PAGENUMBER) || text.contains(SpecialChars::PAGECOUNT);
+}
+
+bool Canvas::DrawMasterItems_Cached(ScPainter *painter, const ScPage *page, const ScPage *masterPage, const ScLayer& layer, const QRectF& cullingArea)
+{
+	// Catalogs typically put the same heavy master page (background images,
+	// grids, logos) under hundreds of pages. Render the master items once
+	// into a pixel aligned surface, then paint that surface for every page
+	// using the master until the document changes or the zoom changes.
+	const QTransform matrix = painter->worldMatrix();
+	if (!matrix.isInvertible())
+		return false;
+
+	QList<PageItem*> items;
+	QRectF itemsRect;
+	bool pageDependent = false;
+	int pageFromMasterCount = page->FromMaster.count();
+	for (int a = 0; a < pageFromMasterCount; ++a)
+	{
+		PageItem *currItem = page->FromMaster.at(a);
+		if (!isMasterItemDrawn(currItem, masterPage, layer))
+			continue;
+		if (currItem->ChangedMasterItem)
+			return false;
+		items.append(currItem);
+		itemsRect |= currItem->getBoundingRect().adjusted(0.0, 0.0, 1.0, 1.0);
+		pageDependent = pageDependent || masterItemDependsOnPage(currItem);
+	}
+	const double dx = page->xOffset() - masterPage->xOffset();
+	const double dy = page->yOffset() - masterPage->yOffset();
+	if (items.isEmpty() || !cullingArea.intersects(itemsRect.translated(dx, dy)))
+		return true;
+
+	// Surface placement is computed in master page coordinates so that
+	// pages showing the master at the same sub-pixel phase share one entry
+	const double dpr = painter->devicePixelRatio();
+	const QTransform masterMatrix = QTransform::fromTranslate(dx, dy) * matrix;
+	ScRasterCache::Placement surfacePlace = ScRasterCache::placement(itemsRect, masterMatrix, dpr);
+	if (surfacePlace.isEmpty())
+		return true;
+	if (surfacePlace.pixelCount() > ScRasterCache::maxSurfacePixels / 4)
+		return false;
+
+	const GuidesPrefs& guides = m_doc->guidesPrefs();
+	QByteArray key;
+	QDataStream keyStream(&key, QIODevice::WriteOnly);
+	keyStream << QByteArray("master") << quint64(quintptr(m_doc)) << m_doc->contentRevision() << masterPage->pageName() << layer.ID << layer.outlineMode << layer.markerColor.rgba();
+	keyStream << surfacePlace.width << surfacePlace.height << dpr << m_viewMode.scale << (pageDependent ? page->pageNr() : -1);
+	keyStream << surfacePlace.matrix;
+	keyStream << m_viewMode.previewMode << m_viewMode.viewAsPreview << m_viewMode.previewVisual << guides.framesShown << guides.tableCellFramesShown << guides.colBordersShown << guides.layerMarkersShown << guides.linkShown << guides.showPic << guides.showControls << guides.showBleed;
+
+	QImage surface;
+	if (m_viewMode.forceRedraw || !ScRasterCache::instance().find(key, surface))
+	{
+		surface = QImage(surfacePlace.width, surfacePlace.height, QImage::Format_ARGB32_Premultiplied);
+		surface.setDevicePixelRatio(dpr);
+		surface.fill(Qt::transparent);
+		ScPainter surfacePainter(&surface, surfacePlace.width, surfacePlace.height, 1.0, 0);
+		surfacePainter.setZoomFactor(m_viewMode.scale);
+		// Items are moved onto the page while being drawn, undo that move in the matrix
+		surfacePainter.setWorldMatrix(QTransform::fromTranslate(-dx, -dy) * surfacePlace.matrix);
+		surfacePainter.setLineWidth(1);
+		surfacePainter.setFillMode(ScPainter::Solid);
+		QRectF surfaceArea = itemsRect.translated(dx, dy);
+		for (PageItem *currItem : std::as_const(items))
+			DrawMasterItem(&surfacePainter, currItem, page, masterPage, surfaceArea);
+		surfacePainter.end();
+		ScRasterCache::instance().insert(key, surface, m_doc);
+	}
+	painter->drawDeviceImage(surface, surfacePlace.origin, 1.0, 0);
+	return true;
 }
 
 
@@ -217,6 +217,14 @@ public:
 	void setupEditHRuler(PageItem * item, bool forceAndReset = false);
 	
 private:
+	bool isMasterItemDrawn(const PageItem *currItem, const ScPage *masterPage, const ScLayer& layer) const;
+	void DrawMasterItem(ScPainter *painter, PageItem *currItem, const ScPage *page, const ScPage *masterPage, const QRectF& cullingArea);
+	/**
+		Draws the master items of a page from a surface rendered once per master page,
+		layer, zoom level and document revision and shared by all pages using that master.
+		Returns false if the items have to be drawn one by one.
+	 */
+	bool DrawMasterItems_Cached(ScPainter *painter, const ScPage *page, const ScPage *masterPage, const ScLayer& layer, const QRectF& cullingArea);
 	void DrawPageBorderSub(ScPainter *p, const ScPage *page);
 	void DrawPageBorder(ScPainter *p, const QRectF& clip, bool master = false);
 	void DrawPageMarginsGridSub(ScPainter *p, const ScPage *page);
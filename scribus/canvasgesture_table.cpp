@@ -36,7 +36,7 @@ QPointF TableGesture::globalToTableGrid(const QPointF& point, bool snap)
 	}
 
 	// Return point mapped to table grid.
-	return m_table->getTransform().inverted().map(canvasPoint.toQPointF()) - m_table->gridOffset();
+	return m_table->getInverseTransform().map(canvasPoint.toQPointF()) - m_table->gridOffset();
 }
 
 void TableGesture::paintTableOutline(
@@ -9,6 +9,7 @@ for which a new license (GPL+exception) is in place.
 #define SCCOLORPROFILECACHE_H
 
 #include <QMap>
+#include <QMutex>
 #include <QString>
 #include <QWeakPointer>
 #include "sccolorprofile.h"
@@ -25,6 +26,8 @@ public:
 
 private:
 	QMap<QString, QWeakPointer<ScColorProfileData> > m_profileMap;
+	// Profiles may be opened from image loading threads
+	mutable QMutex m_mutex;
 };
 
 #endif
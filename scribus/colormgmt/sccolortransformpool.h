@@ -9,6 +9,7 @@ for which a new license (GPL+exception) is in place.
 #define SCCOLORTRANSFORMPOOL_H
 
 #include <QList>
+#include <QMutex>
 #include <QWeakPointer>
 #include "sccolormgmtstructs.h"
 #include "sccolortransform.h"
@@ -30,6 +31,10 @@ public:
 private:
 	int m_engineID { 0 };
 	QList< QWeakPointer<ScColorTransformData> > m_pool;
+	// Transforms may be created from image loading threads
+	mutable QMutex m_mutex;
+
+	ScColorTransform findTransformUnlocked(const ScColorTransformInfo& info) const;
 };
 
 #endif
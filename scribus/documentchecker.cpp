@@ -21,7 +21,13 @@ for which a new license (GPL+exception) is in place.
 *																		 *
 ***************************************************************************/
 
+#include <vector>
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QHash>
 #include <QList>
+#include <QPair>
 
 #include "commonstrings.h"
 #include "documentchecker.h"
@@ -30,6 +36,7 @@ for which a new license (GPL+exception) is in place.
 #include "sccolor.h"
 #include "sclayer.h"
 #include "scpage.h"
+#include "scparallelfor.h"
 #include "scribusdoc.h"
 #include "scribusstructs.h"
 #include "text/textlayoutpainter.h"
@@ -73,6 +80,398 @@ bool isPartFilledImageFrame(PageItem * currItem)
 	return ((currItem->width() - imageRealWidth) > 0.05 || (currItem->height() - imageRealHeight) > 0.05);
 }
 
+namespace
+{
+	/// What PDFAnalyzer reports about one page of a placed PDF
+	struct PdfInspection
+	{
+		bool succeeded { false };
+		QList<PDFColorSpace> usedColorSpaces;
+		bool hasTransparency { false };
+		QList<PDFFont> usedFonts;
+		QList<PDFImage> imgs;
+	};
+
+	/// File and zero-based page number of a placed PDF
+	using PdfInspectionKey = QPair<QString, int>;
+
+	/// Errors found for an item, reused while the item is unchanged
+	struct ItemCheckResult
+	{
+		quint64 itemRevision { 0 };
+		quint64 storyRevision { 0 };
+		size_t signature { 0 };
+		errorCodes errors;
+		bool used { false };
+	};
+
+	/// Item check results of one document
+	struct PreflightCache
+	{
+		size_t contextSignature { 0 };
+		QHash<const PageItem*, ItemCheckResult> items;
+	};
+
+	QHash<const ScribusDoc*, PreflightCache> preflightCaches;
+
+	/// Hashes the color stops of a gradient
+	size_t gradientSignature(size_t signature, const VGradient& gradient)
+	{
+		const QList<VColorStop*> colorStops = gradient.colorStops();
+		for (const VColorStop* colorStop : colorStops)
+			signature = qHashMulti(signature, colorStop->rampPoint, colorStop->opacity, colorStop->name, colorStop->shade);
+		return signature;
+	}
+
+	/**
+	 * Hashes the profile settings and the document resources the item checks
+	 * depend on: colors, styles, named gradients, patterns and line styles.
+	 * Item results checked with another context are all discarded.
+	 */
+	size_t contextSignature(ScribusDoc* currDoc, const CheckerPrefs& checkerSettings)
+	{
+		size_t signature = qHashMulti(0, checkerSettings.checkGlyphs, checkerSettings.checkOverflow, checkerSettings.checkOrphans, checkerSettings.checkPictures);
+		signature = qHashMulti(signature, checkerSettings.checkResolution, checkerSettings.minResolution, checkerSettings.maxResolution, checkerSettings.checkTransparency);
+		signature = qHashMulti(signature, checkerSettings.checkAnnotations, checkerSettings.checkRasterPDF, checkerSettings.checkForGIF, checkerSettings.checkNotCMYKOrSpot);
+		signature = qHashMulti(signature, checkerSettings.checkDeviceColorsAndOutputIntent, checkerSettings.checkFontNotEmbedded, checkerSettings.checkFontIsOpenType);
+		signature = qHashMulti(signature, checkerSettings.checkPartFilledImageFrames, checkerSettings.checkEmptyTextFrames);
+		signature = qHashMulti(signature, currDoc->HasCMS, currDoc->HasCMS ? static_cast<int>(currDoc->DocPrinterProf.colorSpace()) : -1);
+		for (auto it = currDoc->PageColors.cbegin(); it != currDoc->PageColors.cend(); ++it)
+			signature = qHashMulti(signature, it.key(), static_cast<int>(it.value().getColorModel()));
+		const StyleSet<ParagraphStyle>& paraStyles = currDoc->paragraphStyles();
+		for (int i = 0; i < paraStyles.count(); ++i)
+			signature = qHashMulti(signature, paraStyles[i].name());
+		const StyleSet<CharStyle>& charStyles = currDoc->charStyles();
+		for (int i = 0; i < charStyles.count(); ++i)
+			signature = qHashMulti(signature, charStyles[i].name());
+		for (auto it = currDoc->docGradients.cbegin(); it != currDoc->docGradients.cend(); ++it)
+			signature = gradientSignature(qHashMulti(signature, it.key()), it.value());
+		for (auto it = currDoc->docPatterns.cbegin(); it != currDoc->docPatterns.cend(); ++it)
+		{
+			signature = qHashMulti(signature, it.key(), it.value().width, it.value().height, it.value().items.count());
+			for (const PageItem* patternItem : it.value().items)
+				signature = qHashMulti(signature, patternItem->changeRevision());
+		}
+		for (auto it = currDoc->docLineStyles.cbegin(); it != currDoc->docLineStyles.cend(); ++it)
+		{
+			signature = qHashMulti(signature, it.key());
+			for (const SingleLine& line : it.value())
+				signature = qHashMulti(signature, line.Width, line.Dash, line.Color, line.Shade);
+		}
+		return signature;
+	}
+
+	/**
+	 * Hashes the item properties the checks depend on and the document changes
+	 * without recording an undo action, like the layout of text frames and the
+	 * image file on disk.
+	 */
+	size_t itemSignature(const PageItem* currItem, bool masterItem)
+	{
+		size_t signature = qHashMulti(0, currItem->getUId(), static_cast<int>(currItem->itemType()), masterItem, currItem->OwnPage);
+		signature = qHashMulti(signature, currItem->width(), currItem->height(), currItem->imageXScale(), currItem->imageYScale());
+		if (currItem->isImageFrame())
+		{
+			QFileInfo fi(currItem->Pfile);
+			signature = qHashMulti(signature, currItem->Pfile, fi.size(), fi.lastModified().toMSecsSinceEpoch(), currItem->imageIsAvailable, currItem->isRaster);
+			signature = qHashMulti(signature, currItem->pixm.width(), currItem->pixm.height(), currItem->pixm.imgInfo.lowResScale, currItem->pixm.imgInfo.progressive);
+			signature = qHashMulti(signature, currItem->pixm.imgInfo.actualPageNumber, currItem->pixm.imgInfo.numberOfPages);
+		}
+		signature = qHashMulti(signature, currItem->GrType, currItem->GrTypeStroke, currItem->GrMask, currItem->gradient(), currItem->strokeGradient(), currItem->gradientMask(), currItem->patternMask());
+		signature = gradientSignature(signature, currItem->fill_gradient);
+		signature = gradientSignature(signature, currItem->stroke_gradient);
+		signature = gradientSignature(signature, currItem->mask_gradient);
+		signature = qHashMulti(signature, currItem->GrCol1transp, currItem->GrCol2transp, currItem->GrCol3transp, currItem->GrCol4transp);
+		if (currItem->isTextFrame() || currItem->isPathText())
+			signature = qHashMulti(signature, currItem->itemText.length(), currItem->firstInFrame(), currItem->lastInFrame(), currItem->frameOverflows(), currItem->frameUnderflows());
+		return signature;
+	}
+
+	/// Returns true if the checks of the item inspect a placed PDF, in which case key is set
+	bool needsPdfInspection(PageItem* currItem, const CheckerPrefs& checkerSettings, PdfInspectionKey& key)
+	{
+		if (!currItem->isImageFrame() || currItem->isOSGFrame())
+			return false;
+		if ((!currItem->imageIsAvailable) && (checkerSettings.checkPictures))
+			return false;
+		QFileInfo fi(currItem->Pfile);
+		if (!extensionIndicatesPDF(fi.suffix().toLower()))
+			return false;
+		int pageNum = qMin(qMax(1, currItem->pixm.imgInfo.actualPageNumber), currItem->pixm.imgInfo.numberOfPages) - 1;
+		key = qMakePair(currItem->Pfile, pageNum);
+		return true;
+	}
+
+	/**
+	 * Inspects placed PDFs, each on the first free core. PDFAnalyzer only
+	 * reads the file it is given, so inspections can run side by side.
+	 */
+	void inspectPdfs(QHash<PdfInspectionKey, PdfInspection>& inspections)
+	{
+		if (inspections.isEmpty())
+			return;
+		const QList<PdfInspectionKey> keys = inspections.keys();
+		std::vector<PdfInspection> results(keys.count());
+		ScParallelFor::run(keys.count(), [&](int index)
+		{
+			PdfInspection& inspection = results[index];
+			PDFAnalyzer analyst(keys.at(index).first);
+			inspection.succeeded = analyst.inspectPDF(keys.at(index).second, inspection.usedColorSpaces, inspection.hasTransparency, inspection.usedFonts, inspection.imgs);
+		});
+
+		for (int i = 0; i < keys.count(); ++i)
+			inspections[keys.at(i)] = results[i];
+	}
+
+	errorCodes checkItem(ScribusDoc *currDoc, PageItem* currItem, const CheckerPrefs& checkerSettings, bool masterItem, const PdfInspection* inspection)
+	{
+		errorCodes itemError;
+		if (((currItem->isAnnotation()) || (currItem->isBookmark)) && (checkerSettings.checkAnnotations))
+			itemError.insert(PreflightError::PDFAnnotField, 0);
+		if (currItem->hasSoftShadow() && checkerSettings.checkTransparency)
+			itemError.insert(PreflightError::Transparency, 0);
+		if ((currItem->GrType == 0) && (checkerSettings.checkTransparency))
+		{
+			if (currItem->fillColor() != CommonStrings::None)
+			{
+				if ((currItem->fillTransparency() != 0.0) || (currItem->fillBlendmode() != 0))
+					itemError.insert(PreflightError::Transparency, 0);
+			}
+		}
+		if ((currItem->GrType != 0) && (checkerSettings.checkTransparency))
+		{
+			if (currItem->GrType == Gradient_4Colors)
+			{
+				if (currItem->GrCol1transp != 1.0)
+					itemError.insert(PreflightError::Transparency, 0);
+				else if (currItem->GrCol2transp != 1.0)
+					itemError.insert(PreflightError::Transparency, 0);
+				else if (currItem->GrCol3transp != 1.0)
+					itemError.insert(PreflightError::Transparency, 0);
+				else if (currItem->GrCol4transp != 1.0)
+					itemError.insert(PreflightError::Transparency, 0);
+			}
+			else if (currItem->GrType == Gradient_Mesh)
+			{
+				for (int grow = 0; grow < currItem->meshGradientArray.count(); grow++)
+				{
+					for (int gcol = 0; gcol < currItem->meshGradientArray[grow].count(); gcol++)
+					{
+						if (currItem->meshGradientArray[grow][gcol].transparency != 1.0)
+							itemError.insert(PreflightError::Transparency, 0);
+					}
+				}
+			}
+			else if (currItem->GrType == Gradient_PatchMesh)
+			{
+				for (int grow = 0; grow < currItem->meshGradientPatches.count(); grow++)
+				{
+					if (currItem->meshGradientPatches[grow].TL.transparency != 1.0)
+						itemError.insert(PreflightError::Transparency, 0);
+					if (currItem->meshGradientPatches[grow].TR.transparency != 1.0)
+						itemError.insert(PreflightError::Transparency, 0);
+					if (currItem->meshGradientPatches[grow].BR.transparency != 1.0)
+						itemError.insert(PreflightError::Transparency, 0);
+					if (currItem->meshGradientPatches[grow].BL.transparency != 1.0)
+						itemError.insert(PreflightError::Transparency, 0);
+				}
+			}
+			else
+			{
+				QList<VColorStop*> colorStops = currItem->fill_gradient.colorStops();
+				for (int offset = 0 ; offset < colorStops.count() ; offset++)
+				{
+					if (colorStops[offset]->opacity != 1.0)
+					{
+						itemError.insert(PreflightError::Transparency, 0);
+						break;
+					}
+				}
+			}
+		}
+		if ((currItem->GrTypeStroke == 0) && (checkerSettings.checkTransparency))
+		{
+			if ((currItem->lineColor() != CommonStrings::None) || !currItem->NamedLStyle.isEmpty())
+			{
+				if ((currItem->lineTransparency() != 0.0) || (currItem->lineBlendmode() != 0))
+					itemError.insert(PreflightError::Transparency, 0);
+			}
+		}
+		if ((currItem->GrTypeStroke != 0) && (checkerSettings.checkTransparency))
+		{
+			QList<VColorStop*> colorStops = currItem->stroke_gradient.colorStops();
+			for (int offset = 0 ; offset < colorStops.count() ; offset++)
+			{
+				if (colorStops[offset]->opacity != 1.0)
+				{
+					itemError.insert(PreflightError::Transparency, 0);
+					break;
+				}
+			}
+		}
+		if ((currItem->GrMask > 0) && (checkerSettings.checkTransparency))
+			itemError.insert(PreflightError::Transparency, 0);
+		if ((currItem->OwnPage == -1) && (checkerSettings.checkOrphans))
+			itemError.insert(PreflightError::ObjectNotOnPage, 0);
+		if (currItem->isImageFrame() && !currItem->isOSGFrame())
+		{
+			// check image vs. frame sizes
+			if (checkerSettings.checkPartFilledImageFrames && isPartFilledImageFrame(currItem))
+			{
+				itemError.insert(PreflightError::PartFilledImageFrame, 0);
+			}
+
+			if ((!currItem->imageIsAvailable) && (checkerSettings.checkPictures))
+				itemError.insert(PreflightError::MissingImage, 0);
+			else
+			{
+				if (currItem->imageIsAvailable)
+				{
+					if (checkerSettings.checkTransparency && currItem->pixm.hasSmoothAlpha())
+						itemError.insert(PreflightError::Transparency, 0);
+					if (!masterItem && currItem->pixm.imgInfo.progressive)
+						itemError.insert(PreflightError::ImageHasProgressiveEncoding, 0);
+				}
+				if  (((qRound(72.0 / currItem->imageXScale()) < checkerSettings.minResolution) || (qRound(72.0 / currItem->imageYScale()) < checkerSettings.minResolution))
+						&& (currItem->isRaster) && (checkerSettings.checkResolution))
+					itemError.insert(PreflightError::ImageDPITooLow, 0);
+				if  (((qRound(72.0 / currItem->imageXScale()) > checkerSettings.maxResolution) || (qRound(72.0 / currItem->imageYScale()) > checkerSettings.maxResolution))
+						&& (currItem->isRaster) && (checkerSettings.checkResolution))
+					itemError.insert(PreflightError::ImageDPITooHigh, 0);
+				QFileInfo fi(currItem->Pfile);
+				QString ext = fi.suffix().toLower();
+				if (extensionIndicatesPDF(ext) && (checkerSettings.checkRasterPDF))
+					itemError.insert(PreflightError::PlacedPDF, 0);
+				if ((ext == "gif") && (checkerSettings.checkForGIF))
+					itemError.insert(PreflightError::ImageIsGIF, 0);
+
+				if (inspection && inspection->succeeded)
+				{
+					const QList<PDFColorSpace>& usedColorSpaces = inspection->usedColorSpaces;
+					if (checkerSettings.checkNotCMYKOrSpot || checkerSettings.checkDeviceColorsAndOutputIntent)
+					{
+						eColorSpaceType currPrintProfCS = ColorSpace_Unknown;
+						if (currDoc->HasCMS)
+						{
+							ScColorProfile printerProf = currDoc->DocPrinterProf;
+							currPrintProfCS = printerProf.colorSpace();
+						}
+						if (checkerSettings.checkNotCMYKOrSpot)
+						{
+							for (int i = 0; i < usedColorSpaces.size(); ++i)
+							{
+								if (usedColorSpaces[i] == CS_DeviceRGB || usedColorSpaces[i] == CS_ICCBased || usedColorSpaces[i] == CS_CalGray
+									|| usedColorSpaces[i] == CS_CalRGB || usedColorSpaces[i] == CS_Lab)
+								{
+									itemError.insert(PreflightError::NotCMYKOrSpot, 0);
+									break;
+								}
+							}
+						}
+						if (checkerSettings.checkDeviceColorsAndOutputIntent && currDoc->HasCMS)
+						{
+							for (int i = 0; i < usedColorSpaces.size(); ++i)
+							{
+								if (currPrintProfCS == ColorSpace_Cmyk && (usedColorSpaces[i] == CS_DeviceRGB || usedColorSpaces[i] == CS_DeviceGray))
+								{
+									itemError.insert(PreflightError::DeviceColorsAndOutputIntent, 0);
+									break;
+								}
+								if (currPrintProfCS == ColorSpace_Rgb && (usedColorSpaces[i] == CS_DeviceCMYK || usedColorSpaces[i] == CS_DeviceGray))
+								{
+									itemError.insert(PreflightError::DeviceColorsAndOutputIntent, 0);
+									break;
+								}
+							}
+						}
+					}
+					if (checkerSettings.checkTransparency && inspection->hasTransparency)
+						itemError.insert(PreflightError::Transparency, 0);
+					if (checkerSettings.checkFontNotEmbedded || checkerSettings.checkFontIsOpenType)
+					{
+						for (const PDFFont& currentFont : inspection->usedFonts)
+						{
+							if (!currentFont.isEmbedded && checkerSettings.checkFontNotEmbedded)
+								itemError.insert(PreflightError::FontNotEmbedded, 0);
+							if (currentFont.isEmbedded && currentFont.isOpenType && checkerSettings.checkFontIsOpenType)
+								itemError.insert(PreflightError::EmbeddedFontIsOpenType, 0);
+						}
+					}
+					if (checkerSettings.checkResolution)
+					{
+						for (const PDFImage& img : inspection->imgs)
+						{
+							if ((img.dpiX < checkerSettings.minResolution) || (img.dpiY < checkerSettings.minResolution))
+								itemError.insert(PreflightError::ImageDPITooLow, 0);
+							if ((img.dpiX > checkerSettings.maxResolution) || (img.dpiY > checkerSettings.maxResolution))
+								itemError.insert(PreflightError::ImageDPITooHigh, 0);
+						}
+					}
+				}
+			}
+		}
+		if ((currItem->isTextFrame()) || (currItem->isPathText()))
+		{
+			if ( currItem->frameOverflows() && (checkerSettings.checkOverflow) && (!((currItem->isAnnotation()) && ((currItem->annotation().Type() == Annotation::Combobox) || (currItem->annotation().Type() == Annotation::Listbox)))))
+				itemError.insert(PreflightError::TextOverflow, 0);
+
+			if (checkerSettings.checkEmptyTextFrames && (currItem->itemText.length() == 0 || currItem->frameUnderflows()))
+			{
+				bool isEmptyAnnotation = (currItem->isAnnotation() && 
+				                         ((currItem->annotation().Type() == Annotation::Link) ||
+				                          (currItem->annotation().Type() == Annotation::Checkbox) ||
+				                          (currItem->annotation().Type() == Annotation::RadioButton)));
+				if (!isEmptyAnnotation)
+					itemError.insert(PreflightError::EmptyTextFrame, 0);
+			}
+
+			// Dangling parent in the frame's own default style chain
+			// (the StoryText DefaultStyle Parent/CParent, which is not a
+			// named document style and so isn't caught by checkStyles()).
+			{
+				const QString cParent = currItem->itemText.defaultStyle().charStyle().parent();
+				if (!cParent.isEmpty() && currDoc->charStyles().find(cParent) < 0)
+					itemError.insert(PreflightError::MissingStyle, 0);
+				const QString pParent = currItem->itemText.defaultStyle().parent();
+				if (!pParent.isEmpty() && currDoc->paragraphStyles().find(pParent) < 0)
+					itemError.insert(PreflightError::MissingStyle, 0);
+			}
+
+			if (currItem->isAnnotation())
+			{
+				ScFace::FontFormat fformat = currItem->itemText.defaultStyle().charStyle().font().format();
+				if (!(fformat == ScFace::SFNT || fformat == ScFace::TTCF))
+					itemError.insert(PreflightError::WrongFontInAnnotation, 0);
+			}
+
+			if (checkerSettings.checkGlyphs)
+			{
+				MissingGlyphsPainter p(itemError, currItem->textLayout);
+				currItem->textLayout.render(&p);
+			}
+		}
+		if (((currItem->fillColor() != CommonStrings::None) || (currItem->lineColor() != CommonStrings::None)) && (checkerSettings.checkNotCMYKOrSpot))
+		{
+			bool rgbUsed = false;
+			if ((currItem->fillColor() != CommonStrings::None))
+			{
+				ScColor tmpC = currDoc->PageColors[currItem->fillColor()];
+				if (tmpC.getColorModel() == colorModelRGB)
+					rgbUsed = true;
+			}
+			if ((currItem->lineColor() != CommonStrings::None))
+			{
+				ScColor tmpC = currDoc->PageColors[currItem->lineColor()];
+				if (tmpC.getColorModel() == colorModelRGB)
+					rgbUsed = true;
+			}
+			if (rgbUsed)
+				itemError.insert(PreflightError::NotCMYKOrSpot, 0);
+		}
+		return itemError;
+	}
+}
+
 
 bool DocumentChecker::checkDocument(ScribusDoc *currDoc)
 {
@@ -90,6 +489,7 @@ bool DocumentChecker::checkDocument(ScribusDoc *currDoc, const QString& checkerP
 
 	struct CheckerPrefs checkerSettings;
 	checkerSettings = checkerProfiles[checkerProfile];
+	currDoc->loadDeferredImages();
 	currDoc->pageErrors.clear();
 	currDoc->docItemErrors.clear();
 	currDoc->masterItemErrors.clear();
@@ -174,559 +574,116 @@ void DocumentChecker::checkLayers(ScribusDoc *currDoc, const CheckerPrefs& check
 
 void DocumentChecker::checkItems(ScribusDoc *currDoc, const CheckerPrefs& checkerSettings)
 {
-	errorCodes itemError;
+	struct CheckedItem
+	{
+		PageItem* item { nullptr };
+		bool masterItem { false };
+		bool cacheable { false };
+		quint64 itemRevision { 0 };
+		quint64 storyRevision { 0 };
+		size_t signature { 0 };
+		bool inspectPdf { false };
+		PdfInspectionKey pdfKey;
+	};
 
-	QList<PageItem*> allItems;
-	uint masterItemsCount = currDoc->MasterItems.count();
-	for (uint i = 0; i < masterItemsCount; ++i)
+	if (!preflightCaches.contains(currDoc))
+		QObject::connect(currDoc, &QObject::destroyed, [currDoc]() { preflightCaches.remove(currDoc); });
+	PreflightCache& cache = preflightCaches[currDoc];
+	size_t context = contextSignature(currDoc, checkerSettings);
+	if (cache.contextSignature != context)
 	{
-		PageItem* currItem = currDoc->MasterItems.at(i);
-		if (currItem->isGroup())
-			allItems = currItem->getAllChildren();
-		else
-			allItems.append(currItem);
-		for (int ii = 0; ii < allItems.count(); ii++)
+		cache.items.clear();
+		cache.contextSignature = context;
+	}
+	for (auto it = cache.items.begin(); it != cache.items.end(); ++it)
+		it->used = false;
+
+	// Items whose results are still valid are taken from the cache,
+	// the others are collected to be checked once placed PDFs are inspected
+	QList<CheckedItem> pendingItems;
+	QHash<PdfInspectionKey, PdfInspection> inspections;
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		bool masterItems = (pass == 0);
+		const QList<PageItem*>& items = masterItems ? currDoc->MasterItems : currDoc->DocItems;
+		QMap<PageItem*, errorCodes>& itemErrors = masterItems ? currDoc->masterItemErrors : currDoc->docItemErrors;
+		QList<PageItem*> allItems;
+		for (int i = 0; i < items.count(); ++i)
 		{
-			currItem = allItems.at(ii);
-			if (!currItem->printEnabled())
-				continue;
-			if (!(currDoc->layerPrintable(currItem->m_layerID)) && (checkerSettings.ignoreOffLayers))
-				continue;
-			itemError.clear();
-			if (((currItem->isAnnotation()) || (currItem->isBookmark)) && (checkerSettings.checkAnnotations))
-				itemError.insert(PreflightError::PDFAnnotField, 0);
-			if (currItem->hasSoftShadow() && checkerSettings.checkTransparency)
-				itemError.insert(PreflightError::Transparency, 0);
-			if ((currItem->GrType == 0) && (checkerSettings.checkTransparency))
-			{
-				if (currItem->fillColor() != CommonStrings::None)
-				{
-					if ((currItem->fillTransparency() != 0.0) || (currItem->fillBlendmode() != 0))
-						itemError.insert(PreflightError::Transparency, 0);
-				}
-			}
-			if ((currItem->GrType != 0) && (checkerSettings.checkTransparency))
-			{
-				if (currItem->GrType == Gradient_4Colors)
-				{
-					if (currItem->GrCol1transp != 1.0)
-						itemError.insert(PreflightError::Transparency, 0);
-					else if (currItem->GrCol2transp != 1.0)
-						itemError.insert(PreflightError::Transparency, 0);
-					else if (currItem->GrCol3transp != 1.0)
-						itemError.insert(PreflightError::Transparency, 0);
-					else if (currItem->GrCol4transp != 1.0)
-						itemError.insert(PreflightError::Transparency, 0);
-				}
-				else if (currItem->GrType == Gradient_Mesh)
-				{
-					for (int grow = 0; grow < currItem->meshGradientArray.count(); grow++)
-					{
-						for (int gcol = 0; gcol < currItem->meshGradientArray[grow].count(); gcol++)
-						{
-							if (currItem->meshGradientArray[grow][gcol].transparency != 1.0)
-								itemError.insert(PreflightError::Transparency, 0);
-						}
-					}
-				}
-				else if (currItem->GrType == Gradient_PatchMesh)
-				{
-					for (int grow = 0; grow < currItem->meshGradientPatches.count(); grow++)
-					{
-						meshGradientPatch patch = currItem->meshGradientPatches[grow];
-						if (currItem->meshGradientPatches[grow].TL.transparency != 1.0)
-							itemError.insert(PreflightError::Transparency, 0);
-						if (currItem->meshGradientPatches[grow].TR.transparency != 1.0)
-							itemError.insert(PreflightError::Transparency, 0);
-						if (currItem->meshGradientPatches[grow].BR.transparency != 1.0)
-							itemError.insert(PreflightError::Transparency, 0);
-						if (currItem->meshGradientPatches[grow].BL.transparency != 1.0)
-							itemError.insert(PreflightError::Transparency, 0);
-					}
-				}
-				else
-				{
-					QList<VColorStop*> colorStops = currItem->fill_gradient.colorStops();
-					for (int offset = 0 ; offset < colorStops.count() ; offset++)
-					{
-						if (colorStops[offset]->opacity != 1.0)
-						{
-							itemError.insert(PreflightError::Transparency, 0);
-							break;
-						}
-					}
-				}
-			}
-			if ((currItem->GrTypeStroke == 0) && (checkerSettings.checkTransparency))
-			{
-				if ((currItem->lineColor() != CommonStrings::None) || !currItem->NamedLStyle.isEmpty())
-				{
-					if ((currItem->lineTransparency() != 0.0) || (currItem->lineBlendmode() != 0))
-						itemError.insert(PreflightError::Transparency, 0);
-				}
-			}
-			if ((currItem->GrTypeStroke != 0) && (checkerSettings.checkTransparency))
-			{
-				QList<VColorStop*> colorStops = currItem->stroke_gradient.colorStops();
-				for (int offset = 0 ; offset < colorStops.count() ; offset++)
-				{
-					if (colorStops[offset]->opacity != 1.0)
-					{
-						itemError.insert(PreflightError::Transparency, 0);
-						break;
-					}
-				}
-			}
-			if ((currItem->GrMask > 0) && (checkerSettings.checkTransparency))
-				itemError.insert(PreflightError::Transparency, 0);
-			if ((currItem->OwnPage == -1) && (checkerSettings.checkOrphans))
-				itemError.insert(PreflightError::ObjectNotOnPage, 0);
-			if (currItem->isImageFrame() && !currItem->isOSGFrame())
+			PageItem* currItem = items.at(i);
+			if (currItem->isGroup())
+				allItems = currItem->getAllChildren();
+			else
+				allItems.append(currItem);
+			for (int ii = 0; ii < allItems.count(); ii++)
 			{
-				// check image vs. frame sizes
-				if (checkerSettings.checkPartFilledImageFrames && isPartFilledImageFrame(currItem))
-				{
-					itemError.insert(PreflightError::PartFilledImageFrame, 0);
-				}
+				currItem = allItems.at(ii);
+				if (!currItem->printEnabled())
+					continue;
+				if (!(currDoc->layerPrintable(currItem->m_layerID)) && (checkerSettings.ignoreOffLayers))
+					continue;
+				bool isText = currItem->isTextFrame() || currItem->isPathText();
+				if (isText && checkerSettings.checkGlyphs && currItem->invalid)
+					currItem->layout();
 
-				if ((!currItem->imageIsAvailable) && (checkerSettings.checkPictures))
-					itemError.insert(PreflightError::MissingImage, 0);
-				else
+				CheckedItem checkedItem;
+				checkedItem.item = currItem;
+				checkedItem.masterItem = masterItems;
+				// Without a valid layout, the overflow of a frame is not known
+				checkedItem.cacheable = !(isText && currItem->invalid);
+				if (checkedItem.cacheable)
 				{
-					if (currItem->imageIsAvailable)
+					checkedItem.itemRevision = currItem->changeRevision();
+					checkedItem.storyRevision = isText ? currItem->itemText.revision() : 0;
+					checkedItem.signature = itemSignature(currItem, masterItems);
+					auto cached = cache.items.find(currItem);
+					if ((cached != cache.items.end()) && (cached->itemRevision == checkedItem.itemRevision) && (cached->storyRevision == checkedItem.storyRevision) && (cached->signature == checkedItem.signature))
 					{
-						if (checkerSettings.checkTransparency && currItem->pixm.hasSmoothAlpha())
-							itemError.insert(PreflightError::Transparency, 0);
-					}
-					if  (((qRound(72.0 / currItem->imageXScale()) < checkerSettings.minResolution) || (qRound(72.0 / currItem->imageYScale()) < checkerSettings.minResolution))
-							&& (currItem->isRaster) && (checkerSettings.checkResolution))
-						itemError.insert(PreflightError::ImageDPITooLow, 0);
-					if  (((qRound(72.0 / currItem->imageXScale()) > checkerSettings.maxResolution) || (qRound(72.0 / currItem->imageYScale()) > checkerSettings.maxResolution))
-							&& (currItem->isRaster) && (checkerSettings.checkResolution))
-						itemError.insert(PreflightError::ImageDPITooHigh, 0);
-					QFileInfo fi(currItem->Pfile);
-					QString ext = fi.suffix().toLower();
-					if (extensionIndicatesPDF(ext) && (checkerSettings.checkRasterPDF))
-						itemError.insert(PreflightError::PlacedPDF, 0);
-					if ((ext == "gif") && (checkerSettings.checkForGIF))
-						itemError.insert(PreflightError::ImageIsGIF, 0);
-
-					if (extensionIndicatesPDF(ext))
-					{
-						PDFAnalyzer analyst(currItem->Pfile);
-						QList<PDFColorSpace> usedColorSpaces;
-						bool hasTransparency = false;
-						QList<PDFFont> usedFonts;
-						int pageNum = qMin(qMax(1, currItem->pixm.imgInfo.actualPageNumber), currItem->pixm.imgInfo.numberOfPages) - 1;
-						QList<PDFImage> imgs;
-						bool succeeded = analyst.inspectPDF(pageNum, usedColorSpaces, hasTransparency, usedFonts, imgs);
-						if (succeeded)
-						{
-							if (checkerSettings.checkNotCMYKOrSpot || checkerSettings.checkDeviceColorsAndOutputIntent)
-							{
-								eColorSpaceType currPrintProfCS = ColorSpace_Unknown;
-								if (currDoc->HasCMS)
-								{
-									ScColorProfile printerProf = currDoc->DocPrinterProf;
-									currPrintProfCS = printerProf.colorSpace();
-								}
-								if (checkerSettings.checkNotCMYKOrSpot)
-								{
-									for (int i=0; i<usedColorSpaces.size(); ++i)
-									{
-										if (usedColorSpaces[i] == CS_DeviceRGB || usedColorSpaces[i] == CS_ICCBased || usedColorSpaces[i] == CS_CalGray
-											|| usedColorSpaces[i] == CS_CalRGB || usedColorSpaces[i] == CS_Lab)
-										{
-											itemError.insert(PreflightError::NotCMYKOrSpot, 0);
-											break;
-										}
-									}
-								}
-								if (checkerSettings.checkDeviceColorsAndOutputIntent && currDoc->HasCMS)
-								{
-									for (int i=0; i<usedColorSpaces.size(); ++i)
-									{
-										if (currPrintProfCS == ColorSpace_Cmyk && (usedColorSpaces[i] == CS_DeviceRGB || usedColorSpaces[i] == CS_DeviceGray))
-										{
-											itemError.insert(PreflightError::DeviceColorsAndOutputIntent, 0);
-											break;
-										}
-										if (currPrintProfCS == ColorSpace_Rgb && (usedColorSpaces[i] == CS_DeviceCMYK || usedColorSpaces[i] == CS_DeviceGray))
-										{
-											itemError.insert(PreflightError::DeviceColorsAndOutputIntent, 0);
-											break;
-										}
-									}
-								}
-							}
-							if (checkerSettings.checkTransparency && hasTransparency)
-								itemError.insert(PreflightError::Transparency, 0);
-							if (checkerSettings.checkFontNotEmbedded || checkerSettings.checkFontIsOpenType)
-							{
-								for (int i=0; i<usedFonts.size(); ++i)
-								{
-									PDFFont currentFont = usedFonts[i];
-									if (!currentFont.isEmbedded && checkerSettings.checkFontNotEmbedded)
-										itemError.insert(PreflightError::FontNotEmbedded, 0);
-									if (currentFont.isEmbedded && currentFont.isOpenType && checkerSettings.checkFontIsOpenType)
-										itemError.insert(PreflightError::EmbeddedFontIsOpenType, 0);
-								}
-							}
-							if (checkerSettings.checkResolution)
-							{
-								for (int i=0; i<imgs.size(); ++i)
-								{
-									if ((imgs[i].dpiX < checkerSettings.minResolution) || (imgs[i].dpiY < checkerSettings.minResolution))
-										itemError.insert(PreflightError::ImageDPITooLow, 0);
-									if ((imgs[i].dpiX > checkerSettings.maxResolution) || (imgs[i].dpiY > checkerSettings.maxResolution))
-										itemError.insert(PreflightError::ImageDPITooHigh, 0);
-								}
-							}
-						}
+						cached->used = true;
+						if (cached->errors.count() != 0)
+							itemErrors.insert(currItem, cached->errors);
+						continue;
 					}
 				}
+				checkedItem.inspectPdf = needsPdfInspection(currItem, checkerSettings, checkedItem.pdfKey);
+				if (checkedItem.inspectPdf)
+					inspections.insert(checkedItem.pdfKey, PdfInspection());
+				pendingItems.append(checkedItem);
 			}
-			if ((currItem->isTextFrame()) || (currItem->isPathText()))
-			{
-				if ( currItem->frameOverflows() && (checkerSettings.checkOverflow) && (!((currItem->isAnnotation()) && ((currItem->annotation().Type() == Annotation::Combobox) || (currItem->annotation().Type() == Annotation::Listbox)))))
-					itemError.insert(PreflightError::TextOverflow, 0);
-
-				if (checkerSettings.checkEmptyTextFrames && (currItem->itemText.length() == 0 || currItem->frameUnderflows()))
-				{
-					bool isEmptyAnnotation = (currItem->isAnnotation() && 
-					                         ((currItem->annotation().Type() == Annotation::Link) ||
-					                          (currItem->annotation().Type() == Annotation::Checkbox) ||
-					                          (currItem->annotation().Type() == Annotation::RadioButton)));
-					if (!isEmptyAnnotation)
-						itemError.insert(PreflightError::EmptyTextFrame, 0);
-				}
+			allItems.clear();
+		}
+	}
 
-				// Dangling parent in the frame's own default style chain
-				// (the StoryText DefaultStyle Parent/CParent, which is not a
-				// named document style and so isn't caught by checkStyles()).
-				{
-					const QString cParent = currItem->itemText.defaultStyle().charStyle().parent();
-					if (!cParent.isEmpty() && currDoc->charStyles().find(cParent) < 0)
-						itemError.insert(PreflightError::MissingStyle, 0);
-					const QString pParent = currItem->itemText.defaultStyle().parent();
-					if (!pParent.isEmpty() && currDoc->paragraphStyles().find(pParent) < 0)
-						itemError.insert(PreflightError::MissingStyle, 0);
-				}
-				
-				if (currItem->isAnnotation())
-				{
-					ScFace::FontFormat fformat = currItem->itemText.defaultStyle().charStyle().font().format();
-					if (!(fformat == ScFace::SFNT || fformat == ScFace::TTCF))
-						itemError.insert(PreflightError::WrongFontInAnnotation, 0);
-				}
+	inspectPdfs(inspections);
 
-				if (checkerSettings.checkGlyphs)
-				{
-					if (currItem->invalid)
-						currItem->layout();
-					MissingGlyphsPainter p(itemError, currItem->textLayout);
-					currItem->textLayout.render(&p);
-				}
-			}
-			if (((currItem->fillColor() != CommonStrings::None) || (currItem->lineColor() != CommonStrings::None)) && (checkerSettings.checkNotCMYKOrSpot))
-			{
-				bool rgbUsed = false;
-				if ((currItem->fillColor() != CommonStrings::None))
-				{
-					ScColor tmpC = currDoc->PageColors[currItem->fillColor()];
-					if (tmpC.getColorModel() == colorModelRGB)
-						rgbUsed = true;
-				}
-				if ((currItem->lineColor() != CommonStrings::None))
-				{
-					ScColor tmpC = currDoc->PageColors[currItem->lineColor()];
-					if (tmpC.getColorModel() == colorModelRGB)
-						rgbUsed = true;
-				}
-				if (rgbUsed)
-					itemError.insert(PreflightError::NotCMYKOrSpot, 0);
-			}
-			if (itemError.count() != 0)
-				currDoc->masterItemErrors.insert(currItem, itemError);
+	for (const CheckedItem& checkedItem : std::as_const(pendingItems))
+	{
+		const PdfInspection* inspection = checkedItem.inspectPdf ? &inspections[checkedItem.pdfKey] : nullptr;
+		errorCodes itemError = checkItem(currDoc, checkedItem.item, checkerSettings, checkedItem.masterItem, inspection);
+		if (itemError.count() != 0)
+		{
+			if (checkedItem.masterItem)
+				currDoc->masterItemErrors.insert(checkedItem.item, itemError);
+			else
+				currDoc->docItemErrors.insert(checkedItem.item, itemError);
 		}
-		allItems.clear();
+		if (!checkedItem.cacheable)
+			continue;
+		ItemCheckResult& result = cache.items[checkedItem.item];
+		result.itemRevision = checkedItem.itemRevision;
+		result.storyRevision = checkedItem.storyRevision;
+		result.signature = checkedItem.signature;
+		result.errors = itemError;
+		result.used = true;
 	}
-	allItems.clear();
-	uint docItemsCount = currDoc->DocItems.count();
-	for (uint i = 0; i < docItemsCount; ++i)
+
+	// Results of deleted or skipped items
+	for (auto it = cache.items.begin(); it != cache.items.end(); )
 	{
-		PageItem* currItem = currDoc->DocItems.at(i);
-		if (currItem->isGroup())
-			allItems = currItem->getAllChildren();
+		if (it->used)
+			++it;
 		else
-			allItems.append(currItem);
-		for (int ii = 0; ii < allItems.count(); ii++)
-		{
-			currItem = allItems.at(ii);
-			if (!currItem->printEnabled())
-				continue;
-			if (!(currDoc->layerPrintable(currItem->m_layerID)) && (checkerSettings.ignoreOffLayers))
-				continue;
-			itemError.clear();
-			if (currItem->hasSoftShadow() && checkerSettings.checkTransparency)
-				itemError.insert(PreflightError::Transparency, 0);
-			if ((currItem->GrType == 0) && (checkerSettings.checkTransparency))
-			{
-				if (currItem->fillColor() != CommonStrings::None)
-				{
-					if ((currItem->fillTransparency() != 0.0) || (currItem->fillBlendmode() != 0))
-						itemError.insert(PreflightError::Transparency, 0);
-				}
-			}
-			if ((currItem->GrType != 0) && (checkerSettings.checkTransparency))
-			{
-				if (currItem->GrType == Gradient_4Colors)
-				{
-					if (currItem->GrCol1transp != 1.0)
-						itemError.insert(PreflightError::Transparency, 0);
-					else if (currItem->GrCol2transp != 1.0)
-						itemError.insert(PreflightError::Transparency, 0);
-					else if (currItem->GrCol3transp != 1.0)
-						itemError.insert(PreflightError::Transparency, 0);
-					else if (currItem->GrCol4transp != 1.0)
-						itemError.insert(PreflightError::Transparency, 0);
-				}
-				else if (currItem->GrType == Gradient_Mesh)
-				{
-					for (int grow = 0; grow < currItem->meshGradientArray.count(); grow++)
-					{
-						for (int gcol = 0; gcol < currItem->meshGradientArray[grow].count(); gcol++)
-						{
-							if (currItem->meshGradientArray[grow][gcol].transparency != 1.0)
-								itemError.insert(PreflightError::Transparency, 0);
-						}
-					}
-				}
-				else if (currItem->GrType == Gradient_PatchMesh)
-				{
-					for (int grow = 0; grow < currItem->meshGradientPatches.count(); grow++)
-					{
-						meshGradientPatch patch = currItem->meshGradientPatches[grow];
-						if (currItem->meshGradientPatches[grow].TL.transparency != 1.0)
-							itemError.insert(PreflightError::Transparency, 0);
-						if (currItem->meshGradientPatches[grow].TR.transparency != 1.0)
-							itemError.insert(PreflightError::Transparency, 0);
-						if (currItem->meshGradientPatches[grow].BR.transparency != 1.0)
-							itemError.insert(PreflightError::Transparency, 0);
-						if (currItem->meshGradientPatches[grow].BL.transparency != 1.0)
-							itemError.insert(PreflightError::Transparency, 0);
-					}
-				}
-				else
-				{
-					QList<VColorStop*> colorStops = currItem->fill_gradient.colorStops();
-					for (int offset = 0 ; offset < colorStops.count() ; offset++)
-					{
-						if (colorStops[offset]->opacity != 1.0)
-						{
-							itemError.insert(PreflightError::Transparency, 0);
-							break;
-						}
-					}
-				}
-			}
-			if ((currItem->GrTypeStroke == 0) && (checkerSettings.checkTransparency))
-			{
-				if ((currItem->lineColor() != CommonStrings::None) || !currItem->NamedLStyle.isEmpty())
-				{
-					if ((currItem->lineTransparency() != 0.0) || (currItem->lineBlendmode() != 0))
-						itemError.insert(PreflightError::Transparency, 0);
-				}
-			}
-			if ((currItem->GrTypeStroke != 0) && (checkerSettings.checkTransparency))
-			{
-				QList<VColorStop*> colorStops = currItem->stroke_gradient.colorStops();
-				for (int offset = 0 ; offset < colorStops.count() ; offset++)
-				{
-					if (colorStops[offset]->opacity != 1.0)
-					{
-						itemError.insert(PreflightError::Transparency, 0);
-						break;
-					}
-				}
-			}
-			if ((currItem->GrMask > 0) && (checkerSettings.checkTransparency))
-				itemError.insert(PreflightError::Transparency, 0);
-			if (((currItem->isAnnotation()) || (currItem->isBookmark)) && (checkerSettings.checkAnnotations))
-				itemError.insert(PreflightError::PDFAnnotField, 0);
-			if ((currItem->OwnPage == -1) && (checkerSettings.checkOrphans))
-				itemError.insert(PreflightError::ObjectNotOnPage, 0);
-			if (currItem->isImageFrame() && !currItem->isOSGFrame())
-			{
-
-				// check image vs. frame sizes
-				if (checkerSettings.checkPartFilledImageFrames && isPartFilledImageFrame(currItem))
-				{
-					itemError.insert(PreflightError::PartFilledImageFrame, 0);
-				}
-
-				if ((!currItem->imageIsAvailable) && (checkerSettings.checkPictures))
-					itemError.insert(PreflightError::MissingImage, 0);
-				else
-				{
-					if (currItem->imageIsAvailable)
-					{
-						if (checkerSettings.checkTransparency && currItem->pixm.hasSmoothAlpha())
-							itemError.insert(PreflightError::Transparency, 0);
-						if (currItem->pixm.imgInfo.progressive)
-							itemError.insert(PreflightError::ImageHasProgressiveEncoding, 0);
-					}
-					if  (((qRound(72.0 / currItem->imageXScale()) < checkerSettings.minResolution) || (qRound(72.0 / currItem->imageYScale()) < checkerSettings.minResolution))
-							&& (currItem->isRaster) && (checkerSettings.checkResolution))
-						itemError.insert(PreflightError::ImageDPITooLow, 0);
-					if  (((qRound(72.0 / currItem->imageXScale()) > checkerSettings.maxResolution) || (qRound(72.0 / currItem->imageYScale()) > checkerSettings.maxResolution))
-							&& (currItem->isRaster) && (checkerSettings.checkResolution))
-						itemError.insert(PreflightError::ImageDPITooHigh, 0);
-					QFileInfo fi(currItem->Pfile);
-					QString ext = fi.suffix().toLower();
-					if (extensionIndicatesPDF(ext) && (checkerSettings.checkRasterPDF))
-						itemError.insert(PreflightError::PlacedPDF, 0);
-					if ((ext == "gif") && (checkerSettings.checkForGIF))
-						itemError.insert(PreflightError::ImageIsGIF, 0);
-
-					if (extensionIndicatesPDF(ext))
-					{
-						PDFAnalyzer analyst(currItem->Pfile);
-						QList<PDFColorSpace> usedColorSpaces;
-						bool hasTransparency = false;
-						QList<PDFFont> usedFonts;
-						int pageNum = qMin(qMax(1, currItem->pixm.imgInfo.actualPageNumber), currItem->pixm.imgInfo.numberOfPages) - 1;
-						QList<PDFImage> imgs;
-						bool succeeded = analyst.inspectPDF(pageNum, usedColorSpaces, hasTransparency, usedFonts, imgs);
-						if (succeeded)
-						{
-							if (checkerSettings.checkNotCMYKOrSpot || checkerSettings.checkDeviceColorsAndOutputIntent)
-							{
-								int currPrintProfCS = -1;
-								if (currDoc->HasCMS)
-								{
-									ScColorProfile printerProf = currDoc->DocPrinterProf;
-									currPrintProfCS = static_cast<int>(printerProf.colorSpace());
-								}
-								if (checkerSettings.checkNotCMYKOrSpot)
-								{
-									for (int i = 0; i < usedColorSpaces.size(); ++i)
-									{
-										if (usedColorSpaces[i] == CS_DeviceRGB || usedColorSpaces[i] == CS_ICCBased || usedColorSpaces[i] == CS_CalGray
-											|| usedColorSpaces[i] == CS_CalRGB || usedColorSpaces[i] == CS_Lab)
-										{
-											itemError.insert(PreflightError::NotCMYKOrSpot, 0);
-											break;
-										}
-									}
-								}
-								if (checkerSettings.checkDeviceColorsAndOutputIntent && currDoc->HasCMS)
-								{
-									for (int i = 0; i < usedColorSpaces.size(); ++i)
-									{
-										if (currPrintProfCS == ColorSpace_Cmyk && (usedColorSpaces[i] == CS_DeviceRGB || usedColorSpaces[i] == CS_DeviceGray))
-										{
-											itemError.insert(PreflightError::DeviceColorsAndOutputIntent, 0);
-											break;
-										}
-										if (currPrintProfCS == ColorSpace_Rgb && (usedColorSpaces[i] == CS_DeviceCMYK || usedColorSpaces[i] == CS_DeviceGray))
-										{
-											itemError.insert(PreflightError::DeviceColorsAndOutputIntent, 0);
-											break;
-										}
-									}
-								}
-							}
-							if (checkerSettings.checkTransparency && hasTransparency)
-								itemError.insert(PreflightError::Transparency, 0);
-							if (checkerSettings.checkFontNotEmbedded || checkerSettings.checkFontIsOpenType)
-							{
-								for (int i = 0; i < usedFonts.size(); ++i)
-								{
-									PDFFont currentFont = usedFonts[i];
-									if (!currentFont.isEmbedded && checkerSettings.checkFontNotEmbedded)
-										itemError.insert(PreflightError::FontNotEmbedded, 0);
-									if (currentFont.isEmbedded && currentFont.isOpenType && checkerSettings.checkFontIsOpenType)
-										itemError.insert(PreflightError::EmbeddedFontIsOpenType, 0);
-								}
-							}
-							if (checkerSettings.checkResolution)
-							{
-								for (int i = 0; i < imgs.size(); ++i)
-								{
-									if ((imgs[i].dpiX < checkerSettings.minResolution) || (imgs[i].dpiY < checkerSettings.minResolution))
-										itemError.insert(PreflightError::ImageDPITooLow, 0);
-									if ((imgs[i].dpiX > checkerSettings.maxResolution) || (imgs[i].dpiY > checkerSettings.maxResolution))
-										itemError.insert(PreflightError::ImageDPITooHigh, 0);
-								}
-							}
-						}
-					}
-				}
-			}
-			if ((currItem->isTextFrame()) || (currItem->isPathText()))
-			{
-				if ( currItem->frameOverflows() && (checkerSettings.checkOverflow) && (!((currItem->isAnnotation()) && ((currItem->annotation().Type() == Annotation::Combobox) || (currItem->annotation().Type() == Annotation::Listbox)))))
-					itemError.insert(PreflightError::TextOverflow, 0);
-
-				if (checkerSettings.checkEmptyTextFrames && (currItem->itemText.length() == 0 || currItem->frameUnderflows()))
-				{
-					bool isEmptyAnnotation = (currItem->isAnnotation() && 
-					                         ((currItem->annotation().Type() == Annotation::Link) ||
-					                          (currItem->annotation().Type() == Annotation::Checkbox) ||
-					                          (currItem->annotation().Type() == Annotation::RadioButton)));
-					if (!isEmptyAnnotation)
-						itemError.insert(PreflightError::EmptyTextFrame, 0);
-				}
-
-				// Dangling parent in the frame's own default style chain
-				// (the StoryText DefaultStyle Parent/CParent, which is not a
-				// named document style and so isn't caught by checkStyles()).
-				{
-					const QString cParent = currItem->itemText.defaultStyle().charStyle().parent();
-					if (!cParent.isEmpty() && currDoc->charStyles().find(cParent) < 0)
-						itemError.insert(PreflightError::MissingStyle, 0);
-					const QString pParent = currItem->itemText.defaultStyle().parent();
-					if (!pParent.isEmpty() && currDoc->paragraphStyles().find(pParent) < 0)
-						itemError.insert(PreflightError::MissingStyle, 0);
-				}
-
-				if (currItem->isAnnotation())
-				{
-					ScFace::FontFormat fformat = currItem->itemText.defaultStyle().charStyle().font().format();
-					if (!(fformat == ScFace::SFNT || fformat == ScFace::TTCF))
-						itemError.insert(PreflightError::WrongFontInAnnotation, 0);
-				}
-				if (checkerSettings.checkGlyphs)
-				{
-					if (currItem->invalid)
-						currItem->layout();
-					MissingGlyphsPainter p(itemError, currItem->textLayout);
-					currItem->textLayout.render(&p);
-				}
-			}
-			if (((currItem->fillColor() != CommonStrings::None) || (currItem->lineColor() != CommonStrings::None)) && (checkerSettings.checkNotCMYKOrSpot))
-			{
-				bool rgbUsed = false;
-				if ((currItem->fillColor() != CommonStrings::None))
-				{
-					ScColor tmpC = currDoc->PageColors[currItem->fillColor()];
-					if (tmpC.getColorModel() == colorModelRGB)
-						rgbUsed = true;
-				}
-				if ((currItem->lineColor() != CommonStrings::None))
-				{
-					ScColor tmpC = currDoc->PageColors[currItem->lineColor()];
-					if (tmpC.getColorModel() == colorModelRGB)
-						rgbUsed = true;
-				}
-				if (rgbUsed)
-					itemError.insert(PreflightError::NotCMYKOrSpot, 0);
-			}
-			if (itemError.count() != 0)
-				currDoc->docItemErrors.insert(currItem, itemError);
-		}
-		allItems.clear();
+			it = cache.items.erase(it);
 	}
 }
 
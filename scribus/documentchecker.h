@@ -34,6 +34,9 @@ class ScribusDoc;
 /*! \brief It create a error/warning list for CheckDocument GUI class.
 All errors and/or warnings are stored in errorCodes (inherited QMap
 see scribusstructs.h) and parsed into tree view in CheckDocument widgets.
+The errors found for each item are kept per document and reused while the
+item, its text and the checked profile are unchanged, so checking a document
+again only checks the items modified since.
 */
 class SCRIBUS_API DocumentChecker
 {
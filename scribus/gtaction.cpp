@@ -43,6 +43,7 @@ for which a new license (GPL+exception) is in place.
 #include "prefsmanager.h"
 #include "scclocale.h"
 #include "selection.h"
+#include "storytextbuilder.h"
 #include "sccolorengine.h"
 #include "scribusdoc.h"
 #include "scribus.h"
@@ -84,11 +85,14 @@ void gtAction::setInfo(const QString& infoText)
 
 void gtAction::clearFrame()
 {
+	commitStory();
 	m_textFrame->itemText.clear();
 }
 
 void gtAction::writeUnstyled(const QString& text, bool isNote)
 {
+	commitStory();
+
 	UndoTransaction activeTransaction;
 	if (m_isFirstWrite && m_it->itemText.isNotEmpty())
 	{
@@ -251,9 +255,13 @@ void gtAction::write(const QString& text, gtStyle *style, bool isNote)
 	}
 	/*newStyle.eraseCharStyle(paraStyle.charStyle());*/
 
+	if (!m_storyBuilder)
+		m_storyBuilder = std::make_unique<StoryTextBuilder>(m_it->itemText);
+
 	lastStyle = newStyle;
-	lastStyleStart = m_it->itemText.length();
-	StoryText* story = nullptr;
+	lastStyleStart = m_storyBuilder->length();
+	std::unique_ptr<StoryTextBuilder> noteBuilder;
+	StoryTextBuilder* story = nullptr;
 	if (isNote)
 	{
 		if (m_noteStory == nullptr)
@@ -261,10 +269,11 @@ void gtAction::write(const QString& text, gtStyle *style, bool isNote)
 			m_note = m_it->m_Doc->newNote(m_it->m_Doc->m_docNotesStylesList.at(0));
 			m_noteStory = new StoryText(m_it->m_Doc);
 		}
-		story = m_noteStory;
+		noteBuilder = std::make_unique<StoryTextBuilder>(*m_noteStory);
+		story = noteBuilder.get();
 	}
 	else
-		story = &m_it->itemText;
+		story = m_storyBuilder.get();
 
 	QChar ch0(0), ch5(5), ch10(10), ch13(13); 
 	for (int a = 0; a < text.length(); ++a)
@@ -293,6 +302,7 @@ void gtAction::write(const QString& text, gtStyle *style, bool isNote)
 			m_note->setMasterMark(mrk);
 			mrk->clearString();
 			mrk->OwnPage = m_it->OwnPage;
+			m_storyBuilder->commit();
 			m_it->itemText.insertMark(mrk);
 			story->applyCharStyle(lastStyleStart, story->length()-lastStyleStart, lastStyle);
 			if (paraStyle.hasName())
@@ -303,21 +313,23 @@ void gtAction::write(const QString& text, gtStyle *style, bool isNote)
 			}
 			else
 				story->applyStyle(qMax(0,story->length()-1), paraStyle);
+			story->commit();
 			
 			m_lastCharWasLineChange = text.right(1) == "\n";
 			m_inPara = style->target() == "paragraph";
 			m_lastParagraphStyle = paragraphStyle;
 			if (m_isFirstWrite)
 				m_isFirstWrite = false;
-			if (story->text(pos -1) == SpecialChars::PARSEP)
-				story->removeChars(pos-1, 1);
-			m_note->setSaxedText(saxedText(story));
+			if (m_noteStory->text(pos -1) == SpecialChars::PARSEP)
+				m_noteStory->removeChars(pos-1, 1);
+			m_note->setSaxedText(saxedText(m_noteStory));
 			m_note = nullptr;
+			noteBuilder.reset();
 			delete m_noteStory;
 			m_noteStory = nullptr;
 			return;
 		}
-		story->insertChars(pos, QString(ch));
+		story->append(ch);
 		if (ch == SpecialChars::PARSEP) 
 		{
 			if (paraStyle.hasName())
@@ -383,6 +395,7 @@ int gtAction::applyParagraphStyle(gtParagraphStyle* pstyle)
 
 void gtAction::applyFrameStyle(gtFrameStyle* fstyle)
 {
+	commitStory();
 	m_textFrame->setColumns(fstyle->getColumns());
 	m_textFrame->setColumnGap(fstyle->getColumnsGap());
 	m_textFrame->setFillColor(parseColor(fstyle->getBgColor()));
@@ -834,8 +847,15 @@ QString gtAction::parseColor(const QString &s)
 	return ret;
 }
 
+void gtAction::commitStory()
+{
+	if (m_storyBuilder)
+		m_storyBuilder->commit();
+}
+
 void gtAction::finalize()
 {
+	commitStory();
 	if (m_textFrame->doc()->docHyphenator->autoCheck())
 		m_textFrame->doc()->docHyphenator->slotHyphenate(m_textFrame);
 	m_textFrame->doc()->regionsChanged()->update(QRectF());
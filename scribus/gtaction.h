@@ -31,6 +31,8 @@ for which a new license (GPL+exception) is in place.
 #include <QMap>
 #include <QString>
 
+#include <memory>
+
 #include "scribusapi.h"
 
 class PageItem;
@@ -41,6 +43,7 @@ class ParagraphStyle;
 class ScribusDoc;
 class ScribusMainWindow;
 class StoryText;
+class StoryTextBuilder;
 class TextNote;
 
 class UndoManager;
@@ -100,6 +103,11 @@ private:
 	QString m_currentFrameStyle;
 	FontFamilyMap m_families;
 
+	/* Text written to the frame is accumulated here and committed to the
+	   story at once, see commitStory()
+	*/
+	std::unique_ptr<StoryTextBuilder> m_storyBuilder;
+
 	StoryText* m_noteStory { nullptr };
 	TextNote* m_note { nullptr };
 
@@ -111,6 +119,7 @@ private:
 	QString findFontName(gtFont* font);
 	void    updateParagraphStyle(int pstyleIndex, gtParagraphStyle* pstyle);
 	QString parseColor(const QString &s);
+	void    commitStory();
 	void    finalize();
 };
 
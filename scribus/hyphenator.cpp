@@ -26,10 +26,14 @@ for which a new license (GPL+exception) is in place.
 #include "scconfig.h"
 
 #include <QApplication>
+#include <QCache>
 #include <QCursor>
 #include <QCheckBox>
 #include <QByteArray>
+#include <QMutex>
 #include <QStringView>
+#include <QTimer>
+#include <memory>
 #include <unicode/brkiter.h>
 
 #include "langmgr.h"
@@ -41,6 +45,67 @@ for which a new license (GPL+exception) is in place.
 
 using namespace icu;
 
+namespace
+{
+	/*
+	 Word to hyphenation points cache, one per dictionary. Entries are
+	 weighted by their approximate size in bytes so that the total memory
+	 used by each dictionary cache stays bounded.
+	*/
+	class HyphenationCache
+	{
+	public:
+		static HyphenationCache* instance()
+		{
+			static HyphenationCache cache;
+			return &cache;
+		}
+
+		~HyphenationCache()
+		{
+			qDeleteAll(m_caches);
+		}
+
+		bool find(const QString& language, const QString& word, QByteArray& hyphens)
+		{
+			QMutexLocker locker(&m_mutex);
+			QCache<QString, QByteArray>* cache = m_caches.value(language, nullptr);
+			if (!cache)
+				return false;
+			const QByteArray* entry = cache->object(word);
+			if (!entry)
+				return false;
+			hyphens = *entry;
+			return true;
+		}
+
+		void insert(const QString& language, const QString& word, const QByteArray& hyphens)
+		{
+			QMutexLocker locker(&m_mutex);
+			QCache<QString, QByteArray>* cache = m_caches.value(language, nullptr);
+			if (!cache)
+			{
+				cache = new QCache<QString, QByteArray>(m_maxCost);
+				m_caches.insert(language, cache);
+			}
+			int cost = word.size() * sizeof(QChar) + hyphens.size() + 64;
+			cache->insert(word, new QByteArray(hyphens), cost);
+		}
+
+		void clear()
+		{
+			QMutexLocker locker(&m_mutex);
+			for (QCache<QString, QByteArray>* cache : std::as_const(m_caches))
+				cache->clear();
+		}
+
+	private:
+		QHash<QString, QCache<QString, QByteArray>*> m_caches;
+		QMutex m_mutex;
+		static constexpr int m_maxCost { 4 * 1024 * 1024 };
+	};
+}
+
 Hyphenator::Hyphenator(QWidget* parent, ScribusDoc *dok) : QObject( parent ),
 	m_doc(dok),
 	m_automatic(m_doc->hyphAutomatic()),
@@ -54,8 +119,15 @@ Hyphenator::Hyphenator(QWidget* parent, ScribusDoc *dok) : QObject( parent ),
 
 Hyphenator::~Hyphenator()
 {
+	if (m_storyThread)
+	{
+		m_storyThread->requestInterruption();
+		m_storyThread->wait();
+	}
 	if (m_hdict)
 		hnj_hyphen_free(m_hdict);
+	// The document is closed, its words are unlikely to be needed soon
+	clearWordCache();
 }
 
 bool Hyphenator::loadDict(const QString& name)
@@ -88,6 +160,58 @@ bool Hyphenator::loadDict(const QString& name)
 	return true;
 }
 
+bool Hyphenator::hyphenationPoints(HyphenDict* dict, QTextCodec* codec, const QString& language, const QString& word, QByteArray& hyphens)
+{
+	HyphenationCache* cache = HyphenationCache::instance();
+	if (cache->find(language, word, hyphens))
+		return true;
+	if (dict == nullptr || codec == nullptr)
+		return false;
+
+	QByteArray te = codec->fromUnicode(word);
+	hyphens.fill('\0', te.length() + 5);
+	char **rep = nullptr;
+	int *pos = nullptr;
+	int *cut = nullptr;
+	// TODO: support non-standard hyphenation, see hnj_hyphen_hyphenate2 docs
+	bool ok = !hnj_hyphen_hyphenate2(dict, te.data(), te.length(), hyphens.data(), nullptr, &rep, &pos, &cut);
+	if (ok)
+	{
+		hyphens[te.length()] = '\0';
+		cache->insert(language, word, hyphens);
+	}
+	if (rep)
+	{
+		for (int i = 0; i < te.length() - 1; ++i)
+			free(rep[i]);
+	}
+	free(rep);
+	free(pos);
+	free(cut);
+	return ok;
+}
+
+void Hyphenator::clearWordCache()
+{
+	HyphenationCache::instance()->clear();
+}
+
+void Hyphenator::applyHyphenationPattern(const QString& pattern, char* buffer)
+{
+	uint ii = 1;
+	for (int i = 1; i < pattern.length() - 1; ++i)
+	{
+		QChar cht = pattern[i];
+		if (cht == '-')
+			buffer[ii - 1] = 1;
+		else
+		{
+			buffer[ii] = 0;
+			++ii;
+		}
+	}
+}
+
 void Hyphenator::slotNewSettings(bool Autom, bool ACheck)
 {
 	m_autoCheck = ACheck;
@@ -108,28 +232,9 @@ void Hyphenator::slotHyphenateWord(PageItem* it, const QString& text, int firstC
 	if (!ok)
 		return;
 
-	QByteArray te = m_codec->fromUnicode(text);
-	char *buffer = static_cast<char*>(malloc(te.length() + 5));
-	if (buffer == nullptr)
-		return;
-	char **rep = nullptr;
-	int *pos = nullptr;
-	int *cut = nullptr;
-	// TODO: support non-standard hyphenation, see hnj_hyphen_hyphenate2 docs
-	if (!hnj_hyphen_hyphenate2(m_hdict, te.data(), te.length(), buffer, nullptr, &rep, &pos, &cut))
-	{
-		buffer[te.length()] = '\0';
-		it->itemText.hyphenateWord(firstC, text.length(), buffer);
-	}
-	free(buffer);
-	if (rep)
-	{
-		for (int i = 0; i < te.length() - 1; ++i)
-			free(rep[i]);
-	}
-	free(rep);
-	free(pos);
-	free(cut);
+	QByteArray hyphens;
+	if (hyphenationPoints(m_hdict, m_codec, m_language, text, hyphens))
+		it->itemText.hyphenateWord(firstC, text.length(), hyphens.constData());
 }
 
 void Hyphenator::slotHyphenate(PageItem* it)
@@ -177,19 +282,11 @@ void Hyphenator::slotHyphenate(PageItem* it)
 			if (!ok)
 				continue;
 
-			QByteArray te = m_codec->fromUnicode(wordLower);
-			char *buffer = static_cast<char*>(malloc(te.length() + 5));
-			if (buffer == nullptr)
-				break;
-
-			char **rep = nullptr;
-			int *pos = nullptr;
-			int *cut = nullptr;
-			// TODO: support non-standard hyphenation, see hnj_hyphen_hyphenate2 docs
-			if (!hnj_hyphen_hyphenate2(m_hdict, te.data(), te.length(), buffer, nullptr, &rep, &pos, &cut))
+			QByteArray hyphens;
+			if (hyphenationPoints(m_hdict, m_codec, m_language, wordLower, hyphens))
 			{
+				char *buffer = hyphens.data();
 				int i = 0;
-				buffer[te.length()] = '\0';
 				bool hasHyphen = false;
 				for (i = 1; i < wordLower.length() - 1; ++i)
 				{
@@ -310,8 +407,6 @@ void Hyphenator::slotHyphenate(PageItem* it)
 							}
 							else
 							{
-								free(buffer);
-								buffer = nullptr;
 								prefs->set("Xposition", dia->xpos);
 								prefs->set("Yposition", dia->ypos);
 								delete dia;
@@ -325,15 +420,6 @@ void Hyphenator::slotHyphenate(PageItem* it)
 					}
 				}
 			}
-			free(buffer);
-			if (rep)
-			{
-				for (int i = 0; i < te.length() - 1; ++i)
-					free(rep[i]);
-			}
-			free(rep);
-			free(pos);
-			free(cut);
 		}
 	}
 	QApplication::restoreOverrideCursor();
@@ -341,6 +427,114 @@ void Hyphenator::slotHyphenate(PageItem* it)
 	rememberedWords.clear();
 }
 
+void Hyphenator::slotHyphenateStory(PageItem* it)
+{
+	if (!it || !it->isTextFrame() || (it->itemText.length() == 0))
+		return;
+	// Linked frames share their story, queue each story only once
+	PageItem* first = it->firstInChain();
+	if (m_storyItem == first)
+		return;
+	for (const QPointer<PageItem>& queued : std::as_const(m_storyQueue))
+	{
+		if (queued == first)
+			return;
+	}
+	m_storyQueue.append(first);
+	if (!m_storyThread)
+		startNextStory();
+}
+
+void Hyphenator::startNextStory()
+{
+	if (m_storyThread)
+		return;
+	while (!m_storyQueue.isEmpty())
+	{
+		PageItem* it = m_storyQueue.takeFirst();
+		if (!it || (it->itemText.length() == 0))
+			continue;
+
+		m_storyItem = it;
+		m_storyRevision = it->itemText.revision();
+		m_storyEdited = false;
+		m_storyThread = new StoryHyphenationThread(it->itemText.createSnapshot(), this);
+		connect(m_storyThread, &QThread::finished, this, &Hyphenator::storyHyphenationFinished);
+		// Edits make the results useless, stop at the next paragraph
+		connect(&it->itemText, &StoryText::changed, this, &Hyphenator::storyTextChanged);
+		m_storyThread->start(QThread::LowPriority);
+		return;
+	}
+}
+
+void Hyphenator::storyHyphenationFinished()
+{
+	StoryHyphenationThread* thread = m_storyThread;
+	PageItem* it = m_storyItem;
+	m_storyThread = nullptr;
+	m_storyItem = nullptr;
+	if (it)
+		disconnect(&it->itemText, &StoryText::changed, this, &Hyphenator::storyTextChanged);
+
+	// Results are discarded if the item was deleted or its text was edited meanwhile,
+	// edited stories are hyphenated again once the user paused typing
+	if (thread && it && (it->itemText.revision() != m_storyRevision))
+	{
+		thread->deleteLater();
+		if (m_storyEdited && !m_storyQueue.contains(it))
+			m_storyQueue.append(it);
+		QTimer::singleShot(restartDelay, this, SLOT(startNextStory()));
+		return;
+	}
+	if (thread && it)
+	{
+		StoryText& story = it->itemText;
+		story.blockSignals(true);
+		for (const HyphenationResult& result : thread->results())
+		{
+			const CharStyle& style = story.charStyle(result.position);
+			if (result.length < style.hyphenWordMin())
+				continue;
+			QString word = story.text(result.position, result.length);
+			if (ignoredWords.contains(word))
+				continue;
+			QByteArray hyphens = result.hyphens;
+			bool hasHyphen = false;
+			for (int i = 1; i < result.length - 1; ++i)
+			{
+				if (hyphens[i] & 1)
+				{
+					hasHyphen = true;
+					break;
+				}
+			}
+			if (!hasHyphen)
+			{
+				story.hyphenateWord(result.position, result.length, nullptr);
+				continue;
+			}
+			if (specialWords.contains(word))
+				applyHyphenationPattern(specialWords.value(word), hyphens.data());
+			story.hyphenateWord(result.position, result.length, hyphens.constData());
+		}
+		story.blockSignals(false);
+		story.invalidateAll();
+		m_doc->changed();
+		m_doc->regionsChanged()->update(QRectF());
+	}
+	if (thread)
+		thread->deleteLater();
+	startNextStory();
+}
+
+void Hyphenator::storyTextChanged()
+{
+	if (!m_storyThread)
+		return;
+	m_storyEdited = true;
+	m_storyThread->requestInterruption();
+}
+
 void Hyphenator::slotDeHyphenate(PageItem* it)
 {
 	if (!(it->isTextFrame()) || (it ->itemText.length() == 0))
@@ -355,3 +549,102 @@ void Hyphenator::slotDeHyphenate(PageItem* it)
 	}
 	m_doc->DoDrawing = true;
 }
+
+StoryHyphenationThread::StoryHyphenationThread(const StoryTextSnapshot& snapshot, QObject* parent)
+	: QThread(parent),
+	  m_snapshot(snapshot)
+{
+	// Dictionary file names are resolved here as the language manager is not thread safe
+	for (const LanguageRun& run : std::as_const(m_snapshot.languages))
+	{
+		if (run.language.isEmpty() || m_dictFiles.contains(run.language))
+			continue;
+		m_dictFiles.insert(run.language, LanguageManager::instance()->getHyphFilename(run.language));
+	}
+}
+
+void StoryHyphenationThread::run()
+{
+	UErrorCode status = U_ZERO_ERROR;
+	std::unique_ptr<BreakIterator> bi(BreakIterator::createWordInstance(Locale(), status));
+	if (U_FAILURE(status) || !bi)
+		return;
+
+	QHash<QString, HyphenDict*> dicts;
+	QHash<QString, QTextCodec*> codecs;
+
+	// Language runs never span paragraphs, checking for interruption before
+	// each paragraph lets edits stop the thread quickly
+	for (int paraIndex = 0; paraIndex < m_snapshot.paragraphCount(); ++paraIndex)
+	{
+		if (isInterruptionRequested())
+			break;
+		const QVector<LanguageRun> runs = m_snapshot.getLanguageRunsForParagraph(paraIndex);
+		for (const LanguageRun& run : runs)
+			hyphenateRun(run, bi.get(), dicts, codecs);
+	}
+
+	for (HyphenDict* dict : std::as_const(dicts))
+	{
+		if (dict)
+			hnj_hyphen_free(dict);
+	}
+}
+
+void StoryHyphenationThread::hyphenateRun(const LanguageRun& run, BreakIterator* bi, QHash<QString, HyphenDict*>& dicts, QHash<QString, QTextCodec*>& codecs)
+{
+	const QString dictFile = m_dictFiles.value(run.language);
+	if (dictFile.isEmpty())
+		return;
+
+	if (!dicts.contains(run.language))
+	{
+		HyphenDict* dict = nullptr;
+		QTextCodec* codec = nullptr;
+		QFile file(dictFile);
+		if (file.open(QIODevice::ReadOnly))
+		{
+			codec = QTextCodec::codecForName(file.readLine());
+			file.close();
+			if (codec)
+				dict = hnj_hyphen_load(file.fileName().toLocal8Bit().data());
+		}
+		dicts.insert(run.language, dict);
+		codecs.insert(run.language, codec);
+	}
+	HyphenDict* dict = dicts.value(run.language);
+	QTextCodec* codec = codecs.value(run.language);
+	if (!dict || !codec)
+		return;
+
+	const QString text = m_snapshot.plainText.mid(run.start, run.length);
+	const QLocale locale(run.language);
+	icu::UnicodeString unicodeStr((const UChar*) text.utf16(), text.length());
+	bi->setText(unicodeStr);
+
+	int pos = bi->first();
+	while (pos != BreakIterator::DONE)
+	{
+		int firstC = pos;
+		pos = bi->next();
+		if (pos == BreakIterator::DONE)
+			break;
+		int countC = pos - firstC;
+		if (countC < 2)
+			continue;
+
+		// Skip words which contained ignorable characters in the story
+		int origStart = 0;
+		int origLength = 0;
+		if (!m_snapshot.mapRangeToOriginal(run.start + firstC, countC, origStart, origLength) || (origLength != countC))
+			continue;
+
+		QString wordLower = locale.toLower(text.mid(firstC, countC));
+		HyphenationResult result;
+		if (!Hyphenator::hyphenationPoints(dict, codec, run.language, wordLower, result.hyphens))
+			continue;
+		result.position = origStart;
+		result.length = countC;
+		m_results.append(result);
+	}
+}
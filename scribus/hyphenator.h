@@ -8,16 +8,37 @@ for which a new license (GPL+exception) is in place.
 #define HYPLUG_H
 
 #include <QObject>
+#include <QPointer>
 #include <QTextCodec>
+#include <QThread>
 #include <QHash>
+#include <QList>
 #include <QSet>
+#include <QVector>
+#include <unicode/uversion.h>
 
 #include "scribusapi.h"
+#include "text/storytextsnapshot.h"
 #include "third_party/hyphen/hyphen.h"
 
 class ScribusDoc;
 class ScribusMainWindow;
 class PageItem;
+class StoryHyphenationThread;
+
+U_NAMESPACE_BEGIN
+class BreakIterator;
+U_NAMESPACE_END
+
+/*!
+Hyphenation points computed for one word of a story.
+*/
+struct HyphenationResult
+{
+	int position { 0 };  ///< Position of the word in the story
+	int length { 0 };    ///< Length of the word in the story
+	QByteArray hyphens;  ///< Result of hnj_hyphen_hyphenate2, odd values mark hyphenation points
+};
 
 /*!
 This class is the core of the Scribus hyphenation system.
@@ -45,6 +66,24 @@ public:
 	~Hyphenator() override;
 
 	bool autoCheck() const { return m_autoCheck; }
+
+	/*!
+	\brief Returns the hyphenation points of a lower case word, using the word cache when possible.
+	Results are cached per dictionary, the cache is shared by all documents and threads.
+	\param dict hyphenation dictionary of \a language
+	\param codec codec of the dictionary
+	\param language language of the dictionary
+	\param word the lower case word
+	\param hyphens receives the hyphenation points
+	\retval bool false if the word could not be hyphenated
+	*/
+	static bool hyphenationPoints(HyphenDict* dict, QTextCodec* codec, const QString& language, const QString& word, QByteArray& hyphens);
+
+	/*!
+	\brief Forget all cached hyphenation results.
+	Called when a document is closed and when installed dictionaries change.
+	*/
+	static void clearWordCache();
 	
 private:
 
@@ -70,6 +109,22 @@ private:
 	 \param name is the name of specified language.
 	 */
 	bool loadDict(const QString& name);
+
+	/*! Stories waiting for background hyphenation */
+	QList<QPointer<PageItem> > m_storyQueue;
+	/*! Thread hyphenating the story of \a m_storyItem */
+	StoryHyphenationThread* m_storyThread { nullptr };
+	/*! Item whose story is hyphenated in background */
+	QPointer<PageItem> m_storyItem;
+	/*! Revision of the story text when the background hyphenation was started */
+	quint64 m_storyRevision { 0 };
+	/*! Flag - the story was edited while hyphenated in background */
+	bool m_storyEdited { false };
+	/*! Delay before hyphenating again a story edited during its hyphenation, in milliseconds */
+	static constexpr int restartDelay { 1000 };
+
+	/*! Applies a user defined hyphenation such as "hy-phen-ation" to \a buffer */
+	static void applyHyphenationPattern(const QString& pattern, char* buffer);
 	
 public:
 	QHash<QString, QString> rememberedWords;
@@ -104,6 +159,14 @@ public slots:
 	*/
 	void slotHyphenate(PageItem *it);
 	/*!
+	\brief Hyphenate the whole story of a text frame on a worker thread.
+	The text is hyphenated from a snapshot, results are applied to the story in one
+	batch when the thread finishes and only if the text has not changed meanwhile.
+	Words which need user confirmation are hyphenated as if automatic mode were set.
+	\param it references \see PageItem - text frame.
+	*/
+	void slotHyphenateStory(PageItem *it);
+	/*!
 	\fn void Hyphenator::slotDeHyphenate(PageItem* it)
 	\brief Removes hyphenation either for the whole text frame or the selected text if there is a selection.
 	\date
@@ -111,6 +174,36 @@ public slots:
 	\param it references \see PageItem - text frame.
 	*/
 	void slotDeHyphenate(PageItem *it);
+
+private slots:
+	/*! Starts hyphenation of the next queued story */
+	void startNextStory();
+	void storyHyphenationFinished();
+	/*! Interrupts the background hyphenation of an edited story */
+	void storyTextChanged();
+};
+
+/*!
+Thread computing hyphenation points for a snapshot of a story.
+*/
+class SCRIBUS_API StoryHyphenationThread : public QThread
+{
+	Q_OBJECT
+
+public:
+	StoryHyphenationThread(const StoryTextSnapshot& snapshot, QObject* parent = nullptr);
+
+	const QVector<HyphenationResult>& results() const { return m_results; }
+
+protected:
+	void run() override;
+
+private:
+	void hyphenateRun(const LanguageRun& run, icu::BreakIterator* bi, QHash<QString, HyphenDict*>& dicts, QHash<QString, QTextCodec*>& codecs);
+
+	StoryTextSnapshot m_snapshot;
+	QHash<QString, QString> m_dictFiles;
+	QVector<HyphenationResult> m_results;
 };
 
 #endif
@@ -0,0 +1,83 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#include <cstring>
+
+#include "scimgdataloader_memory.h"
+#include "scimagememorystore.h"
+
+void ScImgDataLoader_Memory::initialize()
+{
+	m_useRawImage = false;
+	ScImgDataLoader::initialize();
+}
+
+void ScImgDataLoader_Memory::loadEmbeddedProfile(const QString& /*fn*/, int /*page*/)
+{
+	m_embeddedProfile.resize(0);
+	m_profileComponents = 0;
+}
+
+bool ScImgDataLoader_Memory::loadPicture(const QString& fn, int /*page*/, int /*res*/, bool /*thumbnail*/)
+{
+	initialize();
+	QImage image;
+	bool isCMYK = false;
+	if (!ScImageMemoryStore::instance().image(fn, image, isCMYK))
+		return false;
+
+	m_imageInfoRecord.type = ImageTypeOther;
+	m_imageInfoRecord.exifDataValid = false;
+	float xres = image.dotsPerMeterX() * 0.0254;
+	float yres = image.dotsPerMeterY() * 0.0254;
+	if (xres <= 1.0 || xres > 3000.0)
+		xres = 72.0;
+	if (yres <= 1.0 || yres > 3000.0)
+		yres = 72.0;
+	m_imageInfoRecord.xres = qRound(xres);
+	m_imageInfoRecord.yres = qRound(yres);
+	m_imageInfoRecord.BBoxX = 0;
+	m_imageInfoRecord.BBoxH = image.height();
+
+	if (isCMYK)
+	{
+		// Same layout as a contiguous 8 bit separated TIFF: one byte per ink
+		if (!r_image.create(image.width(), image.height(), 4))
+			return false;
+		const size_t lineSize = 4 * static_cast<size_t>(image.width());
+		for (int y = 0; y < image.height(); ++y)
+			memcpy(r_image.scanLine(y), image.constScanLine(y), lineSize);
+		m_image = QImage();
+		m_useRawImage = true;
+		m_imageInfoRecord.colorspace = ColorSpaceCMYK;
+		m_pixelFormat = Format_CMYK_8;
+		return true;
+	}
+
+	m_image = image;
+	m_image.setDotsPerMeterX((int) (xres / 0.0254));
+	m_image.setDotsPerMeterY((int) (yres / 0.0254));
+	m_imageInfoRecord.colorspace = ColorSpaceRGB;
+	m_pixelFormat = Format_BGRA_8;
+	return true;
+}
+
+bool ScImgDataLoader_Memory::preloadAlphaChannel(const QString& fn, int /*page*/, int /*res*/, bool& hasAlpha)
+{
+	initialize();
+	hasAlpha = false;
+	QImage image;
+	bool isCMYK = false;
+	if (!ScImageMemoryStore::instance().image(fn, image, isCMYK))
+		return false;
+	if (isCMYK)
+		return true;
+	// Images written to PNG by the importers keep their alpha channel
+	hasAlpha = image.hasAlphaChannel();
+	if (hasAlpha)
+		m_image = image;
+	return true;
+}
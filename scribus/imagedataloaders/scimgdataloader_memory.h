@@ -0,0 +1,31 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#ifndef SCIMGDATALOADER_MEMORY_H
+#define SCIMGDATALOADER_MEMORY_H
+
+#include "scimgdataloader.h"
+
+/**
+  * @brief Loads images registered in ScImageMemoryStore without touching the disk
+  */
+class ScImgDataLoader_Memory : public ScImgDataLoader
+{
+public:
+	ScImgDataLoader_Memory() = default;
+
+	void initialize() override;
+
+	bool preloadAlphaChannel(const QString& fn, int page, int res, bool& hasAlpha) override;
+	void loadEmbeddedProfile(const QString& fn, int page = 0) override;
+	bool loadPicture(const QString& fn, int page, int res, bool thumbnail) override;
+	bool useRawImage() const override { return m_useRawImage; }
+
+protected:
+	bool m_useRawImage { false };
+};
+
+#endif
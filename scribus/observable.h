@@ -18,6 +18,8 @@
 
 #include "scribusapi.h"
 
+#include <type_traits>
+
 #include <QObject>
 #include <QSet>
 #include <QVariant>
@@ -73,6 +75,21 @@ struct Private_Memento : public UpdateMemento
 {
 	Private_Memento(OBSERVED data) : m_data(data) {}
 	Private_Memento(OBSERVED data, bool layout) : m_data(data), m_layout(layout) {}
+
+	const void* subject() const override
+	{
+		if constexpr (std::is_pointer_v<OBSERVED>)
+			return m_data;
+		else
+			return nullptr;
+	}
+
+	void merge(const UpdateMemento* later) override
+	{
+		const auto* other = dynamic_cast<const Private_Memento<OBSERVED>*>(later);
+		if (other)
+			m_layout = m_layout || other->m_layout;
+	}
 	
 	OBSERVED m_data;
 	bool     m_layout { false };
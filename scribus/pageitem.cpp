@@ -25,6 +25,7 @@ for which a new license (GPL+exception) is in place.
 
 #include <utility>
 
+#include <QDataStream>
 #include <QDebug>
 #include <QFileInfo>
 #include <QFont>
@@ -38,6 +39,7 @@ for which a new license (GPL+exception) is in place.
 #include <QRegion>
 #include <QRegularExpression>
 #include <QScopedPointer>
+#include <QtMath>
 #include <cairo.h>
 #include <cassert>
 #include <qdrawutil.h>
@@ -64,10 +66,12 @@ for which a new license (GPL+exception) is in place.
 #include "resourcecollection.h"
 #include "sccolorengine.h"
 #include "scimagecacheproxy.h"
+#include "scimagememorystore.h"
 #include "sclimits.h"
 #include "scpage.h"
 #include "scpainter.h"
 #include "scpattern.h"
+#include "scrastercache.h"
 #include "scribusapp.h"
 #include "scribuscore.h"
 #include "scribusdoc.h"
@@ -351,7 +355,13 @@ PageItem::PageItem(const PageItem & other)
 	
 	uniqueNr = m_Doc->TotalItems;
 	invalid = true;
-	if (other.isInlineImage)
+	if (other.isInlineImage && ScImageMemoryStore::instance().contains(Pfile))
+	{
+		Pfile = ScImageMemoryStore::instance().duplicate(Pfile);
+		isInlineImage = true;
+		isTempFile = true;
+	}
+	else if (other.isInlineImage)
 	{
 		QFileInfo inlFi(Pfile);
 		QString ext = inlFi.suffix();
@@ -372,6 +382,10 @@ PageItem::PageItem(const PageItem & other)
 		isInlineImage = false;
 		isTempFile = false;
 	}
+	// Not part of the initializer list above, but needed by clones
+	GrStrokeExtend = other.GrStrokeExtend;
+	gradientMaskVal = other.gradientMaskVal;
+	m_rtl = other.m_rtl;
 	Parent = nullptr;
 	unWeld();
 }
@@ -681,7 +695,10 @@ PageItem::PageItem(ScribusDoc *doc, ItemType newType, double x, double y, double
 PageItem::~PageItem()
 {
 	if (isTempFile && !Pfile.isEmpty())
+	{
+		ScImageMemoryStore::instance().remove(Pfile);
 		QFile::remove(Pfile);
+	}
 	//remove marks
 
 	if (isTextFrame())
@@ -729,6 +746,7 @@ bool PageItem::isTableCell() const
 void PageItem::setXPos(double newXPos, bool drawingOnly)
 {
 	m_xPos = newXPos;
+	invalidateGeometry();
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -737,6 +755,7 @@ void PageItem::setXPos(double newXPos, bool drawingOnly)
 void PageItem::setYPos(double newYPos, bool drawingOnly)
 {
 	m_yPos = newYPos;
+	invalidateGeometry();
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -746,6 +765,7 @@ void PageItem::setXYPos(double newXPos, double newYPos, bool drawingOnly)
 {
 	m_xPos = newXPos;
 	m_yPos = newYPos;
+	invalidateGeometry();
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -780,6 +800,7 @@ void PageItem::moveBy(double dX, double dY, bool drawingOnly)
 		gYpos += dY;
 		BoundingY += dY;
 	}
+	invalidateGeometry();
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	moveWelded(dX, dY);
@@ -789,6 +810,7 @@ void PageItem::moveBy(double dX, double dY, bool drawingOnly)
 void PageItem::setWidth(double newWidth)
 {
 	m_width = newWidth;
+	invalidateGeometry();
 	updateConstants();
 	if (m_Doc->isLoading())
 		return;
@@ -798,6 +820,7 @@ void PageItem::setWidth(double newWidth)
 void PageItem::setHeight(double newHeight)
 {
 	m_height = newHeight;
+	invalidateGeometry();
 	updateConstants();
 	if (m_Doc->isLoading())
 		return;
@@ -808,6 +831,7 @@ void PageItem::setWidthHeight(double newWidth, double newHeight, bool drawingOnl
 {
 	m_width = newWidth;
 	m_height = newHeight;
+	invalidateGeometry();
 	updateConstants();
 	if (drawingOnly)
 		return;
@@ -818,6 +842,7 @@ void PageItem::setWidthHeight(double newWidth, double newHeight)
 {
 	m_width = newWidth;
 	m_height = newHeight;
+	invalidateGeometry();
 	updateConstants();
 	if (m_Doc->isLoading())
 		return;
@@ -832,6 +857,7 @@ void PageItem::resizeBy(double dH, double dW)
 		m_width += dH;
 	if (dW != 0.0)
 		m_height += dW;
+	invalidateGeometry();
 	updateConstants();
 	if (m_Doc->isLoading())
 		return;
@@ -847,6 +873,7 @@ void PageItem::setRotation(double newRotation, bool drawingOnly)
 		m_rotation += 360.0;
 	while (m_rotation > 360.0)
 		m_rotation -= 360.0;
+	invalidateGeometry();
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	rotateWelded(dR, oldRot);
@@ -862,6 +889,7 @@ void PageItem::rotateBy(double dR)
 		m_rotation += 360.0;
 	while (m_rotation > 360.0)
 		m_rotation -= 360.0;
+	invalidateGeometry();
 	if (m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -2084,6 +2112,7 @@ void PageItem::DrawObj_Embedded(ScPainter *p, const QRectF& cullingArea, const C
 			p->translate(0, -embedded->gHeight * (style.baselineOffset() / 1000.0));
 			embedded->m_yPos -= embedded->gHeight * (style.baselineOffset() / 1000.0);
 		}
+		embedded->invalidateGeometry();
 		p->scale(style.scaleH() / 1000.0, style.scaleV() / 1000.0);
 		embedded->invalid = true;
 		double pws = embedded->m_lineWidth;
@@ -2107,17 +2136,20 @@ void PageItem::DrawObj_Embedded(ScPainter *p, const QRectF& cullingArea, const C
 			case PolyLine:
 			case Spiral:
 				embedded->m_lineWidth = pws * qMin(style.scaleH() / 1000.0, style.scaleV() / 1000.0);
+				embedded->invalidateGeometry();
 				embedded->DrawObj_Item(p, cullingArea);
 				break;
 			default:
 				break;
 		}
 		embedded->m_lineWidth = pws * qMin(style.scaleH() / 1000.0, style.scaleV() / 1000.0);
+		embedded->invalidateGeometry();
 		embedded->DrawObj_Post(p);
 		embedded->m_xPos = x;
 		embedded->m_yPos = y;
 		p->restore();
 		embedded->m_lineWidth = pws;
+		embedded->invalidateGeometry();
 	}
 	if (m_Doc->guidesPrefs().framesShown)
 	{
@@ -2203,6 +2235,8 @@ void PageItem::DrawSoftShadow(ScPainter *p)
 		VisionDefectColor defect;
 		tmp = defect.convertDefect(tmp, m_Doc->previewVisual);
 	}
+	if (hasFill() && DrawSoftShadow_Cached(p, tmp, lwCorr))
+		return;
 	p->save();
 	if (m_softShadowHasObjectTransparency)
 		p->beginLayer(1.0 - fillTransparency(), m_softShadowBlendMode);
@@ -2220,6 +2254,7 @@ void PageItem::DrawSoftShadow(ScPainter *p)
 		m_lineTransparency = 0.0;
 		m_rotation = 0;
 		m_hasSoftShadow = false;
+		invalidateGeometry();
 		p->save();
 		p->translate(xOffset, yOffset);
 		DrawObj(p, QRectF());
@@ -2241,6 +2276,7 @@ void PageItem::DrawSoftShadow(ScPainter *p)
 		m_lineTransparency = lineTrans_Old;
 		m_hasSoftShadow = hasSoftShadow_Old;
 		m_rotation = rotation_Old;
+		invalidateGeometry();
 	}
 	else
 	{
@@ -2279,6 +2315,95 @@ void PageItem::DrawSoftShadow(ScPainter *p)
 	p->restore();
 }
 
+bool PageItem::DrawSoftShadow_Cached(ScPainter *p, const QColor& color, double lineWidth)
+{
+	// The shadow of a filled item is its own outline, filled and blurred.
+	// Render it once into a surface just large enough to hold it and paint
+	// that surface on later repaints, instead of blurring a whole canvas
+	// sized layer every time.
+	const QTransform matrix = p->worldMatrix();
+	if (!matrix.isInvertible())
+		return false;
+	const double dpr = p->devicePixelRatio();
+	const int blurRadius = m_softShadowBlurRadius * p->zoomFactor();
+
+	FPointArray sh = PoLine.copy();
+	sh.translate(m_softShadowXOffset, m_softShadowYOffset);
+	QRectF shadowRect = sh.boundingRect().adjusted(-lineWidth, -lineWidth, lineWidth, lineWidth);
+	QRectF deviceRect = matrix.mapRect(shadowRect);
+	const double margin = (blurRadius + 2) / dpr;
+	deviceRect.adjust(-margin, -margin, margin, margin);
+
+	const int left = qFloor(deviceRect.left() * dpr);
+	const int top = qFloor(deviceRect.top() * dpr);
+	const int width = qCeil(deviceRect.right() * dpr) - left;
+	const int height = qCeil(deviceRect.bottom() * dpr) - top;
+	if ((width <= 0) || (height <= 0))
+		return true;
+	if (static_cast<qint64>(width) * height > ScRasterCache::maxSurfacePixels)
+		return false;
+	const QPointF origin(left / dpr, top / dpr);
+	const QTransform surfaceMatrix = matrix * QTransform::fromTranslate(-origin.x(), -origin.y());
+
+	QByteArray key;
+	QDataStream keyStream(&key, QIODevice::WriteOnly);
+	keyStream << QByteArray("shadow") << width << height << dpr << blurRadius << color.rgba() << lineWidth << hasStroke();
+	keyStream << surfaceMatrix;
+	keyStream << m_softShadowXOffset << m_softShadowYOffset << m_softShadowErasedByObject << static_cast<int>(PLineArt) << static_cast<int>(PLineEnd) << static_cast<int>(PLineJoin);
+	keyStream << PoLine.size();
+	for (int i = 0; i < PoLine.size(); ++i)
+	{
+		const FPoint& point = PoLine.at(i);
+		keyStream << point.x() << point.y();
+	}
+
+	QImage surface;
+	if (!ScRasterCache::instance().find(key, surface))
+	{
+		surface = QImage(width, height, QImage::Format_ARGB32_Premultiplied);
+		surface.setDevicePixelRatio(dpr);
+		surface.fill(Qt::transparent);
+		ScPainter painter(&surface, width, height, 1.0, 0);
+		painter.setWorldMatrix(surfaceMatrix);
+		painter.beginLayer(1.0, 0);
+		painter.setupPolygon(&sh);
+		painter.setBrush(color);
+		painter.setFillMode(ScPainter::Solid);
+		painter.fillPath();
+		if (hasStroke())
+		{
+			painter.setStrokeMode(ScPainter::Solid);
+			painter.setPen(color, lineWidth, PLineArt, PLineEnd, PLineJoin);
+			painter.strokePath();
+		}
+		if (blurRadius > 0)
+			painter.blur(blurRadius);
+		if (m_softShadowErasedByObject)
+		{
+			sh = PoLine.copy();
+			painter.setupPolygon(&sh);
+			painter.setBrush(color);
+			painter.setFillMode(ScPainter::Solid);
+			painter.setBlendModeFill(19);
+			painter.fillPath();
+			if (hasStroke())
+			{
+				painter.setBlendModeStroke(19);
+				painter.setStrokeMode(ScPainter::Solid);
+				painter.setPen(color, lineWidth, PLineArt, PLineEnd, PLineJoin);
+				painter.strokePath();
+			}
+		}
+		painter.endLayer();
+		painter.end();
+		ScRasterCache::instance().insert(key, surface, m_Doc);
+	}
+
+	double opacity = 1.0 - (m_softShadowHasObjectTransparency ? fillTransparency() : m_softShadowOpacity);
+	p->drawDeviceImage(surface, origin, opacity, m_softShadowBlendMode);
+	return true;
+}
+
 QImage PageItem::DrawObj_toImage(double maxSize, int options)
 {
 	bool isEmbedded_Old = isEmbedded;
@@ -2289,9 +2414,16 @@ QImage PageItem::DrawObj_toImage(double maxSize, int options)
 	double maxy = -std::numeric_limits<double>::max();
 	double x1, x2, y1, y2;
 	if (options & NoRotation)
+	{
 		m_rotation = 0.0;
+		invalidateGeometry();
+	}
 	getVisualBoundingRect(&x1, &y1, &x2, &y2);
-	m_rotation = rotation_Old;
+	if (options & NoRotation)
+	{
+		m_rotation = rotation_Old;
+		invalidateGeometry();
+	}
 	double maxAdd = 0;
 	if (hasSoftShadow() && !(options & NoSoftShadow))
 		maxAdd = qMax(fabs(softShadowXOffset()), fabs(softShadowYOffset())) + softShadowBlurRadius();
@@ -2397,6 +2529,7 @@ void PageItem::setItemName(const QString& newName)
 	QString oldName = m_itemName;
 	m_itemName = generateUniqueCopyName(newName);
 	AutoName = false;
+	++s_renameRevision;
 	if (UndoManager::undoEnabled())
 	{
 		auto *ss = new SimpleState(Um::Rename, QString(Um::FromTo).arg(oldName, newName));
@@ -3374,6 +3507,29 @@ void PageItem::setStrokeGradient(const QString &newGradient)
 	stroke_gradient = newStrokeGradient;
 }
 
+void PageItem::updateNamedGradients()
+{
+	bool changed = false;
+	auto updateGradient = [this, &changed](QString& gradientName, VGradient& gradient)
+	{
+		if (gradientName.isEmpty())
+			return;
+		auto it = m_Doc->docGradients.constFind(gradientName);
+		if (it == m_Doc->docGradients.cend())
+			gradientName.clear();
+		else if (!(gradient == it.value()))
+			gradient = it.value();
+		else
+			return;
+		changed = true;
+	};
+	updateGradient(m_gradientName, fill_gradient);
+	updateGradient(gradientStrokeVal, stroke_gradient);
+	updateGradient(gradientMaskVal, mask_gradient);
+	if (changed)
+		markChanged();
+}
+
 void PageItem::strokeGradientVector(double& startX, double& startY, double& endX, double& endY, double &focalX, double &focalY, double &scale, double &skew) const
 {
 	startX = GrStrokeStartX;
@@ -3998,6 +4154,7 @@ void PageItem::setLineWidth(double newWidth)
 	}
 	m_oldLineWidth = m_lineWidth;
 	m_lineWidth = newWidth;
+	invalidateGeometry();
 }
 
 void PageItem::setLineEnd(Qt::PenCapStyle newStyle)
@@ -4610,6 +4767,7 @@ void PageItem::setLayer(int newLayerID)
 
 void PageItem::checkChanges(bool force)
 {
+	markChanged();
 	if (m_Doc->view() == nullptr)
 		return;
 	bool spreadChanges(false);
@@ -8069,6 +8227,8 @@ ObjectAttribute PageItem::getObjectAttribute(const QString& attributeName) const
 void PageItem::setObjectAttributes(const ObjAttrVector* map)
 {
 	pageItemAttributes = *map;
+	// No undo action is recorded for attributes
+	markChanged();
 }
 
 //if not `prependCopy` then string "Copy of" will not be prepended
@@ -8119,6 +8279,8 @@ QString PageItem::generateUniqueCopyName(const QString& originalName, bool prepe
 
 void PageItem::replaceNamedResources(ResourceCollection& newNames)
 {
+	markChanged();
+
 	QMap<QString, QString>::ConstIterator it;
 	
 	it = newNames.colors().find(softShadowColor());
@@ -9271,8 +9433,14 @@ QTransform PageItem::getTransform() const
 	}
 	else
 	{
-		result.translate(m_xPos, m_yPos);
-		result.rotate(m_rotation);
+		if (m_geometryCache.transformRevision != m_geometryRevision)
+		{
+			m_geometryCache.transform.reset();
+			m_geometryCache.transform.translate(m_xPos, m_yPos);
+			m_geometryCache.transform.rotate(m_rotation);
+			m_geometryCache.transformRevision = m_geometryRevision;
+		}
+		result = m_geometryCache.transform;
 	}
 	return result;
 }
@@ -9342,6 +9510,19 @@ QTransform PageItem::getTransform(double deltaX, double deltaY) const
 	return result;
 }
 
+QTransform PageItem::getInverseTransform() const
+{
+	// Transform of group children also depends on their parents
+	if (isGroupChild())
+		return getTransform().inverted();
+	if (m_geometryCache.inverseTransformRevision != m_geometryRevision)
+	{
+		m_geometryCache.inverseTransform = getTransform().inverted();
+		m_geometryCache.inverseTransformRevision = m_geometryRevision;
+	}
+	return m_geometryCache.inverseTransform;
+}
+
 QRectF PageItem::getBoundingRect() const
 {
 	double x, y, x2, y2;
@@ -9381,22 +9562,24 @@ void PageItem::getBoundingRect(double *x1, double *y1, double *x2, double *y2) c
 	double maxy = -std::numeric_limits<double>::max();
 	if (m_rotation != 0)
 	{
-		FPointArray pb;
-		pb.addPoint(FPoint(m_xPos, m_yPos));
-		pb.addPoint(FPoint(m_width,    0.0, m_xPos, m_yPos, m_rotation, 1.0, 1.0));
-		pb.addPoint(FPoint(m_width, m_height, m_xPos, m_yPos, m_rotation, 1.0, 1.0));
-		pb.addPoint(FPoint(  0.0, m_height, m_xPos, m_yPos, m_rotation, 1.0, 1.0));
-		for (uint pc = 0; pc < 4; ++pc)
+		if (m_geometryCache.boundsRevision != m_geometryRevision)
 		{
-			minx = qMin(minx, pb.point(pc).x());
-			miny = qMin(miny, pb.point(pc).y());
-			maxx = qMax(maxx, pb.point(pc).x());
-			maxy = qMax(maxy, pb.point(pc).y());
+			FPointArray pb;
+			pb.addPoint(FPoint(m_xPos, m_yPos));
+			pb.addPoint(FPoint(m_width,    0.0, m_xPos, m_yPos, m_rotation, 1.0, 1.0));
+			pb.addPoint(FPoint(m_width, m_height, m_xPos, m_yPos, m_rotation, 1.0, 1.0));
+			pb.addPoint(FPoint(  0.0, m_height, m_xPos, m_yPos, m_rotation, 1.0, 1.0));
+			for (uint pc = 0; pc < 4; ++pc)
+			{
+				minx = qMin(minx, pb.point(pc).x());
+				miny = qMin(miny, pb.point(pc).y());
+				maxx = qMax(maxx, pb.point(pc).x());
+				maxy = qMax(maxy, pb.point(pc).y());
+			}
+			m_geometryCache.bounds.setCoords(minx, miny, maxx, maxy);
+			m_geometryCache.boundsRevision = m_geometryRevision;
 		}
-		*x1 = minx;
-		*y1 = miny;
-		*x2 = maxx;
-		*y2 = maxy;
+		m_geometryCache.bounds.getCoords(x1, y1, x2, y2);
 	}
 	else
 	{
@@ -9450,22 +9633,29 @@ void PageItem::getVisualBoundingRect(double * x1, double * y1, double * x2, doub
 	double extraSpace = visualLineWidth() / 2.0;
 	if (m_rotation != 0)
 	{
-		FPointArray pb;
-		pb.addPoint(FPoint(-extraSpace,					-extraSpace,				xPos(), yPos(), m_rotation, 1.0, 1.0));
-		pb.addPoint(FPoint(visualWidth()-extraSpace,	-extraSpace,				xPos(), yPos(), m_rotation, 1.0, 1.0));
-		pb.addPoint(FPoint(visualWidth()-extraSpace,	visualHeight()-extraSpace,	xPos(), yPos(), m_rotation, 1.0, 1.0));
-		pb.addPoint(FPoint(-extraSpace, 				visualHeight()-extraSpace,	xPos(), yPos(), m_rotation, 1.0, 1.0));
-		for (int pc = 0; pc < 4; ++pc)
-		{
-			minx = qMin(minx, pb.point(pc).x());
-			miny = qMin(miny, pb.point(pc).y());
-			maxx = qMax(maxx, pb.point(pc).x());
-			maxy = qMax(maxy, pb.point(pc).y());
+		// Visual size also depends on line style and view scale, they are checked too
+		QSizeF size(visualWidth(), visualHeight());
+		GeometryCache& cache = m_geometryCache;
+		if ((cache.visualBoundsRevision != m_geometryRevision) || (cache.visualLineWidth != extraSpace) || (cache.visualSize != size))
+		{
+			FPointArray pb;
+			pb.addPoint(FPoint(-extraSpace,					-extraSpace,				xPos(), yPos(), m_rotation, 1.0, 1.0));
+			pb.addPoint(FPoint(size.width()-extraSpace,		-extraSpace,				xPos(), yPos(), m_rotation, 1.0, 1.0));
+			pb.addPoint(FPoint(size.width()-extraSpace,		size.height()-extraSpace,	xPos(), yPos(), m_rotation, 1.0, 1.0));
+			pb.addPoint(FPoint(-extraSpace, 				size.height()-extraSpace,	xPos(), yPos(), m_rotation, 1.0, 1.0));
+			for (int pc = 0; pc < 4; ++pc)
+			{
+				minx = qMin(minx, pb.point(pc).x());
+				miny = qMin(miny, pb.point(pc).y());
+				maxx = qMax(maxx, pb.point(pc).x());
+				maxy = qMax(maxy, pb.point(pc).y());
+			}
+			cache.visualBounds.setCoords(minx, miny, maxx, maxy);
+			cache.visualLineWidth = extraSpace;
+			cache.visualSize = size;
+			cache.visualBoundsRevision = m_geometryRevision;
 		}
-		*x1 = minx;
-		*y1 = miny;
-		*x2 = maxx;
-		*y2 = maxy;
+		cache.visualBounds.getCoords(x1, y1, x2, y2);
 	}
 	else
 	{
@@ -11144,6 +11334,7 @@ void PageItem::makeImageExternal(const QString& path)
 		return;
 
 	QString oldF = Pfile;
+	ScImageMemoryStore::instance().materialize(Pfile);
 	if (copyFile(Pfile, path))
 	{
 		Pfile = path;
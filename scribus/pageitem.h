@@ -36,6 +36,7 @@ for which a new license (GPL+exception) is in place.
 #include <QRect>
 #include <QRectF>
 #include <QString>
+#include <QTransform>
 #include <QVector>
 #include <QTemporaryFile>
 
@@ -312,6 +313,7 @@ public: // Start public functions
 	void DrawObj_Embedded(ScPainter *p, const QRectF& cullingArea, const CharStyle& style, PageItem* cembedded);
 	void DrawStrokePattern(ScPainter *p, const QPainterPath &path);
 	void DrawSoftShadow(ScPainter *p);
+	bool DrawSoftShadow_Cached(ScPainter *p, const QColor& color, double lineWidth);
 	/**
 	 * @brief Set or get the redraw bounding box of the item, moved from the View
 	 */
@@ -420,6 +422,17 @@ public: // Start public functions
 	void getTransform(QTransform& mat) const;
 	QTransform getTransform() const;
 	QTransform getTransform(double deltaX, double deltaY) const;
+	/**
+	 * @brief Inverse of getTransform(), mapping document coordinates to item coordinates
+	 */
+	QTransform getInverseTransform() const;
+	/**
+	 * @brief Revision of the position, size, rotation and line width of the item
+	 *
+	 * Changes each time one of them does, bounding rects and transform are cached
+	 * for the current revision.
+	 */
+	quint64 geometryRevision() const { return m_geometryRevision; }
 
 	/// invalidates current layout information
 	virtual void invalidateLayout() { invalid = true; }
@@ -832,6 +845,11 @@ public: // Start public functions
 	 * See also PageItem::itemName()
 	 */
 	void setItemName(const QString& newName);
+	/**
+	 * @brief Counter incremented whenever any item is renamed, lets name lookups
+	 * detect that cached positions may be out of date
+	 */
+	static quint64 renameRevision() { return s_renameRevision; }
 
 	/**
 	* @brief Set the masterpage the object is on
@@ -871,6 +889,12 @@ public: // Start public functions
 	 */
 	void setStrokeGradient(const QString &newGradient);
 
+	/**
+	 * @brief Copy the edited named gradients of the document into the object
+	 * and forget the names of deleted gradients.
+	 */
+	void updateNamedGradients();
+
 	/** @brief Get the name of the pattern of the object */
 	QString pattern() const { return m_patternName; }
 
@@ -1383,6 +1407,10 @@ public:	// Start public variables
 	bool OverrideCompressionQuality {false};
 	int CompressionQualityIndex {0};
 	bool imageIsAvailable {false}; ///< Flag to hold image file availability
+	bool imageLoadDeferred {false}; ///< Image file not loaded yet, see ScribusDoc::loadDeferredImage()
+	bool deferredImageLayers {false}; ///< Apply the requested layers once the deferred image is loaded
+	QString deferredImageClip; ///< Clipping path to apply once the deferred image is loaded
+	quint64 deferredImageRevision {0}; ///< Change revision of the item when its deferred image was loaded
 	int OrigW {0};
 	int OrigH {0};
 	double BBoxX {0.0}; ///< Bounding Box-X
@@ -1538,6 +1566,10 @@ public:	// Start public variables
 
 protected: // Start protected functions
 	PageItem(const PageItem & other);
+	/**
+	 * @brief To be called whenever m_xPos, m_yPos, m_width, m_height, m_rotation or m_lineWidth change
+	 */
+	void invalidateGeometry() { ++m_geometryRevision; }
 	void DrawObj_ImageFrame(ScPainter *p, double sc);
 	void DrawObj_Polygon(ScPainter *p);
 	void DrawObj_PolyLine(ScPainter *p);
@@ -1746,6 +1778,7 @@ protected: // Start protected variables
 	 * @sa PageItem::itemName(), PageItem::setItemName()
 	 */
 	QString m_itemName;
+	static inline quint64 s_renameRevision { 0 };
 
 	/**
 	 * Flag to tell if this item is a PDF annotation item
@@ -1935,6 +1968,25 @@ private:	// Start private functions
 			// End private functions
 
 private:	// Start private variables
+	/**
+	 * @brief Geometry computed for a given geometry revision, see geometryRevision()
+	 */
+	struct GeometryCache
+	{
+		quint64 boundsRevision {0};
+		QRectF bounds;
+		quint64 visualBoundsRevision {0};
+		double visualLineWidth {0.0};
+		QSizeF visualSize;
+		QRectF visualBounds;
+		quint64 transformRevision {0};
+		QTransform transform;
+		quint64 inverseTransformRevision {0};
+		QTransform inverseTransform;
+	};
+
+	quint64 m_geometryRevision {1};
+	mutable GeometryCache m_geometryCache;
 			// End private variables
 
 
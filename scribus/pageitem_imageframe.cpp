@@ -38,6 +38,7 @@ for which a new license (GPL+exception) is in place.
 #include "pageitem.h"
 #include "pageitem_imageframe.h"
 #include "prefsmanager.h"
+#include "scimagememorystore.h"
 #include "scraction.h"
 #include "scpage.h"
 #include "scpaths.h"
@@ -76,6 +77,8 @@ void PageItem_ImageFrame::DrawObj_Item(ScPainter *p, const QRectF& /*e*/)
 		return;
 	if (m_Doc->layerOutline(m_layerID))
 		return;
+	if (imageLoadDeferred)
+		m_Doc->loadDeferredImage(this);
 
 	p->setFillRule(true);
 	if ((fillColor() != CommonStrings::None) || (GrType != 0))
@@ -252,7 +255,10 @@ void PageItem_ImageFrame::clearContents()
 	setLineTransparency(0.0);
 	imageClip.resize(0);
 	if ((isTempFile) && (!Pfile.isEmpty()))
+	{
+		ScImageMemoryStore::instance().remove(Pfile);
 		QFile::remove(Pfile);
+	}
 	isTempFile = false;
 	isInlineImage = false;
 	//				emit UpdtObj(Doc->currentPage->pageNr(), ItemNr);
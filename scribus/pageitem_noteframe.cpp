@@ -85,6 +85,7 @@ PageItem_NoteFrame::PageItem_NoteFrame(PageItem_TextFrame* inFrame, NotesStyle *
 	oldRot = m_rotation;
 	oldXpos = m_xPos;
 	m_yPos = oldYpos = m_masterFrame->yPos() + m_masterFrame->height();
+	invalidateGeometry();
 
 	m_textFlowMode = TextFlowUsesFrameShape;
 	setColumns(1);
@@ -196,6 +197,7 @@ void PageItem_NoteFrame::layout()
 	if (m_nstyle->isAutoNotesWidth() && (m_width != m_masterFrame->width()))
 	{
 		oldWidth = m_width = m_masterFrame->width();
+		invalidateGeometry();
 		updateClip();
 	}
 
@@ -215,6 +217,7 @@ void PageItem_NoteFrame::layout()
 			while (frameOverflows())
 			{
 				oldHeight = m_height += 8;
+				invalidateGeometry();
 				updateClip(false);
 				invalid = true;
 				PageItem_TextFrame::layout();
@@ -224,6 +227,7 @@ void PageItem_NoteFrame::layout()
 		}
 		textLayout.box()->moveTo(textLayout.box()->x(), 0);
 		oldHeight = m_height = textLayout.box()->naturalHeight() + m_textDistanceMargins.bottom();
+		invalidateGeometry();
 		updateConstants();
 		updateClip();
 		invalid = true;
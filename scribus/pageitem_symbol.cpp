@@ -25,6 +25,7 @@ for which a new license (GPL+exception) is in place.
 #include <cassert>
 
 #include <QApplication>
+#include <QDataStream>
 #include <QFontInfo>
 
 #include "commonstrings.h"
@@ -35,6 +36,7 @@ for which a new license (GPL+exception) is in place.
 #include "scpainter.h"
 #include "scpaths.h"
 #include "scraction.h"
+#include "scrastercache.h"
 
 #include "scribusstructs.h"
 #include "scribusdoc.h"
@@ -134,20 +136,11 @@ void PageItem_Symbol::DrawObj_Item(ScPainter *p, const QRectF& /*e*/)
 	p->setFillRule(fillRule);
 	p->beginLayer(1.0 - fillTransparency(), fillBlendmode(), &PoLine);
 	p->setMaskMode(0);
-	ScPattern pat = m_Doc->docPatterns[m_patternName];
+	const ScPattern& pat = m_Doc->docPatterns[m_patternName];
 	p->scale(m_width / pat.width, m_height / pat.height);
 //		p->translate(pat.items.at(0)->gXpos, pat.items.at(0)->gYpos);
-	for (int em = 0; em < pat.items.count(); ++em)
-	{
-		PageItem* embedded = pat.items.at(em);
-		p->save();
-		p->translate(embedded->gXpos, embedded->gYpos);
-		embedded->isEmbedded = true;
-		embedded->invalid = true;
-		embedded->DrawObj(p, QRectF());
-		embedded->isEmbedded = false;
-		p->restore();
-	}
+	if (!DrawObj_PatternCached(p, pat))
+		DrawObj_Pattern(p, pat);
 	p->endLayer();
 	p->restore();
 	if (m_Doc->layerOutline(m_layerID))
@@ -161,6 +154,62 @@ void PageItem_Symbol::DrawObj_Item(ScPainter *p, const QRectF& /*e*/)
 	}
 }
 
+void PageItem_Symbol::DrawObj_Pattern(ScPainter *p, const ScPattern& pattern)
+{
+	for (int em = 0; em < pattern.items.count(); ++em)
+	{
+		PageItem* embedded = pattern.items.at(em);
+		p->save();
+		p->translate(embedded->gXpos, embedded->gYpos);
+		embedded->isEmbedded = true;
+		embedded->invalid = true;
+		embedded->DrawObj(p, QRectF());
+		embedded->isEmbedded = false;
+		p->restore();
+	}
+}
+
+bool PageItem_Symbol::DrawObj_PatternCached(ScPainter *p, const ScPattern& pattern)
+{
+	// Symbols are meant to be placed many times, mostly at the same size.
+	// Each placement relayouts and redraws every item of the symbol, so
+	// render the content once and paint the result for all instances.
+	const QTransform matrix = p->worldMatrix();
+	if (!matrix.isInvertible())
+		return false;
+	const double dpr = p->devicePixelRatio();
+	ScRasterCache::Placement surfacePlace = ScRasterCache::placement(QRectF(0.0, 0.0, pattern.width, pattern.height), matrix, dpr);
+	if (surfacePlace.isEmpty())
+		return true;
+	if (surfacePlace.pixelCount() > ScRasterCache::maxSurfacePixels / 4)
+		return false;
+
+	QByteArray key;
+	QDataStream keyStream(&key, QIODevice::WriteOnly);
+	keyStream << QByteArray("symbol") << quint64(quintptr(m_Doc)) << m_Doc->contentRevision() << m_patternName << surfacePlace.width << surfacePlace.height << dpr << p->zoomFactor();
+	keyStream << surfacePlace.matrix;
+	// Items of the symbol are drawn differently in preview mode and with guides shown
+	const GuidesPrefs& guides = m_Doc->guidesPrefs();
+	keyStream << m_Doc->drawAsPreview << m_Doc->viewAsPreview << m_Doc->previewVisual << PrefsManager::instance().appPrefs.displayPrefs.showVerifierWarningsOnCanvas;
+	keyStream << guides.framesShown << guides.tableCellFramesShown << guides.colBordersShown << guides.layerMarkersShown << guides.linkShown << guides.showPic << guides.showControls;
+
+	QImage surface;
+	if (!ScRasterCache::instance().find(key, surface))
+	{
+		surface = QImage(surfacePlace.width, surfacePlace.height, QImage::Format_ARGB32_Premultiplied);
+		surface.setDevicePixelRatio(dpr);
+		surface.fill(Qt::transparent);
+		ScPainter painter(&surface, surfacePlace.width, surfacePlace.height, 1.0, 0);
+		painter.setZoomFactor(p->zoomFactor());
+		painter.setWorldMatrix(surfacePlace.matrix);
+		DrawObj_Pattern(&painter, pattern);
+		painter.end();
+		ScRasterCache::instance().insert(key, surface, m_Doc);
+	}
+	p->drawDeviceImage(surface, surfacePlace.origin, 1.0, 0);
+	return true;
+}
+
 void PageItem_Symbol::applicableActions(QStringList & actionList)
 {
 }
@@ -28,6 +28,7 @@ for which a new license (GPL+exception) is in place.
 #include "scribusapi.h"
 #include "pageitem.h"
 class ScPainter;
+class ScPattern;
 class ScribusDoc;
 
 
@@ -50,6 +51,15 @@ public:
 protected:
 	 void DrawObj_Item(ScPainter *p, const QRectF& e) override;
 
+private:
+	void DrawObj_Pattern(ScPainter *p, const ScPattern& pattern);
+	/**
+	 * Draws the symbol content from a surface rendered once per symbol, size,
+	 * zoom level and document revision and shared by all instances.
+	 * Returns false if the content has to be drawn item by item.
+	 */
+	bool DrawObj_PatternCached(ScPainter *p, const ScPattern& pattern);
+
 };
 
 #endif 
@@ -62,6 +62,41 @@ PageItem_Table::PageItem_Table(ScribusDoc *pa, double x, double y, double w, dou
 	ASSERT_VALID();
 }
 
+PageItem_Table::PageItem_Table(const PageItem_Table& other) :
+	PageItem(other),
+	m_rows(other.m_rows), m_columns(other.m_columns),
+	m_rowPositions(other.m_rowPositions), m_rowHeights(other.m_rowHeights),
+	m_columnPositions(other.m_columnPositions), m_columnWidths(other.m_columnWidths),
+	m_cellAreas(other.m_cellAreas),
+	m_style(other.m_style),
+	m_tablePainter(new CollapsedTablePainter(this))
+{
+	m_style.setContext(&m_Doc->tableStyles());
+	rebuildAreaStyles();
+
+	m_cellRows.reserve(m_rows);
+	for (const QList<TableCell>& otherRow : other.m_cellRows)
+	{
+		QList<TableCell> cellRow;
+		cellRow.reserve(m_columns);
+		for (const TableCell& otherCell : otherRow)
+			cellRow.append(otherCell.copyFor(this));
+		m_cellRows.append(cellRow);
+	}
+
+	// Listen to changes in the document-wide cell/table style contexts.
+	m_Doc->tableStyles().connect(this, SLOT(handleStyleChanged()));
+	m_Doc->cellStyles().connect(this, SLOT(handleStyleChanged()));
+
+	m_activeCell = cellAt(0, 0);
+
+	doc()->dontResize = true;
+	updateCells();
+	doc()->dontResize = false;
+
+	ASSERT_VALID();
+}
+
 PageItem_Table::~PageItem_Table()
 {
 	delete m_tablePainter;
@@ -397,6 +432,19 @@ void PageItem_Table::replaceNamedResources(ResourceCollection& newNames)
 	}
 }
 
+void PageItem_Table::invalidateLayout()
+{
+	PageItem::invalidateLayout();
+
+	// Cell text frames are not document items, document wide invalidations
+	// have to be forwarded to them.
+	for (const QList<TableCell>& cellRow : std::as_const(m_cellRows))
+	{
+		for (const TableCell& cell : cellRow)
+			cell.textFrame()->invalidateLayout();
+	}
+}
+
 void PageItem_Table::layout()
 {
 	int rowCount = rows();
@@ -901,8 +949,9 @@ void PageItem_Table::resizeRow(int row, double height, ResizeStrategy strategy)
 	else
 		qWarning("Unknown resize strategy!");
 
-	// Update cells. TODO: Not for entire table.
-	updateCells();
+	// Update cells of the resized row and of the rows moved or resized with it.
+	const int endRow = (strategy == ResizeFollowing) ? qMin(row + 1, rows() - 1) : rows() - 1;
+	updateCells(row, 0, endRow, columns() - 1);
 
 	emit changed();
 
@@ -1062,8 +1111,9 @@ void PageItem_Table::resizeColumn(int column, double width, ResizeStrategy strat
 	else
 		qWarning("Unknown resize strategy!");
 
-	// Update cells. TODO: Not for entire table.
-	updateCells();
+	// Update cells of the resized column and of the columns moved or resized with it.
+	const int endColumn = (strategy == ResizeFollowing) ? qMin(column + 1, columns() - 1) : columns() - 1;
+	updateCells(0, column, rows() - 1, endColumn);
 
 	emit changed();
 
@@ -1310,7 +1360,7 @@ TableCell PageItem_Table::cellAt(int row, int column) const
 
 TableCell PageItem_Table::cellAt(const QPointF& point) const
 {
-	QPointF gridPoint = getTransform().inverted().map(point) - gridOffset();
+	QPointF gridPoint = getInverseTransform().map(point) - gridOffset();
 
 	if (!QRectF(0, 0, tableWidth(), tableHeight()).contains(gridPoint))
 		return TableCell(); // Outside table grid.
@@ -1396,7 +1446,7 @@ void PageItem_Table::moveTo(const TableCell& cell)
 
 TableHandle PageItem_Table::hitTest(const QPointF& point, double threshold) const
 {
-	const QPointF framePoint = getTransform().inverted().map(point);
+	const QPointF framePoint = getInverseTransform().map(point);
 	const QPointF gridPoint = framePoint - gridOffset();
 	const QRectF gridRect(0.0, 0.0, tableWidth(), tableHeight());
 
@@ -2400,9 +2450,20 @@ void PageItem_Table::updateCells(int startRow, int startColumn, int endRow, int
 		}
 	}
 
-	foreach (const QList<TableCell>& cellRow, m_cellRows)
-		foreach (TableCell cell, cellRow)
-			cell.updateContent();
+	// Cells only lay out their text again if their content size changed.
+	for (int row = startRow; row <= endRow; ++row)
+	{
+		for (int column = startColumn; column <= endColumn; ++column)
+			m_cellRows[row][column].updateContent();
+	}
+
+	// Merged cells starting before the area may reach into it.
+	CellArea updatedArea(startRow, startColumn, endColumn - startColumn + 1, endRow - startRow + 1);
+	for (const CellArea& area : std::as_const(m_cellAreas))
+	{
+		if ((area.row() < startRow || area.column() < startColumn) && updatedArea.intersects(area))
+			m_cellRows[area.row()][area.column()].updateContent();
+	}
 }
 
 void PageItem_Table::updateSpans(int index, int number, ChangeType changeType)
@@ -142,6 +142,9 @@ public:
 	/// Construct a new table item with @a numRows rows and @a numColumns columns.
 	PageItem_Table(ScribusDoc *pa, double x, double y, double w, double h, double w2, const QString& fill, const QString& outline, int numRows = 1, int numColumns = 1);
 
+	/// Construct a copy of @a other. Cells get copies of the text frames of the cells of @a other.
+	PageItem_Table(const PageItem_Table& other);
+
 	/// Destructor.
 	~PageItem_Table();
 
@@ -275,7 +278,9 @@ public:
 	/// content of all cells starting in this row at their current widths,
 	/// honoring text distance padding. Returns the row's current height
 	/// if no cells contribute to the calculation (e.g. row only contains
-	/// cells merged from earlier rows).
+	/// cells merged from earlier rows). Cell text frames cache their
+	/// natural height, so only cells whose text or width changed since
+	/// the last call are laid out again.
 	double naturalRowHeight(int row, bool* hasContent = nullptr);
 
 	/// Resizes the row to its natural content height, leaving the row
@@ -283,7 +288,8 @@ public:
 	/// naturalRowHeight(). Returns true if the row height changed.
 	bool adjustRowHeight(int row, bool growOnly = false);
 
-	/// Calls adjustRowHeight() on every row.
+	/// Calls adjustRowHeight() on every row. Only cells whose content size
+	/// changes are laid out again.
 	void adjustAllRowHeights();
 
 	/// Returns true if the given row is shorter than the natural height its
@@ -659,6 +665,9 @@ public:
 	/// Replace named resource of table and its cells
 	void replaceNamedResources(ResourceCollection& newNames) override;
 
+	/// Invalidates the layout of the table and of all cell text frames
+	void invalidateLayout() override;
+
 	/// creates valid layout information
 	void layout() override;
 
@@ -3039,6 +3039,8 @@ void PageItem_TextFrame::invalidateLayout(int firstChar)
 
 void PageItem_TextFrame::slotInvalidateLayout(int firstItem, int /*endItem*/)
 {
+	m_naturalHeightValid = false;
+
 	PageItem* firstFrame = firstInChain();
 	firstItem = itemText.prevParagraph(firstItem);
 
@@ -6064,8 +6066,28 @@ void PageItem_TextFrame::setTextFrameHeight()
 	m_Doc->changedPagePreview();
 }
 
+PageItem_TextFrame::NaturalHeightKey PageItem_TextFrame::naturalHeightKey() const
+{
+	NaturalHeightKey key;
+	key.width = m_width;
+	key.columns = m_columns;
+	key.columnGap = m_columnGap;
+	key.left = textToFrameDistLeft();
+	key.right = textToFrameDistRight();
+	key.top = textToFrameDistTop();
+	key.bottom = textToFrameDistBottom();
+	return key;
+}
+
 double PageItem_TextFrame::naturalContentHeight()
 {
+	// Table row fitting asks every cell for its natural height, each
+	// answer costing several full layouts. Reuse the previous answer
+	// while neither the story nor the relevant geometry has changed.
+	const NaturalHeightKey key = naturalHeightKey();
+	if (m_naturalHeightValid && m_naturalHeightKey == key)
+		return m_naturalHeight;
+
 	// Temporarily expand the frame, iterating if needed, until layout
 	// reports a height strictly less than what we gave it -- meaning
 	// the layout had room to spare and the natural height is honest.
@@ -6107,5 +6129,8 @@ double PageItem_TextFrame::naturalContentHeight()
 	invalidateLayout(false);
 	layout();
 
-	return std::ceil(height);
+	m_naturalHeight = std::ceil(height);
+	m_naturalHeightKey = key;
+	m_naturalHeightValid = true;
+	return m_naturalHeight;
 }
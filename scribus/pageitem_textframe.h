@@ -91,7 +91,7 @@ public:
 	//for speed up updates when changed was only one frame from chain
 	virtual void invalidateLayout(bool wholeChain);
 	virtual void invalidateLayout(int firstChar);
-	using PageItem::invalidateLayout;
+	void invalidateLayout() override { m_naturalHeightValid = false; invalid = true; }
 	void layout() override;
 
 	//return true if all previous frames from chain are valid (including that one)
@@ -188,6 +188,32 @@ protected:
 public:
 	void setTextFrameHeight();
 	double naturalContentHeight();
+
+private:
+	/// Geometry naturalContentHeight() was last computed for. The cached
+	/// height is reused as long as the story did not change and the frame
+	/// still has the same width, columns and text distances.
+	struct NaturalHeightKey
+	{
+		double width {0.0};
+		int columns {0};
+		double columnGap {0.0};
+		double left {0.0};
+		double right {0.0};
+		double top {0.0};
+		double bottom {0.0};
+
+		bool operator==(const NaturalHeightKey& other) const
+		{
+			return width == other.width && columns == other.columns && columnGap == other.columnGap
+				&& left == other.left && right == other.right && top == other.top && bottom == other.bottom;
+		}
+	};
+	NaturalHeightKey naturalHeightKey() const;
+
+	bool m_naturalHeightValid {false};
+	double m_naturalHeight {0.0};
+	NaturalHeightKey m_naturalHeightKey;
 };
 
 #endif
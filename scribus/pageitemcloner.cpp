@@ -0,0 +1,227 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include "pageitemcloner.h"
+
+#include "pageitem.h"
+#include "pageitem_group.h"
+#include "pageitem_imageframe.h"
+#include "pageitem_line.h"
+#include "pageitem_pathtext.h"
+#include "pageitem_polygon.h"
+#include "pageitem_polyline.h"
+#include "pageitem_symbol.h"
+#include "pageitem_table.h"
+#include "pageitem_textframe.h"
+#include "scpage.h"
+#include "scribusdoc.h"
+#include "text/specialchars.h"
+#include "undomanager.h"
+#include "undostate.h"
+
+PageItemCloner::PageItemCloner(ScribusDoc* doc) :
+	m_doc(doc)
+{
+}
+
+bool PageItemCloner::canClone(const QList<PageItem*>& items) const
+{
+	if (items.isEmpty())
+		return false;
+	QSet<const PageItem*> itemSet;
+	collectItems(items, itemSet);
+	for (const PageItem* item : items)
+	{
+		if (!canCloneItem(item, itemSet))
+			return false;
+	}
+	return true;
+}
+
+void PageItemCloner::collectItems(const QList<PageItem*>& items, QSet<const PageItem*>& itemSet) const
+{
+	for (const PageItem* item : items)
+	{
+		itemSet.insert(item);
+		if (item->isGroup())
+			collectItems(item->groupItemList, itemSet);
+	}
+}
+
+bool PageItemCloner::canCloneItem(const PageItem* item, const QSet<const PageItem*>& itemSet) const
+{
+	switch (item->itemType())
+	{
+		case PageItem::ImageFrame:
+		case PageItem::Line:
+		case PageItem::Polygon:
+		case PageItem::PolyLine:
+		case PageItem::Symbol:
+			break;
+		case PageItem::TextFrame:
+		case PageItem::PathText:
+			// Inline frames, marks and notes are owned by the document and referenced
+			// from the text, they are only duplicated correctly by the SLA code
+			if (item->itemText.plainText().contains(SpecialChars::OBJECT))
+				return false;
+			for (const PageItem* frame = item->prevInChain(); frame; frame = frame->prevInChain())
+			{
+				if (!itemSet.contains(frame))
+					return false;
+			}
+			for (const PageItem* frame = item->nextInChain(); frame; frame = frame->nextInChain())
+			{
+				if (!itemSet.contains(frame))
+					return false;
+			}
+			break;
+		case PageItem::Group:
+			for (const PageItem* child : item->groupItemList)
+			{
+				if (!canCloneItem(child, itemSet))
+					return false;
+			}
+			break;
+		case PageItem::Table:
+			for (const QList<TableCell>& cellRow : item->asTable()->cellRows())
+			{
+				for (const TableCell& cell : cellRow)
+				{
+					if (cell.textFrame()->itemText.plainText().contains(SpecialChars::OBJECT))
+						return false;
+				}
+			}
+			break;
+		default:
+			return false;
+	}
+	if (item->isTableItem || item->isEmbedded || !item->OnMasterPage.isEmpty())
+		return false;
+	return true;
+}
+
+QList<PageItem*> PageItemCloner::clone(const QList<PageItem*>& items, double dX, double dY, int layerID)
+{
+	QList<PageItem*> clones;
+	m_clones.clear();
+	for (PageItem* item : items)
+	{
+		PageItem* clone = cloneItem(item, nullptr, layerID);
+		if (!clone)
+			continue;
+		m_doc->Items->append(clone);
+		clones.append(clone);
+	}
+	relinkClones();
+
+	for (PageItem* clone : std::as_const(clones))
+	{
+		clone->moveBy(dX, dY, true);
+		if (clone->isGroup())
+			m_doc->GroupOnPage(clone);
+		else
+			clone->OwnPage = m_doc->OnPage(clone);
+		if (UndoManager::undoEnabled())
+		{
+			auto *is = new ScItemState<PageItem*>("Create PageItem");
+			is->set("CREATE_ITEM");
+			is->setItem(clone);
+			UndoObject *target = m_doc->Pages->at((clone->OwnPage > -1) ? clone->OwnPage : 0);
+			UndoManager::instance()->action(target, is);
+		}
+	}
+	m_clones.clear();
+	return clones;
+}
+
+PageItem* PageItemCloner::cloneItem(PageItem* item, PageItem* parent, int layerID)
+{
+	PageItem* clone = nullptr;
+	switch (item->itemType())
+	{
+		case PageItem::ImageFrame:
+			clone = new PageItem_ImageFrame(*item);
+			break;
+		case PageItem::TextFrame:
+			clone = new PageItem_TextFrame(*item);
+			break;
+		case PageItem::Line:
+			clone = new PageItem_Line(*item);
+			break;
+		case PageItem::Polygon:
+			clone = new PageItem_Polygon(*item);
+			break;
+		case PageItem::PolyLine:
+			clone = new PageItem_PolyLine(*item);
+			break;
+		case PageItem::PathText:
+			clone = new PageItem_PathText(*item);
+			break;
+		case PageItem::Group:
+			clone = new PageItem_Group(*item);
+			break;
+		case PageItem::Symbol:
+			clone = new PageItem_Symbol(*item);
+			break;
+		case PageItem::Table:
+			clone = new PageItem_Table(*item->asTable());
+			break;
+		default:
+			return nullptr;
+	}
+	m_clones.insert(item, clone);
+	clone->setSelected(false);
+	clone->Parent = parent;
+	clone->m_layerID = layerID;
+
+	// The copy constructor shares the story with the original. Frames following
+	// the first one of a chain get the story of their predecessor when relinking.
+	if (item->isTextFrame() || item->isPathText())
+	{
+		if (item->prevInChain())
+			clone->itemText = StoryText(m_doc);
+		else
+			clone->itemText = item->itemText.copy();
+	}
+
+	if (item->isGroup())
+	{
+		clone->groupItemList.clear();
+		for (PageItem* child : std::as_const(item->groupItemList))
+		{
+			PageItem* childClone = cloneItem(child, clone, layerID);
+			if (childClone)
+				clone->groupItemList.append(childClone);
+		}
+	}
+	return clone;
+}
+
+void PageItemCloner::relinkClones()
+{
+	for (auto it = m_clones.cbegin(); it != m_clones.cend(); ++it)
+	{
+		PageItem* item = it.key();
+		PageItem* clone = it.value();
+
+		PageItem* next = item->nextInChain();
+		if (next && m_clones.contains(next))
+			clone->link(m_clones.value(next), false);
+
+		for (const PageItem::WeldingInfo& weld : std::as_const(item->weldList))
+		{
+			PageItem* weldClone = m_clones.value(weld.weldItem, nullptr);
+			if (!weldClone)
+				continue;
+			PageItem::WeldingInfo cloneWeld;
+			cloneWeld.weldItem = weldClone;
+			cloneWeld.weldPoint = weld.weldPoint;
+			cloneWeld.weldID = weld.weldID;
+			clone->weldList.append(cloneWeld);
+		}
+	}
+}
@@ -0,0 +1,62 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef PAGEITEMCLONER_H
+#define PAGEITEMCLONER_H
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+
+#include "scribusapi.h"
+
+class PageItem;
+class ScribusDoc;
+
+/**
+  * @brief Duplicates page items in memory instead of serializing them to SLA and parsing them back
+  *
+  * Clones share implicitly shared data such as images, paths and gradients with
+  * the original items. Stories are deep copied, groups are cloned recursively, and
+  * text chains and welds between cloned items are rebuilt between the clones.
+  * Tables are cloned with copies of their cells and cell text frames.
+  * Items which cannot be cloned reliably this way (legacy table items, render
+  * frames, note frames, text containing inline objects or marks...) are reported
+  * by canClone(), callers then use ScriXmlDoc as before.
+  */
+class SCRIBUS_API PageItemCloner
+{
+public:
+	explicit PageItemCloner(ScribusDoc* doc);
+
+	/**
+	  * @brief Returns true if all items can be cloned with clone()
+	  * @param items top-level items, text frames must be cloned together with their whole chain
+	  */
+	bool canClone(const QList<PageItem*>& items) const;
+
+	/**
+	  * @brief Clones items and appends the clones to the document item list
+	  * @param items top-level items, in stacking order
+	  * @param dX horizontal offset applied to the clones
+	  * @param dY vertical offset applied to the clones
+	  * @param layerID layer the clones are placed on
+	  * @return the cloned top-level items, in the same order as items
+	  */
+	QList<PageItem*> clone(const QList<PageItem*>& items, double dX, double dY, int layerID);
+
+private:
+	ScribusDoc* m_doc { nullptr };
+	QHash<PageItem*, PageItem*> m_clones;
+
+	bool canCloneItem(const PageItem* item, const QSet<const PageItem*>& itemSet) const;
+	void collectItems(const QList<PageItem*>& items, QSet<const PageItem*>& itemSet) const;
+	PageItem* cloneItem(PageItem* item, PageItem* parent, int layerID);
+	void relinkClones();
+};
+
+#endif
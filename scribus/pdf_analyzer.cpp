@@ -85,12 +85,9 @@ static void generateKWNameMap()
 PDFAnalyzer::PDFAnalyzer(QString & filename)
  : m_filename(filename)
 {
-	static bool nameMapInited = false;
-	if (!nameMapInited)
-	{
-		generateKWNameMap();
-		nameMapInited = true;
-	}
+	// Placed PDFs are inspected on several threads by the preflight verifier
+	static const bool nameMapInited = (generateKWNameMap(), true);
+	Q_UNUSED(nameMapInited);
 
 #if (PODOFO_VERSION < PODOFO_MAKE_VERSION(0, 10, 0))
 	PdfError::EnableDebug( false );
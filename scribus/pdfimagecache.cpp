@@ -0,0 +1,129 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+#include "pdfimagecache.h"
+#include "scpaths.h"
+
+namespace
+{
+	const quint32 cacheMagic = 0x53435049; // "SCPI"
+	const quint32 cacheVersion = 1;
+}
+
+PdfImageStreamCache& PdfImageStreamCache::instance()
+{
+	static PdfImageStreamCache cache;
+	return cache;
+}
+
+PdfImageStreamCache::PdfImageStreamCache()
+	: m_dir(ScPaths::pdfImageCacheDir())
+{
+}
+
+QString PdfImageStreamCache::fileName(const QByteArray& key) const
+{
+	return m_dir + QString::fromLatin1(key) + ".pdfimg";
+}
+
+bool PdfImageStreamCache::load(const QByteArray& key, PdfPreparedImage& image) const
+{
+	if (key.isEmpty())
+		return false;
+	QFile file(fileName(key));
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	QDataStream ds(&file);
+	quint32 magic = 0;
+	quint32 version = 0;
+	QByteArray storedKey;
+	ds >> magic >> version >> storedKey;
+	if ((magic != cacheMagic) || (version != cacheVersion) || (storedKey != key))
+		return false;
+
+	PdfPreparedImage entry;
+	qint32 colorSpace = 0;
+	qint32 compression = 0;
+	qint32 outType = 0;
+	ds >> colorSpace >> entry.grayProfile >> entry.isBitmapFromGS;
+	ds >> entry.reso >> entry.sxa >> entry.sya;
+	ds >> entry.width >> entry.height >> entry.maskWidth >> entry.maskHeight;
+	ds >> entry.mask >> entry.maskCompressed;
+	ds >> compression >> outType >> entry.data;
+	if ((ds.status() != QDataStream::Ok) || entry.data.isEmpty())
+		return false;
+	entry.colorSpace = static_cast<ColorSpaceEnum>(colorSpace);
+	entry.compression = static_cast<PDFOptions::PDFCompression>(compression);
+	entry.outType = static_cast<ColorSpaceEnum>(outType);
+	image = std::move(entry);
+
+	// Mark the entry as recently used for prune()
+	file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+	return true;
+}
+
+bool PdfImageStreamCache::store(const QByteArray& key, const PdfPreparedImage& image)
+{
+	if (key.isEmpty() || (image.error != PdfPreparedImage::NoError) || image.data.isEmpty())
+		return false;
+	{
+		QMutexLocker locker(&m_mutex);
+		QDir dir(m_dir);
+		if (!dir.exists() && !dir.mkpath(m_dir))
+			return false;
+	}
+
+	// QSaveFile writes to a temporary file first, so concurrent exports
+	// never see a partially written entry
+	QSaveFile file(fileName(key));
+	if (!file.open(QIODevice::WriteOnly))
+		return false;
+	QDataStream ds(&file);
+	ds << cacheMagic << cacheVersion << key;
+	ds << static_cast<qint32>(image.colorSpace) << image.grayProfile << image.isBitmapFromGS;
+	ds << image.reso << image.sxa << image.sya;
+	ds << image.width << image.height << image.maskWidth << image.maskHeight;
+	ds << image.mask << image.maskCompressed;
+	ds << static_cast<qint32>(image.compression) << static_cast<qint32>(image.outType) << image.data;
+	if (ds.status() != QDataStream::Ok)
+	{
+		file.cancelWriting();
+		return false;
+	}
+	return file.commit();
+}
+
+void PdfImageStreamCache::prune()
+{
+	QMutexLocker locker(&m_mutex);
+	QDir dir(m_dir);
+	if (!dir.exists())
+		return;
+	const QFileInfoList entries = dir.entryInfoList(QStringList() << "*.pdfimg", QDir::Files, QDir::Time);
+	qint64 totalSize = 0;
+	for (const QFileInfo& entry : entries)
+	{
+		totalSize += entry.size();
+		if (totalSize > m_maxSize)
+			QFile::remove(entry.absoluteFilePath());
+	}
+}
+
+void PdfImageStreamCache::setMaxSize(qint64 bytes)
+{
+	QMutexLocker locker(&m_mutex);
+	m_maxSize = bytes;
+}
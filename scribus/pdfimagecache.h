@@ -0,0 +1,94 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef PDFIMAGECACHE_H
+#define PDFIMAGECACHE_H
+
+#include "scribusapi.h"
+
+#include <QByteArray>
+#include <QMutex>
+#include <QString>
+
+#include "pdfoptions.h"
+#include "scimagestructs.h"
+
+/**
+  * @brief Image of a frame, loaded and encoded as it will be written to a PDF file
+  *
+  * Everything the PDF exporter needs to write the image and mask objects
+  * without touching the source file again. The data is not encrypted yet,
+  * encryption depends on the object number assigned when the image is written.
+  */
+struct PdfPreparedImage
+{
+	enum Error
+	{
+		NoError,
+		LoadFailed,
+		MaskFailed,
+		WriteFailed
+	};
+
+	Error error { NoError };
+	ColorSpaceEnum colorSpace { ColorSpaceRGB }; //!< Color space of the loaded image, before effects were applied
+	bool grayProfile { false };   //!< Whether the image was prepared for a gray ICC profile
+	bool isBitmapFromGS { false };
+	double reso { 1.0 };
+	double sxa { 0.0 };
+	double sya { 0.0 };
+	int width { 0 };
+	int height { 0 };
+	int maskWidth { 0 };
+	int maskHeight { 0 };
+	QByteArray mask;
+	bool maskCompressed { false };
+	PDFOptions::PDFCompression compression { PDFOptions::Compression_None };
+	ColorSpaceEnum outType { ColorSpaceRGB };
+	QByteArray data;
+
+	qint64 size() const { return data.size() + mask.size(); }
+};
+
+/**
+  * @brief Persistent cache of encoded PDF image streams
+  *
+  * Entries are stored in ScPaths::pdfImageCacheDir(), one file per entry,
+  * named after a hash of everything that influences the encoded stream
+  * (source file and modification time, color options, resolution,
+  * compression and quality). A modified image or changed export settings
+  * thus simply produce a new key. Reading an entry refreshes its timestamp
+  * and prune() removes the least recently used entries once the cache grows
+  * past its size limit. The cache may be used from several threads.
+  */
+class SCRIBUS_API PdfImageStreamCache
+{
+public:
+	static PdfImageStreamCache& instance();
+
+	bool load(const QByteArray& key, PdfPreparedImage& image) const;
+	bool store(const QByteArray& key, const PdfPreparedImage& image);
+
+	/// Removes the oldest entries until the cache fits in its size limit
+	void prune();
+
+	/// Sets the size limit in bytes
+	void setMaxSize(qint64 bytes);
+
+private:
+	PdfImageStreamCache();
+	PdfImageStreamCache(const PdfImageStreamCache&) = delete;
+	PdfImageStreamCache& operator=(const PdfImageStreamCache&) = delete;
+
+	QString fileName(const QByteArray& key) const;
+
+	QString m_dir;
+	qint64 m_maxSize { 1024 * 1024 * 1024 };
+	QMutex m_mutex;
+};
+
+#endif
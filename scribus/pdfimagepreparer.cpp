@@ -0,0 +1,138 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QMutexLocker>
+
+#include "pdfimagepreparer.h"
+
+PdfImagePreparer::PdfImagePreparer(const PrepareFunction& prepare, int threadCount, qint64 memoryBudget)
+	: m_prepare(prepare),
+	m_threadCount(qMax(1, threadCount)),
+	m_memoryBudget(memoryBudget)
+{
+}
+
+PdfImagePreparer::~PdfImagePreparer()
+{
+	{
+		QMutexLocker locker(&m_mutex);
+		m_stop = true;
+		m_budgetFreed.wakeAll();
+	}
+	for (QThread* thread : std::as_const(m_threads))
+	{
+		thread->wait();
+		delete thread;
+	}
+}
+
+void PdfImagePreparer::addJob(const Job& job)
+{
+	Q_ASSERT(!m_started);
+	if (job.key.isEmpty() || m_index.contains(job.key))
+		return;
+	m_index.insert(job.key, static_cast<int>(m_entries.size()));
+	Entry entry;
+	entry.job = job;
+	m_entries.push_back(entry);
+}
+
+void PdfImagePreparer::start()
+{
+	if (m_started)
+		return;
+	m_started = true;
+	int threads = qMin(m_threadCount, jobCount());
+	for (int i = 0; i < threads; ++i)
+	{
+		QThread* thread = new PdfImagePrepareThread(this);
+		m_threads.append(thread);
+		thread->start(QThread::LowPriority);
+	}
+}
+
+bool PdfImagePreparer::take(const QByteArray& key, PdfPreparedImage& image)
+{
+	QMutexLocker locker(&m_mutex);
+	auto it = m_index.constFind(key);
+	if (it == m_index.constEnd())
+		return false;
+	Entry& entry = m_entries[it.value()];
+	// Not started by a worker yet: the caller is quicker preparing it itself
+	if (entry.state == Queued)
+	{
+		entry.state = Taken;
+		return false;
+	}
+	while (entry.state == Running)
+		m_jobDone.wait(&m_mutex);
+	if (entry.state != Done)
+		return false;
+	image = std::move(entry.image);
+	entry.image = PdfPreparedImage();
+	entry.state = Taken;
+	m_pendingBytes -= image.size();
+	m_budgetFreed.wakeAll();
+	return true;
+}
+
+void PdfImagePreparer::discard(const QByteArray& key)
+{
+	QMutexLocker locker(&m_mutex);
+	auto it = m_index.constFind(key);
+	if (it == m_index.constEnd())
+		return;
+	Entry& entry = m_entries[it.value()];
+	if (entry.state == Running)
+	{
+		entry.discarded = true;
+		return;
+	}
+	if (entry.state == Done)
+	{
+		m_pendingBytes -= entry.image.size();
+		entry.image = PdfPreparedImage();
+		m_budgetFreed.wakeAll();
+	}
+	entry.state = Taken;
+}
+
+void PdfImagePreparer::work()
+{
+	QMutexLocker locker(&m_mutex);
+	while (!m_stop)
+	{
+		while (!m_stop && (m_pendingBytes > m_memoryBudget))
+			m_budgetFreed.wait(&m_mutex);
+		while ((m_next < m_entries.size()) && (m_entries[m_next].state != Queued))
+			++m_next;
+		if (m_stop || (m_next >= m_entries.size()))
+			break;
+		Entry& entry = m_entries[m_next++];
+		entry.state = Running;
+
+		locker.unlock();
+		PdfPreparedImage image;
+		m_prepare(entry.job, image);
+		locker.relock();
+
+		if (entry.discarded)
+			entry.state = Taken;
+		else
+		{
+			entry.image = std::move(image);
+			entry.state = Done;
+			m_pendingBytes += entry.image.size();
+		}
+		m_jobDone.wakeAll();
+	}
+}
+
+void PdfImagePrepareThread::run()
+{
+	m_preparer->work();
+}
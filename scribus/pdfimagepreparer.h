@@ -0,0 +1,120 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef PDFIMAGEPREPARER_H
+#define PDFIMAGEPREPARER_H
+
+#include <functional>
+#include <vector>
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QWaitCondition>
+
+#include "colormgmt/sccolormgmtstructs.h"
+#include "pdfimagecache.h"
+#include "scribusapi.h"
+
+class PageItem;
+
+/**
+  * @brief Loads and encodes the images of a PDF export ahead of the writer
+  *
+  * The exporter queues the images of the exported pages in the order it will
+  * write them, then starts the preparer. Worker threads load, convert and
+  * compress the images in that order while the exporter keeps writing pages,
+  * and the exporter collects each result with take() when it reaches the
+  * image. If the exporter gets to an image no worker has started yet, take()
+  * returns false and the image is prepared inline as before.
+  *
+  * Workers pause while the prepared but not yet collected images exceed the
+  * memory budget, so that a long document cannot pile up its images in memory.
+  */
+class SCRIBUS_API PdfImagePreparer
+{
+	friend class PdfImagePrepareThread;
+
+public:
+	struct Job
+	{
+		QByteArray key;
+		PageItem* item { nullptr };
+		QString fileName;
+		double sx { 1.0 };
+		double sy { 1.0 };
+		QString profile;
+		bool embedded { false };
+		eRenderIntent intent { Intent_Relative_Colorimetric };
+	};
+
+	using PrepareFunction = std::function<void(const Job&, PdfPreparedImage&)>;
+
+	PdfImagePreparer(const PrepareFunction& prepare, int threadCount, qint64 memoryBudget = 256 * 1024 * 1024);
+	~PdfImagePreparer();
+
+	/// Queues a job, jobs with an already queued key are ignored. Must be called before start().
+	void addJob(const Job& job);
+	int jobCount() const { return static_cast<int>(m_entries.size()); }
+
+	void start();
+
+	/// Returns the prepared image for key, waiting for it if a worker is busy with it
+	bool take(const QByteArray& key, PdfPreparedImage& image);
+	/// Tells the preparer the image for key will not be collected
+	void discard(const QByteArray& key);
+
+private:
+	enum State
+	{
+		Queued,
+		Running,
+		Done,
+		Taken
+	};
+
+	struct Entry
+	{
+		Job job;
+		State state { Queued };
+		bool discarded { false };
+		PdfPreparedImage image;
+	};
+
+	void work();
+
+	PrepareFunction m_prepare;
+	int m_threadCount { 1 };
+	qint64 m_memoryBudget { 0 };
+	qint64 m_pendingBytes { 0 };
+	std::vector<Entry> m_entries;
+	QHash<QByteArray, int> m_index;
+	size_t m_next { 0 };
+	bool m_started { false };
+	bool m_stop { false };
+	QMutex m_mutex;
+	QWaitCondition m_jobDone;
+	QWaitCondition m_budgetFreed;
+	QList<QThread*> m_threads;
+};
+
+class PdfImagePrepareThread : public QThread
+{
+public:
+	explicit PdfImagePrepareThread(PdfImagePreparer* preparer) : m_preparer(preparer) {}
+
+protected:
+	void run() override;
+
+private:
+	PdfImagePreparer* m_preparer { nullptr };
+};
+
+#endif
@@ -31,6 +31,11 @@ bool PDFlib::doExport(const QString& fn, const std::vector<int> & pageNs, const
 	return static_cast<PDFLibCore*>(m_impl)->doExport(fn, pageNs, thumbs);
 }
 
+bool PDFlib::doExportRecords(const QString& fn, const std::vector<int> & pageNs, int recordCount, const std::function<bool(int)>& prepareRecord, const QMap<QString, QMap<uint, QString> >& recordFonts)
+{
+	return static_cast<PDFLibCore*>(m_impl)->doExportRecords(fn, pageNs, recordCount, prepareRecord, recordFonts);
+}
+
 const QString& PDFlib::errorMessage()
 {
 	return static_cast<PDFLibCore*>(m_impl)->errorMessage();
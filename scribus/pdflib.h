@@ -11,6 +11,7 @@ for which a new license (GPL+exception) is in place.
 #include <QObject>
 #include <QImage>
 #include <QMap>
+#include <functional>
 #include <vector>
 
 #include "scconfig.h"
@@ -53,6 +54,20 @@ public:
 	 */
 	bool doExport(const QString& fn, const std::vector<int> & pageNs, const QMap<int, QImage>& thumbs);
 
+	/**
+	 * Export the same pages once per record, as done by a data merge.
+	 *
+	 * All records end up in a single file and share fonts, images and master pages.
+	 * Page thumbnails, if enabled, are left blank.
+	 *
+	 * \param fn Output file name
+	 * \param pageNs List of pages from document to be exported for each record
+	 * \param recordCount Number of records
+	 * \param prepareRecord Called to set up the document for a record before its pages are written, returning false aborts the export
+	 * \param recordFonts Glyphs used by any record which may not be in use by the document in its current state
+	 */
+	bool doExportRecords(const QString& fn, const std::vector<int> & pageNs, int recordCount, const std::function<bool(int)>& prepareRecord, const QMap<QString, QMap<uint, QString> >& recordFonts);
+
 	/**
 	 * Return an error message in case export has failed.
 	 */
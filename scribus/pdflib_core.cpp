@@ -39,6 +39,7 @@ for which a new license (GPL+exception) is in place.
 
 #include "rc4.h"
 
+#include <QBuffer>
 #include <QByteArray>
 #include <QCryptographicHash>
 #include <QDateTime>
@@ -53,10 +54,12 @@ for which a new license (GPL+exception) is in place.
 #include <QRect>
 #include <QRegularExpression>
 #include <QScopedPointer>
+#include <QSet>
 #include <QStack>
 #include <QString>
 #include <QTemporaryFile>
 #include <QTextCodec>
+#include <QThread>
 #include <QUuid>
 
 #include "cmsettings.h"
@@ -65,6 +68,8 @@ for which a new license (GPL+exception) is in place.
 #include "pageitem_textframe.h"
 #include "pageitem_group.h"
 #include "pageitem_table.h"
+#include "pdfimagecache.h"
+#include "pdfimagepreparer.h"
 #include "pdfoptions.h"
 #include "prefsmanager.h"
 #include "sccolor.h"
@@ -601,6 +606,7 @@ PDFLibCore::PDFLibCore(ScribusDoc & docu, const PDFOptions& options)
 
 PDFLibCore::~PDFLibCore()
 {
+	delete m_imagePreparer;
 	delete progressDialog;
 }
 
@@ -643,6 +649,7 @@ bool PDFLibCore::doExport(const QString& fn, const std::vector<int> & pageNs, co
 	int  pc_exportmasterpages = 0;
 	if (usingGUI)
 		progressDialog->show();
+	doc.loadDeferredImages(pageNs);
 
 	ucs2Codec = QTextCodec::codecForName("ISO-10646-UCS-2");
 	if (!ucs2Codec)
@@ -662,13 +669,14 @@ bool PDFLibCore::doExport(const QString& fn, const std::vector<int> & pageNs, co
 		}
 		if (usingGUI)
 		{
-			progressDialog->setOverallTotalSteps(pageNsMpa.count() + pageNs.size());
+			progressDialog->setOverallTotalSteps(pageNsMpa.count() + pageNs.size() * m_recordCount);
 			progressDialog->setTotalSteps("EMP", pageNsMpa.count());
-			progressDialog->setTotalSteps("EP", pageNs.size());
+			progressDialog->setTotalSteps("EP", pageNs.size() * m_recordCount);
 			progressDialog->setOverallProgress(0);
 			progressDialog->setProgress("EMP", 0);
 			progressDialog->setProgress("EP", 0);
 		}
+		PDF_PrepareImages(pageNs);
 		for (int ap = 0; ap < doc.MasterPages.count() && !abortExport; ++ap)
 		{
 			if (doc.MasterItems.count() != 0)
@@ -687,28 +695,36 @@ bool PDFLibCore::doExport(const QString& fn, const std::vector<int> & pageNs, co
 				progressDialog->setOverallProgress(pc_exportmasterpages+pc_exportpages);
 			}
 		}
-		for (uint a = 0; a < pageNs.size() && !abortExport; ++a)
+		for (int record = 0; record < m_recordCount && !abortExport; ++record)
 		{
-			if (Options.Thumbnails)
-				thumb = thumbs[pageNs[a]];
-			QApplication::processEvents();
-			if (abortExport) break;
+			if (m_prepareRecord && !m_prepareRecord(record))
+			{
+				error = abortExport = true;
+				break;
+			}
+			for (uint a = 0; a < pageNs.size() && !abortExport; ++a)
+			{
+				if (Options.Thumbnails)
+					thumb = thumbs[pageNs[a]];
+				QApplication::processEvents();
+				if (abortExport) break;
 
-			PDF_Begin_Page(doc.DocPages.at(pageNs[a]-1), thumb);
-			QApplication::processEvents();
-			if (abortExport) break;
+				PDF_Begin_Page(doc.DocPages.at(pageNs[a]-1), thumb);
+				QApplication::processEvents();
+				if (abortExport) break;
 
-			if (!PDF_ProcessPage(doc.DocPages.at(pageNs[a]-1), pageNs[a]-1, Options.doClip))
-				error = abortExport = true;
-			QApplication::processEvents();
-			if (abortExport) break;
+				if (!PDF_ProcessPage(doc.DocPages.at(pageNs[a]-1), pageNs[a]-1, Options.doClip))
+					error = abortExport = true;
+				QApplication::processEvents();
+				if (abortExport) break;
 
-			PDF_End_Page();
-			pc_exportpages++;
-			if (usingGUI)
-			{
-				progressDialog->setProgress("EP", pc_exportpages);
-				progressDialog->setOverallProgress(pc_exportmasterpages+pc_exportpages);
+				PDF_End_Page();
+				pc_exportpages++;
+				if (usingGUI)
+				{
+					progressDialog->setProgress("EP", pc_exportpages);
+					progressDialog->setOverallProgress(pc_exportmasterpages+pc_exportpages);
+				}
 			}
 		}
 		ret = true;//Even when aborting we return true. Don't want that "couldn't write msg"
@@ -721,12 +737,33 @@ bool PDFLibCore::doExport(const QString& fn, const std::vector<int> & pageNs, co
 		}
 		else
 			closeAndCleanup();
+		delete m_imagePreparer;
+		m_imagePreparer = nullptr;
+		PdfImageStreamCache::instance().prune();
 	}
 	if (usingGUI)
 		progressDialog->close();
 	return (ret && !error);
 }
 
+bool PDFLibCore::doExportRecords(const QString& fn, const std::vector<int> & pageNs, int recordCount, const std::function<bool(int)>& prepareRecord, const QMap<QString, QMap<uint, QString> >& recordFonts)
+{
+	m_recordCount = recordCount;
+	m_prepareRecord = prepareRecord;
+	m_recordFonts = recordFonts;
+
+	// Pages differ from record to record, a single thumbnail per page would be misleading
+	QMap<int, QImage> thumbs;
+	if (Options.Thumbnails)
+	{
+		QImage blank(10, 10, QImage::Format_ARGB32_Premultiplied);
+		blank.fill(Qt::white);
+		for (int pageNr : pageNs)
+			thumbs.insert(pageNr, blank);
+	}
+	return doExport(fn, pageNs, thumbs);
+}
+
 const QString& PDFLibCore::errorMessage() const
 {
 	return ErrorMessage;
@@ -854,96 +891,32 @@ bool PDFLibCore::EncodeArrayToStream(const QByteArray& in, PdfId ObjNum)
 	return (writer.getOutStream().status() == QDataStream::Ok);
 }
 
-int PDFLibCore::WriteImageToStream(const ScImage& image, PdfId ObjNum, ColorSpaceEnum format, bool precal)
-{
-	bool fromCmyk, succeed = false;
-	int  bytesWritten = 0;
-
-	ScStreamFilter* rc4Encode = writer.openStreamFilter(Options.Encrypt, ObjNum);
-	if (rc4Encode->openFilter())
-	{
-		switch (format)
-		{
-			case ColorSpaceMonochrome :
-				fromCmyk = !Options.UseRGB && !Options.isGrayscale && !(doc.HasCMS && Options.UseProfiles2);
-				succeed = image.writeMonochromeDataToFilter(rc4Encode, fromCmyk); break;
-			case ColorSpaceGray :
-				succeed = image.writeGrayDataToFilter(rc4Encode, precal); break;
-			case ColorSpaceCMYK :
-				succeed = image.writeCMYKDataToFilter(rc4Encode); break;
-			default :
-				succeed = image.writeRGBDataToFilter(rc4Encode); break;
-		}
-		succeed &= rc4Encode->closeFilter();
-		bytesWritten = rc4Encode->writtenToStream();
-		delete rc4Encode;
-	}
-	return (succeed ? bytesWritten : 0);
-}
-
-int PDFLibCore::WriteJPEGImageToStream(ScImage& image, const QString& fn, PdfId ObjNum, int quality, ColorSpaceEnum format,
-										 bool sameFile, bool precal)
+bool PDFLibCore::WriteImageToFilter(const ScImage& image, ScStreamFilter* filter, ColorSpaceEnum format, bool precal) const
 {
-	bool succeed = true;
-	int  bytesWritten = 0;
-	QFileInfo fInfo(fn);
-	QString   ext = fInfo.suffix().toLower();
-	QString   jpgFileName, tmpFile;
-	if (extensionIndicatesJPEG(ext) && sameFile)
-		jpgFileName = fn;
-	else
+	bool fromCmyk;
+	switch (format)
 	{
-		tmpFile  = QDir::toNativeSeparators(ScPaths::tempFileDir() + "sc.jpg");
-		if (format == ColorSpaceGray && (!precal))
-			image.convertToGray();
-		if (image.convert2JPG(tmpFile, quality, format == ColorSpaceCMYK, format == ColorSpaceGray))
-			jpgFileName = tmpFile;
+		case ColorSpaceMonochrome :
+			fromCmyk = !Options.UseRGB && !Options.isGrayscale && !(doc.HasCMS && Options.UseProfiles2);
+			return image.writeMonochromeDataToFilter(filter, fromCmyk);
+		case ColorSpaceGray :
+			return image.writeGrayDataToFilter(filter, precal);
+		case ColorSpaceCMYK :
+			return image.writeCMYKDataToFilter(filter);
+		default :
+			return image.writeRGBDataToFilter(filter);
 	}
-	if (jpgFileName.isEmpty())
-		return 0;
-	if (Options.Encrypt)
-	{
-		succeed = false;
-		ScStreamFilter* rc4Encode = writer.openStreamFilter(true, ObjNum);
-		if (rc4Encode->openFilter())
-		{
-			succeed  = copyFileToFilter(jpgFileName, *rc4Encode);
-			succeed &= rc4Encode->closeFilter();
-			bytesWritten = rc4Encode->writtenToStream();
-		}
-		delete rc4Encode;
-	}
-	else
-	{
-		succeed &= copyFileToStream(jpgFileName, writer.getOutStream());
-		QFileInfo jpgInfo(jpgFileName);
-		bytesWritten = jpgInfo.size();
-	}
-	if (!tmpFile.isEmpty() && QFile::exists(tmpFile))
-		QFile::remove(tmpFile);
-	return (succeed ? bytesWritten : 0);
 }
 
 int PDFLibCore::WriteFlateImageToStream(const ScImage& image, PdfId ObjNum, ColorSpaceEnum format, bool precal)
 {
-	bool fromCmyk, succeed = false;
+	bool succeed = false;
 	int  bytesWritten = 0;
 	ScStreamFilter* rc4Encode = writer.openStreamFilter(Options.Encrypt, ObjNum);
-	ScFlateEncodeFilter flateEncode(rc4Encode);
+	ScFlateEncodeFilter flateEncode(rc4Encode, Options.zlibCompressionLevel());
 	if (flateEncode.openFilter())
 	{
-		switch (format)
-		{
-			case ColorSpaceMonochrome :
-				fromCmyk = !Options.UseRGB && !Options.isGrayscale && !(doc.HasCMS && Options.UseProfiles2);
-				succeed = image.writeMonochromeDataToFilter(&flateEncode, fromCmyk); break;
-			case ColorSpaceGray :
-				succeed = image.writeGrayDataToFilter(&flateEncode, precal); break;
-			case ColorSpaceCMYK :
-				succeed = image.writeCMYKDataToFilter(&flateEncode); break;
-			default :
-				succeed = image.writeRGBDataToFilter(&flateEncode); break;
-		}
+		succeed  = WriteImageToFilter(image, &flateEncode, format, precal);
 		succeed &= flateEncode.closeFilter();
 		bytesWritten = flateEncode.writtenToStream();
 	}
@@ -1165,6 +1138,9 @@ PDFLibCore::PDF_Begin_FindUsedFonts()
 
 	QMap<QString, QMap<uint, QString> > usedFonts;
 	doc.getUsedFonts(usedFonts);
+	// Glyphs used by the other records of a record export only
+	for (auto it = m_recordFonts.cbegin(); it != m_recordFonts.cend(); ++it)
+		usedFonts[it.key()].insert(it.value());
 
 	QList<PageItem*> allItems = doc.FrameItems.values();
 	while (allItems.count() > 0)
@@ -1422,7 +1398,7 @@ PdfFont PDFLibCore::PDF_WriteType3Font(const QByteArray& name, ScFace& face, con
 		PdfId charProcObject = writer.newObject();
 		writer.startObj(charProcObject);
 		if (Options.Compress)
-			fon = CompressArray(fon);
+			fon = CompressArray(fon, Options.zlibCompressionLevel());
 		PutDoc("<< /Length " + Pdf::toPdf(fon.length() + 1));
 		if (Options.Compress)
 			PutDoc("\n/Filter /FlateDecode");
@@ -1629,7 +1605,7 @@ PdfFont PDFLibCore::PDF_WriteGlyphsAsXForms(const QByteArray& fontName, const Sc
 		PutDoc("/Resources << /ProcSet [/PDF /Text /ImageB /ImageC /ImageI]\n");
 		PutDoc(">>\n");
 		if (Options.Compress)
-			fon = CompressArray(fon);
+			fon = CompressArray(fon, Options.zlibCompressionLevel());
 		PutDoc("/Length " + Pdf::toPdf(fon.length() + 1));
 		if (Options.Compress)
 			PutDoc("\n/Filter /FlateDecode");
@@ -1645,7 +1621,7 @@ PdfId PDFLibCore::PDF_EmbedFontObject(const QByteArray& font, const QByteArray&
 	PdfId embeddedFontObject = writer.newObject();
 	writer.startObj(embeddedFontObject);
 	int len = font.length();
-	QByteArray ttf = (Options.Compress? CompressArray(font) : font);
+	QByteArray ttf = (Options.Compress? CompressArray(font, Options.zlibCompressionLevel()) : font);
 	//qDebug() << QString("sfnt data: size=%1 compressed=%2").arg(len).arg(bb.length());
 	PutDoc("<<\n/Length " + Pdf::toPdf(ttf.length() + 1) + "\n");
 	PutDoc("/Length1 " + Pdf::toPdf(len) + "\n");
@@ -2203,7 +2179,7 @@ PdfId PDFLibCore::PDF_EmbedType1AsciiFontObject(const QByteArray& fon)
 	fon2 += hexData;
 	fon2 += fon.mid(len2);
 	if (Options.Compress)
-		fon2 = CompressArray(fon2);
+		fon2 = CompressArray(fon2, Options.zlibCompressionLevel());
 	PutDoc("<<\n/Length " + Pdf::toPdf(fon2.length() + 1) + "\n");
 	PutDoc("/Length1 " + Pdf::toPdf(len1 + 1) + "\n");
 	PutDoc("/Length2 " + Pdf::toPdf(hexData.length()) + "\n");
@@ -2255,7 +2231,7 @@ PdfId PDFLibCore::PDF_EmbedType1BinaryFontObject(const QByteArray& bb)
 	}
 	int len3 = fon.length() - len2 - len1;
 	if (Options.Compress)
-		fon = CompressArray(fon);
+		fon = CompressArray(fon, Options.zlibCompressionLevel());
 	PutDoc("<<\n/Length " + Pdf::toPdf(fon.length() + 1) + "\n");
 	PutDoc("/Length1 " + Pdf::toPdf(len1) + "\n");
 	PutDoc("/Length2 " + Pdf::toPdf(len2) + "\n");
@@ -2456,7 +2432,7 @@ void PDFLibCore::PDF_Begin_Colors()
 		PutDoc("<<\n");
 		if (Options.Compress)
 		{
-			QByteArray compData = CompressArray(dataP);
+			QByteArray compData = CompressArray(dataP, Options.zlibCompressionLevel());
 			if (compData.size() > 0)
 			{
 				PutDoc("/Filter /FlateDecode\n");
@@ -3243,7 +3219,7 @@ bool PDFLibCore::PDF_TemplatePage(const ScPage* pag, bool)
 			writer.write(dict);
 				
 			if (Options.Compress)
-				Content = CompressArray(Content);
+				Content = CompressArray(Content, Options.zlibCompressionLevel());
 			PutDoc("/Length " + Pdf::toPdf(Content.length() + 1));
 			if (Options.Compress)
 				PutDoc("\n/Filter /FlateDecode");
@@ -3278,7 +3254,7 @@ void PDFLibCore::PDF_Begin_Page(const ScPage* pag, const QImage& thumb)
 		QByteArray array = img.ImageToArray();
 		if (Options.Compress)
 		{
-			QByteArray compArray = CompressArray(array);
+			QByteArray compArray = CompressArray(array, Options.zlibCompressionLevel());
 			if (compArray.size() > 0)
 			{
 				array = compArray;
@@ -3869,7 +3845,7 @@ bool PDFLibCore::PDF_ProcessMasterElements(const ScLayer& layer, const ScPage* p
 		PutDoc("/BBox [ " + FToStr(-bleedLeft) + " " + FToStr(-Options.bleeds.bottom()) + " " + FToStr(maxBoxX) + " " + FToStr(maxBoxY) + " ]\n");
 		PutDoc("/Group " + QByteArray::number(Gobj) + " 0 R\n");
 		if (Options.Compress)
-			content = CompressArray(content);
+			content = CompressArray(content, Options.zlibCompressionLevel());
 		PutDoc("/Length " + QByteArray::number(content.length() + 1));
 		if (Options.Compress)
 			PutDoc("\n/Filter /FlateDecode");
@@ -3948,7 +3924,7 @@ bool PDFLibCore::PDF_ProcessPageElements(const ScLayer& layer, const ScPage* pag
 		PutDoc("/BBox [ " + FToStr(-bleedLeft) + " " + FToStr(-Options.bleeds.bottom()) + " " + FToStr(maxBoxX) + " " + FToStr(maxBoxY) + " ]\n");
 		PutDoc("/Group " + Pdf::toPdf(Gobj) + " 0 R\n");
 		if (Options.Compress)
-			inh = CompressArray(inh);
+			inh = CompressArray(inh, Options.zlibCompressionLevel());
 		PutDoc("/Length " + Pdf::toPdf(inh.length() + 1));
 		if (Options.Compress)
 			PutDoc("\n/Filter /FlateDecode");
@@ -4009,7 +3985,7 @@ QByteArray PDFLibCore::Write_FormXObject(QByteArray &data, const PageItem *contr
 	writer.write(dict);
 
 	if (Options.Compress)
-		data = CompressArray(data);
+		data = CompressArray(data, Options.zlibCompressionLevel());
 	PutDoc("/Length " + QByteArray::number(data.length() + 1));
 	if (Options.Compress)
 		PutDoc("\n/Filter /FlateDecode");
@@ -4098,7 +4074,7 @@ QByteArray PDFLibCore::Write_TransparencyGroup(double trans, int blend, QByteArr
 	writer.write(dict);
 
 	if (Options.Compress)
-		data = CompressArray(data);
+		data = CompressArray(data, Options.zlibCompressionLevel());
 	PutDoc("/Length " + Pdf::toPdf(data.length() + 1));
 	if (Options.Compress)
 		PutDoc("\n/Filter /FlateDecode");
@@ -4245,7 +4221,7 @@ QByteArray PDFLibCore::PDF_PutSoftShadow(PageItem* ite)
 	softMaskGroupData += "Q";
 	if (Options.Compress)
 	{
-		softMaskGroupData = CompressArray(softMaskGroupData);
+		softMaskGroupData = CompressArray(softMaskGroupData, Options.zlibCompressionLevel());
 		PutDoc("/Filter /FlateDecode\n");
 	}
 	PutDoc("/Length " + Pdf::toPdf(softMaskGroupData.length()) + "\n");
@@ -6313,7 +6289,7 @@ QByteArray PDFLibCore::PDF_TransparenzFill(const PageItem *currItem)
 		stre += "/Pattern" + Pdf::toPdf(patObject) + " scn\nf*\n";
 		stre += "Q\n";
 		if (Options.Compress)
-			stre = CompressArray(stre);
+			stre = CompressArray(stre, Options.zlibCompressionLevel());
 		PutDoc("/Length " + Pdf::toPdf(stre.length()) + "\n");
 		if (Options.Compress)
 			PutDoc("/Filter /FlateDecode\n");
@@ -6375,7 +6351,7 @@ QByteArray PDFLibCore::PDF_TransparenzFill(const PageItem *currItem)
 		stre += tmpOut + " f*\n";
 		stre += "Q\n";
 		if (Options.Compress)
-			stre = CompressArray(stre);
+			stre = CompressArray(stre, Options.zlibCompressionLevel());
 		PutDoc("/Length " + Pdf::toPdf(stre.length()) + "\n");
 		if (Options.Compress)
 			PutDoc("/Filter /FlateDecode\n");
@@ -6554,7 +6530,7 @@ bool PDFLibCore::PDF_PatternFillStroke(QByteArray& output, const PageItem *currI
 		tmp2 += "Q\n";
 	}
 	if (Options.Compress)
-		tmp2 = CompressArray(tmp2);
+		tmp2 = CompressArray(tmp2, Options.zlibCompressionLevel());
 	PdfId patObject = writer.newObject();
 	writer.startObj(patObject);
 	PutDoc("<< /Type /Pattern\n");
@@ -6830,7 +6806,7 @@ bool PDFLibCore::PDF_MeshGradientFill(QByteArray& output, const PageItem *c)
 			dat += vertStreamT[vd];
 		}
 		if (Options.Compress)
-			dat = CompressArray(dat);
+			dat = CompressArray(dat, Options.zlibCompressionLevel());
 		PutDoc("/Length " + Pdf::toPdf(dat.length()) + "\n");
 		if (Options.Compress)
 			PutDoc("/Filter /FlateDecode\n");
@@ -6864,7 +6840,7 @@ bool PDFLibCore::PDF_MeshGradientFill(QByteArray& output, const PageItem *c)
 		stre += "/Pattern" + Pdf::toPdf(patObject) + " scn\nf*\n";
 		stre += "Q\n";
 		if (Options.Compress)
-			stre = CompressArray(stre);
+			stre = CompressArray(stre, Options.zlibCompressionLevel());
 		PutDoc("/Length " + Pdf::toPdf(stre.length()) + "\n");
 		if (Options.Compress)
 			PutDoc("/Filter /FlateDecode\n");
@@ -6961,7 +6937,7 @@ bool PDFLibCore::PDF_MeshGradientFill(QByteArray& output, const PageItem *c)
 		dat += vertStream[vd];
 	}
 	if (Options.Compress)
-		dat = CompressArray(dat);
+		dat = CompressArray(dat, Options.zlibCompressionLevel());
 	PutDoc("/Length " + Pdf::toPdf(dat.length()) + "\n");
 	if (Options.Compress)
 		PutDoc("/Filter /FlateDecode\n");
@@ -7154,7 +7130,7 @@ bool PDFLibCore::PDF_PatchMeshGradientFill(QByteArray& output, const PageItem *c
 			dat += vertStreamT[vd];
 		}
 		if (Options.Compress)
-			dat = CompressArray(dat);
+			dat = CompressArray(dat, Options.zlibCompressionLevel());
 		PutDoc("/Length " + Pdf::toPdf(dat.length()) + "\n");
 		if (Options.Compress)
 			PutDoc("/Filter /FlateDecode\n");
@@ -7187,7 +7163,7 @@ bool PDFLibCore::PDF_PatchMeshGradientFill(QByteArray& output, const PageItem *c
 		stre += "/Pattern" + Pdf::toPdf(patObject) + " scn\nf*\n";
 		stre += "Q\n";
 		if (Options.Compress)
-			stre = CompressArray(stre);
+			stre = CompressArray(stre, Options.zlibCompressionLevel());
 		PutDoc("/Length " + Pdf::toPdf(stre.length()) + "\n");
 		if (Options.Compress)
 			PutDoc("/Filter /FlateDecode\n");
@@ -7282,7 +7258,7 @@ bool PDFLibCore::PDF_PatchMeshGradientFill(QByteArray& output, const PageItem *c
 		dat += vertStream[vd];
 	}
 	if (Options.Compress)
-		dat = CompressArray(dat);
+		dat = CompressArray(dat, Options.zlibCompressionLevel());
 	PutDoc("/Length " + Pdf::toPdf(dat.length()) + "\n");
 	if (Options.Compress)
 		PutDoc("/Filter /FlateDecode\n");
@@ -7514,7 +7490,7 @@ bool PDFLibCore::PDF_DiamondGradientFill(QByteArray& output, const PageItem *c)
 			dat += vertStreamT[vd];
 		}
 		if (Options.Compress)
-			dat = CompressArray(dat);
+			dat = CompressArray(dat, Options.zlibCompressionLevel());
 		PutDoc("/Length " + Pdf::toPdf(dat.length()) + "\n");
 		if (Options.Compress)
 			PutDoc("/Filter /FlateDecode\n");
@@ -7547,7 +7523,7 @@ bool PDFLibCore::PDF_DiamondGradientFill(QByteArray& output, const PageItem *c)
 		stre += "/Pattern" + Pdf::toPdf(patObject) + " scn\nf*\n";
 		stre += "Q\n";
 		if (Options.Compress)
-			stre = CompressArray(stre);
+			stre = CompressArray(stre, Options.zlibCompressionLevel());
 		PutDoc("/Length " + Pdf::toPdf(stre.length()) + "\n");
 		if (Options.Compress)
 			PutDoc("/Filter /FlateDecode\n");
@@ -7715,7 +7691,7 @@ bool PDFLibCore::PDF_DiamondGradientFill(QByteArray& output, const PageItem *c)
 		dat += vertStream[vd];
 	}
 	if (Options.Compress)
-		dat = CompressArray(dat);
+		dat = CompressArray(dat, Options.zlibCompressionLevel());
 	PutDoc("/Length " + Pdf::toPdf(dat.length()) + "\n");
 	if (Options.Compress)
 		PutDoc("/Filter /FlateDecode\n");
@@ -7877,7 +7853,7 @@ bool PDFLibCore::PDF_TensorGradientFill(QByteArray& output, const PageItem *c)
 			dat += vertStreamT[vd];
 		}
 		if (Options.Compress)
-			dat = CompressArray(dat);
+			dat = CompressArray(dat, Options.zlibCompressionLevel());
 		PutDoc("/Length " + Pdf::toPdf(dat.length()) + "\n");
 		if (Options.Compress)
 			PutDoc("/Filter /FlateDecode\n");
@@ -7910,7 +7886,7 @@ bool PDFLibCore::PDF_TensorGradientFill(QByteArray& output, const PageItem *c)
 		stre += "/Pattern" + Pdf::toPdf(patObject) + " scn\nf*\n";
 		stre += "Q\n";
 		if (Options.Compress)
-			stre = CompressArray(stre);
+			stre = CompressArray(stre, Options.zlibCompressionLevel());
 		PutDoc("/Length " + Pdf::toPdf(stre.length()) + "\n");
 		if (Options.Compress)
 			PutDoc("/Filter /FlateDecode\n");
@@ -8035,7 +8011,7 @@ bool PDFLibCore::PDF_TensorGradientFill(QByteArray& output, const PageItem *c)
 		dat += vertStream[vd];
 	}
 	if (Options.Compress)
-		dat = CompressArray(dat);
+		dat = CompressArray(dat, Options.zlibCompressionLevel());
 	PutDoc("/Length " + Pdf::toPdf(dat.length()) + "\n");
 	if (Options.Compress)
 		PutDoc("/Filter /FlateDecode\n");
@@ -8382,7 +8358,7 @@ bool PDFLibCore::PDF_GradientFillStroke(QByteArray& output, const PageItem *curr
 		}
 		stre += "Q\n";
 		if (Options.Compress)
-			stre = CompressArray(stre);
+			stre = CompressArray(stre, Options.zlibCompressionLevel());
 		PutDoc("/Length " + Pdf::toPdf(stre.length()) + "\n");
 		if (Options.Compress)
 			PutDoc("/Filter /FlateDecode\n");
@@ -8650,7 +8626,7 @@ bool PDFLibCore::PDF_3DAnnotation(PageItem *ite, uint)
 	loadRawBytes(imgName, dataP);
 	if ((Options.CompressMethod != PDFOptions::Compression_None) && Options.Compress)
 	{
-		QByteArray compData = CompressArray(dataP);
+		QByteArray compData = CompressArray(dataP, Options.zlibCompressionLevel());
 		if (compData.size() > 0)
 		{
 			PutDoc("/Filter /FlateDecode\n");
@@ -9718,7 +9694,7 @@ PdfId PDFLibCore::WritePDFStream(const QByteArray& cc, PdfId objId)
 {
 	QByteArray tmp(cc);
 	if (Options.Compress)
-		tmp = CompressArray(tmp);
+		tmp = CompressArray(tmp, Options.zlibCompressionLevel());
 	writer.startObj(objId);
 	PutDoc("<< /Length " + Pdf::toPdf(tmp.length()));  // moeglicherweise + 1
 	if (Options.Compress)
@@ -10601,23 +10577,433 @@ static ColorSpaceEnum getOutputType(const bool gray, const bool cmyk)
  * Add the image item to this.output
  * Returns false if the image can't be read or if it can't be added to this.output
 */
-bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double sy, double x, double y, bool fromAN, const QString& Profil, bool Embedded, eRenderIntent Intent, QByteArray* output)
+QByteArray PDFLibCore::PDF_ImageCacheKey(const PageItem* item, const QString& fn, double sx, double sy, const QString& Profil, bool Embedded, eRenderIntent Intent) const
+{
+	// Bump when the way images are prepared changes, so that stale cache entries are not used
+	static const qint32 cacheFormat = 1;
+
+	// Color effects depend on document colors, LaTeX frames and PDF or PostScript files
+	// are embedded or rasterized by Ghostscript on temporary files: these are always
+	// prepared inline
+	if (item->isLatexFrame() || item->effectsInUse.useColorEffect())
+		return QByteArray();
+	QFileInfo fi(fn);
+	if (!fi.exists())
+		return QByteArray();
+	QString ext = fi.suffix().toLower();
+	if (ext.isEmpty())
+		ext = getImageType(fn);
+	if (extensionIndicatesPDF(ext) || extensionIndicatesEPSorPS(ext))
+		return QByteArray();
+
+	QByteArray keyData;
+	QDataStream ds(&keyData, QIODevice::WriteOnly);
+	ds << cacheFormat;
+	ds << fi.absoluteFilePath() << fi.lastModified().toMSecsSinceEpoch() << fi.size();
+	ds << static_cast<qint32>(item->pixm.imgInfo.actualPageNumber) << static_cast<qint32>(item->pixm.imgInfo.type);
+	ds << item->pixm.imgInfo.isRequest;
+	for (auto it = item->pixm.imgInfo.RequestProps.cbegin(); it != item->pixm.imgInfo.RequestProps.cend(); ++it)
+		ds << static_cast<qint32>(it.key()) << it->visible << it->useMask << it->opacity << it->blend;
+	for (const ImageEffect& effect : item->effectsInUse)
+		ds << static_cast<qint32>(effect.effectCode) << effect.effectParameters;
+
+	ds << Options.UseRGB << Options.isGrayscale << Options.UseProfiles2 << Options.EmbeddedI;
+	ds << static_cast<qint32>(Options.Intent2) << Options.ImageProf << Options.PrintProf;
+	ds << doc.HasCMS << doc.cmsSettings().DefaultImageRGBProfile << doc.cmsSettings().DefaultImageCMYKProfile;
+	ds << doc.cmsSettings().BlackPoint << static_cast<qint32>(doc.IntentImages);
+	ds << Profil << Embedded << static_cast<qint32>(Intent);
+
+	ds << Options.RecalcPic << static_cast<qint32>(Options.PicRes) << static_cast<qint32>(Options.Resolution);
+	ds << static_cast<qint32>(Options.CompressMethod) << Options.Compress << static_cast<qint32>(Options.Quality);
+	ds << static_cast<qint32>(Options.CompressionLevel);
+	ds << item->OverrideCompressionMethod << static_cast<qint32>(item->CompressionMethodIndex);
+	ds << item->OverrideCompressionQuality << static_cast<qint32>(item->CompressionQualityIndex);
+	ds << Options.supportsTransparency();
+	// The scale only matters when images are downsampled
+	if (Options.RecalcPic)
+		ds << sx << sy;
+
+	return QCryptographicHash::hash(keyData, QCryptographicHash::Sha1).toHex();
+}
+
+bool PDFLibCore::PDF_ImageHasGrayProfile(const QString& fn, bool Embedded) const
+{
+	if (!doc.HasCMS || !Options.UseProfiles2 || !Embedded || Options.EmbeddedI)
+		return false;
+	ScImage img;
+	int components = 0;
+	QByteArray profileData;
+	img.getEmbeddedProfile(fn, &profileData, &components);
+	return (!profileData.isEmpty() && (components == 1));
+}
+
+void PDFLibCore::PDF_PrepareImage(PageItem* item, const QString& fn, double sx, double sy, const QString& Profil, bool Embedded, eRenderIntent Intent, const QByteArray& cacheKey, int grayProfile, PdfPreparedImage& prepared) const
 {
 	QFileInfo fi(fn);
 	QString ext = fi.suffix().toLower();
 	if (ext.isEmpty())
 		ext = getImageType(fn);
+	bool hasColorEffect = item->effectsInUse.useColorEffect();
+
+	// grayProfile < 0: assume the image gets a gray ICC profile if its embedded profile is gray,
+	// color effects convert gray images to RGB so such images never get one
+	if (grayProfile < 0)
+		grayProfile = (!hasColorEffect && PDF_ImageHasGrayProfile(fn, Embedded)) ? 1 : 0;
+	QByteArray diskKey;
+	if (!cacheKey.isEmpty())
+	{
+		diskKey = cacheKey + (grayProfile ? "g" : "c");
+		if (PdfImageStreamCache::instance().load(diskKey, prepared))
+			return;
+	}
+
+	prepared = PdfPreparedImage();
+	prepared.grayProfile = (grayProfile > 0);
+	if (Options.RecalcPic)
+		prepared.reso = Options.PicRes / 72.0;
+	else
+		prepared.reso = Options.Resolution / 72.0;
+
 	ScImage img;
-	QString BBox;
-	bool   found = false;
-	bool   alphaM = false;
+	bool   imageLoaded = false;
 	bool   realCMYK = false;
+	bool   downsampled = false;
+	int    afl = Options.Resolution;
+	CMSettings cms(item->doc(), Profil, Intent);
+	cms.setUseEmbeddedProfile(Embedded);
+	if ((extensionIndicatesPDF(ext) || extensionIndicatesEPSorPS(ext)) && (item->pixm.imgInfo.type != ImageType7))
+	{
+		prepared.isBitmapFromGS = true;
+		if (Options.RecalcPic)
+		{
+			afl = qMin(Options.PicRes, Options.Resolution);
+			prepared.reso = afl / 72.0;
+		}
+		ScImage::RequestType requestType = ScImage::RGBData;
+		if (!Options.UseRGB && !(doc.HasCMS && Options.UseProfiles2) && !Options.isGrayscale)
+			requestType = ScImage::CMYKData;
+		bool found = (ext == "pdf");
+		if (!found)
+		{
+			QFile f(fn);
+			if (f.open(QIODevice::ReadOnly))
+			{
+				QDataStream ts(&f);
+				while (!ts.atEnd())
+				{
+					QString tmp = readLineFromDataStream(ts);
+					if (tmp.startsWith("%%BoundingBox"))
+					{
+						found = true;
+						break;
+					}
+					if (tmp.startsWith("%%EndComments"))
+						break;
+				}
+				f.close();
+			}
+		}
+		if (found)
+			imageLoaded = img.loadPicture(fn, item->pixm.imgInfo.actualPageNumber, cms, requestType, afl);
+		if (!imageLoaded)
+		{
+			prepared.error = PdfPreparedImage::LoadFailed;
+			return;
+		}
+		if (Options.RecalcPic)
+		{
+			prepared.sxa = sx * (1.0 / prepared.reso);
+			prepared.sya = sy * (1.0 / prepared.reso);
+		}
+	}
+	// not PS/PDF
+	else
+	{
+		img.imgInfo.valid = false;
+		img.imgInfo.clipPath.clear();
+		img.imgInfo.PDSpathData.clear();
+		img.imgInfo.layerInfo.clear();
+		img.imgInfo.RequestProps = item->pixm.imgInfo.RequestProps;
+		img.imgInfo.isRequest = item->pixm.imgInfo.isRequest;
+		ScImage::RequestType requestType = ScImage::CMYKData;
+		if (Options.UseRGB)
+			requestType = ScImage::RGBData;
+		else if ((doc.HasCMS) && (Options.UseProfiles2))
+			requestType = ScImage::RawData;
+		else if (Options.isGrayscale)
+			requestType = ScImage::RGBData;
+		imageLoaded = img.loadPicture(fn, item->pixm.imgInfo.actualPageNumber, cms, requestType, 72, &realCMYK);
+		if (!imageLoaded)
+		{
+			prepared.error = PdfPreparedImage::LoadFailed;
+			return;
+		}
+		if ((Options.RecalcPic) && (Options.PicRes < (qMax(72.0 / item->imageXScale(), 72.0 / item->imageYScale()))))
+		{
+			double afl = Options.PicRes;
+			double a2 = (72.0 / sx) / afl;
+			double a1 = (72.0 / sy) / afl;
+			double ax = img.width() / a2;
+			double ay = img.height() / a1;
+			// #10510 : do not use scaled() here, may cause display problem 
+			// with acrobat reader if image contains some transparency
+			img.scaleImage(qRound(ax), qRound(ay));
+			prepared.sxa = sx * a2;
+			prepared.sya = sy * a1;
+			downsampled = true;
+		}
+		prepared.reso = 1;
+	}
+	prepared.colorSpace = img.imgInfo.colorspace;
+
+	if (item->pixm.imgInfo.type != ImageType7)
+	{
+		ScImage img2;
+		img2.imgInfo.clipPath.clear();
+		img2.imgInfo.PDSpathData.clear();
+		img2.imgInfo.layerInfo.clear();
+		img2.imgInfo.RequestProps = item->pixm.imgInfo.RequestProps;
+		img2.imgInfo.isRequest = item->pixm.imgInfo.isRequest;
+		if (!img2.getAlpha(fn, item->pixm.imgInfo.actualPageNumber, prepared.mask, true, Options.supportsTransparency(), afl, img.width(), img.height()))
+		{
+			prepared.error = PdfPreparedImage::MaskFailed;
+			return;
+		}
+		if (!prepared.mask.isEmpty() && (Options.CompressMethod != PDFOptions::Compression_None))
+		{
+			QByteArray compAlpha = CompressArray(prepared.mask, Options.zlibCompressionLevel());
+			if (compAlpha.size() > 0)
+			{
+				prepared.mask = compAlpha;
+				prepared.maskCompressed = true;
+			}
+		}
+	}
+	prepared.maskWidth = img.width();
+	prepared.maskHeight = img.height();
+
+	bool imgE = false;
+	if ((Options.UseRGB) || (Options.isGrayscale))
+		imgE = false;
+	else
+		imgE = !((Options.UseProfiles2) && (img.imgInfo.colorspace != ColorSpaceCMYK));
+	img.applyEffect(item->effectsInUse, item->doc()->PageColors, imgE);
+	if (!downsampled)
+	{
+		prepared.sxa = sx * (1.0 / prepared.reso);
+		prepared.sya = sy * (1.0 / prepared.reso);
+	}
+	prepared.width = img.width();
+	prepared.height = img.height();
+
+	enum PDFOptions::PDFCompression compress_method = Options.CompressMethod;
+	enum PDFOptions::PDFCompression cm = Options.CompressMethod;
+	bool exportToCMYK = false;
+	bool exportToGrayscale = false;
+	bool jpegUseOriginal = false;
+	if (!Options.UseRGB && !(doc.HasCMS && Options.UseProfiles2 && !realCMYK))
+	{
+		exportToGrayscale = Options.isGrayscale;
+		if (exportToGrayscale)
+			exportToCMYK = !Options.isGrayscale;
+		else
+			exportToCMYK = !Options.UseRGB;
+	}
+	if (item->OverrideCompressionMethod)
+		compress_method = cm = (enum PDFOptions::PDFCompression) item->CompressionMethodIndex;
+	if (img.imgInfo.colorspace == ColorSpaceMonochrome && item->effectsInUse.isEmpty())
+	{
+		compress_method = (compress_method != PDFOptions::Compression_None) ? PDFOptions::Compression_ZIP : compress_method;
+		cm = compress_method;
+	}
+	if (extensionIndicatesJPEG(ext) && (cm != PDFOptions::Compression_None))
+	{
+		if (((Options.UseRGB || Options.UseProfiles2) && (cm == PDFOptions::Compression_Auto) && item->effectsInUse.isEmpty() && (img.imgInfo.colorspace == ColorSpaceRGB)) && (!img.imgInfo.progressive) && (!downsampled))
+		{
+			// #12961 : we must not rely on PDF viewers taking exif infos into account
+			// So if JPEG orientation is non default, do not use the original file
+			jpegUseOriginal = (img.imgInfo.exifInfo.orientation == 1);
+			cm = PDFOptions::Compression_JPEG;
+		}
+		// We can't unfortunately use directly cmyk jpeg files. Otherwise we have to use the /Decode argument in image
+		// dictionary, which we do not quite want as this argument is simply ignored by some rips and software
+		// amongst which photoshop and illustrator
+		else if (compress_method == PDFOptions::Compression_JPEG)
+		{
+			if (realCMYK || !((Options.UseRGB) || (Options.UseProfiles2)))
+			{
+				exportToGrayscale = Options.isGrayscale;
+				if (exportToGrayscale)
+					exportToCMYK = !Options.isGrayscale;
+				else
+					exportToCMYK = !Options.UseRGB;
+			}
+			cm = PDFOptions::Compression_JPEG;
+		}
+		else
+			cm = PDFOptions::Compression_ZIP;
+	}
+	else if ((compress_method == PDFOptions::Compression_JPEG) || (compress_method == PDFOptions::Compression_Auto))
+	{
+		if (realCMYK || !((Options.UseRGB) || (Options.UseProfiles2)))
+		{
+			exportToGrayscale = Options.isGrayscale;
+			if (exportToGrayscale)
+				exportToCMYK = !Options.isGrayscale;
+			else
+				exportToCMYK = !Options.UseRGB;
+		}
+		cm = PDFOptions::Compression_JPEG;
+	}
+	if (prepared.grayProfile && doc.HasCMS && Options.UseProfiles2)
+		exportToGrayscale = true;
+	// Fixme: outType variable should be set directly in the if/else maze above.
+	if (img.imgInfo.colorspace == ColorSpaceMonochrome && item->effectsInUse.isEmpty())
+		prepared.outType = ColorSpaceMonochrome;
+	else
+		prepared.outType = getOutputType(exportToGrayscale, exportToCMYK);
+	prepared.compression = cm;
+
+	// Encode the image in memory, encryption is applied when the stream is written
+	bool succeed = false;
+	QBuffer buffer(&prepared.data);
+	buffer.open(QIODevice::WriteOnly);
+	if (cm == PDFOptions::Compression_JPEG) // Fixme: should not do this with monochrome images?
+	{
+		int quality = item->OverrideCompressionQuality ? item->CompressionQualityIndex : Options.Quality;
+		if (item->OverrideCompressionQuality)
+			jpegUseOriginal = false;
+		if (extensionIndicatesJPEG(ext) && jpegUseOriginal)
+		{
+			buffer.close();
+			succeed = loadRawBytes(fn, prepared.data);
+		}
+		else
+		{
+			if (prepared.outType == ColorSpaceGray && !prepared.grayProfile)
+				img.convertToGray();
+			succeed = img.convert2JPG(&buffer, quality, prepared.outType == ColorSpaceCMYK, prepared.outType == ColorSpaceGray);
+		}
+	}
+	else
+	{
+		QDataStream ds(&buffer);
+		if (cm == PDFOptions::Compression_ZIP)
+		{
+			ScFlateEncodeFilter flateEncode(&ds, Options.zlibCompressionLevel());
+			if (flateEncode.openFilter())
+			{
+				succeed  = WriteImageToFilter(img, &flateEncode, prepared.outType, prepared.grayProfile);
+				succeed &= flateEncode.closeFilter();
+			}
+		}
+		else
+		{
+			ScNullEncodeFilter nullEncode(&ds);
+			if (nullEncode.openFilter())
+			{
+				succeed  = WriteImageToFilter(img, &nullEncode, prepared.outType, prepared.grayProfile);
+				succeed &= nullEncode.closeFilter();
+			}
+		}
+	}
+	if (!succeed || prepared.data.isEmpty())
+	{
+		prepared.data.clear();
+		prepared.error = PdfPreparedImage::WriteFailed;
+		return;
+	}
+
+	if (!diskKey.isEmpty())
+		PdfImageStreamCache::instance().store(diskKey, prepared);
+}
+
+bool PDFLibCore::PDF_CheckPreparedImage(const PdfPreparedImage& prepared, const QString& fn)
+{
+	switch (prepared.error)
+	{
+		case PdfPreparedImage::LoadFailed:
+			PDF_Error_ImageLoadFailure(fn);
+			return false;
+		case PdfPreparedImage::MaskFailed:
+			PDF_Error_MaskLoadFailure(fn);
+			return false;
+		case PdfPreparedImage::WriteFailed:
+			PDF_Error_ImageWriteFailure(fn);
+			return false;
+		default:
+			return true;
+	}
+}
+
+void PDFLibCore::PDF_PrepareImages(const std::vector<int>& pageNs)
+{
+	// Items of a data merge change from record to record
+	if (m_recordCount > 1)
+		return;
+
+	// Queue the image frames in the order the pages are written: master pages first
+	QList<PageItem*> items;
+	QSet<QString> masterNames;
+	for (int pageNr : pageNs)
+		masterNames.insert(doc.DocPages.at(pageNr - 1)->masterPageName());
+	for (PageItem* item : std::as_const(doc.MasterItems))
+	{
+		if (masterNames.contains(item->OnMasterPage))
+			items.append(item);
+	}
+	QHash<int, QList<PageItem*> > pageItems;
+	for (PageItem* item : std::as_const(doc.DocItems))
+		pageItems[item->OwnPage].append(item);
+	for (int pageNr : pageNs)
+		items.append(pageItems.value(pageNr - 1));
+
+	auto prepare = [this](const PdfImagePreparer::Job& job, PdfPreparedImage& prepared)
+	{
+		PDF_PrepareImage(job.item, job.fileName, job.sx, job.sy, job.profile, job.embedded, job.intent, job.key, -1, prepared);
+	};
+	m_imagePreparer = new PdfImagePreparer(prepare, QThread::idealThreadCount());
+	for (int i = 0; i < items.count(); ++i)
+	{
+		PageItem* item = items.at(i);
+		if (item->isGroup())
+		{
+			items.append(item->groupItemList);
+			continue;
+		}
+		if (!item->isImageFrame() || !item->imageIsAvailable || item->Pfile.isEmpty() || !item->printEnabled())
+			continue;
+		PdfImagePreparer::Job job;
+		job.key = PDF_ImageCacheKey(item, item->Pfile, item->imageXScale(), item->imageYScale(), item->ImageProfile, item->UseEmbedded, item->ImageIntent);
+		if (job.key.isEmpty())
+			continue;
+		job.item = item;
+		job.fileName = item->Pfile;
+		job.sx = item->imageXScale();
+		job.sy = item->imageYScale();
+		job.profile = item->ImageProfile;
+		job.embedded = item->UseEmbedded;
+		job.intent = item->ImageIntent;
+		m_imagePreparer->addJob(job);
+	}
+	if (m_imagePreparer->jobCount() == 0)
+	{
+		delete m_imagePreparer;
+		m_imagePreparer = nullptr;
+		return;
+	}
+	m_imagePreparer->start();
+}
+
+bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double sy, double x, double y, bool fromAN, const QString& Profil, bool Embedded, eRenderIntent Intent, QByteArray* output)
+{
+	QFileInfo fi(fn);
+	QString ext = fi.suffix().toLower();
+	if (ext.isEmpty())
+		ext = getImageType(fn);
 	bool   hasGrayProfile = false;
 	bool   avoidPDFXOutputIntentProf = false;
 	QString profInUse = Profil;
-	int    afl = Options.Resolution;
-	int    origWidth = 1;
-	int    origHeight = 1;
 
 	ShIm   ImInfo;
 	if (Options.RecalcPic)
@@ -10685,142 +11071,12 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 		// no embedded PDF:
 		if (!imageLoaded)
 		{
-			if ((extensionIndicatesPDF(ext) || extensionIndicatesEPSorPS(ext)) && (item->pixm.imgInfo.type != ImageType7))
-			{
-				ImInfo.isBitmapFromGS = true;
-				if (Options.RecalcPic)
-				{
-					afl = qMin(Options.PicRes, Options.Resolution);
-					ImInfo.reso = afl / 72.0;
-				}
-				else
-					afl = Options.Resolution;
-				if (ext == "pdf")
-				{
-					CMSettings cms(item->doc(), Profil, Intent);
-					cms.setUseEmbeddedProfile(Embedded);
-					if (Options.UseRGB)
-						imageLoaded = img.loadPicture(fn, item->pixm.imgInfo.actualPageNumber, cms, ScImage::RGBData, afl);
-					else
-					{
-						if ((doc.HasCMS) && (Options.UseProfiles2))
-							imageLoaded = img.loadPicture(fn, item->pixm.imgInfo.actualPageNumber, cms, ScImage::RGBData, afl);
-						else
-						{
-							if (Options.isGrayscale)
-								imageLoaded = img.loadPicture(fn, item->pixm.imgInfo.actualPageNumber, cms, ScImage::RGBData, afl);
-							else
-								imageLoaded = img.loadPicture(fn, item->pixm.imgInfo.actualPageNumber, cms, ScImage::CMYKData, afl);
-						}
-					}
-				}
-				else
-				{
-					QFile f(fn);
-					if (f.open(QIODevice::ReadOnly))
-					{
-						QDataStream ts(&f);
-						while (!ts.atEnd())
-						{
-							QString tmp = readLineFromDataStream(ts);
-							if (tmp.startsWith("%%BoundingBox:"))
-							{
-								found = true;
-								BBox = tmp.remove("%%BoundingBox:");
-							}
-							if (!found)
-							{
-								if (tmp.startsWith("%%BoundingBox"))
-								{
-									found = true;
-									BBox = tmp.remove("%%BoundingBox");
-								}
-							}
-							if (tmp.startsWith("%%EndComments"))
-								break;
-						}
-						// BBox is not used...
-						
-						f.close();
-						if (found)
-						{
-							CMSettings cms(item->doc(), Profil, Intent);
-							cms.setUseEmbeddedProfile(Embedded);
-							if (Options.UseRGB)
-								imageLoaded = img.loadPicture(fn, item->pixm.imgInfo.actualPageNumber, cms, ScImage::RGBData, afl);
-							else
-							{
-								if ((doc.HasCMS) && (Options.UseProfiles2))
-									imageLoaded = img.loadPicture(fn, item->pixm.imgInfo.actualPageNumber, cms, ScImage::RGBData, afl);
-								else
-								{
-									if (Options.isGrayscale)
-										imageLoaded = img.loadPicture(fn, item->pixm.imgInfo.actualPageNumber, cms, ScImage::RGBData, afl);
-									else
-										imageLoaded = img.loadPicture(fn, item->pixm.imgInfo.actualPageNumber, cms, ScImage::CMYKData, afl);
-								}
-							}
-						}
-					}
-				}
-				if (!imageLoaded)
-				{
-					PDF_Error_ImageLoadFailure(fn);
-					return false;
-				}
-				if (Options.RecalcPic)
-				{
-					ImInfo.sxa = sx * (1.0 / ImInfo.reso);
-					ImInfo.sya = sy * (1.0 / ImInfo.reso);
-				}
-			}
-			// not PS/PDF
-			else
-			{
-				img.imgInfo.valid = false;
-				img.imgInfo.clipPath.clear();
-				img.imgInfo.PDSpathData.clear();
-				img.imgInfo.layerInfo.clear();
-				img.imgInfo.RequestProps = item->pixm.imgInfo.RequestProps;
-				img.imgInfo.isRequest = item->pixm.imgInfo.isRequest;
-				CMSettings cms(item->doc(), Profil, Intent);
-				cms.setUseEmbeddedProfile(Embedded);
-				if (Options.UseRGB)
-					imageLoaded = img.loadPicture(fn, item->pixm.imgInfo.actualPageNumber, cms, ScImage::RGBData, 72, &realCMYK);
-				else
-				{
-					if ((doc.HasCMS) && (Options.UseProfiles2))
-						imageLoaded = img.loadPicture(fn, item->pixm.imgInfo.actualPageNumber, cms, ScImage::RawData, 72, &realCMYK);
-					else
-					{
-						if (Options.isGrayscale)
-							imageLoaded = img.loadPicture(fn, item->pixm.imgInfo.actualPageNumber, cms, ScImage::RGBData, 72, &realCMYK);
-						else
-							imageLoaded = img.loadPicture(fn, item->pixm.imgInfo.actualPageNumber, cms, ScImage::CMYKData, 72, &realCMYK);
-					}
-				}
-				if (!imageLoaded)
-				{
-					PDF_Error_ImageLoadFailure(fn);
-					return false;
-				}
-				if ((Options.RecalcPic) && (Options.PicRes < (qMax(72.0 / item->imageXScale(), 72.0 / item->imageYScale()))))
-				{
-					double afl = Options.PicRes;
-					double a2 = (72.0 / sx) / afl;
-					double a1 = (72.0 / sy) / afl;
-					origWidth = img.width();
-					origHeight = img.height();
-					double ax = img.width() / a2;
-					double ay = img.height() / a1;
-					// #10510 : do not use scaled() here, may cause display problem 
-					// with acrobat reader if image contains some transparency
-					img.scaleImage(qRound(ax), qRound(ay));
-					ImInfo.sxa = sx * a2;
-					ImInfo.sya = sy * a1;
-				}
-				ImInfo.reso = 1;
-			}
+			QByteArray cacheKey = PDF_ImageCacheKey(item, fn, sx, sy, Profil, Embedded, Intent);
+			PdfPreparedImage prepared;
+			if (!m_imagePreparer || !m_imagePreparer->take(cacheKey, prepared))
+				PDF_PrepareImage(item, fn, sx, sy, Profil, Embedded, Intent, cacheKey, -1, prepared);
+			if (!PDF_CheckPreparedImage(prepared, fn))
+				return false;
 			bool hasColorEffect = item->effectsInUse.useColorEffect();
 			if ((doc.HasCMS) && (Options.UseProfiles2))
 			{
@@ -10831,9 +11087,9 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 					QByteArray dataP;
 					if (Embedded && !Options.EmbeddedI)
 						img3.getEmbeddedProfile(fn, &dataP, &components);
-					if ((dataP.isEmpty()) || ((img.imgInfo.colorspace == ColorSpaceGray) && hasColorEffect && (components == 1)))
+					if ((dataP.isEmpty()) || ((prepared.colorSpace == ColorSpaceGray) && hasColorEffect && (components == 1)))
 					{
-						if (img.imgInfo.colorspace == ColorSpaceCMYK)
+						if (prepared.colorSpace == ColorSpaceCMYK)
 						{
 							QString profilePath;
 							if (Embedded && ScCore->InputProfilesCMYK.contains(Options.ImageProf))
@@ -10883,7 +11139,7 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 						PutDoc("<<\n");
 						if ((Options.CompressMethod != PDFOptions::Compression_None) && Options.Compress)
 						{
-							QByteArray compData = CompressArray(dataP);
+							QByteArray compData = CompressArray(dataP, Options.zlibCompressionLevel());
 							if (compData.size() > 0)
 							{
 								PutDoc("/Filter /FlateDecode\n");
@@ -10914,7 +11170,7 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 				{
 					if (ICCProfiles[Profil].components == 1)
 					{
-						if ((img.imgInfo.colorspace == ColorSpaceGray) && hasColorEffect)
+						if ((prepared.colorSpace == ColorSpaceGray) && hasColorEffect)
 						{
 							profInUse = item->doc()->cmsSettings().DefaultImageRGBProfile;
 							if (!ICCProfiles.contains(profInUse))
@@ -10929,7 +11185,7 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 								PutDoc("<<\n");
 								if ((Options.CompressMethod != PDFOptions::Compression_None) && Options.Compress)
 								{
-									QByteArray compData = CompressArray(dataP);
+									QByteArray compData = CompressArray(dataP, Options.zlibCompressionLevel());
 									if (compData.size() > 0)
 									{
 										PutDoc("/Filter /FlateDecode\n");
@@ -10959,75 +11215,35 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 					}
 				}
 			}
-			QByteArray im2;
-			ScImage img2;
-			img2.imgInfo.clipPath.clear();
-			img2.imgInfo.PDSpathData.clear();
-			img2.imgInfo.layerInfo.clear();
-			img2.imgInfo.RequestProps = item->pixm.imgInfo.RequestProps;
-			img2.imgInfo.isRequest = item->pixm.imgInfo.isRequest;
-			if (item->pixm.imgInfo.type == ImageType7)
-				alphaM = false;
-			else
+			// The image was prepared assuming it gets a gray profile if its embedded profile is gray,
+			// but an already written profile with the same name takes precedence
+			bool grayProfile = hasGrayProfile && !hasColorEffect;
+			if (prepared.grayProfile != grayProfile)
 			{
-				bool gotAlpha = false;
-				bool pdfVer14 = Options.supportsTransparency();
-				gotAlpha = img2.getAlpha(fn, item->pixm.imgInfo.actualPageNumber, im2, true, pdfVer14, afl, img.width(), img.height());
-				if (!gotAlpha)
-				{
-					PDF_Error_MaskLoadFailure(fn);
+				PDF_PrepareImage(item, fn, sx, sy, Profil, Embedded, Intent, cacheKey, grayProfile ? 1 : 0, prepared);
+				if (!PDF_CheckPreparedImage(prepared, fn))
 					return false;
-				}
-				alphaM = !im2.isEmpty();
-			}
-			bool imgE = false;
-			if ((Options.UseRGB) || (Options.isGrayscale))
-				imgE = false;
-			else
-				imgE = !((Options.UseProfiles2) && (img.imgInfo.colorspace != ColorSpaceCMYK));
-			origWidth = img.width();
-			origHeight = img.height();
-			img.applyEffect(item->effectsInUse, item->doc()->PageColors, imgE);
-			if (!((Options.RecalcPic) && (Options.PicRes < (qMax(72.0 / item->imageXScale(), 72.0 / item->imageYScale())))))
-			{
-				ImInfo.sxa = sx * (1.0 / ImInfo.reso);
-				ImInfo.sya = sy * (1.0 / ImInfo.reso);
 			}
 			PdfId maskObj = 0;
-			if (alphaM)
+			if (!prepared.mask.isEmpty())
 			{
-				bool compAlphaAvail = false;
 				maskObj = writer.newObject();
 				writer.startObj(maskObj);
 				PutDoc("<<\n/Type /XObject\n/Subtype /Image\n");
-				if (Options.CompressMethod != PDFOptions::Compression_None)
-				{
-					QByteArray compAlpha = CompressArray(im2);
-					if (compAlpha.size() > 0)
-					{
-						im2 = compAlpha;
-						compAlphaAvail = true;
-					}
-				}
+				PutDoc("/Width " + Pdf::toPdf(prepared.maskWidth) + "\n");
+				PutDoc("/Height " + Pdf::toPdf(prepared.maskHeight) + "\n");
 				if (Options.supportsTransparency())
 				{
-					PutDoc("/Width " + Pdf::toPdf(origWidth) + "\n");
-					PutDoc("/Height " + Pdf::toPdf(origHeight) + "\n");
 					PutDoc("/ColorSpace /DeviceGray\n");
 					PutDoc("/BitsPerComponent 8\n");
-					PutDoc("/Length " + Pdf::toPdf(im2.size()) + "\n");
 				}
 				else
-				{
-					PutDoc("/Width " + Pdf::toPdf(origWidth) + "\n");
-					PutDoc("/Height " + Pdf::toPdf(origHeight) + "\n");
 					PutDoc("/ImageMask true\n/BitsPerComponent 1\n");
-					PutDoc("/Length " + Pdf::toPdf(im2.size()) + "\n");
-				}
-				if ((Options.CompressMethod != PDFOptions::Compression_None) && compAlphaAvail)
+				PutDoc("/Length " + Pdf::toPdf(prepared.mask.size()) + "\n");
+				if (prepared.maskCompressed)
 					PutDoc("/Filter /FlateDecode\n");
 				PutDoc(">>\nstream\n");
-				EncodeArrayToStream(im2, maskObj);
+				EncodeArrayToStream(prepared.mask, maskObj);
 				PutDoc("\nendstream");
 				writer.endObj(maskObj);
 				pageData.ImgObjects[ResNam + "I" + Pdf::toPdf(ResCount)] = maskObj;
@@ -11036,96 +11252,9 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 			PdfId imageObj = writer.newObject();
 			writer.startObj(imageObj);
 			PutDoc("<<\n/Type /XObject\n/Subtype /Image\n");
-			PutDoc("/Width " + Pdf::toPdf(img.width()) + "\n");
-			PutDoc("/Height " + Pdf::toPdf(img.height()) + "\n");
-			enum PDFOptions::PDFCompression compress_method = Options.CompressMethod;
- 			enum PDFOptions::PDFCompression cm = Options.CompressMethod;
-			bool exportToCMYK = false;
-			bool exportToGrayscale = false;
-			bool jpegUseOriginal = false;
-			if (!Options.UseRGB && !(doc.HasCMS && Options.UseProfiles2 && !realCMYK))
-			{
-				exportToGrayscale = Options.isGrayscale;
-				if (exportToGrayscale)
-					exportToCMYK = !Options.isGrayscale;
-				else
-					exportToCMYK = !Options.UseRGB;
-			}
-			if (item->OverrideCompressionMethod)
-				compress_method = cm = (enum PDFOptions::PDFCompression) item->CompressionMethodIndex;
-			if (img.imgInfo.colorspace == ColorSpaceMonochrome && item->effectsInUse.isEmpty())
-			{
-				compress_method = (compress_method != PDFOptions::Compression_None) ? PDFOptions::Compression_ZIP : compress_method;
-				cm = compress_method;
-			}
-			if (extensionIndicatesJPEG(ext) && (cm != PDFOptions::Compression_None))
-			{
-				if (((Options.UseRGB || Options.UseProfiles2) && (cm == PDFOptions::Compression_Auto) && item->effectsInUse.isEmpty() && (img.imgInfo.colorspace == ColorSpaceRGB)) && (!img.imgInfo.progressive) && (!((Options.RecalcPic) && (Options.PicRes < (qMax(72.0 / item->imageXScale(), 72.0 / item->imageYScale()))))))
-				{
-					// #12961 : we must not rely on PDF viewers taking exif infos into account
-					// So if JPEG orientation is non default, do not use the original file
-					jpegUseOriginal = (img.imgInfo.exifInfo.orientation == 1);
-					cm = PDFOptions::Compression_JPEG;
-				}
-				// We can't unfortunately use directly cmyk jpeg files. Otherwise we have to use the /Decode argument in image
-				// dictionary, which we do not quite want as this argument is simply ignored by some rips and software
-				// amongst which photoshop and illustrator
-				/*else if (((!Options.UseRGB) && (!Options.isGrayscale) && (!Options.UseProfiles2)) && (cm == PDFOptions::Compression_Auto) && item->effectsInUse.isEmpty() && (img.imgInfo.colorspace == ColorSpaceCMYK) && (!((Options.RecalcPic) && (Options.PicRes < (qMax(72.0 / item->imageXScale(), 72.0 / item->imageYScale()))))) && (!img.imgInfo.progressive))
-				{
-					jpegUseOriginal = false;
-					exportToCMYK = true;
-					cm = PDFOptions::Compression_JPEG;
-				}*/
-				else if (compress_method == PDFOptions::Compression_JPEG)
-				{
-					if (realCMYK || !((Options.UseRGB) || (Options.UseProfiles2)))
-					{
-						exportToGrayscale = Options.isGrayscale;
-						if (exportToGrayscale)
-							exportToCMYK = !Options.isGrayscale;
-						else
-							exportToCMYK = !Options.UseRGB;
-					}
-					cm = PDFOptions::Compression_JPEG;
-				}
-				else
-					cm = PDFOptions::Compression_ZIP;
-			}
-			else if ((compress_method == PDFOptions::Compression_JPEG) || (compress_method == PDFOptions::Compression_Auto))
-			{
-				if (realCMYK || !((Options.UseRGB) || (Options.UseProfiles2)))
-				{
-					exportToGrayscale = Options.isGrayscale;
-					if (exportToGrayscale)
-						exportToCMYK = !Options.isGrayscale;
-					else
-						exportToCMYK = !Options.UseRGB;
-				}
-				cm = PDFOptions::Compression_JPEG;
-				/*if (compress_method == PDFOptions::Compression_Auto)
-				{
-					QFileInfo fi(tmpFile);
-					if (fi.size() < im.size())
-					{
-						im.resize(0);
-						if (!loadRawBytes(tmpFile, im))
-							return false;
-						cm = PDFOptions::Compression_JPEG;
-					}
-					else
-						cm = PDFOptions::Compression_ZIP;
-				}*/
-			}
-			if (hasGrayProfile && doc.HasCMS && Options.UseProfiles2 && (!hasColorEffect))
-				exportToGrayscale = true;
-			int bytesWritten = 0;
-			// Fixme: outType variable should be set directly in the if/else maze above.
-			ColorSpaceEnum outType;
-			if (img.imgInfo.colorspace == ColorSpaceMonochrome && item->effectsInUse.isEmpty())
-				outType = ColorSpaceMonochrome;
-			else
-				outType = getOutputType(exportToGrayscale, exportToCMYK);
-			if ((outType != ColorSpaceMonochrome) && (doc.HasCMS) && (Options.UseProfiles2) && (!avoidPDFXOutputIntentProf))
+			PutDoc("/Width " + Pdf::toPdf(prepared.width) + "\n");
+			PutDoc("/Height " + Pdf::toPdf(prepared.height) + "\n");
+			if ((prepared.outType != ColorSpaceMonochrome) && (doc.HasCMS) && (Options.UseProfiles2) && (!avoidPDFXOutputIntentProf))
 			{
 				PutDoc("/ColorSpace " + ICCProfiles[profInUse].ICCArray + "\n");
 				PutDoc("/Intent /");
@@ -11137,7 +11266,7 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 			}
 			else
 			{
-				switch (outType)
+				switch (prepared.outType)
 				{
 					case ColorSpaceMonochrome :
 					case ColorSpaceGray : PutDoc("/ColorSpace /DeviceGray\n"); break;
@@ -11145,19 +11274,16 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 					default : PutDoc("/ColorSpace /DeviceRGB\n"); break;
 				}
 			}
-			if (outType == ColorSpaceMonochrome)
+			if (prepared.outType == ColorSpaceMonochrome)
 				PutDoc("/BitsPerComponent 1\n");
 			else
 				PutDoc("/BitsPerComponent 8\n");
-			PdfId lengthObj = writer.newObject();
-			PutDoc("/Length " + Pdf::toPdf(lengthObj) + " 0 R\n");
-			if (cm == PDFOptions::Compression_JPEG)
+			PutDoc("/Length " + Pdf::toPdf(prepared.data.size()) + "\n");
+			if (prepared.compression == PDFOptions::Compression_JPEG)
 				PutDoc("/Filter /DCTDecode\n");
-			else if (cm != PDFOptions::Compression_None)
+			else if (prepared.compression != PDFOptions::Compression_None)
 				PutDoc("/Filter /FlateDecode\n");
-//			if (exportToCMYK && (cm == PDFOptions::Compression_JPEG))
-//				PutDoc("/Decode [1 0 1 0 1 0 1 0]\n");
-			if (alphaM)
+			if (maskObj != 0)
 			{
 				if (Options.supportsTransparency())
 					PutDoc("/SMask " + Pdf::toPdf(maskObj) + " 0 R\n");
@@ -11165,31 +11291,17 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 					PutDoc("/Mask " + Pdf::toPdf(maskObj) + " 0 R\n");
 			}
 			PutDoc(">>\nstream\n");
-			if (cm == PDFOptions::Compression_JPEG) // Fixme: should not do this with monochrome images?
-			{
-				int quality = item->OverrideCompressionQuality ? item->CompressionQualityIndex : Options.Quality;
-				if (item->OverrideCompressionQuality)
-					jpegUseOriginal = false;
-				bytesWritten = WriteJPEGImageToStream(img, fn, imageObj, quality, outType, jpegUseOriginal, (!hasColorEffect && hasGrayProfile));
-			}
-			else if (cm == PDFOptions::Compression_ZIP)
-				bytesWritten = WriteFlateImageToStream(img, imageObj, outType, (!hasColorEffect && hasGrayProfile));
-			else
-				bytesWritten = WriteImageToStream(img, imageObj, outType, (!hasColorEffect && hasGrayProfile));
+			EncodeArrayToStream(prepared.data, imageObj);
 			PutDoc("\nendstream");
 			writer.endObj(imageObj);
-			if (bytesWritten <= 0)
-			{
-				PDF_Error_ImageWriteFailure(fn);
-				return false;
-			}
-			writer.startObj(lengthObj);
-			PutDoc("    " + Pdf::toPdf(bytesWritten));
-			writer.endObj(lengthObj);
 			pageData.ImgObjects[ResNam + "I" + Pdf::toPdf(ResCount)] = imageObj;
+			ImInfo.isBitmapFromGS = prepared.isBitmapFromGS;
+			ImInfo.reso = prepared.reso;
+			ImInfo.sxa = prepared.sxa;
+			ImInfo.sya = prepared.sya;
 			ImInfo.ResNum = ResCount;
-			ImInfo.Width = img.width();
-			ImInfo.Height = img.height();
+			ImInfo.Width = prepared.width;
+			ImInfo.Height = prepared.height;
 			ImInfo.xa = sx;
 			ImInfo.ya = sy;
 			ImInfo.RequestProps = item->pixm.imgInfo.RequestProps;
@@ -11200,6 +11312,8 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 	}
 	else
 	{
+		if (m_imagePreparer)
+			m_imagePreparer->discard(PDF_ImageCacheKey(item, fn, sx, sy, Profil, Embedded, Intent));
 		ImInfo = *sharedImageIt;
 		ImInfo.sxa *= sx / ImInfo.xa;
 		ImInfo.sya *= sy / ImInfo.ya;
@@ -11654,7 +11768,7 @@ bool PDFLibCore::PDF_End_OutputProfile(const QString& profilePath)
 	PutDoc("<<\n");
 	if (Options.Compress)
 	{
-		QByteArray compData = CompressArray(dataP);
+		QByteArray compData = CompressArray(dataP, Options.zlibCompressionLevel());
 		if (compData.size() > 0)
 		{
 			PutDoc("/Filter /FlateDecode\n");
@@ -14,6 +14,7 @@ for which a new license (GPL+exception) is in place.
 #include <QList>
 #include <QMultiMap>
 #include <QStack>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -29,8 +30,11 @@ class ScPage;
 class PDFOptions;
 class PrefsContext;
 class MultiProgressDialog;
+class PdfImagePreparer;
 class ScLayer;
 class ScText;
+class ScStreamFilter;
+struct PdfPreparedImage;
 
 #include "pdfoptions.h"
 #include "pdfstructs.h"
@@ -70,6 +74,7 @@ public:
 	~PDFLibCore();
 
 	bool doExport(const QString& fn, const std::vector<int> & pageNs, const QMap<int, QImage> & thumbs);
+	bool doExportRecords(const QString& fn, const std::vector<int> & pageNs, int recordCount, const std::function<bool(int)>& prepareRecord, const QMap<QString, QMap<uint, QString> >& recordFonts);
 
 	const QString& errorMessage() const;
 	bool  exportAborted() const;
@@ -197,8 +202,7 @@ private:
 
 	bool       EncodeArrayToStream(const QByteArray& in, PdfId ObjNum);
 
-	int     WriteImageToStream(const ScImage& image, PdfId ObjNum, ColorSpaceEnum format, bool precal);
-	int     WriteJPEGImageToStream(ScImage& image, const QString& fn, PdfId ObjNum, int quality, ColorSpaceEnum format, bool sameFile, bool precal);
+	bool    WriteImageToFilter(const ScImage& image, ScStreamFilter* filter, ColorSpaceEnum format, bool precal) const;
 	int     WriteFlateImageToStream(const ScImage& image, PdfId ObjNum, ColorSpaceEnum format, bool precal);
 
 //	void    CalcOwnerKey(const QString & Owner, const QString & User);
@@ -265,6 +269,11 @@ private:
 	void    PDF_Form(const QByteArray& im);
 	void    PDF_xForm(PdfId objNr, double w, double h, const QByteArray& im);
 	bool    PDF_Image(PageItem* c, const QString& fn, double sx, double sy, double x, double y, bool fromAN = false, const QString& Profil = "", bool Embedded = false, eRenderIntent Intent = Intent_Relative_Colorimetric, QByteArray* output = nullptr);
+	QByteArray PDF_ImageCacheKey(const PageItem* item, const QString& fn, double sx, double sy, const QString& Profil, bool Embedded, eRenderIntent Intent) const;
+	bool    PDF_ImageHasGrayProfile(const QString& fn, bool Embedded) const;
+	void    PDF_PrepareImage(PageItem* item, const QString& fn, double sx, double sy, const QString& Profil, bool Embedded, eRenderIntent Intent, const QByteArray& cacheKey, int grayProfile, PdfPreparedImage& prepared) const;
+	bool    PDF_CheckPreparedImage(const PdfPreparedImage& prepared, const QString& fn);
+	void    PDF_PrepareImages(const std::vector<int>& pageNs);
 	bool    PDF_EmbeddedPDF(PageItem* c, const QString& fn, double sx, double sy, double x, double y, ShIm& imgInfo, bool &fatalError);
 #if HAVE_PODOFO
 	void copyPoDoFoObject(const PoDoFo::PdfObject* obj, PdfId scObjID, QMap<PoDoFo::PdfReference, uint>& importedObjects);
@@ -324,7 +333,11 @@ private:
 	int inPattern { 0 };
 	QMap<QString, QString> StdFonts;
 	MultiProgressDialog* progressDialog { nullptr };
+	PdfImagePreparer* m_imagePreparer { nullptr };
 	bool abortExport { false };
+	int m_recordCount { 1 };
+	std::function<bool(int)> m_prepareRecord;
+	QMap<QString, QMap<uint, QString> > m_recordFonts;
 	bool usingGUI;
 	double bleedDisplacementX { 0.0 };
 	double bleedDisplacementY { 0.0 };
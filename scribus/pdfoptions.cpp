@@ -38,3 +38,16 @@ bool PDFOptions::supportsTransparency() const
 {
 	return Version.supportsTransparency();
 }
+
+int PDFOptions::zlibCompressionLevel() const
+{
+	switch (CompressionLevel)
+	{
+		case CompressionLevel_Fastest:
+			return 1;
+		case CompressionLevel_Smallest:
+			return 9;
+		default:
+			return 6;
+	}
+}
@@ -64,6 +64,13 @@ public:
 		Compression_None = 3
 	};
 
+	enum PDFCompressionLevel
+	{
+		CompressionLevel_Fastest  = 0,
+		CompressionLevel_Balanced = 1,
+		CompressionLevel_Smallest = 2
+	};
+
 	enum PDFFontEmbedding
 	{
 		EmbedFonts = 0,
@@ -98,6 +105,8 @@ public:
 	bool supportsEmbeddedOpenTypeFonts() const;
 	bool supportsOCGs() const;
 	bool supportsTransparency() const;
+	//! \brief Returns the zlib compression level matching CompressionLevel
+	int  zlibCompressionLevel() const;
 
 	bool firstUse { true };
 	bool Thumbnails { false };
@@ -105,6 +114,7 @@ public:
 	bool useLayers { false };
 	bool Compress { true };
 	PDFCompression CompressMethod { Compression_Auto };
+	PDFCompressionLevel CompressionLevel { CompressionLevel_Balanced };
 	int  Quality { 0 };
 	bool RecalcPic { false };
 	bool Bookmarks { false };
@@ -104,6 +104,7 @@ void PDFOptionsIO::buildSettings()
 	addElem(m_root, "compress", m_opts->Compress);
 	addElem(m_root, "compressMethod", m_opts->CompressMethod);
 	addElem(m_root, "quality", m_opts->Quality);
+	addElem(m_root, "compressionLevel", m_opts->CompressionLevel);
 	addElem(m_root, "recalcPic", m_opts->RecalcPic);
 	addElem(m_root, "bookmarks", m_opts->Bookmarks);
 	addElem(m_root, "picRes", m_opts->PicRes);
@@ -366,6 +367,9 @@ bool PDFOptionsIO::readSettings()
 		return false;
 	if (!readElem(m_root, "quality", &m_opts->Quality))
 		return false;
+	// Not present in files written by older versions
+	if (!m_root.firstChildElement("compressionLevel").isNull() && !readElem(m_root, "compressionLevel", (int*) &m_opts->CompressionLevel))
+		return false;
 	if (!readElem(m_root, "recalcPic", &m_opts->RecalcPic))
 		return false;
 	if (!readElem(m_root, "bookmarks", &m_opts->Bookmarks))
@@ -31,6 +31,7 @@ for which a new license (GPL+exception) is in place.
 #include <QMessageBox>
 #include <QScopedPointer>
 #include <QTextStream>
+#include <QXmlStreamWriter>
 
 #include "svgexplugin.h"
 
@@ -126,7 +127,17 @@ bool SVGExportPlugin::run(ScribusDoc* doc, const QString& filename)
 	if (doc == nullptr)
 		return true;
 
-	Q_ASSERT(filename.isEmpty());
+	// Non interactive export of the current page with the default options
+	if (!filename.isEmpty())
+	{
+		SVGOptions Options;
+		Options.inlineImages = true;
+		Options.exportPageBackground = false;
+		Options.compressFile = filename.endsWith(".svgz", Qt::CaseInsensitive);
+		auto pPlug = std::make_unique<SVGExPlug>(doc);
+		return pPlug->doExport(filename, Options);
+	}
+
 	QString fileName;
 
 	PrefsContext* prefs = PrefsManager::instance().prefsFile->getPluginContext("svgex");
@@ -197,6 +208,7 @@ SVGExPlug::SVGExPlug(ScribusDoc* doc)
 bool SVGExPlug::doExport(const QString& fName, const SVGOptions& Opts)
 {
 	Options = Opts;
+	m_Doc->loadDeferredImages();
 	QFileInfo fiBase(fName);
 
 	m_baseDir = fiBase.absolutePath();
@@ -206,49 +218,60 @@ bool SVGExPlug::doExport(const QString& fName, const SVGOptions& Opts)
 	m_maskCount = 0;
 	m_filterCount = 0;
 
+	m_glyphNames.clear();
+	m_fontGlyphPrefixes.clear();
+	m_imageIds.clear();
+
+	// Items are converted one by one into small DOM fragments which are
+	// written out immediately, so memory use does not grow with the page.
+	QFile file(fName);
+	QtIOCompressor compressor(&file);
+	QIODevice* device = &file;
+	if (Options.compressFile)
+	{
+		compressor.setStreamFormat(QtIOCompressor::GzipFormat);
+		if (!compressor.open(QIODevice::WriteOnly))
+			return false;
+		device = &compressor;
+	}
+	else if (!file.open(QIODevice::WriteOnly))
+		return false;
+
+	QXmlStreamWriter writer(device);
+	writer.setAutoFormatting(true);
+	writer.setAutoFormattingIndent(1);
+	m_writer = &writer;
 	m_domDoc = QDomDocument("svgdoc");
-	QString vo = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
-	QString st = "<svg></svg>";
-	m_domDoc.setContent(st);
 
 	ScPage *page = m_Doc->currentPage();
 	double pageWidth  = page->width();
 	double pageHeight = page->height();
-	m_domElem = m_domDoc.documentElement();
-	m_domElem.setAttribute("width", FToStr(pageWidth) + "pt");
-	m_domElem.setAttribute("height", FToStr(pageHeight) + "pt");
-	m_domElem.setAttribute("viewBox", QString("0 0 %1 %2").arg(pageWidth).arg(pageHeight));
-	m_domElem.setAttribute("xmlns", "http://www.w3.org/2000/svg");
-	m_domElem.setAttribute("xmlns:inkscape","http://www.inkscape.org/namespaces/inkscape");
-	m_domElem.setAttribute("xmlns:xlink","http://www.w3.org/1999/xlink");
-	m_domElem.setAttribute("version","1.1");
+	writer.writeStartDocument();
+	writer.writeStartElement("svg");
+	writer.writeAttribute("width", FToStr(pageWidth) + "pt");
+	writer.writeAttribute("height", FToStr(pageHeight) + "pt");
+	writer.writeAttribute("viewBox", QString("0 0 %1 %2").arg(pageWidth).arg(pageHeight));
+	writer.writeAttribute("xmlns", "http://www.w3.org/2000/svg");
+	writer.writeAttribute("xmlns:inkscape","http://www.inkscape.org/namespaces/inkscape");
+	writer.writeAttribute("xmlns:xlink","http://www.w3.org/1999/xlink");
+	writer.writeAttribute("version","1.1");
 	if (!m_Doc->documentInfo().title().isEmpty())
-	{
-		QDomText title = m_domDoc.createTextNode(m_Doc->documentInfo().title());
-		QDomElement titleElem = m_domDoc.createElement("title");
-		titleElem.appendChild(title);
-		m_domElem.appendChild(titleElem);
-	}
+		writer.writeTextElement("title", m_Doc->documentInfo().title());
 	if (!m_Doc->documentInfo().comments().isEmpty())
-	{
-		QDomText desc = m_domDoc.createTextNode(m_Doc->documentInfo().comments());
-		QDomElement descElem = m_domDoc.createElement("desc");
-		descElem.appendChild(desc);
-		m_domElem.appendChild(descElem);
-	}
+		writer.writeTextElement("desc", m_Doc->documentInfo().comments());
 	m_globalDefs = m_domDoc.createElement("defs");
 	writeBasePatterns();
 	writeBaseSymbols();
-	m_domElem.appendChild(m_globalDefs);
+	flushDefs();
 	if (Options.exportPageBackground)
 	{
-		QDomElement backG = m_domDoc.createElement("rect");
-		backG.setAttribute("x", "0");
-		backG.setAttribute("y", "0");
-		backG.setAttribute("width", FToStr(pageWidth));
-		backG.setAttribute("height", FToStr(pageHeight));
-		backG.setAttribute("style", "fill:" + m_Doc->paperColor().name() + ";" + "stroke:none;");
-		m_domElem.appendChild(backG);
+		writer.writeStartElement("rect");
+		writer.writeAttribute("x", "0");
+		writer.writeAttribute("y", "0");
+		writer.writeAttribute("width", FToStr(pageWidth));
+		writer.writeAttribute("height", FToStr(pageHeight));
+		writer.writeAttribute("style", "fill:" + m_Doc->paperColor().name() + ";" + "stroke:none;");
+		writer.writeEndElement();
 	}
 	ScLayer ll;
 	ll.isPrintable = false;
@@ -263,37 +286,54 @@ bool SVGExPlug::doExport(const QString& fName, const SVGOptions& Opts)
 			processPageLayer(page, ll);
 		}
 	}
-	if(Options.compressFile)
-	{
-		// zipped saving
-		QString wr = vo;
-		wr += m_domDoc.toString();
-		QByteArray utf8wr = wr.toUtf8();
-		QFile file(fName);
-		QtIOCompressor compressor(&file);
-		compressor.setStreamFormat(QtIOCompressor::GzipFormat);
-		compressor.open(QIODevice::WriteOnly);
-		compressor.write(utf8wr);
+	writer.writeEndElement();
+	writer.writeEndDocument();
+	m_writer = nullptr;
+	m_domDoc.clear();
+	m_globalDefs = QDomElement();
+
+	if (Options.compressFile)
 		compressor.close();
-	}
 	else
+		file.close();
+	return !writer.hasError();
+}
+
+void SVGExPlug::flushDefs()
+{
+	if (!m_globalDefs.hasChildNodes())
+		return;
+	writeElement(m_globalDefs);
+	m_globalDefs = m_domDoc.createElement("defs");
+}
+
+void SVGExPlug::writeElement(const QDomElement& elem)
+{
+	m_writer->writeStartElement(elem.tagName());
+	QDomNamedNodeMap attributes = elem.attributes();
+	for (int i = 0; i < attributes.count(); ++i)
 	{
-		QFile f(fName);
-		if(!f.open(QIODevice::WriteOnly))
-			return false;
-		QDataStream s(&f);
-		QString wr = vo;
-		wr += m_domDoc.toString();
-		QByteArray utf8wr = wr.toUtf8();
-		s.writeRawData(utf8wr.data(), utf8wr.length());
-		f.close();
+		QDomAttr attr = attributes.item(i).toAttr();
+		m_writer->writeAttribute(attr.name(), attr.value());
 	}
-	return true;
+	for (QDomNode node = elem.firstChild(); !node.isNull(); node = node.nextSibling())
+	{
+		if (node.isElement())
+			writeElement(node.toElement());
+		else if (node.isText())
+			m_writer->writeCharacters(node.nodeValue());
+	}
+	m_writer->writeEndElement();
+}
+
+void SVGExPlug::writeChildElements(const QDomElement& elem)
+{
+	for (QDomElement child = elem.firstChildElement(); !child.isNull(); child = child.nextSiblingElement())
+		writeElement(child);
 }
 
 void SVGExPlug::processPageLayer(ScPage *page, const ScLayer& layer)
 {
-	QDomElement layerGroup;
 	PageItem *item;
 	QList<PageItem*> items;
 	ScPage* SavedAct = m_Doc->currentPage();
@@ -307,12 +347,12 @@ void SVGExPlug::processPageLayer(ScPage *page, const ScLayer& layer)
 		return;
 	m_Doc->setCurrentPage(page);
 
-	layerGroup = m_domDoc.createElement("g");
-	layerGroup.setAttribute("id", layer.Name);
-	layerGroup.setAttribute("inkscape:label", layer.Name);
-	layerGroup.setAttribute("inkscape:groupmode", "layer");
+	m_writer->writeStartElement("g");
+	m_writer->writeAttribute("id", layer.Name);
+	m_writer->writeAttribute("inkscape:label", layer.Name);
+	m_writer->writeAttribute("inkscape:groupmode", "layer");
 	if (layer.transparency != 1.0)
-		layerGroup.setAttribute("opacity", FToStr(layer.transparency));
+		m_writer->writeAttribute("opacity", FToStr(layer.transparency));
 	for (int j = 0; j < items.count(); ++j)
 	{
 		item = items.at(j);
@@ -332,9 +372,14 @@ void SVGExPlug::processPageLayer(ScPage *page, const ScLayer& layer)
 			continue;
 		if ((!page->pageNameEmpty()) && (item->OwnPage != page->pageNr()) && (item->OwnPage != -1))
 			continue;
-		processItemOnPage(item->xPos()-page->xOffset(), item->yPos()-page->yOffset(), item, &layerGroup);
+		// The item is built in a scratch element; everything it references
+		// is written before it, then the fragment is released.
+		QDomElement itemElems = m_domDoc.createElement("g");
+		processItemOnPage(item->xPos()-page->xOffset(), item->yPos()-page->yOffset(), item, &itemElems);
+		flushDefs();
+		writeChildElements(itemElems);
 	}
-	m_domElem.appendChild(layerGroup);
+	m_writer->writeEndElement();
 
 	m_Doc->setCurrentPage(SavedAct);
 }
@@ -1062,37 +1107,9 @@ QDomElement SVGExPlug::processImageItem(const PageItem *item, const QString& tra
 		QDomElement ob6 = m_domDoc.createElement("g");
 		if (!ob2.isNull())
 			ob6.setAttribute("clip-path", "url(#" + ob2.attribute("id") + ")");
-		QDomElement ob3 = m_domDoc.createElement("image");
-		ScImage img;
-		CMSettings cms(m_Doc, item->ImageProfile, item->ImageIntent);
-		cms.setUseEmbeddedProfile(item->UseEmbedded);
-		cms.allowSoftProofing(true);
-		img.loadPicture(item->Pfile, item->pixm.imgInfo.actualPageNumber, cms, ScImage::RGBData, 72);
-		img.applyEffect(item->effectsInUse, m_Doc->PageColors, true);
-		if (Options.inlineImages)
-		{
-			QBuffer buffer;
-			buffer.open(QIODevice::WriteOnly);
-			img.qImage().save(&buffer, "PNG");
-			QByteArray ba = buffer.buffer().toBase64();
-			buffer.close();
-			ob3.setAttribute("xlink:href", "data:image/png;base64," + QString(ba));
-		}
-		else
-		{
-			QFileInfo fi(item->Pfile);
-			QString imgFileName = m_baseDir + "/" + fi.baseName() + ".png";
-			QFileInfo im(imgFileName);
-			if (im.exists())
-				imgFileName = m_baseDir + "/" + fi.baseName() + "_copy.png";
-			img.qImage().save(imgFileName, "PNG");
-			QFileInfo fi2(imgFileName);
-			ob3.setAttribute("xlink:href", fi2.baseName() + ".png");
-		}
-		ob3.setAttribute("x", FToStr(item->imageXOffset() * item->imageXScale()));
-		ob3.setAttribute("y", FToStr(item->imageYOffset() * item->imageYScale()));
-		ob3.setAttribute("width", FToStr(img.width() * item->imageXScale()));
-		ob3.setAttribute("height", FToStr(img.height() * item->imageYScale()));
+		// Identical images are written only once and referenced by each frame
+		QDomElement ob3 = m_domDoc.createElement("use");
+		ob3.setAttribute("xlink:href", "#" + handleImage(item));
 		QTransform mpa;
 		if (item->imageFlippedH())
 		{
@@ -1105,6 +1122,8 @@ QDomElement SVGExPlug::processImageItem(const PageItem *item, const QString& tra
 			mpa.scale(1, -1);
 		}
 		mpa.rotate(item->imageRotation());
+		mpa.translate(item->imageXOffset() * item->imageXScale(), item->imageYOffset() * item->imageYScale());
+		mpa.scale(item->imageXScale(), item->imageYScale());
 		ob3.setAttribute("transform", matrixToStr(mpa));
 		ob6.appendChild(ob3);
 		ob.appendChild(ob6);
@@ -1269,6 +1288,53 @@ public:
 	void drawObjectDecoration(PageItem* item) override {}
 };
 
+QString SVGExPlug::handleImage(const PageItem *item)
+{
+	QString key = item->Pfile + "|" + QString::number(item->pixm.imgInfo.actualPageNumber);
+	key += "|" + item->ImageProfile + "|" + QString::number(item->ImageIntent) + "|" + QString::number(item->UseEmbedded);
+	for (const ImageEffect& effect : item->effectsInUse)
+		key += "|" + QString::number(effect.effectCode) + ":" + effect.effectParameters;
+	auto it = m_imageIds.constFind(key);
+	if (it != m_imageIds.constEnd())
+		return it.value();
+
+	ScImage img;
+	CMSettings cms(m_Doc, item->ImageProfile, item->ImageIntent);
+	cms.setUseEmbeddedProfile(item->UseEmbedded);
+	cms.allowSoftProofing(true);
+	img.loadPicture(item->Pfile, item->pixm.imgInfo.actualPageNumber, cms, ScImage::RGBData, 72);
+	img.applyEffect(item->effectsInUse, m_Doc->PageColors, true);
+
+	QString imageId = "Image" + IToStr(m_imageIds.count());
+	QDomElement ob = m_domDoc.createElement("image");
+	ob.setAttribute("id", imageId);
+	ob.setAttribute("width", IToStr(img.width()));
+	ob.setAttribute("height", IToStr(img.height()));
+	if (Options.inlineImages)
+	{
+		QBuffer buffer;
+		buffer.open(QIODevice::WriteOnly);
+		img.qImage().save(&buffer, "PNG");
+		QByteArray ba = buffer.buffer().toBase64();
+		buffer.close();
+		ob.setAttribute("xlink:href", "data:image/png;base64," + QString(ba));
+	}
+	else
+	{
+		QFileInfo fi(item->Pfile);
+		QString imgFileName = m_baseDir + "/" + fi.baseName() + ".png";
+		QFileInfo im(imgFileName);
+		if (im.exists())
+			imgFileName = m_baseDir + "/" + fi.baseName() + "_copy.png";
+		img.qImage().save(imgFileName, "PNG");
+		QFileInfo fi2(imgFileName);
+		ob.setAttribute("xlink:href", fi2.baseName() + ".png");
+	}
+	m_globalDefs.appendChild(ob);
+	m_imageIds.insert(key, imageId);
+	return imageId;
+}
+
 QDomElement SVGExPlug::processTextItem(const PageItem *item, const QString& trans, const QString& fill, const QString& stroke)
 {
 	QDomElement ob;
@@ -1491,7 +1557,11 @@ QDomElement SVGExPlug::processInlineItem(PageItem* embItem, const QString& trans
 
 QString SVGExPlug::handleGlyph(uint gid, const ScFace& font)
 {
-	QString glName = QString("Gl%1%2").arg(font.psName().simplified().replace(QRegularExpression("[\\s\\/\\{\\[\\]\\}\\<\\>\\(\\)\\%]"), "_" )).arg(gid);
+	const QString psName = font.psName();
+	auto prefixIt = m_fontGlyphPrefixes.constFind(psName);
+	if (prefixIt == m_fontGlyphPrefixes.constEnd())
+		prefixIt = m_fontGlyphPrefixes.insert(psName, "Gl" + psName.simplified().replace(QRegularExpression("[\\s\\/\\{\\[\\]\\}\\<\\>\\(\\)\\%]"), "_" ));
+	QString glName = prefixIt.value() + QString::number(gid);
 	if (m_glyphNames.contains(glName))
 		return glName;
 	FPointArray pts = font.glyphOutline(gid);
@@ -1499,7 +1569,7 @@ QString SVGExPlug::handleGlyph(uint gid, const ScFace& font)
 	ob.setAttribute("d", setClipPath(pts, true));
 	ob.setAttribute("id", glName);
 	m_globalDefs.appendChild(ob);
-	m_glyphNames.append(glName);
+	m_glyphNames.insert(glName);
 	return glName;
 }
 
@@ -9,11 +9,14 @@ for which a new license (GPL+exception) is in place.
 
 #include <QObject>
 #include <QDomElement>
+#include <QHash>
+#include <QSet>
 #include "pluginapi.h"
 #include "loadsaveplugin.h"
 #include "tableborder.h"
 
 class QString;
+class QXmlStreamWriter;
 class ScLayer;
 class ScribusDoc;
 class ScribusMainWindow;
@@ -82,9 +85,11 @@ private:
 	int m_filterCount { 0 };
 	QString m_baseDir;
 	QDomDocument m_domDoc;
-	QDomElement m_domElem;
 	QDomElement m_globalDefs;
-	QList<QString> m_glyphNames;
+	QXmlStreamWriter* m_writer { nullptr };
+	QSet<QString> m_glyphNames;
+	QHash<QString, QString> m_fontGlyphPrefixes;
+	QHash<QString, QString> m_imageIds;
 
 	/*!
 	\author Franz Schmid
@@ -92,6 +97,13 @@ private:
 	\param Seite Page *
 	*/
 	void processPageLayer(ScPage *page, const ScLayer& layer);
+	/*!
+	\brief Write the definitions collected so far to the output and start a new defs element
+	*/
+	void flushDefs();
+	void writeElement(const QDomElement& elem);
+	void writeChildElements(const QDomElement& elem);
+	QString handleImage(const PageItem *Item);
 	void processItemOnPage(double xOffset, double yOffset, PageItem *Item, QDomElement *parentElem);
 	void paintBorder(const TableBorder& border, const QPointF& start, const QPointF& end, const QPointF& startOffsetFactors, const QPointF& endOffsetFactors, QDomElement &ob);
 	QString processDropShadow(const PageItem *Item);
@@ -215,6 +215,7 @@ XPSExPlug::XPSExPlug(ScribusDoc* doc, int output_res)
 
 bool XPSExPlug::doExport(const QString& fName)
 {
+	m_Doc->loadDeferredImages();
 	ScZipHandler zip(true);
 	if (!zip.open(fName))
 		return false;
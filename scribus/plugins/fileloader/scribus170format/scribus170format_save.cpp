@@ -37,6 +37,7 @@ for which a new license (GPL+exception) is in place.
 #include "qtiocompressor.h"
 #include "resourcecollection.h"
 #include "scconfig.h"
+#include "scimagememorystore.h"
 #include "scpaths.h"
 #include "scpattern.h"
 #include "scribusdoc.h"
@@ -2897,6 +2898,7 @@ void Scribus170Format::SetItemProps(ScXmlStreamWriter& docu, PageItem* item, con
 			docu.writeAttribute("isInlineImage", static_cast<int>(item->isInlineImage));
 			QFileInfo inlFi(item->Pfile);
 			docu.writeAttribute("inlineImageExt", inlFi.suffix());
+			ScImageMemoryStore::instance().materialize(item->Pfile);
 			QFile inFil(item->Pfile);
 			if (inFil.open(QIODevice::ReadOnly))
 			{
@@ -6,10 +6,12 @@ for which a new license (GPL+exception) is in place.
 */
 #include "scribus171format.h"
 #include "scribus171formatimpl.h"
+#include "scribus171index.h"
 
 #include <algorithm>
 
 #include <QApplication>
+#include <QBuffer>
 #include <QByteArray>
 #include <QCursor>
 // #include <QDebug>
@@ -221,6 +223,17 @@ QIODevice* Scribus171Format::slaReader(const QString & fileName)
 	return ioDevice;
 }
 
+QIODevice* Scribus171Format::slaSummaryReader(const QString & fileName)
+{
+	Scribus171Index index;
+	if (!index.load(fileName))
+		return slaReader(fileName);
+	QBuffer* buffer = new QBuffer();
+	buffer->setData(index.summary);
+	buffer->open(QIODevice::ReadOnly);
+	return buffer;
+}
+
 QIODevice* Scribus171Format::paletteReader(const QString & fileName)
 {
 	if (!paletteSupported(nullptr, fileName))
@@ -1692,6 +1705,10 @@ bool Scribus171Format::loadFile(const QString & fileName, const FileFormat & /*
 	readObjectParams.baseDir = fileDir;
 	readObjectParams.itemKind = PageItem::StandardItem;
 	readObjectParams.loadingPage = false;
+	// Only image decoding is deferred. Pages, items and stories are all read here: text chains,
+	// layout and the item lists need every item, and compressed files have no usable byte offsets
+	// to read the items of a page later.
+	readObjectParams.deferImageLoading = ScCore->usingGUI() && PrefsManager::instance().appPrefs.docSetupPrefs.deferImageLoading;
 
 	bool firstElement = true;
 	bool success = true;
@@ -4179,6 +4196,7 @@ bool Scribus171Format::readPDFOptions(ScribusDoc* doc, ScXmlStreamReader& reader
 	doc->pdfOptions().Compress = attrs.valueAsBool("Compress");
 	doc->pdfOptions().CompressMethod = (PDFOptions::PDFCompression) attrs.valueAsInt("CMethod", 0);
 	doc->pdfOptions().Quality = attrs.valueAsInt("Quality", 0);
+	doc->pdfOptions().CompressionLevel = (PDFOptions::PDFCompressionLevel) attrs.valueAsInt("CompressionLevel", PDFOptions::CompressionLevel_Balanced);
 	doc->pdfOptions().RecalcPic = attrs.valueAsBool("RecalcPic");
 	doc->pdfOptions().embedPDF = attrs.valueAsBool("EmbedPDF", false);
 	doc->pdfOptions().Bookmarks = attrs.valueAsBool("Bookmarks");
@@ -5334,6 +5352,7 @@ bool Scribus171Format::readObject(ScribusDoc* doc, ScXmlStreamReader& reader, co
 				readObjectParams2.baseDir = readObjectParams.baseDir;
 				readObjectParams2.itemKind = (itemKind == PageItem::PatternItem) ? PageItem::PatternItem : PageItem::StandardItem;
 				readObjectParams2.loadingPage = true;
+				readObjectParams2.deferImageLoading = readObjectParams.deferImageLoading;
 				readObject(doc, reader, readObjectParams2, itemInfo);
 				for (int as = 0; as < groupItems.count(); ++as)
 				{
@@ -5464,34 +5483,16 @@ bool Scribus171Format::readObject(ScribusDoc* doc, ScXmlStreamReader& reader, co
 	{
 		if (!newItem->Pfile.isEmpty())
 		{
-			double imageXOffset = newItem->imageXOffset();
-			double imageYOffset = newItem->imageYOffset();
-			QString imageProfile = newItem->ImageProfile;
-			QString embeddedProfile = newItem->EmbeddedProfile;
-			bool useEmbeddedProfile = newItem->UseEmbedded;
-			doc->loadPict(newItem->Pfile, newItem, false);
-			newItem->setImageXYOffset(imageXOffset, imageYOffset);
-			newItem->ImageProfile = imageProfile;
-			newItem->EmbeddedProfile = embeddedProfile;
-			newItem->UseEmbedded = useEmbeddedProfile;
-			if (newItem->pixm.imgInfo.PDSpathData.contains(clipPath))
-			{
-				newItem->imageClip = newItem->pixm.imgInfo.PDSpathData[clipPath].copy();
-				newItem->pixm.imgInfo.usedPath = clipPath;
-				QTransform cl;
-				cl.translate(newItem->imageXOffset() * newItem->imageXScale(), newItem->imageYOffset() * newItem->imageYScale());
-				cl.scale(newItem->imageXScale(), newItem->imageYScale());
-				newItem->imageClip.map(cl);
-			}
-			if (layerFound)
+			// Images of the pages are loaded when the pages are drawn
+			if (readObjectParams.deferImageLoading && (newItem->itemType() == PageItem::ImageFrame) && (itemKind == PageItem::StandardItem))
 			{
-				newItem->pixm.imgInfo.isRequest = true;
-				doc->loadPict(newItem->Pfile, newItem, true);
-				newItem->setImageXYOffset(imageXOffset, imageYOffset);
-				newItem->ImageProfile = imageProfile;
-				newItem->EmbeddedProfile = embeddedProfile;
-				newItem->UseEmbedded = useEmbeddedProfile;
+				newItem->imageLoadDeferred = true;
+				newItem->deferredImageClip = clipPath;
+				newItem->deferredImageLayers = layerFound;
+				newItem->pixm.imgInfo.usedPath = clipPath;
 			}
+			else
+				doc->loadItemImage(newItem, clipPath, layerFound);
 		}
 	}
 	if (!readObjectParams.loadingPage)
@@ -8146,6 +8147,13 @@ bool Scribus171Format::loadPage(const QString & fileName, int pageNumber, bool M
 	}
 
 	QString fileDir = QFileInfo(fileName).absolutePath();
+
+	// With an index, reading stops after the last object of the page
+	Scribus171Index index;
+	bool indexed = index.load(fileName);
+	int lastObject = indexed ? index.lastObject(pageNumber, Mpage) : -1;
+	int pageObjectCount = 0;
+	int masterObjectCount = 0;
 	
 	ReadObjectParams readObjectParams;
 	readObjectParams.baseDir = fileDir;
@@ -8450,6 +8458,14 @@ bool Scribus171Format::loadPage(const QString & fileName, int pageNumber, bool M
 		if ((tagName == QLatin1String("PAGEOBJECT")) || (tagName == QLatin1String("MASTEROBJECT")) || (tagName == QLatin1String("FRAMEOBJECT")) ||
 				(tagName == QLatin1String("PageObject")) || (tagName == QLatin1String("MasterObject")) || (tagName == QLatin1String("FrameObject")))
 		{
+			if (indexed)
+			{
+				// Master objects are saved before page objects
+				if (tagName == QLatin1String("PageObject") && (Mpage || (pageObjectCount++ > lastObject)))
+					break;
+				if (tagName == QLatin1String("MasterObject") && Mpage && (masterObjectCount++ > lastObject))
+					break;
+			}
 			if ((Mpage && (tagName != QLatin1String("MASTEROBJECT") && tagName != QLatin1String("MasterObject"))) || (!Mpage && (tagName == QLatin1String("MASTEROBJECT") || tagName == QLatin1String("MasterObject"))))
 			{
 				// Go to end of node
@@ -8950,13 +8966,33 @@ void Scribus171Format::getStyle(CharStyle& style, ScXmlStreamReader& reader, Sty
 	}
 }
 
+namespace
+{
+	// Colours and styles are saved before the pages, and pages before the objects,
+	// readers looking for them can stop at the first element which comes after.
+	// Objects may also be nested in patterns, before the pages.
+	bool isPageElement(const QString& tagName)
+	{
+		//Remove uppercase in 1.8 format
+		return (tagName == QLatin1String("Page")) || (tagName == QLatin1String("MasterPage")) ||
+				(tagName == QLatin1String("PAGE")) || (tagName == QLatin1String("MASTERPAGE"));
+	}
+
+	bool isObjectElement(const QString& tagName)
+	{
+		//Remove uppercase in 1.8 format
+		return (tagName == QLatin1String("PageObject")) || (tagName == QLatin1String("MasterObject")) || (tagName == QLatin1String("FrameObject")) ||
+				(tagName == QLatin1String("PAGEOBJECT")) || (tagName == QLatin1String("MASTEROBJECT")) || (tagName == QLatin1String("FRAMEOBJECT"));
+	}
+}
+
 bool Scribus171Format::readStyles(const QString& fileName, ScribusDoc* doc, StyleSet<ParagraphStyle> &docParagraphStyles)
 {
 	ParagraphStyle pstyle;
 	bool firstElement = true;
 	bool success = true;
 
-	QScopedPointer<QIODevice> ioDevice(slaReader(fileName));
+	QScopedPointer<QIODevice> ioDevice(slaSummaryReader(fileName));
 	if (ioDevice.isNull())
 		return false;
 
@@ -8981,6 +9017,8 @@ bool Scribus171Format::readStyles(const QString& fileName, ScribusDoc* doc, Styl
 			firstElement = false;
 			continue;
 		}
+		if (isPageElement(tagName))
+			break;
 		//Remove uppercase in 1.8 format
 		if ((tagName == QLatin1String("ParagraphStyle")) || (tagName == QLatin1String("STYLE")))
 		{
@@ -8997,7 +9035,7 @@ bool Scribus171Format::readCharStyles(const QString& fileName, ScribusDoc* doc,
 	bool firstElement = true;
 	//bool success = true;
 
-	QScopedPointer<QIODevice> ioDevice(slaReader(fileName));
+	QScopedPointer<QIODevice> ioDevice(slaSummaryReader(fileName));
 	if (ioDevice.isNull())
 		return false;
 
@@ -9022,6 +9060,8 @@ bool Scribus171Format::readCharStyles(const QString& fileName, ScribusDoc* doc,
 			firstElement = false;
 			continue;
 		}
+		if (isPageElement(tagName))
+			break;
 		//Remove uppercase in 1.8 format
 		if (tagName == QLatin1String("CharacterStyle") || tagName == QLatin1String("CHARSTYLE"))
 		{
@@ -9039,7 +9079,7 @@ bool Scribus171Format::readLineStyles(const QString& fileName, QHash<QString, Mu
 	bool firstElement = true;
 	bool success = true;
 
-	QScopedPointer<QIODevice> ioDevice(slaReader(fileName));
+	QScopedPointer<QIODevice> ioDevice(slaSummaryReader(fileName));
 	if (ioDevice.isNull())
 		return false;
 
@@ -9061,6 +9101,8 @@ bool Scribus171Format::readLineStyles(const QString& fileName, QHash<QString, Mu
 			firstElement = false;
 			continue;
 		}
+		if (isPageElement(tagName))
+			break;
 		if (tagName == QLatin1String("MultiLine"))
 		{
 			MultiLine ml;
@@ -9089,7 +9131,7 @@ bool Scribus171Format::readColors(const QString& fileName, ColorList & colors)
 	bool firstElement = true;
 	bool success = true;
 
-	QScopedPointer<QIODevice> ioDevice(slaReader(fileName));
+	QScopedPointer<QIODevice> ioDevice(slaSummaryReader(fileName));
 	if (ioDevice.isNull())
 		return false;
 
@@ -9111,6 +9153,8 @@ bool Scribus171Format::readColors(const QString& fileName, ColorList & colors)
 			firstElement = false;
 			continue;
 		}
+		if (isPageElement(tagName))
+			break;
 		//Remove uppercase in 1.8
 		if (tagName == QLatin1String("COLOR") && attrs.valueAsString("NAME") != CommonStrings::None)
 		{
@@ -9135,6 +9179,7 @@ bool Scribus171Format::readPageCount(const QString& fileName, int *num1, int *nu
 	int counter = 0;
 	int counter2 = 0;
 	bool firstElement = true;
+	bool pagesFound = false;
 	bool success = true;
 
 	markeredItemsMap.clear();
@@ -9144,7 +9189,7 @@ bool Scribus171Format::readPageCount(const QString& fileName, int *num1, int *nu
 	notesMasterMarks.clear();
 	notesNSets.clear();
 
-	QScopedPointer<QIODevice> ioDevice(slaReader(fileName));
+	QScopedPointer<QIODevice> ioDevice(slaSummaryReader(fileName));
 	if (ioDevice.isNull())
 		return false;
 
@@ -9166,6 +9211,10 @@ bool Scribus171Format::readPageCount(const QString& fileName, int *num1, int *nu
 			firstElement = false;
 			continue;
 		}
+		if (pagesFound && isObjectElement(tagName))
+			break;
+		if (isPageElement(tagName))
+			pagesFound = true;
 		//Remove uppercase in 1.8 format
 		if (tagName == QLatin1String("PAGE"))
 			counter++;
@@ -15,8 +15,10 @@ for which a new license (GPL+exception) is in place.
 #include "styles/styleset.h"
 #include "selection.h"
 
+#include <QHash>
 #include <QList>
 #include <QMap>
+#include <QPair>
 #include <QProgressBar>
 #include <QString>
 
@@ -109,6 +111,7 @@ class PLUGIN_API Scribus171Format : public LoadSavePlugin
 
 			PageItem::ItemKind itemKind { PageItem::StandardItem };
 			bool    loadingPage { false };
+			bool    deferImageLoading { false };
 			QString baseDir;
 			QString renamedMasterPage;
 		};
@@ -116,6 +119,8 @@ class PLUGIN_API Scribus171Format : public LoadSavePlugin
 		void registerFormats();
 		
 		QIODevice* slaReader(const QString & fileName);
+		/// Reads the document summary from the index if there is one, the document itself otherwise
+		QIODevice* slaSummaryReader(const QString & fileName);
 		QIODevice* paletteReader(const QString & fileName);
 
 		void getStyle(ParagraphStyle& style, ScXmlStreamReader& reader, StyleSet<ParagraphStyle> *docParagraphStyles, ScribusDoc* doc, bool equiv);
@@ -232,6 +237,8 @@ class PLUGIN_API Scribus171Format : public LoadSavePlugin
 
 		void WritePages(ScribusDoc *doc, ScXmlStreamWriter& docu, QProgressBar *dia2, uint maxC, bool master) const;
 		void WriteObjects(ScribusDoc *doc, ScXmlStreamWriter& docu, const QString& baseDir, QProgressBar *dia2, uint maxC, ItemSelection master, QList<PageItem*> *items = 0) const;
+		void WriteObject(ScribusDoc *doc, ScXmlStreamWriter& docu, const QString& baseDir, PageItem* item, ItemSelection master, QList<PageItem*> *items) const;
+		void WriteObjectFragment(ScribusDoc *doc, ScXmlStreamWriter& docu, const QString& baseDir, PageItem* item, ItemSelection master, QList<PageItem*> *items) const;
 		void SetItemProps(ScXmlStreamWriter& docu, PageItem* item, const QString& baseDir) const;
 		
 		QMap<QString, QString> charStyleMap;
@@ -247,6 +254,34 @@ class PLUGIN_API Scribus171Format : public LoadSavePlugin
 		QList<PageItem*> FrameItems;
 		QMap<PageItem*, QString> itemsWeld;  //item* and master name
 
+		/// XML written for an item by a previous save, reused while the item is unchanged
+		struct SaveFragment
+		{
+			quint64 itemRevision { 0 };
+			quint64 storyRevision { 0 };
+			size_t signature { 0 };
+			QByteArray xml;
+			bool used { false };
+		};
+
+		/// Item fragments of one document for incremental saving
+		struct SaveFragmentStore
+		{
+			QString baseDir;
+			int savesSinceFullWrite { 0 };
+			qint64 size { 0 };
+			QHash<QPair<int, const PageItem*>, SaveFragment> fragments;
+		};
+
+		/// Writes the index of the document just saved to fileName
+		void writeIndex(const QString& fileName) const;
+
+		void beginIncrementalSave(const QString& baseDir);
+		void endIncrementalSave(bool success);
+
+		QHash<const ScribusDoc*, SaveFragmentStore> m_saveFragmentStores;
+		SaveFragmentStore* m_saveFragments { nullptr };
+
 		QFile aFile;
 		QString clipPath;
 		bool isNewFormat {false};
@@ -6,6 +6,7 @@ for which a new license (GPL+exception) is in place.
 */
 #include "scribus171format.h"
 #include "scribus171formatimpl.h"
+#include "scribus171index.h"
 
 #include <ctime>
 #include <memory>
@@ -34,9 +35,10 @@ for which a new license (GPL+exception) is in place.
 #include "pageitem_table.h"
 #include "pagesize.h"
 #include "prefsmanager.h"
-#include "qtiocompressor.h"
 #include "resourcecollection.h"
 #include "scconfig.h"
+#include "scimagememorystore.h"
+#include "scparalleldeflate.h"
 #include "scpaths.h"
 #include "scpattern.h"
 #include "scribusdoc.h"
@@ -49,6 +51,49 @@ for which a new license (GPL+exception) is in place.
 #include "util_color.h"
 #include "util_text.h"
 
+namespace
+{
+	// Every so many incremental saves, the whole document is serialized again
+	const int incrementalSavesBetweenFullWrites = 20;
+	// Memory kept for the fragments of one document
+	const qint64 maxSaveFragmentBytes = 1024LL * 1024 * 1024;
+
+	/**
+	 * Collects the revisions of an item and of the items written inside it,
+	 * and hashes the properties the document changes without recording an
+	 * undo action. Returns false if the item cannot be reused from a
+	 * previous save.
+	 */
+	bool collectFragmentState(const PageItem* item, quint64& itemRevision, quint64& storyRevision, size_t& signature)
+	{
+		// Formulas are text nodes, tables and notes are updated by their own machinery
+		if (item->isLatexFrame() || item->isTable() || item->isNoteFrame() || item->isOSGFrame())
+			return false;
+		itemRevision = qMax(itemRevision, item->changeRevision());
+		if (item->isTextFrame() || item->isPathText())
+			storyRevision = qMax(storyRevision, item->itemText.revision());
+		signature = qHashMulti(signature, quintptr(item), static_cast<int>(item->itemType()), item->itemName(), item->OnMasterPage);
+		signature = qHashMulti(signature, item->xPos(), item->yPos(), item->width(), item->height(), item->rotation());
+		signature = qHashMulti(signature, item->gXpos, item->gYpos, item->gWidth, item->gHeight);
+		signature = qHashMulti(signature, item->OwnPage, item->m_layerID, quintptr(item->Parent), item->isEmbedded, item->inlineCharID, item->Pfile);
+		const PageItem* prevTopParent = item->prevInChain();
+		while (prevTopParent && prevTopParent->Parent)
+			prevTopParent = prevTopParent->Parent;
+		signature = qHashMulti(signature, quintptr(item->nextInChain()), quintptr(item->prevInChain()));
+		if (prevTopParent)
+			signature = qHashMulti(signature, prevTopParent->OnMasterPage, prevTopParent->isEmbedded);
+		if (!item->isGroup())
+			return true;
+		signature = qHashMulti(signature, item->groupItemList.count());
+		for (const PageItem* child : item->groupItemList)
+		{
+			if (!collectFragmentState(child, itemRevision, storyRevision, signature))
+				return false;
+		}
+		return true;
+	}
+}
+
 QString Scribus171Format::saveElements(double xp, double yp, double wp, double hp, Selection* selection, QByteArray &prevData)
 {
 	ResourceCollection lists;
@@ -307,9 +352,8 @@ bool Scribus171Format::saveFile(const QString & fileName, const FileFormat & /*
 	if (fileName.toLower().right(2) == "gz")
 	{
 		aFile.setFileName(tmpFileName);
-		QtIOCompressor *compressor = new QtIOCompressor(&aFile);
-		compressor->setStreamFormat(QtIOCompressor::GzipFormat);
-		outputFile.reset(compressor);
+		// Compressed on all cores, the XML of big documents is several hundred megabytes
+		outputFile.reset(new ScParallelDeflateDevice(&aFile, ScParallelDeflate::GzipFormat));
 	}
 	else
 		outputFile.reset( new QFile(tmpFileName) );
@@ -546,6 +590,10 @@ bool Scribus171Format::saveFile(const QString & fileName, const FileFormat & /*
 	writePageSets(docu);
 	writeSections(docu);
 	writePatterns(docu, fileDir);
+	if (PrefsManager::instance().appPrefs.docSetupPrefs.saveIncremental)
+		beginIncrementalSave(fileDir);
+	else
+		m_saveFragmentStores.remove(m_Doc);
 	writeContent(docu, fileDir);
 
 	docu.writeEndElement();
@@ -570,13 +618,84 @@ bool Scribus171Format::saveFile(const QString & fileName, const FileFormat & /*
 		QFile::remove(tmpFileName);
 	if (writeSucceed)
 		QFile::remove(tmpFileName);
+	endIncrementalSave(writeSucceed);
 #ifdef Q_OS_UNIX
 	if (writeSucceed)
 		QFile::setPermissions(fileName, m_Doc->filePermissions());
 #endif
+	if (writeSucceed)
+		writeIndex(fileName);
 	return writeSucceed;
 }
 
+void Scribus171Format::writeIndex(const QString& fileName) const
+{
+	Scribus171Index index;
+	ScXmlStreamWriter docu(&index.summary);
+	docu.writeStartDocument();
+	docu.writeStartElement("SCRIBUSUTF8NEW");
+	docu.writeAttribute("Version", ScribusAPI::getVersion());
+	writeColors(docu);
+	writeCharStyles(docu);
+	writeParagraphStyles(docu);
+	writeLineStyles(docu);
+	WritePages(m_Doc, docu, nullptr, 0, true);
+	WritePages(m_Doc, docu, nullptr, 0, false);
+	docu.writeEndElement();
+	docu.writeEndDocument();
+
+	// Same order as WriteObjects() writes them
+	for (int i = 0; i < m_Doc->MasterItems.count(); ++i)
+		index.lastMasterObjects[m_Doc->MasterItems.at(i)->OwnPage] = i;
+	for (int i = 0; i < m_Doc->DocItems.count(); ++i)
+		index.lastPageObjects[m_Doc->DocItems.at(i)->OwnPage] = i;
+	index.store(fileName);
+}
+
+void Scribus171Format::beginIncrementalSave(const QString& baseDir)
+{
+	if (!m_saveFragmentStores.contains(m_Doc))
+	{
+		const ScribusDoc* doc = m_Doc;
+		connect(m_Doc, &QObject::destroyed, this, [this, doc]() { m_saveFragmentStores.remove(doc); });
+	}
+	SaveFragmentStore& store = m_saveFragmentStores[m_Doc];
+	// Image paths are written relative to the document
+	if ((store.baseDir != baseDir) || (++store.savesSinceFullWrite >= incrementalSavesBetweenFullWrites))
+	{
+		store.fragments.clear();
+		store.size = 0;
+		store.savesSinceFullWrite = 0;
+		store.baseDir = baseDir;
+	}
+	for (auto it = store.fragments.begin(); it != store.fragments.end(); ++it)
+		it->used = false;
+	m_saveFragments = &store;
+}
+
+void Scribus171Format::endIncrementalSave(bool success)
+{
+	if (m_saveFragments == nullptr)
+		return;
+	if (success)
+	{
+		// Fragments of deleted items
+		for (auto it = m_saveFragments->fragments.begin(); it != m_saveFragments->fragments.end(); )
+		{
+			if (it->used)
+			{
+				++it;
+				continue;
+			}
+			m_saveFragments->size -= it->xml.size();
+			it = m_saveFragments->fragments.erase(it);
+		}
+	}
+	else
+		m_saveFragmentStores.remove(m_Doc);
+	m_saveFragments = nullptr;
+}
+
 void Scribus171Format::writeCheckerProfiles(ScXmlStreamWriter & docu) const
 {
 	auto itcpend = m_Doc->checkerProfiles().end();
@@ -1319,6 +1438,7 @@ void Scribus171Format::writePdfOptions(ScXmlStreamWriter & docu) const
 	docu.writeAttribute("Compress", static_cast<int>(m_Doc->pdfOptions().Compress));
 	docu.writeAttribute("CMethod", m_Doc->pdfOptions().CompressMethod);
 	docu.writeAttribute("Quality", m_Doc->pdfOptions().Quality);
+	docu.writeAttribute("CompressionLevel", m_Doc->pdfOptions().CompressionLevel);
 	docu.writeAttribute("EmbedPDF", static_cast<int>(m_Doc->pdfOptions().embedPDF));
 	docu.writeAttribute("MirrorH", static_cast<int>(m_Doc->pdfOptions().MirrorH));
 	docu.writeAttribute("MirrorV", static_cast<int>(m_Doc->pdfOptions().MirrorV));
@@ -2029,671 +2149,725 @@ void Scribus171Format::WriteObjects(ScribusDoc *doc, ScXmlStreamWriter& docu, co
 		if (dia2 != nullptr)
 			dia2->setValue(ObCount);
 		item = items->at(j);
-		switch (master)
+		if (m_saveFragments && ((master == ItemSelectionMaster) || (master == ItemSelectionPage) || (master == ItemSelectionFrame)))
+			WriteObjectFragment(doc, docu, baseDir, item, master, items);
+		else
+			WriteObject(doc, docu, baseDir, item, master, items);
+	}
+}
+
+void Scribus171Format::WriteObjectFragment(ScribusDoc *doc, ScXmlStreamWriter& docu, const QString& baseDir, PageItem* item, ItemSelection master, QList<PageItem*> *items) const
+{
+	quint64 itemRevision = 0;
+	quint64 storyRevision = 0;
+	size_t signature = 0;
+	if (!collectFragmentState(item, itemRevision, storyRevision, signature))
+	{
+		WriteObject(doc, docu, baseDir, item, master, items);
+		return;
+	}
+
+	QPair<int, const PageItem*> key(master, item);
+	auto it = m_saveFragments->fragments.find(key);
+	if (it != m_saveFragments->fragments.end())
+	{
+		if ((it->itemRevision == itemRevision) && (it->storyRevision == storyRevision) && (it->signature == signature))
 		{
-			case ItemSelectionMaster:
-				docu.writeStartElement("MasterObject");
-				break;
-			case ItemSelectionGroup:
-			case ItemSelectionPage:
-				docu.writeStartElement("PageObject");
-				break;
-			case ItemSelectionFrame:
-				docu.writeStartElement("FrameObject");
-				break;
-			case ItemSelectionPattern:
-				docu.writeStartElement("PatternItem");
-				break;
-			case ItemSelectionElements:
-				docu.writeStartElement("Item");
-				break;
+			it->used = true;
+			docu.writeXmlFragment(QString::fromUtf8(it->xml));
+			return;
 		}
-		if (master == ItemSelectionFrame)
-			docu.writeAttribute("InID", item->inlineCharID);
-		if (master == ItemSelectionElements)
+		m_saveFragments->size -= it->xml.size();
+		m_saveFragments->fragments.erase(it);
+	}
+
+	// Fragments are kept without formatting, the document writer indents
+	// them when they are copied
+	QString xml;
+	ScXmlStreamWriter writer(&xml);
+	WriteObject(doc, writer, baseDir, item, master, items);
+	docu.writeXmlFragment(xml);
+
+	SaveFragment fragment;
+	fragment.itemRevision = itemRevision;
+	fragment.storyRevision = storyRevision;
+	fragment.signature = signature;
+	fragment.xml = xml.toUtf8();
+	fragment.used = true;
+	if (m_saveFragments->size + fragment.xml.size() > maxSaveFragmentBytes)
+		return;
+	m_saveFragments->size += fragment.xml.size();
+	m_saveFragments->fragments.insert(key, fragment);
+}
+
+void Scribus171Format::WriteObject(ScribusDoc *doc, ScXmlStreamWriter& docu, const QString& baseDir, PageItem* item, ItemSelection master, QList<PageItem*> *items) const
+{
+	switch (master)
+	{
+		case ItemSelectionMaster:
+			docu.writeStartElement("MasterObject");
+			break;
+		case ItemSelectionGroup:
+		case ItemSelectionPage:
+			docu.writeStartElement("PageObject");
+			break;
+		case ItemSelectionFrame:
+			docu.writeStartElement("FrameObject");
+			break;
+		case ItemSelectionPattern:
+			docu.writeStartElement("PatternItem");
+			break;
+		case ItemSelectionElements:
+			docu.writeStartElement("Item");
+			break;
+	}
+	if (master == ItemSelectionFrame)
+		docu.writeAttribute("InID", item->inlineCharID);
+	if (master == ItemSelectionElements)
+	{
+		docu.writeAttribute("XPosition", item->xPos() - doc->currentPage()->xOffset());
+		docu.writeAttribute("YPosition", item->yPos() - doc->currentPage()->yOffset());
+	}
+	else
+	{
+		docu.writeAttribute("XPosition", item->xPos());
+		docu.writeAttribute("YPosition", item->yPos());
+	}
+	SetItemProps(docu, item, baseDir);
+	if (!item->OnMasterPage.isEmpty())
+		docu.writeAttribute("OnMasterPage", item->OnMasterPage);
+	if (!item->pixm.imgInfo.usedPath.isEmpty())
+		docu.writeAttribute("ImageClip", item->pixm.imgInfo.usedPath);
+	if (item->pixm.imgInfo.lowResType != 1)
+		docu.writeAttribute("ImageLowResType", item->pixm.imgInfo.lowResType);
+	if (item->isEmbedded)
+		docu.writeAttribute("isInline", 1);
+	if (!item->fillRule)
+		docu.writeAttribute("FillRule", 0);
+	if (item->doOverprint)
+		docu.writeAttribute("DoOverprint", 1);
+	docu.writeAttribute("gXpos", item->gXpos);
+	docu.writeAttribute("gYpos", item->gYpos);
+	docu.writeAttribute("gWidth", item->gWidth);
+	docu.writeAttribute("gHeight", item->gHeight);
+	if (item->itemType() == PageItem::Symbol)
+		docu.writeAttribute("pattern", item->pattern());
+	if (item->GrType != 0)
+	{
+		if (item->GrType == Gradient_Pattern)
 		{
-			docu.writeAttribute("XPosition", item->xPos() - doc->currentPage()->xOffset());
-			docu.writeAttribute("YPosition", item->yPos() - doc->currentPage()->yOffset());
+			docu.writeAttribute("Pattern", item->pattern());
+			const ScPatternTransform& patternTrans = item->patternTransform();
+			bool mirrorX, mirrorY;
+			item->patternFlip(mirrorX, mirrorY);
+			docu.writeAttribute("PatternXScale", patternTrans.scaleX * 100.0);
+			docu.writeAttribute("PatternYScale", patternTrans.scaleY * 100.0);
+			docu.writeAttribute("PatternXOffset", patternTrans.offsetX);
+			docu.writeAttribute("PatternYOffset", patternTrans.offsetY);
+			docu.writeAttribute("PatternRotation", patternTrans.rotation);
+			docu.writeAttribute("PatternXSkew", patternTrans.skewX);
+			docu.writeAttribute("PatternYSkew", patternTrans.skewY);
+			docu.writeAttribute("PatternXMirror", mirrorX);
+			docu.writeAttribute("PatternYMirror", mirrorY);
 		}
 		else
 		{
-			docu.writeAttribute("XPosition", item->xPos());
-			docu.writeAttribute("YPosition", item->yPos());
-		}
-		SetItemProps(docu, item, baseDir);
-		if (!item->OnMasterPage.isEmpty())
-			docu.writeAttribute("OnMasterPage", item->OnMasterPage);
-		if (!item->pixm.imgInfo.usedPath.isEmpty())
-			docu.writeAttribute("ImageClip", item->pixm.imgInfo.usedPath);
-		if (item->pixm.imgInfo.lowResType != 1)
-			docu.writeAttribute("ImageLowResType", item->pixm.imgInfo.lowResType);
-		if (item->isEmbedded)
-			docu.writeAttribute("isInline", 1);
-		if (!item->fillRule)
-			docu.writeAttribute("FillRule", 0);
-		if (item->doOverprint)
-			docu.writeAttribute("DoOverprint", 1);
-		docu.writeAttribute("gXpos", item->gXpos);
-		docu.writeAttribute("gYpos", item->gYpos);
-		docu.writeAttribute("gWidth", item->gWidth);
-		docu.writeAttribute("gHeight", item->gHeight);
-		if (item->itemType() == PageItem::Symbol)
-			docu.writeAttribute("pattern", item->pattern());
-		if (item->GrType != 0)
-		{
-			if (item->GrType == Gradient_Pattern)
+			if (item->GrType == Gradient_Mesh)
 			{
-				docu.writeAttribute("Pattern", item->pattern());
-				const ScPatternTransform& patternTrans = item->patternTransform();
-				bool mirrorX, mirrorY;
-				item->patternFlip(mirrorX, mirrorY);
-				docu.writeAttribute("PatternXScale", patternTrans.scaleX * 100.0);
-				docu.writeAttribute("PatternYScale", patternTrans.scaleY * 100.0);
-				docu.writeAttribute("PatternXOffset", patternTrans.offsetX);
-				docu.writeAttribute("PatternYOffset", patternTrans.offsetY);
-				docu.writeAttribute("PatternRotation", patternTrans.rotation);
-				docu.writeAttribute("PatternXSkew", patternTrans.skewX);
-				docu.writeAttribute("PatternYSkew", patternTrans.skewY);
-				docu.writeAttribute("PatternXMirror", mirrorX);
-				docu.writeAttribute("PatternYMirror", mirrorY);
+				docu.writeAttribute("GradientMeshArrayColumns", item->meshGradientArray[0].count());
+				docu.writeAttribute("GradientMeshArrayRows", item->meshGradientArray.count());
+			}
+			else if (item->GrType == Gradient_PatchMesh)
+			{
+				docu.writeAttribute("GradientMeshArrayRows", item->meshGradientPatches.count());
+			}
+			else if (item->GrType == Gradient_Hatch)
+			{
+				docu.writeAttribute("HatchMode", item->hatchType);
+				docu.writeAttribute("HatchDistance", item->hatchDistance);
+				docu.writeAttribute("HatchAngle", item->hatchAngle);
+				docu.writeAttribute("HatchUseBackground", item->hatchUseBackground);
+				docu.writeAttribute("HatchBackgroundColor", item->hatchBackground);
+				docu.writeAttribute("HatchForegroundColor", item->hatchForeground);
 			}
 			else
 			{
-				if (item->GrType == Gradient_Mesh)
-				{
-					docu.writeAttribute("GradientMeshArrayColumns", item->meshGradientArray[0].count());
-					docu.writeAttribute("GradientMeshArrayRows", item->meshGradientArray.count());
-				}
-				else if (item->GrType == Gradient_PatchMesh)
-				{
-					docu.writeAttribute("GradientMeshArrayRows", item->meshGradientPatches.count());
-				}
-				else if (item->GrType == Gradient_Hatch)
+				docu.writeAttribute("GradientStartX", item->GrStartX);
+				docu.writeAttribute("GradientStartY", item->GrStartY);
+				docu.writeAttribute("GradientEndX", item->GrEndX);
+				docu.writeAttribute("GradientEndY", item->GrEndY);
+				docu.writeAttribute("GradientFocalX", item->GrFocalX);
+				docu.writeAttribute("GradientFocalY", item->GrFocalY);
+				docu.writeAttribute("GradientScale", item->GrScale);
+				docu.writeAttribute("GradientSkew", item->GrSkew);
+				docu.writeAttribute("GradientExtend", item->getGradientExtend());
+				if ((item->GrType == Gradient_4Colors) || (item->GrType == Gradient_Diamond))
 				{
-					docu.writeAttribute("HatchMode", item->hatchType);
-					docu.writeAttribute("HatchDistance", item->hatchDistance);
-					docu.writeAttribute("HatchAngle", item->hatchAngle);
-					docu.writeAttribute("HatchUseBackground", item->hatchUseBackground);
-					docu.writeAttribute("HatchBackgroundColor", item->hatchBackground);
-					docu.writeAttribute("HatchForegroundColor", item->hatchForeground);
-				}
-				else
-				{
-					docu.writeAttribute("GradientStartX", item->GrStartX);
-					docu.writeAttribute("GradientStartY", item->GrStartY);
-					docu.writeAttribute("GradientEndX", item->GrEndX);
-					docu.writeAttribute("GradientEndY", item->GrEndY);
-					docu.writeAttribute("GradientFocalX", item->GrFocalX);
-					docu.writeAttribute("GradientFocalY", item->GrFocalY);
-					docu.writeAttribute("GradientScale", item->GrScale);
-					docu.writeAttribute("GradientSkew", item->GrSkew);
-					docu.writeAttribute("GradientExtend", item->getGradientExtend());
-					if ((item->GrType == Gradient_4Colors) || (item->GrType == Gradient_Diamond))
-					{
-						docu.writeAttribute("GradientControl1X", item->GrControl1.x());
-						docu.writeAttribute("GradientControl1Y", item->GrControl1.y());
-						docu.writeAttribute("GradientColorP1", item->GrColorP1);
-						docu.writeAttribute("GradientControl2X", item->GrControl2.x());
-						docu.writeAttribute("GradientControl2Y", item->GrControl2.y());
-						docu.writeAttribute("GradientColorP2", item->GrColorP2);
-						docu.writeAttribute("GradientControl3X", item->GrControl3.x());
-						docu.writeAttribute("GradientControl3Y", item->GrControl3.y());
-						docu.writeAttribute("GradientColorP3", item->GrColorP3);
-						docu.writeAttribute("GradientControl4X", item->GrControl4.x());
-						docu.writeAttribute("GradientControl4Y", item->GrControl4.y());
-						docu.writeAttribute("GradientControl5X", item->GrControl5.x());
-						docu.writeAttribute("GradientControl5Y", item->GrControl5.y());
-						docu.writeAttribute("GradientColorP4", item->GrColorP4);
-						docu.writeAttribute("GradientColorP1Transparency", item->GrCol1transp);
-						docu.writeAttribute("GradientColorP2Transparency", item->GrCol2transp);
-						docu.writeAttribute("GradientColorP3Transparency", item->GrCol3transp);
-						docu.writeAttribute("GradientColorP4Transparency", item->GrCol4transp);
-						docu.writeAttribute("GradientColorP1Shade", item->GrCol1Shade);
-						docu.writeAttribute("GradientColorP2Shade", item->GrCol2Shade);
-						docu.writeAttribute("GradientColorP3Shade", item->GrCol3Shade);
-						docu.writeAttribute("GradientColorP4Shade", item->GrCol4Shade);
-					}
+					docu.writeAttribute("GradientControl1X", item->GrControl1.x());
+					docu.writeAttribute("GradientControl1Y", item->GrControl1.y());
+					docu.writeAttribute("GradientColorP1", item->GrColorP1);
+					docu.writeAttribute("GradientControl2X", item->GrControl2.x());
+					docu.writeAttribute("GradientControl2Y", item->GrControl2.y());
+					docu.writeAttribute("GradientColorP2", item->GrColorP2);
+					docu.writeAttribute("GradientControl3X", item->GrControl3.x());
+					docu.writeAttribute("GradientControl3Y", item->GrControl3.y());
+					docu.writeAttribute("GradientColorP3", item->GrColorP3);
+					docu.writeAttribute("GradientControl4X", item->GrControl4.x());
+					docu.writeAttribute("GradientControl4Y", item->GrControl4.y());
+					docu.writeAttribute("GradientControl5X", item->GrControl5.x());
+					docu.writeAttribute("GradientControl5Y", item->GrControl5.y());
+					docu.writeAttribute("GradientColorP4", item->GrColorP4);
+					docu.writeAttribute("GradientColorP1Transparency", item->GrCol1transp);
+					docu.writeAttribute("GradientColorP2Transparency", item->GrCol2transp);
+					docu.writeAttribute("GradientColorP3Transparency", item->GrCol3transp);
+					docu.writeAttribute("GradientColorP4Transparency", item->GrCol4transp);
+					docu.writeAttribute("GradientColorP1Shade", item->GrCol1Shade);
+					docu.writeAttribute("GradientColorP2Shade", item->GrCol2Shade);
+					docu.writeAttribute("GradientColorP3Shade", item->GrCol3Shade);
+					docu.writeAttribute("GradientColorP4Shade", item->GrCol4Shade);
 				}
 			}
 		}
-		if (!item->gradient().isEmpty())
-			docu.writeAttribute("GradientName", item->gradient());
-		if (!item->strokeGradient().isEmpty())
-			docu.writeAttribute("GradientStrokeName", item->strokeGradient());
-		if (!item->gradientMask().isEmpty())
-			docu.writeAttribute("GradientMaskName", item->gradientMask());
-		if (item->GrTypeStroke > 0)
-		{
-			docu.writeAttribute("GradientStrokeExtend", item->getStrokeGradientExtend());
-			docu.writeAttribute("GradientStrokeStartX", item->GrStrokeStartX);
-			docu.writeAttribute("GradientStrokeStartY", item->GrStrokeStartY);
-			docu.writeAttribute("GradientStrokeEndX", item->GrStrokeEndX);
-			docu.writeAttribute("GradientStrokeEndY", item->GrStrokeEndY);
-			docu.writeAttribute("GradientStrokeFocalX", item->GrStrokeFocalX);
-			docu.writeAttribute("GradientStrokeFocalY", item->GrStrokeFocalY);
-			docu.writeAttribute("GradientStrokeScale", item->GrStrokeScale);
-			docu.writeAttribute("GradientStrokeSkew", item->GrStrokeSkew);
-		}
-		if (!item->strokePattern().isEmpty())
-		{
-			docu.writeAttribute("StrokePattern", item->strokePattern());
-			const ScStrokePatternTransform& strokePatTrans = item->strokePatternTransform();
-			bool mirrorX, mirrorY;
-			item->strokePatternFlip(mirrorX, mirrorY);
-			bool atPath = item->isStrokePatternToPath();
-			docu.writeAttribute("StrokePatternXScale", strokePatTrans.scaleX * 100.0);
-			docu.writeAttribute("StrokePatternYScale", strokePatTrans.scaleY * 100.0);
-			docu.writeAttribute("StrokePatternXOffset", strokePatTrans.offsetX);
-			docu.writeAttribute("StrokePatternYOffset", strokePatTrans.offsetY);
-			docu.writeAttribute("StrokePatternRotation", strokePatTrans.rotation);
-			docu.writeAttribute("StrokePatternXSkew", strokePatTrans.skewX);
-			docu.writeAttribute("StrokePatternYSkew", strokePatTrans.skewY);
-			docu.writeAttribute("StrokePatternSpace", strokePatTrans.space);
-			docu.writeAttribute("StrokePatternXMirror", mirrorX);
-			docu.writeAttribute("StrokePatternYMirror", mirrorY);
-			docu.writeAttribute("StrokePatternToPath", atPath);
-		}
-		if (item->GrMask > 0)
-		{
-			docu.writeAttribute("GradientMaskRepeatMethod", item->mask_gradient.repeatMethod());
-			docu.writeAttribute("GradientMaskType", item->GrMask);
-			docu.writeAttribute("GradientMaskStartX", item->GrMaskStartX);
-			docu.writeAttribute("GradientMaskStartY", item->GrMaskStartY);
-			docu.writeAttribute("GradientMaskEndX", item->GrMaskEndX);
-			docu.writeAttribute("GradientMaskEndY", item->GrMaskEndY);
-			docu.writeAttribute("GradientMaskFocalX", item->GrMaskFocalX);
-			docu.writeAttribute("GradientMaskFocalY", item->GrMaskFocalY);
-			docu.writeAttribute("GradientMaskScale", item->GrMaskScale);
-			docu.writeAttribute("GradientMaskSkew", item->GrMaskSkew);
-		}
-		if (!item->patternMask().isEmpty())
-		{
-			docu.writeAttribute("MaskPattern", item->patternMask());
-			const ScMaskTransform& maskTrans = item->maskTransform();
-			bool mirrorX, mirrorY;
-			item->maskFlip(mirrorX, mirrorY);
-			docu.writeAttribute("MaskPatternScaleX", maskTrans.scaleX * 100.0);
-			docu.writeAttribute("MaskPatternScaleY", maskTrans.scaleY * 100.0);
-			docu.writeAttribute("MaskPatternOffsetX", maskTrans.offsetX);
-			docu.writeAttribute("MaskPatternOffsetY", maskTrans.offsetY);
-			docu.writeAttribute("MaskPatternRotation", maskTrans.rotation);
-			docu.writeAttribute("MaskPatternSkewX", maskTrans.skewX);
-			docu.writeAttribute("MaskPatternSkewY", maskTrans.skewY);
-			docu.writeAttribute("MaskPatternMirrorX", mirrorX);
-			docu.writeAttribute("MaskPatternMirrorY", mirrorY);
-		}
-		if (item->itemText.defaultStyle().hasParent())
-			docu.writeAttribute("ParagraphStyle", item->itemText.defaultStyle().parent());
-		if (! item->itemText.defaultStyle().isInhAlignment())
-			docu.writeAttribute("Alignment", item->itemText.defaultStyle().alignment());
-		
-		docu.writeAttribute("Layer", item->m_layerID);
-		if (item->isBookmark)
-			docu.writeAttribute("BookMark", 1);
-
-		if (item->isTextFrame() || item->isPathText() || item->isImageFrame())
-		{
-			if (item->nextInChain() != nullptr)
-				docu.writeAttribute("NextItem", qHash(item->nextInChain()) & 0x7FFFFFFF);
-			else
-				docu.writeAttribute("NextItem", -1);
+	}
+	if (!item->gradient().isEmpty())
+		docu.writeAttribute("GradientName", item->gradient());
+	if (!item->strokeGradient().isEmpty())
+		docu.writeAttribute("GradientStrokeName", item->strokeGradient());
+	if (!item->gradientMask().isEmpty())
+		docu.writeAttribute("GradientMaskName", item->gradientMask());
+	if (item->GrTypeStroke > 0)
+	{
+		docu.writeAttribute("GradientStrokeExtend", item->getStrokeGradientExtend());
+		docu.writeAttribute("GradientStrokeStartX", item->GrStrokeStartX);
+		docu.writeAttribute("GradientStrokeStartY", item->GrStrokeStartY);
+		docu.writeAttribute("GradientStrokeEndX", item->GrStrokeEndX);
+		docu.writeAttribute("GradientStrokeEndY", item->GrStrokeEndY);
+		docu.writeAttribute("GradientStrokeFocalX", item->GrStrokeFocalX);
+		docu.writeAttribute("GradientStrokeFocalY", item->GrStrokeFocalY);
+		docu.writeAttribute("GradientStrokeScale", item->GrStrokeScale);
+		docu.writeAttribute("GradientStrokeSkew", item->GrStrokeSkew);
+	}
+	if (!item->strokePattern().isEmpty())
+	{
+		docu.writeAttribute("StrokePattern", item->strokePattern());
+		const ScStrokePatternTransform& strokePatTrans = item->strokePatternTransform();
+		bool mirrorX, mirrorY;
+		item->strokePatternFlip(mirrorX, mirrorY);
+		bool atPath = item->isStrokePatternToPath();
+		docu.writeAttribute("StrokePatternXScale", strokePatTrans.scaleX * 100.0);
+		docu.writeAttribute("StrokePatternYScale", strokePatTrans.scaleY * 100.0);
+		docu.writeAttribute("StrokePatternXOffset", strokePatTrans.offsetX);
+		docu.writeAttribute("StrokePatternYOffset", strokePatTrans.offsetY);
+		docu.writeAttribute("StrokePatternRotation", strokePatTrans.rotation);
+		docu.writeAttribute("StrokePatternXSkew", strokePatTrans.skewX);
+		docu.writeAttribute("StrokePatternYSkew", strokePatTrans.skewY);
+		docu.writeAttribute("StrokePatternSpace", strokePatTrans.space);
+		docu.writeAttribute("StrokePatternXMirror", mirrorX);
+		docu.writeAttribute("StrokePatternYMirror", mirrorY);
+		docu.writeAttribute("StrokePatternToPath", atPath);
+	}
+	if (item->GrMask > 0)
+	{
+		docu.writeAttribute("GradientMaskRepeatMethod", item->mask_gradient.repeatMethod());
+		docu.writeAttribute("GradientMaskType", item->GrMask);
+		docu.writeAttribute("GradientMaskStartX", item->GrMaskStartX);
+		docu.writeAttribute("GradientMaskStartY", item->GrMaskStartY);
+		docu.writeAttribute("GradientMaskEndX", item->GrMaskEndX);
+		docu.writeAttribute("GradientMaskEndY", item->GrMaskEndY);
+		docu.writeAttribute("GradientMaskFocalX", item->GrMaskFocalX);
+		docu.writeAttribute("GradientMaskFocalY", item->GrMaskFocalY);
+		docu.writeAttribute("GradientMaskScale", item->GrMaskScale);
+		docu.writeAttribute("GradientMaskSkew", item->GrMaskSkew);
+	}
+	if (!item->patternMask().isEmpty())
+	{
+		docu.writeAttribute("MaskPattern", item->patternMask());
+		const ScMaskTransform& maskTrans = item->maskTransform();
+		bool mirrorX, mirrorY;
+		item->maskFlip(mirrorX, mirrorY);
+		docu.writeAttribute("MaskPatternScaleX", maskTrans.scaleX * 100.0);
+		docu.writeAttribute("MaskPatternScaleY", maskTrans.scaleY * 100.0);
+		docu.writeAttribute("MaskPatternOffsetX", maskTrans.offsetX);
+		docu.writeAttribute("MaskPatternOffsetY", maskTrans.offsetY);
+		docu.writeAttribute("MaskPatternRotation", maskTrans.rotation);
+		docu.writeAttribute("MaskPatternSkewX", maskTrans.skewX);
+		docu.writeAttribute("MaskPatternSkewY", maskTrans.skewY);
+		docu.writeAttribute("MaskPatternMirrorX", mirrorX);
+		docu.writeAttribute("MaskPatternMirrorY", mirrorY);
+	}
+	if (item->itemText.defaultStyle().hasParent())
+		docu.writeAttribute("ParagraphStyle", item->itemText.defaultStyle().parent());
+	if (! item->itemText.defaultStyle().isInhAlignment())
+		docu.writeAttribute("Alignment", item->itemText.defaultStyle().alignment());
+	
+	docu.writeAttribute("Layer", item->m_layerID);
+	if (item->isBookmark)
+		docu.writeAttribute("BookMark", 1);
 
-			bool prevTopParentCheck = (master == ItemSelectionGroup);
-			if (master != ItemSelectionGroup)
-			{
-				PageItem* prevTopParent = item->prevInChain();
-				while (prevTopParent && prevTopParent->Parent)
-					prevTopParent = prevTopParent->Parent;
-				prevTopParentCheck = items->contains(prevTopParent);
-			}
+	if (item->isTextFrame() || item->isPathText() || item->isImageFrame())
+	{
+		if (item->nextInChain() != nullptr)
+			docu.writeAttribute("NextItem", qHash(item->nextInChain()) & 0x7FFFFFFF);
+		else
+			docu.writeAttribute("NextItem", -1);
 
-			if (item->prevInChain() != nullptr && prevTopParentCheck)
-				docu.writeAttribute("BackItem", qHash(item->prevInChain()) & 0x7FFFFFFF);
-			else
-			{
-				docu.writeAttribute("BackItem", -1);
-				if (item->isNoteFrame())
-					docu.writeAttribute("isNoteFrame", 1);
-				else if (item->isTextFrame() || item->isPathText())
-					writeStoryText(doc, docu, item->itemText, item);
-			}
+		bool prevTopParentCheck = (master == ItemSelectionGroup);
+		if (master != ItemSelectionGroup)
+		{
+			PageItem* prevTopParent = item->prevInChain();
+			while (prevTopParent && prevTopParent->Parent)
+				prevTopParent = prevTopParent->Parent;
+			prevTopParentCheck = items->contains(prevTopParent);
 		}
 
-		if (item->isWelded())
+		if (item->prevInChain() != nullptr && prevTopParentCheck)
+			docu.writeAttribute("BackItem", qHash(item->prevInChain()) & 0x7FFFFFFF);
+		else
 		{
-			for (int i = 0 ; i <  item->weldList.count(); i++)
-			{
-				PageItem::WeldingInfo wInf = item->weldList.at(i);
-				const PageItem *pIt = wInf.weldItem;
-				if (pIt == nullptr)
-				{
-					qDebug() << "Saving welding info - empty pointer!!!";
-					continue;
-				}
-				if (pIt->isAutoNoteFrame())
-					continue;
-				docu.writeEmptyElement("WeldEntry");
-				docu.writeAttribute("Target", qHash(wInf.weldItem) & 0x7FFFFFFF);
-				docu.writeAttribute("WX", wInf.weldPoint.x());
-				docu.writeAttribute("WY", wInf.weldPoint.y());
-			}
+			docu.writeAttribute("BackItem", -1);
+			if (item->isNoteFrame())
+				docu.writeAttribute("isNoteFrame", 1);
+			else if (item->isTextFrame() || item->isPathText())
+				writeStoryText(doc, docu, item->itemText, item);
 		}
-		if (!item->effectsInUse.isEmpty())
+	}
+
+	if (item->isWelded())
+	{
+		for (int i = 0 ; i <  item->weldList.count(); i++)
 		{
-			for (int a = 0; a < item->effectsInUse.count(); ++a)
+			PageItem::WeldingInfo wInf = item->weldList.at(i);
+			const PageItem *pIt = wInf.weldItem;
+			if (pIt == nullptr)
 			{
-				docu.writeEmptyElement("ImageEffect");
-				docu.writeAttribute("Code", item->effectsInUse.at(a).effectCode);
-				docu.writeAttribute("Param", item->effectsInUse.at(a).effectParameters);
+				qDebug() << "Saving welding info - empty pointer!!!";
+				continue;
 			}
+			if (pIt->isAutoNoteFrame())
+				continue;
+			docu.writeEmptyElement("WeldEntry");
+			docu.writeAttribute("Target", qHash(wInf.weldItem) & 0x7FFFFFFF);
+			docu.writeAttribute("WX", wInf.weldPoint.x());
+			docu.writeAttribute("WY", wInf.weldPoint.y());
 		}
-		if (((item->isImageFrame()) || (item->isTextFrame())) && (!item->Pfile.isEmpty()) && !item->pixm.imgInfo.layerInfo.isEmpty() && item->pixm.imgInfo.isRequest)
+	}
+	if (!item->effectsInUse.isEmpty())
+	{
+		for (int a = 0; a < item->effectsInUse.count(); ++a)
 		{
-			for (auto it2 = item->pixm.imgInfo.RequestProps.begin(); it2 != item->pixm.imgInfo.RequestProps.end(); ++it2)
-			{
-				docu.writeEmptyElement("PSDLayer");
-				docu.writeAttribute("Layer",it2.key());
-				docu.writeAttribute("Visible", static_cast<int>(it2.value().visible));
-				docu.writeAttribute("useMask", static_cast<int>(it2.value().useMask));
-				docu.writeAttribute("Opacity", it2.value().opacity);
-				docu.writeAttribute("Blend", it2.value().blend);
-			}
+			docu.writeEmptyElement("ImageEffect");
+			docu.writeAttribute("Code", item->effectsInUse.at(a).effectCode);
+			docu.writeAttribute("Param", item->effectsInUse.at(a).effectParameters);
+		}
+	}
+	// Images not loaded yet have no layer info, but keep the layer settings read from the file
+	bool imageLayers = (!item->pixm.imgInfo.layerInfo.isEmpty() && item->pixm.imgInfo.isRequest) || item->imageLoadDeferred;
+	if (((item->isImageFrame()) || (item->isTextFrame())) && (!item->Pfile.isEmpty()) && imageLayers)
+	{
+		for (auto it2 = item->pixm.imgInfo.RequestProps.begin(); it2 != item->pixm.imgInfo.RequestProps.end(); ++it2)
+		{
+			docu.writeEmptyElement("PSDLayer");
+			docu.writeAttribute("Layer",it2.key());
+			docu.writeAttribute("Visible", static_cast<int>(it2.value().visible));
+			docu.writeAttribute("useMask", static_cast<int>(it2.value().useMask));
+			docu.writeAttribute("Opacity", it2.value().opacity);
+			docu.writeAttribute("Blend", it2.value().blend);
 		}
-		if (((item->GrType > 0) && (item->GrType != Gradient_Pattern) && (item->GrType != Gradient_4Colors) && (item->GrType != Gradient_Mesh) && (item->GrType != Gradient_Hatch)) && (item->gradient().isEmpty()))
+	}
+	if (((item->GrType > 0) && (item->GrType != Gradient_Pattern) && (item->GrType != Gradient_4Colors) && (item->GrType != Gradient_Mesh) && (item->GrType != Gradient_Hatch)) && (item->gradient().isEmpty()))
+	{
+		QList<VColorStop*> cstops = item->fill_gradient.colorStops();
+		for (int cst = 0; cst < item->fill_gradient.stops(); ++cst)
 		{
-			QList<VColorStop*> cstops = item->fill_gradient.colorStops();
-			for (int cst = 0; cst < item->fill_gradient.stops(); ++cst)
-			{
-				docu.writeEmptyElement("ColorStop");
-				docu.writeAttribute("Ramp", cstops.at(cst)->rampPoint);
-				docu.writeAttribute("Name", cstops.at(cst)->name);
-				docu.writeAttribute("Shade", cstops.at(cst)->shade);
-				docu.writeAttribute("Opacity", cstops.at(cst)->opacity);
-			}
+			docu.writeEmptyElement("ColorStop");
+			docu.writeAttribute("Ramp", cstops.at(cst)->rampPoint);
+			docu.writeAttribute("Name", cstops.at(cst)->name);
+			docu.writeAttribute("Shade", cstops.at(cst)->shade);
+			docu.writeAttribute("Opacity", cstops.at(cst)->opacity);
 		}
-		if ((item->GrTypeStroke > 0) && (item->strokeGradient().isEmpty()))
+	}
+	if ((item->GrTypeStroke > 0) && (item->strokeGradient().isEmpty()))
+	{
+		QList<VColorStop*> cstops = item->stroke_gradient.colorStops();
+		for (int cst = 0; cst < item->stroke_gradient.stops(); ++cst)
 		{
-			QList<VColorStop*> cstops = item->stroke_gradient.colorStops();
-			for (int cst = 0; cst < item->stroke_gradient.stops(); ++cst)
-			{
-				docu.writeEmptyElement("ColorStopStroke");
-				docu.writeAttribute("Ramp", cstops.at(cst)->rampPoint);
-				docu.writeAttribute("Name", cstops.at(cst)->name);
-				docu.writeAttribute("Shade", cstops.at(cst)->shade);
-				docu.writeAttribute("Opacity", cstops.at(cst)->opacity);
-			}
+			docu.writeEmptyElement("ColorStopStroke");
+			docu.writeAttribute("Ramp", cstops.at(cst)->rampPoint);
+			docu.writeAttribute("Name", cstops.at(cst)->name);
+			docu.writeAttribute("Shade", cstops.at(cst)->shade);
+			docu.writeAttribute("Opacity", cstops.at(cst)->opacity);
+		}
+	}
+	if ((item->GrMask > 0) && (item->gradientMask().isEmpty()))
+	{
+		QList<VColorStop*> cstops = item->mask_gradient.colorStops();
+		for (int cst = 0; cst < item->mask_gradient.stops(); ++cst)
+		{
+			docu.writeEmptyElement("ColorStopMaskGradient");
+			docu.writeAttribute("Ramp", cstops.at(cst)->rampPoint);
+			docu.writeAttribute("Name", cstops.at(cst)->name);
+			docu.writeAttribute("Shade", cstops.at(cst)->shade);
+			docu.writeAttribute("Opacity", cstops.at(cst)->opacity);
 		}
-		if ((item->GrMask > 0) && (item->gradientMask().isEmpty()))
+	}
+	if (item->GrType == Gradient_Mesh)
+	{
+		for (int grow = 0; grow < item->meshGradientArray.count(); grow++)
 		{
-			QList<VColorStop*> cstops = item->mask_gradient.colorStops();
-			for (int cst = 0; cst < item->mask_gradient.stops(); ++cst)
+			for (int gcol = 0; gcol < item->meshGradientArray[grow].count(); gcol++)
 			{
-				docu.writeEmptyElement("ColorStopMaskGradient");
-				docu.writeAttribute("Ramp", cstops.at(cst)->rampPoint);
-				docu.writeAttribute("Name", cstops.at(cst)->name);
-				docu.writeAttribute("Shade", cstops.at(cst)->shade);
-				docu.writeAttribute("Opacity", cstops.at(cst)->opacity);
+				MeshPoint mp = item->meshGradientArray[grow][gcol];
+				docu.writeStartElement("MeshPoint");
+				docu.writeAttribute("GridPointX", mp.gridPoint.x());
+				docu.writeAttribute("GridPointY", mp.gridPoint.y());
+				docu.writeAttribute("ControlTopX", mp.controlTop.x());
+				docu.writeAttribute("ControlTopY", mp.controlTop.y());
+				docu.writeAttribute("ControlBottomX", mp.controlBottom.x());
+				docu.writeAttribute("ControlBottomY", mp.controlBottom.y());
+				docu.writeAttribute("ControlLeftX", mp.controlLeft.x());
+				docu.writeAttribute("ControlLeftY", mp.controlLeft.y());
+				docu.writeAttribute("ControlRightX", mp.controlRight.x());
+				docu.writeAttribute("ControlRightY", mp.controlRight.y());
+				docu.writeAttribute("ControlColorX", mp.controlColor.x());
+				docu.writeAttribute("ControlColorY", mp.controlColor.y());
+				docu.writeAttribute("Name", mp.colorName);
+				docu.writeAttribute("Shade", mp.shade);
+				docu.writeAttribute("Transparency", mp.transparency);
+				docu.writeEndElement();
 			}
 		}
-		if (item->GrType == Gradient_Mesh)
+	}
+	if (item->GrType == Gradient_PatchMesh)
+	{
+		for (int grow = 0; grow < item->meshGradientPatches.count(); grow++)
 		{
-			for (int grow = 0; grow < item->meshGradientArray.count(); grow++)
+			meshGradientPatch patch = item->meshGradientPatches[grow];
+			for (int gcol = 0; gcol < 4; gcol++)
 			{
-				for (int gcol = 0; gcol < item->meshGradientArray[grow].count(); gcol++)
+				MeshPoint mp;
+				docu.writeStartElement("PatchMeshPoint");
+				if (gcol == 0)
 				{
-					MeshPoint mp = item->meshGradientArray[grow][gcol];
-					docu.writeStartElement("MeshPoint");
-					docu.writeAttribute("GridPointX", mp.gridPoint.x());
-					docu.writeAttribute("GridPointY", mp.gridPoint.y());
-					docu.writeAttribute("ControlTopX", mp.controlTop.x());
-					docu.writeAttribute("ControlTopY", mp.controlTop.y());
+					mp = patch.TL;
 					docu.writeAttribute("ControlBottomX", mp.controlBottom.x());
 					docu.writeAttribute("ControlBottomY", mp.controlBottom.y());
-					docu.writeAttribute("ControlLeftX", mp.controlLeft.x());
-					docu.writeAttribute("ControlLeftY", mp.controlLeft.y());
 					docu.writeAttribute("ControlRightX", mp.controlRight.x());
 					docu.writeAttribute("ControlRightY", mp.controlRight.y());
-					docu.writeAttribute("ControlColorX", mp.controlColor.x());
-					docu.writeAttribute("ControlColorY", mp.controlColor.y());
-					docu.writeAttribute("Name", mp.colorName);
-					docu.writeAttribute("Shade", mp.shade);
-					docu.writeAttribute("Transparency", mp.transparency);
-					docu.writeEndElement();
 				}
-			}
-		}
-		if (item->GrType == Gradient_PatchMesh)
-		{
-			for (int grow = 0; grow < item->meshGradientPatches.count(); grow++)
-			{
-				meshGradientPatch patch = item->meshGradientPatches[grow];
-				for (int gcol = 0; gcol < 4; gcol++)
+				else if (gcol == 1)
 				{
-					MeshPoint mp;
-					docu.writeStartElement("PatchMeshPoint");
-					if (gcol == 0)
-					{
-						mp = patch.TL;
-						docu.writeAttribute("ControlBottomX", mp.controlBottom.x());
-						docu.writeAttribute("ControlBottomY", mp.controlBottom.y());
-						docu.writeAttribute("ControlRightX", mp.controlRight.x());
-						docu.writeAttribute("ControlRightY", mp.controlRight.y());
-					}
-					else if (gcol == 1)
-					{
-						mp = patch.TR;
-						docu.writeAttribute("ControlBottomX", mp.controlBottom.x());
-						docu.writeAttribute("ControlBottomY", mp.controlBottom.y());
-						docu.writeAttribute("ControlLeftX", mp.controlLeft.x());
-						docu.writeAttribute("ControlLeftY", mp.controlLeft.y());
-					}
-					else if (gcol == 2)
-					{
-						mp = patch.BR;
-						docu.writeAttribute("ControlTopX", mp.controlTop.x());
-						docu.writeAttribute("ControlTopY", mp.controlTop.y());
-						docu.writeAttribute("ControlLeftX", mp.controlLeft.x());
-						docu.writeAttribute("ControlLeftY", mp.controlLeft.y());
-					}
-					else if (gcol == 3)
-					{
-						mp = patch.BL;
-						docu.writeAttribute("ControlTopX", mp.controlTop.x());
-						docu.writeAttribute("ControlTopY", mp.controlTop.y());
-						docu.writeAttribute("ControlRightX", mp.controlRight.x());
-						docu.writeAttribute("ControlRightY", mp.controlRight.y());
-					}
-					docu.writeAttribute("GridPointX", mp.gridPoint.x());
-					docu.writeAttribute("GridPointY", mp.gridPoint.y());
-					docu.writeAttribute("ControlColorX", mp.controlColor.x());
-					docu.writeAttribute("ControlColorY", mp.controlColor.y());
-					docu.writeAttribute("Name", mp.colorName);
-					docu.writeAttribute("Shade", mp.shade);
-					docu.writeAttribute("Transparency", mp.transparency);
-					docu.writeEndElement();
+					mp = patch.TR;
+					docu.writeAttribute("ControlBottomX", mp.controlBottom.x());
+					docu.writeAttribute("ControlBottomY", mp.controlBottom.y());
+					docu.writeAttribute("ControlLeftX", mp.controlLeft.x());
+					docu.writeAttribute("ControlLeftY", mp.controlLeft.y());
+				}
+				else if (gcol == 2)
+				{
+					mp = patch.BR;
+					docu.writeAttribute("ControlTopX", mp.controlTop.x());
+					docu.writeAttribute("ControlTopY", mp.controlTop.y());
+					docu.writeAttribute("ControlLeftX", mp.controlLeft.x());
+					docu.writeAttribute("ControlLeftY", mp.controlLeft.y());
 				}
+				else if (gcol == 3)
+				{
+					mp = patch.BL;
+					docu.writeAttribute("ControlTopX", mp.controlTop.x());
+					docu.writeAttribute("ControlTopY", mp.controlTop.y());
+					docu.writeAttribute("ControlRightX", mp.controlRight.x());
+					docu.writeAttribute("ControlRightY", mp.controlRight.y());
+				}
+				docu.writeAttribute("GridPointX", mp.gridPoint.x());
+				docu.writeAttribute("GridPointY", mp.gridPoint.y());
+				docu.writeAttribute("ControlColorX", mp.controlColor.x());
+				docu.writeAttribute("ControlColorY", mp.controlColor.y());
+				docu.writeAttribute("Name", mp.colorName);
+				docu.writeAttribute("Shade", mp.shade);
+				docu.writeAttribute("Transparency", mp.transparency);
+				docu.writeEndElement();
 			}
 		}
+	}
 
-		if (item->isLatexFrame())
+	if (item->isLatexFrame())
+	{
+		docu.writeStartElement("LaTeX");
+		const PageItem_LatexFrame *latexitem = item->asLatexFrame();
+		QFileInfo fi(latexitem->configFile());
+		docu.writeAttribute("ConfigFile", fi.fileName());
+		docu.writeAttribute("DPI", latexitem->dpi());
+		docu.writeAttribute("UsePreamble", latexitem->usePreamble());
+		QMapIterator<QString, QString> i(latexitem->editorProperties);
+		while (i.hasNext())
 		{
-			docu.writeStartElement("LaTeX");
-			const PageItem_LatexFrame *latexitem = item->asLatexFrame();
-			QFileInfo fi(latexitem->configFile());
-			docu.writeAttribute("ConfigFile", fi.fileName());
-			docu.writeAttribute("DPI", latexitem->dpi());
-			docu.writeAttribute("UsePreamble", latexitem->usePreamble());
-			QMapIterator<QString, QString> i(latexitem->editorProperties);
-			while (i.hasNext())
-			{
-				i.next();
-				docu.writeStartElement("Property");
-				docu.writeAttribute("Name", i.key());
-				docu.writeAttribute("Value", i.value());
-				docu.writeEndElement();
-			}
-			docu.writeCharacters(latexitem->formula());
+			i.next();
+			docu.writeStartElement("Property");
+			docu.writeAttribute("Name", i.key());
+			docu.writeAttribute("Value", i.value());
 			docu.writeEndElement();
 		}
+		docu.writeCharacters(latexitem->formula());
+		docu.writeEndElement();
+	}
 #ifdef HAVE_OSG
-		if (item->isOSGFrame())
+	if (item->isOSGFrame())
+	{
+		PageItem_OSGFrame *osgitem = item->asOSGFrame();
+		if (!item->Pfile.isEmpty())
 		{
-			PageItem_OSGFrame *osgitem = item->asOSGFrame();
-			if (!item->Pfile.isEmpty())
+			for (auto itv = osgitem->viewMap.begin(); itv != osgitem->viewMap.end(); ++itv)
 			{
-				for (auto itv = osgitem->viewMap.begin(); itv != osgitem->viewMap.end(); ++itv)
+				QString tmp;
+				docu.writeStartElement("OSGViews");
+				docu.writeAttribute("viewName", itv.key());
+				docu.writeAttribute("angleFOV", itv.value().angleFOV);
+				QString trackM;
+				for (uint matx = 0; matx < 4; ++matx)
 				{
-					QString tmp;
-					docu.writeStartElement("OSGViews");
-					docu.writeAttribute("viewName", itv.key());
-					docu.writeAttribute("angleFOV", itv.value().angleFOV);
-					QString trackM;
-					for (uint matx = 0; matx < 4; ++matx)
+					for (uint maty = 0; maty < 4; ++maty)
 					{
-						for (uint maty = 0; maty < 4; ++maty)
-						{
-							trackM += tmp.setNum(itv.value().trackerMatrix(matx, maty))+" ";
-						}
+						trackM += tmp.setNum(itv.value().trackerMatrix(matx, maty))+" ";
 					}
-					docu.writeAttribute("trackM", trackM);
-					QString trackC;
-					trackC += tmp.setNum(itv.value().trackerCenter[0])+" ";
-					trackC += tmp.setNum(itv.value().trackerCenter[1])+" ";
-					trackC += tmp.setNum(itv.value().trackerCenter[2]);
-					docu.writeAttribute("trackC", trackC);
-					QString cameraP;
-					cameraP += tmp.setNum(itv.value().cameraPosition[0])+" ";
-					cameraP += tmp.setNum(itv.value().cameraPosition[1])+" ";
-					cameraP += tmp.setNum(itv.value().cameraPosition[2]);
-					docu.writeAttribute("cameraP", cameraP);
-					QString cameraU;
-					cameraU += tmp.setNum(itv.value().cameraUp[0])+" ";
-					cameraU += tmp.setNum(itv.value().cameraUp[1])+" ";
-					cameraU += tmp.setNum(itv.value().cameraUp[2]);
-					docu.writeAttribute("cameraU", cameraU);
-					docu.writeAttribute("trackerDist", itv.value().trackerDist);
-					docu.writeAttribute("trackerSize", itv.value().trackerSize);
-					docu.writeAttribute("illumination", itv.value().illumination);
-					docu.writeAttribute("rendermode", itv.value().rendermode);
-					docu.writeAttribute("trans", itv.value().addedTransparency);
-					docu.writeAttribute("colorAC", itv.value().colorAC.name());
-					docu.writeAttribute("colorFC", itv.value().colorFC.name());
-					docu.writeEndElement();
 				}
+				docu.writeAttribute("trackM", trackM);
+				QString trackC;
+				trackC += tmp.setNum(itv.value().trackerCenter[0])+" ";
+				trackC += tmp.setNum(itv.value().trackerCenter[1])+" ";
+				trackC += tmp.setNum(itv.value().trackerCenter[2]);
+				docu.writeAttribute("trackC", trackC);
+				QString cameraP;
+				cameraP += tmp.setNum(itv.value().cameraPosition[0])+" ";
+				cameraP += tmp.setNum(itv.value().cameraPosition[1])+" ";
+				cameraP += tmp.setNum(itv.value().cameraPosition[2]);
+				docu.writeAttribute("cameraP", cameraP);
+				QString cameraU;
+				cameraU += tmp.setNum(itv.value().cameraUp[0])+" ";
+				cameraU += tmp.setNum(itv.value().cameraUp[1])+" ";
+				cameraU += tmp.setNum(itv.value().cameraUp[2]);
+				docu.writeAttribute("cameraU", cameraU);
+				docu.writeAttribute("trackerDist", itv.value().trackerDist);
+				docu.writeAttribute("trackerSize", itv.value().trackerSize);
+				docu.writeAttribute("illumination", itv.value().illumination);
+				docu.writeAttribute("rendermode", itv.value().rendermode);
+				docu.writeAttribute("trans", itv.value().addedTransparency);
+				docu.writeAttribute("colorAC", itv.value().colorAC.name());
+				docu.writeAttribute("colorFC", itv.value().colorFC.name());
+				docu.writeEndElement();
 			}
 		}
+	}
 #endif
-		if (item->isGroup())
-		{
-			WriteObjects(m_Doc, docu, baseDir, nullptr, 0, ItemSelectionGroup, &item->groupItemList);
-		}
-		//Write all the cells and their data to the document, as sub-elements of the pageitem.
-		if (item->isTable())
-		{
-			//ItemType == PageItem::Table or 16 (pageitem.h)
-			const PageItem_Table* tableItem = item->asTable();
-			docu.writeStartElement("TableData");
-			QString tstyle = tableItem->styleName();
-			docu.writeAttribute("Style", tableItem->styleName());
-			TableStyle ts;
-			if (!tstyle.isEmpty())
-				ts = tableItem->style();
-
-			if ((tstyle.isEmpty()) || ((!tstyle.isEmpty()) && (!ts.isInhFillColor())))
-				docu.writeAttribute("FillColor", tableItem->fillColor());
-			if ((tstyle.isEmpty()) || ((!tstyle.isEmpty()) && ( !ts.isInhFillShade())))
-				docu.writeAttribute("FillShade", tableItem->fillShade());
-			if ((tstyle.isEmpty()) || ((!tstyle.isEmpty()) && ( !ts.isInhLeftBorder())))
+	if (item->isGroup())
+	{
+		WriteObjects(m_Doc, docu, baseDir, nullptr, 0, ItemSelectionGroup, &item->groupItemList);
+	}
+	//Write all the cells and their data to the document, as sub-elements of the pageitem.
+	if (item->isTable())
+	{
+		//ItemType == PageItem::Table or 16 (pageitem.h)
+		const PageItem_Table* tableItem = item->asTable();
+		docu.writeStartElement("TableData");
+		QString tstyle = tableItem->styleName();
+		docu.writeAttribute("Style", tableItem->styleName());
+		TableStyle ts;
+		if (!tstyle.isEmpty())
+			ts = tableItem->style();
+
+		if ((tstyle.isEmpty()) || ((!tstyle.isEmpty()) && (!ts.isInhFillColor())))
+			docu.writeAttribute("FillColor", tableItem->fillColor());
+		if ((tstyle.isEmpty()) || ((!tstyle.isEmpty()) && ( !ts.isInhFillShade())))
+			docu.writeAttribute("FillShade", tableItem->fillShade());
+		if ((tstyle.isEmpty()) || ((!tstyle.isEmpty()) && ( !ts.isInhLeftBorder())))
+		{
+			TableBorder tbLeft = tableItem->leftBorder();
+			docu.writeStartElement("TableBorderLeft");
+			for (const TableBorderLine& tbl : tbLeft.borderLines())
 			{
-				TableBorder tbLeft = tableItem->leftBorder();
-				docu.writeStartElement("TableBorderLeft");
-				for (const TableBorderLine& tbl : tbLeft.borderLines())
-				{
-					docu.writeStartElement("TableBorderLine");
-					docu.writeAttribute("Width", tbl.width());
-					docu.writeAttribute("PenStyle", tbl.style());
-					docu.writeAttribute("Color", tbl.color());
-					docu.writeAttribute("Shade", tbl.shade());
-					docu.writeEndElement();
-				}
+				docu.writeStartElement("TableBorderLine");
+				docu.writeAttribute("Width", tbl.width());
+				docu.writeAttribute("PenStyle", tbl.style());
+				docu.writeAttribute("Color", tbl.color());
+				docu.writeAttribute("Shade", tbl.shade());
 				docu.writeEndElement();
 			}
-			if ((tstyle.isEmpty()) || ((!tstyle.isEmpty()) && ( !ts.isInhRightBorder())))
+			docu.writeEndElement();
+		}
+		if ((tstyle.isEmpty()) || ((!tstyle.isEmpty()) && ( !ts.isInhRightBorder())))
+		{
+			TableBorder tbRight = tableItem->rightBorder();
+			docu.writeStartElement("TableBorderRight");
+			for (const TableBorderLine& tbl : tbRight.borderLines())
 			{
-				TableBorder tbRight = tableItem->rightBorder();
-				docu.writeStartElement("TableBorderRight");
-				for (const TableBorderLine& tbl : tbRight.borderLines())
-				{
-					docu.writeStartElement("TableBorderLine");
-					docu.writeAttribute("Width", tbl.width());
-					docu.writeAttribute("PenStyle", tbl.style());
-					docu.writeAttribute("Color", tbl.color());
-					docu.writeAttribute("Shade", tbl.shade());
-					docu.writeEndElement();
-				}
+				docu.writeStartElement("TableBorderLine");
+				docu.writeAttribute("Width", tbl.width());
+				docu.writeAttribute("PenStyle", tbl.style());
+				docu.writeAttribute("Color", tbl.color());
+				docu.writeAttribute("Shade", tbl.shade());
 				docu.writeEndElement();
 			}
-			if ((tstyle.isEmpty()) || ((!tstyle.isEmpty()) && ( !ts.isInhTopBorder())))
+			docu.writeEndElement();
+		}
+		if ((tstyle.isEmpty()) || ((!tstyle.isEmpty()) && ( !ts.isInhTopBorder())))
+		{
+			TableBorder tbTop = tableItem->topBorder();
+			docu.writeStartElement("TableBorderTop");
+			for (const TableBorderLine& tbl : tbTop.borderLines())
 			{
-				TableBorder tbTop = tableItem->topBorder();
-				docu.writeStartElement("TableBorderTop");
-				for (const TableBorderLine& tbl : tbTop.borderLines())
-				{
-					docu.writeStartElement("TableBorderLine");
-					docu.writeAttribute("Width", tbl.width());
-					docu.writeAttribute("PenStyle", tbl.style());
-					docu.writeAttribute("Color", tbl.color());
-					docu.writeAttribute("Shade", tbl.shade());
-					docu.writeEndElement();
-				}
+				docu.writeStartElement("TableBorderLine");
+				docu.writeAttribute("Width", tbl.width());
+				docu.writeAttribute("PenStyle", tbl.style());
+				docu.writeAttribute("Color", tbl.color());
+				docu.writeAttribute("Shade", tbl.shade());
 				docu.writeEndElement();
 			}
-			if ((tstyle.isEmpty()) || ((!tstyle.isEmpty()) && ( !ts.isInhBottomBorder())))
+			docu.writeEndElement();
+		}
+		if ((tstyle.isEmpty()) || ((!tstyle.isEmpty()) && ( !ts.isInhBottomBorder())))
+		{
+			TableBorder tbBottom = tableItem->bottomBorder();
+			docu.writeStartElement("TableBorderBottom");
+			for (const TableBorderLine& tbl : tbBottom.borderLines())
 			{
-				TableBorder tbBottom = tableItem->bottomBorder();
-				docu.writeStartElement("TableBorderBottom");
-				for (const TableBorderLine& tbl : tbBottom.borderLines())
-				{
-					docu.writeStartElement("TableBorderLine");
-					docu.writeAttribute("Width", tbl.width());
-					docu.writeAttribute("PenStyle", tbl.style());
-					docu.writeAttribute("Color", tbl.color());
-					docu.writeAttribute("Shade", tbl.shade());
-					docu.writeEndElement();
-				}
+				docu.writeStartElement("TableBorderLine");
+				docu.writeAttribute("Width", tbl.width());
+				docu.writeAttribute("PenStyle", tbl.style());
+				docu.writeAttribute("Color", tbl.color());
+				docu.writeAttribute("Shade", tbl.shade());
 				docu.writeEndElement();
 			}
-			//for each cell, write it to the doc
-			for (int row = 0; row < tableItem->rows(); ++row)
+			docu.writeEndElement();
+		}
+		//for each cell, write it to the doc
+		for (int row = 0; row < tableItem->rows(); ++row)
+		{
+			for (int col = 0; col < tableItem->columns(); col ++)
 			{
-				for (int col = 0; col < tableItem->columns(); col ++)
+				TableCell cell = tableItem->cellAt(row, col);
+				if (cell.row() != row || cell.column() != col)
+					continue;
+				const PageItem* textFrame = cell.textFrame();
+				docu.writeStartElement("Cell");
+				docu.writeAttribute("Row", cell.row());
+				docu.writeAttribute("Column", cell.column());
+				docu.writeAttribute("Style", cell.styleName());
+				docu.writeAttribute("TextColumns", textFrame->columns());
+				docu.writeAttribute("TextColGap", textFrame->columnGap());
+				docu.writeAttribute("TextDistLeft", textFrame->textToFrameDistLeft());
+				docu.writeAttribute("TextDistTop", textFrame->textToFrameDistTop());
+				docu.writeAttribute("TextDistBottom", textFrame->textToFrameDistBottom());
+				docu.writeAttribute("TextDistRight", textFrame->textToFrameDistRight());
+				docu.writeAttribute("TextVertAlign", textFrame->verticalAlignment());
+				docu.writeAttribute("Flop", textFrame->firstLineOffset());
+
+				QString cstyle = cell.styleName();
+				CellStyle cs;
+				if (!cstyle.isEmpty())
+					cs = cell.style();
+				if (!cell.style().isInhFillColor())
+					docu.writeAttribute("FillColor", cell.fillColor());
+				if (!cell.style().isInhFillShade())
+					docu.writeAttribute("FillShade", cell.fillShade());
+				if (!cell.style().isInhLeftPadding())
+					docu.writeAttribute("LeftPadding",cell.leftPadding());
+				if (!cell.style().isInhRightPadding())
+					docu.writeAttribute("RightPadding", cell.rightPadding());
+				if (!cell.style().isInhTopPadding())
+					docu.writeAttribute("TopPadding",cell.topPadding());
+				if (!cell.style().isInhBottomPadding())
+					docu.writeAttribute("BottomPadding", cell.bottomPadding());
+				if (!cell.style().isInhLeftBorder())
 				{
-					TableCell cell = tableItem->cellAt(row, col);
-					if (cell.row() != row || cell.column() != col)
-						continue;
-					const PageItem* textFrame = cell.textFrame();
-					docu.writeStartElement("Cell");
-					docu.writeAttribute("Row", cell.row());
-					docu.writeAttribute("Column", cell.column());
-					docu.writeAttribute("Style", cell.styleName());
-					docu.writeAttribute("TextColumns", textFrame->columns());
-					docu.writeAttribute("TextColGap", textFrame->columnGap());
-					docu.writeAttribute("TextDistLeft", textFrame->textToFrameDistLeft());
-					docu.writeAttribute("TextDistTop", textFrame->textToFrameDistTop());
-					docu.writeAttribute("TextDistBottom", textFrame->textToFrameDistBottom());
-					docu.writeAttribute("TextDistRight", textFrame->textToFrameDistRight());
-					docu.writeAttribute("TextVertAlign", textFrame->verticalAlignment());
-					docu.writeAttribute("Flop", textFrame->firstLineOffset());
-
-					QString cstyle = cell.styleName();
-					CellStyle cs;
-					if (!cstyle.isEmpty())
-						cs = cell.style();
-					if (!cell.style().isInhFillColor())
-						docu.writeAttribute("FillColor", cell.fillColor());
-					if (!cell.style().isInhFillShade())
-						docu.writeAttribute("FillShade", cell.fillShade());
-					if (!cell.style().isInhLeftPadding())
-						docu.writeAttribute("LeftPadding",cell.leftPadding());
-					if (!cell.style().isInhRightPadding())
-						docu.writeAttribute("RightPadding", cell.rightPadding());
-					if (!cell.style().isInhTopPadding())
-						docu.writeAttribute("TopPadding",cell.topPadding());
-					if (!cell.style().isInhBottomPadding())
-						docu.writeAttribute("BottomPadding", cell.bottomPadding());
-					if (!cell.style().isInhLeftBorder())
+					TableBorder tbLeft = cell.leftBorder();
+					docu.writeStartElement("TableBorderLeft");
+					docu.writeAttribute("Width", tbLeft.width());
+					for (const TableBorderLine& tbl : tbLeft.borderLines())
 					{
-						TableBorder tbLeft = cell.leftBorder();
-						docu.writeStartElement("TableBorderLeft");
-						docu.writeAttribute("Width", tbLeft.width());
-						for (const TableBorderLine& tbl : tbLeft.borderLines())
-						{
-							docu.writeStartElement("TableBorderLine");
-							docu.writeAttribute("Width", tbl.width());
-							docu.writeAttribute("PenStyle", tbl.style());
-							docu.writeAttribute("Color", tbl.color());
-							docu.writeAttribute("Shade", tbl.shade());
-							docu.writeEndElement();
-						}
+						docu.writeStartElement("TableBorderLine");
+						docu.writeAttribute("Width", tbl.width());
+						docu.writeAttribute("PenStyle", tbl.style());
+						docu.writeAttribute("Color", tbl.color());
+						docu.writeAttribute("Shade", tbl.shade());
 						docu.writeEndElement();
 					}
-					if (!cell.style().isInhRightBorder())
+					docu.writeEndElement();
+				}
+				if (!cell.style().isInhRightBorder())
+				{
+					TableBorder tbRight = cell.rightBorder();
+					docu.writeStartElement("TableBorderRight");
+					docu.writeAttribute("Width", tbRight.width());
+					for (const TableBorderLine& tbl : tbRight.borderLines())
 					{
-						TableBorder tbRight = cell.rightBorder();
-						docu.writeStartElement("TableBorderRight");
-						docu.writeAttribute("Width", tbRight.width());
-						for (const TableBorderLine& tbl : tbRight.borderLines())
-						{
-							docu.writeStartElement("TableBorderLine");
-							docu.writeAttribute("Width", tbl.width());
-							docu.writeAttribute("PenStyle", tbl.style());
-							docu.writeAttribute("Color", tbl.color());
-							docu.writeAttribute("Shade", tbl.shade());
-							docu.writeEndElement();
-						}
+						docu.writeStartElement("TableBorderLine");
+						docu.writeAttribute("Width", tbl.width());
+						docu.writeAttribute("PenStyle", tbl.style());
+						docu.writeAttribute("Color", tbl.color());
+						docu.writeAttribute("Shade", tbl.shade());
 						docu.writeEndElement();
 					}
-					if (!cell.style().isInhTopBorder())
+					docu.writeEndElement();
+				}
+				if (!cell.style().isInhTopBorder())
+				{
+					TableBorder tbTop = cell.topBorder();
+					docu.writeStartElement("TableBorderTop");
+					docu.writeAttribute("Width", tbTop.width());
+					for (const TableBorderLine& tbl : tbTop.borderLines())
 					{
-						TableBorder tbTop = cell.topBorder();
-						docu.writeStartElement("TableBorderTop");
-						docu.writeAttribute("Width", tbTop.width());
-						for (const TableBorderLine& tbl : tbTop.borderLines())
-						{
-							docu.writeStartElement("TableBorderLine");
-							docu.writeAttribute("Width", tbl.width());
-							docu.writeAttribute("PenStyle", tbl.style());
-							docu.writeAttribute("Color", tbl.color());
-							docu.writeAttribute("Shade", tbl.shade());
-							docu.writeEndElement();
-						}
+						docu.writeStartElement("TableBorderLine");
+						docu.writeAttribute("Width", tbl.width());
+						docu.writeAttribute("PenStyle", tbl.style());
+						docu.writeAttribute("Color", tbl.color());
+						docu.writeAttribute("Shade", tbl.shade());
 						docu.writeEndElement();
 					}
-					if (!cell.style().isInhBottomBorder())
+					docu.writeEndElement();
+				}
+				if (!cell.style().isInhBottomBorder())
+				{
+					TableBorder tbBottom = cell.bottomBorder();
+					docu.writeStartElement("TableBorderBottom");
+					docu.writeAttribute("Width", tbBottom.width());
+					for (const TableBorderLine& tbl : tbBottom.borderLines())
 					{
-						TableBorder tbBottom = cell.bottomBorder();
-						docu.writeStartElement("TableBorderBottom");
-						docu.writeAttribute("Width", tbBottom.width());
-						for (const TableBorderLine& tbl : tbBottom.borderLines())
-						{
-							docu.writeStartElement("TableBorderLine");
-							docu.writeAttribute("Width", tbl.width());
-							docu.writeAttribute("PenStyle", tbl.style());
-							docu.writeAttribute("Color", tbl.color());
-							docu.writeAttribute("Shade", tbl.shade());
-							docu.writeEndElement();
-						}
+						docu.writeStartElement("TableBorderLine");
+						docu.writeAttribute("Width", tbl.width());
+						docu.writeAttribute("PenStyle", tbl.style());
+						docu.writeAttribute("Color", tbl.color());
+						docu.writeAttribute("Shade", tbl.shade());
 						docu.writeEndElement();
 					}
-					//End Cell
-					
-					writeStoryText(doc, docu, cell.textFrame()->itemText);
 					docu.writeEndElement();
 				}
+				//End Cell
+				
+				writeStoryText(doc, docu, cell.textFrame()->itemText);
+				docu.writeEndElement();
 			}
-			docu.writeEndElement();
 		}
+		docu.writeEndElement();
+	}
 
-		//CB PageItemAttributes
-		ObjAttrVector *attributes = item->getObjectAttributes();
-		if (attributes->count() > 0)
+	//CB PageItemAttributes
+	ObjAttrVector *attributes = item->getObjectAttributes();
+	if (attributes->count() > 0)
+	{
+		docu.writeStartElement("PageItemAttributes");
+		for (const auto& itemAttr : *attributes)
 		{
-			docu.writeStartElement("PageItemAttributes");
-			for (const auto& itemAttr : *attributes)
-			{
-				docu.writeEmptyElement("ItemAttribute");
-				docu.writeAttribute("Name", itemAttr.name);
-				docu.writeAttribute("Type", itemAttr.type);
-				docu.writeAttribute("Value", itemAttr.value);
-				docu.writeAttribute("Parameter", itemAttr.parameter);
-				docu.writeAttribute("Relationship", itemAttr.relationship);
-				docu.writeAttribute("RelationshipTo", itemAttr.relationshipto);
-				docu.writeAttribute("AutoAddTo", itemAttr.autoaddto);
-			}
-			docu.writeEndElement();
+			docu.writeEmptyElement("ItemAttribute");
+			docu.writeAttribute("Name", itemAttr.name);
+			docu.writeAttribute("Type", itemAttr.type);
+			docu.writeAttribute("Value", itemAttr.value);
+			docu.writeAttribute("Parameter", itemAttr.parameter);
+			docu.writeAttribute("Relationship", itemAttr.relationship);
+			docu.writeAttribute("RelationshipTo", itemAttr.relationshipto);
+			docu.writeAttribute("AutoAddTo", itemAttr.autoaddto);
 		}
 		docu.writeEndElement();
 	}
+	docu.writeEndElement();
 }
 
 void Scribus171Format::SetItemProps(ScXmlStreamWriter& docu, PageItem* item, const QString& baseDir) const
@@ -2873,6 +3047,7 @@ void Scribus171Format::SetItemProps(ScXmlStreamWriter& docu, PageItem* item, con
 			docu.writeAttribute("IsInlineImage", static_cast<int>(item->isInlineImage));
 			QFileInfo inlFi(item->Pfile);
 			docu.writeAttribute("InlineImageExt", inlFi.suffix());
+			ScImageMemoryStore::instance().materialize(item->Pfile);
 			QFile inFil(item->Pfile);
 			if (inFil.open(QIODevice::ReadOnly))
 			{
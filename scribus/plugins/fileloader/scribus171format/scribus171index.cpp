@@ -0,0 +1,110 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include "scribus171index.h"
+#include "scpaths.h"
+
+namespace
+{
+	const quint32 indexMagic = 0x53434958; // "SCIX"
+	const quint32 indexVersion = 1;
+	const qint64 indexCacheMaxSize = 32 * 1024 * 1024;
+}
+
+QString Scribus171Index::indexFileName(const QString& canonicalPath)
+{
+	QByteArray hash = QCryptographicHash::hash(canonicalPath.toUtf8(), QCryptographicHash::Sha1).toHex();
+	return ScPaths::slaIndexCacheDir() + QString::fromLatin1(hash) + ".slaidx";
+}
+
+bool Scribus171Index::load(const QString& fileName)
+{
+	QFileInfo fileInfo(fileName);
+	QString canonicalPath = fileInfo.canonicalFilePath();
+	if (canonicalPath.isEmpty())
+		return false;
+	QFile file(indexFileName(canonicalPath));
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	QDataStream ds(&file);
+	quint32 magic = 0;
+	quint32 version = 0;
+	QString storedPath;
+	qint64 storedSize = -1;
+	qint64 storedTime = -1;
+	ds >> magic >> version >> storedPath >> storedSize >> storedTime;
+	if ((magic != indexMagic) || (version != indexVersion) || (storedPath != canonicalPath))
+		return false;
+	// The document was modified since the index was written
+	if ((storedSize != fileInfo.size()) || (storedTime != fileInfo.lastModified().toMSecsSinceEpoch()))
+		return false;
+
+	Scribus171Index index;
+	ds >> index.summary >> index.lastPageObjects >> index.lastMasterObjects;
+	if ((ds.status() != QDataStream::Ok) || index.summary.isEmpty())
+		return false;
+	*this = index;
+
+	// Mark the entry as recently used for prune()
+	file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+	return true;
+}
+
+bool Scribus171Index::store(const QString& fileName) const
+{
+	QFileInfo fileInfo(fileName);
+	QString canonicalPath = fileInfo.canonicalFilePath();
+	if (canonicalPath.isEmpty() || summary.isEmpty())
+		return false;
+	QDir dir(ScPaths::slaIndexCacheDir());
+	if (!dir.exists() && !dir.mkpath(ScPaths::slaIndexCacheDir()))
+		return false;
+
+	QSaveFile file(indexFileName(canonicalPath));
+	if (!file.open(QIODevice::WriteOnly))
+		return false;
+	QDataStream ds(&file);
+	ds << indexMagic << indexVersion << canonicalPath;
+	ds << fileInfo.size() << fileInfo.lastModified().toMSecsSinceEpoch();
+	ds << summary << lastPageObjects << lastMasterObjects;
+	if (ds.status() != QDataStream::Ok)
+	{
+		file.cancelWriting();
+		return false;
+	}
+	if (!file.commit())
+		return false;
+	prune();
+	return true;
+}
+
+int Scribus171Index::lastObject(int pageNumber, bool master) const
+{
+	return master ? lastMasterObjects.value(pageNumber, -1) : lastPageObjects.value(pageNumber, -1);
+}
+
+void Scribus171Index::prune()
+{
+	QDir dir(ScPaths::slaIndexCacheDir());
+	const QFileInfoList entries = dir.entryInfoList(QStringList() << "*.slaidx", QDir::Files, QDir::Time);
+	qint64 totalSize = 0;
+	for (const QFileInfo& entry : entries)
+	{
+		totalSize += entry.size();
+		if (totalSize > indexCacheMaxSize)
+			QFile::remove(entry.absoluteFilePath());
+	}
+}
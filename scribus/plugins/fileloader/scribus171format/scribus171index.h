@@ -0,0 +1,52 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SCRIBUS171INDEX_H
+#define SCRIBUS171INDEX_H
+
+#include <QByteArray>
+#include <QMap>
+#include <QString>
+
+/**
+  * @brief Summary of a saved SLA document, kept in the application cache
+  *
+  * The index is written when a document is saved and lets the page import,
+  * style import and colour import dialogs read what they need without
+  * parsing the whole document. It holds a small SLA document with only the
+  * colours, styles, line styles and page elements of the saved document,
+  * plus the position of the last top level object of each page in the
+  * object list, so that loading one page can stop as soon as it has read
+  * the objects of that page.
+  *
+  * An index is only used while the size and modification time of the
+  * document are those recorded when it was written.
+  */
+class Scribus171Index
+{
+public:
+	/// SLA document with the colours, styles, line styles and pages
+	QByteArray summary;
+	/// Position of the last PageObject of each page
+	QMap<int, int> lastPageObjects;
+	/// Position of the last MasterObject of each master page
+	QMap<int, int> lastMasterObjects;
+
+	/// Loads the index of fileName, returns false if there is none or it is outdated
+	bool load(const QString& fileName);
+	/// Stores the index of fileName, which must have just been written
+	bool store(const QString& fileName) const;
+
+	/// Returns the position of the last object of a page, -1 if the page has none
+	int lastObject(int pageNumber, bool master) const;
+
+private:
+	static QString indexFileName(const QString& canonicalPath);
+	static void prune();
+};
+
+#endif
@@ -20,6 +20,7 @@ for which a new license (GPL+exception) is in place.
 #include "styles/paragraphstyle.h"
 #include "third_party/zip/scribus_zip.h"
 #include "prefsmanager.h"
+#include "text/storytextbuilder.h"
 #include "ui/missing.h"
 
 
@@ -317,6 +318,7 @@ void DocXIm::parseStyledText(PageItem *textItem)
 	}
 	textItem->itemText.setDefaultStyle(defaultParagraphStyle);
 
+	StoryTextBuilder story(textItem->itemText);
 	QDomElement docElem = designMapDom.documentElement();
 	for (QDomElement drawPag = docElem.firstChildElement(); !drawPag.isNull(); drawPag = drawPag.nextSiblingElement())
 	{
@@ -366,31 +368,31 @@ void DocXIm::parseStyledText(PageItem *textItem)
 										txt.replace(QChar(12), SpecialChars::FRAMEBREAK);
 										txt.replace(QChar(30), SpecialChars::NBHYPHEN);
 										txt.replace(QChar(160), SpecialChars::NBSPACE);
-										int posT = textItem->itemText.length();
-										textItem->itemText.insertChars(posT, txt);
-										textItem->itemText.applyStyle(posT, currentParagraphStyle);
-										textItem->itemText.applyCharStyle(posT, txt.length(), currentParagraphStyle.charStyle());
+										int posT = story.length();
+										story.append(txt);
+										story.applyStyle(posT, currentParagraphStyle);
+										story.applyCharStyle(posT, txt.length(), currentParagraphStyle.charStyle());
 									}
 								}
 								else if (spt.tagName() == "w:tab")
 								{
-									int posT = textItem->itemText.length();
-									textItem->itemText.insertChars(posT, SpecialChars::TAB);
-									textItem->itemText.applyStyle(posT, currentParagraphStyle);
+									int posT = story.length();
+									story.append(SpecialChars::TAB);
+									story.applyStyle(posT, currentParagraphStyle);
 								}
 								else if (spt.tagName() == "w:br")
 								{
-									int posT = textItem->itemText.length();
-									textItem->itemText.insertChars(posT, SpecialChars::LINEBREAK);
-									textItem->itemText.applyStyle(posT, currentParagraphStyle);
+									int posT = story.length();
+									story.append(SpecialChars::LINEBREAK);
+									story.applyStyle(posT, currentParagraphStyle);
 								}
 								else if (spt.tagName() == "w:rPr")
 									parseCharProps(spt, currentParagraphStyle);
 							}
 						}
 					}
-					textItem->itemText.insertChars(textItem->itemText.length(), SpecialChars::PARSEP);
-					textItem->itemText.applyStyle(textItem->itemText.length(), currentParagraphStyle);
+					story.append(SpecialChars::PARSEP);
+					story.applyStyle(story.length(), currentParagraphStyle);
 				}
 			}
 		}
@@ -660,6 +662,7 @@ void DocXIm::parsePlainTextOnly(PageItem *textItem)
 	currentParagraphStyle.charStyle().setParent(CommonStrings::DefaultCharacterStyle);
 	currentParagraphStyle.setLineSpacingMode(ParagraphStyle::AutomaticLineSpacing);
 
+	StoryTextBuilder story(textItem->itemText);
 	QDomElement docElem = designMapDom.documentElement();
 	for (QDomElement drawPag = docElem.firstChildElement(); !drawPag.isNull(); drawPag = drawPag.nextSiblingElement())
 	{
@@ -684,22 +687,22 @@ void DocXIm::parsePlainTextOnly(PageItem *textItem)
 										txt.replace(QChar(12), SpecialChars::FRAMEBREAK);
 										txt.replace(QChar(30), SpecialChars::NBHYPHEN);
 										txt.replace(QChar(160), SpecialChars::NBSPACE);
-										textItem->itemText.insertChars(textItem->itemText.length(), txt);
-										textItem->itemText.applyStyle(textItem->itemText.length(), currentParagraphStyle);
-										textItem->itemText.applyCharStyle(textItem->itemText.length(), txt.length(), currentParagraphStyle.charStyle());
+										story.append(txt);
+										story.applyStyle(story.length(), currentParagraphStyle);
+										story.applyCharStyle(story.length(), txt.length(), currentParagraphStyle.charStyle());
 									}
 								}
 								else if (spt.tagName() == "w:tab")
 								{
-									int posT = textItem->itemText.length();
-									textItem->itemText.insertChars(posT, SpecialChars::TAB);
-									textItem->itemText.applyStyle(posT, currentParagraphStyle);
+									int posT = story.length();
+									story.append(SpecialChars::TAB);
+									story.applyStyle(posT, currentParagraphStyle);
 								}
 							}
 						}
 					}
-					textItem->itemText.insertChars(textItem->itemText.length(), SpecialChars::PARSEP);
-					textItem->itemText.applyStyle(textItem->itemText.length(), currentParagraphStyle);
+					story.append(SpecialChars::PARSEP);
+					story.applyStyle(story.length(), currentParagraphStyle);
 				}
 			}
 		}
@@ -27,6 +27,7 @@ for which a new license (GPL+exception) is in place.
 #include "scribusdoc.h"
 #include "styles/charstyle.h"
 #include "styles/paragraphstyle.h"
+#include "text/storytextbuilder.h"
 
 QString FileFormatName()
 {
@@ -91,6 +92,8 @@ void MarkDownIm::parseMarkDown()
 	m_item->itemText.clear();
 	m_item->itemText.setDefaultStyle(defaultParagraphStyle);
 
+	StoryTextBuilder story(m_item->itemText);
+
 	int listStyleCount = 1;
 	int listCounter = 1;
 	int blockCount = m_importedText.blockCount();
@@ -262,22 +265,23 @@ void MarkDownIm::parseMarkDown()
 			}
 		}
 		//Insert our text and a paragraph separator
-		m_item->itemText.insertChars(m_item->itemText.length(), curblk.text());
-		m_item->itemText.insertChars(m_item->itemText.length(), SpecialChars::PARSEP);
+		story.append(curblk.text());
+		story.append(SpecialChars::PARSEP);
 		//If we are not just inserting the text, apply a paragraph style and the character styles based on the positions we recorded earlier
 		if (!m_textOnly)
 		{
 			ParagraphStyle paraStyle;
 			paraStyle.setParent(currentParagraphStyle.name());
-			m_item->itemText.applyStyle(m_item->itemText.length() - 1, paraStyle);
+			story.applyStyle(story.length() - 1, paraStyle);
 			for (int i = 0; i < styleApplicationList.size(); ++i)
 			{
 				CharStyle charStyle;
 				charStyle.setParent(styleApplicationList.at(i).styleName);
-				m_item->itemText.applyCharStyle(styleApplicationList.at(i).start, styleApplicationList.at(i).length, charStyle);
+				story.applyCharStyle(styleApplicationList.at(i).start, styleApplicationList.at(i).length, charStyle);
 			}
 		}
 	}
+	story.commit();
 	if (!m_textOnly)
 	{
 		m_Doc->redefineStyles(newParaStyleSet, false);
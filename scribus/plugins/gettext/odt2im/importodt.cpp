@@ -20,6 +20,7 @@ for which a new license (GPL+exception) is in place.
 #include "scribusdoc.h"
 #include "styles/charstyle.h"
 #include "styles/paragraphstyle.h"
+#include "text/storytextbuilder.h"
 #include "third_party/zip/scribus_zip.h"
 #include "prefsmanager.h"
 #include "scclocale.h"
@@ -332,9 +333,9 @@ void ODTIm::parseRawTextParagraph(const QDomNode &elem, PageItem* item, const Pa
 		}
 	}
 
-	item->itemText.insertChars(posC, SpecialChars::PARSEP);
-	item->itemText.applyStyle(posC, newStyle);
-	posC = item->itemText.length();
+	m_story->append(SpecialChars::PARSEP);
+	m_story->applyStyle(posC, newStyle);
+	posC = m_story->length();
 }
 
 void ODTIm::parseRawText(const QDomElement &elem, PageItem* item)
@@ -348,7 +349,9 @@ void ODTIm::parseRawText(const QDomElement &elem, PageItem* item)
 		item->itemText.clear();
 		item->itemText.setDefaultStyle(newStyle);
 	}
-	int posC = item->itemText.length();
+	StoryTextBuilder story(item->itemText);
+	m_story = &story;
+	int posC = story.length();
 	for (QDomNode para = elem.firstChild(); !para.isNull(); para = para.nextSibling())
 	{
 		if ((para.nodeName() == "text:p") || (para.nodeName() == "text:h"))
@@ -368,6 +371,7 @@ void ODTIm::parseRawText(const QDomElement &elem, PageItem* item)
 			}
 		}
 	}
+	m_story = nullptr;
 }
 
 /* Styled Text import */
@@ -898,12 +902,12 @@ void ODTIm::parseTextParagraph(const QDomNode &elem, PageItem* item, const Parag
 		}
 		m_textStylesStack.push(pStyleName);
 	}
-	if ((pStyle.breakBefore == "column") && (item->itemText.isNotEmpty()))
+	if ((pStyle.breakBefore == "column") && (m_story->length() > 0))
 	{
 		QString txt = SpecialChars::COLBREAK;
 		insertChars(item, txt, tmpStyle, tmpCStyle, posC);
 	}
-	else if ((pStyle.breakBefore == "page") && (item->itemText.isNotEmpty()))
+	else if ((pStyle.breakBefore == "page") && (m_story->length() > 0))
 	{
 		QString txt = SpecialChars::FRAMEBREAK;
 		insertChars(item, txt, tmpStyle, tmpCStyle, posC);
@@ -981,9 +985,9 @@ void ODTIm::parseTextParagraph(const QDomNode &elem, PageItem* item, const Parag
 		QString txt = SpecialChars::FRAMEBREAK;
 		insertChars(item, txt, tmpStyle, tmpCStyle, posC);
 	}
-	item->itemText.insertChars(posC, SpecialChars::PARSEP);
-	item->itemText.applyStyle(posC, tmpStyle);
-	posC = item->itemText.length();
+	m_story->append(SpecialChars::PARSEP);
+	m_story->applyStyle(posC, tmpStyle);
+	posC = m_story->length();
 
 	if (!pStyleName.isEmpty())
 		m_textStylesStack.pop();
@@ -1005,7 +1009,9 @@ void ODTIm::parseText(const QDomElement &elem, PageItem* item, const ObjStyleODT
 		item->itemText.setDefaultStyle(newStyle);
 		item->setFirstLineOffset(FLOPFontAscent);
 	}
-	int posC = item->itemText.length();
+	StoryTextBuilder story(item->itemText);
+	m_story = &story;
+	int posC = story.length();
 	for (QDomNode para = elem.firstChild(); !para.isNull(); para = para.nextSibling())
 	{
 		if ((para.nodeName() == "text:p") || (para.nodeName() == "text:h"))
@@ -1025,6 +1031,7 @@ void ODTIm::parseText(const QDomElement &elem, PageItem* item, const ObjStyleODT
 			}
 		}
 	}
+	m_story = nullptr;
 }
 
 void ODTIm::insertChars(PageItem *item, QString &txt, const ParagraphStyle &tmpStyle, const CharStyle &tmpCStyle, int &posC)
@@ -1032,10 +1039,10 @@ void ODTIm::insertChars(PageItem *item, QString &txt, const ParagraphStyle &tmpS
 	if (txt.isEmpty())
 		return;
 
-	item->itemText.insertChars(posC, txt);
-	item->itemText.applyStyle(posC, tmpStyle);
-	item->itemText.applyCharStyle(posC, txt.length(), tmpCStyle);
-	posC = item->itemText.length();
+	m_story->append(txt);
+	m_story->applyStyle(posC, tmpStyle);
+	m_story->applyCharStyle(posC, txt.length(), tmpCStyle);
+	posC = m_story->length();
 	txt.clear();
 }
 
@@ -1526,6 +1533,7 @@ QString ODTIm::constructFontName(const QString& fontBaseName, const QString& fon
 
 void ODTIm::setFontstyle(CharStyle &tmpCStyle, int kind)
 {
+	// The probe character is removed again, so text buffered by m_story is not disturbed
 	int posC = m_item->itemText.length();
 	m_item->itemText.insertChars(posC, "B");
 	m_item->itemText.applyCharStyle(posC, 1, tmpCStyle);
@@ -26,6 +26,7 @@ for which a new license (GPL+exception) is in place.
 #include <QString>
 
 class ScZipHandler;
+class StoryTextBuilder;
 
 extern "C" PLUGIN_API void GetText2(const QString& filename, const QString& encoding, bool textOnly, bool prefix, bool append, PageItem *textItem);
 extern "C" PLUGIN_API QString FileFormatName();
@@ -146,6 +147,7 @@ private:
 	std::unique_ptr<ScZipHandler> m_zip;
 	ScribusDoc* m_Doc {nullptr};
 	PageItem* m_item {nullptr};
+	StoryTextBuilder* m_story {nullptr};
 	bool m_prefixName {false};
 	bool m_append {false};
 	QHash<QString, QString> map_ID_to_Name;
@@ -39,8 +39,6 @@ void GetText2(const QString& filename, const QString& encoding, bool textOnly, b
 		f.close();
 		QBuffer buffer(&daten);
 		buffer.open(QIODevice::ReadOnly);
-		RtfReader::SlaDocumentRtfOutput *output = new RtfReader::SlaDocumentRtfOutput(textItem, textItem->doc(), prefix);
-		RtfReader::Reader reader;
 		if (!append)
 		{
 			QString pStyleD = CommonStrings::DefaultParagraphStyle;
@@ -50,9 +48,12 @@ void GetText2(const QString& filename, const QString& encoding, bool textOnly, b
 			textItem->itemText.clear();
 			textItem->itemText.setDefaultStyle(newStyle);
 		}
+		RtfReader::SlaDocumentRtfOutput *output = new RtfReader::SlaDocumentRtfOutput(textItem, textItem->doc(), prefix);
+		RtfReader::Reader reader;
 		reader.parseFromDeviceTo(&buffer, output);
+		// Deleting the output inserts the text it still buffers
+		delete output;
 		textItem->itemText.trim();
 		textItem->itemText.invalidateLayout();
-		delete output;
 	}
 }
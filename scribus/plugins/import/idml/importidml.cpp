@@ -29,6 +29,7 @@ for which a new license (GPL+exception) is in place.
 #include <cstdlib>
 #include <climits>
 #include <limits>
+#include <vector>
 
 #include "importidml.h"
 
@@ -40,6 +41,7 @@ for which a new license (GPL+exception) is in place.
 #include "sccolorengine.h"
 #include "scconfig.h"
 #include "scmimedata.h"
+#include "scparallelfor.h"
 #include "scribusXml.h"
 #include "scribuscore.h"
 #include "scribusdoc.h"
@@ -545,6 +547,8 @@ bool IdmlPlug::convert(const QString& fn)
 
 	QDomElement docElem = designMapDom.documentElement();
 	QString activeLayer = docElem.attribute("ActiveLayer");
+	if (ext == "idml")
+		listParts(docElem);
 	if (ext == "idms")
 	{
 		for (QDomNode drawPag = docElem.firstChild(); !drawPag.isNull(); drawPag = drawPag.nextSibling())
@@ -689,6 +693,8 @@ bool IdmlPlug::convert(const QString& fn)
 		m_Doc->setActiveLayer(activeLayer);
 	}
 
+	m_partSources.clear();
+	m_parsedParts.clear();
 	m_zip.reset();
 
 	if (progressDialog)
@@ -696,15 +702,90 @@ bool IdmlPlug::convert(const QString& fn)
 	return retVal;
 }
 
+void IdmlPlug::listParts(const QDomElement& docElem)
+{
+	m_partSources.clear();
+	m_parsedParts.clear();
+	m_nextPart = 0;
+	bool firstSpread = true;
+	for (QDomElement dpg = docElem.firstChildElement(); !dpg.isNull(); dpg = dpg.nextSiblingElement())
+	{
+		if (!dpg.hasAttribute("src"))
+			continue;
+		QString tagName = dpg.tagName();
+		// Only list the parts convert() will read
+		if (!(importerFlags & LoadSavePlugin::lfCreateDoc))
+		{
+			if (tagName == "idPkg:MasterSpread")
+				continue;
+			if (tagName == "idPkg:Spread")
+			{
+				if (!firstSpread)
+					continue;
+				firstSpread = false;
+			}
+		}
+		if ((tagName == "idPkg:Fonts") || (tagName == "idPkg:Graphic") || (tagName == "idPkg:Styles") || (tagName == "idPkg:Preferences")
+			|| (tagName == "idPkg:MasterSpread") || (tagName == "idPkg:Spread") || (tagName == "idPkg:Story"))
+			m_partSources.append(dpg.attribute("src"));
+	}
+}
+
+void IdmlPlug::parseParts(int first)
+{
+	// Parts are parsed a few per thread at a time, so that parsed parts are not kept long
+	int threadCount = ScParallelFor::maxHelpers() + 1;
+	int count = qMin(2 * threadCount, static_cast<int>(m_partSources.count()) - first);
+	if (count <= 0)
+		return;
+	m_nextPart = first + count;
+
+	// The archive is only read from this thread, helpers share the XML parsing
+	std::vector<QByteArray> data(count);
+	for (int i = 0; i < count; ++i)
+		m_zip->read(m_partSources.at(first + i), data[i]);
+
+	std::vector<QDomDocument> doms(count);
+	std::vector<char> parsed(count, 0);
+	ScParallelFor::run(count, [&](int index)
+	{
+		parsed[index] = doms[index].setContent(data[index]) ? 1 : 0;
+		data[index].clear();
+	});
+
+	for (int i = 0; i < count; ++i)
+	{
+		if (parsed[i])
+			m_parsedParts.insert(m_partSources.at(first + i), doms[i]);
+	}
+}
+
+bool IdmlPlug::readPart(const QString& src, QDomDocument& partDom)
+{
+	if (!m_parsedParts.contains(src))
+	{
+		int index = m_partSources.indexOf(src, m_nextPart);
+		if (index >= 0)
+			parseParts(index);
+	}
+	if (m_parsedParts.contains(src))
+	{
+		partDom = m_parsedParts.take(src);
+		return true;
+	}
+	// Parts not listed beforehand, or which failed to parse
+	QByteArray f2;
+	m_zip->read(src, f2);
+	return partDom.setContent(f2);
+}
+
 bool IdmlPlug::parseFontsXML(const QDomElement& grElem)
 {
 	QDomElement grNode;
 	QDomDocument grMapDom;
 	if (grElem.hasAttribute("src"))
 	{
-		QByteArray f2;
-		m_zip->read(grElem.attribute("src"), f2);
-		if (!grMapDom.setContent(f2))
+		if (!readPart(grElem.attribute("src"), grMapDom))
 			return false;
 		grNode = grMapDom.documentElement();
 	}
@@ -748,9 +829,7 @@ bool IdmlPlug::parseGraphicsXML(const QDomElement& grElem)
 	QDomDocument grMapDom;
 	if (grElem.hasAttribute("src"))
 	{
-		QByteArray f2;
-		m_zip->read(grElem.attribute("src"), f2);
-		if (!grMapDom.setContent(f2))
+		if (!readPart(grElem.attribute("src"), grMapDom))
 			return false;
 		grNode = grMapDom.documentElement();
 	}
@@ -885,9 +964,7 @@ bool IdmlPlug::parseStylesXML(const QDomElement& sElem)
 	QDomDocument sMapDom;
 	if (sElem.hasAttribute("src"))
 	{
-		QByteArray f2;
-		m_zip->read(sElem.attribute("src"), f2);
-		if (!sMapDom.setContent(f2))
+		if (!readPart(sElem.attribute("src"), sMapDom))
 			return false;
 		sNode = sMapDom.documentElement();
 	}
@@ -1305,9 +1382,7 @@ bool IdmlPlug::parsePreferencesXML(const QDomElement& prElem)
 	QDomDocument prMapDom;
 	if (prElem.hasAttribute("src"))
 	{
-		QByteArray f2;
-		m_zip->read(prElem.attribute("src"), f2);
-		if (!prMapDom.setContent(f2))
+		if (!readPart(prElem.attribute("src"), prMapDom))
 			return false;
 		prNode = prMapDom.documentElement();
 	}
@@ -1515,9 +1590,7 @@ bool IdmlPlug::parseSpreadXML(const QDomElement& spElem)
 	QDomDocument spMapDom;
 	if (spElem.hasAttribute("src"))
 	{
-		QByteArray f2;
-		m_zip->read(spElem.attribute("src"), f2);
-		if (!spMapDom.setContent(f2))
+		if (!readPart(spElem.attribute("src"), spMapDom))
 			return false;
 		spNode = spMapDom.documentElement();
 	}
@@ -2721,9 +2794,7 @@ bool IdmlPlug::parseStoryXML(const QDomElement& stElem)
 	QDomDocument stMapDom;
 	if (stElem.hasAttribute("src"))
 	{
-		QByteArray f2;
-		m_zip->read(stElem.attribute("src"), f2);
-		if (!stMapDom.setContent(f2))
+		if (!readPart(stElem.attribute("src"), stMapDom))
 			return false;
 		stNode = stMapDom.documentElement();
 	}
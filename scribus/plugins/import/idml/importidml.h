@@ -17,10 +17,12 @@ for which a new license (GPL+exception) is in place.
 
 #include <QDomDocument>
 #include <QDomElement>
+#include <QHash>
 #include <QList>
 #include <QMultiMap>
 #include <QObject>
 #include <QString>
+#include <QStringList>
 #include <QtGlobal>
 #include <QTransform>
 
@@ -100,6 +102,12 @@ private:
 	};
 	QString getNodeValue(const QDomNode &baseNode, const QString& path) const;
 	bool convert(const QString& fn);
+	/// Lists the package parts convert() will read, in designmap order
+	void listParts(const QDomElement& docElem);
+	/// Reads the listed parts from first on and parses a batch of them on all cores
+	void parseParts(int first);
+	/// Returns the parsed document of a package part, parsing it and the next parts if needed
+	bool readPart(const QString& src, QDomDocument& partDom);
 	bool parseFontsXML(const QDomElement& grElem);
 	void parseFontsXMLNode(const QDomElement& grNode);
 	bool parseGraphicsXML(const QDomElement& grElem);
@@ -192,6 +200,9 @@ private:
 	QMap<QString, ObjectStyle> ObjectStyles;
 
 	std::unique_ptr<ScZipHandler> m_zip;
+	QStringList m_partSources;
+	int m_nextPart { 0 };
+	QHash<QString, QDomDocument> m_parsedParts;
 
 public slots:
 	void cancelRequested() { cancel = true; }
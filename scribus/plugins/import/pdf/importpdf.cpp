@@ -17,6 +17,7 @@ for which a new license (GPL+exception) is in place.
 #include <QList>
 #include <QMimeData>
 #include <QStack>
+#include <QThread>
 
 #include <poppler/ErrorCodes.h>
 #include <poppler/GlobalParams.h>
@@ -30,6 +31,7 @@ for which a new license (GPL+exception) is in place.
 
 #include "importpdf.h"
 #include "importpdfconfig.h"
+#include "pdfpageprefetcher.h"
 #include "pdftextrecognition.h"
 #include "slaoutput.h"
 
@@ -40,6 +42,7 @@ for which a new license (GPL+exception) is in place.
 #include "prefsmanager.h"
 #include "scconfig.h"
 #include "scmimedata.h"
+#include "scparallelfor.h"
 #include "scribus.h"
 #include "scribusXml.h"
 #include "scribuscore.h"
@@ -308,6 +311,7 @@ bool PdfPlug::convert(const QString& fn)
 	globalParams->setErrQuiet(true);
 
 	QList<OptionalContentGroup*> ocgGroups;
+	QByteArray userPassword;
 	QByteArray encodedFileName = os_is_win() ? fn.toUtf8() : QFile::encodeName(fn);
 	auto fname = std::make_unique<GooString>(encodedFileName.data());
 	auto pdfDoc = std::make_unique<PDFDoc>(std::move(fname));
@@ -325,7 +329,8 @@ bool PdfPlug::convert(const QString& fn)
 			if (ok && !text.isEmpty())
 			{
 				auto fname = std::make_unique<GooString>(encodedFileName.data());
-				std::optional<GooString> userPW(std::in_place, text.toLocal8Bit().data());
+				userPassword = text.toLocal8Bit();
+				std::optional<GooString> userPW(std::in_place, userPassword.data());
 				pdfDoc.reset(new PDFDoc(std::move(fname), userPW, userPW, nullptr));
 				QApplication::changeOverrideCursor(QCursor(Qt::WaitCursor));
 			}
@@ -568,6 +573,21 @@ bool PdfPlug::convert(const QString& fn)
 					}
 					m_Doc->setPageSize("Custom");
 				//	m_Doc->pdfOptions().PresentVals.clear();
+
+					// Glyph outlines and images of the next pages are converted by other threads
+					// while the items of the current page are created
+					QAtomicInt nextPrefetchPage(1);
+					QAtomicInt importedPage(0);
+					std::vector<std::unique_ptr<PdfPagePrefetcher>> prefetchers;
+					// Each prefetcher opens its own PDFDoc, they are started as threads of their own
+					// within the helper thread cap of ScParallelFor
+					int prefetcherCount = ScParallelFor::reserveHelpers(static_cast<int>(pageNs.size()) - 1);
+					for (int i = 0; i < prefetcherCount; ++i)
+					{
+						prefetchers.emplace_back(new PdfPagePrefetcher(encodedFileName, userPassword, pageNs, nextPrefetchPage, importedPage, dev->cache()));
+						prefetchers.back()->start(QThread::LowPriority);
+					}
+
 					for (size_t i = 0; i < pageNs.size(); ++i)
 					{
 						if (m_progressDialog)
@@ -575,6 +595,7 @@ bool PdfPlug::convert(const QString& fn)
 							m_progressDialog->setProgress("GI", i);
 							QApplication::processEvents();
 						}
+						importedPage.storeRelease(static_cast<int>(i));
 						int pp = pageNs[i];
 						m_Doc->setActiveLayer(baseLayer);
 						if (firstPg)
@@ -693,6 +714,12 @@ bool PdfPlug::convert(const QString& fn)
 						}
 						m_Doc->currentPage()->PresentVals = ef;
 					}
+					for (auto& prefetcher : prefetchers)
+						prefetcher->requestInterruption();
+					for (auto& prefetcher : prefetchers)
+						prefetcher->wait();
+					prefetchers.clear();
+					ScParallelFor::releaseHelpers(prefetcherCount);
 					int numjs = pdfDoc->getCatalog()->numJS();
 					if (numjs > 0)
 					{
@@ -0,0 +1,76 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include "pdfpageprefetcher.h"
+
+#include <optional>
+
+void PdfPrefetchOutputDev::drawChar(GfxState *state, double x, double y, double dx, double dy, double originX, double originY, CharCode code, int nBytes, const Unicode *u, int uLen)
+{
+	if (state->getRender() >= 8)
+		return;
+	SlaGlyphOutline glyph;
+	m_glyphLoader.glyphOutline(state, code, *m_cache, glyph);
+}
+
+void PdfPrefetchOutputDev::drawImage(GfxState *state, Object *ref, Stream *str, int width, int height, GfxImageColorMap *colorMap, bool interpolate, const int *maskColors, bool inlineImg)
+{
+	SlaImageKey key;
+	if (!SlaOutputDev::imageKey(ref, inlineImg, width, height, colorMap, maskColors, key))
+		return;
+	if (m_cache->containsImage(key))
+		return;
+	QImage image;
+	if (SlaOutputDev::decodeImage(str, width, height, colorMap, maskColors, image))
+		m_cache->insertImage(key, image);
+}
+
+PdfPagePrefetcher::PdfPagePrefetcher(const QByteArray& fileName, const QByteArray& password, const std::vector<int>& pageNumbers,
+									 QAtomicInt& nextPage, const QAtomicInt& importedPage, std::shared_ptr<SlaOutputCache> cache) :
+	m_fileName(fileName),
+	m_password(password),
+	m_pageNumbers(pageNumbers),
+	m_nextPage(nextPage),
+	m_importedPage(importedPage),
+	m_cache(std::move(cache))
+{
+}
+
+void PdfPagePrefetcher::run()
+{
+	// PDFDoc and XRef are not thread safe, each prefetcher opens the file again
+	std::unique_ptr<PDFDoc> pdfDoc;
+	auto fname = std::make_unique<GooString>(m_fileName.data());
+	if (m_password.isEmpty())
+		pdfDoc = std::make_unique<PDFDoc>(std::move(fname));
+	else
+	{
+		std::optional<GooString> userPW(std::in_place, m_password.data());
+		pdfDoc.reset(new PDFDoc(std::move(fname), userPW, userPW, nullptr));
+	}
+	if (!pdfDoc->isOk())
+		return;
+
+	PdfPrefetchOutputDev dev(m_cache);
+	dev.startDoc(pdfDoc.get());
+
+	const int pageCount = static_cast<int>(m_pageNumbers.size());
+	while (!isInterruptionRequested())
+	{
+		int index = m_nextPage.fetchAndAddOrdered(1);
+		if (index >= pageCount)
+			break;
+		// The importer has already reached this page
+		if (index <= m_importedPage.loadAcquire())
+			continue;
+		while ((index > m_importedPage.loadAcquire() + maxLookAhead) && !isInterruptionRequested())
+			msleep(10);
+		if (isInterruptionRequested())
+			break;
+		pdfDoc->displayPage(&dev, m_pageNumbers[index], 72.0, 72.0, 0, true, false, false);
+	}
+}
@@ -0,0 +1,98 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#ifndef PDFPAGEPREFETCHER_H
+#define PDFPAGEPREFETCHER_H
+
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QThread>
+
+#include <memory>
+#include <vector>
+
+#include "importpdfconfig.h"
+#include "slaoutput.h"
+
+#include <poppler/GfxState.h>
+#include <poppler/OutputDev.h>
+#include <poppler/PDFDoc.h>
+
+/*
+* Output device which converts glyph outlines and decodes image XObjects of
+* a page into a SlaOutputCache, without creating any item.
+*/
+class PdfPrefetchOutputDev : public OutputDev
+{
+public:
+	explicit PdfPrefetchOutputDev(std::shared_ptr<SlaOutputCache> cache) : m_cache(std::move(cache)) {}
+
+	void startDoc(PDFDoc *doc) { m_glyphLoader.startDoc(doc, doc->getXRef()); }
+
+	bool upsideDown() override { return true; }
+	bool useDrawChar() override { return true; }
+	bool interpretType3Chars() override { return true; }
+	bool useTilingPatternFill() override { return true; }
+	bool useShadedFills(int type) override { return true; }
+	bool useDrawForm() override { return false; }
+
+	// Patterns and shadings are left to the importer
+#if POPPLER_ENCODED_VERSION >= POPPLER_VERSION_ENCODE(25, 9, 0)
+	bool tilingPatternFill(GfxState *state, Gfx *gfx, Catalog *cat, GfxTilingPattern *tPat, const std::array<double, 6>& mat, int x0, int y0, int x1, int y1, double xStep, double yStep) override { return true; }
+#else
+	bool tilingPatternFill(GfxState *state, Gfx *gfx, Catalog *cat, GfxTilingPattern *tPat, const double *mat, int x0, int y0, int x1, int y1, double xStep, double yStep) override { return true; }
+#endif
+	bool functionShadedFill(GfxState * /*state*/, GfxFunctionShading * /*shading*/) override { return true; }
+	bool axialShadedFill(GfxState * /*state*/, GfxAxialShading * /*shading*/, double /*tMin*/, double /*tMax*/) override { return true; }
+	bool radialShadedFill(GfxState * /*state*/, GfxRadialShading * /*shading*/, double /*sMin*/, double /*sMax*/) override { return true; }
+	bool gouraudTriangleShadedFill(GfxState * /*state*/, GfxGouraudTriangleShading * /*shading*/) override { return true; }
+	bool patchMeshShadedFill(GfxState * /*state*/, GfxPatchMeshShading * /*shading*/) override { return true; }
+
+	void drawChar(GfxState *state, double /*x*/, double /*y*/, double /*dx*/, double /*dy*/, double /*originX*/, double /*originY*/, CharCode code, int /*nBytes*/, const Unicode * /*u*/, int /*uLen*/) override;
+	void drawImage(GfxState *state, Object *ref, Stream *str, int width, int height, GfxImageColorMap *colorMap, bool interpolate, const int *maskColors, bool inlineImg) override;
+	// The importer decodes masked images together with their mask, without the cache.
+	// The default implementations would decode the image without its mask.
+	void drawMaskedImage(GfxState * /*state*/, Object * /*ref*/, Stream * /*str*/, int /*width*/, int /*height*/, GfxImageColorMap * /*colorMap*/, bool /*interpolate*/,
+						 Stream * /*maskStr*/, int /*maskWidth*/, int /*maskHeight*/, bool /*maskInvert*/, bool /*maskInterpolate*/) override {}
+	void drawSoftMaskedImage(GfxState * /*state*/, Object * /*ref*/, Stream * /*str*/, int /*width*/, int /*height*/, GfxImageColorMap * /*colorMap*/, bool /*interpolate*/,
+							 Stream * /*maskStr*/, int /*maskWidth*/, int /*maskHeight*/, GfxImageColorMap * /*maskColorMap*/, bool /*maskInterpolate*/) override {}
+
+private:
+	std::shared_ptr<SlaOutputCache> m_cache;
+	SlaGlyphLoader m_glyphLoader;
+};
+
+/*
+* Converts the pages of a multi-page import in advance, on its own PDFDoc and
+* output device, while the importer creates the items of the previous pages.
+* Several prefetchers share the page counter and take pages ahead of the
+* importer; the importer then finds most glyph outlines and images in the cache.
+*/
+class PdfPagePrefetcher : public QThread
+{
+public:
+	PdfPagePrefetcher(const QByteArray& fileName, const QByteArray& password, const std::vector<int>& pageNumbers,
+					  QAtomicInt& nextPage, const QAtomicInt& importedPage, std::shared_ptr<SlaOutputCache> cache);
+
+protected:
+	void run() override;
+
+private:
+	// Maximum number of pages converted ahead of the importer, so that the
+	// cached data of a page is not dropped before the importer needs it
+	static constexpr int maxLookAhead { 8 };
+
+	QByteArray m_fileName;
+	QByteArray m_password;
+	std::vector<int> m_pageNumbers;
+	// Index in m_pageNumbers of the next page to prefetch
+	QAtomicInt& m_nextPage;
+	// Index in m_pageNumbers of the page being imported
+	const QAtomicInt& m_importedPage;
+	std::shared_ptr<SlaOutputCache> m_cache;
+};
+
+#endif
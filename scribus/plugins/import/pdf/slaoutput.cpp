@@ -18,14 +18,16 @@ for which a new license (GPL+exception) is in place.
 #include <poppler/OptionalContent.h>
 
 #include <QApplication>
+#include <QDataStream>
 #include <QFile>
+#include <QMutexLocker>
 
 #include "commonstrings.h"
 #include "loadsaveplugin.h"
 #include "sccolorengine.h"
+#include "scimagememorystore.h"
 #include "util.h"
 #include "util_math.h"
-#include <tiffio.h>
 
 //#ifndef DEBUG_TEXT_IMPORT
 //	#define DEBUG_TEXT_IMPORT
@@ -136,6 +138,44 @@ LinkImportData::LinkImportData(Object *actionObj)
 #endif
 }
 
+bool SlaOutputCache::glyph(const SlaGlyphKey& key, SlaGlyphOutline& glyph)
+{
+	QMutexLocker locker(&m_mutex);
+	const SlaGlyphOutline* cached = m_glyphs.object(key);
+	if (!cached)
+		return false;
+	glyph = *cached;
+	return true;
+}
+
+void SlaOutputCache::insertGlyph(const SlaGlyphKey& key, const SlaGlyphOutline& glyph)
+{
+	QMutexLocker locker(&m_mutex);
+	m_glyphs.insert(key, new SlaGlyphOutline(glyph), qMax(1, static_cast<int>(glyph.points.size())));
+}
+
+bool SlaOutputCache::containsImage(const SlaImageKey& key)
+{
+	QMutexLocker locker(&m_mutex);
+	return m_images.contains(key);
+}
+
+bool SlaOutputCache::image(const SlaImageKey& key, QImage& image)
+{
+	QMutexLocker locker(&m_mutex);
+	const QImage* cached = m_images.object(key);
+	if (!cached)
+		return false;
+	image = *cached;
+	return true;
+}
+
+void SlaOutputCache::insertImage(const SlaImageKey& key, const QImage& image)
+{
+	QMutexLocker locker(&m_mutex);
+	m_images.insert(key, new QImage(image), qMax(1, static_cast<int>(image.sizeInBytes() / 1024)));
+}
+
 AnoOutputDev::AnoOutputDev(ScribusDoc* doc, QStringList *importedColors)
 {
 	m_doc = doc;
@@ -309,7 +349,6 @@ SlaOutputDev::~SlaOutputDev()
 	m_groupStack.clear();
 	m_tmpSel->clear();
 	delete m_tmpSel;
-	delete m_fontEngine;
 }
 
 /* get Actions not implemented by Poppler */
@@ -1272,7 +1311,7 @@ void SlaOutputDev::startDoc(PDFDoc *doc, XRef *xrefA, Catalog *catA)
 	m_catalog = catA;
 	m_pdfDoc = doc;
 	m_updateGUICounter = 0;
-	m_fontEngine = new SplashFontEngine(true, false, false, true);
+	m_glyphLoader.startDoc(doc, xrefA);
 }
 
 void SlaOutputDev::startPage(int pageNum, GfxState *, XRef *)
@@ -2667,23 +2706,66 @@ void SlaOutputDev::drawMaskedImage(GfxState *state, Object *ref, Stream *str,  i
 }
 
 void SlaOutputDev::drawImage(GfxState *state, Object *ref, Stream *str, int width, int height, GfxImageColorMap *colorMap, bool interpolate, const int* maskColors, bool inlineImg)
+{
+	// Image XObjects may be used on several pages or may have been decoded
+	// in advance by a PdfPagePrefetcher
+	SlaImageKey key;
+	bool isXObject = imageKey(ref, inlineImg, width, height, colorMap, maskColors, key);
+
+	QImage image;
+	if (!isXObject || !m_cache->image(key, image))
+	{
+		if (!decodeImage(str, width, height, colorMap, maskColors, image))
+			return;
+		if (isXObject)
+			m_cache->insertImage(key, image);
+	}
+
+	createImageFrame(image, state, colorMap->getNumPixelComps());
+}
+
+bool SlaOutputDev::imageKey(Object *ref, bool inlineImg, int width, int height, GfxImageColorMap *colorMap, const int *maskColors, SlaImageKey& key)
+{
+	// Inline images have no reference and cannot be found again
+	if (inlineImg || !ref || !ref->isRef())
+		return false;
+	key.num = ref->getRef().num;
+	key.gen = ref->getRef().gen;
+	key.width = width;
+	key.height = height;
+	key.colorSpaceMode = static_cast<int>(colorMap->getColorSpace()->getMode());
+	key.bits = colorMap->getBits();
+	key.decode.clear();
+	QDataStream decodeStream(&key.decode, QIODevice::WriteOnly);
+	const int components = colorMap->getNumPixelComps();
+	for (int i = 0; i < components; ++i)
+		decodeStream << colorMap->getDecodeLow(i) << colorMap->getDecodeHigh(i);
+	if (maskColors)
+	{
+		for (int i = 0; i < 2 * components; ++i)
+			decodeStream << maskColors[i];
+	}
+	return true;
+}
+
+bool SlaOutputDev::decodeImage(Stream *str, int width, int height, GfxImageColorMap *colorMap, const int* maskColors, QImage& image)
 {
 	auto imgStr = std::make_unique<ImageStream>(str, width, colorMap->getNumPixelComps(), colorMap->getBits());
 #if POPPLER_ENCODED_VERSION >= POPPLER_VERSION_ENCODE(26, 1, 0)
 	bool rewindDone = imgStr->rewind();
 	if (!rewindDone)
-		return;
+		return false;
 #elif POPPLER_ENCODED_VERSION >= POPPLER_VERSION_ENCODE(25, 02, 0)
 	bool resetDone = imgStr->reset();
 	if (!resetDone)
-		return;
+		return false;
 #else
 	imgStr->reset();
 #endif
 
-	QImage image(width, height, QImage::Format_ARGB32);
+	image = QImage(width, height, QImage::Format_ARGB32);
 	if (image.isNull())
-		return;
+		return false;
 
 	if (maskColors)
 	{
@@ -2744,8 +2826,7 @@ void SlaOutputDev::drawImage(GfxState *state, Object *ref, Stream *str, int widt
 			}
 		}
 	}
-
-	createImageFrame(image, state, colorMap->getNumPixelComps());
+	return true;
 }
 
 void SlaOutputDev::createImageFrame(QImage& image, GfxState *state, int numColorComponents)
@@ -2809,74 +2890,19 @@ void SlaOutputDev::createImageFrame(QImage& image, GfxState *state, int numColor
 		ite->setRotation(-angle);
 	m_doc->adjustItemSize(ite);
 
-	if (numColorComponents == 4)
-	{
-		QTemporaryFile tempFile(QDir::tempPath() + "/scribus_temp_pdf_XXXXXX.tif");
-		if (tempFile.open())
-		{
-			QString fileName = getLongPathName(tempFile.fileName());
-			if (!fileName.isEmpty())
-			{
-				tempFile.setAutoRemove(false);
-				tempFile.close();
-				ite->isInlineImage = true;
-				ite->isTempFile = true;
-				ite->AspectRatio = false;
-				ite->ScaleType   = false;
-				TIFF* tif = TIFFOpen(fileName.toLocal8Bit().data(), "w");
-				if (tif)
-				{
-					TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, image.width());
-					TIFFSetField(tif, TIFFTAG_IMAGELENGTH, image.height());
-					TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, 8);
-					TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, 4);
-					TIFFSetField(tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
-					TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_SEPARATED);
-					TIFFSetField(tif, TIFFTAG_COMPRESSION, COMPRESSION_LZW);
-					for (int y = 0; y < image.height(); ++y)
-					{
-						TIFFWriteScanline(tif, image.scanLine(y), y);
-					}
-					TIFFClose(tif);
-					m_doc->loadPict(fileName, ite);
-				}
-				m_Elements->append(ite);
-				if (!m_groupStack.isEmpty())
-				{
-					m_groupStack.top().Items.append(ite);
-					applyMask(ite);
-				}
-			}
-			else
-				m_doc->Items->removeAll(ite);
-		}
-	}
-	else
+	// Hand the decoded pixels over in memory, the temporary file is only
+	// written if the document gets saved with the image embedded
+	QString fileName = ScImageMemoryStore::instance().add(image, numColorComponents == 4, "scribus_temp_pdf_");
+	ite->isInlineImage = true;
+	ite->isTempFile = true;
+	ite->AspectRatio = false;
+	ite->ScaleType   = false;
+	m_doc->loadPict(fileName, ite);
+	m_Elements->append(ite);
+	if (!m_groupStack.isEmpty())
 	{
-		QTemporaryFile tempFile(QDir::tempPath() + "/scribus_temp_pdf_XXXXXX.png");
-		if (tempFile.open())
-		{
-			QString fileName = getLongPathName(tempFile.fileName());
-			if (!fileName.isEmpty())
-			{
-				tempFile.setAutoRemove(false);
-				tempFile.close();
-				ite->isInlineImage = true;
-				ite->isTempFile = true;
-				ite->AspectRatio = false;
-				ite->ScaleType   = false;
-				image.save(fileName, "PNG");
-				m_doc->loadPict(fileName, ite);
-				m_Elements->append(ite);
-				if (!m_groupStack.isEmpty())
-				{
-					m_groupStack.top().Items.append(ite);
-					applyMask(ite);
-				}
-			}
-			else
-				m_doc->Items->removeAll(ite);
-		}
+		m_groupStack.top().Items.append(ite);
+		applyMask(ite);
 	}
 	if (m_inPattern == 0)
 	{
@@ -3057,7 +3083,21 @@ void SlaOutputDev::markPoint(const char *name, Dict *properties)
 }
 #endif
 
-void SlaOutputDev::updateFont(GfxState *state)
+SlaGlyphLoader::~SlaGlyphLoader()
+{
+	delete m_fontEngine;
+}
+
+void SlaGlyphLoader::startDoc(PDFDoc *doc, XRef *xrefA)
+{
+	m_xref = xrefA;
+	m_pdfDoc = doc;
+	m_font = nullptr;
+	delete m_fontEngine;
+	m_fontEngine = new SplashFontEngine(true, false, false, true);
+}
+
+void SlaGlyphLoader::updateFont(GfxState *state)
 {
 	std::optional<GfxFontLoc> fontLoc;
 	std::string fileName;
@@ -3517,11 +3557,6 @@ err1:
 void SlaOutputDev::drawChar(GfxState* state, double x, double y, double dx, double dy, double originX, double originY, CharCode code, int nBytes, const Unicode* u, int uLen)
 {
 //	qDebug() << "SlaOutputDev::drawChar code:" << code << "bytes:" << nBytes << "Unicode:" << u << "ulen:" << uLen << "render:" << state->getRender();
-	double x1, y1, x2, y2;
-	updateFont(state);
-	if (!m_font)
-		return;
-
 	// PDF 1.7 Section 9.3.6 defines eight text rendering modes.
 	// 0 - Fill
 	// 1 - Stroke
@@ -3539,39 +3574,17 @@ void SlaOutputDev::drawChar(GfxState* state, double x, double y, double dx, doub
 	if (textRenderingMode >= 8)
 		return;
 
-	SplashPath * fontPath = m_font->getGlyphPath(code);
-	if (!fontPath)
+	SlaGlyphOutline glyph;
+	if (!m_glyphLoader.glyphOutline(state, code, *m_cache, glyph))
 		return;
+	const QPainterPath& qPath = glyph.path;
 
-	QPainterPath qPath;
-	qPath.setFillRule(Qt::WindingFill);
-	for (int i = 0; i < fontPath->getLength(); ++i)
-	{
-		unsigned char f;
-		fontPath->getPoint(i, &x1, &y1, &f);
-		if (f & splashPathFirst)
-			qPath.moveTo(x1,y1);
-		else if (f & splashPathCurve)
-		{
-			double x3, y3;
-			++i;
-			fontPath->getPoint(i, &x2, &y2, &f);
-			++i;
-			fontPath->getPoint(i, &x3, &y3, &f);
-			qPath.cubicTo(x1, y1, x2, y2, x3, y3);
-		}
-		else
-			qPath.lineTo(x1, y1);
-		if (f & splashPathLast)
-			qPath.closeSubpath();
-	}
 	const auto ctm = state->getCTM();
 	m_ctm = QTransform(ctm[0], ctm[1], ctm[2], ctm[3], ctm[4], ctm[5]);
 	double xCoor = m_doc->currentPage()->xOffset();
 	double yCoor = m_doc->currentPage()->yOffset();
-	FPointArray textPath;
-	textPath.fromQPainterPath(qPath);
-	FPoint wh = textPath.widthHeight();
+	FPointArray textPath(glyph.points);
+	FPoint wh = glyph.size;
 	if (textRenderingMode > 3)
 	{
 		QTransform mm;
@@ -3602,7 +3615,65 @@ void SlaOutputDev::drawChar(GfxState* state, double x, double y, double dx, doub
 			applyMask(ite);
 		}
 	}
-	delete fontPath;
+}
+
+bool SlaGlyphLoader::glyphOutline(GfxState *state, CharCode code, SlaOutputCache& cache, SlaGlyphOutline& glyph)
+{
+	GfxFont* gfxFont = state->getFont().get();
+	if (!gfxFont)
+		return false;
+
+	// Same font matrix as computed by updateFont()
+	const auto textMat = state->getTextMat();
+	double fontSize = state->getFontSize();
+	SlaGlyphKey key;
+	key.fontNum = gfxFont->getID()->num;
+	key.fontGen = gfxFont->getID()->gen;
+	key.code = code;
+	key.m11 = textMat[0] * fontSize * state->getHorizScaling();
+	key.m12 = textMat[1] * fontSize * state->getHorizScaling();
+	key.m21 = textMat[2] * fontSize;
+	key.m22 = textMat[3] * fontSize;
+
+	if (cache.glyph(key, glyph))
+		return !glyph.points.isEmpty();
+
+	glyph = SlaGlyphOutline();
+	updateFont(state);
+	SplashPath * fontPath = m_font ? m_font->getGlyphPath(code) : nullptr;
+	if (fontPath)
+	{
+		double x1, y1, x2, y2;
+		QPainterPath& qPath = glyph.path;
+		qPath.setFillRule(Qt::WindingFill);
+		for (int i = 0; i < fontPath->getLength(); ++i)
+		{
+			unsigned char f;
+			fontPath->getPoint(i, &x1, &y1, &f);
+			if (f & splashPathFirst)
+				qPath.moveTo(x1,y1);
+			else if (f & splashPathCurve)
+			{
+				double x3, y3;
+				++i;
+				fontPath->getPoint(i, &x2, &y2, &f);
+				++i;
+				fontPath->getPoint(i, &x3, &y3, &f);
+				qPath.cubicTo(x1, y1, x2, y2, x3, y3);
+			}
+			else
+				qPath.lineTo(x1, y1);
+			if (f & splashPathLast)
+				qPath.closeSubpath();
+		}
+		delete fontPath;
+		glyph.points.fromQPainterPath(qPath);
+		glyph.size = glyph.points.widthHeight();
+	}
+
+	// Glyphs without outline are cached too, so that they are not looked up again
+	cache.insertGlyph(key, glyph);
+	return !glyph.points.isEmpty();
 }
 
 
@@ -8,12 +8,14 @@ for which a new license (GPL+exception) is in place.
 #define SLAOUTPUT_H
 
 #include <QBuffer>
+#include <QCache>
 #include <QColor>
 #include <QBrush>
 #include <QDebug>
 #include <QImage>
 #include <QPen>
 #include <QList>
+#include <QMutex>
 #include <QSizeF>
 #include <QStack>
 #include <QString>
@@ -125,6 +127,116 @@ private:
 	Ref r;
 };
 
+//------------------------------------------------------------------------
+// SlaOutputCache
+//------------------------------------------------------------------------
+
+// Outline of a glyph in text space, as returned by SplashFont::getGlyphPath()
+struct SlaGlyphOutline
+{
+	QPainterPath path;
+	FPointArray points;
+	FPoint size;
+};
+
+// A glyph is identified by its font object and its code, the outline also
+// depends on the scaling of the font
+struct SlaGlyphKey
+{
+	int fontNum { 0 };
+	int fontGen { 0 };
+	CharCode code { 0 };
+	double m11 { 1.0 };
+	double m12 { 0.0 };
+	double m21 { 0.0 };
+	double m22 { 1.0 };
+
+	bool operator==(const SlaGlyphKey& other) const
+	{
+		return fontNum == other.fontNum && fontGen == other.fontGen && code == other.code &&
+			   m11 == other.m11 && m12 == other.m12 && m21 == other.m21 && m22 == other.m22;
+	}
+	friend size_t qHash(const SlaGlyphKey& key, size_t seed = 0)
+	{
+		return qHashMulti(seed, key.fontNum, key.fontGen, key.code, key.m11, key.m12, key.m21, key.m22);
+	}
+};
+
+// An image XObject, its decoded pixels do not depend on the graphics state
+// but on the colour map and the colour key mask it is drawn with
+struct SlaImageKey
+{
+	int num { 0 };
+	int gen { 0 };
+	int width { 0 };
+	int height { 0 };
+	int colorSpaceMode { 0 };
+	int bits { 0 };
+	// Decode ranges of the components, followed by the colour key mask if any
+	QByteArray decode;
+
+	bool operator==(const SlaImageKey& other) const
+	{
+		return num == other.num && gen == other.gen && width == other.width && height == other.height &&
+			   colorSpaceMode == other.colorSpaceMode && bits == other.bits && decode == other.decode;
+	}
+	friend size_t qHash(const SlaImageKey& key, size_t seed = 0)
+	{
+		return qHashMulti(seed, key.num, key.gen, key.width, key.height, key.colorSpaceMode, key.bits, key.decode);
+	}
+};
+
+// Glyph outlines and decoded images of one import, shared by all pages. Pages
+// may be converted in advance by other threads (see PdfPagePrefetcher), all
+// accesses are therefore serialized.
+class SlaOutputCache
+{
+public:
+	bool glyph(const SlaGlyphKey& key, SlaGlyphOutline& glyph);
+	void insertGlyph(const SlaGlyphKey& key, const SlaGlyphOutline& glyph);
+
+	bool containsImage(const SlaImageKey& key);
+	bool image(const SlaImageKey& key, QImage& image);
+	void insertImage(const SlaImageKey& key, const QImage& image);
+
+private:
+	QMutex m_mutex;
+	// The cost is the point count
+	QCache<SlaGlyphKey, SlaGlyphOutline> m_glyphs { 500000 };
+	// The cost is the size in kilobytes
+	QCache<SlaImageKey, QImage> m_images { 256 * 1024 };
+};
+
+//------------------------------------------------------------------------
+// SlaGlyphLoader
+//------------------------------------------------------------------------
+
+// Loads the fonts of a document with Splash and converts glyph outlines.
+// Each output device needs its own loader, fonts are only loaded when a
+// glyph is not found in the cache.
+class SlaGlyphLoader
+{
+public:
+	SlaGlyphLoader() = default;
+	SlaGlyphLoader(const SlaGlyphLoader&) = delete;
+	SlaGlyphLoader& operator=(const SlaGlyphLoader&) = delete;
+	~SlaGlyphLoader();
+
+	void startDoc(PDFDoc *doc, XRef *xrefA);
+
+	// Looks up or converts the outline of the glyph drawn with code in the
+	// current font of state. Returns false if the glyph has no outline.
+	bool glyphOutline(GfxState *state, CharCode code, SlaOutputCache& cache, SlaGlyphOutline& glyph);
+
+private:
+	void updateFont(GfxState *state);
+
+	XRef *m_xref {nullptr};		// xref table for current document
+	PDFDoc *m_pdfDoc {nullptr};
+	SplashFontEngine *m_fontEngine {nullptr};
+	SplashFont *m_font {nullptr};
+};
+
 
 class AnoOutputDev : public OutputDev
 {
@@ -184,6 +296,10 @@ public:
 	void applyTextStyle(PageItem* ite, const QString& fontName, const QString& textColor, double fontSize);
 	void handleActions(PageItem* ite, AnnotWidget *ano);
 	void startDoc(PDFDoc *doc, XRef *xrefA, Catalog *catA);
+	std::shared_ptr<SlaOutputCache> cache() const { return m_cache; }
+	// Fills the cache key of an image XObject, returns false for inline images
+	static bool imageKey(Object *ref, bool inlineImg, int width, int height, GfxImageColorMap *colorMap, const int *maskColors, SlaImageKey& key);
+	static bool decodeImage(Stream *str, int width, int height, GfxImageColorMap *colorMap, const int *maskColors, QImage& image);
 
 	bool isOk() const { return true; }
 	bool upsideDown() override { return true; }
@@ -300,7 +416,6 @@ public:
 
 	void updateFillColor(GfxState *state) override;
 	void updateStrokeColor(GfxState *state) override;
-	void updateFont(GfxState* state) override;
 
 	//----- text drawing
 	void  beginTextObject(GfxState *state) override;
@@ -426,6 +541,9 @@ private:
 
 	// Collect the paths of character glyphs for clipping of a whole text group.
 	QPainterPath  m_clipTextPath;
+	// Converted glyph outlines and decoded images, shared by all pages of the import
+	std::shared_ptr<SlaOutputCache> m_cache { std::make_shared<SlaOutputCache>() };
+	SlaGlyphLoader m_glyphLoader;
 
 	QString m_currentMask;
 	QPointF m_currentMaskPosition;
@@ -452,8 +570,6 @@ private:
 	XRef *m_xref {nullptr};		// xref table for current document
 	PDFDoc *m_pdfDoc {nullptr};
 	Catalog *m_catalog {nullptr};
-	SplashFontEngine *m_fontEngine {nullptr};
-	SplashFont *m_font {nullptr};
 	std::unique_ptr<FormPageWidgets> m_formWidgets;
 	QHash<QString, QList<int> > m_radioMap;
 	QHash<int, PageItem*> m_radioButtons;
@@ -16,6 +16,7 @@ for which a new license (GPL+exception) is in place.
 #include <QStack>
 #include <QTemporaryFile>
 #include <QUrl>
+#include <QXmlStreamReader>
 
 #include "svgplugin.h"
 
@@ -41,6 +42,7 @@ for which a new license (GPL+exception) is in place.
 #include "scribusview.h"
 #include "selection.h"
 #include "ui/customfdialog.h"
+#include "ui/multiprogressdialog.h"
 #include "ui/propertiespalette.h"
 #include "ui/scmessagebox.h"
 #include "undomanager.h"
@@ -230,6 +232,7 @@ SVGPlug::SVGPlug(ScribusDoc* doc, int flags)
 
 SVGPlug::~SVGPlug()
 {
+	delete progressDialog;
 	delete tmpSel;
 }
 
@@ -281,8 +284,7 @@ QImage SVGPlug::readThumbnail(const QString& fName)
 		}
 	}
 
-	m_nodeMap = buildNodeMap(docElem);
-	QList<PageItem*> Elements = parseGroup(docElem);
+	QList<PageItem*> Elements = parseDocStream(true);
 
 	tmpSel->clear();
 	QImage tmpImage;
@@ -313,13 +315,35 @@ bool SVGPlug::importFile(const QString& fname, const TransactionSettings& trSett
 	m_currentSvgFilePath.clear();
 	m_currentSvgFileDir.clear();
 
-	if (!loadData(fname))
-	{
-		importFailed = true;
+	QFileInfo fInfo(fname);
+	cancel = false;
+	if (interactive && ScCore->usingGUI() && (fInfo.size() > progressFileSize))
+	{
+		ScribusMainWindow* mw = (m_Doc == nullptr) ? ScCore->primaryMainWindow() : m_Doc->scMW();
+		progressDialog = new MultiProgressDialog( tr("Importing: %1").arg(fInfo.fileName()), CommonStrings::tr_Cancel, mw );
+		QStringList barNames, barTexts;
+		barNames << "GI";
+		barTexts << tr("Analyzing File:");
+		QList<bool> barsNumeric;
+		barsNumeric << false;
+		progressDialog->addExtraProgressBars(barNames, barTexts, barsNumeric);
+		progressDialog->setOverallTotalSteps(2);
+		progressDialog->setOverallProgress(0);
+		progressDialog->setTotalSteps("GI", static_cast<int>(fInfo.size() / 1024));
+		progressDialog->setProgress("GI", 0);
+		progressDialog->show();
+		connect(progressDialog, &MultiProgressDialog::canceled, this, &SVGPlug::cancelRequested);
+		QApplication::processEvents();
+	}
+
+	if (!loadData(fname) || cancel)
+	{
+		if (progressDialog)
+			progressDialog->close();
+		importFailed = !cancel;
 		return false;
 	}
 
-	QFileInfo fInfo(fname);
 	m_currentSvgFilePath = fInfo.absoluteFilePath();
 	m_currentSvgFileDir = fInfo.absolutePath();
 
@@ -333,8 +357,11 @@ bool SVGPlug::importFile(const QString& fname, const TransactionSettings& trSett
 
 bool SVGPlug::loadData(const QString& fName)
 {
-	bool isCompressed = false;
-	bool success = false;
+	m_fileName = fName;
+	m_compressed = false;
+	m_referencedIds.clear();
+	m_nodeMap.clear();
+	inpdoc.clear();
 	QFile fi(fName);
 	if (fi.open(QIODevice::ReadOnly))
 	{
@@ -343,35 +370,234 @@ bool SVGPlug::loadData(const QString& fName)
 		fi.close();
 		// Qt4 bb[0]->QChar(bb[0])
 		if ((QChar(bb[0]) == QChar(0x1F)) && (QChar(bb[1]) == QChar(0x8B)))
-			isCompressed = true;
-	}
-	if ((fName.right(2) == "gz") || isCompressed)
-	{
-		QFile file(fName);
-		QtIOCompressor compressor(&file);
-		compressor.setStreamFormat(QtIOCompressor::GzipFormat);
-		if (!compressor.open(QIODevice::ReadOnly))
-			return false;
-#if QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)
-		success = (bool) inpdoc.setContent(&compressor);
-#else
-		success = inpdoc.setContent(&compressor, nullptr);
-#endif
-		compressor.close();
+			m_compressed = true;
 	}
-	else
+	if (fName.right(2) == "gz")
+		m_compressed = true;
+
+	// First pass, checks the document and collects the elements referenced by <use>
+	// and clip paths, the document is then streamed again for creating items
+	QFile file(fName);
+	std::unique_ptr<QtIOCompressor> compressor;
+	QIODevice* device = openDevice(file, compressor);
+	if (!device)
+		return false;
+	QXmlStreamReader reader(device);
+	reader.setNamespaceProcessing(false);
+	bool haveRoot = false;
+	while (!reader.atEnd() && !cancel)
+	{
+		if (reader.readNext() != QXmlStreamReader::StartElement)
+			continue;
+		if (!haveRoot)
+		{
+			// Only the attributes of the root element are kept
+			inpdoc.appendChild(createElement(reader));
+			haveRoot = true;
+		}
+		const QXmlStreamAttributes attributes = reader.attributes();
+		QStringView href = attributes.value("xlink:href");
+		if (href.startsWith(QLatin1Char('#')))
+			m_referencedIds.insert(href.mid(1).toString());
+		updateProgress(file);
+	}
+	if (reader.hasError() || !haveRoot)
+		return false;
+	if (m_referencedIds.isEmpty())
+		return true;
+	return readReferencedElements();
+}
+
+QIODevice* SVGPlug::openDevice(QFile& file, std::unique_ptr<QtIOCompressor>& compressor) const
+{
+	if (m_compressed)
+	{
+		compressor = std::make_unique<QtIOCompressor>(&file);
+		compressor->setStreamFormat(QtIOCompressor::GzipFormat);
+		if (!compressor->open(QIODevice::ReadOnly))
+			return nullptr;
+		return compressor.get();
+	}
+	if (!file.open(QIODevice::ReadOnly))
+		return nullptr;
+	return &file;
+}
+
+QDomElement SVGPlug::createElement(const QXmlStreamReader& reader)
+{
+	QDomElement element = inpdoc.createElement(reader.qualifiedName().toString());
+	const QXmlStreamAttributes attributes = reader.attributes();
+	for (const QXmlStreamAttribute& attribute : attributes)
+		element.setAttribute(attribute.qualifiedName().toString(), attribute.value().toString());
+	return element;
+}
+
+QDomElement SVGPlug::readElement(QXmlStreamReader& reader)
+{
+	QDomElement element = createElement(reader);
+	QStack<QDomElement> parents;
+	parents.push(element);
+	while (!parents.isEmpty() && !reader.atEnd())
+	{
+		switch (reader.readNext())
+		{
+			case QXmlStreamReader::StartElement:
+				{
+					QDomElement child = createElement(reader);
+					parents.top().appendChild(child);
+					parents.push(child);
+				}
+				break;
+			case QXmlStreamReader::EndElement:
+				parents.pop();
+				break;
+			case QXmlStreamReader::Characters:
+				// Same as QDomDocument, which drops whitespace only text
+				if (reader.isCDATA())
+					parents.top().appendChild(inpdoc.createCDATASection(reader.text().toString()));
+				else if (!reader.isWhitespace())
+					parents.top().appendChild(inpdoc.createTextNode(reader.text().toString()));
+				break;
+			default:
+				break;
+		}
+	}
+	return element;
+}
+
+bool SVGPlug::readReferencedElements()
+{
+	QFile file(m_fileName);
+	std::unique_ptr<QtIOCompressor> compressor;
+	QIODevice* device = openDevice(file, compressor);
+	if (!device)
+		return false;
+	QXmlStreamReader reader(device);
+	reader.setNamespaceProcessing(false);
+	bool haveRoot = false;
+	while (!reader.atEnd() && !cancel)
+	{
+		if (reader.readNext() != QXmlStreamReader::StartElement)
+			continue;
+		if (!haveRoot)
+		{
+			haveRoot = true;
+			continue;
+		}
+		updateProgress(file);
+		QString id = reader.attributes().value("id").toString();
+		if (id.isEmpty() || !m_referencedIds.contains(id))
+			continue;
+		// The elements nested in a referenced one are read with it
+		QDomElement element = readElement(reader);
+		m_nodeMap.insert(id, element);
+		m_nodeMap.insert(buildNodeMap(element));
+	}
+	return !reader.hasError();
+}
+
+QList<PageItem*> SVGPlug::parseDocStream(bool asGroup)
+{
+	QList<PageItem*> GElements;
+	QFile file(m_fileName);
+	std::unique_ptr<QtIOCompressor> compressor;
+	QIODevice* device = openDevice(file, compressor);
+	if (!device)
+		return GElements;
+	QXmlStreamReader reader(device);
+	reader.setNamespaceProcessing(false);
+	while (!reader.atEnd())
+	{
+		if (reader.readNext() == QXmlStreamReader::StartElement)
+			break;
+	}
+	if (!reader.isStartElement())
+		return GElements;
+
+	// Groups are not read as a whole, items are created for their children
+	// one by one, only the DOM of the other elements is built
+	struct StreamedGroup
+	{
+		QDomElement element;
+		GroupState state;
+	};
+	QStack<StreamedGroup> groups;
+	QDomElement docElem = inpdoc.documentElement();
+	if (asGroup)
+	{
+		groups.push(StreamedGroup { docElem, GroupState() });
+		beginGroup(docElem, groups.top().state);
+	}
+	int rootLevel = groups.count();
+
+	while (!reader.atEnd() && !cancel)
+	{
+		QXmlStreamReader::TokenType token = reader.readNext();
+		if (token == QXmlStreamReader::EndElement)
+		{
+			// End of the root element
+			if (groups.count() == rootLevel)
+				break;
+			StreamedGroup group = groups.pop();
+			QList<PageItem*> el = endGroup(group.element, group.state);
+			if (groups.isEmpty())
+				GElements += el;
+			else
+				groups.top().state.items += el;
+			continue;
+		}
+		if (token != QXmlStreamReader::StartElement)
+			continue;
+
+		QDomElement b = createElement(reader);
+		if (isIgnorableNode(b))
+		{
+			reader.skipCurrentElement();
+			continue;
+		}
+		SvgStyle svgStyle;
+		parseStyle(&svgStyle, b);
+		if (!svgStyle.Display)
+		{
+			reader.skipCurrentElement();
+			continue;
+		}
+		if (parseTagName(b) == "g")
+		{
+			groups.push(StreamedGroup { b, GroupState() });
+			beginGroup(b, groups.top().state);
+			continue;
+		}
+
+		b = readElement(reader);
+		QList<PageItem*> el = parseElement(b);
+		if (groups.isEmpty())
+			GElements += el;
+		else
+			groups.top().state.items += el;
+		updateProgress(file);
+	}
+
+	// Close the groups left open by a cancellation or an error
+	while (!groups.isEmpty())
 	{
-		QFile file(fName);
-		if (!file.open(QIODevice::ReadOnly))
-			return false;
-#if QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)
-		success = (bool) inpdoc.setContent(&file);
-#else
-		success = inpdoc.setContent(&file, nullptr);
-#endif
-		file.close();
+		StreamedGroup group = groups.pop();
+		QList<PageItem*> el = endGroup(group.element, group.state);
+		if (groups.isEmpty())
+			GElements += el;
+		else
+			groups.top().state.items += el;
 	}
-	return success;
+	return GElements;
+}
+
+void SVGPlug::updateProgress(const QFile& file)
+{
+	if (!progressDialog || (m_progressTimer.isValid() && (m_progressTimer.elapsed() < 100)))
+		return;
+	m_progressTimer.start();
+	progressDialog->setProgress("GI", static_cast<int>(file.pos() / 1024));
+	QApplication::processEvents();
 }
 
 QMap<QString, QDomElement> SVGPlug::buildNodeMap(const QDomElement &e) const
@@ -478,8 +704,23 @@ void SVGPlug::convert(const TransactionSettings& trSettings, int flags)
 		}
 	}
 
-	m_nodeMap = buildNodeMap(docElem);
-	Elements += parseDoc(docElem);
+	if (progressDialog)
+	{
+		progressDialog->setOverallProgress(1);
+		progressDialog->setLabel("GI", tr("Generating Items"));
+		progressDialog->setProgress("GI", 0);
+	}
+	Elements += parseDocStream(false);
+	if (progressDialog)
+		progressDialog->close();
+	if (cancel)
+	{
+		// Remove what was imported before the import was canceled
+		Selection tmpSelection(m_Doc, false);
+		tmpSelection.addItems(Elements);
+		m_Doc->itemSelection_DeleteItem(&tmpSelection);
+		Elements.clear();
+	}
 
 	if (flags & LoadSavePlugin::lfCreateDoc)
 	{
@@ -489,7 +730,7 @@ void SVGPlug::convert(const TransactionSettings& trSettings, int flags)
 	tmpSel->clear();
 	if (Elements.isEmpty())
 	{
-		importFailed = true;
+		importFailed = !cancel;
 		if ((importedColors.count() != 0) && ((flags & LoadSavePlugin::lfKeepGradients) || (flags & LoadSavePlugin::lfKeepColors) || (flags & LoadSavePlugin::lfKeepPatterns)))
 			importFailed = false;
 		if ((importedGradients.count() != 0) && ((flags & LoadSavePlugin::lfKeepGradients) || (flags & LoadSavePlugin::lfKeepPatterns)))
@@ -1227,12 +1468,27 @@ QList<PageItem*> SVGPlug::parseA(const QDomElement &e)
 
 QList<PageItem*> SVGPlug::parseGroup(const QDomElement &e)
 {
-	FPointArray clipPath;
-	QList<PageItem*> GElements;
-	QList<PageItem*> gElements;
+	GroupState group;
+	beginGroup(e, group);
+	for (QDomNode n = e.firstChild(); !n.isNull(); n = n.nextSibling())
+	{
+		QDomElement b = n.toElement();
+		if (b.isNull() || isIgnorableNode(b))
+			continue;
+		SvgStyle svgStyle;
+		parseStyle(&svgStyle, b);
+		if (!svgStyle.Display)
+			continue;
+		group.items += parseElement(b);
+	}
+	return endGroup(e, group);
+}
 
+void SVGPlug::beginGroup(const QDomElement &e, GroupState& group)
+{
 	if ((importerFlags & LoadSavePlugin::lfCreateDoc) && (e.hasAttribute("inkscape:groupmode")) && (e.attribute("inkscape:groupmode") == "layer"))
 	{
+		group.isLayer = true;
 		setupNode(e);
 		QString layerName = e.attribute("inkscape:label", "Layer");
 		double trans = m_gc.top()->Opacity;
@@ -1246,43 +1502,32 @@ QList<PageItem*> SVGPlug::parseGroup(const QDomElement &e)
 		m_Doc->setLayerPrintable(currentLayer, true);
 		m_Doc->setLayerTransparency(currentLayer, trans);
 		firstLayer = false;
-		for (QDomNode n = e.firstChild(); !n.isNull(); n = n.nextSibling())
-		{
-			QDomElement b = n.toElement();
-			if (b.isNull() || isIgnorableNode(b))
-				continue;
-			SvgStyle svgStyle;
-			parseStyle(&svgStyle, b);
-			if (!svgStyle.Display)
-				continue;
-			QList<PageItem*> el = parseElement(b);
-			for (int ec = 0; ec < el.count(); ++ec)
-				GElements.append(el.at(ec));
-		}
-		delete (m_gc.pop());
-		return GElements;
+		return;
 	}
 
 	double baseX = m_Doc->currentPage()->xOffset();
 	double baseY = m_Doc->currentPage()->yOffset();
 	groupLevel++;
 	setupNode(e);
-	parseClipPathAttr(e, clipPath);
+	parseClipPathAttr(e, group.clipPath);
 	int z = m_Doc->itemAdd(PageItem::Group, PageItem::Rectangle, baseX, baseY, 1, 1, 0, CommonStrings::None, CommonStrings::None);
-	PageItem *neu = m_Doc->Items->at(z);
-	for (QDomNode n = e.firstChild(); !n.isNull(); n = n.nextSibling())
+	group.item = m_Doc->Items->at(z);
+}
+
+QList<PageItem*> SVGPlug::endGroup(const QDomElement &e, GroupState& group)
+{
+	QList<PageItem*> GElements;
+	if (group.isLayer)
 	{
-		QDomElement b = n.toElement();
-		if (b.isNull() || isIgnorableNode(b))
-			continue;
-		SvgStyle svgStyle;
-		parseStyle(&svgStyle, b);
-		if (!svgStyle.Display)
-			continue;
-		QList<PageItem*> el = parseElement(b);
-		for (int ec = 0; ec < el.count(); ++ec)
-			gElements.append(el.at(ec));
+		delete (m_gc.pop());
+		return group.items;
 	}
+
+	FPointArray& clipPath = group.clipPath;
+	const QList<PageItem*>& gElements = group.items;
+	PageItem *neu = group.item;
+	double baseX = m_Doc->currentPage()->xOffset();
+	double baseY = m_Doc->currentPage()->yOffset();
 	groupLevel--;
 	const SvgStyle *gc = m_gc.top();
 	if (clipPath.empty())
@@ -1363,8 +1608,8 @@ QList<PageItem*> SVGPlug::parseGroup(const QDomElement &e)
 			currItem->gHeight = gh;
 			currItem->Parent = neu;
 			neu->groupItemList.append(currItem);
-			m_Doc->Items->removeAll(currItem);
 		}
+		removeGroupedItems(neu, gElements);
 		neu->setRedrawBounding();
 		neu->setTextFlowMode(PageItem::TextFlowDisabled);
 		m_Doc->GroupCounter++;
@@ -1383,23 +1628,22 @@ QList<PageItem*> SVGPlug::parseGroup(const QDomElement &e)
 	return GElements;
 }
 
-QList<PageItem*> SVGPlug::parseDoc(const QDomElement &e)
+void SVGPlug::removeGroupedItems(const PageItem* group, const QList<PageItem*>& items)
 {
-	QList<PageItem*> GElements;
-	for (QDomNode n = e.firstChild(); !n.isNull(); n = n.nextSibling())
+	// Items of a group are created after it, look for them at the end of the item list
+	// instead of searching the whole list once per item
+	QSet<const PageItem*> groupedItems(items.cbegin(), items.cend());
+	qsizetype removed = 0;
+	qsizetype groupIndex = m_Doc->Items->lastIndexOf(const_cast<PageItem*>(group));
+	for (qsizetype i = m_Doc->Items->count() - 1; (i > groupIndex) && (removed < groupedItems.count()); --i)
 	{
-		QDomElement b = n.toElement();
-		if (b.isNull() || isIgnorableNode(b))
+		if (!groupedItems.contains(m_Doc->Items->at(i)))
 			continue;
-		SvgStyle svgStyle;
-		parseStyle(&svgStyle, b);
-		if (!svgStyle.Display)
-			continue;
-		QList<PageItem*> el = parseElement(b);
-		for (int ec = 0; ec < el.count(); ++ec)
-			GElements.append(el.at(ec));
+		m_Doc->Items->removeAt(i);
+		++removed;
 	}
-	return GElements;
+	if (removed < groupedItems.count())
+		m_Doc->Items->removeIf([&groupedItems](const PageItem* item) { return groupedItems.contains(item); });
 }
 
 QList<PageItem*> SVGPlug::parseElement(const QDomElement &e)
@@ -7,12 +7,15 @@ for which a new license (GPL+exception) is in place.
 #ifndef SVGPLUG_H
 #define SVGPLUG_H
 
+#include <memory>
 #include <optional>
 
 #include <QDomElement>
+#include <QElapsedTimer>
 #include <QFont>
 #include <QList>
 #include <QRectF>
+#include <QSet>
 #include <QSizeF>
 #include <QStack>
 
@@ -65,7 +68,12 @@ extern "C" PLUGIN_API int svgimplugin_getPluginAPIVersion();
 extern "C" PLUGIN_API ScPlugin* svgimplugin_getPlugin();
 extern "C" PLUGIN_API void svgimplugin_freePlugin(ScPlugin* plugin);
 
+class MultiProgressDialog;
 class PageItem;
+class QFile;
+class QIODevice;
+class QtIOCompressor;
+class QXmlStreamReader;
 class ScribusDoc;
 class PrefsManager;
 class FPointArray;
@@ -176,6 +184,10 @@ class SVGPlug : public QObject
 
 		bool importFile(const QString& fname, const TransactionSettings& trSettings, int flags);
 		QImage readThumbnail(const QString& fn);
+		/*!
+		\brief Checks the file and reads the elements referenced by others
+		\retval true if the file is a valid XML document
+		 */
 		bool loadData(const QString& fname);
 		void convert(const TransactionSettings& trSettings, int flags);
 		void addGraphicContext();
@@ -193,7 +205,11 @@ class SVGPlug : public QObject
 		void parseFilterAttr(const QDomElement &e, PageItem* item) const;
 		QList<PageItem*> parseA(const QDomElement &e);
 		QList<PageItem*> parseGroup(const QDomElement &e);
-		QList<PageItem*> parseDoc(const QDomElement &e);
+		/*!
+		\brief Streams the file loaded by loadData() and creates its items
+		\param asGroup true to handle the root element like a group
+		 */
+		QList<PageItem*> parseDocStream(bool asGroup);
 		QList<PageItem*> parseElement(const QDomElement &e);
 		QList<PageItem*> parseCircle(const QDomElement &e);
 		QList<PageItem*> parseEllipse(const QDomElement &e);
@@ -231,10 +247,35 @@ class SVGPlug : public QObject
 
 		QMap<QString, QDomElement> buildNodeMap(const QDomElement &e) const;
 
+		//! \brief Group whose children are being parsed
+		struct GroupState
+		{
+			bool isLayer { false };
+			PageItem* item { nullptr };
+			FPointArray clipPath;
+			QList<PageItem*> items;
+		};
+		void beginGroup(const QDomElement &e, GroupState& group);
+		QList<PageItem*> endGroup(const QDomElement &e, GroupState& group);
+		void removeGroupedItems(const PageItem* group, const QList<PageItem*>& items);
+
+		QIODevice* openDevice(QFile& file, std::unique_ptr<QtIOCompressor>& compressor) const;
+		//! \brief Creates an element with the attributes of the current element of reader
+		QDomElement createElement(const QXmlStreamReader& reader);
+		//! \brief Reads the current element of reader and its content
+		QDomElement readElement(QXmlStreamReader& reader);
+		bool readReferencedElements();
+		void updateProgress(const QFile& file);
+
 		QString m_currentSvgFilePath;
 		QString m_currentSvgFileDir;
 
+		//! \brief Root element and the elements read from the file
 		QDomDocument inpdoc;
+		QString m_fileName;
+		bool m_compressed { false };
+		//! \brief Ids referenced by xlink:href attributes
+		QSet<QString> m_referencedIds;
 		QString docDesc;
 		QString docTitle;
 		int groupLevel { 0 };
@@ -279,6 +320,14 @@ class SVGPlug : public QObject
 		QMap<QString, markerDesc> markers;
 		QList<PageItem*> Elements;
 		QMap<QString, CSSStyle> cssStyleList;
+		//! \brief Files from this size show a progress dialog while imported
+		static constexpr qint64 progressFileSize { 4 * 1024 * 1024 };
+		MultiProgressDialog* progressDialog { nullptr };
+		QElapsedTimer m_progressTimer;
+		bool cancel { false };
+
+	public slots:
+		void cancelRequested() { cancel = true; }
 
 	protected:
 		QVector<double> parseNumbersList(const QString& numbersStr) const;
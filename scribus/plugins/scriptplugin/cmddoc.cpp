@@ -9,9 +9,11 @@ for which a new license (GPL+exception) is in place.
 #include "documentchecker.h"
 #include "documentinformation.h"
 #include "pyesstring.h"
+#include "scdatamerge.h"
 #include "scribuscore.h"
 #include "scribusdoc.h"
 #include "scribusview.h"
+#include "undomanager.h"
 #include "units.h"
 
 #include <QApplication>
@@ -259,6 +261,27 @@ PyObject *scribus_revertdoc(PyObject* /* self */)
 	Py_RETURN_NONE;
 }
 
+PyObject *scribus_undo(PyObject* /* self */, PyObject* args)
+{
+	int steps = 1;
+	if (!PyArg_ParseTuple(args, "|i", &steps))
+		return nullptr;
+	if (!checkHaveDocument())
+		return nullptr;
+	if (steps < 1)
+	{
+		PyErr_SetString(PyExc_ValueError, QObject::tr("Number of undo steps must be at least 1.","python error").toUtf8().constData());
+		return nullptr;
+	}
+	if (scriptBatchActive())
+	{
+		PyErr_SetString(ScribusException, QObject::tr("Cannot undo inside a batch.","python error").toUtf8().constData());
+		return nullptr;
+	}
+	UndoManager::instance()->undo(steps);
+	Py_RETURN_NONE;
+}
+
 PyObject *scribus_getdocname(PyObject* /* self */)
 {
 	if (!checkHaveDocument())
@@ -726,6 +749,56 @@ PyObject* scribus_exportdocumentcheck(PyObject* /* self */, PyObject* args, PyOb
 	Py_RETURN_NONE;
 }
 
+PyObject* scribus_datamerge(PyObject* /* self */, PyObject* args, PyObject* kw)
+{
+	PyESString dataFileArg;
+	PyESString outputFileArg;
+	int singleFile = 1;
+	int first = 0;
+	int last = -1;
+	char *kwargs[] = {const_cast<char*>("dataFile"), const_cast<char*>("outputFile"),
+		const_cast<char*>("singleFile"), const_cast<char*>("first"), const_cast<char*>("last"), nullptr};
+	if (!PyArg_ParseTupleAndKeywords(args, kw, "eses|pii", kwargs,
+			"utf-8", dataFileArg.ptr(), "utf-8", outputFileArg.ptr(), &singleFile, &first, &last))
+		return nullptr;
+	if (!checkHaveDocument())
+		return nullptr;
+
+	QString error;
+	ScDataMergeSource source;
+	if (!source.load(QString::fromUtf8(dataFileArg.c_str()), error))
+	{
+		PyErr_SetString(ScribusException, error.toUtf8().constData());
+		return nullptr;
+	}
+
+	ScribusDoc* currentDoc = ScCore->primaryMainWindow()->doc;
+	QString outputFile = QString::fromUtf8(outputFileArg.c_str());
+	QStringList files;
+	bool success;
+	{
+		ScDataMerge merge(currentDoc, source);
+		if (singleFile)
+		{
+			success = merge.exportPDF(outputFile, first, last, error);
+			if (success)
+				files.append(outputFile);
+		}
+		else
+			success = merge.exportPDFs(outputFile, first, last, files, error);
+	}
+	if (!success)
+	{
+		PyErr_SetString(ScribusException, error.toUtf8().constData());
+		return nullptr;
+	}
+
+	PyObject* fileList = PyList_New(files.count());
+	for (int i = 0; i < files.count(); ++i)
+		PyList_SetItem(fileList, i, PyUnicode_FromString(files.at(i).toUtf8()));
+	return fileList;
+}
+
 /*! HACK: this removes "warning: 'blah' defined but not used" compiler warnings
 with header files structure untouched (docstrings are kept near declarations)
 PV */
@@ -736,6 +809,7 @@ void cmddocdocwarnings()
 	  << scribus_closedoc__doc__
 	  << scribus_closemasterpage__doc__
 	  << scribus_createmasterpage__doc__
+	  << scribus_datamerge__doc__
 	  << scribus_deletemasterpage__doc__
 	  << scribus_editmasterpage__doc__
 	  << scribus_getbaseline__doc__ 
@@ -759,7 +833,8 @@ void cmddocdocwarnings()
 	  << scribus_setdoctype__doc__ 
 	  << scribus_setinfo__doc__
 	  << scribus_setmargins__doc__
-	  << scribus_setunit__doc__;
+	  << scribus_setunit__doc__
+	  << scribus_undo__doc__;
 }
 
 PyObject *scribus_getrtl(PyObject* /* self */)
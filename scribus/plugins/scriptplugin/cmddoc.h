@@ -153,6 +153,18 @@ Revert the current document to its last saved state.\n\
 "));
 PyObject *scribus_revertdoc(PyObject * /*self*/);
 
+/*! docstring */
+PyDoc_STRVAR(scribus_undo__doc__,
+QT_TR_NOOP("undo([steps])\n\
+\n\
+Undoes the last actions of the current document, like Edit > Undo. steps is\n\
+the number of actions to undo, 1 by default. A batch counts as one action.\n\
+\n\
+May raise ValueError if steps is lower than 1.\n\
+May raise ScribusException if called inside a batch.\n\
+"));
+PyObject *scribus_undo(PyObject * /*self*/, PyObject* args);
+
 /*! docstring */
 PyDoc_STRVAR(scribus_getdocname__doc__,
 QT_TR_NOOP("getDocName() -> string\n\
@@ -430,6 +442,31 @@ The errors are strings, mostly names from the PreflightError enum in scribusstru
 "));
 PyObject* scribus_exportdocumentcheck(PyObject* self, PyObject* args, PyObject* kw);
 
+/*! docstring */
+PyDoc_STRVAR(scribus_datamerge__doc__,
+QT_TR_NOOP("dataMerge(\"dataFile\", \"outputFile\", singleFile=True, first=0, last=-1) -> list\n\
+\n\
+Fills the current document with the records of a CSV or JSON data file and\n\
+exports it to PDF, returning the names of the written files.\n\
+\n\
+Text containing {{field}} placeholders, image frames having an attribute\n\
+named \"datamerge\" whose value names a field with the image file, and item\n\
+attribute values containing placeholders are bound to the fields of the\n\
+data file. CSV files start with a line naming the fields, JSON files hold an\n\
+array of objects.\n\
+\n\
+If singleFile is True, all records are written to outputFile one after the\n\
+other. Otherwise one file is written per record, %1 in outputFile is\n\
+replaced by the record number and placeholders by the record values.\n\
+first and last limit the export to a range of records counted from 0, a\n\
+negative last exports up to the last record. The document is left\n\
+unchanged.\n\
+\n\
+May raise ScribusError if the data could not be read or exported.\n\
+"));
+/** Exports the current document once per record of a data file. */
+PyObject* scribus_datamerge(PyObject* self, PyObject* args, PyObject* kw);
+
 
 PyDoc_STRVAR(scribus_getrtl__doc__,
 QT_TR_NOOP("getRTL() -> bool\n\
@@ -6,6 +6,7 @@ for which a new license (GPL+exception) is in place.
 */
 #include "cmdmisc.h"
 #include "cmdutil.h"
+#include "objbatch.h"
 
 #include <string>
 
@@ -22,6 +23,7 @@ for which a new license (GPL+exception) is in place.
 #include "scribusview.h"
 #include "selection.h"
 #include "fonts/scfontmetrics.h"
+#include "ui/multiprogressdialog.h"
 #include "pdfoptionsio.h"
 
 PyObject *scribus_setredraw(PyObject* /* self */, PyObject* args)
@@ -35,6 +37,26 @@ PyObject *scribus_setredraw(PyObject* /* self */, PyObject* args)
 	Py_RETURN_NONE;
 }
 
+PyObject *scribus_beginbatch(PyObject* /* self */)
+{
+	if (!checkHaveDocument())
+		return nullptr;
+	beginScriptBatch();
+	Py_RETURN_NONE;
+}
+
+PyObject *scribus_endbatch(PyObject* /* self */)
+{
+	if (!endScriptBatch())
+		return nullptr;
+	Py_RETURN_NONE;
+}
+
+PyObject *scribus_batch(PyObject* /* self */)
+{
+	return PyObject_CallObject((PyObject *) &Batch_Type, nullptr);
+}
+
 PyObject *scribus_getfontnames(PyObject* /* self */)
 {
 	int cc2 = 0;
@@ -854,14 +876,32 @@ PyObject *scribus_processevents(PyObject* /* self */)
 	Py_RETURN_NONE;
 }
 
+PyObject *scribus_cancelprogress(PyObject* /* self */)
+{
+	bool canceled = false;
+	const QList<MultiProgressDialog*> dialogs = ScCore->primaryMainWindow()->findChildren<MultiProgressDialog*>();
+	for (MultiProgressDialog* dialog : dialogs)
+	{
+		if (!dialog->isVisible())
+			continue;
+		dialog->emitCancel();
+		canceled = true;
+	}
+	return PyBool_FromLong(canceled);
+}
+
 /*! HACK: this removes "warning: 'blah' defined but not used" compiler warnings
 with header files structure untouched (docstrings are kept near declarations)
 PV */
 void cmdmiscdocwarnings()
 {
 	QStringList s;
-	s << scribus_createlayer__doc__
+	s << scribus_batch__doc__
+	  << scribus_beginbatch__doc__
+	  << scribus_cancelprogress__doc__
+	  << scribus_createlayer__doc__
 	  << scribus_deletelayer__doc__
+	  << scribus_endbatch__doc__
 	  << scribus_filequit__doc__
 	  << scribus_getfontnames__doc__
 	  << scribus_getactivelayer__doc__ 
@@ -25,6 +25,46 @@ setRedraw(True) in a finally: clause at the top level of your script.\n\
 /*! Enable/disable page redrawing. */
 PyObject *scribus_setredraw(PyObject * /*self*/, PyObject* args);
 
+/*! docstring */
+PyDoc_STRVAR(scribus_beginbatch__doc__,
+QT_TR_NOOP("beginBatch()\n\
+\n\
+Starts a batch of commands. Until the matching endBatch() call, the canvas\n\
+is not redrawn, palettes are not refreshed and text frames are not laid out\n\
+after each command. The changes made in a batch are recorded as a single\n\
+undo step when the outermost batch ends. Batches may be nested.\n\
+Prefer the batch() context manager, which always ends the batch.\n\
+"));
+/*! Start a batch of commands. */
+PyObject *scribus_beginbatch(PyObject * /*self*/);
+
+/*! docstring */
+PyDoc_STRVAR(scribus_endbatch__doc__,
+QT_TR_NOOP("endBatch()\n\
+\n\
+Ends a batch of commands started with beginBatch(). Ending the outermost\n\
+batch lays out the text chains the batch has modified once and redraws\n\
+the document.\n\
+\n\
+May raise ScribusException if no batch is active.\n\
+"));
+/*! End a batch of commands. */
+PyObject *scribus_endbatch(PyObject * /*self*/);
+
+/*! docstring */
+PyDoc_STRVAR(scribus_batch__doc__,
+QT_TR_NOOP("batch() -> context manager\n\
+\n\
+Returns a context manager running the commands of a with block as a batch,\n\
+see beginBatch(). Example:\n\
+\n\
+with scribus.batch():\n\
+    for name in scribus.getAllObjects():\n\
+        scribus.setFillColor('Red', name)\n\
+"));
+/*! Create a batch context manager. */
+PyObject *scribus_batch(PyObject * /*self*/);
+
 /*! docstring */
 PyDoc_STRVAR(scribus_getfontnames__doc__,
 QT_TR_NOOP("getFontNames() -> list\n\
@@ -401,6 +441,18 @@ Python loop running on the GUI thread to keep the interface responsive.\n\
 /*! Pump the Qt event loop. */
 PyObject *scribus_processevents(PyObject * /*self*/);
 
+/*! docstring */
+PyDoc_STRVAR(scribus_cancelprogress__doc__,
+QT_TR_NOOP("cancelProgress() -> bool\n\
+\n\
+Cancels the operation showing a progress dialog, such as the import of a big\n\
+file, as if the Cancel button of the dialog was pressed. Returns True if a\n\
+progress dialog was shown. The operation only runs callables scheduled with\n\
+invokeLater() while it processes events, call it from there.\n\
+"));
+/*! Press Cancel in the shown progress dialogs. */
+PyObject *scribus_cancelprogress(PyObject * /*self*/);
+
 PyDoc_STRVAR(scribus_readpdfoptions__doc__,
 QT_TR_NOOP("readPDFOptions(fileName)\n\
 \n\
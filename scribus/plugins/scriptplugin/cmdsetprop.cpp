@@ -29,14 +29,16 @@ PyObject *scribus_setgradfill(PyObject* /* self */, PyObject* args)
 	if (currItem == nullptr)
 		return nullptr;
 	QColor tmp;
-	currItem->fill_gradient.clearStops();
+	VGradient gradient(currItem->fill_gradient);
+	gradient.clearStops();
 	QString c1 = QString::fromUtf8(color1.c_str());
 	QString c2 = QString::fromUtf8(color2.c_str());
 	currItem->SetQColor(&tmp, c1, shade1);
-	currItem->fill_gradient.addStop(tmp, 0.0, 0.5, 1.0, c1, shade1);
+	gradient.addStop(tmp, 0.0, 0.5, 1.0, c1, shade1);
 	currItem->SetQColor(&tmp, c2, shade2);
-	currItem->fill_gradient.addStop(tmp, 1.0, 0.5, 1.0, c2, shade2);
-	currItem->GrType = typ;
+	gradient.addStop(tmp, 1.0, 0.5, 1.0, c2, shade2);
+	currItem->setFillGradient(gradient);
+	currItem->setGradientType(typ);
 	switch (currItem->GrType)
 	{
 		case 0:
@@ -81,6 +83,8 @@ PyObject *scribus_setgradfill(PyObject* /* self */, PyObject* args)
 		default:
 			break;
 	}
+	// The gradient vector is set without an undo action
+	currItem->markChanged();
 	//ScCore->primaryMainWindow()->view->updateGradientVectors(currItem);
 	currItem->updateGradientVectors();
 	currItem->update();
@@ -118,7 +122,9 @@ PyObject *scribus_setgradstop(PyObject* /* self */, PyObject* args)
 	QColor tmp;
 	QString c1 = QString::fromUtf8(color1.c_str());
 	currItem->SetQColor(&tmp, c1, shade1);
-	currItem->fill_gradient.setStop(tmp, rampPoint, 0.5, opacity, c1, shade1);
+	VGradient gradient(currItem->fill_gradient);
+	gradient.setStop(tmp, rampPoint, 0.5, opacity, c1, shade1);
+	currItem->setFillGradient(gradient);
 	currItem->updateGradientVectors();
 	currItem->update();
 	Py_RETURN_NONE;
@@ -6,6 +6,7 @@ for which a new license (GPL+exception) is in place.
 */
 
 #include "cmdutil.h"
+#include "pageitem.h"
 #include "prefsmanager.h"
 #include "pyesstring.h"
 #include "resourcecollection.h"
@@ -15,9 +16,139 @@ for which a new license (GPL+exception) is in place.
 #include "scribusview.h"
 #include "selection.h"
 #include "tableborder.h"
+#include "undomanager.h"
 #include "units.h"
 
+#include <QHash>
+#include <QList>
 #include <QMap>
+#include <QPointer>
+#include <QSet>
+
+namespace
+{
+	/**
+	 * Maps item names to their position in the document item list.
+	 *
+	 * Scripts address items by name and commands used to walk the whole
+	 * item list for each lookup. Positions are checked against the item
+	 * list before use, so stale entries caused by renamed, reordered or
+	 * deleted items are never returned, they only trigger a reindex.
+	 * The item list is changed in many places without notice, and new
+	 * items get their automatic name without a rename, so a name missing
+	 * from the index is searched for again in a rebuilt index.
+	 */
+	class ItemNameIndex
+	{
+	public:
+		PageItem* find(const QString& name);
+
+	private:
+		const QList<PageItem*>* m_items { nullptr };
+		int m_indexedCount { 0 };
+		QPointer<PageItem> m_lastIndexed;
+		quint64 m_renameRevision { 0 };
+		QHash<QString, int> m_positions;
+
+		PageItem* lookup(const QString& name) const;
+		bool isAppendedTo() const;
+		void index(int from);
+		void rebuild();
+	};
+
+	PageItem* ItemNameIndex::find(const QString& name)
+	{
+		const QList<PageItem*>* items = ScCore->primaryMainWindow()->doc->Items;
+		if ((items != m_items) || (m_renameRevision != PageItem::renameRevision()))
+		{
+			m_items = items;
+			rebuild();
+		}
+		else if (m_indexedCount != items->count())
+		{
+			// New items are appended to the list, only index those
+			if (isAppendedTo())
+				index(m_indexedCount);
+			else
+				rebuild();
+		}
+
+		// Items may have been replaced without changing the item count,
+		// e.g. deleted then created, so check a missing name against the list
+		if (!m_positions.contains(name))
+		{
+			rebuild();
+			return lookup(name);
+		}
+		PageItem* item = lookup(name);
+		if (item != nullptr)
+			return item;
+		// The cached position failed validation
+		rebuild();
+		return lookup(name);
+	}
+
+	PageItem* ItemNameIndex::lookup(const QString& name) const
+	{
+		auto it = m_positions.constFind(name);
+		if (it == m_positions.cend() || it.value() >= m_items->count())
+			return nullptr;
+		PageItem* item = m_items->at(it.value());
+		return (item->itemName() == name) ? item : nullptr;
+	}
+
+	bool ItemNameIndex::isAppendedTo() const
+	{
+		if (m_indexedCount > m_items->count())
+			return false;
+		if (m_indexedCount == 0)
+			return true;
+		return m_items->at(m_indexedCount - 1) == m_lastIndexed;
+	}
+
+	void ItemNameIndex::index(int from)
+	{
+		for (int i = from; i < m_items->count(); ++i)
+		{
+			const QString& itemName = m_items->at(i)->itemName();
+			if (!m_positions.contains(itemName))
+				m_positions.insert(itemName, i);
+		}
+		m_indexedCount = m_items->count();
+		m_lastIndexed = m_items->isEmpty() ? nullptr : m_items->last();
+	}
+
+	void ItemNameIndex::rebuild()
+	{
+		m_positions.clear();
+		m_renameRevision = PageItem::renameRevision();
+		index(0);
+	}
+
+	ItemNameIndex itemNameIndex;
+
+	struct ScriptBatch
+	{
+		int depth { 0 };
+		QPointer<ScribusDoc> doc;
+		bool doDrawing { true };
+		UndoTransaction transaction;
+		QSet<const PageItem*> touched;
+		QList<QPointer<PageItem> > touchedItems;
+	};
+
+	ScriptBatch scriptBatch;
+
+	PageItem* touchItem(PageItem* item)
+	{
+		if ((item != nullptr) && (scriptBatch.depth > 0) && !scriptBatch.touched.contains(item))
+		{
+			scriptBatch.touched.insert(item);
+			scriptBatch.touchedItems.append(item);
+		}
+		return item;
+	}
+}
 
 /// Convert a value in points to a value in the current document units
 double PointToValue(double Val)
@@ -62,18 +193,9 @@ PageItem *GetItem(const QString& name)
 {
 	ScribusDoc* currentDoc = ScCore->primaryMainWindow()->doc;
 	if (!name.isEmpty())
-	{
-		for (int i = 0; i < currentDoc->Items->count(); ++i)
-		{
-			if (currentDoc->Items->at(i)->itemName() == name)
-				return currentDoc->Items->at(i);
-		}
-	}
-	else
-	{
-		if (!currentDoc->m_Selection->isEmpty())
-			return currentDoc->m_Selection->itemAt(0);
-	}
+		return touchItem(itemNameIndex.find(name));
+	if (!currentDoc->m_Selection->isEmpty())
+		return touchItem(currentDoc->m_Selection->itemAt(0));
 	return nullptr;
 }
 
@@ -103,7 +225,7 @@ PageItem* GetUniqueItem(const QString& name)
 	if (name.isEmpty())
 	{
 		if (!ScCore->primaryMainWindow()->doc->m_Selection->isEmpty())
-			return ScCore->primaryMainWindow()->doc->m_Selection->itemAt(0);
+			return touchItem(ScCore->primaryMainWindow()->doc->m_Selection->itemAt(0));
 		PyErr_SetString(NoValidObjectError, QString("Cannot use empty string for object name when there is no selection").toUtf8().constData());
 		return nullptr;
 	}
@@ -118,12 +240,9 @@ PageItem* getPageItemByName(const QString& name)
 		return nullptr;
 	}
 
-	const ScribusDoc* currentDoc = ScCore->primaryMainWindow()->doc;
-	for (int i = 0; i < currentDoc->Items->count(); ++i)
-	{
-		if (name == currentDoc->Items->at(i)->itemName())
-			return currentDoc->Items->at(i);
-	}
+	PageItem* item = itemNameIndex.find(name);
+	if (item != nullptr)
+		return touchItem(item);
 
 	PyErr_SetString(NoValidObjectError, QString("Object not found").toUtf8().constData());
 	return nullptr;
@@ -140,13 +259,7 @@ bool ItemExists(const QString& name)
 	if (name.isEmpty())
 		return false;
 
-	const ScribusDoc* currentDoc = ScCore->primaryMainWindow()->doc;
-	for (int i = 0; i < currentDoc->Items->count(); ++i)
-	{
-		if (name == currentDoc->Items->at(i)->itemName())
-			return true;
-	}
-	return false;
+	return itemNameIndex.find(name) != nullptr;
 }
 
 /*!
@@ -184,7 +297,6 @@ QStringList getSelectedItemsByName()
 
 bool setSelectedItemsByName(const QStringList& itemNames)
 {
-	ScribusDoc* currentDoc =  ScCore->primaryMainWindow()->doc;
 	ScribusView* currentView = ScCore->primaryMainWindow()->view;
 
 	currentView->deselectItems();
@@ -193,15 +305,7 @@ bool setSelectedItemsByName(const QStringList& itemNames)
 	for (const QString& itemName : itemNames)
 	{
 		// Search for the named item
-		PageItem* item = nullptr;
-		for (int j = 0; j < currentDoc->Items->count(); j++)
-		{
-			if (itemName == currentDoc->Items->at(j)->itemName())
-			{
-				item = currentDoc->Items->at(j);
-				break;
-			}
-		}
+		PageItem* item = itemNameIndex.find(itemName);
 		if (!item)
 			return false;
 		// And select it
@@ -210,6 +314,77 @@ bool setSelectedItemsByName(const QStringList& itemNames)
 	return true;
 }
 
+void beginScriptBatch()
+{
+	if (scriptBatch.depth++ > 0)
+		return;
+	ScribusDoc* currentDoc = ScCore->primaryMainWindow()->doc;
+	scriptBatch.doc = currentDoc;
+	// The whole batch becomes a single undo step
+	if (UndoManager::undoEnabled())
+		scriptBatch.transaction = UndoManager::instance()->beginTransaction(currentDoc->getUName(), Um::IDocument, QObject::tr("Script"), "", nullptr);
+	scriptBatch.doDrawing = currentDoc->DoDrawing;
+	currentDoc->DoDrawing = false;
+	currentDoc->m_Selection->delaySignalsOn();
+	currentDoc->beginUpdate();
+}
+
+bool endScriptBatch()
+{
+	if (scriptBatch.depth <= 0)
+	{
+		PyErr_SetString(ScribusException, QObject::tr("endBatch() called without a matching beginBatch()", "python error").toUtf8().constData());
+		return false;
+	}
+	if (--scriptBatch.depth > 0)
+		return true;
+
+	if (scriptBatch.transaction)
+	{
+		// A document closed during the batch took its undo stack along
+		if (scriptBatch.doc != nullptr)
+			scriptBatch.transaction.commit();
+		scriptBatch.transaction.reset();
+	}
+
+	QList<QPointer<PageItem> > touchedItems;
+	touchedItems.swap(scriptBatch.touchedItems);
+	scriptBatch.touched.clear();
+	ScribusDoc* currentDoc = scriptBatch.doc;
+	scriptBatch.doc.clear();
+	if (currentDoc == nullptr)
+		return true;
+
+	currentDoc->endUpdate();
+	// Lay out each text chain touched by the batch once
+	QSet<PageItem*> chains;
+	for (const QPointer<PageItem>& item : std::as_const(touchedItems))
+	{
+		if (item.isNull())
+			continue;
+		// Incremental saving must rewrite the item, whether undo recorded the changes or not
+		item->markChanged();
+		if (!item->isTextFrame())
+			continue;
+		PageItem* firstFrame = item->firstInChain();
+		if (chains.contains(firstFrame))
+			continue;
+		chains.insert(firstFrame);
+		if (firstFrame->invalid)
+			firstFrame->layout();
+	}
+	currentDoc->m_Selection->delaySignalsOff();
+	currentDoc->DoDrawing = scriptBatch.doDrawing;
+	if (ScCore->primaryMainWindow()->doc == currentDoc)
+		ScCore->primaryMainWindow()->view->DrawNew();
+	return true;
+}
+
+bool scriptBatchActive()
+{
+	return scriptBatch.depth > 0;
+}
+
 TableBorder parseBorder(PyObject* borderLines, bool* ok)
 {
 	TableBorder border;
@@ -82,6 +82,27 @@ QStringList getSelectedItemsByName();
  */
 bool setSelectedItemsByName(const QStringList& itemNames);
 
+/*!
+ * @brief Starts a batch of script commands.
+ *
+ * Until the matching endScriptBatch() call, canvas redraws, selection
+ * signals and document change notifications are held back and changes
+ * are recorded as a single undo step. Batches may be nested.
+ */
+void beginScriptBatch();
+
+/*!
+ * @brief Ends a batch of script commands.
+ *
+ * Ending the outermost batch delivers the pending notifications once,
+ * lays out the text chains touched by the batch, commits its undo step
+ * and redraws the canvas. Sets a Python exception and returns false if
+ * no batch is active.
+ */
+bool endScriptBatch();
+
+bool scriptBatchActive();
+
 /*!
  * @brief Helper method to parse a border from a list of tuples.
  */
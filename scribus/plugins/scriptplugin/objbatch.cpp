@@ -0,0 +1,152 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#include "objbatch.h"
+
+#include "cmdutil.h"
+
+struct Batch
+{
+	PyObject_HEAD
+};
+
+static void Batch_dealloc(Batch* self)
+{
+	Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static PyObject * Batch_new(PyTypeObject *type, PyObject * /*args*/, PyObject * /*kwds*/)
+{
+	return type->tp_alloc(type, 0);
+}
+
+static PyObject *Batch_enter(Batch *self)
+{
+	if (!checkHaveDocument())
+		return nullptr;
+	beginScriptBatch();
+	Py_INCREF(self);
+	return (PyObject *) self;
+}
+
+static PyObject *Batch_exit(Batch * /*self*/, PyObject * /*args*/)
+{
+	if (!endScriptBatch())
+		return nullptr;
+	// Do not swallow exceptions raised inside the with block
+	Py_RETURN_FALSE;
+}
+
+static PyMethodDef Batch_methods[] = {
+	{ "__enter__", (PyCFunction) Batch_enter, METH_NOARGS, nullptr },
+	{ "__exit__", (PyCFunction) Batch_exit, METH_VARARGS, nullptr },
+	{ nullptr, (PyCFunction)(nullptr), 0, nullptr } // sentinel
+};
+
+PyTypeObject Batch_Type = {
+	PyVarObject_HEAD_INIT(nullptr, 0)   // PyObject_VAR_HEAD
+	"scribus.Batch", // const char *tp_name; /* For printing, in format "<module>.<name>" */
+	sizeof(Batch),   // int tp_basicsize, /* For allocation */
+	0,  // int tp_itemsize; /* For allocation */
+
+	/* Methods to implement standard operations */
+
+	(destructor) Batch_dealloc, //	 destructor tp_dealloc;
+#if PY_VERSION_HEX >= 0x03080000
+	0,       //     Py_ssize_t tp_vectorcall_offset
+#else
+	nullptr, //     printfunc tp_print;
+#endif
+	nullptr, //	 getattrfunc tp_getattr;
+	nullptr, //	 setattrfunc tp_setattr;
+	nullptr, //	 cmpfunc tp_as_async;
+	nullptr, //	 reprfunc tp_repr;
+
+	/* Method suites for standard classes */
+
+	nullptr, //	 PyNumberMethods *tp_as_number;
+	nullptr, //	 PySequenceMethods *tp_as_sequence;
+	nullptr, //	 PyMappingMethods *tp_as_mapping;
+
+	/* More standard operations (here for binary compatibility) */
+
+	nullptr, //	 hashfunc tp_hash;
+	nullptr, //	 ternaryfunc tp_call;
+	nullptr, //	 reprfunc tp_str;
+	nullptr, //	 getattrofunc tp_getattro;
+	nullptr, //	 setattrofunc tp_setattro;
+
+	/* Functions to access object as input/output buffer */
+	nullptr, //	 PyBufferProcs *tp_as_buffer;
+
+	/* Flags to define presence of optional/expanded features */
+	Py_TPFLAGS_DEFAULT,	// long tp_flags;
+
+	batch__doc__, // char *tp_doc; /* Documentation string */
+
+	/* Assigned meaning in release 2.0 */
+	/* call function for all accessible objects */
+	nullptr, //	 traverseproc tp_traverse;
+
+	/* delete references to contained objects */
+	nullptr, //	 inquiry tp_clear;
+
+	/* Assigned meaning in release 2.1 */
+	/* rich comparisons */
+	nullptr, //	 richcmpfunc tp_richcompare;
+
+	/* weak reference enabler */
+	0, //	 long tp_weaklistoffset;
+
+	/* Added in release 2.2 */
+	/* Iterators */
+	nullptr, //	 getiterfunc tp_iter;
+	nullptr, //	 iternextfunc tp_iternext;
+
+	/* Attribute descriptor and subclassing stuff */
+	Batch_methods, //	 struct PyMethodDef *tp_methods;
+	nullptr, //	 struct PyMemberDef *tp_members;
+	nullptr, //	 struct PyGetSetDef *tp_getset;
+	nullptr, //	 struct _typeobject *tp_base;
+	nullptr, //	 PyObject *tp_dict;
+	nullptr, //	 descrgetfunc tp_descr_get;
+	nullptr, //	 descrsetfunc tp_descr_set;
+	0, //	 long tp_dictoffset;
+	nullptr, //	 initproc tp_init;
+	nullptr, //	 allocfunc tp_alloc;
+	Batch_new, //	 newfunc tp_new;
+	nullptr, //	 freefunc tp_free; /* Low-level free-memory routine */
+	nullptr, //	 inquiry tp_is_gc; /* For PyObject_IS_GC */
+	nullptr, //	 PyObject *tp_bases;
+	nullptr, //	 PyObject *tp_mro; /* method resolution order */
+	nullptr, //	 PyObject *tp_cache;
+	nullptr, //	 PyObject *tp_subclasses;
+	nullptr, //	 PyObject *tp_weaklist;
+	nullptr, //	 destructor tp_del;
+	0, //	 unsigned int tp_version_tag;
+	nullptr, //	 destructor tp_finalize;
+#if PY_VERSION_HEX >= 0x03080000
+	nullptr, // tp_vectorcall
+#endif
+#if PY_VERSION_HEX >= 0x03080000 && PY_VERSION_HEX < 0x03090000
+	nullptr, // deprecated tp_print
+#endif
+#if PY_VERSION_HEX >= 0x030C0000 // Python 3.12
+	0, // unsigned char tp_watched
+#endif
+#if PY_VERSION_HEX >= 0x030D0000 // Python 3.13
+	0, // uint16_t tp_versions_used
+#endif
+
+#if defined(COUNT_ALLOCS) && PY_VERSION_HEX < 0x03090000
+	/* these must be last and never explicitly initialized */
+	//    int tp_allocs;
+	//    int tp_frees;
+	//    int tp_maxalloc;
+	//    struct _typeobject *tp_prev;
+	//    struct _typeobject *tp_next;
+#endif
+};
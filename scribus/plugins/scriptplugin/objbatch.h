@@ -0,0 +1,25 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#ifndef OBJBATCH_H
+#define OBJBATCH_H
+
+// Pulls in <Python.h> first
+#include "cmdvar.h"
+
+extern PyTypeObject Batch_Type;
+
+// docstrings
+PyDoc_STRVAR(batch__doc__,"Batch of commands\n\
+\n\
+Context manager returned by batch(). Entering it calls beginBatch(),\n\
+leaving it calls endBatch(), even when an exception is raised.\n\
+Example:\n\
+with scribus.batch():\n\
+    for name in names:\n\
+        scribus.setFillColor('Red', name)");
+
+#endif /* OBJBATCH_H */
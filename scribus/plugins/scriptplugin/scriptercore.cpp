@@ -30,6 +30,7 @@ for which a new license (GPL+exception) is in place.
 #include "scribuscore.h"
 #include "scribusdoc.h"
 #include "scribusview.h"
+#include "scriptservice.h"
 #include "selection.h"
 #include "ui/contentpalette.h" //TODO Move the calls to this to a signal
 #include "ui/helpbrowser.h"
@@ -70,6 +71,7 @@ ScripterCore::ScripterCore(QWidget* parent)
 
 	QObject::connect(ScQApp, SIGNAL(appStarted()) , this, SLOT(runStartupScript()) );
 	QObject::connect(ScQApp, SIGNAL(appStarted()) , this, SLOT(slotRunPythonScript()) );
+	QObject::connect(ScQApp, SIGNAL(appStarted()) , this, SLOT(slotRunServiceWorker()) );
 
 	QObject::connect(&scriptPaths, &ScriptPaths::runScriptFile, this, &ScripterCore::runScriptFile);
 }
@@ -242,6 +244,7 @@ void ScripterCore::slotRunScriptFile(const QString& fileName, bool inMainInterpr
 void ScripterCore::slotRunScriptFile(const QString& fileName, QStringList arguments, bool inMainInterpreter)
 /** run "filename" python script with the additional arguments provided in "arguments" */
 {
+	m_lastScriptError.clear();
 	// Prevent two scripts to be run concurrently or face crash!
 	if (ScCore->primaryMainWindow()->scriptIsRunning())
 		return;
@@ -343,6 +346,7 @@ void ScripterCore::slotRunScriptFile(const QString& fileName, QStringList argume
 		if (result == nullptr)
 		{
 			PyObject* errorMsgPyStr = PyMapping_GetItemString(globals, "_errorMsg");
+			m_lastScriptError = errorMsgPyStr ? PyUnicode_asQString(errorMsgPyStr) : tr("Script error");
 			if (errorMsgPyStr == nullptr)
 			{
 				// It's rather unlikely that this will ever be reached - to get here
@@ -373,6 +377,9 @@ void ScripterCore::slotRunScriptFile(const QString& fileName, QStringList argume
 		// Because 'result' may be nullptr, not a PyObject*, we must call PyXDECREF not Py_DECREF
 		Py_XDECREF(result);
 	} // end if m == nullptr
+	// Do not leave the document in batch mode if the script did not end its batches
+	while (scriptBatchActive())
+		endScriptBatch();
 	if (!inMainInterpreter)
 	{
 		Py_EndInterpreter(state);
@@ -394,6 +401,15 @@ void ScripterCore::slotRunPythonScript()
 	finishScriptRun();
 }
 
+// needed for running as a headless service worker from CLI
+void ScripterCore::slotRunServiceWorker()
+{
+	if (!ScQApp->isServiceWorker())
+		return;
+	ScriptServiceWorker worker(this);
+	worker.run();
+}
+
 void ScripterCore::slotRunScript(const QString& Script)
 {
 	// Prevent two scripts to be run concurrently or face crash!
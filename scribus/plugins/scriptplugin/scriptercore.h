@@ -37,6 +37,9 @@ public:
 
 	ScriptPaths scriptPaths;
 
+	/** @brief Traceback of the exception that ended the last script run from a file, empty on success */
+	const QString& lastScriptError() const { return m_lastScriptError; }
+
 public slots:
 	void runScriptDialog();
 	void StdScript(const QString& baseFilename);
@@ -45,6 +48,7 @@ public slots:
 	void slotRunScriptFile(const QString& fileName, bool inMainInterpreter = false);
 	void slotRunScriptFile(const QString& fileName, QStringList arguments, bool inMainInterpreter = false);
 	void slotRunPythonScript(); // needed for running python script from CLI
+	void slotRunServiceWorker(); // needed for running as a headless service worker from CLI
 	void slotRunScript(const QString& script);
 	void slotInteractiveScript(bool);
 	void slotExecute();
@@ -94,6 +98,8 @@ protected:
 	bool m_importAllNames {true};
 	/** \brief pref: Load this script on startup */
 	QString m_startupScript;
+
+	QString m_lastScriptError;
 };
 
 #endif
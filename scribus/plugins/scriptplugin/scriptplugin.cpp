@@ -52,6 +52,7 @@ for which a new license (GPL+exception) is in place.
 #include "cmdutil.h"
 #include "cmdvar.h"
 #include "guiapp.h"
+#include "objbatch.h"
 #include "objimageexport.h"
 #include "objpdffile.h"
 #include "objprinter.h"
@@ -285,6 +286,9 @@ PyMethodDef scribus_methods[] = {
 	// 2004/10/03 pv - aliases with common Python syntax - ClassName methodName
 	// 2004-11-06 cr - move aliasing to dynamically generated wrapper functions, sort methoddef
 	{ "applyMasterPage", scribus_applymasterpage, METH_VARARGS, tr(scribus_applymasterpage__doc__)},
+	{ "batch", (PyCFunction) scribus_batch, METH_NOARGS, tr(scribus_batch__doc__)},
+	{ "beginBatch", (PyCFunction) scribus_beginbatch, METH_NOARGS, tr(scribus_beginbatch__doc__)},
+	{ "cancelProgress", (PyCFunction) scribus_cancelprogress, METH_NOARGS, tr(scribus_cancelprogress__doc__)},
 	{ "changeColor", scribus_setcolor, METH_VARARGS, tr(scribus_setcolor__doc__)},
 	{ "changeColorCMYK", scribus_setcolorcmyk, METH_VARARGS, tr(scribus_setcolorcmyk__doc__)},
 	{ "changeColorCMYKFloat", scribus_setcolorcmykfloat, METH_VARARGS, tr(scribus_setcolorcmykfloat__doc__)},
@@ -312,6 +316,7 @@ PyMethodDef scribus_methods[] = {
 	{ "currentPage", (PyCFunction) scribus_currentpage, METH_NOARGS, tr(scribus_currentpage__doc__)},
 	{ "currentPageNumber", (PyCFunction) scribus_currentpage, METH_NOARGS, tr(scribus_currentpage__doc__)},
 	{ "currentPageNumberForSection", (PyCFunction) scribus_currentpagenumberforsection, METH_NOARGS, tr(scribus_currentpagenumberforsection__doc__)},
+	{ "dataMerge", (PyCFunction) scribus_datamerge, METH_VARARGS|METH_KEYWORDS, tr(scribus_datamerge__doc__)},
 	{ "defineColor", scribus_newcolor, METH_VARARGS, tr(scribus_newcolor__doc__)},
 	{ "defineColorCMYK", scribus_newcolorcmyk, METH_VARARGS, tr(scribus_newcolorcmyk__doc__)},
 	{ "defineColorCMYKFloat", scribus_newcolorcmykfloat, METH_VARARGS, tr(scribus_newcolorcmykfloat__doc__)},
@@ -328,6 +333,7 @@ PyMethodDef scribus_methods[] = {
 	{ "deselectAll", (PyCFunction) scribus_deselectall, METH_NOARGS, tr(scribus_deselectall__doc__)},
 	{ "docChanged", scribus_docchanged, METH_VARARGS, tr(scribus_docchanged__doc__)},
 	{ "editMasterPage", scribus_editmasterpage, METH_VARARGS, tr(scribus_editmasterpage__doc__)},
+	{ "endBatch", (PyCFunction) scribus_endbatch, METH_NOARGS, tr(scribus_endbatch__doc__)},
 	{ "exportDocumentCheck", (PyCFunction) scribus_exportdocumentcheck, METH_VARARGS|METH_KEYWORDS, tr(scribus_exportdocumentcheck__doc__)},
 	{ "fileDialog", (PyCFunction) scribus_filedialog, METH_VARARGS|METH_KEYWORDS, tr(scribus_filedialog__doc__)},
 	{ "fileQuit", scribus_filequit, METH_VARARGS, tr(scribus_filequit__doc__)},
@@ -635,6 +641,7 @@ PyMethodDef scribus_methods[] = {
 	{ "textFlowMode", scribus_settextflowmode, METH_VARARGS, tr(scribus_textflowmode__doc__)}, // Deprecated
 	{ "textOverflows", (PyCFunction) scribus_istextoverflowing, METH_VARARGS|METH_KEYWORDS, tr(scribus_istextoverflowing__doc__) },
 	{ "traceText", scribus_outlinetext, METH_VARARGS, tr(scribus_tracetext__doc__)},
+	{ "undo", scribus_undo, METH_VARARGS, tr(scribus_undo__doc__)},
 	{ "unGroupObject", scribus_ungroupobjects, METH_VARARGS, tr(scribus_ungroupobjects__doc__)}, // Deprecated, now alias for unGroupObjects()
 	{ "unGroupObjects", scribus_ungroupobjects, METH_VARARGS, tr(scribus_ungroupobjects__doc__)},
 	{ "unlinkTextFrames", scribus_unlinktextframes, METH_VARARGS, tr(scribus_unlinktextframes__doc__)},
@@ -719,6 +726,7 @@ PyObject* PyInit_scribus(void)
 	int result;
 	PyObject *m, *d;
 
+	PyType_Ready(&Batch_Type);
 	PyType_Ready(&Printer_Type);
 	PyType_Ready(&PDFfile_Type);
 	PyType_Ready(&ImageExport_Type);
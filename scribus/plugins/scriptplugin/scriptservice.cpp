@@ -0,0 +1,385 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+// Pulls in <Python.h> first
+#include "cmdvar.h"
+
+#include "scriptservice.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QMap>
+
+#include "cmdutil.h"
+#include "pdfoptions.h"
+#include "prefsmanager.h"
+#include "scdatamerge.h"
+#include "scribus.h"
+#include "scribuscore.h"
+#include "scribusdoc.h"
+#include "scribusview.h"
+#include "scriptercore.h"
+#include "scservicedispatcher.h"
+#include "ui/bookmarkpalette.h"
+#include "util.h"
+
+namespace
+{
+	/**
+	 * Saves the state of the main interpreter a job script may change and
+	 * restores it when going out of scope: the globals of __main__, the
+	 * module table, sys.path, sys.argv and the standard streams. Every job
+	 * script thus starts from the same fresh globals, and modules a job
+	 * imported from its own directories are not seen by the next one.
+	 * Modules of the Python installation stay loaded, extension modules
+	 * often cannot be imported twice in one process.
+	 */
+	class InterpreterStateGuard
+	{
+	public:
+		InterpreterStateGuard()
+		{
+			m_mainDict = PyDict_Copy(PyModule_GetDict(PyImport_AddModule("__main__")));
+			m_modules = PyDict_Copy(PySys_GetObject("modules"));
+			m_path = PySequence_List(PySys_GetObject("path"));
+			m_argv = PySequence_List(PySys_GetObject("argv"));
+			for (int i = 0; i < 3; ++i)
+			{
+				m_streams[i] = PySys_GetObject(streamNames[i]);
+				Py_XINCREF(m_streams[i]);
+			}
+		}
+
+		~InterpreterStateGuard()
+		{
+			PyObject* mainDict = PyModule_GetDict(PyImport_AddModule("__main__"));
+			if (m_mainDict)
+			{
+				PyDict_Clear(mainDict);
+				PyDict_Update(mainDict, m_mainDict);
+			}
+			PyObject* modules = PySys_GetObject("modules");
+			if (m_modules && modules)
+			{
+				const QStringList prefixes = installationPrefixes();
+				PyObject* names = PyDict_Keys(modules);
+				for (Py_ssize_t i = 0; names && i < PyList_Size(names); ++i)
+				{
+					PyObject* name = PyList_GetItem(names, i);
+					if (PyDict_Contains(m_modules, name))
+						continue;
+					if (!isInstalledModule(PyDict_GetItem(modules, name), prefixes))
+						PyDict_DelItem(modules, name);
+				}
+				Py_XDECREF(names);
+				PyDict_Update(modules, m_modules);
+			}
+			PyObject* path = PySys_GetObject("path");
+			if (m_path && path)
+				PyList_SetSlice(path, 0, PyList_Size(path), m_path);
+			if (m_argv)
+				PySys_SetObject("argv", m_argv);
+			for (int i = 0; i < 3; ++i)
+			{
+				if (m_streams[i])
+					PySys_SetObject(streamNames[i], m_streams[i]);
+				Py_XDECREF(m_streams[i]);
+			}
+			PyErr_Clear();
+			Py_XDECREF(m_argv);
+			Py_XDECREF(m_path);
+			Py_XDECREF(m_modules);
+			Py_XDECREF(m_mainDict);
+		}
+
+	private:
+		static constexpr const char* streamNames[3] = { "stdin", "stdout", "stderr" };
+
+		static QStringList installationPrefixes()
+		{
+			QStringList prefixes;
+			for (const char* name : { "prefix", "base_prefix", "exec_prefix", "base_exec_prefix" })
+			{
+				PyObject* prefix = PySys_GetObject(name);
+				if (prefix && PyUnicode_Check(prefix))
+					prefixes.append(PyUnicode_asQString(prefix));
+			}
+			prefixes.removeAll(QString());
+			return prefixes;
+		}
+
+		static bool isInstalledModule(PyObject* module, const QStringList& prefixes)
+		{
+			if (module == nullptr || module == Py_None)
+				return false;
+			QString origin;
+			PyObject* spec = PyObject_GetAttrString(module, "__spec__");
+			PyObject* specOrigin = (spec && spec != Py_None) ? PyObject_GetAttrString(spec, "origin") : nullptr;
+			if (specOrigin && PyUnicode_Check(specOrigin))
+				origin = PyUnicode_asQString(specOrigin);
+			Py_XDECREF(specOrigin);
+			Py_XDECREF(spec);
+			PyErr_Clear();
+			if (origin == "built-in" || origin == "frozen")
+				return true;
+			for (const QString& prefix : prefixes)
+			{
+				if (origin.startsWith(prefix))
+					return true;
+			}
+			return false;
+		}
+
+		PyObject* m_mainDict {nullptr};
+		PyObject* m_modules {nullptr};
+		PyObject* m_path {nullptr};
+		PyObject* m_argv {nullptr};
+		PyObject* m_streams[3] {nullptr, nullptr, nullptr};
+	};
+}
+
+ScriptServiceWorker::ScriptServiceWorker(ScripterCore* scripter)
+	: m_scripter(scripter)
+{
+}
+
+void ScriptServiceWorker::run()
+{
+	std::string line;
+	while (std::getline(std::cin, line))
+	{
+		QJsonParseError parseError;
+		QJsonDocument doc = QJsonDocument::fromJson(QByteArray::fromStdString(line), &parseError);
+		QJsonObject result;
+		if (doc.isObject())
+			result = runJob(doc.object());
+		else
+		{
+			result["ok"] = false;
+			result["error"] = QObject::tr("Invalid job: %1").arg(parseError.errorString());
+		}
+		// Script output must not end up on the result line
+		PyRun_SimpleString("import sys\nsys.stdout.flush()\nsys.stderr.flush()\n");
+		std::cout << std::endl << ScServiceDispatcher::resultMarker().constData() << QJsonDocument(result).toJson(QJsonDocument::Compact).constData() << std::endl;
+	}
+}
+
+QJsonObject ScriptServiceWorker::runJob(const QJsonObject& job)
+{
+	ScribusMainWindow* mainWin = ScCore->primaryMainWindow();
+	QJsonObject result;
+	QJsonObject timings;
+	QJsonArray outputs;
+	QString error;
+	QElapsedTimer total;
+	QElapsedTimer step;
+	total.start();
+
+	result["id"] = job.value("id");
+
+	// A failed job may have left its document behind
+	while (mainWin->HaveDoc)
+		closeDocument();
+
+	step.start();
+	QString document = job.value("document").toString();
+	if (!mainWin->loadDoc(document))
+		error = QObject::tr("Failed to open document: %1").arg(document);
+	timings["open"] = step.elapsed();
+
+	QString script = job.value("script").toString();
+	if (error.isEmpty() && !script.isEmpty())
+	{
+		step.restart();
+		QStringList args;
+		const QJsonArray jsonArgs = job.value("args").toArray();
+		for (const QJsonValue& arg : jsonArgs)
+			args.append(arg.toString());
+		if (!QFileInfo::exists(script))
+			error = QObject::tr("Python script %1 does not exist").arg(script);
+		else
+		{
+			// The service runs every script in its main interpreter, which
+			// keeps the scribus module and its imports warm. Jobs must not
+			// see what earlier jobs left behind in it.
+			InterpreterStateGuard interpreterState;
+			m_scripter->slotRunScriptFile(script, args, true);
+			error = m_scripter->lastScriptError();
+			if (error.isEmpty() && !mainWin->HaveDoc)
+				error = QObject::tr("The script closed the document");
+		}
+		timings["script"] = step.elapsed();
+	}
+
+	if (error.isEmpty())
+	{
+		step.restart();
+		QString pdfFile = job.value("pdf").toString();
+		QString dataFile = job.value("data").toString();
+		if (!dataFile.isEmpty())
+		{
+			QStringList files;
+			exportDataMerge(dataFile, pdfFile, job, files, error);
+			for (const QString& file : std::as_const(files))
+				outputs.append(file);
+		}
+		else if (!pdfFile.isEmpty() && exportPDF(pdfFile, error))
+			outputs.append(pdfFile);
+		QString pngFile = job.value("png").toString();
+		if (error.isEmpty() && !pngFile.isEmpty())
+		{
+			QStringList files;
+			exportPNG(pngFile, job.value("dpi").toDouble(72.0), files, error);
+			for (const QString& file : std::as_const(files))
+				outputs.append(file);
+		}
+		timings["export"] = step.elapsed();
+	}
+
+	step.restart();
+	if (mainWin->HaveDoc)
+		closeDocument();
+	timings["close"] = step.elapsed();
+	timings["total"] = total.elapsed();
+
+	result["ok"] = error.isEmpty();
+	if (!error.isEmpty())
+		result["error"] = error;
+	result["outputs"] = outputs;
+	result["timings"] = timings;
+	return result;
+}
+
+bool ScriptServiceWorker::exportPDF(const QString& fileName, QString& error)
+{
+	// Same steps as PDFfile.save(), using the PDF options stored in the document
+	ScribusMainWindow* mainWin = ScCore->primaryMainWindow();
+	ScribusDoc* doc = mainWin->doc;
+	PDFOptions& pdfOptions = doc->pdfOptions();
+
+	if (mainWin->bookmarkPalette->BView->topLevelItemCount() == 0)
+		pdfOptions.Bookmarks = false;
+
+	doc->reorganiseFonts();
+	const SCFonts& availableFonts = PrefsManager::instance().appPrefs.fontPrefs.AvailFonts;
+	QStringList usedFontNames = doc->UsedFonts.keys();
+	if (pdfOptions.Version == PDFVersion::PDF_X1a ||
+	    pdfOptions.Version == PDFVersion::PDF_X3 ||
+	    pdfOptions.Version == PDFVersion::PDF_X4)
+	{
+		pdfOptions.FontEmbedding = PDFOptions::EmbedFonts;
+	}
+	pdfOptions.EmbedList.clear();
+	pdfOptions.SubsetList.clear();
+	pdfOptions.OutlineList.clear();
+	if (pdfOptions.FontEmbedding == PDFOptions::EmbedFonts)
+	{
+		for (const QString& fontName : std::as_const(usedFontNames))
+		{
+			const ScFace& fontFace = availableFonts[fontName];
+			if (fontFace.subset() || (fontFace.isOTF() && !pdfOptions.Version.supportsEmbeddedOpenTypeFonts()))
+				pdfOptions.SubsetList.append(fontName);
+			else
+				pdfOptions.EmbedList.append(fontName);
+		}
+	}
+	else if (pdfOptions.FontEmbedding == PDFOptions::OutlineFonts)
+		pdfOptions.OutlineList = usedFontNames;
+
+	pdfOptions.fileName = fileName;
+	std::vector<int> pageNs;
+	QMap<int, QImage> thumbs;
+	PageToPixmapFlags pixmapFlags = Pixmap_DontReloadImages | Pixmap_DrawWhiteBackground;
+	for (int i = 0; i < doc->DocPages.count(); ++i)
+	{
+		pageNs.push_back(i + 1);
+		QImage thumb(10, 10, QImage::Format_ARGB32_Premultiplied);
+		if (pdfOptions.Thumbnails)
+			thumb = mainWin->view->PageToPixmap(i, 100, pixmapFlags);
+		thumbs.insert(i + 1, thumb);
+	}
+
+	ReOrderText(doc, mainWin->view);
+
+	QString errorMessage;
+	if (mainWin->getPDFDriver(fileName, pageNs, thumbs, errorMessage))
+		return true;
+	error = QObject::tr("Cannot write the file: %1").arg(fileName);
+	if (!errorMessage.isEmpty())
+		error += QString("\n%1").arg(errorMessage);
+	return false;
+}
+
+bool ScriptServiceWorker::exportDataMerge(const QString& dataFile, const QString& pdfFile, const QJsonObject& job, QStringList& files, QString& error)
+{
+	if (pdfFile.isEmpty())
+	{
+		error = QObject::tr("A data merge needs a PDF file name");
+		return false;
+	}
+	ScDataMergeSource source;
+	if (!source.load(dataFile, error))
+		return false;
+	ScDataMerge merge(ScCore->primaryMainWindow()->doc, source);
+	int first = job.value("first").toInt(0);
+	int last = job.value("last").toInt(-1);
+	if (!job.value("merged").toBool(true))
+		return merge.exportPDFs(pdfFile, first, last, files, error);
+	if (!merge.exportPDF(pdfFile, first, last, error))
+		return false;
+	files.append(pdfFile);
+	return true;
+}
+
+bool ScriptServiceWorker::exportPNG(const QString& fileName, double dpi, QStringList& files, QString& error)
+{
+	// Same rendering as ImageExport.saveAs(), for all pages. The page number
+	// replaces %1 in the file name, or is appended to it for multi-page documents.
+	ScribusMainWindow* mainWin = ScCore->primaryMainWindow();
+	ScribusDoc* doc = mainWin->doc;
+	int dotsPerMeter = qRound(100.0 / 2.54 * dpi);
+	int pageCount = doc->DocPages.count();
+	for (int i = 0; i < pageCount; ++i)
+	{
+		ScPage* page = doc->DocPages.at(i);
+		QString pageFile(fileName);
+		if (fileName.contains("%1"))
+			pageFile = fileName.arg(i + 1);
+		else if (pageCount > 1)
+		{
+			QFileInfo fi(fileName);
+			pageFile = QString("%1/%2-%3.%4").arg(fi.path(), fi.completeBaseName()).arg(i + 1).arg(fi.suffix());
+		}
+		double pixmapSize = qMax(page->width(), page->height());
+		QImage im = mainWin->view->PageToPixmap(i, qRound(pixmapSize * dpi / 72.0), Pixmap_DrawBackground);
+		im.setDotsPerMeterX(dotsPerMeter);
+		im.setDotsPerMeterY(dotsPerMeter);
+		if (!im.save(pageFile, "PNG"))
+		{
+			error = QObject::tr("Failed to export image: %1").arg(pageFile);
+			return false;
+		}
+		files.append(pageFile);
+	}
+	return true;
+}
+
+void ScriptServiceWorker::closeDocument()
+{
+	ScribusMainWindow* mainWin = ScCore->primaryMainWindow();
+	mainWin->doc->setModified(false);
+	mainWin->slotFileClose();
+	QApplication::processEvents();
+}
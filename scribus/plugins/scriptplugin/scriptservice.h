@@ -0,0 +1,42 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#ifndef SCRIPTSERVICE_H
+#define SCRIPTSERVICE_H
+
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+
+class ScripterCore;
+
+/**
+ * Job loop of a headless service worker (--service-worker).
+ *
+ * Reads one JSON job per line from stdin until the end of input. Each job
+ * opens a document, runs an optional script on it, exports it and closes it,
+ * then the result is written to stdout on a line starting with
+ * ScServiceDispatcher::resultMarker(). Fonts, colour profiles, plugins and
+ * the image cache are set up once for the whole lifetime of the worker.
+ */
+class ScriptServiceWorker
+{
+public:
+	explicit ScriptServiceWorker(ScripterCore* scripter);
+
+	void run();
+
+private:
+	ScripterCore* m_scripter {nullptr};
+
+	QJsonObject runJob(const QJsonObject& job);
+	bool exportPDF(const QString& fileName, QString& error);
+	bool exportDataMerge(const QString& dataFile, const QString& pdfFile, const QJsonObject& job, QStringList& files, QString& error);
+	bool exportPNG(const QString& fileName, double dpi, QStringList& files, QString& error);
+	void closeDocument();
+};
+
+#endif
@@ -347,6 +347,8 @@ void PrefsManager::initDefaults()
 	appPrefs.docSetupPrefs.AutoSaveCount = 1;
 	appPrefs.docSetupPrefs.AutoSaveKeep = false;
 	appPrefs.docSetupPrefs.saveCompressed = false;
+	appPrefs.docSetupPrefs.saveIncremental = false;
+	appPrefs.docSetupPrefs.deferImageLoading = false;
 	appPrefs.docSetupPrefs.AutoSaveLocation = true;
 	appPrefs.docSetupPrefs.AutoSaveDir = "";
 	appPrefs.miscPrefs.saveEmergencyFile = true;
@@ -480,6 +482,7 @@ void PrefsManager::initDefaults()
 	appPrefs.pdfPrefs.Compress = true;
 	appPrefs.pdfPrefs.CompressMethod = PDFOptions::Compression_Auto;
 	appPrefs.pdfPrefs.Quality = 0;
+	appPrefs.pdfPrefs.CompressionLevel = PDFOptions::CompressionLevel_Balanced;
 	appPrefs.pdfPrefs.RecalcPic = false;
 	appPrefs.pdfPrefs.embedPDF  = false;
 	appPrefs.pdfPrefs.Bookmarks = false;
@@ -1410,6 +1413,8 @@ bool PrefsManager::writePref(const QString& filePath)
 	deDocumentSetup.setAttribute("AutoSaveLoc", static_cast<int>(appPrefs.docSetupPrefs.AutoSaveLocation));
 	deDocumentSetup.setAttribute("AutoSaveDir", appPrefs.docSetupPrefs.AutoSaveDir);
 	deDocumentSetup.setAttribute("SaveCompressed", static_cast<int>(appPrefs.docSetupPrefs.saveCompressed));
+	deDocumentSetup.setAttribute("SaveIncremental", static_cast<int>(appPrefs.docSetupPrefs.saveIncremental));
+	deDocumentSetup.setAttribute("DeferImageLoading", static_cast<int>(appPrefs.docSetupPrefs.deferImageLoading));
 	deDocumentSetup.setAttribute("BleedTop", ScCLocale::toQStringC(appPrefs.docSetupPrefs.bleeds.top()));
 	deDocumentSetup.setAttribute("BleedLeft", ScCLocale::toQStringC(appPrefs.docSetupPrefs.bleeds.left()));
 	deDocumentSetup.setAttribute("BleedRight", ScCLocale::toQStringC(appPrefs.docSetupPrefs.bleeds.right()));
@@ -1841,6 +1846,7 @@ bool PrefsManager::writePref(const QString& filePath)
 	pdf.setAttribute("Compress", static_cast<int>(appPrefs.pdfPrefs.Compress));
 	pdf.setAttribute("CompressionMethod", appPrefs.pdfPrefs.CompressMethod);
 	pdf.setAttribute("Quality", appPrefs.pdfPrefs.Quality);
+	pdf.setAttribute("CompressionLevel", appPrefs.pdfPrefs.CompressionLevel);
 	pdf.setAttribute("EmbedPDF", static_cast<int>(appPrefs.pdfPrefs.embedPDF));
 	pdf.setAttribute("MirrorPagesHorizontal", static_cast<int>(appPrefs.pdfPrefs.MirrorH));
 	pdf.setAttribute("MirrorPagesVertical", static_cast<int>(appPrefs.pdfPrefs.MirrorV));
@@ -2116,6 +2122,8 @@ bool PrefsManager::readPref(const QString& filePath)
 			appPrefs.docSetupPrefs.AutoSaveLocation = static_cast<bool>(dc.attribute("AutoSaveLoc", "1").toInt());
 			appPrefs.docSetupPrefs.AutoSaveDir = dc.attribute("AutoSaveDir", "");
 			appPrefs.docSetupPrefs.saveCompressed = static_cast<bool>(dc.attribute("SaveCompressed", "0").toInt());
+			appPrefs.docSetupPrefs.saveIncremental = static_cast<bool>(dc.attribute("SaveIncremental", "0").toInt());
+			appPrefs.docSetupPrefs.deferImageLoading = static_cast<bool>(dc.attribute("DeferImageLoading", "0").toInt());
 			appPrefs.docSetupPrefs.bleeds.setTop(ScCLocale::toDoubleC(dc.attribute("BleedTop"), 0.0));
 			appPrefs.docSetupPrefs.bleeds.setLeft(ScCLocale::toDoubleC(dc.attribute("BleedLeft"), 0.0));
 			appPrefs.docSetupPrefs.bleeds.setRight(ScCLocale::toDoubleC(dc.attribute("BleedRight"), 0.0));
@@ -2692,6 +2700,7 @@ bool PrefsManager::readPref(const QString& filePath)
 			appPrefs.pdfPrefs.Compress = static_cast<bool>(dc.attribute("Compress").toInt());
 			appPrefs.pdfPrefs.CompressMethod = (PDFOptions::PDFCompression) dc.attribute("CompressMethod", "0").toInt();
 			appPrefs.pdfPrefs.Quality = dc.attribute("Quality", "0").toInt();
+			appPrefs.pdfPrefs.CompressionLevel = (PDFOptions::PDFCompressionLevel) dc.attribute("CompressionLevel", "1").toInt();
 			appPrefs.pdfPrefs.embedPDF  = dc.attribute("EmbedPDF", "0").toInt();
 			appPrefs.pdfPrefs.RecalcPic = static_cast<bool>(dc.attribute("RecalcPic").toInt());
 			appPrefs.pdfPrefs.Bookmarks = static_cast<bool>(dc.attribute("Bookmarks").toInt());
@@ -169,6 +169,8 @@ struct DocumentSetupPrefs
 	bool AutoSaveLocation;
 	QString AutoSaveDir;
 	bool saveCompressed;
+	bool saveIncremental; //! Reuse the saved XML of unchanged items
+	bool deferImageLoading; //! Load the images of opened documents when their pages are drawn
 	int bindingDirection; //! 0 = LTR, 1 = RTL
 	bool isRTL; //! \brief Document is right-to-left
 };
@@ -5,14 +5,65 @@ a copyright and/or license notice that predates the release of Scribus 1.3.2
 for which a new license (GPL+exception) is in place.
 */
 
+#include <atomic>
+
+#include <QDataStream>
+#include <QPainter>
+#include <QProcess>
+#include <QThread>
+
+#include "iconmanager.h"
+#include "prefsmanager.h"
 #include "printpreviewcreator.h"
 #include "sccolor.h"
 #include "sccolorengine.h"
+#include "scpaths.h"
 #include "scribuscore.h"
 #include "scribusdoc.h"
 #include "util_ghostscript.h"
 #include "util_printer.h"
 
+/**
+  * @brief Runs Ghostscript for a page prefetched by PrintPreviewCreator
+  */
+class PrintPreviewRenderThread : public QThread
+{
+public:
+	PrintPreviewRenderThread(const QString& program, const QStringList& arguments)
+		: m_program(program), m_arguments(arguments) {}
+
+	void cancel() { m_cancel = true; }
+	int exitCode() const { return m_exitCode; }
+
+protected:
+	void run() override
+	{
+		QProcess proc;
+		proc.start(m_program, m_arguments);
+		if (!proc.waitForStarted(15000))
+			return;
+		while (!proc.waitForFinished(100))
+		{
+			if (proc.state() == QProcess::NotRunning)
+				break;
+			if (m_cancel)
+			{
+				proc.kill();
+				proc.waitForFinished();
+				return;
+			}
+		}
+		if (proc.exitStatus() == QProcess::NormalExit)
+			m_exitCode = proc.exitCode();
+	}
+
+private:
+	QString m_program;
+	QStringList m_arguments;
+	std::atomic<bool> m_cancel { false };
+	int m_exitCode { -1 };
+};
+
 PrintPreviewCreator::PrintPreviewCreator(ScribusDoc* doc) :
 	m_doc(doc),
 	m_printOptions(doc->Print_Options)
@@ -31,6 +82,96 @@ PrintPreviewCreator::PrintPreviewCreator(ScribusDoc* doc) :
 	m_printOptions.markLength = 20.0;
 	m_printOptions.markOffset = 0.0;
 	m_printOptions.bleeds.set(0, 0, 0, 0);
+
+	// Cost of cached previews is in KiB
+	m_previewCache.setMaxCost(128 * 1024);
+}
+
+PrintPreviewCreator::~PrintPreviewCreator()
+{
+	stopPrefetch();
+}
+
+QPixmap PrintPreviewCreator::preview(int pageIndex)
+{
+	QByteArray key = previewKey(pageIndex);
+	collectPrefetch(key);
+	const QPixmap* cachedPixmap = m_previewCache.object(key);
+	if (cachedPixmap)
+		return *cachedPixmap;
+
+	QPixmap pixmap = createPreview(pageIndex);
+	cachePreview(key, pixmap);
+	return pixmap;
+}
+
+bool PrintPreviewCreator::prefetch(int pageIndex)
+{
+	collectPrefetch(QByteArray());
+	if (m_prefetchThread)
+		return true;
+	if ((pageIndex < 0) || (pageIndex >= m_doc->Pages->count()))
+		return false;
+
+	PrefetchJob job;
+	job.pageIndex = pageIndex;
+	job.key = previewKey(pageIndex);
+	if (m_previewCache.contains(job.key))
+		return false;
+	if (!preparePrefetch(job))
+		return false;
+	m_prefetchJob = job;
+	m_prefetchThread = new PrintPreviewRenderThread(job.program, job.arguments);
+	m_prefetchThread->start(QThread::LowPriority);
+	return true;
+}
+
+QByteArray PrintPreviewCreator::previewKey(int pageIndex) const
+{
+	// Keys are compared in full, two pages or option sets never share a preview
+	QByteArray key;
+	QDataStream keyStream(&key, QIODevice::WriteOnly);
+	keyStream << pageIndex << m_doc->contentRevision() << m_previewResolution << m_devicePixelRatio << m_useAntialiasing << m_showTransparency;
+	keyStream << static_cast<int>(m_printOptions.prnLanguage) << m_printOptions.useSpotColors << m_printOptions.useColor << m_printOptions.doGCR;
+	keyStream << m_printOptions.mirrorH << m_printOptions.mirrorV << m_printOptions.doClip;
+	writeRenderingKey(keyStream);
+	return key;
+}
+
+void PrintPreviewCreator::cachePreview(const QByteArray& key, const QPixmap& pixmap)
+{
+	// Previews of pages which failed to render are 1x1 pixmaps
+	if ((pixmap.width() <= 1) && (pixmap.height() <= 1))
+		return;
+	qint64 cost = static_cast<qint64>(pixmap.width()) * pixmap.height() * 4 / 1024;
+	m_previewCache.insert(key, new QPixmap(pixmap), qMax<qint64>(1, cost));
+}
+
+void PrintPreviewCreator::collectPrefetch(const QByteArray& wantedKey)
+{
+	if (!m_prefetchThread)
+		return;
+	if ((m_prefetchJob.key != wantedKey) && !m_prefetchThread->isFinished())
+		return;
+	m_prefetchThread->wait();
+	int exitCode = m_prefetchThread->exitCode();
+	delete m_prefetchThread;
+	m_prefetchThread = nullptr;
+
+	// Options may have changed while Ghostscript was running
+	if ((exitCode != 0) || (previewKey(m_prefetchJob.pageIndex) != m_prefetchJob.key))
+		return;
+	cachePreview(m_prefetchJob.key, finishPrefetch(m_prefetchJob));
+}
+
+void PrintPreviewCreator::stopPrefetch()
+{
+	if (!m_prefetchThread)
+		return;
+	m_prefetchThread->cancel();
+	m_prefetchThread->wait();
+	delete m_prefetchThread;
+	m_prefetchThread = nullptr;
 }
 
 void PrintPreviewCreator::setAntialisingEnabled(bool enabled)
@@ -101,6 +242,14 @@ SeparationPreviewCreator::SeparationPreviewCreator(ScribusDoc* doc) :
 	}
 }
 
+void SeparationPreviewCreator::writeRenderingKey(QDataStream& keyStream) const
+{
+	keyStream << m_sepPreviewEnabled;
+	if (!m_sepPreviewEnabled)
+		return;
+	keyStream << m_showInkCoverage << m_inkCoverageThreshold << m_separationVisibilities;
+}
+
 void SeparationPreviewCreator::setSeparationPreviewEnabled(bool enabled)
 {
 	if (m_sepPreviewEnabled == enabled)
@@ -132,6 +281,82 @@ void SeparationPreviewCreator::setInkCoverageThreshold(double value)
 	m_renderingOptionsChanged = true;
 }
 
+QString SeparationPreviewCreator::previewImageFile(const QString& baseName) const
+{
+	if (m_showTransparency && m_havePngAlpha)
+		return ScPaths::tempFileDir() + "/" + baseName + ".png";
+	return ScPaths::tempFileDir() + "/" + baseName + ".tif";
+}
+
+bool SeparationPreviewCreator::loadPreviewImage(const QString& fileName, QImage& image) const
+{
+	if (!image.load(fileName))
+		return false;
+	image = image.convertToFormat(QImage::Format_ARGB32);
+	if (m_showTransparency && m_havePngAlpha)
+	{
+		int wi = image.width();
+		int hi = image.height();
+		for (int yi = 0; yi < hi; ++yi)
+		{
+			QRgb *s = (QRgb*) image.scanLine(yi);
+			for (int xi = 0; xi < wi; ++xi)
+			{
+				if ((*s) == 0xffffffff)
+					(*s) &= 0x00ffffff;
+				s++;
+			}
+		}
+	}
+	return true;
+}
+
+QPixmap SeparationPreviewCreator::finishPreview(int pageIndex, QImage& image) const
+{
+	orientPreviewImage(pageIndex, image);
+
+	QPixmap pixmap;
+	image.setDevicePixelRatio(m_devicePixelRatio);
+	if (m_showTransparency)
+	{
+		pixmap = QPixmap(image.width(), image.height());
+		pixmap.setDevicePixelRatio(m_devicePixelRatio);
+		QPainter p;
+		QBrush b(QColor(205,205,205), IconManager::instance().loadPixmap("testfill"));
+		p.begin(&pixmap);
+		p.fillRect(0, 0, image.width(), image.height(), b);
+		p.drawImage(0, 0, image);
+		p.end();
+	}
+	else
+		pixmap = QPixmap::fromImage(image);
+	pixmap.setDevicePixelRatio(m_devicePixelRatio);
+	return pixmap;
+}
+
+bool SeparationPreviewCreator::preparePrefetch(PrefetchJob& job)
+{
+	// Separations are rendered to several files with fixed names
+	if (m_sepPreviewEnabled)
+		return false;
+	QString baseName = m_tempBaseName + "_prefetch";
+	if (!createPreviewFile(job.pageIndex, baseName))
+		return false;
+	int gsRes = qRound(m_previewResolution * m_devicePixelRatio);
+	job.program = PrefsManager::instance().ghostscriptExecutable();
+	job.arguments = renderPreviewArguments(job.pageIndex, gsRes, baseName);
+	job.imageFile = previewImageFile(baseName);
+	return true;
+}
+
+QPixmap SeparationPreviewCreator::finishPrefetch(const PrefetchJob& job)
+{
+	QImage image;
+	if (!loadPreviewImage(job.imageFile, image))
+		return QPixmap();
+	return finishPreview(job.pageIndex, image);
+}
+
 void SeparationPreviewCreator::blendImages(QImage &target, ScImage &scSource, const ScColor& col)
 {
 	QImage source = scSource.qImage(); // FIXME: this will not work once qImage always returns ARGB!
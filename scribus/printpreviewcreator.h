@@ -7,6 +7,8 @@ for which a new license (GPL+exception) is in place.
 #ifndef PRINTPREVIEWCREATOR_H
 #define PRINTPREVIEWCREATOR_H
 
+#include <QByteArray>
+#include <QCache>
 #include <QMap>
 #include <QPixmap>
 #include <QStringList>
@@ -14,13 +16,15 @@ for which a new license (GPL+exception) is in place.
 #include "scribusapi.h"
 #include "scribusstructs.h"
 
+class PrintPreviewRenderThread;
+class QDataStream;
 class ScribusDoc;
 
 class SCRIBUS_API PrintPreviewCreator
 {
 public:
 	PrintPreviewCreator(ScribusDoc* doc);
-	virtual ~PrintPreviewCreator() {};
+	virtual ~PrintPreviewCreator();
 
 	/**
 	 * @brief Creates the Preview of the Actual Page
@@ -29,6 +33,24 @@ public:
 	 * @retval pixmap QPixmap print preview
 	 */
 	virtual QPixmap createPreview(int pageIndex) = 0;
+
+	/**
+	 * @brief Returns the preview of a page, reusing the pages already rendered
+	 * with the same options and document revision, or rendered by prefetch()
+	 * @param pageIndex int page number
+	 * @retval pixmap QPixmap print preview
+	 */
+	QPixmap preview(int pageIndex);
+
+	/**
+	 * @brief Starts rendering a page in background so that preview() finds it ready
+	 *
+	 * The page file is generated on the calling thread, Ghostscript runs on a
+	 * worker thread. Only one page is rendered at a time.
+	 * @retval bool true if a page is being rendered, false if pageIndex is already
+	 * available or cannot be prefetched
+	 */
+	bool prefetch(int pageIndex);
 	
 	/**
 	 * @brief If print preview is generated with Ghostscript
@@ -93,6 +115,55 @@ protected:
 
 	bool m_renderingOptionsChanged { false };
 	bool m_printOptionsChanged { true };
+
+	/**
+	 * @brief Page rendered in background by Ghostscript
+	 */
+	struct PrefetchJob
+	{
+		int pageIndex { -1 };
+		QByteArray key;
+		QString program;
+		QStringList arguments;
+		QString imageFile;
+	};
+
+	/**
+	 * @brief The page, the options and the document revision a preview depends on
+	 */
+	QByteArray previewKey(int pageIndex) const;
+
+	/**
+	 * @brief Writes the options specific to a generator to the key of previewKey()
+	 */
+	virtual void writeRenderingKey(QDataStream& /*keyStream*/) const {}
+
+	/**
+	 * @brief Writes the file of a page for a background render and fills the
+	 * Ghostscript command rendering it, returns false if the page cannot be prefetched
+	 */
+	virtual bool preparePrefetch(PrefetchJob& /*job*/) { return false; }
+
+	/**
+	 * @brief Creates the preview of a page rendered in background
+	 */
+	virtual QPixmap finishPrefetch(const PrefetchJob& /*job*/) { return QPixmap(); }
+
+	/**
+	 * @brief Stops the page being rendered in background, if any
+	 */
+	void stopPrefetch();
+
+private:
+	QCache<QByteArray, QPixmap> m_previewCache;
+	PrefetchJob m_prefetchJob;
+	PrintPreviewRenderThread* m_prefetchThread { nullptr };
+
+	void cachePreview(const QByteArray& key, const QPixmap& pixmap);
+	/**
+	 * @brief Caches the page rendered in background once done, waits for it if it has key wantedKey
+	 */
+	void collectPrefetch(const QByteArray& wantedKey);
 };
 
 class SeparationPreviewCreator : public PrintPreviewCreator
@@ -158,6 +229,47 @@ protected:
 	double m_inkCoverageThreshold { 300.0 };
 	int  m_spotColorCount { 0 };
 
+	QString m_tempBaseName; // Base name for temporary files
+
+	/**
+	 * @brief Hash of the separation options
+	 */
+	void writeRenderingKey(QDataStream& keyStream) const override;
+
+	/**
+	 * @brief Generate the file Ghostscript renders for the specified page
+	 * @param baseName base name of the generated file in the temporary directory
+	 */
+	virtual bool createPreviewFile(int pageIndex, const QString& baseName) = 0;
+
+	/**
+	 * @brief Ghostscript arguments rendering the file generated with baseName
+	 */
+	virtual QStringList renderPreviewArguments(int pageIndex, int res, const QString& baseName) = 0;
+
+	/**
+	 * @brief Image file rendered by Ghostscript for the file generated with baseName
+	 */
+	QString previewImageFile(const QString& baseName) const;
+
+	/**
+	 * @brief Load a non separated image rendered by Ghostscript
+	 */
+	bool loadPreviewImage(const QString& fileName, QImage& image) const;
+
+	/**
+	 * @brief Adapt the image rendered by Ghostscript to the orientation of the page
+	 */
+	virtual void orientPreviewImage(int /*pageIndex*/, QImage& /*image*/) const {}
+
+	/**
+	 * @brief Create the preview pixmap of a page from its rendered image
+	 */
+	QPixmap finishPreview(int pageIndex, QImage& image) const;
+
+	bool preparePrefetch(PrefetchJob& job) override;
+	QPixmap finishPrefetch(const PrefetchJob& job) override;
+
 	/**
 	 * @brief Utility functions used for blending separation images
 	 */
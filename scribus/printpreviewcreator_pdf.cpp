@@ -13,7 +13,6 @@ for which a new license (GPL+exception) is in place.
 
 #include "commonstrings.h"
 #include "cmsettings.h"
-#include "iconmanager.h"
 #include "prefsfile.h"
 #include "prefsmanager.h"
 #include "prefstable.h"
@@ -55,6 +54,7 @@ PrintPreviewCreator_PDF::~PrintPreviewCreator_PDF()
 		delete m_pdfPrintEngine;
 		m_pdfPrintEngine = nullptr;
 	}
+	stopPrefetch();
 	cleanupTemporaryFiles();
 }
 
@@ -81,7 +81,7 @@ QPixmap PrintPreviewCreator_PDF::createPreview(int pageIndex)
 	QPixmap pixmap;
 	if (m_printOptionsChanged || (m_pageIndex != pageIndex))
 	{
-		bool success = createPreviewFile(pageIndex);
+		bool success = createPreviewFile(pageIndex, m_tempBaseName);
 		if (!success)
 		{
 			imageLoadError(pixmap, pageIndex);
@@ -277,51 +277,13 @@ QPixmap PrintPreviewCreator_PDF::createPreview(int pageIndex)
 			}
 		}
 	}
-	else
+	else if (!loadPreviewImage(previewImageFile(m_tempBaseName), image))
 	{
-		QString previewFile;
-		if (m_showTransparency && m_havePngAlpha)
-			previewFile = ScPaths::tempFileDir() + "/" + m_tempBaseName + ".png";
-		else
-			previewFile = ScPaths::tempFileDir() + "/" + m_tempBaseName + ".tif";
-		if (!image.load(previewFile))
-		{
-			imageLoadError(pixmap, pageIndex);
-			return pixmap;
-		}
-		image = image.convertToFormat(QImage::Format_ARGB32);
-		if (m_showTransparency && m_havePngAlpha)
-		{
-			int wi = image.width();
-			int hi = image.height();
-			for (int yi = 0; yi < hi; ++yi)
-			{
-				QRgb *s = (QRgb*) image.scanLine(yi);
-				for (int xi = 0; xi < wi; ++xi)
-				{
-					if ((*s) == 0xffffffff)
-						(*s) &= 0x00ffffff;
-					s++;
-				}
-			}
-		}
+		imageLoadError(pixmap, pageIndex);
+		return pixmap;
 	}
 
-	image.setDevicePixelRatio(m_devicePixelRatio);
-	if (m_showTransparency)
-	{
-		pixmap = QPixmap(image.width(), image.height());
-		pixmap.setDevicePixelRatio(m_devicePixelRatio);
-		QPainter p;
-		QBrush b(QColor(205,205,205), IconManager::instance().loadPixmap("testfill"));
-		p.begin(&pixmap);
-		p.fillRect(0, 0, image.width(), image.height(), b);
-		p.drawImage(0, 0, image);
-		p.end();
-	}
-	else
-		pixmap = QPixmap::fromImage(image);
-	pixmap.setDevicePixelRatio(m_devicePixelRatio);
+	pixmap = finishPreview(pageIndex, image);
 
 	m_pageIndex = pageIndex;
 	m_printOptionsChanged = false;
@@ -330,7 +292,7 @@ QPixmap PrintPreviewCreator_PDF::createPreview(int pageIndex)
 	return pixmap;
 }
 
-bool PrintPreviewCreator_PDF::createPreviewFile(int pageIndex)
+bool PrintPreviewCreator_PDF::createPreviewFile(int pageIndex, const QString& baseName)
 {
 	std::vector<int> pageNumbers { pageIndex + 1 };
 
@@ -352,7 +314,7 @@ bool PrintPreviewCreator_PDF::createPreviewFile(int pageIndex)
 
 	// Generate PostScript
 	QString errorMessage;
-	QString pdfFileName = ScPaths::tempFileDir() + "/"  + m_tempBaseName + ".pdf";
+	QString pdfFileName = ScPaths::tempFileDir() + "/"  + baseName + ".pdf";
 
 	bool success = (m_pdfPrintEngine->createPDFFile(pdfFileName, printOptions, errorMessage) == 0);
 	return success;
@@ -360,7 +322,14 @@ bool PrintPreviewCreator_PDF::createPreviewFile(int pageIndex)
 
 int PrintPreviewCreator_PDF::renderPreview(int pageIndex, int res)
 {
-	int ret = -1;
+	if (m_sepPreviewEnabled && !m_haveTiffSep)
+		return 1;
+	QStringList args = renderPreviewArguments(pageIndex, res, m_tempBaseName);
+	return System(m_prefsManager.ghostscriptExecutable(), args);
+}
+
+QStringList PrintPreviewCreator_PDF::renderPreviewArguments(int pageIndex, int res, const QString& baseName)
+{
 	QString cmd1;
 
 	QStringList args;
@@ -375,8 +344,6 @@ int PrintPreviewCreator_PDF::renderPreview(int pageIndex, int res)
 	args.append( QString("-g%1x%2").arg(tmp2.setNum(w), tmp3.setNum(h)) );
 	if (m_sepPreviewEnabled)
 	{
-		if (!m_haveTiffSep)
-			return 1;
 		args.append( "-sDEVICE=tiffsep" );
 	}
 	else
@@ -422,18 +389,17 @@ int PrintPreviewCreator_PDF::renderPreview(int pageIndex, int res)
 	// then add any final args and call gs
 	QString tempFileDir = ScPaths::tempFileDir() ;
 	if (m_sepPreviewEnabled)
-		args.append( QString("-sOutputFile=%1").arg(QDir::toNativeSeparators(tempFileDir + "/" + m_tempBaseName + ".tif")) );
+		args.append( QString("-sOutputFile=%1").arg(QDir::toNativeSeparators(tempFileDir + "/" + baseName + ".tif")) );
 	else if (m_showTransparency && m_havePngAlpha)
-		args.append( QString("-sOutputFile=%1").arg(QDir::toNativeSeparators(tempFileDir + "/" + m_tempBaseName + ".png")) );
+		args.append( QString("-sOutputFile=%1").arg(QDir::toNativeSeparators(tempFileDir + "/" + baseName + ".png")) );
 	else
-		args.append(QString("-sOutputFile=%1").arg(QDir::toNativeSeparators(tempFileDir + "/" + m_tempBaseName + ".tif")));
-	args.append( QDir::toNativeSeparators(ScPaths::tempFileDir() + "/" + m_tempBaseName + ".pdf") );
+		args.append(QString("-sOutputFile=%1").arg(QDir::toNativeSeparators(tempFileDir + "/" + baseName + ".tif")));
+	args.append( QDir::toNativeSeparators(ScPaths::tempFileDir() + "/" + baseName + ".pdf") );
 	args.append( "-c" );
 	args.append( "showpage" );
 	args.append( "-c" );
 	args.append( "quit" );
-	ret = System(m_prefsManager.ghostscriptExecutable(), args);
-	return ret;
+	return args;
 }
 
 int PrintPreviewCreator_PDF::renderPreviewSep(int pageIndex, int res)
@@ -7,8 +7,10 @@ for which a new license (GPL+exception) is in place.
 #ifndef PRINTPREVIEWCREATOR_PDF_H
 #define PRINTPREVIEWCREATOR_PDF_H
 
+#include <QImage>
 #include <QMap>
 #include <QString>
+#include <QStringList>
 
 #include "scribusapi.h"
 #include "printpreviewcreator.h"
@@ -46,7 +48,6 @@ public:
 protected:
 	int     m_pageIndex { -1 };
 	int     m_previewRes { 72 };
-	QString m_tempBaseName; // Base name for temporary files
 
 	PrefsManager& m_prefsManager;
 	ScPrintEngine_PDF* m_pdfPrintEngine { nullptr };
@@ -55,8 +56,9 @@ protected:
 
 	/**
 	 * @Brief Generate PostScript for for specified page
+	 * @param baseName base name of the generated file in the temporary directory
 	 */
-	bool createPreviewFile(int pageIndex);
+	bool createPreviewFile(int pageIndex, const QString& baseName) override;
 
 	/**
 	 * @brief Delete generated temporary files
@@ -68,6 +70,11 @@ protected:
 	 */
 	int renderPreview(int pageIndex, int res);
 
+	/**
+	 * @brief Ghostscript arguments rendering the file generated with baseName
+	 */
+	QStringList renderPreviewArguments(int pageIndex, int res, const QString& baseName) override;
+
 	/**
 	 * @brief Render CMYK-based separation preview
 	 */
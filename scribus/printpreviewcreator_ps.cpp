@@ -14,7 +14,6 @@ for which a new license (GPL+exception) is in place.
 
 #include "commonstrings.h"
 #include "cmsettings.h"
-#include "iconmanager.h"
 #include "prefsfile.h"
 #include "prefsmanager.h"
 #include "prefstable.h"
@@ -49,6 +48,7 @@ PrintPreviewCreator_PS::PrintPreviewCreator_PS(ScribusDoc* doc) :
 
 PrintPreviewCreator_PS::~PrintPreviewCreator_PS()
 {
+	stopPrefetch();
 	cleanupTemporaryFiles();
 }
 
@@ -75,7 +75,7 @@ QPixmap PrintPreviewCreator_PS::createPreview(int pageIndex)
 	QPixmap pixmap;
 	if (m_printOptionsChanged || (m_pageIndex != pageIndex))
 	{
-		bool success = createPreviewFile(pageIndex);
+		bool success = createPreviewFile(pageIndex, m_tempBaseName);
 		if (!success)
 		{
 			imageLoadError(pixmap, pageIndex);
@@ -273,55 +273,13 @@ QPixmap PrintPreviewCreator_PS::createPreview(int pageIndex)
 			}
 		}
 	}
-	else
+	else if (!loadPreviewImage(previewImageFile(m_tempBaseName), image))
 	{
-		QString previewFile;
-		if (m_showTransparency && m_havePngAlpha)
-			previewFile = ScPaths::tempFileDir() + "/" + m_tempBaseName + ".png";
-		else
-			previewFile = ScPaths::tempFileDir() + "/" + m_tempBaseName + ".tif";
-		if (!image.load(previewFile))
-		{
-			imageLoadError(pixmap, pageIndex);
-			return pixmap;
-		}
-		image = image.convertToFormat(QImage::Format_ARGB32);
-		if (m_showTransparency && m_havePngAlpha)
-		{
-			int wi = image.width();
-			int hi = image.height();
-			for (int yi = 0; yi < hi; ++yi)
-			{
-				QRgb *s = (QRgb*) image.scanLine(yi);
-				for (int xi = 0; xi < wi; ++xi)
-				{
-					if ((*s) == 0xffffffff)
-						(*s) &= 0x00ffffff;
-					s++;
-				}
-			}
-		}
+		imageLoadError(pixmap, pageIndex);
+		return pixmap;
 	}
 
-	const ScPage* page = m_doc->Pages->at(pageIndex);
-	if ((page->orientation() == 1) && (image.width() < image.height()))
-		image = image.transformed( QTransform(0, 1, -1, 0, 0, 0) );
-
-	image.setDevicePixelRatio(m_devicePixelRatio);
-	if (m_showTransparency)
-	{
-		pixmap = QPixmap(image.width(), image.height());
-		pixmap.setDevicePixelRatio(m_devicePixelRatio);
-		QPainter p;
-		QBrush b(QColor(205,205,205), IconManager::instance().loadPixmap("testfill"));
-		p.begin(&pixmap);
-		p.fillRect(0, 0, image.width(), image.height(), b);
-		p.drawImage(0, 0, image);
-		p.end();
-	}
-	else
-		pixmap = QPixmap::fromImage(image);
-	pixmap.setDevicePixelRatio(m_devicePixelRatio);
+	pixmap = finishPreview(pageIndex, image);
 
 	m_pageIndex = pageIndex;
 	m_printOptionsChanged = false;
@@ -330,7 +288,7 @@ QPixmap PrintPreviewCreator_PS::createPreview(int pageIndex)
 	return pixmap;
 }
 
-bool PrintPreviewCreator_PS::createPreviewFile(int pageIndex)
+bool PrintPreviewCreator_PS::createPreviewFile(int pageIndex, const QString& baseName)
 {
 	std::vector<int> pageNumbers { pageIndex + 1 };
 
@@ -351,7 +309,7 @@ bool PrintPreviewCreator_PS::createPreviewFile(int pageIndex)
 	printOptions.bleeds.set(0, 0, 0, 0);
 
 	// Generate PostScript
-	QString psFileName = ScPaths::tempFileDir() + "/"  + m_tempBaseName + ".ps";
+	QString psFileName = ScPaths::tempFileDir() + "/"  + baseName + ".ps";
 	
 	PSLib *psLib = new PSLib(m_doc, printOptions, PSLib::OutputPS, &m_doc->PageColors);
 	if (!psLib)
@@ -372,7 +330,7 @@ bool PrintPreviewCreator_PS::createPreviewFile(int pageIndex)
 		opts.append( QString("-dDEVICEWIDTHPOINTS=%1").arg(QString::number(pageWidth)) );
 		opts.append( QString("-dDEVICEHEIGHTPOINTS=%1").arg(QString::number(pageHeight)) );
 
-		QString outFileName = ScPaths::tempFileDir() + "/"  + m_tempBaseName + ".ps" + QString::number((int) printOptions.prnLanguage);
+		QString outFileName = ScPaths::tempFileDir() + "/"  + baseName + ".ps" + QString::number((int) printOptions.prnLanguage);
 		success = (convertPS2PS(psFileName, outFileName, opts, (int) printOptions.prnLanguage) == 0);
 		if (!success)
 			return false;
@@ -385,7 +343,14 @@ bool PrintPreviewCreator_PS::createPreviewFile(int pageIndex)
 
 int PrintPreviewCreator_PS::renderPreview(int pageIndex, int res)
 {
-	int ret = -1;
+	if (m_sepPreviewEnabled && !m_haveTiffSep)
+		return 1;
+	QStringList args = renderPreviewArguments(pageIndex, res, m_tempBaseName);
+	return System(m_prefsManager.ghostscriptExecutable(), args);
+}
+
+QStringList PrintPreviewCreator_PS::renderPreviewArguments(int pageIndex, int res, const QString& baseName)
+{
 	QString cmd1;
 
 	QStringList args;
@@ -402,8 +367,6 @@ int PrintPreviewCreator_PS::renderPreview(int pageIndex, int res)
 	args.append( QString("-g%1x%2").arg(tmp2.setNum(w), tmp3.setNum(h)) );
 	if (m_sepPreviewEnabled)
 	{
-		if (!m_haveTiffSep)
-			return 1;
 		args.append("-sDEVICE=tiffsep");
 	}
 	else
@@ -449,18 +412,17 @@ int PrintPreviewCreator_PS::renderPreview(int pageIndex, int res)
 	// then add any final args and call gs
 	QString tempFileDir = ScPaths::tempFileDir() ;
 	if (m_sepPreviewEnabled)
-		args.append( QString("-sOutputFile=%1").arg(QDir::toNativeSeparators(tempFileDir + "/" + m_tempBaseName + ".tif")) );
+		args.append( QString("-sOutputFile=%1").arg(QDir::toNativeSeparators(tempFileDir + "/" + baseName + ".tif")) );
 	else if (m_showTransparency && m_havePngAlpha)
-		args.append( QString("-sOutputFile=%1").arg(QDir::toNativeSeparators(tempFileDir + "/" + m_tempBaseName + ".png")) );
+		args.append( QString("-sOutputFile=%1").arg(QDir::toNativeSeparators(tempFileDir + "/" + baseName + ".png")) );
 	else
-		args.append(QString("-sOutputFile=%1").arg(QDir::toNativeSeparators(tempFileDir + "/" + m_tempBaseName + ".tif")));
-	args.append( QDir::toNativeSeparators(ScPaths::tempFileDir() + "/" + m_tempBaseName + ".ps") );
+		args.append(QString("-sOutputFile=%1").arg(QDir::toNativeSeparators(tempFileDir + "/" + baseName + ".tif")));
+	args.append( QDir::toNativeSeparators(ScPaths::tempFileDir() + "/" + baseName + ".ps") );
 	args.append( "-c" );
 	args.append( "showpage" );
 	args.append( "-c" );
 	args.append( "quit" );
-	ret = System(m_prefsManager.ghostscriptExecutable(), args);
-	return ret;
+	return args;
 }
 
 int PrintPreviewCreator_PS::renderPreviewSep(int pageIndex, int res)
@@ -612,6 +574,13 @@ int PrintPreviewCreator_PS::renderPreviewSep(int pageIndex, int res)
 	return ret;
 }
 
+void PrintPreviewCreator_PS::orientPreviewImage(int pageIndex, QImage& image) const
+{
+	const ScPage* page = m_doc->Pages->at(pageIndex);
+	if ((page->orientation() == 1) && (image.width() < image.height()))
+		image = image.transformed( QTransform(0, 1, -1, 0, 0, 0) );
+}
+
 void PrintPreviewCreator_PS::setPrintOptions(const PrintOptions& options)
 {
 	m_printOptions = options;
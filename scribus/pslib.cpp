@@ -1597,6 +1597,7 @@ int PSLib::createPS(const QString& outputFileName)
 
 	if (!PS_set_file(outputFileName))
 		return 1;
+	m_Doc->loadDeferredImages(Options.pageNumbers);
 
 	std::vector<int> &pageNs = Options.pageNumbers;
 	bool outputSep = Options.outputSeparations;
@@ -0,0 +1,540 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+#include <QRect>
+#include <QRegularExpression>
+
+#include "scdatamerge.h"
+
+#include "pageitem.h"
+#include "pdflib.h"
+#include "pdfoptions.h"
+#include "prefsmanager.h"
+#include "scpainter.h"
+#include "scribusdoc.h"
+#include "text/specialchars.h"
+#include "undomanager.h"
+#include "util.h"
+
+namespace
+{
+	const QRegularExpression& placeholderPattern()
+	{
+		static const QRegularExpression pattern("\\{\\{\\s*([^{}]+?)\\s*\\}\\}");
+		return pattern;
+	}
+
+	const QString bindingAttribute("datamerge");
+}
+
+bool ScDataMergeSource::load(const QString& fileName, QString& error)
+{
+	QFile file(fileName);
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		error = QObject::tr("Cannot open %1").arg(fileName);
+		return false;
+	}
+	QByteArray data = file.readAll();
+	QFileInfo fi(fileName);
+	m_baseDir = fi.absolutePath();
+	if (fi.suffix().compare("json", Qt::CaseInsensitive) == 0)
+		return loadJson(data, error);
+	QString text = QString::fromUtf8(data);
+	if (text.startsWith(QChar(0xFEFF)))
+		text.remove(0, 1);
+	return loadCsv(text, error);
+}
+
+bool ScDataMergeSource::loadCsv(const QString& data, QString& error)
+{
+	m_fields.clear();
+	m_fieldIndex.clear();
+	m_records.clear();
+
+	// The delimiter occurring most often in the header line wins
+	QString header = data.left(data.indexOf('\n'));
+	QChar delimiter(',');
+	for (QChar c : { QChar(';'), QChar('\t') })
+	{
+		if (header.count(c) > header.count(delimiter))
+			delimiter = c;
+	}
+
+	QList<QStringList> rows;
+	QStringList row;
+	QString cell;
+	bool quoted = false;
+	for (int i = 0; i < data.length(); ++i)
+	{
+		QChar c = data.at(i);
+		if (quoted)
+		{
+			if (c != '"')
+				cell += c;
+			else if (i + 1 < data.length() && data.at(i + 1) == '"')
+			{
+				cell += c;
+				++i;
+			}
+			else
+				quoted = false;
+		}
+		else if (c == '"')
+			quoted = true;
+		else if (c == delimiter)
+		{
+			row.append(cell);
+			cell.clear();
+		}
+		else if (c == '\n' || c == '\r')
+		{
+			if (c == '\r' && i + 1 < data.length() && data.at(i + 1) == '\n')
+				++i;
+			row.append(cell);
+			cell.clear();
+			if (row.count() > 1 || !row.first().isEmpty())
+				rows.append(row);
+			row.clear();
+		}
+		else
+			cell += c;
+	}
+	if (!row.isEmpty() || !cell.isEmpty())
+	{
+		row.append(cell);
+		rows.append(row);
+	}
+
+	if (rows.isEmpty())
+	{
+		error = QObject::tr("The data file has no header line");
+		return false;
+	}
+	QStringList fields = rows.takeFirst();
+	for (QString& field : fields)
+		field = field.trimmed();
+	setFields(fields);
+	m_records = rows;
+	return true;
+}
+
+bool ScDataMergeSource::loadJson(const QByteArray& data, QString& error)
+{
+	m_fields.clear();
+	m_fieldIndex.clear();
+	m_records.clear();
+
+	QJsonParseError parseError;
+	QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
+	if (!doc.isArray())
+	{
+		error = QObject::tr("The data file is not an array of records: %1").arg(parseError.errorString());
+		return false;
+	}
+
+	// Fields are collected in order of first appearance, records
+	// lacking later fields are shorter and read as empty there
+	const QJsonArray records = doc.array();
+	QStringList fields;
+	QHash<QString, int> fieldIndex;
+	for (const QJsonValue& value : records)
+	{
+		const QJsonObject object = value.toObject();
+		QStringList record;
+		for (auto it = object.constBegin(); it != object.constEnd(); ++it)
+		{
+			int index = fieldIndex.value(it.key(), -1);
+			if (index < 0)
+			{
+				index = fields.count();
+				fields.append(it.key());
+				fieldIndex.insert(it.key(), index);
+			}
+			while (record.count() <= index)
+				record.append(QString());
+			if (!it.value().isNull())
+				record[index] = it.value().toVariant().toString();
+		}
+		m_records.append(record);
+	}
+	setFields(fields);
+	return true;
+}
+
+QString ScDataMergeSource::value(int record, const QString& field) const
+{
+	int index = m_fieldIndex.value(field, -1);
+	if (index < 0 || record < 0 || record >= m_records.count())
+		return QString();
+	const QStringList& values = m_records.at(record);
+	return (index < values.count()) ? values.at(index) : QString();
+}
+
+void ScDataMergeSource::setFields(const QStringList& fields)
+{
+	m_fields = fields;
+	m_fieldIndex.clear();
+	for (int i = 0; i < m_fields.count(); ++i)
+		m_fieldIndex.insert(m_fields.at(i), i);
+}
+
+ScDataMerge::ScDataMerge(ScribusDoc* doc, const ScDataMergeSource& source)
+	: m_doc(doc),
+	  m_source(source)
+{
+	UndoManager::instance()->setUndoEnabled(false);
+	bind();
+}
+
+ScDataMerge::~ScDataMerge()
+{
+	restore();
+	UndoManager::instance()->setUndoEnabled(true);
+}
+
+int ScDataMerge::bindingCount() const
+{
+	return m_texts.count() + m_images.count() + m_attributes.count();
+}
+
+void ScDataMerge::bind()
+{
+	// Master page items are exported once for all records, they are not bound
+	const QList<PageItem*> items = m_doc->getAllItems(m_doc->DocItems);
+	for (PageItem* item : items)
+	{
+		// Linked frames share their story, bind it on the first one
+		if ((item->isTextFrame() && !item->prevInChain()) || item->isPathText())
+		{
+			TextBinding binding;
+			binding.item = item;
+			QString text = item->itemText.text(0, item->itemText.length());
+			QRegularExpressionMatchIterator it = placeholderPattern().globalMatch(text);
+			while (it.hasNext())
+			{
+				QRegularExpressionMatch match = it.next();
+				TextField field;
+				field.field = match.captured(1);
+				field.placeholder = match.captured(0);
+				field.current = field.placeholder;
+				field.pos = match.capturedStart();
+				field.style = item->itemText.charStyle(field.pos);
+				binding.fields.append(field);
+			}
+			if (!binding.fields.isEmpty())
+				m_texts.append(binding);
+		}
+
+		const ObjAttrVector* attributes = item->getObjectAttributes();
+		bool boundAttributes = false;
+		for (const ObjectAttribute& attribute : *attributes)
+		{
+			if (attribute.name == bindingAttribute)
+			{
+				if (item->isImageFrame())
+				{
+					ImageBinding binding;
+					binding.item = item;
+					binding.field = attribute.value;
+					binding.original = item->Pfile;
+					binding.current = item->Pfile;
+					m_images.append(binding);
+				}
+			}
+			else if (attribute.value.contains(placeholderPattern()))
+				boundAttributes = true;
+		}
+		if (boundAttributes)
+		{
+			AttributeBinding binding;
+			binding.item = item;
+			binding.original = *attributes;
+			binding.current = *attributes;
+			m_attributes.append(binding);
+		}
+	}
+}
+
+QString ScDataMerge::fieldValue(int record, const QString& field) const
+{
+	QString value = m_source.value(record, field);
+	value.replace("\r\n", "\n");
+	value.replace('\n', SpecialChars::PARSEP);
+	return value;
+}
+
+QString ScDataMerge::substitute(const QString& text, int record) const
+{
+	QString result;
+	int last = 0;
+	QRegularExpressionMatchIterator it = placeholderPattern().globalMatch(text);
+	while (it.hasNext())
+	{
+		QRegularExpressionMatch match = it.next();
+		result += QStringView(text).mid(last, match.capturedStart() - last);
+		result += m_source.value(record, match.captured(1));
+		last = match.capturedEnd();
+	}
+	result += QStringView(text).mid(last);
+	return result;
+}
+
+bool ScDataMerge::setText(TextBinding& binding, const QStringList& values)
+{
+	StoryText& story = binding.item->itemText;
+	bool changed = false;
+	// Back to front, so the positions of the fields still to process stay valid
+	for (int i = binding.fields.count() - 1; i >= 0; --i)
+	{
+		TextField& field = binding.fields[i];
+		const QString& value = values.at(i);
+		if (value == field.current)
+			continue;
+		if (!field.current.isEmpty())
+			story.removeChars(field.pos, field.current.length());
+		if (!value.isEmpty())
+		{
+			story.insertChars(field.pos, value, true);
+			story.setCharStyle(field.pos, value.length(), field.style);
+		}
+		int delta = value.length() - field.current.length();
+		for (int j = i + 1; j < binding.fields.count(); ++j)
+			binding.fields[j].pos += delta;
+		field.current = value;
+		changed = true;
+	}
+	return changed;
+}
+
+void ScDataMerge::layout(PageItem* item)
+{
+	item->invalidateLayout();
+	if (!item->isPathText())
+	{
+		item->layout();
+		return;
+	}
+	// Text on paths is laid out when drawn, see ReOrderText()
+	bool wasRePos = m_doc->RePos;
+	m_doc->RePos = true;
+	QImage pgPix(10, 10, QImage::Format_ARGB32_Premultiplied);
+	QRect rd;
+	ScPainter painter(&pgPix, pgPix.width(), pgPix.height());
+	item->DrawObj(&painter, rd);
+	m_doc->RePos = wasRePos;
+}
+
+bool ScDataMerge::applyRecord(int record, QString& error)
+{
+	if (record < 0 || record >= m_source.count())
+	{
+		error = QObject::tr("There is no record %1").arg(record + 1);
+		return false;
+	}
+	m_applied = true;
+
+	for (TextBinding& binding : m_texts)
+	{
+		QStringList values;
+		for (const TextField& field : std::as_const(binding.fields))
+			values.append(fieldValue(record, field.field));
+		if (setText(binding, values))
+			layout(binding.item);
+	}
+
+	for (ImageBinding& binding : m_images)
+	{
+		QString fileName = m_source.value(record, binding.field);
+		if (!fileName.isEmpty() && QFileInfo(fileName).isRelative())
+			fileName = QDir(m_source.baseDir()).absoluteFilePath(fileName);
+		if (fileName == binding.current)
+			continue;
+		binding.current = fileName;
+		if (!m_doc->loadPict(fileName, binding.item) && !fileName.isEmpty())
+		{
+			error = QObject::tr("Cannot load image %1").arg(fileName);
+			return false;
+		}
+	}
+
+	for (AttributeBinding& binding : m_attributes)
+	{
+		ObjAttrVector attributes(binding.original);
+		bool changed = false;
+		for (int i = 0; i < attributes.count(); ++i)
+		{
+			ObjectAttribute& attribute = attributes[i];
+			if (attribute.name == bindingAttribute)
+				continue;
+			attribute.value = substitute(attribute.value, record);
+			changed |= (attribute.value != binding.current.at(i).value);
+		}
+		if (!changed)
+			continue;
+		binding.item->setObjectAttributes(&attributes);
+		binding.current = attributes;
+	}
+	return true;
+}
+
+void ScDataMerge::restore()
+{
+	if (!m_applied)
+		return;
+	for (TextBinding& binding : m_texts)
+	{
+		QStringList values;
+		for (const TextField& field : std::as_const(binding.fields))
+			values.append(field.placeholder);
+		if (setText(binding, values))
+			layout(binding.item);
+	}
+	for (ImageBinding& binding : m_images)
+	{
+		if (binding.current == binding.original)
+			continue;
+		m_doc->loadPict(binding.original, binding.item);
+		binding.current = binding.original;
+	}
+	for (AttributeBinding& binding : m_attributes)
+	{
+		binding.item->setObjectAttributes(&binding.original);
+		binding.current = binding.original;
+	}
+	m_applied = false;
+}
+
+bool ScDataMerge::checkRange(int& first, int& last, QString& error) const
+{
+	if (last < 0 || last >= m_source.count())
+		last = m_source.count() - 1;
+	first = qMax(0, first);
+	if (first > last)
+	{
+		error = QObject::tr("There are no records to export");
+		return false;
+	}
+	return true;
+}
+
+void ScDataMerge::preparePdfOptions()
+{
+	// Same font setup as PDFfile.save(), using the PDF options stored in the document
+	PDFOptions& pdfOptions = m_doc->pdfOptions();
+	m_doc->reorganiseFonts();
+	const SCFonts& availableFonts = PrefsManager::instance().appPrefs.fontPrefs.AvailFonts;
+	QStringList usedFontNames = m_doc->UsedFonts.keys();
+	if (pdfOptions.Version == PDFVersion::PDF_X1a ||
+	    pdfOptions.Version == PDFVersion::PDF_X3 ||
+	    pdfOptions.Version == PDFVersion::PDF_X4)
+	{
+		pdfOptions.FontEmbedding = PDFOptions::EmbedFonts;
+	}
+	pdfOptions.EmbedList.clear();
+	pdfOptions.SubsetList.clear();
+	pdfOptions.OutlineList.clear();
+	if (pdfOptions.FontEmbedding == PDFOptions::EmbedFonts)
+	{
+		for (const QString& fontName : std::as_const(usedFontNames))
+		{
+			const ScFace& fontFace = availableFonts[fontName];
+			if (fontFace.subset() || (fontFace.isOTF() && !pdfOptions.Version.supportsEmbeddedOpenTypeFonts()))
+				pdfOptions.SubsetList.append(fontName);
+			else
+				pdfOptions.EmbedList.append(fontName);
+		}
+	}
+	else if (pdfOptions.FontEmbedding == PDFOptions::OutlineFonts)
+		pdfOptions.OutlineList = usedFontNames;
+
+	ReOrderText(m_doc, m_doc->view());
+}
+
+std::vector<int> ScDataMerge::allPages() const
+{
+	std::vector<int> pageNs;
+	pageNs.reserve(m_doc->DocPages.count());
+	for (int i = 0; i < m_doc->DocPages.count(); ++i)
+		pageNs.push_back(i + 1);
+	return pageNs;
+}
+
+bool ScDataMerge::exportPDF(const QString& fileName, int first, int last, QString& error)
+{
+	if (!checkRange(first, last, error))
+		return false;
+	preparePdfOptions();
+
+	// Fonts are written ahead of the first page, so the glyphs needed by
+	// all records have to be known before the export starts
+	QMap<QString, QMap<uint, QString> > recordFonts;
+	if (!m_texts.isEmpty())
+	{
+		for (int record = first; record <= last; ++record)
+		{
+			if (!applyRecord(record, error))
+				return false;
+			for (const TextBinding& binding : std::as_const(m_texts))
+			{
+				for (PageItem* frame = binding.item; frame; frame = frame->nextInChain())
+					m_doc->checkItemForFonts(frame, recordFonts);
+			}
+		}
+	}
+
+	m_doc->pdfOptions().fileName = fileName;
+	PDFlib pdflib(*m_doc);
+	auto prepareRecord = [this, first, &error](int index) { return applyRecord(first + index, error); };
+	if (pdflib.doExportRecords(fileName, allPages(), last - first + 1, prepareRecord, recordFonts))
+		return true;
+	if (error.isEmpty())
+		error = QObject::tr("Cannot write the file: %1\n%2").arg(fileName, pdflib.errorMessage());
+	return false;
+}
+
+bool ScDataMerge::exportPDFs(const QString& fileNamePattern, int first, int last, QStringList& files, QString& error)
+{
+	if (!checkRange(first, last, error))
+		return false;
+	preparePdfOptions();
+
+	std::vector<int> pageNs = allPages();
+	QMap<int, QImage> thumbs;
+	if (m_doc->pdfOptions().Thumbnails)
+	{
+		QImage blank(10, 10, QImage::Format_ARGB32_Premultiplied);
+		blank.fill(Qt::white);
+		for (int pageNr : pageNs)
+			thumbs.insert(pageNr, blank);
+	}
+	for (int record = first; record <= last; ++record)
+	{
+		if (!applyRecord(record, error))
+			return false;
+		QString fileName = substitute(fileNamePattern, record);
+		if (fileName.contains("%1"))
+			fileName = fileName.arg(record + 1);
+		m_doc->pdfOptions().fileName = fileName;
+		PDFlib pdflib(*m_doc);
+		if (!pdflib.doExport(fileName, pageNs, thumbs))
+		{
+			error = QObject::tr("Cannot write the file: %1\n%2").arg(fileName, pdflib.errorMessage());
+			return false;
+		}
+		files.append(fileName);
+	}
+	return true;
+}
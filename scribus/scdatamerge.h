@@ -0,0 +1,150 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SCDATAMERGE_H
+#define SCDATAMERGE_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+#include "pagestructs.h"
+#include "scribusapi.h"
+#include "styles/charstyle.h"
+
+class PageItem;
+class ScribusDoc;
+
+/**
+  * @brief Records of a data merge, read from a CSV or JSON file
+  *
+  * CSV files start with a header line naming the fields, the delimiter is
+  * guessed from that line. JSON files contain an array of objects, each of
+  * them being one record.
+  */
+class SCRIBUS_API ScDataMergeSource
+{
+public:
+	bool load(const QString& fileName, QString& error);
+	bool loadCsv(const QString& data, QString& error);
+	bool loadJson(const QByteArray& data, QString& error);
+
+	const QStringList& fields() const { return m_fields; }
+	int count() const { return m_records.count(); }
+	/// Value of a field in a record, empty for unknown fields
+	QString value(int record, const QString& field) const;
+	/// Directory relative file names in the records are resolved against
+	const QString& baseDir() const { return m_baseDir; }
+
+private:
+	QStringList m_fields;
+	QHash<QString, int> m_fieldIndex;
+	QList<QStringList> m_records;
+	QString m_baseDir;
+
+	void setFields(const QStringList& fields);
+};
+
+/**
+  * @brief Fills a document with the records of a ScDataMergeSource and exports it
+  *
+  * Items of the document (not of master pages) are bound to fields of the
+  * source when the merge is created:
+  * - text in text frames and on paths containing {{field}} placeholders. A
+  *   placeholder is replaced by the value of the field, in the character
+  *   style of the placeholder.
+  * - image frames with an attribute named "datamerge" whose value is the
+  *   name of a field holding the image file name.
+  * - values of item attributes containing {{field}} placeholders.
+  *
+  * Switching to a record only touches the bindings whose value changes,
+  * and only the text chains of changed text are laid out again. The merge
+  * turns the document back into its original state when it is destroyed.
+  */
+class SCRIBUS_API ScDataMerge
+{
+public:
+	ScDataMerge(ScribusDoc* doc, const ScDataMergeSource& source);
+	~ScDataMerge();
+
+	ScDataMerge(const ScDataMerge&) = delete;
+	ScDataMerge& operator=(const ScDataMerge&) = delete;
+
+	/// Number of bound items
+	int bindingCount() const;
+
+	/// Sets up the document for a record
+	bool applyRecord(int record, QString& error);
+	/// Turns the document back into its original state
+	void restore();
+
+	/**
+	  * Exports records first to last to a single PDF file. The document pages
+	  * are repeated for each record, fonts, images and master pages are shared.
+	  * A negative last exports up to the last record.
+	  */
+	bool exportPDF(const QString& fileName, int first, int last, QString& error);
+	/**
+	  * Exports records first to last to one PDF file each. %1 in the file name
+	  * pattern is replaced by the record number starting at 1, {{field}}
+	  * placeholders by the values of the record.
+	  */
+	bool exportPDFs(const QString& fileNamePattern, int first, int last, QStringList& files, QString& error);
+
+	/// Replaces the {{field}} placeholders of text with the values of a record
+	QString substitute(const QString& text, int record) const;
+
+private:
+	struct TextField
+	{
+		QString field;
+		QString placeholder;
+		QString current;
+		int pos {0};
+		CharStyle style;
+	};
+
+	struct TextBinding
+	{
+		PageItem* item {nullptr};
+		QList<TextField> fields;
+	};
+
+	struct ImageBinding
+	{
+		PageItem* item {nullptr};
+		QString field;
+		QString original;
+		QString current;
+	};
+
+	struct AttributeBinding
+	{
+		PageItem* item {nullptr};
+		ObjAttrVector original;
+		ObjAttrVector current;
+	};
+
+	ScribusDoc* m_doc {nullptr};
+	const ScDataMergeSource& m_source;
+	QList<TextBinding> m_texts;
+	QList<ImageBinding> m_images;
+	QList<AttributeBinding> m_attributes;
+	bool m_applied {false};
+
+	void bind();
+	QString fieldValue(int record, const QString& field) const;
+	bool setText(TextBinding& binding, const QStringList& values);
+	void layout(PageItem* item);
+	bool checkRange(int& first, int& last, QString& error) const;
+	void preparePdfOptions();
+	std::vector<int> allPages() const;
+};
+
+#endif
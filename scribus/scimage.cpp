@@ -25,6 +25,7 @@ for which a new license (GPL+exception) is in place.
 #include "rawimage.h"
 #include "sccolorengine.h"
 #include "scimagecacheproxy.h"
+#include "scimagememorystore.h"
 #include "scstreamfilter.h"
 #include "scimage.h"
 #include "scpaths.h"
@@ -46,6 +47,7 @@ for which a new license (GPL+exception) is in place.
 #endif
 #include "imagedataloaders/scimgdataloader_ora.h"
 #include "imagedataloaders/scimgdataloader_kra.h"
+#include "imagedataloaders/scimgdataloader_memory.h"
 #include "imagedataloaders/scimgdataloader_pict.h"
 #include "imagedataloaders/scimgdataloader_pdf.h"
 #include "imagedataloaders/scimgdataloader_pgf.h"
@@ -1176,7 +1178,13 @@ bool ScImage::convert2JPG(const QString& fn, int Quality, bool isCMYK, bool isGr
 	QFile file(fn);
 	if (!file.open(QIODevice::WriteOnly))
 		return false;
+	bool success = convert2JPG(&file, Quality, isCMYK, isGray);
+	file.close();
+	return success;
+}
 
+bool ScImage::convert2JPG(QIODevice* device, int Quality, bool isCMYK, bool isGray)
+{
 	bool success = false;
 	ScJpegEncodeFilter::Color imgColor = ScJpegEncodeFilter::GRAY;
 	if (isCMYK)
@@ -1184,7 +1192,7 @@ bool ScImage::convert2JPG(const QString& fn, int Quality, bool isCMYK, bool isGr
 	else if (!isGray)
 		imgColor = ScJpegEncodeFilter::RGB;
 	int qual[] = { 95, 85, 75, 50, 25 };  // These are the JPEG Quality settings 100 means best, 0 .. don't discuss
-	QDataStream dataStream(&file);
+	QDataStream dataStream(device);
 	ScJpegEncodeFilter jpegFilter(&dataStream, width(), height(), imgColor);
 	jpegFilter.setQuality(qual[Quality]);
 	if (jpegFilter.openFilter())
@@ -1197,8 +1205,6 @@ bool ScImage::convert2JPG(const QString& fn, int Quality, bool isCMYK, bool isGr
 			success = writeRGBDataToFilter(&jpegFilter);
 		success &= jpegFilter.closeFilter();
 	}
-	file.close();
-
 	return success;
 }
 
@@ -1962,11 +1968,12 @@ bool ScImage::getAlpha(const QString& fn, int page, QByteArray& alpha, bool PDF,
 	imgInfo.PDSpathData.clear();
 	imgInfo.layerInfo.clear();
 	QFileInfo fi(fn);
-	if (!fi.exists())
+	bool inMemory = ScImageMemoryStore::instance().contains(fn);
+	if (!inMemory && !fi.exists())
 		return false;
 	alpha.resize(0);
 	QString ext = fi.suffix().toLower();
-	QString ext2 = getImageType(fn);
+	QString ext2 = inMemory ? QString() : getImageType(fn);
 	if (ext.isEmpty() || (!ext2.isEmpty() && (ext2 != ext)))
 		ext = ext2;
 	QList<QByteArray> fmtList = QImageReader::supportedImageFormats();
@@ -1979,7 +1986,11 @@ bool ScImage::getAlpha(const QString& fn, int page, QByteArray& alpha, bool PDF,
 		return true;
 	if (extensionIndicatesJPEGXL(ext))
 		return true;
-	if (extensionIndicatesPDF(ext))
+	if (inMemory)
+	{
+		pDataLoader.reset( new ScImgDataLoader_Memory() );
+	}
+	else if (extensionIndicatesPDF(ext))
 	{
 		pDataLoader.reset( new ScImgDataLoader_PDF() );
 	}
@@ -2123,6 +2134,8 @@ void ScImage::getEmbeddedProfile(const QString & fn, QByteArray *profile, int *c
 	*components = 0;
 
 	QFileInfo fi(fn);
+	if (ScImageMemoryStore::instance().contains(fn))
+		return;
 	if (!fi.exists())
 		return;
 
@@ -2249,7 +2262,8 @@ bool ScImage::loadPicture(const QString & fn, int page, const CMSettings& cmSett
 	ScColorProfile inputProf;
 
 	QFileInfo fi(fn);
-	if (!fi.exists())
+	bool inMemory = ScImageMemoryStore::instance().contains(fn);
+	if (!inMemory && !fi.exists())
 		return ret;
 	QString ext = fi.suffix().toLower();
 
@@ -2270,12 +2284,14 @@ bool ScImage::loadPicture(const QString & fn, int page, const CMSettings& cmSett
 		if (cspace != ColorSpace_Rgb && cspace != ColorSpace_Cmyk)
 			return false;
 	}
-	QString ext2 = getImageType(fn);
+	QString ext2 = inMemory ? QString() : getImageType(fn);
 	if (ext.isEmpty() || (!ext2.isEmpty() && (ext2 != ext)))
 		ext = ext2;
 
 	QScopedPointer<ScImgDataLoader> pDataLoader;
-	if (extensionIndicatesPDF(ext))
+	if (inMemory)
+		pDataLoader.reset( new ScImgDataLoader_Memory() );
+	else if (extensionIndicatesPDF(ext))
 		pDataLoader.reset( new ScImgDataLoader_PDF() );
 	else if (extensionIndicatesEPSorPS(ext))
 		pDataLoader.reset( new ScImgDataLoader_PS() );
@@ -78,6 +78,7 @@ public:
 
 	bool getAlpha(const QString& fn, int page, QByteArray& alpha, bool PDF, bool pdf14, int gsRes = 72, int scaleXSize = 0, int scaleYSize = 0);
 	bool convert2JPG(const QString& fn, int Quality, bool isCMYK, bool isGray);
+	bool convert2JPG(QIODevice* device, int Quality, bool isCMYK, bool isGray);
 
 	// Image effects
 	void applyEffect(const ScImageEffectList& effectsList, ColorList& colors, bool cmyk);
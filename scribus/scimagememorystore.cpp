@@ -0,0 +1,126 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QUuid>
+
+#include <tiffio.h>
+
+#include "scimagememorystore.h"
+
+ScImageMemoryStore& ScImageMemoryStore::instance()
+{
+	static ScImageMemoryStore store;
+	return store;
+}
+
+QString ScImageMemoryStore::add(const QImage& image, bool isCMYK, const QString& prefix)
+{
+	Entry entry;
+	entry.image = (image.format() == QImage::Format_ARGB32) ? image : image.convertToFormat(QImage::Format_ARGB32);
+	entry.isCMYK = isCMYK;
+
+	QMutexLocker locker(&m_mutex);
+	QString fileName = uniqueFileName(prefix, isCMYK ? "tif" : "png");
+	m_images.insert(fileName, entry);
+	return fileName;
+}
+
+QString ScImageMemoryStore::duplicate(const QString& path)
+{
+	QMutexLocker locker(&m_mutex);
+	auto it = m_images.constFind(key(path));
+	if (it == m_images.constEnd())
+		return QString();
+	Entry entry = it.value();
+	QString fileName = uniqueFileName("scribus_temp_", QFileInfo(path).suffix());
+	m_images.insert(fileName, entry);
+	return fileName;
+}
+
+bool ScImageMemoryStore::contains(const QString& path) const
+{
+	if (path.isEmpty())
+		return false;
+	QMutexLocker locker(&m_mutex);
+	if (m_images.isEmpty())
+		return false;
+	return m_images.contains(key(path));
+}
+
+bool ScImageMemoryStore::image(const QString& path, QImage& image, bool& isCMYK) const
+{
+	QMutexLocker locker(&m_mutex);
+	auto it = m_images.constFind(key(path));
+	if (it == m_images.constEnd())
+		return false;
+	image = it->image;
+	isCMYK = it->isCMYK;
+	return true;
+}
+
+bool ScImageMemoryStore::materialize(const QString& path)
+{
+	QMutexLocker locker(&m_mutex);
+	QString fileName = key(path);
+	auto it = m_images.find(fileName);
+	if (it == m_images.end())
+		return true;
+	bool written = it->isCMYK ? writeTiff(fileName, it->image) : it->image.save(fileName, "PNG");
+	if (written)
+		m_images.erase(it);
+	return written;
+}
+
+void ScImageMemoryStore::remove(const QString& path)
+{
+	if (path.isEmpty())
+		return;
+	QMutexLocker locker(&m_mutex);
+	m_images.remove(key(path));
+}
+
+QString ScImageMemoryStore::key(const QString& path) const
+{
+	return QDir::fromNativeSeparators(QFileInfo(path).absoluteFilePath());
+}
+
+QString ScImageMemoryStore::uniqueFileName(const QString& prefix, const QString& suffix) const
+{
+	// Names must neither collide with other stored images nor with real temporary files
+	QString tempDir = QDir::fromNativeSeparators(QFileInfo(QDir::tempPath()).absoluteFilePath());
+	QString fileName;
+	do
+	{
+		QString id = QUuid::createUuid().toString(QUuid::Id128).left(12);
+		fileName = tempDir + "/" + prefix + id + "." + suffix;
+	}
+	while (m_images.contains(fileName) || QFile::exists(fileName));
+	return fileName;
+}
+
+bool ScImageMemoryStore::writeTiff(const QString& fileName, const QImage& image) const
+{
+	TIFF* tif = TIFFOpen(fileName.toLocal8Bit().data(), "w");
+	if (!tif)
+		return false;
+	TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, image.width());
+	TIFFSetField(tif, TIFFTAG_IMAGELENGTH, image.height());
+	TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, 8);
+	TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, 4);
+	TIFFSetField(tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+	TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_SEPARATED);
+	TIFFSetField(tif, TIFFTAG_COMPRESSION, COMPRESSION_LZW);
+	bool success = true;
+	for (int y = 0; y < image.height() && success; ++y)
+		success = (TIFFWriteScanline(tif, const_cast<uchar*>(image.constScanLine(y)), y) >= 0);
+	TIFFClose(tif);
+	return success;
+}
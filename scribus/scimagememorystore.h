@@ -0,0 +1,77 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SCIMAGEMEMORYSTORE_H
+#define SCIMAGEMEMORYSTORE_H
+
+#include "scribusapi.h"
+
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QString>
+
+/**
+  * @brief Keeps decoded images in memory under a temporary file name
+  *
+  * Importers which produce images themselves (e.g. the PDF importer) register
+  * them here instead of encoding them to a temporary file and decoding that
+  * file again right away. The returned name is used as the item's Pfile and is
+  * recognized by ScImage, which loads the pixels directly from the store.
+  * The file itself is only written by materialize(), when something needs the
+  * actual file contents, e.g. when embedding the image in a saved document.
+  */
+class SCRIBUS_API ScImageMemoryStore
+{
+public:
+	static ScImageMemoryStore& instance();
+
+	/**
+	  * @brief Registers an image and returns the temporary file name it is stored under
+	  * @param image the image, in QImage::Format_ARGB32. For CMYK images each
+	  *        pixel holds the four 8 bit inks in memory byte order
+	  * @param isCMYK true if image holds CMYK data, the name will use a .tif suffix,
+	  *        a .png suffix otherwise
+	  * @param prefix prefix of the generated file name
+	  */
+	QString add(const QImage& image, bool isCMYK, const QString& prefix = QString("scribus_temp_"));
+	/**
+	  * @brief Registers a copy of the image stored under path and returns the new file name.
+	  * Returns an empty string if path is not in the store.
+	  */
+	QString duplicate(const QString& path);
+
+	bool contains(const QString& path) const;
+	bool image(const QString& path, QImage& image, bool& isCMYK) const;
+
+	/**
+	  * @brief Writes the image stored under path to disk and removes it from the store.
+	  * Returns true if path is not in the store or if the file was written successfully.
+	  */
+	bool materialize(const QString& path);
+	void remove(const QString& path);
+
+private:
+	ScImageMemoryStore() = default;
+	ScImageMemoryStore(const ScImageMemoryStore&) = delete;
+	ScImageMemoryStore& operator=(const ScImageMemoryStore&) = delete;
+
+	struct Entry
+	{
+		QImage image;
+		bool isCMYK { false };
+	};
+
+	QString key(const QString& path) const;
+	QString uniqueFileName(const QString& prefix, const QString& suffix) const;
+	bool writeTiff(const QString& fileName, const QImage& image) const;
+
+	mutable QMutex m_mutex;
+	QHash<QString, Entry> m_images;
+};
+
+#endif
@@ -719,6 +719,8 @@ void ScPageOutput::drawItem_Group(PageItem_Group* item, ScPainterExBase* painter
 void ScPageOutput::drawItem_ImageFrame(PageItem_ImageFrame* item, ScPainterExBase* painter, const QRect& clip)
 {
 	ScPainterExBase::ImageMode mode = ScPainterExBase::rgbImages;
+	if (item->imageLoadDeferred)
+		m_doc->loadDeferredImage(item);
 	if ((item->fillColor() != CommonStrings::None) || (item->GrType != 0))
 	{
 		painter->setupPolygon(&item->PoLine);
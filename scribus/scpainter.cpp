@@ -166,6 +166,14 @@ void ScPainter::setWorldMatrix(const QTransform &mat)
 	cairo_set_matrix(m_cr, &matrix);
 }
 
+double ScPainter::devicePixelRatio()
+{
+	double xScale = 1.0;
+	double yScale = 1.0;
+	cairo_surface_get_device_scale(cairo_get_target(m_cr), &xScale, &yScale);
+	return xScale;
+}
+
 void ScPainter::setAntialiasing(bool enable)
 {
 	if (enable)
@@ -1389,6 +1397,19 @@ void ScPainter::drawImage(QImage *image)
 	cairo_set_antialias(m_cr, CAIRO_ANTIALIAS_DEFAULT);
 }
 
+void ScPainter::drawDeviceImage(const QImage& image, const QPointF& pos, double opacity, int blendMode)
+{
+	cairo_surface_t *surface = cairo_image_surface_create_for_data((uchar*) image.constBits(), CAIRO_FORMAT_ARGB32, image.width(), image.height(), image.bytesPerLine());
+	cairo_surface_set_device_scale(surface, image.devicePixelRatio(), image.devicePixelRatio());
+	cairo_save(m_cr);
+	cairo_identity_matrix(m_cr);
+	cairo_set_source_surface(m_cr, surface, pos.x(), pos.y());
+	setRasterOp(blendMode);
+	cairo_paint_with_alpha(m_cr, opacity);
+	cairo_restore(m_cr);
+	cairo_surface_destroy(surface);
+}
+
 void ScPainter::setupPolygon(const FPointArray *points, bool closed)
 {
 	bool nPath = true;
@@ -52,6 +52,7 @@ public:
 	// matrix manipulation
 	virtual void setWorldMatrix(const QTransform &);
 	virtual QTransform worldMatrix();
+	virtual double devicePixelRatio();
 	virtual void setZoomFactor(double);
 	virtual double zoomFactor() { return m_zoomFactor; }
 	virtual void translate(double, double);
@@ -92,6 +93,8 @@ public:
 	virtual void setClipPath();
 
 	virtual void drawImage(QImage *image);
+	/// Paints a premultiplied ARGB image with its top left corner at pos in device coordinates, ignoring the world matrix
+	virtual void drawDeviceImage(const QImage& image, const QPointF& pos, double opacity, int blendMode);
 	virtual void setupPolygon(const FPointArray *points, bool closed = true);
 	virtual void setupSharpPolygon(const FPointArray *points, bool closed = true);
 	virtual void sharpLineHelper(FPoint &pp);
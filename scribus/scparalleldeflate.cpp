@@ -0,0 +1,308 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include "scparalleldeflate.h"
+#include "scparallelfor.h"
+
+#include <cstring>
+#include <zlib.h>
+
+#include <QThread>
+
+namespace
+{
+	void appendBigEndian32(QByteArray& out, quint32 value)
+	{
+		out.append(static_cast<char>((value >> 24) & 0xFF));
+		out.append(static_cast<char>((value >> 16) & 0xFF));
+		out.append(static_cast<char>((value >> 8) & 0xFF));
+		out.append(static_cast<char>(value & 0xFF));
+	}
+
+	void appendLittleEndian32(QByteArray& out, quint32 value)
+	{
+		out.append(static_cast<char>(value & 0xFF));
+		out.append(static_cast<char>((value >> 8) & 0xFF));
+		out.append(static_cast<char>((value >> 16) & 0xFF));
+		out.append(static_cast<char>((value >> 24) & 0xFF));
+	}
+}
+
+ScParallelDeflate::ScParallelDeflate(Format format, int level)
+	: m_format(format),
+	m_level(qBound(-1, level, 9))
+{
+	m_checksum = (m_format == GzipFormat) ? crc32(0L, Z_NULL, 0) : adler32(0L, Z_NULL, 0);
+}
+
+int ScParallelDeflate::maxBatchBlocks()
+{
+	return 2 * qMax(1, QThread::idealThreadCount());
+}
+
+void ScParallelDeflate::writeHeader()
+{
+	if (m_headerWritten)
+		return;
+	m_headerWritten = true;
+	if (m_format == GzipFormat)
+	{
+		char extraFlags = 0;
+		if (m_level == 9)
+			extraFlags = 2;
+		else if (m_level == 1)
+			extraFlags = 4;
+		const char header[10] = { '\x1f', '\x8b', 8, 0, 0, 0, 0, 0, extraFlags, 3 };
+		m_output.append(header, 10);
+		return;
+	}
+	// Same header as zlib writes for the compression level
+	char flags = '\x9c';
+	if ((m_level >= 0) && (m_level < 2))
+		flags = '\x01';
+	else if ((m_level >= 2) && (m_level < 6))
+		flags = '\x5e';
+	else if (m_level > 6)
+		flags = '\xda';
+	m_output.append('\x78');
+	m_output.append(flags);
+}
+
+bool ScParallelDeflate::write(const char* data, qint64 length)
+{
+	if (m_finished || m_failed)
+		return false;
+	writeHeader();
+	if (length <= 0)
+		return true;
+	m_pending.append(data, length);
+	m_totalIn += length;
+	if (m_pending.size() >= static_cast<qint64>(blockSize) * maxBatchBlocks())
+		return compressPending(false);
+	return true;
+}
+
+bool ScParallelDeflate::finish()
+{
+	if (m_finished)
+		return !m_failed;
+	writeHeader();
+	if (!m_failed)
+		compressPending(true);
+	m_finished = true;
+	if (m_failed)
+		return false;
+	if (m_format == GzipFormat)
+	{
+		appendLittleEndian32(m_output, m_checksum);
+		appendLittleEndian32(m_output, static_cast<quint32>(m_totalIn & 0xFFFFFFFF));
+	}
+	else
+		appendBigEndian32(m_output, m_checksum);
+	return true;
+}
+
+QByteArray ScParallelDeflate::takeOutput()
+{
+	QByteArray output;
+	output.swap(m_output);
+	return output;
+}
+
+bool ScParallelDeflate::compressPending(bool last)
+{
+	int pendingSize = m_pending.size();
+	int blockCount = pendingSize / blockSize;
+	// The last block may be partial, or empty if the input was
+	if (last && ((pendingSize % blockSize != 0) || (blockCount == 0)))
+		++blockCount;
+	if (blockCount == 0)
+		return true;
+
+	std::vector<Block> blocks(blockCount);
+	int offset = 0;
+	for (int i = 0; i < blockCount; ++i)
+	{
+		Block& block = blocks[i];
+		block.data = m_pending.constData() + offset;
+		block.length = qMin(blockSize, pendingSize - offset);
+		if (i == 0)
+		{
+			block.dictionary = m_dictionary.constData();
+			block.dictionaryLength = m_dictionary.size();
+		}
+		else
+		{
+			block.dictionary = block.data - dictionarySize;
+			block.dictionaryLength = dictionarySize;
+		}
+		block.last = last && (i == blockCount - 1);
+		offset += block.length;
+	}
+
+	compressBlocks(blocks);
+
+	for (const Block& block : blocks)
+	{
+		if (!block.success)
+		{
+			m_failed = true;
+			return false;
+		}
+		m_output.append(block.output);
+		if (m_format == GzipFormat)
+			m_checksum = crc32_combine(m_checksum, block.checksum, block.length);
+		else
+			m_checksum = adler32_combine(m_checksum, block.checksum, block.length);
+	}
+
+	// Keep the end of the consumed input to prime the next block
+	if (offset >= dictionarySize)
+		m_dictionary = m_pending.mid(offset - dictionarySize, dictionarySize);
+	else
+		m_dictionary = (m_dictionary + m_pending.left(offset)).right(dictionarySize);
+	m_pending.remove(0, offset);
+	return true;
+}
+
+void ScParallelDeflate::compressBlock(Block& block) const
+{
+	z_stream stream;
+	memset(&stream, 0, sizeof(stream));
+	block.success = false;
+	// Raw deflate, the zlib or gzip wrapper is written for the whole stream
+	if (deflateInit2(&stream, m_level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+		return;
+	if (block.dictionaryLength > 0)
+		deflateSetDictionary(&stream, reinterpret_cast<const Bytef*>(block.dictionary), block.dictionaryLength);
+
+	block.output.resize(deflateBound(&stream, block.length) + 16);
+	stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(block.data));
+	stream.avail_in = block.length;
+	stream.next_out = reinterpret_cast<Bytef*>(block.output.data());
+	stream.avail_out = block.output.size();
+
+	// Every block but the last ends on a byte boundary so that blocks can be concatenated
+	int flush = block.last ? Z_FINISH : Z_SYNC_FLUSH;
+	int ret = Z_OK;
+	while (true)
+	{
+		ret = deflate(&stream, flush);
+		if (ret == Z_STREAM_ERROR)
+			break;
+		bool done = block.last ? (ret == Z_STREAM_END) : ((stream.avail_in == 0) && (stream.avail_out != 0));
+		if (done)
+			break;
+		int used = block.output.size() - stream.avail_out;
+		block.output.resize(block.output.size() * 2);
+		stream.next_out = reinterpret_cast<Bytef*>(block.output.data()) + used;
+		stream.avail_out = block.output.size() - used;
+	}
+	block.output.resize(block.output.size() - stream.avail_out);
+	deflateEnd(&stream);
+	block.success = block.last ? (ret == Z_STREAM_END) : (ret != Z_STREAM_ERROR);
+
+	const Bytef* data = reinterpret_cast<const Bytef*>(block.data);
+	if (m_format == GzipFormat)
+		block.checksum = crc32(crc32(0L, Z_NULL, 0), data, block.length);
+	else
+		block.checksum = adler32(adler32(0L, Z_NULL, 0), data, block.length);
+}
+
+void ScParallelDeflate::compressBlocks(std::vector<Block>& blocks) const
+{
+	ScParallelFor::run(static_cast<int>(blocks.size()), [&](int index) { compressBlock(blocks[index]); });
+}
+
+QByteArray ScParallelDeflate::compress(const QByteArray& data, Format format, int level)
+{
+	ScParallelDeflate deflate(format, level);
+	if (!deflate.write(data.constData(), data.size()) || !deflate.finish())
+		return QByteArray();
+	return deflate.takeOutput();
+}
+
+ScParallelDeflateDevice::ScParallelDeflateDevice(QIODevice* device, ScParallelDeflate::Format format, int level)
+	: m_device(device),
+	m_format(format),
+	m_level(level)
+{
+}
+
+ScParallelDeflateDevice::~ScParallelDeflateDevice()
+{
+	close();
+}
+
+bool ScParallelDeflateDevice::open(OpenMode mode)
+{
+	if (isOpen() || !m_device)
+		return false;
+	if ((mode & ReadOnly) || !(mode & WriteOnly))
+	{
+		setErrorString(tr("Compressed devices can only be opened for writing"));
+		return false;
+	}
+	m_openedDevice = false;
+	if (!m_device->isOpen())
+	{
+		if (!m_device->open(mode))
+		{
+			setErrorString(m_device->errorString());
+			return false;
+		}
+		m_openedDevice = true;
+	}
+	else if (!(m_device->openMode() & WriteOnly))
+		return false;
+	m_deflate = new ScParallelDeflate(m_format, m_level);
+	return QIODevice::open(mode);
+}
+
+void ScParallelDeflateDevice::close()
+{
+	if (!isOpen())
+		return;
+	if (m_deflate)
+	{
+		m_deflate->finish();
+		flushOutput();
+		delete m_deflate;
+		m_deflate = nullptr;
+	}
+	if (m_openedDevice && m_device)
+		m_device->close();
+	m_openedDevice = false;
+	QIODevice::close();
+}
+
+qint64 ScParallelDeflateDevice::readData(char* /*data*/, qint64 /*maxSize*/)
+{
+	return -1;
+}
+
+qint64 ScParallelDeflateDevice::writeData(const char* data, qint64 maxSize)
+{
+	if (!m_deflate || !m_deflate->write(data, maxSize))
+		return -1;
+	if (!flushOutput())
+		return -1;
+	return maxSize;
+}
+
+bool ScParallelDeflateDevice::flushOutput()
+{
+	QByteArray output = m_deflate->takeOutput();
+	if (output.isEmpty())
+		return true;
+	if (!m_device || (m_device->write(output) != output.size()))
+	{
+		setErrorString(m_device ? m_device->errorString() : QString());
+		return false;
+	}
+	return true;
+}
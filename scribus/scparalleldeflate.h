@@ -0,0 +1,120 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SCPARALLELDEFLATE_H
+#define SCPARALLELDEFLATE_H
+
+#include "scribusapi.h"
+
+#include <vector>
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QPointer>
+
+/**
+  * @brief Deflate compressor spreading the work over several cores
+  *
+  * The input is cut into blocks compressed independently on worker threads,
+  * each block being primed with the last 32 KiB of the previous one so that
+  * compression ratio stays close to a single deflate stream. Every block but
+  * the last ends on a byte aligned sync flush, the compressed blocks are then
+  * simply concatenated into one zlib or gzip stream any inflater can read.
+  *
+  * Input shorter than one block is compressed on the calling thread and gives
+  * the same result as a plain deflate. The number of helper threads running
+  * at the same time is capped for the whole application, so that compressors
+  * used from several threads do not oversubscribe the processor.
+  */
+class SCRIBUS_API ScParallelDeflate
+{
+public:
+	enum Format
+	{
+		ZlibFormat,
+		GzipFormat
+	};
+
+	static constexpr int blockSize = 128 * 1024;
+	static constexpr int dictionarySize = 32 * 1024;
+
+	/// level is a zlib compression level, -1 for zlib's default
+	explicit ScParallelDeflate(Format format, int level = -1);
+
+	bool write(const char* data, qint64 length);
+	/// Compresses the remaining input and appends the stream trailer
+	bool finish();
+
+	/// Returns and clears the compressed bytes produced so far
+	QByteArray takeOutput();
+	qint64 totalIn() const { return m_totalIn; }
+
+	static QByteArray compress(const QByteArray& data, Format format, int level = -1);
+
+private:
+	struct Block
+	{
+		const char* data { nullptr };
+		int length { 0 };
+		const char* dictionary { nullptr };
+		int dictionaryLength { 0 };
+		bool last { false };
+		bool success { false };
+		quint32 checksum { 0 };
+		QByteArray output;
+	};
+
+	Format m_format { ZlibFormat };
+	int m_level { -1 };
+	bool m_headerWritten { false };
+	bool m_finished { false };
+	bool m_failed { false };
+	qint64 m_totalIn { 0 };
+	quint32 m_checksum { 0 };
+	QByteArray m_pending;
+	QByteArray m_dictionary;
+	QByteArray m_output;
+
+	void writeHeader();
+	bool compressPending(bool last);
+	void compressBlock(Block& block) const;
+	void compressBlocks(std::vector<Block>& blocks) const;
+	static int maxBatchBlocks();
+};
+
+/**
+  * @brief Write-only device compressing everything written to it with ScParallelDeflate
+  *
+  * Drop-in replacement for QtIOCompressor when writing gzip files.
+  */
+class SCRIBUS_API ScParallelDeflateDevice : public QIODevice
+{
+	Q_OBJECT
+
+public:
+	ScParallelDeflateDevice(QIODevice* device, ScParallelDeflate::Format format, int level = -1);
+	~ScParallelDeflateDevice() override;
+
+	bool open(OpenMode mode) override;
+	void close() override;
+	bool isSequential() const override { return true; }
+
+protected:
+	qint64 readData(char* data, qint64 maxSize) override;
+	qint64 writeData(const char* data, qint64 maxSize) override;
+
+private:
+	QPointer<QIODevice> m_device;
+	ScParallelDeflate::Format m_format { ScParallelDeflate::GzipFormat };
+	int m_level { -1 };
+	ScParallelDeflate* m_deflate { nullptr };
+	bool m_openedDevice { false };
+
+	bool flushOutput();
+};
+
+#endif
@@ -0,0 +1,93 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include "scparallelfor.h"
+
+#include <memory>
+#include <vector>
+
+#include <QAtomicInt>
+#include <QThread>
+
+namespace
+{
+	// Helper threads currently running, for all parallel work of the application
+	QAtomicInt activeHelpers(0);
+
+	class ScParallelForThread : public QThread
+	{
+	public:
+		explicit ScParallelForThread(const std::function<void()>& work) : m_work(work) {}
+
+	protected:
+		void run() override { m_work(); }
+
+	private:
+		std::function<void()> m_work;
+	};
+}
+
+void ScParallelFor::run(int count, const std::function<void(int)>& work)
+{
+	if (count <= 0)
+		return;
+	if (count == 1)
+	{
+		work(0);
+		return;
+	}
+
+	QAtomicInt nextIndex(0);
+	auto loop = [&]()
+	{
+		int index = nextIndex.fetchAndAddOrdered(1);
+		while (index < count)
+		{
+			work(index);
+			index = nextIndex.fetchAndAddOrdered(1);
+		}
+	};
+
+	// The calling thread works too
+	int helpers = reserveHelpers(count - 1);
+	std::vector<std::unique_ptr<QThread> > threads;
+	for (int i = 0; i < helpers; ++i)
+	{
+		threads.emplace_back(new ScParallelForThread(loop));
+		threads.back()->start();
+	}
+	loop();
+	for (auto& thread : threads)
+		thread->wait();
+	releaseHelpers(helpers);
+}
+
+int ScParallelFor::reserveHelpers(int wanted)
+{
+	const int maxCount = maxHelpers();
+	int helpers = 0;
+	while (helpers < wanted)
+	{
+		int active = activeHelpers.loadAcquire();
+		if (active >= maxCount)
+			break;
+		if (activeHelpers.testAndSetOrdered(active, active + 1))
+			++helpers;
+	}
+	return helpers;
+}
+
+void ScParallelFor::releaseHelpers(int count)
+{
+	if (count > 0)
+		activeHelpers.fetchAndSubOrdered(count);
+}
+
+int ScParallelFor::maxHelpers()
+{
+	return qMax(0, QThread::idealThreadCount() - 1);
+}
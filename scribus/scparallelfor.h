@@ -0,0 +1,43 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SCPARALLELFOR_H
+#define SCPARALLELFOR_H
+
+#include "scribusapi.h"
+
+#include <functional>
+
+/**
+  * @brief Spreads independent pieces of work over several cores
+  *
+  * The calling thread takes part in the work, helper threads are only started
+  * while cores are available. Helpers are counted for the whole application,
+  * so that work spread from several threads at once, or from a helper thread,
+  * never runs more threads than the processor has cores.
+  */
+class SCRIBUS_API ScParallelFor
+{
+public:
+	/**
+	  * @brief Calls work(index) once for each index below count, on the calling
+	  * thread and on helper threads, and returns when all calls are done
+	  */
+	static void run(int count, const std::function<void(int)>& work);
+
+	/**
+	  * @brief Reserves up to wanted helper threads for threads started by the caller,
+	  * returns the number granted, which must be given back with releaseHelpers()
+	  */
+	static int reserveHelpers(int wanted);
+	static void releaseHelpers(int count);
+
+	/// Number of helper threads which may run at the same time in the application
+	static int maxHelpers();
+};
+
+#endif
@@ -591,6 +591,16 @@ QString ScPaths::imageCacheDir()
 	return applicationDataDir() + "cache/img/";
 }
 
+QString ScPaths::pdfImageCacheDir()
+{
+	return applicationDataDir() + "cache/pdfimg/";
+}
+
+QString ScPaths::slaIndexCacheDir()
+{
+	return applicationDataDir() + "cache/slaindex/";
+}
+
 QString ScPaths::pluginDataDir(bool createIfNotExists)
 {
 	QDir useFilesDirectory(applicationDataDir() + "plugins/");
@@ -91,6 +91,10 @@ public:
 	static QString userTemplateDir(bool createIfNotExists);
 	/** @brief Return path to image cache dir*/
 	static QString imageCacheDir();
+	/** @brief Return path to the cache dir of encoded PDF image streams*/
+	static QString pdfImageCacheDir();
+	/** @brief Return path to the cache dir of SLA document indexes*/
+	static QString slaIndexCacheDir();
 	/** @brief Return path to plugin data dir*/
 	static QString pluginDataDir(bool createIfNotExists);
 	/** @brief Return path to user documents*/
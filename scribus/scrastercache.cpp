@@ -0,0 +1,67 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QMutexLocker>
+#include <QtMath>
+
+#include "scrastercache.h"
+
+ScRasterCache::ScRasterCache()
+	: m_images(64 * 1024)
+{
+}
+
+ScRasterCache& ScRasterCache::instance()
+{
+	static ScRasterCache cache;
+	return cache;
+}
+
+ScRasterCache::Placement ScRasterCache::placement(const QRectF& rect, const QTransform& matrix, double dpr)
+{
+	Placement result;
+	QRectF deviceRect = matrix.mapRect(rect);
+	int left = qFloor(deviceRect.left() * dpr);
+	int top = qFloor(deviceRect.top() * dpr);
+	result.width = qCeil(deviceRect.right() * dpr) - left + 1;
+	result.height = qCeil(deviceRect.bottom() * dpr) - top + 1;
+	result.origin = QPointF(left / dpr, top / dpr);
+	result.matrix = matrix * QTransform::fromTranslate(-result.origin.x(), -result.origin.y());
+	double phaseX = qRound(result.matrix.dx() * 16.0) / 16.0;
+	double phaseY = qRound(result.matrix.dy() * 16.0) / 16.0;
+	result.matrix *= QTransform::fromTranslate(phaseX - result.matrix.dx(), phaseY - result.matrix.dy());
+	return result;
+}
+
+bool ScRasterCache::find(const QByteArray& key, QImage& image) const
+{
+	QMutexLocker locker(&m_mutex);
+	const Entry* cached = m_images.object(key);
+	if (cached == nullptr)
+		return false;
+	image = cached->image;
+	return true;
+}
+
+void ScRasterCache::insert(const QByteArray& key, const QImage& image, const void* owner)
+{
+	qsizetype cost = qMax<qsizetype>((image.sizeInBytes() + key.size()) / 1024, 1);
+	QMutexLocker locker(&m_mutex);
+	m_images.insert(key, new Entry { image, owner }, cost);
+}
+
+void ScRasterCache::clear(const void* owner)
+{
+	QMutexLocker locker(&m_mutex);
+	const QList<QByteArray> keys = m_images.keys();
+	for (const QByteArray& key : keys)
+	{
+		const Entry* entry = m_images.object(key);
+		if (entry && (entry->owner == owner))
+			m_images.remove(key);
+	}
+}
@@ -0,0 +1,89 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SCRASTERCACHE_H
+#define SCRASTERCACHE_H
+
+#include "scribusapi.h"
+
+#include <QByteArray>
+#include <QCache>
+#include <QImage>
+#include <QMutex>
+#include <QPointF>
+#include <QRectF>
+#include <QTransform>
+
+/**
+  * @brief Keeps rasterized results of expensive item effects for reuse on later repaints
+  *
+  * Entries are addressed by a key serializing everything that influences the
+  * result (geometry, colors, zoom and device transform, effect parameters).
+  * Keys are compared in full, so an entry never goes stale: once an item
+  * changes it simply produces a new key and unused entries are evicted least
+  * recently used first. The total memory held by the cache is capped.
+  * Entries record the document they were drawn for and are dropped when it
+  * is closed.
+  *
+  * Only soft shadows of filled items, symbol content and master page items
+  * are cached. Mesh, patch mesh and diamond gradients and transparency
+  * groups are not: their output depends on item content such as text,
+  * images and group members.
+  *
+  * The cache may be used from several threads.
+  */
+class SCRIBUS_API ScRasterCache
+{
+public:
+	static ScRasterCache& instance();
+
+	/// Largest surface, in pixels, that is worth caching
+	static constexpr qint64 maxSurfacePixels = 4096 * 4096;
+
+	/**
+	  * @brief Pixel aligned surface covering an area of a painter's device
+	  *
+	  * The sub-pixel position of the area is rounded to 1/16 of a pixel so
+	  * that identical content placed at nearly the same phase, e.g. on
+	  * several pages, produces the same matrix and can share a cache entry.
+	  */
+	struct Placement
+	{
+		QTransform matrix; //!< Maps the area coordinates to surface coordinates
+		QPointF origin;    //!< Position of the surface in device independent device coordinates
+		int width { 0 };   //!< Surface width in pixels
+		int height { 0 };  //!< Surface height in pixels
+
+		bool isEmpty() const { return (width <= 0) || (height <= 0); }
+		qint64 pixelCount() const { return static_cast<qint64>(width) * height; }
+	};
+
+	/// Computes the surface covering @a rect once mapped by @a matrix on a device with pixel ratio @a dpr
+	static Placement placement(const QRectF& rect, const QTransform& matrix, double dpr);
+
+	bool find(const QByteArray& key, QImage& image) const;
+	/// Stores @a image for @a key, @a owner is the document the image was drawn for
+	void insert(const QByteArray& key, const QImage& image, const void* owner);
+	/// Removes the entries stored for document @a owner
+	void clear(const void* owner);
+
+private:
+	ScRasterCache();
+	ScRasterCache(const ScRasterCache&) = delete;
+	ScRasterCache& operator=(const ScRasterCache&) = delete;
+
+	struct Entry
+	{
+		QImage image;
+		const void* owner { nullptr };
+	};
+
+	mutable QMutex m_mutex;
+	QCache<QByteArray, Entry> m_images;
+};
+
+#endif
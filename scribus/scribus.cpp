@@ -148,6 +148,7 @@ for which a new license (GPL+exception) is in place.
 #include "scribuswin.h"
 #include "selection.h"
 #include "serializer.h"
+#include "spellcheckfunctions.h"
 #include "storyloader.h"
 #include "stylesearch.h"
 #include "textframespellchecker.h"
@@ -2700,6 +2701,9 @@ void ScribusMainWindow::HaveNewSel()
 	{
 		currItem = doc->m_Selection->itemAt(0);
 		selectedType = currItem->itemType();
+		// Image actions and properties need the image of the frame
+		if (currItem->imageLoadDeferred)
+			doc->loadDeferredImage(currItem);
 	}
 	assert (docSelectionCount == 0 || currItem != nullptr); // help coverity analysis
 
@@ -3762,6 +3766,7 @@ bool ScribusMainWindow::loadDoc(const QString& fileName)
 		doc->Last = bookmarkPalette->BView->Last;
 		if (doc->drawAsPreview)
 			view->togglePreview(true);
+		TextFrameSpellChecker::instance()->checkDocument(doc);
 	}
 	else
 	{
@@ -6676,6 +6681,8 @@ void ScribusMainWindow::slotPrefsOrg()
 	TextFrameSpellChecker* checker = TextFrameSpellChecker::instance();
 	checker->setEnabled(newPrefs.spellCheckPrefs.liveSpellCheckEnabled);
 	checker->setDebounceDelay(newPrefs.spellCheckPrefs.debounceDelay);
+	if (newPrefs.spellCheckPrefs.maxSuggestions != oldPrefs.spellCheckPrefs.maxSuggestions)
+		clearSpellWordCache();
 
 	m_prefsManager.savePrefs();
 	m_mainWindowStatusLabel->setText( tr("Ready"));
@@ -8058,6 +8065,8 @@ void ScribusMainWindow::StatusPic()
 {
 	if (!HaveDoc)
 		return;
+	// Images not loaded yet would be listed as missing
+	doc->loadDeferredImages();
 	PicStatus *dia = new PicStatus(this, doc);
 	connect(dia, SIGNAL(selectPage(int)), this, SLOT(selectPagesFromOutlines(int)));
 	connect(dia, SIGNAL(selectMasterPage(QString)), this, SLOT(editMasterPagesStart(QString)));
@@ -33,6 +33,7 @@ for which a new license (GPL+exception) is in place.
 #include <QString>
 #include <QStringList>
 #include <QTextStream>
+#include <QThread>
 #include <QTranslator>
 
 #include "scribusapp.h"
@@ -45,10 +46,12 @@ for which a new license (GPL+exception) is in place.
 #include "prefsmanager.h"
 #include "scpaths.h"
 #include "scribuscore.h"
+#include "scservicedispatcher.h"
 #include "upgradechecker.h"
 #include "util.h"
 
 #ifdef WITH_TESTS
+#include "tests/benchmarks.h"
 #include "tests/runtests.h"
 #endif
 
@@ -69,7 +72,12 @@ for which a new license (GPL+exception) is in place.
 #define ARG_PREFS "--prefs"
 #define ARG_UPGRADECHECK "--upgradecheck"
 #define ARG_TESTS "--tests"
+#define ARG_BENCHMARK "--benchmark"
 #define ARG_PYTHONSCRIPT "--python-script"
+#define ARG_SERVICE "--service"
+#define ARG_SERVICESOCKET "--service-socket"
+#define ARG_SERVICEWORKERS "--service-workers"
+#define ARG_SERVICEWORKER "--service-worker"
 #define CMD_OPTIONS_END "--"
 
 #define ARG_VERSION_SHORT "-v"
@@ -85,7 +93,11 @@ for which a new license (GPL+exception) is in place.
 #define ARG_PREFS_SHORT "-pr"
 #define ARG_UPGRADECHECK_SHORT "-u"
 #define ARG_TESTS_SHORT "-T"
+#define ARG_BENCHMARK_SHORT "-bm"
 #define ARG_PYTHONSCRIPT_SHORT "-py"
+#define ARG_SERVICE_SHORT "-sv"
+#define ARG_SERVICESOCKET_SHORT "-ss"
+#define ARG_SERVICEWORKERS_SHORT "-sw"
 
 // Qt wants -display not --display or -d
 #define ARG_DISPLAY_QT "-display"
@@ -206,6 +218,19 @@ void ScribusQApp::parseCommandLine()
 			testargsv = argv() + argi;
 			break;
 		}
+		else if (arg == ARG_BENCHMARK || arg == ARG_BENCHMARK_SHORT)
+		{
+			if (++argi < argsc)
+			{
+				m_runBenchmarks = true;
+				m_benchmarkFile = QFile::decodeName(args[argi].toLocal8Bit());
+			}
+			else
+			{
+				std::cout << tr("Option %1 requires an argument.").arg(arg).toLocal8Bit().data() << std::endl;
+				std::exit(EXIT_FAILURE);
+			}
+		}
 #endif
 		else if (arg == ARG_AVAILLANG || arg == ARG_AVAILLANG_SHORT)
 		{
@@ -234,6 +259,35 @@ void ScribusQApp::parseCommandLine()
 		{
 			useGUI = false;
 		}
+		else if (arg == ARG_SERVICE || arg == ARG_SERVICE_SHORT)
+		{
+			m_serviceMode = true;
+		}
+		else if (arg == ARG_SERVICESOCKET || arg == ARG_SERVICESOCKET_SHORT)
+		{
+			if (++argi < argsc)
+				m_serviceSocket = args[argi];
+			else
+			{
+				std::cout << tr("Option %1 requires an argument.").arg(arg).toLocal8Bit().data() << std::endl;
+				std::exit(EXIT_FAILURE);
+			}
+		}
+		else if (arg == ARG_SERVICEWORKERS || arg == ARG_SERVICEWORKERS_SHORT)
+		{
+			bool ok = false;
+			if (++argi < argsc)
+				m_serviceWorkers = args[argi].toInt(&ok);
+			if (!ok || m_serviceWorkers < 1)
+			{
+				std::cout << tr("Option %1 requires a positive number.").arg(arg).toLocal8Bit().data() << std::endl;
+				std::exit(EXIT_FAILURE);
+			}
+		}
+		else if (arg == ARG_SERVICEWORKER)
+		{
+			m_serviceWorker = true;
+		}
 		else if (arg == ARG_FONTINFO || arg == ARG_FONTINFO_SHORT)
 		{
 			m_showFontInfo = true;
@@ -308,6 +362,18 @@ void ScribusQApp::parseCommandLine()
 			m_filesToLoad.append(m_fileName);
 		}
 	}
+	// Both ends of the service run without GUI, the dispatcher does not even
+	// start the Scribus core, its workers do. So do benchmarks.
+	if (m_serviceMode || m_serviceWorker || m_runBenchmarks)
+	{
+		useGUI = false;
+		m_showSplash = false;
+	}
+	if (m_serviceMode && (m_serviceWorker || !pythonScript.isEmpty() || !m_filesToLoad.isEmpty()))
+	{
+		std::cout << tr("Option %1 cannot be combined with documents or scripts to run.").arg(ARG_SERVICE).toLocal8Bit().data() << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
 	//Init translations
 	initLang();
 	
@@ -343,6 +409,9 @@ void ScribusQApp::parseCommandLine()
 
 int ScribusQApp::init()
 {
+	if (m_serviceMode)
+		return runService();
+
 	m_ScCore = new ScribusCore();
 	Q_CHECK_PTR(m_ScCore);
 	if (!m_ScCore)
@@ -358,6 +427,11 @@ int ScribusQApp::init()
 	 */
 	// if (useGUI)
 	int retVal = ScCore->startGUI(m_showSplash, m_showFontInfo, m_showProfileInfo, m_lang);
+#ifdef WITH_TESTS
+	// Benchmarks run on a fully set up application, without startup scripts
+	if (m_runBenchmarks && retVal != EXIT_FAILURE)
+		return RunBenchmarks::runBenchmarks(m_benchmarkFile);
+#endif
 	// A hook for plugins and scripts to trigger on. Some plugins and scripts
 	// require the app to be fully set up (in particular, the main window to be
 	// built and shown) before running their setup.
@@ -366,6 +440,26 @@ int ScribusQApp::init()
 	return retVal;
 }
 
+int ScribusQApp::runService()
+{
+	QStringList workerArgs;
+	workerArgs << ARG_NOGUI << ARG_NOSPLASH << ARG_SERVICEWORKER;
+	if (!m_lang.isEmpty())
+		workerArgs << ARG_LANG << m_lang;
+	if (!m_prefsUserDir.isEmpty())
+		workerArgs << ARG_PREFS << m_prefsUserDir;
+	if (m_showFontInfo)
+		workerArgs << ARG_FONTINFO;
+	if (m_showProfileInfo)
+		workerArgs << ARG_PROFILEINFO;
+
+	int workers = (m_serviceWorkers > 0) ? m_serviceWorkers : QThread::idealThreadCount();
+	ScServiceDispatcher dispatcher(workers, m_serviceSocket, workerArgs);
+	if (!dispatcher.start())
+		return EXIT_FAILURE;
+	return exec();
+}
+
 QStringList ScribusQApp::getLang(QString lang)
 {
 	QStringList langs;
@@ -600,6 +694,9 @@ void ScribusQApp::showUsage()
 	printArgLine(ts, ARG_VERSION_SHORT, ARG_VERSION, tr("Output version information and exit") );
 	printArgLine(ts, ARG_PYTHONSCRIPT_SHORT, qPrintable(QString("%1 <%2> [%3] ").arg(ARG_PYTHONSCRIPT, tr("script"), tr("arguments ..."))), tr("Run script in Python [with optional arguments]. This option must be last option used") );
 	printArgLine(ts, ARG_NOGUI_SHORT, ARG_NOGUI, tr("Do not start GUI") );
+	printArgLine(ts, ARG_SERVICE_SHORT, ARG_SERVICE, tr("Run as a headless service processing export jobs read from stdin, one JSON object per line") );
+	printArgLine(ts, ARG_SERVICESOCKET_SHORT, qPrintable(QString("%1 <%2>").arg(ARG_SERVICESOCKET, tr("name"))), tr("Read service jobs from the local socket name instead of stdin") );
+	printArgLine(ts, ARG_SERVICEWORKERS_SHORT, qPrintable(QString("%1 <%2>").arg(ARG_SERVICEWORKERS, tr("count"))), tr("Number of worker processes of the service, defaults to the number of CPU cores") );
 	ts << (QString("     %1").arg(CMD_OPTIONS_END,-39)) << tr("Explicit end of command line options"); Qt::endl(ts);
 	
 #if defined(_WIN32) && !defined(_CONSOLE)
@@ -608,6 +705,7 @@ void ScribusQApp::showUsage()
 
 #if WITH_TESTS
 	printArgLine(ts, ARG_TESTS_SHORT, ARG_TESTS, tr("Run unit tests and exit") );
+	printArgLine(ts, ARG_BENCHMARK_SHORT, qPrintable(QString("%1 <%2>").arg(ARG_BENCHMARK, tr("file"))), tr("Run performance benchmarks, write the results as JSON to file (- for the console) and exit") );
 #endif
 
 /* Delete me?
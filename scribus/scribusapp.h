@@ -81,6 +81,8 @@ class SCRIBUS_API ScribusQApp : public QApplication
 		ScDLManager* dlManager() { return m_scDLMgr; }
 		QString pythonScript; // script to be run in python from CLI
 		QStringList pythonScriptArgs; // command line arguments and flags for script from CLI
+		//! \brief True if this process is a worker of the headless service, see ScServiceDispatcher
+		bool isServiceWorker() const { return m_serviceWorker; }
 
 	private:
 		void showHeader();
@@ -98,6 +100,11 @@ class SCRIBUS_API ScribusQApp : public QApplication
 		\brief Instantiates the Language Manager and prints installed languages with brief instructions around
 		*/
 		void showAvailLangs();
+		/*!
+		\brief Runs the headless service dispatcher until it is shut down
+		\retval int Exit code of the service
+		*/
+		int runService();
 
 		ScribusCore* m_ScCore {nullptr};
 		QString m_lang;
@@ -111,6 +118,12 @@ class SCRIBUS_API ScribusQApp : public QApplication
 		QList<QString> m_filesToLoad;
 		QString m_fileName;
 		ScDLManager *m_scDLMgr {nullptr};
+		bool m_serviceMode {false};
+		bool m_serviceWorker {false};
+		int m_serviceWorkers {0};
+		QString m_serviceSocket;
+		bool m_runBenchmarks {false};
+		QString m_benchmarkFile;
 
 	protected:
 		virtual bool event(QEvent *event);
@@ -21,6 +21,7 @@ for which a new license (GPL+exception) is in place.
  *                                                                         *
  ***************************************************************************/
 
+#include <algorithm>
 #include <cstdlib>
 #include <memory>
 #include <utility>
@@ -40,6 +41,7 @@ for which a new license (GPL+exception) is in place.
 #include <QRandomGenerator>
 #include <QRegularExpression>
 #include <QScopedValueRollback>
+#include <QSet>
 #include <QStringList>
 #include <QtAlgorithms>
 #include <QTime>
@@ -60,6 +62,7 @@ for which a new license (GPL+exception) is in place.
 #include "notesstyles.h"
 #include "numeration.h"
 #include "pageitem.h"
+#include "pageitemcloner.h"
 #include "pageitemiterator.h"
 #include "pageitem_imageframe.h"
 #include "pageitem_latexframe.h"
@@ -85,7 +88,9 @@ for which a new license (GPL+exception) is in place.
 #include "prefsmanager.h"
 #include "resourcecollection.h"
 #include "sccolorengine.h"
+#include "scimagememorystore.h"
 #include "scpage.h"
+#include "scrastercache.h"
 #include "scraction.h"
 #include "scribusXml.h"
 #include "scribuscore.h"
@@ -116,6 +121,9 @@ for which a new license (GPL+exception) is in place.
 
 // static const bool FRAMESELECTION_EDITS_DEFAULTSTYLE = false;
 
+// Number of deferred images kept loaded before those of far away pages are released
+static const int deferredImageBudget = 64;
+
 
 
 /**
@@ -469,6 +477,9 @@ void ScribusDoc::init()
 ScribusDoc::~ScribusDoc()
 {
 	m_guardedObject.nullify();
+	// Drop the rasterized effects of this document, a document created at the
+	// same address later must not find them
+	ScRasterCache::instance().clear(this);
 	CloseCMSProfiles();
 	ScCore->fileWatcher->stop();
 	ScCore->fileWatcher->removeFile(m_documentFileName);
@@ -1336,6 +1347,7 @@ void ScribusDoc::replaceStyles(const QMap<QString,QString>& newNameForOld)
 
 void ScribusDoc::replaceNamedResources(ResourceCollection& newNames)
 {
+	invalidateRenderCaches();
 	// replace names in items
 	const QList<PageItem*> * itemlist = & MasterItems;
 	while (itemlist != nullptr)
@@ -2759,6 +2771,7 @@ void ScribusDoc::deleteMasterPage(int pageNumber)
 	assert( Pages->count() > 1 && Pages->count() > pageNumber );
 	setCurrentPage(Pages->at(0));
 	ScPage* page = Pages->takeAt(pageNumber);
+	m_updateManager.cancelUpdates(page);
 	delete page;
 	// #10658 : renumber masterpages and masterpage objects
 	// in order to avoid crash after masterpage deletion
@@ -2832,6 +2845,7 @@ void ScribusDoc::deletePage(int pageNumber)
 	//#5561: If we are going to delete the first page, do not set the current page to it
 	setCurrentPage(Pages->at(pageNumber!=0?0:1));
 	ScPage* page = Pages->takeAt(pageNumber);
+	m_updateManager.cancelUpdates(page);
 	delete page;
 	reformPages();
 	changed();
@@ -3863,6 +3877,16 @@ void ScribusDoc::setGradients(const QHash<QString, VGradient> &gradients)
 {
 	docGradients.clear();
 	docGradients = gradients;
+	invalidateRenderCaches();
+
+	// Items hold a copy of their named gradients
+	QList<PageItem*> allItems = getAllItems(MasterItems);
+	allItems += getAllItems(DocItems);
+	allItems += getAllItems(FrameItems.values());
+	for (auto it = docPatterns.cbegin(); it != docPatterns.cend(); ++it)
+		allItems += getAllItems(it.value().items);
+	for (PageItem* currItem : std::as_const(allItems))
+		currItem->updateNamedGradients();
 }
 
 bool ScribusDoc::addPattern(QString &name, const ScPattern& pattern)
@@ -3910,6 +3934,7 @@ void ScribusDoc::setPatterns(const QHash<QString, ScPattern> &patterns)
 {
 	docPatterns.clear();
 	docPatterns = patterns;
+	invalidateRenderCaches();
 }
 
 QString ScribusDoc::getUniquePatternName(const QString& originalName) const
@@ -5107,6 +5132,8 @@ void ScribusDoc::recalculateColorItem(PageItem *item)
 
 void ScribusDoc::recalculateColors()
 {
+	// Colors or the color management settings changed
+	invalidateRenderCaches();
 	// #12658, #13889 : disable undo temporarily, there is nothing to cancel here
 	m_undoManager->setUndoEnabled(false);
 
@@ -5855,6 +5882,7 @@ bool ScribusDoc::loadPict(const QString& fn, PageItem *pageItem, bool reload, bo
 				ScCore->fileWatcher->removeFile(pageItem->Pfile);
 			if (pageItem->isTempFile)
 			{
+				ScImageMemoryStore::instance().remove(pageItem->Pfile);
 				QFile::remove(pageItem->Pfile);
 				pageItem->Pfile.clear();
 			}
@@ -5862,25 +5890,19 @@ bool ScribusDoc::loadPict(const QString& fn, PageItem *pageItem, bool reload, bo
 			pageItem->isTempFile = false;
 		}
 	}
+	// Images kept in memory by importers have no file to watch yet
+	bool watchFile = m_hasGUI && !reload && !ScImageMemoryStore::instance().contains(pageItem->Pfile);
 	if (!pageItem->loadImage(fn, reload, -1, showMsg))
 	{
-		if (!reload)
+		if (watchFile)
 		{
-			if (m_hasGUI)
-			{
-				QFileInfo fi(pageItem->Pfile);
-				ScCore->fileWatcher->addDir(fi.absolutePath());
-			}
+			QFileInfo fi(pageItem->Pfile);
+			ScCore->fileWatcher->addDir(fi.absolutePath());
 		}
 		return false;
 	}
-	if (!reload)
-	{
-		if (m_hasGUI)
-		{
-			ScCore->fileWatcher->addFile(pageItem->Pfile);
-		}
-	}
+	if (watchFile)
+		ScCore->fileWatcher->addFile(pageItem->Pfile);
 	if (!isLoading())
 	{
 		pageItem->update();
@@ -5891,6 +5913,183 @@ bool ScribusDoc::loadPict(const QString& fn, PageItem *pageItem, bool reload, bo
 }
 
 
+void ScribusDoc::loadItemImage(PageItem *pageItem, const QString& clipPath, bool loadLayers)
+{
+	double imageXOffset = pageItem->imageXOffset();
+	double imageYOffset = pageItem->imageYOffset();
+	QString imageProfile = pageItem->ImageProfile;
+	QString embeddedProfile = pageItem->EmbeddedProfile;
+	bool useEmbeddedProfile = pageItem->UseEmbedded;
+	loadPict(pageItem->Pfile, pageItem, false);
+	pageItem->setImageXYOffset(imageXOffset, imageYOffset);
+	pageItem->ImageProfile = imageProfile;
+	pageItem->EmbeddedProfile = embeddedProfile;
+	pageItem->UseEmbedded = useEmbeddedProfile;
+	if (pageItem->pixm.imgInfo.PDSpathData.contains(clipPath))
+	{
+		pageItem->imageClip = pageItem->pixm.imgInfo.PDSpathData[clipPath].copy();
+		pageItem->pixm.imgInfo.usedPath = clipPath;
+		QTransform cl;
+		cl.translate(pageItem->imageXOffset() * pageItem->imageXScale(), pageItem->imageYOffset() * pageItem->imageYScale());
+		cl.scale(pageItem->imageXScale(), pageItem->imageYScale());
+		pageItem->imageClip.map(cl);
+	}
+	if (loadLayers)
+	{
+		pageItem->pixm.imgInfo.isRequest = true;
+		loadPict(pageItem->Pfile, pageItem, true);
+		pageItem->setImageXYOffset(imageXOffset, imageYOffset);
+		pageItem->ImageProfile = imageProfile;
+		pageItem->EmbeddedProfile = embeddedProfile;
+		pageItem->UseEmbedded = useEmbeddedProfile;
+	}
+}
+
+bool ScribusDoc::loadDeferredImage(PageItem *pageItem)
+{
+	if (!pageItem->imageLoadDeferred)
+		return pageItem->imageIsAvailable;
+	if (m_loading)
+	{
+		pageItem->imageLoadDeferred = false;
+		loadItemImage(pageItem, pageItem->deferredImageClip, pageItem->deferredImageLayers);
+		return pageItem->imageIsAvailable;
+	}
+
+	loadReleasableImage(pageItem);
+	if (m_deferredImageItems.count() > deferredImageBudget)
+		releaseDeferredImages();
+	return pageItem->imageIsAvailable;
+}
+
+void ScribusDoc::loadDeferredImages(const std::vector<int>& pageNumbers)
+{
+	QList<PageItem*> items;
+	if (pageNumbers.empty())
+	{
+		for (PageItemIterator it(this, PageItemIterator::IterateInDocDefaults); *it; ++it)
+			items.append(*it);
+	}
+	else
+	{
+		QList<QRectF> pageRects;
+		QSet<int> pageIndexes;
+		QSet<QString> masterPageNames;
+		for (int pageNumber : pageNumbers)
+		{
+			if ((pageNumber < 1) || (pageNumber > DocPages.count()))
+				continue;
+			const ScPage* page = DocPages.at(pageNumber - 1);
+			MarginStruct bleeds;
+			getBleeds(page, bleeds);
+			pageRects.append(QRectF(page->xOffset() - bleeds.left(), page->yOffset() - bleeds.top(), page->width() + bleeds.left() + bleeds.right(), page->height() + bleeds.top() + bleeds.bottom()));
+			pageIndexes.insert(page->pageNr());
+			masterPageNames.insert(page->masterPageName());
+		}
+		for (PageItem* item : std::as_const(DocItems))
+		{
+			bool onPage = pageIndexes.contains(item->OwnPage);
+			QRectF itemRect(item->getBoundingRect());
+			for (int i = 0; (i < pageRects.count()) && !onPage; ++i)
+				onPage = pageRects.at(i).intersects(itemRect);
+			if (!onPage)
+				continue;
+			items.append(item);
+			if (item->isGroup())
+				items.append(item->getAllChildren());
+		}
+		for (PageItem* item : std::as_const(MasterItems))
+		{
+			if (!masterPageNames.contains(item->OnMasterPage))
+				continue;
+			items.append(item);
+			if (item->isGroup())
+				items.append(item->getAllChildren());
+		}
+	}
+
+	// Output needs the images of all its pages at once, none is released until the next
+	// image is loaded for display
+	for (PageItem* item : std::as_const(items))
+	{
+		if (item->imageLoadDeferred)
+			loadReleasableImage(item);
+	}
+}
+
+void ScribusDoc::loadReleasableImage(PageItem *pageItem)
+{
+	pageItem->imageLoadDeferred = false;
+	// Loading the image the document already refers to is neither an undoable action
+	// nor a modification of the document
+	{
+		UndoBlocker undoBlocker;
+		m_loading = true;
+		loadItemImage(pageItem, pageItem->deferredImageClip, pageItem->deferredImageLayers);
+		m_loading = false;
+	}
+	// Results computed while the image was missing must not be reused
+	pageItem->markChanged();
+	pageItem->deferredImageRevision = pageItem->changeRevision();
+	invalidateRenderCaches();
+	// Text flowing around the frame may follow the clipping path of the image
+	if (pageItem->textFlowAroundObject())
+	{
+		invalidateRegion(pageItem->getBoundingRect());
+		pageItem->checkTextFlowInteractions();
+	}
+	m_deferredImageItems.append(pageItem);
+}
+
+void ScribusDoc::releaseDeferredImages()
+{
+	m_deferredImageItems.removeAll(QPointer<PageItem>());
+	int currentPageNr = currentPageNumber();
+	QList<QPointer<PageItem> > candidates;
+	for (const QPointer<PageItem>& item : std::as_const(m_deferredImageItems))
+	{
+		// Modified items keep their image, it may not match the file any more
+		if (item->imageLoadDeferred || (item->changeRevision() != item->deferredImageRevision))
+			continue;
+		// Master page and inline items are drawn on many pages
+		if ((item->OwnPage < 0) || !item->OnMasterPage.isEmpty())
+			continue;
+		if (qAbs(item->OwnPage - currentPageNr) > 1)
+			candidates.append(item);
+	}
+	std::stable_sort(candidates.begin(), candidates.end(), [currentPageNr](const QPointer<PageItem>& a, const QPointer<PageItem>& b)
+	{
+		return qAbs(a->OwnPage - currentPageNr) > qAbs(b->OwnPage - currentPageNr);
+	});
+
+	for (const QPointer<PageItem>& item : std::as_const(candidates))
+	{
+		if (m_deferredImageItems.count() <= deferredImageBudget / 2)
+			break;
+		if (m_hasGUI && ScCore->fileWatcher->isWatching(item->Pfile))
+			ScCore->fileWatcher->removeFile(item->Pfile);
+		// Keep the settings read from the file, the image is loaded again with them
+		ImageInfoRecord imgInfo;
+		imgInfo.lowResType = item->pixm.imgInfo.lowResType;
+		imgInfo.actualPageNumber = item->pixm.imgInfo.actualPageNumber;
+		imgInfo.RequestProps = item->pixm.imgInfo.RequestProps;
+		imgInfo.isRequest = item->pixm.imgInfo.isRequest;
+		imgInfo.usedPath = item->pixm.imgInfo.usedPath;
+		item->pixm = ScImage();
+		item->pixm.imgInfo = imgInfo;
+		item->imageClip.resize(0);
+		item->imageIsAvailable = false;
+		item->imageLoadDeferred = true;
+		m_deferredImageItems.removeOne(item);
+		// Text flowing around the clipping path of the image flows around the frame again
+		if (item->textFlowAroundObject())
+		{
+			invalidateRegion(item->getBoundingRect());
+			item->checkTextFlowInteractions();
+		}
+	}
+}
+
 void ScribusDoc::canvasMinMax(FPoint& minPoint, FPoint& maxPoint) const
 {
 	const PageItem *currItem;
@@ -7330,6 +7529,8 @@ void ScribusDoc::copyPage(int pageNumberToCopy, int existingPage, int whereToIns
 
 	int oldItems = Items->count();
 	QList<QString> itemBuffer;
+	QList< QList<PageItem*> > itemsToClone;
+	PageItemCloner cloner(this);
 	Selection tempSelection(this, false);
 	m_Selection->clear();
 	tempSelection.delaySignalsOn();
@@ -7347,13 +7548,23 @@ void ScribusDoc::copyPage(int pageNumberToCopy, int existingPage, int whereToIns
 					if ((itemToCopy->OwnPage == from->pageNr()) && (it->ID == itemToCopy->m_layerID))
 						tempSelection.addItem(itemToCopy);
 				}
-				if (tempSelection.count() != 0)
+				QList<PageItem*> layerItems = tempSelection.items();
+				if (cloner.canClone(layerItems))
+				{
+					itemsToClone.append(layerItems);
+					itemBuffer.append(QString());
+				}
+				else if (tempSelection.count() != 0)
 				{
 					QString dataS = ScriXmlDoc::writeElem(this, &tempSelection);
+					itemsToClone.append(QList<PageItem*>());
 					itemBuffer.append(dataS);
 				}
 				else
+				{
+					itemsToClone.append(QList<PageItem*>());
 					itemBuffer.append(QString());
+				}
 				tempSelection.clear();
 			}
 			setActiveLayer(currActiveLayer);
@@ -7428,7 +7639,13 @@ void ScribusDoc::copyPage(int pageNumberToCopy, int existingPage, int whereToIns
 				this->SnapItems = false;
 				for (auto it = Layers.begin(); it != Layers.end(); ++it)
 				{
-					if ((lcount < itemBuffer.count()) && !itemBuffer[lcount].isEmpty())
+					if ((lcount < itemsToClone.count()) && !itemsToClone[lcount].isEmpty())
+					{
+						double dX = destination->xOffset() - from->xOffset();
+						double dY = destination->yOffset() - from->yOffset();
+						cloner.clone(itemsToClone[lcount], dX, dY, it->ID);
+					}
+					else if ((lcount < itemBuffer.count()) && !itemBuffer[lcount].isEmpty())
 					{
 						ScriXmlDoc ss;
 						QString fragment = itemBuffer[lcount];
@@ -10566,7 +10783,8 @@ void ScribusDoc::updatePictDir(const QString& name)
 		currItem->setImageFlippedV(fvo);
 		currItem->setImageXOffset(imgX);
 		currItem->setImageYOffset(imgY);
-		ScCore->fileWatcher->addFile(currItem->Pfile);
+		if (!ScImageMemoryStore::instance().contains(currItem->Pfile))
+			ScCore->fileWatcher->addFile(currItem->Pfile);
 		updated = true;
 	}
 
@@ -10600,7 +10818,8 @@ void ScribusDoc::updatePictDir(const QString& name)
 				currItem->setImageFlippedV(fvo);
 				currItem->setImageXOffset(imgX);
 				currItem->setImageYOffset(imgY);
-				ScCore->fileWatcher->addFile(currItem->Pfile);
+				if (!ScImageMemoryStore::instance().contains(currItem->Pfile))
+					ScCore->fileWatcher->addFile(currItem->Pfile);
 				updated = true;
 			}
 			allItems.clear();
@@ -12042,7 +12261,10 @@ void ScribusDoc::itemSelection_DeleteItem(Selection* customSelection, bool force
 		itemList->removeAll(currItem);
 //		undoManager->action(Pages->at(0), is, currItem->getUPixmap());
 		if (forceDeletion)
+		{
+			m_updateManager.cancelUpdates(currItem);
 			delete currItem;
+		}
 	}
 	itemSelection->delaySignalsOff();
 	if (activeTransaction)
@@ -12480,7 +12702,12 @@ void ScribusDoc::itemSelection_DoHyphenate()
 	for (int i = 0; i < selectedItemCount; ++i)
 	{
 		PageItem *currItem = m_Selection->itemAt(i);
-		docHyphenator->slotHyphenate(currItem);
+		// Whole stories do not need user interaction in automatic mode,
+		// hyphenate them in background so that long stories do not block the UI
+		if (hyphAutomatic() && currItem->isTextFrame() && !currItem->itemText.hasSelection())
+			docHyphenator->slotHyphenateStory(currItem);
+		else
+			docHyphenator->slotHyphenate(currItem);
 	}
 	//FIXME: stop using m_View
 	m_View->DrawNew(); //CB draw new until NLS for redraw through text chains
@@ -13874,6 +14101,11 @@ void ScribusDoc::itemSelection_SwapRight()
 
 void ScribusDoc::changed()
 {
+	++m_contentRevision;
+	// Palettes edit the selected items, some without an undo action, so
+	// mark them for incremental saving here
+	for (int i = 0; i < m_Selection->count(); ++i)
+		m_Selection->itemAt(i)->markChanged();
 	setModified(true);
 	// Do not emit docChanged signal() unnecessarily
 	// Processing of that signal is slowwwwwww and
@@ -13886,6 +14118,11 @@ void ScribusDoc::changed()
 	emit docChanged();
 }
 
+void ScribusDoc::invalidateRenderCaches()
+{
+	++m_contentRevision;
+}
+
 void ScribusDoc::changedPagePreview()
 {
 	emit pagePreviewChanged();
@@ -14240,14 +14477,21 @@ void ScribusDoc::itemSelection_MultipleDuplicate(const ItemMultipleDuplicateData
 				dV2 += selection.height();
 		}
 		ScriXmlDoc ss;
-		QString BufferS = ScriXmlDoc::writeElem(this, &selection);
+		PageItemCloner cloner(this);
+		bool nativeClone = cloner.canClone(selectedItems);
+		QString BufferS;
+		if (!nativeClone)
+			BufferS = ScriXmlDoc::writeElem(this, &selection);
 		//FIXME: stop using m_View
 		Selection tempSelection(nullptr, false);
 		m_View->deselectItems(true);
 		for (int i = 0; i < mdData.copyCount; ++i)
 		{
 			int oldItemCount = Items->count();
-			ss.readElem(BufferS, this, m_currentPage->xOffset(), m_currentPage->yOffset(), false, true);
+			if (nativeClone)
+				cloner.clone(selectedItems, 0.0, 0.0, activeLayer());
+			else
+				ss.readElem(BufferS, this, m_currentPage->xOffset(), m_currentPage->yOffset(), false, true);
 			tempSelection.delaySignalsOn();
 			for (int j = oldItemCount; j < Items->count(); ++j)
 			{
@@ -14293,7 +14537,11 @@ void ScribusDoc::itemSelection_MultipleDuplicate(const ItemMultipleDuplicateData
 		double dX = mdData.gridGapH / m_docUnitRatio + selection.width();
 		double dY = mdData.gridGapV / m_docUnitRatio + selection.height();
 		ScriXmlDoc ss;
-		QString BufferS = ScriXmlDoc::writeElem(this, &selection);
+		PageItemCloner cloner(this);
+		bool nativeClone = cloner.canClone(selectedItems);
+		QString BufferS;
+		if (!nativeClone)
+			BufferS = ScriXmlDoc::writeElem(this, &selection);
 		for (int i = 0; i < mdData.gridRows; ++i) //skip 0, the item is the one we are copying
 		{
 			for (int j = 0; j < mdData.gridCols; ++j) //skip 0, the item is the one we are copying
@@ -14302,7 +14550,10 @@ void ScribusDoc::itemSelection_MultipleDuplicate(const ItemMultipleDuplicateData
 				if (i == 0 && j == 0)
 					continue;
 				uint ac = Items->count();
-				ss.readElem(BufferS, this, m_currentPage->xOffset(), m_currentPage->yOffset(), false, true);
+				if (nativeClone)
+					cloner.clone(selectedItems, 0.0, 0.0, activeLayer());
+				else
+					ss.readElem(BufferS, this, m_currentPage->xOffset(), m_currentPage->yOffset(), false, true);
 				for (int as = ac; as < Items->count(); ++as)
 				{
 					PageItem* bItem = Items->at(as);
@@ -14415,15 +14666,25 @@ void ScribusDoc::multipleDuplicateByPage(const ItemMultipleDuplicateData& dialog
 
 	ScPage* oldCurrentPage = currentPage();
 	ScriXmlDoc xmlStream;
-	QString buffer = ScriXmlDoc::writeElem(this, &selection);
+	PageItemCloner cloner(this);
+	QList<PageItem*> selectedItems = selection.items();
+	bool nativeClone = cloner.canClone(selectedItems);
+	QString buffer;
+	if (!nativeClone)
+		buffer = ScriXmlDoc::writeElem(this, &selection);
 	for (const auto page: pages)
 	{
 		if (currPageNumber == page - 1)
 			continue;
 		ScPage* targetPage = Pages->at(page - 1);
+		double dX = targetPage->xOffset() - oldCurrentPage->xOffset();
+		double dY = targetPage->yOffset() - oldCurrentPage->yOffset();
 		setCurrentPage(targetPage);
 		int countBeforeInsert = Items->count();
-		xmlStream.readElem(buffer, this, currentPage()->xOffset(), currentPage()->yOffset(), false, true);
+		if (nativeClone)
+			cloner.clone(selectedItems, dX, dY, activeLayer());
+		else
+			xmlStream.readElem(buffer, this, currentPage()->xOffset(), currentPage()->yOffset(), false, true);
 		if (!lastInChain)
 			continue;
 		for (int i = countBeforeInsert; i < Items->count(); ++i)
@@ -14734,12 +14995,13 @@ void ScribusDoc::getClosestElementBorder(double xin, double yin, double *xout, d
 	const PageItem *parentI = nullptr;
 	if (!m_Selection->isEmpty())
 		parentI = m_Selection->itemAt(0)->Parent;
+	int pageNumber = OnPage(xin, yin);
 
 	for (int i = 0; i < items.size(); ++i)
 	{
-		if ((behavior == ExcludeSelection) && m_Selection->containsItem(items.at(i)))
+		if (items.at(i)->OwnPage != pageNumber)
 			continue;
-		if (items.at(i)->OwnPage != OnPage(xin, yin))
+		if ((behavior == ExcludeSelection) && m_Selection->containsItem(items.at(i)))
 			continue;
 		if (items.at(i)->Parent != parentI)
 			continue;
@@ -16110,7 +16372,10 @@ void ScribusDoc::itemSelection_UnGroupObjects(Selection* customSelection)
 		if (currItem->isWelded())
 			currItem->unWeld();
 		if (!UndoManager::undoEnabled() && !isUndoRedoOngoing())
+		{
+			m_updateManager.cancelUpdates(currItem);
 			delete currItem;
+		}
 	}
 
 	if (activeTransaction)
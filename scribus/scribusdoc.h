@@ -35,11 +35,14 @@ for which a new license (GPL+exception) is in place.
 #include <QMap>
 #include <QObject>
 #include <QPixmap>
+#include <QPointer>
 #include <QRectF>
 #include <QStringList>
 #include <QTimer>
 #include <QUuid>
 
+#include <vector>
+
 #include "appmodes.h"
 #include "gtgettext.h" //CB For the ImportSetup struct and itemadduserframe
 #include "scribusapi.h"
@@ -959,6 +962,31 @@ class SCRIBUS_API ScribusDoc : public QObject, public UndoObject, public Observa
 		 * @return
 		 */
 		bool loadPict(const QString& fn, PageItem *pageItem, bool reload = false, bool showMsg = false);
+		/**
+		 * \brief Loads the image of an item read from a document file
+		 * The image offsets and profiles read from the file are kept, and the clipping path
+		 * and layer settings read from the file are applied.
+		 * @param pageItem the item
+		 * @param clipPath name of the clipping path of the image to use, empty if none
+		 * @param loadLayers true to load the image again with the requested layers
+		 */
+		void loadItemImage(PageItem *pageItem, const QString& clipPath, bool loadLayers);
+		/**
+		 * \brief Loads the image of an item whose loading was deferred when the document was opened
+		 * Deferred images are loaded when their frame is drawn. Once more than a few dozens of them
+		 * are loaded, those of the pages farthest from the current page which were not modified
+		 * since are released again.
+		 * @param pageItem the item
+		 * @return true if the image of the item is available
+		 */
+		bool loadDeferredImage(PageItem *pageItem);
+		/**
+		 * \brief Loads the deferred images output needs at once
+		 * The items stay on the list of images released again when the next images are loaded for display.
+		 * @param pageNumbers numbers of the output pages, counted from 1, whose items and master page
+		 * items are loaded; empty to load every image of the document, as checks of all items need
+		 */
+		void loadDeferredImages(const std::vector<int>& pageNumbers = std::vector<int>());
 		/**
 		 * \brief Handle image with color profiles
 		 * @param Pr profile
@@ -1278,6 +1306,12 @@ class SCRIBUS_API ScribusDoc : public QObject, public UndoObject, public Observa
 		 */
 		void changed();
 		void changedPagePreview();
+		/*! \brief Counter incremented by changed() and invalidateRenderCaches(), render caches use it to detect stale content */
+		quint64 contentRevision() const { return m_contentRevision; }
+		/*! \brief Tells render caches that the rendering changed without the document being modified,
+		 *  e.g. after loading a deferred image or redefining named colors and gradients
+		 */
+		void invalidateRenderCaches();
 		/*! \brief Get pointer to the current page
 		\retval	Page* current page object */
 		ScPage* currentPage();
@@ -1357,6 +1391,7 @@ class SCRIBUS_API ScribusDoc : public QObject, public UndoObject, public Observa
 		UndoManager * const m_undoManager;
 		bool m_loading {false};
 		bool m_modified {false};
+		quint64 m_contentRevision {0};
 		int  m_undoRedoOngoing {0};
 		int m_ActiveLayer {0};
 		double m_docUnitRatio;
@@ -1379,6 +1414,11 @@ class SCRIBUS_API ScribusDoc : public QObject, public UndoObject, public Observa
 		int m_currentEditedIFrame {0};
 		QString m_documentFileName;
 		QUuid m_uuid;
+		//! Items whose deferred image was loaded, oldest first
+		QList<QPointer<PageItem> > m_deferredImageItems;
+
+		void loadReleasableImage(PageItem *pageItem);
+		void releaseDeferredImages();
 
 	public: // Public attributes
 		int NrItems {0};
@@ -1510,7 +1510,7 @@ bool ScribusView::slotSetCurs(int x, int y)
 		table->moveTo(table->cellAt(tablePoint));
 		textFrame = table->activeCell().textFrame();
 		mm = textFrame->getTransform();
-		canvasPoint = table->getTransform().inverted().map(tablePoint) - table->gridOffset();
+		canvasPoint = table->getInverseTransform().map(tablePoint) - table->gridOffset();
 	}
 	else if (item->isImageFrame())
 		return true;
@@ -0,0 +1,410 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <iostream>
+
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTimer>
+
+#if defined(Q_OS_WIN32)
+#include <windows.h>
+#else
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+#include "scservicedispatcher.h"
+
+namespace
+{
+	/// Waits at most @a timeout ms for stdin to become readable, returns false on timeout
+	bool waitForInput(int timeout)
+	{
+#if defined(Q_OS_WIN32)
+		HANDLE input = GetStdHandle(STD_INPUT_HANDLE);
+		if (GetFileType(input) == FILE_TYPE_PIPE)
+		{
+			DWORD available = 0;
+			// A failure means the pipe was closed, the next read reports it
+			if (!PeekNamedPipe(input, nullptr, 0, nullptr, &available, nullptr) || (available > 0))
+				return true;
+			Sleep(timeout);
+			return false;
+		}
+		if (GetFileType(input) == FILE_TYPE_CHAR)
+			return WaitForSingleObject(input, timeout) == WAIT_OBJECT_0;
+		return true;
+#else
+		pollfd input { STDIN_FILENO, POLLIN, 0 };
+		return poll(&input, 1, timeout) != 0;
+#endif
+	}
+
+	/// Reads what is available on stdin, returns 0 at the end of input and -1 on error
+	qint64 readInput(char* buffer, qint64 size)
+	{
+#if defined(Q_OS_WIN32)
+		DWORD count = 0;
+		if (!ReadFile(GetStdHandle(STD_INPUT_HANDLE), buffer, static_cast<DWORD>(size), &count, nullptr))
+			return -1;
+		return count;
+#else
+		return read(STDIN_FILENO, buffer, size);
+#endif
+	}
+}
+
+ScServiceInputThread::ScServiceInputThread(QObject* parent) : QThread(parent)
+{
+}
+
+void ScServiceInputThread::run()
+{
+	// Wait with a timeout instead of blocking in read so that the thread
+	// notices an interruption request when the service is shut down
+	QByteArray pending;
+	char buffer[4096];
+	while (!isInterruptionRequested())
+	{
+		if (!waitForInput(100))
+			continue;
+		qint64 count = readInput(buffer, sizeof(buffer));
+		if (count <= 0)
+			break;
+		pending.append(buffer, count);
+		int end;
+		while ((end = pending.indexOf('\n')) >= 0)
+		{
+			emit lineRead(pending.left(end));
+			pending.remove(0, end + 1);
+		}
+	}
+	if (isInterruptionRequested())
+		return;
+	if (!pending.isEmpty())
+		emit lineRead(pending);
+	emit inputClosed();
+}
+
+ScServiceDispatcher::ScServiceDispatcher(int workerCount, const QString& socketName, const QStringList& workerArguments, QObject* parent)
+	: QObject(parent),
+	  m_workerCount(qMax(1, workerCount)),
+	  m_socketName(socketName),
+	  m_workerArguments(workerArguments)
+{
+}
+
+ScServiceDispatcher::~ScServiceDispatcher()
+{
+	// The input thread may still be waiting for input if the service was
+	// shut down by a command
+	if (m_input && m_input->isRunning())
+	{
+		m_input->requestInterruption();
+		m_input->wait();
+	}
+	for (const Worker& worker : std::as_const(m_workers))
+	{
+		if (!worker.process)
+			continue;
+		worker.process->disconnect(this);
+		worker.process->closeWriteChannel();
+		if (!worker.process->waitForFinished(5000))
+			worker.process->kill();
+	}
+}
+
+bool ScServiceDispatcher::start()
+{
+	if (!m_socketName.isEmpty())
+	{
+		m_server = new QLocalServer(this);
+		QLocalServer::removeServer(m_socketName);
+		if (!m_server->listen(m_socketName))
+		{
+			std::cerr << tr("Cannot listen on %1: %2").arg(m_socketName, m_server->errorString()).toLocal8Bit().data() << std::endl;
+			return false;
+		}
+		connect(m_server, &QLocalServer::newConnection, this, &ScServiceDispatcher::newConnection);
+	}
+
+	for (int i = 0; i < m_workerCount; ++i)
+	{
+		m_workers.append(Worker());
+		startWorker(i);
+	}
+
+	if (!m_server)
+	{
+		m_input = new ScServiceInputThread(this);
+		connect(m_input, &ScServiceInputThread::lineRead, this, &ScServiceDispatcher::readStdin);
+		connect(m_input, &ScServiceInputThread::inputClosed, this, &ScServiceDispatcher::stdinClosed);
+		m_input->start();
+	}
+	return true;
+}
+
+void ScServiceDispatcher::startWorker(int index)
+{
+	auto* process = new QProcess(this);
+	process->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+	connect(process, &QProcess::readyReadStandardOutput, this, [this, index]() { handleWorkerOutput(index); });
+	connect(process, &QProcess::finished, this, [this, index]() { handleWorkerExit(index); });
+	connect(process, &QProcess::errorOccurred, this, [process](QProcess::ProcessError error) {
+		if (error != QProcess::FailedToStart)
+			return;
+		std::cerr << tr("Cannot start service worker: %1").arg(process->errorString()).toLocal8Bit().data() << std::endl;
+		QCoreApplication::exit(EXIT_FAILURE);
+	});
+
+	Worker& worker = m_workers[index];
+	worker.process = process;
+	worker.output.clear();
+	worker.busy = false;
+	process->start(QCoreApplication::applicationFilePath(), m_workerArguments);
+}
+
+void ScServiceDispatcher::readStdin(const QByteArray& line)
+{
+	handleRequest(line, nullptr);
+}
+
+void ScServiceDispatcher::stdinClosed()
+{
+	m_shuttingDown = true;
+	finishIfIdle();
+}
+
+void ScServiceDispatcher::newConnection()
+{
+	while (m_server->hasPendingConnections())
+	{
+		QLocalSocket* client = m_server->nextPendingConnection();
+		connect(client, &QLocalSocket::readyRead, this, [this, client]() {
+			while (client->canReadLine())
+				handleRequest(client->readLine(), client);
+		});
+		connect(client, &QLocalSocket::disconnected, client, &QObject::deleteLater);
+	}
+}
+
+void ScServiceDispatcher::handleRequest(const QByteArray& line, QLocalSocket* client)
+{
+	QByteArray data = line.trimmed();
+	if (data.isEmpty())
+		return;
+
+	Job job;
+	job.client = client;
+	job.fromSocket = (client != nullptr);
+	job.queued.start();
+
+	QJsonParseError parseError;
+	QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
+	if (!doc.isObject())
+	{
+		QJsonObject response;
+		response["ok"] = false;
+		response["error"] = tr("Invalid job: %1").arg(parseError.errorString());
+		respond(job, response);
+		return;
+	}
+	job.request = doc.object();
+
+	if (job.request.value("command").toString() == "shutdown")
+	{
+		m_shuttingDown = true;
+		finishIfIdle();
+		return;
+	}
+
+	QString error;
+	if (m_shuttingDown)
+		error = tr("The service is shutting down");
+	else if (!hasWorkers())
+		error = tr("No service worker is running");
+	else if (job.request.value("document").toString().isEmpty())
+		error = tr("The job does not name a document");
+	if (!error.isEmpty())
+	{
+		QJsonObject response;
+		response["ok"] = false;
+		response["error"] = error;
+		respond(job, response);
+		return;
+	}
+
+	m_queue.enqueue(job);
+	dispatch();
+}
+
+void ScServiceDispatcher::dispatch()
+{
+	for (Worker& worker : m_workers)
+	{
+		if (m_queue.isEmpty())
+			break;
+		if (worker.busy || !worker.process || worker.process->state() == QProcess::NotRunning)
+			continue;
+		worker.job = m_queue.dequeue();
+		worker.job.waited = worker.job.queued.elapsed();
+		worker.busy = true;
+		worker.process->write(QJsonDocument(worker.job.request).toJson(QJsonDocument::Compact) + '\n');
+	}
+}
+
+void ScServiceDispatcher::handleWorkerOutput(int index)
+{
+	Worker& worker = m_workers[index];
+	if (!worker.process)
+		return;
+	worker.output += worker.process->readAllStandardOutput();
+
+	int end;
+	while ((end = worker.output.indexOf('\n')) >= 0)
+	{
+		QByteArray line = worker.output.left(end);
+		worker.output.remove(0, end + 1);
+		if (line.isEmpty())
+			continue;
+		if (!line.startsWith(resultMarker()))
+		{
+			// Output of scripts and of Scribus itself, keep it out of the responses
+			std::cerr << "[worker " << index << "] " << line.constData() << std::endl;
+			continue;
+		}
+		if (!worker.busy)
+			continue;
+		QJsonObject response = QJsonDocument::fromJson(line.mid(resultMarker().length())).object();
+		response["worker"] = index;
+		worker.busy = false;
+		// The worker is usable, restart it again should it exit later
+		worker.restarts = 0;
+		respond(worker.job, response);
+	}
+	dispatch();
+	finishIfIdle();
+}
+
+void ScServiceDispatcher::handleWorkerExit(int index)
+{
+	Worker& worker = m_workers[index];
+	worker.process->deleteLater();
+	worker.process = nullptr;
+	if (worker.busy)
+	{
+		worker.busy = false;
+		QJsonObject response;
+		response["ok"] = false;
+		response["error"] = tr("The worker process exited while processing the job");
+		response["worker"] = index;
+		respond(worker.job, response);
+	}
+
+	if (m_stopping)
+	{
+		for (const Worker& w : std::as_const(m_workers))
+		{
+			if (w.process)
+				return;
+		}
+		QCoreApplication::exit(EXIT_SUCCESS);
+		return;
+	}
+
+	// Replace the lost worker so the remaining jobs still get processed.
+	// A worker that keeps exiting, e.g. because it crashes on start up, is
+	// restarted after growing delays and given up after a few attempts.
+	if (worker.restarts >= maxWorkerRestarts)
+	{
+		worker.retired = true;
+		std::cerr << tr("Service worker %1 keeps exiting, it is not restarted any more").arg(index).toLocal8Bit().data() << std::endl;
+		if (!hasWorkers())
+			failQueuedJobs(tr("No service worker is running"));
+		finishIfIdle();
+		return;
+	}
+	const int delay = 250 << worker.restarts;
+	++worker.restarts;
+	QTimer::singleShot(delay, this, [this, index]() {
+		if (m_stopping)
+			return;
+		startWorker(index);
+		dispatch();
+	});
+	dispatch();
+	finishIfIdle();
+}
+
+bool ScServiceDispatcher::hasWorkers() const
+{
+	for (const Worker& worker : std::as_const(m_workers))
+	{
+		if (!worker.retired)
+			return true;
+	}
+	return false;
+}
+
+void ScServiceDispatcher::failQueuedJobs(const QString& error)
+{
+	while (!m_queue.isEmpty())
+	{
+		QJsonObject response;
+		response["ok"] = false;
+		response["error"] = error;
+		respond(m_queue.dequeue(), response);
+	}
+}
+
+void ScServiceDispatcher::respond(const Job& job, QJsonObject response)
+{
+	if (!response.contains("id") && job.request.contains("id"))
+		response["id"] = job.request.value("id");
+	QJsonObject timings = response.value("timings").toObject();
+	timings["queue"] = job.waited;
+	timings["service"] = job.queued.elapsed();
+	response["timings"] = timings;
+
+	QByteArray data = QJsonDocument(response).toJson(QJsonDocument::Compact);
+	if (job.fromSocket)
+	{
+		// Nobody left to tell if the client went away in the meantime
+		if (job.client)
+			job.client->write(data + '\n');
+		return;
+	}
+	std::cout << data.constData() << std::endl;
+}
+
+void ScServiceDispatcher::finishIfIdle()
+{
+	if (!m_shuttingDown || m_stopping || !m_queue.isEmpty())
+		return;
+	for (const Worker& worker : std::as_const(m_workers))
+	{
+		if (worker.busy)
+			return;
+	}
+
+	// Workers leave their job loop at the end of their input
+	m_stopping = true;
+	bool running = false;
+	for (const Worker& worker : std::as_const(m_workers))
+	{
+		if (!worker.process)
+			continue;
+		worker.process->closeWriteChannel();
+		running = true;
+	}
+	if (!running)
+		QCoreApplication::exit(EXIT_SUCCESS);
+}
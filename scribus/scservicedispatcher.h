@@ -0,0 +1,138 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SCSERVICEDISPATCHER_H
+#define SCSERVICEDISPATCHER_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QProcess>
+#include <QQueue>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+
+#include "scribusapi.h"
+
+class QLocalServer;
+class QLocalSocket;
+
+/**
+  * @brief Reads job lines from the standard input of the service
+  *
+  * Reading stdin blocks, so it is done on its own thread. Every line is
+  * handed to the dispatcher through a queued signal. The thread waits for
+  * input with a timeout and stops once interruption is requested.
+  */
+class ScServiceInputThread : public QThread
+{
+	Q_OBJECT
+
+public:
+	explicit ScServiceInputThread(QObject* parent = nullptr);
+
+protected:
+	void run() override;
+
+signals:
+	void lineRead(const QByteArray& line);
+	void inputClosed();
+};
+
+/**
+  * @brief Headless render and export service (--service)
+  *
+  * The dispatcher accepts jobs as JSON objects, one per line, either on its
+  * standard input or on a local socket, and hands them to a pool of worker
+  * processes. Each worker is Scribus started with --service-worker: it loads
+  * fonts, colour profiles and plugins once and then processes jobs one after
+  * the other, so these stay warm for the lifetime of the service. A job opens
+  * a document, optionally runs a script on it, exports it to PDF and/or PNG
+  * and closes it again:
+  *
+  * {"id": "1", "document": "in.sla", "script": "fill.py", "args": ["x"],
+  *  "pdf": "out.pdf", "png": "out-%1.png", "dpi": 150}
+  *
+  * A job with a "data" file runs a data merge (see ScDataMerge) instead of
+  * the plain PDF export. It writes records "first" to "last" to the "pdf"
+  * file, or to one file per record if "merged" is false. Splitting the
+  * records of a large merge over several jobs spreads it over the workers.
+  *
+  * Every job gets exactly one response line on the channel it came from,
+  * with the job id, "ok", an "error" message on failure, the produced files
+  * and the time spent in each step in milliseconds. {"command": "shutdown"}
+  * stops the service once all queued jobs are done, as does the end of the
+  * standard input when jobs are read from there.
+  */
+class SCRIBUS_API ScServiceDispatcher : public QObject
+{
+	Q_OBJECT
+
+public:
+	ScServiceDispatcher(int workerCount, const QString& socketName, const QStringList& workerArguments, QObject* parent = nullptr);
+	~ScServiceDispatcher();
+
+	/// Starts the workers and begins to accept jobs
+	bool start();
+
+	/// Prefix of the lines a worker writes its job results on, other output lines are logged
+	static QByteArray resultMarker() { return QByteArrayLiteral("@scribus-service "); }
+
+private:
+	struct Job
+	{
+		QJsonObject request;
+		QPointer<QLocalSocket> client;
+		bool fromSocket {false};
+		QElapsedTimer queued;
+		qint64 waited {0};
+	};
+
+	struct Worker
+	{
+		QProcess* process {nullptr};
+		QByteArray output;
+		Job job;
+		bool busy {false};
+		int restarts {0};      ///< Restarts since the worker last finished a job
+		bool retired {false};  ///< Exited too often, not restarted any more
+	};
+
+	/// Restarts of a worker that exits without finishing a job before it is given up
+	static constexpr int maxWorkerRestarts = 5;
+
+	int m_workerCount {1};
+	QString m_socketName;
+	QStringList m_workerArguments;
+	QList<Worker> m_workers;
+	QQueue<Job> m_queue;
+	QLocalServer* m_server {nullptr};
+	ScServiceInputThread* m_input {nullptr};
+	bool m_shuttingDown {false};
+	bool m_stopping {false};
+
+	void startWorker(int index);
+	void handleRequest(const QByteArray& line, QLocalSocket* client);
+	void handleWorkerOutput(int index);
+	void handleWorkerExit(int index);
+	bool hasWorkers() const;
+	void failQueuedJobs(const QString& error);
+	void dispatch();
+	void respond(const Job& job, QJsonObject response);
+	void finishIfIdle();
+
+private slots:
+	void readStdin(const QByteArray& line);
+	void stdinClosed();
+	void newConnection();
+};
+
+#endif
@@ -10,13 +10,14 @@ for which a new license (GPL+exception) is in place.
 
 #include "scstreamfilter.h"
 
-struct ScFlateEncodeFilterData;
+class ScParallelDeflate;
 
 class ScFlateEncodeFilter : public ScStreamFilter
 {
 public:
-	ScFlateEncodeFilter(QDataStream* stream);
-	ScFlateEncodeFilter(ScStreamFilter* filter);
+	/// level is a zlib compression level, -1 for zlib's default
+	ScFlateEncodeFilter(QDataStream* stream, int level = -1);
+	ScFlateEncodeFilter(ScStreamFilter* filter, int level = -1);
 	~ScFlateEncodeFilter() override;
 
 	bool openFilter() override;
@@ -26,11 +27,12 @@ public:
 
 protected:
 	bool m_openedFilter { false };
-	ScFlateEncodeFilterData* m_filterData { nullptr };
+	int  m_level { -1 };
+	ScParallelDeflate* m_deflate { nullptr };
 
 	void freeData();
 
-	bool writeDeflate(bool flush);
+	bool writeDeflated();
 };
 
 #endif
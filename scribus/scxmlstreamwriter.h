@@ -11,6 +11,7 @@ for which a new license (GPL+exception) is in place.
 
 #include <QByteArray>
 #include <QString>
+#include <QXmlStreamReader>
 #include <QXmlStreamWriter>
 
 #include "pdfversion.h"
@@ -32,6 +33,19 @@ public:
 
 	template<typename T, std::enable_if_t< std::is_floating_point_v<T>, bool> = true>
 	void writeAttribute(const QString & name, T value) { QXmlStreamWriter::writeAttribute(name, QString::number(value, 'g', 15)); }
+
+	/// Copies the elements of well-formed XML serialized earlier, whitespace between elements is left to auto-formatting
+	void writeXmlFragment(const QString& xml)
+	{
+		QXmlStreamReader reader(xml);
+		while (!reader.atEnd())
+		{
+			reader.readNext();
+			if (reader.isStartDocument() || reader.isEndDocument() || reader.isWhitespace())
+				continue;
+			writeCurrentToken(reader);
+		}
+	}
 };
 
 #endif
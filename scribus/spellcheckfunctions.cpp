@@ -13,7 +13,9 @@
 #include "spellcheckfunctions.h"
 #include "textframespellchecker.h"
 #include <hunspell/hunspell.hxx>
+#include <QCache>
 #include <QFile>
+#include <QHash>
 #include <QMap>
 #include <QMutex>
 #include <QRegularExpression>
@@ -139,6 +141,112 @@ class HunspellManager
 		QMutex m_mutex;
 };
 
+// ============================================================================
+// Helper: per language word cache
+// ============================================================================
+
+class SpellWordCache
+{
+	public:
+		struct WordEntry
+		{
+			bool correct {true};
+			bool hasSuggestions {false};
+			QStringList suggestions;
+		};
+
+		static SpellWordCache* instance()
+		{
+			static SpellWordCache cache;
+			return &cache;
+		}
+
+		// Returns false if the word has not been looked up yet
+		bool isCorrect(const QString& language, const QString& word, bool& correct)
+		{
+			QMutexLocker locker(&m_mutex);
+			const WordEntry* entry = languageCache(language)->object(word);
+			if (!entry)
+				return false;
+			correct = entry->correct;
+			return true;
+		}
+
+		void setCorrect(const QString& language, const QString& word, bool correct)
+		{
+			QMutexLocker locker(&m_mutex);
+			QCache<QString, WordEntry>* cache = languageCache(language);
+			WordEntry* entry = cache->object(word);
+			if (entry)
+			{
+				entry->correct = correct;
+				return;
+			}
+			entry = new WordEntry;
+			entry->correct = correct;
+			cache->insert(word, entry);
+		}
+
+		// Returns false if no suggestions have been computed for the word yet
+		bool suggestions(const QString& language, const QString& word, QStringList& result)
+		{
+			QMutexLocker locker(&m_mutex);
+			const WordEntry* entry = languageCache(language)->object(word);
+			if (!entry || !entry->hasSuggestions)
+				return false;
+			result = entry->suggestions;
+			return true;
+		}
+
+		void setSuggestions(const QString& language, const QString& word, const QStringList& suggestions)
+		{
+			QMutexLocker locker(&m_mutex);
+			QCache<QString, WordEntry>* cache = languageCache(language);
+			WordEntry* entry = cache->object(word);
+			if (!entry)
+			{
+				entry = new WordEntry;
+				entry->correct = false;
+				cache->insert(word, entry);
+			}
+			entry->hasSuggestions = true;
+			entry->suggestions = suggestions;
+		}
+
+		void clear()
+		{
+			QMutexLocker locker(&m_mutex);
+			for (QCache<QString, WordEntry>* cache : std::as_const(m_caches))
+				cache->clear();
+		}
+
+		~SpellWordCache()
+		{
+			qDeleteAll(m_caches);
+		}
+
+	private:
+		QCache<QString, WordEntry>* languageCache(const QString& language)
+		{
+			QCache<QString, WordEntry>* cache = m_caches.value(language, nullptr);
+			if (!cache)
+			{
+				cache = new QCache<QString, WordEntry>(maxWords);
+				m_caches.insert(language, cache);
+			}
+			return cache;
+		}
+
+		QHash<QString, QCache<QString, WordEntry>*> m_caches;
+		QMutex m_mutex;
+		static constexpr int maxWords {20000};
+};
+
+void clearSpellWordCache()
+{
+	SpellWordCache::instance()->clear();
+}
+
 // ============================================================================
 // Main Spell Check Function
 // ============================================================================
@@ -152,22 +260,29 @@ QVector<SpellError> performSpellCheck(const StoryTextSnapshot& snapshot)
 
 	// Process each paragraph
 	for (int paraIndex = 0; paraIndex < snapshot.paragraphCount(); ++paraIndex)
-	{
-		// Get language runs for this paragraph
-		QVector<LanguageRun> runs = snapshot.getLanguageRunsForParagraph(paraIndex);
+		errors.append(performSpellCheckParagraph(snapshot, paraIndex));
 
-		// Check each language run separately
-		for (const LanguageRun& run : runs)
-		{
-			if (run.language.isEmpty())
-				continue; // Skip runs with no language set
+	return errors;
+}
+
+QVector<SpellError> performSpellCheckParagraph(const StoryTextSnapshot& snapshot, int paraIndex)
+{
+	QVector<SpellError> errors;
 
-			// Extract text for this language run
-			QString text = snapshot.plainText.mid(run.start, run.length);
-			QVector<SpellError> runErrors = checkTextInLanguage(text, run.language, run.start);
+	// Get language runs for this paragraph
+	const QVector<LanguageRun> runs = snapshot.getLanguageRunsForParagraph(paraIndex);
 
-			errors.append(runErrors);
-		}
+	// Check each language run separately
+	for (const LanguageRun& run : runs)
+	{
+		if (run.language.isEmpty())
+			continue; // Skip runs with no language set
+
+		// Extract text for this language run
+		QString text = snapshot.plainText.mid(run.start, run.length);
+		QVector<SpellError> runErrors = checkTextInLanguage(text, run.language, run.start);
+
+		errors.append(runErrors);
 	}
 
 	return errors;
@@ -190,6 +305,8 @@ QVector<SpellError> checkTextInLanguage(const QString& text, const QString& lang
 	if (!entry)
 		return errors;
 
+	SpellWordCache* wordCache = SpellWordCache::instance();
+
 	// int wordCount = 0;
 	// int misspelledCount = 0;
 
@@ -203,9 +320,15 @@ QVector<SpellError> checkTextInLanguage(const QString& text, const QString& lang
 			continue;
 
 		// wordCount++;
-		// Encode word in the dictionary's native encoding before passing to Hunspell
-		QByteArray encoded = entry->encoder.encode(word);
-		if (!entry->hunspell->spell(encoded.toStdString()))
+		bool correct = true;
+		if (!wordCache->isCorrect(language, word, correct))
+		{
+			// Encode word in the dictionary's native encoding before passing to Hunspell
+			QByteArray encoded = entry->encoder.encode(word);
+			correct = entry->hunspell->spell(encoded.toStdString());
+			wordCache->setCorrect(language, word, correct);
+		}
+		if (!correct)
 		{
 			// misspelledCount++;
 			SpellError error;
@@ -227,6 +350,10 @@ QVector<SpellError> checkTextInLanguage(const QString& text, const QString& lang
 
 QStringList getSpellingSuggestions(const QString& word, const QString& language)
 {
+	QStringList result;
+	if (SpellWordCache::instance()->suggestions(language, word, result))
+		return result;
+
 	HunspellManager::DictEntry* entry = HunspellManager::instance()->getDictEntry(language);
 	if (!entry)
 		return QStringList();
@@ -236,10 +363,10 @@ QStringList getSpellingSuggestions(const QString& word, const QString& language)
 	QByteArray encoded = entry->encoder.encode(word);
 	const std::vector<std::string> suggestions = entry->hunspell->suggest(encoded.toStdString());
 
-	QStringList result;
 	result.reserve(qMin((int)suggestions.size(), maxSuggestions));
 	for (size_t i = 0; i < suggestions.size() && i < (size_t)maxSuggestions; ++i)
 		result << entry->decoder.decode(QByteArray::fromStdString(suggestions[i]));
 
+	SpellWordCache::instance()->setSuggestions(language, word, result);
 	return result;
 }
\ No newline at end of file
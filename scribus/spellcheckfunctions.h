@@ -41,6 +41,17 @@ struct SpellError;
  */
 QVector<SpellError> performSpellCheck(const StoryTextSnapshot& snapshot);
 
+/**
+ * @brief Perform spell checking on a single paragraph of a text snapshot
+ * 
+ * @param snapshot Immutable text snapshot to check
+ * @param paraIndex Index of the paragraph to check
+ * @return Vector of spelling errors found, positions relative to the snapshot text
+ * 
+ * @note This function can be safely called from any thread
+ */
+QVector<SpellError> performSpellCheckParagraph(const StoryTextSnapshot& snapshot, int paraIndex);
+
 /**
  * @brief Check a single text string in a specific language
  * 
@@ -71,4 +82,12 @@ bool isWordMisspelled(const QString& word, const QString& language);
  */
 QStringList getSpellingSuggestions(const QString& word, const QString& language);
 
+/**
+ * @brief Forget all cached dictionary lookups and suggestions
+ * 
+ * Results of dictionary lookups and suggestion requests are kept in a
+ * least recently used cache shared by all frames.
+ */
+void clearSpellWordCache();
+
 #endif // SPELLCHECKFUNCTIONS_H
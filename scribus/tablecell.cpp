@@ -45,6 +45,36 @@ TableCell::TableCell(int row, int column, PageItem_Table *table) : d(new TableCe
 	setColumnSpan(1);
 }
 
+TableCell TableCell::copyFor(PageItem_Table *table) const
+{
+	Q_ASSERT(table);
+	TableCell cell;
+	cell.d->isValid = d->isValid;
+	cell.d->row = d->row;
+	cell.d->column = d->column;
+	cell.d->rowSpan = d->rowSpan;
+	cell.d->columnSpan = d->columnSpan;
+	cell.d->userStyleName = d->userStyleName;
+	cell.d->table = table;
+
+	cell.d->style = d->style;
+	cell.d->style.setContext(&table->doc()->cellStyles());
+
+	if (d->textFrame)
+	{
+		// The copy constructor shares the story with the original frame
+		cell.d->textFrame = new PageItem_TextFrame(*d->textFrame);
+		cell.d->textFrame->itemText = d->textFrame->itemText.copy();
+		cell.d->textFrame->Parent = table;
+		cell.d->textFrame->OwnPage = table->OwnPage;
+		cell.d->textFrame->OnMasterPage = table->OnMasterPage;
+		cell.d->textFrame->m_layerID = table->m_layerID;
+		cell.d->textFrame->setIsTableCellTextFrame(true);
+		cell.d->textFrame->invalidateLayout(false);
+	}
+	return cell;
+}
+
 QRectF TableCell::boundingRect() const
 {
 	if (!isValid())
@@ -191,9 +221,32 @@ void TableCell::updateContent()
 	contentRect.setWidth(qMax(contentRect.width() - (rightPadding() + maxRightBorderWidth()/2), 1.0));
 	contentRect.setHeight(qMax(contentRect.height() - (bottomPadding() + maxBottomBorderWidth()/2), 1.0));
 
-	d->textFrame->setXYPos(contentRect.x(), contentRect.y(), true);
-	d->textFrame->setWidthHeight(contentRect.width(), contentRect.height(), true);
-	d->textFrame->updateClip();
+	// Moving a cell leaves its text layout valid, only a new content size or
+	// new frame settings require a relayout. Text edits invalidate the frame
+	// through its story.
+	if (d->textFrame->xPos() != contentRect.x() || d->textFrame->yPos() != contentRect.y())
+		d->textFrame->setXYPos(contentRect.x(), contentRect.y(), true);
+
+	TableCellData::LayoutSettings settings;
+	settings.width = contentRect.width();
+	settings.height = contentRect.height();
+	settings.columns = d->textFrame->columns();
+	settings.columnGap = d->textFrame->columnGap();
+	settings.left = d->textFrame->textToFrameDistLeft();
+	settings.right = d->textFrame->textToFrameDistRight();
+	settings.top = d->textFrame->textToFrameDistTop();
+	settings.bottom = d->textFrame->textToFrameDistBottom();
+	settings.verticalAlignment = d->textFrame->verticalAlignment();
+	settings.firstLineOffset = static_cast<int>(d->textFrame->firstLineOffset());
+	if (settings == d->layoutSettings)
+		return;
+	d->layoutSettings = settings;
+
+	if (d->textFrame->width() != contentRect.width() || d->textFrame->height() != contentRect.height())
+	{
+		d->textFrame->setWidthHeight(contentRect.width(), contentRect.height(), true);
+		d->textFrame->updateClip();
+	}
 	d->textFrame->invalidateLayout(false);
 }
 
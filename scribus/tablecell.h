@@ -44,6 +44,7 @@ public:
 		style(other.style),
 		userStyleName(other.userStyleName),
 		appliedParagraphStyleName(other.appliedParagraphStyleName),
+		layoutSettings(other.layoutSettings),
 		table(other.table) {}
 	/// Destroys the cell data.
 	~TableCellData()
@@ -75,6 +76,32 @@ public:
 	/// style, used to avoid redundant setDefaultStyle() calls on relayout.
 	/// Transient layout state; not saved.
 	QString appliedParagraphStyleName;
+	/// Text frame settings the cell text was last laid out with, used to
+	/// relayout only cells whose content size or frame settings changed.
+	/// Transient layout state; not saved.
+	struct LayoutSettings
+	{
+		double width {-1.0};
+		double height {-1.0};
+		int columns {-1};
+		double columnGap {0.0};
+		double left {0.0};
+		double right {0.0};
+		double top {0.0};
+		double bottom {0.0};
+		int verticalAlignment {0};
+		int firstLineOffset {0};
+
+		bool operator==(const LayoutSettings& other) const
+		{
+			return width == other.width && height == other.height &&
+				columns == other.columns && columnGap == other.columnGap &&
+				left == other.left && right == other.right &&
+				top == other.top && bottom == other.bottom &&
+				verticalAlignment == other.verticalAlignment &&
+				firstLineOffset == other.firstLineOffset;
+		}
+	} layoutSettings;
 	/// Table containing the cell.
 	PageItem_Table *table {nullptr};
 };
@@ -226,6 +253,12 @@ private:
 	 */
 	TableCell(int row, int column, PageItem_Table *table);
 
+	/**
+	 * Returns a copy of this cell for the table @a table, which is a copy of the table
+	 * containing this cell. The copy gets its own copy of the cell text frame and story.
+	 */
+	TableCell copyFor(PageItem_Table *table) const;
+
 	/// Set the row of the table that contains this cell to @a row.
 	void setRow(int row) { d->row = row; }
 	/// Set the column of the table that contains this cell to @a row.
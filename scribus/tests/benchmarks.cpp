@@ -0,0 +1,479 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <algorithm>
+#include <iostream>
+
+#include <QApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
+#include <QJsonDocument>
+#include <QLinearGradient>
+#include <QPainter>
+#include <QTemporaryDir>
+
+#include "api/api_application.h"
+#include "benchmarks.h"
+#include "commonstrings.h"
+#include "pageitem.h"
+#include "pageitem_table.h"
+#include "pluginmanager.h"
+#include "scpage.h"
+#include "scplugin.h"
+#include "scprintengine_pdf.h"
+#include "scprintengine_ps.h"
+#include "scribus.h"
+#include "scribuscore.h"
+#include "scribusdoc.h"
+#include "scribusview.h"
+#include "tablecell.h"
+#include "text/specialchars.h"
+#include "undomanager.h"
+#include "util.h"
+
+namespace
+{
+	// Number of times each scenario is run, the median is reported
+	const int benchmarkRuns = 3;
+	// Seed of the generated content, changing it invalidates earlier results
+	const quint32 benchmarkSeed = 0x5c1b05;
+
+	const char* const benchmarkWords[] = {
+		"lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "adipiscing", "elit",
+		"sed", "do", "eiusmod", "tempor", "incididunt", "ut", "labore", "et", "dolore",
+		"magna", "aliqua", "enim", "ad", "minim", "veniam", "quis", "nostrud",
+		"exercitation", "ullamco", "laboris", "nisi", "aliquip", "ex", "ea", "commodo",
+		"consequat", "duis", "aute", "irure", "in", "reprehenderit", "voluptate",
+		"velit", "esse", "cillum", "fugiat", "nulla", "pariatur", "excepteur", "sint",
+		"occaecat", "cupidatat", "non", "proident", "sunt", "culpa", "qui", "officia",
+		"deserunt", "mollit", "anim", "id", "est", "laborum"
+	};
+}
+
+int RunBenchmarks::runBenchmarks(const QString& outputFile)
+{
+	RunBenchmarks benchmarks;
+	return benchmarks.run(outputFile);
+}
+
+RunBenchmarks::RunBenchmarks()
+	: m_mainWin(ScCore->primaryMainWindow())
+{
+}
+
+int RunBenchmarks::run(const QString& outputFile)
+{
+	QTemporaryDir workDir;
+	if (!workDir.isValid())
+	{
+		std::cout << QObject::tr("Cannot create a temporary directory for the benchmarks").toLocal8Bit().data() << std::endl;
+		return EXIT_FAILURE;
+	}
+	m_workDir = workDir.path();
+	createImages();
+
+	QList<Scenario> scenarios;
+	scenarios.append({ "text_chain", 40, [this](ScribusDoc* doc) { buildTextChain(doc); } });
+	scenarios.append({ "tables", 10, [this](ScribusDoc* doc) { buildTables(doc); } });
+	scenarios.append({ "images", 10, [this](ScribusDoc* doc) { buildImages(doc); } });
+	scenarios.append({ "vectors", 10, [this](ScribusDoc* doc) { buildVectors(doc); } });
+	scenarios.append({ "masters", 30, [this](ScribusDoc* doc) { buildMasters(doc); } });
+
+	// Documents left open would be part of the measurements
+	while (m_mainWin->HaveDoc)
+		closeDocument();
+
+	QJsonObject results;
+	for (const Scenario& scenario : std::as_const(scenarios))
+	{
+		std::cout << QObject::tr("Running benchmark %1").arg(scenario.name).toLocal8Bit().data() << std::endl;
+		results[scenario.name] = runScenario(scenario);
+	}
+
+	QJsonObject report;
+	report["version"] = ScribusAPI::getVersion();
+	if (ScribusAPI::haveSVNRevision())
+		report["revision"] = ScribusAPI::getSVNRevision();
+	report["qt"] = QString(qVersion());
+	report["date"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+	report["runs"] = benchmarkRuns;
+	report["seed"] = static_cast<qint64>(benchmarkSeed);
+	report["scenarios"] = results;
+	QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+
+	if (outputFile.isEmpty() || outputFile == "-")
+		std::cout << json.constData();
+	else
+	{
+		QFile file(outputFile);
+		if (!file.open(QIODevice::WriteOnly) || file.write(json) != json.size())
+		{
+			std::cout << QObject::tr("Cannot write the file: %1").arg(outputFile).toLocal8Bit().data() << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+	return m_failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+QJsonObject RunBenchmarks::runScenario(const Scenario& scenario)
+{
+	QMap<QString, QList<qint64> > timings;
+	QJsonObject result;
+	result["pages"] = scenario.pages;
+	for (int i = 0; i < benchmarkRuns; ++i)
+		runSteps(scenario, timings, result);
+
+	// Times in milliseconds
+	QJsonObject steps;
+	for (auto it = timings.begin(); it != timings.end(); ++it)
+	{
+		QList<qint64>& times = it.value();
+		std::sort(times.begin(), times.end());
+		QJsonObject step;
+		step["median"] = times.at(times.count() / 2);
+		step["min"] = times.first();
+		step["max"] = times.last();
+		steps[it.key()] = step;
+	}
+	result["timings"] = steps;
+	return result;
+}
+
+void RunBenchmarks::runSteps(const Scenario& scenario, QMap<QString, QList<qint64> >& timings, QJsonObject& info)
+{
+	UndoManager* undoManager = UndoManager::instance();
+	QElapsedTimer timer;
+
+	// Every run works on the same content
+	m_seed = benchmarkSeed;
+
+	timer.start();
+	ScribusDoc* doc = newDocument(scenario.pages);
+	if (doc == nullptr)
+	{
+		fail(scenario.name, "build");
+		return;
+	}
+	undoManager->setUndoEnabled(false);
+	scenario.build(doc);
+	undoManager->setUndoEnabled(true);
+	timings["build"].append(timer.elapsed());
+
+	QList<PageItem*> allItems;
+	doc->getAllItems(allItems);
+	info["items"] = allItems.count();
+
+	timer.restart();
+	doc->invalidateAll();
+	ReOrderText(doc, m_mainWin->view);
+	timings["layout"].append(timer.elapsed());
+
+	// Draws the pages the same way the canvas does, through ScPainter
+	timer.restart();
+	for (int i = 0; i < doc->DocPages.count(); ++i)
+	{
+		const ScPage* page = doc->DocPages.at(i);
+		m_mainWin->view->PageToPixmap(i, qRound(qMax(page->width(), page->height())), Pixmap_DrawBackground | Pixmap_DontReloadImages);
+	}
+	timings["render"].append(timer.elapsed());
+
+	PrintOptions options;
+	options.toFile = true;
+	for (int i = 0; i < doc->DocPages.count(); ++i)
+		options.pageNumbers.push_back(i + 1);
+
+	timer.restart();
+	options.prnLanguage = PrintLanguage::PDF;
+	options.filename = m_workDir + "/" + scenario.name + ".pdf";
+	ScPrintEngine_PDF pdfEngine(*doc);
+	if (pdfEngine.print(options))
+		timings["export_pdf"].append(timer.elapsed());
+	else
+		fail(scenario.name, "export_pdf");
+
+	timer.restart();
+	options.prnLanguage = PrintLanguage::PostScript3;
+	options.filename = m_workDir + "/" + scenario.name + ".ps";
+	ScPrintEngine_PS psEngine(*doc);
+	if (psEngine.print(options))
+		timings["export_ps"].append(timer.elapsed());
+	else
+		fail(scenario.name, "export_ps");
+
+	// The SVG exporter is a plugin, it is skipped when not available
+	auto* svgPlugin = qobject_cast<ScActionPlugin*>(PluginManager::instance().getPlugin("svgexplugin", false));
+	if (svgPlugin)
+	{
+		bool exported = true;
+		timer.restart();
+		for (int i = 0; i < doc->DocPages.count(); ++i)
+		{
+			doc->setCurrentPage(doc->DocPages.at(i));
+			exported &= svgPlugin->run(doc, QString("%1/%2-%3.svg").arg(m_workDir, scenario.name).arg(i + 1));
+		}
+		if (exported)
+			timings["export_svg"].append(timer.elapsed());
+		else
+			fail(scenario.name, "export_svg");
+	}
+
+	// One undo action per moved item
+	QList<PageItem*> movedItems = doc->DocItems.mid(0, 1000);
+	undoManager->setUndoEnabled(false);
+	for (PageItem* item : std::as_const(movedItems))
+		item->moveUndoAction();
+	undoManager->setUndoEnabled(true);
+	timer.restart();
+	for (PageItem* item : std::as_const(movedItems))
+	{
+		doc->moveItem(1.0, 1.0, item);
+		item->moveUndoAction();
+	}
+	timings["move"].append(timer.elapsed());
+	timer.restart();
+	undoManager->undo(movedItems.count());
+	timings["undo"].append(timer.elapsed());
+	timer.restart();
+	undoManager->redo(movedItems.count());
+	timings["redo"].append(timer.elapsed());
+
+	QString fileName = m_workDir + "/" + scenario.name + ".sla";
+	timer.restart();
+	if (doc->save(fileName))
+		timings["save"].append(timer.elapsed());
+	else
+		fail(scenario.name, "save");
+	closeDocument();
+
+	timer.restart();
+	if (m_mainWin->loadDoc(fileName))
+	{
+		timings["load"].append(timer.elapsed());
+		closeDocument();
+	}
+	else
+		fail(scenario.name, "load");
+}
+
+ScribusDoc* RunBenchmarks::newDocument(int pages)
+{
+	// A4 portrait, single pages, in points
+	if (!m_mainWin->doFileNew(595.28, 841.89, 40.0, 40.0, 40.0, 40.0, 11.0, 1, false, 0, 0, 0, 0, 1, QSizeF(), true, pages))
+		return nullptr;
+	return m_mainWin->doc;
+}
+
+void RunBenchmarks::closeDocument()
+{
+	m_mainWin->doc->setModified(false);
+	m_mainWin->slotFileClose();
+	QApplication::processEvents();
+}
+
+void RunBenchmarks::fail(const QString& scenario, const QString& step)
+{
+	std::cout << QObject::tr("Benchmark %1 failed at step %2").arg(scenario, step).toLocal8Bit().data() << std::endl;
+	m_failed = true;
+}
+
+void RunBenchmarks::buildTextChain(ScribusDoc* doc)
+{
+	// Two linked columns per page, with enough text to fill all of them
+	const double columnWidth = (doc->pageWidth() - 80.0 - 11.0) / 2.0;
+	PageItem* previous = nullptr;
+	PageItem* first = nullptr;
+	for (int i = 0; i < doc->DocPages.count(); ++i)
+	{
+		const ScPage* page = doc->DocPages.at(i);
+		for (int column = 0; column < 2; ++column)
+		{
+			int z = doc->itemAdd(PageItem::TextFrame, PageItem::Unspecified,
+								page->xOffset() + 40.0 + column * (columnWidth + 11.0), page->yOffset() + 40.0,
+								columnWidth, doc->pageHeight() - 80.0,
+								doc->itemToolPrefs().shapeLineWidth, CommonStrings::None, doc->itemToolPrefs().textColor);
+			PageItem* item = doc->Items->at(z);
+			if (previous)
+				previous->link(item, false);
+			else
+				first = item;
+			previous = item;
+		}
+	}
+
+	QString text;
+	const int length = doc->DocPages.count() * 6500;
+	while (text.length() < length)
+	{
+		if (!text.isEmpty())
+			text += SpecialChars::PARSEP;
+		text += randomText(40 + random(80));
+	}
+	first->itemText.insertChars(0, text);
+}
+
+void RunBenchmarks::buildTables(ScribusDoc* doc)
+{
+	const int rows = 50;
+	const int columns = 6;
+	for (int i = 0; i < doc->DocPages.count(); ++i)
+	{
+		const ScPage* page = doc->DocPages.at(i);
+		int z = doc->itemAdd(PageItem::Table, PageItem::Unspecified,
+							page->xOffset() + 40.0, page->yOffset() + 40.0,
+							doc->pageWidth() - 80.0, doc->pageHeight() - 80.0,
+							0, CommonStrings::None, CommonStrings::None);
+		PageItem_Table* table = doc->Items->at(z)->asTable();
+		table->insertRows(0, rows - 1);
+		table->insertColumns(0, columns - 1);
+		table->adjustTableToFrame();
+		table->adjustFrameToTable();
+		for (int row = 0; row < rows; ++row)
+		{
+			for (int column = 0; column < columns; ++column)
+				table->cellAt(row, column).setText(randomText(1 + random(6)));
+		}
+	}
+}
+
+void RunBenchmarks::buildImages(ScribusDoc* doc)
+{
+	// A grid of 3 x 4 image frames per page
+	const double width = (doc->pageWidth() - 80.0) / 3.0;
+	const double height = (doc->pageHeight() - 80.0) / 4.0;
+	for (int i = 0; i < doc->DocPages.count(); ++i)
+	{
+		const ScPage* page = doc->DocPages.at(i);
+		for (int cell = 0; cell < 12; ++cell)
+		{
+			int z = doc->itemAdd(PageItem::ImageFrame, PageItem::Unspecified,
+								page->xOffset() + 40.0 + (cell % 3) * width, page->yOffset() + 40.0 + (cell / 3) * height,
+								width - 5.0, height - 5.0,
+								1, doc->itemToolPrefs().imageFillColor, doc->itemToolPrefs().imageStrokeColor);
+			doc->loadPict(m_images.at(random(m_images.count())), doc->Items->at(z));
+		}
+	}
+}
+
+void RunBenchmarks::buildVectors(ScribusDoc* doc)
+{
+	for (int i = 0; i < doc->DocPages.count(); ++i)
+		addVectorItems(doc, i, 1000);
+}
+
+void RunBenchmarks::buildMasters(ScribusDoc* doc)
+{
+	// Three master pages full of items, applied in turn to the pages
+	QStringList masterNames;
+	for (int i = 0; i < 3; ++i)
+	{
+		QString name = QString("Benchmark %1").arg(i + 1);
+		doc->addMasterPage(doc->MasterPages.count(), name);
+		masterNames.append(name);
+		int masterIndex = doc->MasterNames[name];
+		m_mainWin->view->showMasterPage(masterIndex);
+		addVectorItems(doc, masterIndex, 400);
+		const ScPage* page = doc->currentPage();
+		int z = doc->itemAdd(PageItem::TextFrame, PageItem::Unspecified,
+							page->xOffset() + 40.0, page->yOffset() + 40.0, doc->pageWidth() - 80.0, 100.0,
+							doc->itemToolPrefs().shapeLineWidth, CommonStrings::None, doc->itemToolPrefs().textColor);
+		doc->Items->at(z)->itemText.insertChars(0, randomText(100));
+		m_mainWin->view->hideMasterPage();
+	}
+	for (int i = 0; i < doc->DocPages.count(); ++i)
+		doc->applyMasterPage(masterNames.at(i % masterNames.count()), i);
+}
+
+void RunBenchmarks::addVectorItems(ScribusDoc* doc, int pageIndex, int count)
+{
+	// Pages in master page mode are the master pages
+	const ScPage* page = doc->Pages->at(pageIndex);
+	QStringList colors = doc->PageColors.keys();
+	colors.removeAll(CommonStrings::None);
+	for (int i = 0; i < count; ++i)
+	{
+		double x = page->xOffset() + random(qRound(page->width()) - 60);
+		double y = page->yOffset() + random(qRound(page->height()) - 60);
+		double w = 5.0 + random(55);
+		double h = 5.0 + random(55);
+		const QString& fill = colors.at(random(colors.count()));
+		const QString& stroke = colors.at(random(colors.count()));
+		int z;
+		switch (random(4))
+		{
+			case 0:
+				z = doc->itemAdd(PageItem::Polygon, PageItem::Rectangle, x, y, w, h, 1, fill, stroke);
+				break;
+			case 1:
+				z = doc->itemAdd(PageItem::Polygon, PageItem::Ellipse, x, y, w, h, 1, fill, stroke);
+				break;
+			case 2:
+				z = doc->itemAdd(PageItem::Polygon, PageItem::Round, x, y, w, h, 1, fill, stroke);
+				break;
+			default:
+				z = doc->itemAdd(PageItem::Line, PageItem::Unspecified, x, y, w, 0, 1 + random(4), CommonStrings::None, stroke);
+				break;
+		}
+		PageItem* item = doc->Items->at(z);
+		item->setRotation(random(360));
+		if (random(4) == 0)
+			item->setFillTransparency(random(80) / 100.0);
+	}
+}
+
+void RunBenchmarks::createImages()
+{
+	// Large enough to go through scaling and compression like real photos
+	m_images.clear();
+	for (int i = 0; i < 6; ++i)
+	{
+		QImage image(1600, 1200, QImage::Format_RGB32);
+		QPainter painter(&image);
+		QLinearGradient gradient(0, 0, image.width(), image.height());
+		gradient.setColorAt(0.0, QColor::fromHsv(i * 60, 200, 255));
+		gradient.setColorAt(1.0, QColor::fromHsv(i * 60 + 30, 255, 80));
+		painter.fillRect(image.rect(), gradient);
+		for (int j = 0; j < 200; ++j)
+		{
+			painter.setBrush(QColor::fromHsv(random(360), 100 + random(155), 100 + random(155), 128));
+			painter.drawEllipse(random(image.width()), random(image.height()), 20 + random(200), 20 + random(200));
+		}
+		painter.end();
+		QString fileName = QString("%1/image-%2.%3").arg(m_workDir).arg(i + 1).arg((i % 2) ? "png" : "jpg");
+		image.save(fileName);
+		m_images.append(fileName);
+	}
+}
+
+quint32 RunBenchmarks::random(quint32 range)
+{
+	// Fixed linear congruential generator, the standard library ones are
+	// not guaranteed to give the same sequence everywhere
+	m_seed = m_seed * 1664525u + 1013904223u;
+	return (range > 0) ? (m_seed >> 8) % range : 0;
+}
+
+QString RunBenchmarks::randomText(int words)
+{
+	const quint32 wordCount = sizeof(benchmarkWords) / sizeof(benchmarkWords[0]);
+	QString text;
+	bool capitalize = true;
+	for (int i = 0; i < words; ++i)
+	{
+		QString word = QString::fromLatin1(benchmarkWords[random(wordCount)]);
+		if (capitalize)
+			word[0] = word[0].toUpper();
+		if (!text.isEmpty())
+			text += ' ';
+		text += word;
+		capitalize = (random(10) == 0);
+		if (capitalize || i == words - 1)
+			text += '.';
+	}
+	return text;
+}
@@ -0,0 +1,74 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include <functional>
+
+#include <QJsonObject>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+class ScribusDoc;
+class ScribusMainWindow;
+
+/**
+ * Performance benchmarks, run with --benchmark once the application is set up.
+ *
+ * Each scenario builds a synthetic document in code from a fixed random seed,
+ * so that every run and every build works on the same content: long text
+ * chains, big tables, many images, many vector items and heavy master pages.
+ * The document is then laid out, rendered, exported to PDF, PostScript and
+ * SVG, saved, loaded again, and item moves are undone and redone. Every step
+ * is timed over several runs, the results are written as JSON to allow
+ * tracking regressions across commits.
+ */
+class RunBenchmarks
+{
+public:
+	//! \brief Runs all scenarios and writes the results to outputFile, or to stdout if empty or "-"
+	static int runBenchmarks(const QString& outputFile);
+
+private:
+	struct Scenario
+	{
+		QString name;
+		int pages {1};
+		std::function<void(ScribusDoc*)> build;
+	};
+
+	RunBenchmarks();
+
+	ScribusMainWindow* m_mainWin {nullptr};
+	QString m_workDir;
+	QStringList m_images;
+	quint32 m_seed {0};
+	bool m_failed {false};
+
+	int run(const QString& outputFile);
+	QJsonObject runScenario(const Scenario& scenario);
+	void runSteps(const Scenario& scenario, QMap<QString, QList<qint64> >& timings, QJsonObject& info);
+
+	ScribusDoc* newDocument(int pages);
+	void closeDocument();
+	void fail(const QString& scenario, const QString& step);
+
+	void buildTextChain(ScribusDoc* doc);
+	void buildTables(ScribusDoc* doc);
+	void buildImages(ScribusDoc* doc);
+	void buildVectors(ScribusDoc* doc);
+	void buildMasters(ScribusDoc* doc);
+	void addVectorItems(ScribusDoc* doc, int pageIndex, int count);
+	void createImages();
+
+	quint32 random(quint32 range);
+	QString randomText(int words);
+};
+
+#endif
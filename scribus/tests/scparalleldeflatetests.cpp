@@ -0,0 +1,146 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#include <QtTest/QtTest>
+#include <zlib.h>
+
+#include "scparalleldeflatetests.h"
+#include "scparalleldeflate.h"
+
+Q_DECLARE_METATYPE(ScParallelDeflate::Format);
+
+namespace
+{
+	// Text-like data compressing reasonably, with some noise so that blocks differ
+	QByteArray testData(int size)
+	{
+		static const char* const words[] = { "scribus ", "page ", "frame ", "text ", "layout ", "\n" };
+		QByteArray data;
+		data.reserve(size);
+		quint32 seed = 0x5c1b05;
+		while (data.size() < size)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			if ((seed >> 28) == 0)
+				data.append(static_cast<char>(seed >> 16));
+			else
+				data.append(words[(seed >> 16) % 6]);
+		}
+		data.truncate(size);
+		return data;
+	}
+
+	bool inflateAll(const QByteArray& in, ScParallelDeflate::Format format, QByteArray& out)
+	{
+		z_stream stream;
+		memset(&stream, 0, sizeof(stream));
+		int windowBits = (format == ScParallelDeflate::GzipFormat) ? (16 + MAX_WBITS) : MAX_WBITS;
+		if (inflateInit2(&stream, windowBits) != Z_OK)
+			return false;
+		out.clear();
+		char buffer[65536];
+		stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.constData()));
+		stream.avail_in = in.size();
+		int ret = Z_OK;
+		while (ret == Z_OK)
+		{
+			stream.next_out = reinterpret_cast<Bytef*>(buffer);
+			stream.avail_out = sizeof(buffer);
+			ret = inflate(&stream, Z_NO_FLUSH);
+			out.append(buffer, sizeof(buffer) - stream.avail_out);
+		}
+		bool complete = (ret == Z_STREAM_END) && (stream.avail_in == 0);
+		inflateEnd(&stream);
+		return complete;
+	}
+}
+
+void ScParallelDeflateTests::testRoundTrip()
+{
+	QFETCH(ScParallelDeflate::Format, format);
+	QFETCH(int, level);
+	QFETCH(int, size);
+
+	QByteArray data = testData(size);
+	QByteArray compressed = ScParallelDeflate::compress(data, format, level);
+	QVERIFY(!compressed.isEmpty());
+	QByteArray inflated;
+	QVERIFY(inflateAll(compressed, format, inflated));
+	QCOMPARE(inflated, data);
+}
+
+void ScParallelDeflateTests::testRoundTrip_data()
+{
+	QTest::addColumn<ScParallelDeflate::Format>("format");
+	QTest::addColumn<int>("level");
+	QTest::addColumn<int>("size");
+
+	const int block = ScParallelDeflate::blockSize;
+	QTest::newRow("zlib empty") << ScParallelDeflate::ZlibFormat << -1 << 0;
+	QTest::newRow("zlib small") << ScParallelDeflate::ZlibFormat << -1 << 1000;
+	QTest::newRow("zlib one block") << ScParallelDeflate::ZlibFormat << -1 << block;
+	QTest::newRow("zlib one block and a byte") << ScParallelDeflate::ZlibFormat << 6 << block + 1;
+	QTest::newRow("zlib many blocks fastest") << ScParallelDeflate::ZlibFormat << 1 << 5 * block + 123;
+	QTest::newRow("zlib many blocks smallest") << ScParallelDeflate::ZlibFormat << 9 << 5 * block + 123;
+	QTest::newRow("zlib several batches") << ScParallelDeflate::ZlibFormat << -1 << 80 * block + 7;
+	QTest::newRow("gzip empty") << ScParallelDeflate::GzipFormat << -1 << 0;
+	QTest::newRow("gzip small") << ScParallelDeflate::GzipFormat << -1 << 1000;
+	QTest::newRow("gzip many blocks") << ScParallelDeflate::GzipFormat << -1 << 7 * block;
+}
+
+void ScParallelDeflateTests::testChunkedWrites()
+{
+	// Blocks are cut at fixed offsets of the input, the output must not depend on write sizes
+	QByteArray data = testData(9 * ScParallelDeflate::blockSize + 4321);
+	QByteArray expected = ScParallelDeflate::compress(data, ScParallelDeflate::ZlibFormat);
+
+	ScParallelDeflate deflate(ScParallelDeflate::ZlibFormat);
+	QByteArray chunked;
+	int offset = 0;
+	int chunk = 1;
+	while (offset < data.size())
+	{
+		int length = qMin(chunk, static_cast<int>(data.size()) - offset);
+		QVERIFY(deflate.write(data.constData() + offset, length));
+		chunked += deflate.takeOutput();
+		offset += length;
+		chunk = (chunk * 7) % 100000 + 1;
+	}
+	QVERIFY(deflate.finish());
+	chunked += deflate.takeOutput();
+	QCOMPARE(chunked, expected);
+}
+
+void ScParallelDeflateTests::testSmallInputMatchesZlib()
+{
+	// A single block is a plain deflate stream
+	QByteArray data = testData(50000);
+	for (int level : { 1, 4, 6, 9 })
+	{
+		uLongf length = compressBound(data.size());
+		QByteArray reference(length, '\0');
+		QCOMPARE(compress2(reinterpret_cast<Bytef*>(reference.data()), &length, reinterpret_cast<const Bytef*>(data.constData()), data.size(), level), Z_OK);
+		reference.truncate(length);
+		QCOMPARE(ScParallelDeflate::compress(data, ScParallelDeflate::ZlibFormat, level), reference);
+	}
+}
+
+void ScParallelDeflateTests::testGzipTrailer()
+{
+	QByteArray data = testData(3 * ScParallelDeflate::blockSize + 17);
+	QByteArray compressed = ScParallelDeflate::compress(data, ScParallelDeflate::GzipFormat);
+	QVERIFY(compressed.size() > 18);
+	QCOMPARE(static_cast<uchar>(compressed.at(0)), uchar(0x1f));
+	QCOMPARE(static_cast<uchar>(compressed.at(1)), uchar(0x8b));
+
+	const uchar* trailer = reinterpret_cast<const uchar*>(compressed.constData() + compressed.size() - 8);
+	quint32 crc = trailer[0] | (trailer[1] << 8) | (trailer[2] << 16) | (static_cast<quint32>(trailer[3]) << 24);
+	quint32 size = trailer[4] | (trailer[5] << 8) | (trailer[6] << 16) | (static_cast<quint32>(trailer[7]) << 24);
+	QCOMPARE(crc, static_cast<quint32>(crc32(0L, reinterpret_cast<const Bytef*>(data.constData()), data.size())));
+	QCOMPARE(size, static_cast<quint32>(data.size()));
+}
+
+QTEST_APPLESS_MAIN(ScParallelDeflateTests)
@@ -0,0 +1,29 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#ifndef SCPARALLELDEFLATETESTS_H
+#define SCPARALLELDEFLATETESTS_H
+
+#include <QtTest/QtTest>
+
+/**
+ * Unit tests for ScParallelDeflate.
+ */
+class ScParallelDeflateTests : public QObject
+{
+	Q_OBJECT
+public:
+	ScParallelDeflateTests() {}
+
+private slots:
+	void testRoundTrip();
+	void testRoundTrip_data();
+	void testChunkedWrites();
+	void testSmallInputMatchesZlib();
+	void testGzipTrailer();
+};
+
+#endif // SCPARALLELDEFLATETESTS_H
@@ -0,0 +1,61 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#include <QtTest/QtTest>
+
+#include <vector>
+
+#include "scparallelfortests.h"
+#include "scparallelfor.h"
+
+void ScParallelForTests::testEachIndexOnce_data()
+{
+	QTest::addColumn<int>("count");
+	QTest::newRow("empty") << 0;
+	QTest::newRow("single") << 1;
+	QTest::newRow("few") << 3;
+	QTest::newRow("many") << 10000;
+}
+
+void ScParallelForTests::testEachIndexOnce()
+{
+	QFETCH(int, count);
+	std::vector<QAtomicInt> calls(count);
+	ScParallelFor::run(count, [&](int index) { calls[index].fetchAndAddOrdered(1); });
+	for (int i = 0; i < count; ++i)
+		QCOMPARE(calls[i].loadAcquire(), 1);
+}
+
+void ScParallelForTests::testNestedRun()
+{
+	// Work spread from helper threads must neither deadlock nor lose calls
+	QAtomicInt calls(0);
+	ScParallelFor::run(16, [&](int /*index*/)
+	{
+		ScParallelFor::run(16, [&](int /*index*/) { calls.fetchAndAddOrdered(1); });
+	});
+	QCOMPARE(calls.loadAcquire(), 16 * 16);
+}
+
+void ScParallelForTests::testHelpersCapped()
+{
+	int maxHelpers = ScParallelFor::maxHelpers();
+	int helpers = ScParallelFor::reserveHelpers(maxHelpers + 4);
+	QCOMPARE(helpers, maxHelpers);
+	QCOMPARE(ScParallelFor::reserveHelpers(1), 0);
+
+	// Without helpers left, the calling thread does all the work
+	QAtomicInt calls(0);
+	ScParallelFor::run(100, [&](int /*index*/) { calls.fetchAndAddOrdered(1); });
+	QCOMPARE(calls.loadAcquire(), 100);
+
+	ScParallelFor::releaseHelpers(helpers);
+	int again = ScParallelFor::reserveHelpers(maxHelpers);
+	QCOMPARE(again, maxHelpers);
+	ScParallelFor::releaseHelpers(again);
+}
+
+QTEST_APPLESS_MAIN(ScParallelForTests)
@@ -0,0 +1,28 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#ifndef SCPARALLELFORTESTS_H
+#define SCPARALLELFORTESTS_H
+
+#include <QtTest/QtTest>
+
+/**
+ * Unit tests for ScParallelFor.
+ */
+class ScParallelForTests : public QObject
+{
+	Q_OBJECT
+public:
+	ScParallelForTests() {}
+
+private slots:
+	void testEachIndexOnce();
+	void testEachIndexOnce_data();
+	void testNestedRun();
+	void testHelpersCapped();
+};
+
+#endif // SCPARALLELFORTESTS_H
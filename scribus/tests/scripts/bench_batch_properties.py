@@ -0,0 +1,61 @@
+#!/usr/bin/env python
+
+"""
+Benchmark script for setting many item properties from a script.
+
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+
+Run this script from the Script menu with a document open. It creates ITEMS
+shapes and text frames on the current page, then sets PASSES properties on
+each of them by name, once command by command and once inside a batch, and
+prints the time taken by both runs.
+"""
+
+from time import time
+
+from scribus import *
+
+ITEMS = 2000
+PASSES = 5
+
+def set_properties(names, shade):
+    """ Sets a few properties on every named item """
+    for name in names:
+        setFillShade(shade, name)
+        setLineWidth(0.5, name)
+        setFillTransparency(0.1, name)
+        setCornerRadius(2, name)
+        setItemName(name, name)
+
+def run(names):
+    start_time = time()
+    for p in range(PASSES):
+        set_properties(names, 100 - p)
+    return time() - start_time
+
+if __name__ == '__main__':
+    if not haveDoc():
+        messageBox("Batch benchmark", "Please open a document first.")
+    else:
+        names = []
+        with batch():
+            for i in range(ITEMS):
+                x = 10 + (i % 40) * 5
+                y = 10 + (i // 40) * 5
+                if i % 2:
+                    names.append(createRect(x, y, 4, 4))
+                else:
+                    frame = createText(x, y, 4, 4)
+                    setText("Item %i" % i, frame)
+                    names.append(frame)
+        plain_time = run(names)
+        start_time = time()
+        with batch():
+            batch_time = run(names)
+        batch_end_time = time() - start_time - batch_time
+        commands = ITEMS * PASSES * 5
+        print('%i commands without batch = %.3f s' % (commands, round(plain_time, 3)))
+        print('%i commands in batch = %.3f s (ending the batch %.3f s)' % (commands, round(batch_time, 3), round(batch_end_time, 3)))
@@ -0,0 +1,60 @@
+#!/usr/bin/env python
+
+"""
+Benchmark script for the data merge.
+
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+
+Run this script from the Script menu with a document open. It adds a few text
+frames with placeholders to the current page, generates a CSV file with
+RECORDS records and merges it into a single PDF file and into one PDF file per
+record, printing the time taken by both exports.
+"""
+
+import csv
+import os
+import shutil
+import tempfile
+from time import time
+
+from scribus import *
+
+RECORDS = 1000
+SEPARATE_RECORDS = 100
+
+if __name__ == '__main__':
+    if not haveDoc():
+        messageBox("Data merge benchmark", "Please open a document first.")
+    else:
+        outdir = tempfile.mkdtemp()
+        data = os.path.join(outdir, "records.csv")
+        with open(data, "w", newline="", encoding="utf-8") as f:
+            writer = csv.writer(f)
+            writer.writerow(["name", "street", "city", "amount"])
+            for i in range(RECORDS):
+                writer.writerow(["Customer %i" % i, "%i Main Street" % i, "Town %i" % (i % 50), "%.2f" % (i * 1.5)])
+
+        frames = []
+        with batch():
+            frame = createText(20, 20, 100, 30)
+            setText("{{name}}\n{{street}}\n{{city}}", frame)
+            frames.append(frame)
+            frame = createText(20, 60, 100, 20)
+            setText("Amount due: {{amount}}", frame)
+            frames.append(frame)
+        try:
+            start_time = time()
+            dataMerge(data, os.path.join(outdir, "merged.pdf"))
+            merged_time = time() - start_time
+            start_time = time()
+            files = dataMerge(data, os.path.join(outdir, "record-%1.pdf"), False, 0, SEPARATE_RECORDS - 1)
+            separate_time = time() - start_time
+            print('%i records into one file = %.3f s, %.0f records/min' % (RECORDS, round(merged_time, 3), RECORDS * 60 / merged_time))
+            print('%i records into %i files = %.3f s, %.0f records/min' % (SEPARATE_RECORDS, len(files), round(separate_time, 3), SEPARATE_RECORDS * 60 / separate_time))
+        finally:
+            for frame in frames:
+                deleteObject(frame)
+            shutil.rmtree(outdir)
@@ -0,0 +1,77 @@
+#!/usr/bin/env python
+
+"""
+Benchmark script for importing a large DOCX file into a text frame.
+
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+
+Run this script from the Script menu with a document open. It generates a DOCX
+file with PARAGRAPHS styled paragraphs (roughly a 400 page manuscript with the
+default values), imports it into a new text frame on the current page and
+prints the time taken by the import and by the first layout of the story.
+"""
+
+import os
+import tempfile
+import zipfile
+from time import time
+
+from scribus import *
+
+PARAGRAPHS = 8000
+RUNS_PER_PARAGRAPH = 4
+WORDS = "Lorem ipsum dolor sit amet consectetur adipiscing elit sed do eiusmod tempor".split()
+
+CONTENT_TYPES = """<?xml version="1.0" encoding="UTF-8" standalone="yes"?>
+<Types xmlns="http://schemas.openxmlformats.org/package/2006/content-types">
+<Default Extension="rels" ContentType="application/vnd.openxmlformats-package.relationships+xml"/>
+<Default Extension="xml" ContentType="application/xml"/>
+<Override PartName="/word/document.xml" ContentType="application/vnd.openxmlformats-officedocument.wordprocessingml.document.main+xml"/>
+</Types>"""
+
+RELS = """<?xml version="1.0" encoding="UTF-8" standalone="yes"?>
+<Relationships xmlns="http://schemas.openxmlformats.org/package/2006/relationships">
+<Relationship Id="rId1" Type="http://schemas.openxmlformats.org/officeDocument/2006/relationships/officeDocument" Target="word/document.xml"/>
+</Relationships>"""
+
+def make_docx(path):
+    """ Writes a DOCX file with PARAGRAPHS paragraphs of mixed bold and italic runs """
+    body = []
+    for p in range(PARAGRAPHS):
+        runs = []
+        for r in range(RUNS_PER_PARAGRAPH):
+            props = ("<w:rPr><w:b/></w:rPr>", "<w:rPr><w:i/></w:rPr>", "", "")[r % 4]
+            text = " ".join(WORDS[(p + r + i) % len(WORDS)] for i in range(12))
+            runs.append('<w:r>%s<w:t xml:space="preserve">%s </w:t></w:r>' % (props, text))
+        body.append("<w:p>%s</w:p>" % "".join(runs))
+    document = ('<?xml version="1.0" encoding="UTF-8" standalone="yes"?>'
+                '<w:document xmlns:w="http://schemas.openxmlformats.org/wordprocessingml/2006/main">'
+                '<w:body>%s</w:body></w:document>' % "".join(body))
+    with zipfile.ZipFile(path, "w", zipfile.ZIP_DEFLATED) as docx:
+        docx.writestr("[Content_Types].xml", CONTENT_TYPES)
+        docx.writestr("_rels/.rels", RELS)
+        docx.writestr("word/document.xml", document)
+
+if __name__ == '__main__':
+    if not haveDoc():
+        messageBox("DOCX import benchmark", "Please open a document first.")
+    else:
+        fd, path = tempfile.mkstemp(suffix=".docx")
+        os.close(fd)
+        try:
+            make_docx(path)
+            frame = createText(20, 20, 150, 200)
+            start_time = time()
+            insertHtmlText(path, frame)
+            import_time = time() - start_time
+            start_time = time()
+            layoutText(frame)
+            layout_time = time() - start_time
+            print('Imported %i paragraphs, %i characters' % (PARAGRAPHS, getTextLength(frame)))
+            print('import time = %.3f s' % round(import_time, 3))
+            print('first layout time = %.3f s' % round(layout_time, 3))
+        finally:
+            os.remove(path)
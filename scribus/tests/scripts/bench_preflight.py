@@ -0,0 +1,46 @@
+#!/usr/bin/env python
+
+"""
+Benchmark script for the preflight verifier.
+
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+
+Run this script from the Script menu with a large document open. It checks
+the document once, then PASSES more times without changes, then once more
+after moving one item, and prints the time taken by each kind of check.
+"""
+
+import os
+import tempfile
+from time import time
+
+from scribus import *
+
+PASSES = 5
+
+def check(report):
+    start_time = time()
+    exportDocumentCheck(report)
+    return time() - start_time
+
+if __name__ == '__main__':
+    if not haveDoc():
+        messageBox("Preflight benchmark", "Please open a document first.")
+    else:
+        report = os.path.join(tempfile.mkdtemp(), "preflight.json")
+        first_time = check(report)
+        unchanged_time = 0
+        for p in range(PASSES):
+            unchanged_time += check(report)
+        names = getAllObjects()
+        changed_time = 0
+        if names:
+            moveObject(1, 1, names[0])
+            changed_time = check(report)
+            moveObject(-1, -1, names[0])
+        print('first check = %.3f s' % round(first_time, 3))
+        print('check of unchanged document = %.3f s' % round(unchanged_time / PASSES, 3))
+        print('check after moving one item = %.3f s' % round(changed_time, 3))
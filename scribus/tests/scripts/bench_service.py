@@ -0,0 +1,60 @@
+#!/usr/bin/env python
+
+"""
+Benchmark script for the headless export service.
+
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+
+Run this script with a regular Python interpreter, not from Scribus:
+
+    python bench_service.py /path/to/scribus template.sla [JOBS] [WORKERS]
+
+It starts Scribus with --service, submits JOBS jobs exporting the template to
+PDF on its standard input and prints the average time of each job step as
+reported by the service, as well as the overall throughput.
+"""
+
+import json
+import os
+import subprocess
+import sys
+import tempfile
+from time import time
+
+STEPS = ("queue", "open", "script", "export", "close", "total", "service")
+
+if __name__ == '__main__':
+    if len(sys.argv) < 3:
+        print(__doc__)
+        sys.exit(1)
+    scribus, template = sys.argv[1], os.path.abspath(sys.argv[2])
+    jobs = int(sys.argv[3]) if len(sys.argv) > 3 else 100
+    workers = sys.argv[4] if len(sys.argv) > 4 else str(os.cpu_count())
+    outdir = tempfile.mkdtemp()
+
+    start_time = time()
+    service = subprocess.Popen([scribus, "--service", "--service-workers", workers],
+                               stdin=subprocess.PIPE, stdout=subprocess.PIPE, text=True)
+    for i in range(jobs):
+        job = {"id": i, "document": template, "pdf": os.path.join(outdir, "%i.pdf" % i)}
+        service.stdin.write(json.dumps(job) + "\n")
+    service.stdin.close()
+
+    totals = dict.fromkeys(STEPS, 0)
+    failed = 0
+    for line in service.stdout:
+        response = json.loads(line)
+        if not response["ok"]:
+            failed += 1
+            print("job %s failed: %s" % (response.get("id"), response.get("error")))
+        for step, ms in response["timings"].items():
+            totals[step] = totals.get(step, 0) + ms
+    service.wait()
+    elapsed = time() - start_time
+
+    print('%i jobs with %s workers in %.3f s, %.1f jobs/s, %i failed' % (jobs, workers, elapsed, jobs / elapsed, failed))
+    for step in STEPS:
+        print('  %-8s %8.1f ms average' % (step, totals[step] / jobs))
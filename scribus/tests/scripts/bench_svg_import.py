@@ -0,0 +1,76 @@
+#!/usr/bin/env python
+
+"""
+Benchmark script for importing a large SVG file.
+
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+
+Run this script from the Script menu with a document open. It generates an SVG
+file looking like a map export, GROUPS groups of PATHS_PER_GROUP paths using a
+gradient and a symbol defined at the end of the file, places it on the current
+page and prints the time taken by the import and the peak memory use of the
+application.
+"""
+
+import os
+import resource
+import sys
+import tempfile
+from time import time
+
+from scribus import *
+
+GROUPS = 2000
+PATHS_PER_GROUP = 50
+
+def make_svg(path):
+    """ Writes an SVG file with GROUPS groups of PATHS_PER_GROUP paths """
+    with open(path, "w") as svg:
+        svg.write('<?xml version="1.0" encoding="UTF-8"?>\n')
+        svg.write('<svg xmlns="http://www.w3.org/2000/svg" xmlns:xlink="http://www.w3.org/1999/xlink" '
+                  'width="2000" height="2000" viewBox="0 0 2000 2000">\n')
+        for g in range(GROUPS):
+            svg.write('<g id="tile%i" transform="translate(%i,%i)" style="stroke:#203040;stroke-width:0.5">\n'
+                      % (g, (g % 40) * 50, (g // 40) * 40))
+            for p in range(PATHS_PER_GROUP):
+                x = (p * 7) % 45
+                y = (p * 3) % 35
+                fill = "url(#ramp)" if p % 5 == 0 else "#%02x%02x80" % ((g * 5) % 256, (p * 9) % 256)
+                svg.write('<path d="M %i %i l 4 0 l 1 3 l -3 2 z" style="fill:%s"/>\n' % (x, y, fill))
+            svg.write('<use xlink:href="#marker" x="20" y="20"/>\n')
+            svg.write('</g>\n')
+        svg.write('<defs>\n')
+        svg.write('<linearGradient id="ramp"><stop offset="0" stop-color="#ff0000"/>'
+                  '<stop offset="1" stop-color="#0000ff"/></linearGradient>\n')
+        svg.write('<symbol id="marker"><circle cx="0" cy="0" r="2" style="fill:#000000"/></symbol>\n')
+        svg.write('</defs>\n')
+        svg.write('</svg>\n')
+
+def peak_memory():
+    """ Peak resident memory of the application in MiB """
+    peak = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    if sys.platform == "darwin":
+        return peak / (1024.0 * 1024.0)
+    return peak / 1024.0
+
+if __name__ == '__main__':
+    if not haveDoc():
+        messageBox("SVG import benchmark", "Please open a document first.")
+    else:
+        fd, path = tempfile.mkstemp(suffix=".svg")
+        os.close(fd)
+        try:
+            make_svg(path)
+            size = os.path.getsize(path) / (1024.0 * 1024.0)
+            memory_before = peak_memory()
+            start_time = time()
+            placeSVG(path, 0, 0)
+            import_time = time() - start_time
+            print('Imported %i paths from a %.1f MiB file' % (GROUPS * PATHS_PER_GROUP, size))
+            print('import time = %.3f s' % round(import_time, 3))
+            print('peak memory = %.0f MiB (%.0f MiB before import)' % (peak_memory(), memory_before))
+        finally:
+            os.remove(path)
@@ -0,0 +1,122 @@
+#!/usr/bin/env python
+
+"""
+Test script for script batches.
+
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+
+Run this script from the Script menu. Each test changes a new document in a
+batch, then undoes the batch and checks that it was recorded as a single
+undo step.
+
+Use check() to check a condition and fail(msg) to manually fail a test. The
+tests are run in a "fail fast" fashion; on failure, the test method will
+stop executing and testing move on to the next test method.
+"""
+
+from scribus import *
+from traceback import print_exc
+from sys import stdout
+from inspect import getmembers, ismethod
+from time import time
+
+class BatchTests:
+    """ Tests for script batches """
+    def new_document(self):
+        """ Creates a document with a black item and returns the item """
+        newDocument(PAPER_A4, (10, 10, 10, 10), PORTRAIT, 1, UNIT_POINTS, PAGE_1, 0, 1)
+        item = createRect(20, 20, 20, 20)
+        setFillColor("Black", item)
+        return item
+
+    def test_single_undo_step(self):
+        """ Undoing a batch """
+        first = self.new_document()
+        try:
+            with batch():
+                setFillColor("White", first)
+                second = createRect(60, 60, 20, 20)
+                setFillColor("White", second)
+            check(getFillColor(first) == "White")
+            check(objectExists(second))
+            undo()
+            check(getFillColor(first) == "Black")
+            check(not objectExists(second))
+        finally:
+            closeDoc()
+
+    def test_nested_batches(self):
+        """ Undoing nested batches """
+        first = self.new_document()
+        try:
+            with batch():
+                setFillColor("White", first)
+                with batch():
+                    second = createRect(60, 60, 20, 20)
+                third = createRect(100, 60, 20, 20)
+            undo()
+            check(getFillColor(first) == "Black")
+            check(not objectExists(second))
+            check(not objectExists(third))
+        finally:
+            closeDoc()
+
+    def test_undo_in_batch(self):
+        """ Undoing inside a batch """
+        item = self.new_document()
+        try:
+            with batch():
+                setFillColor("White", item)
+                try:
+                    undo()
+                    fail('undo() inside a batch did not raise')
+                except ScribusException:
+                    pass
+            check(getFillColor(item) == "White")
+        finally:
+            closeDoc()
+
+class TestFailure(Exception):
+    def __init__(self, msg):
+        self.msg = msg
+    def __str__(self):
+        return repr(self.msg)
+
+def check(condition):
+    """ Fails test if condition is false """
+    if not condition:
+        fail('Check failed')
+
+def fail(msg):
+    """ Fails test with msg """
+    raise TestFailure(msg)
+
+def is_test_method(obj):
+    """ Returns True if obj is a test method """
+    return ismethod(obj) and obj.__name__.startswith('test_')
+
+if __name__ == '__main__':
+    print('Running batch tests...')
+    tests = BatchTests()
+    methods = getmembers(tests, is_test_method)
+    ntests = len(methods)
+    nfailed = 0
+    total_time = 0
+    for testnr, (name, method) in enumerate(methods):
+        print('\t%i/%i: %s()%s' % (testnr + 1, ntests, name, '.' * (30 - len(name))), end=' ')
+        try:
+            start_time = time()
+            method()
+            test_time = time() - start_time
+            total_time += test_time
+        except:
+            print('Failed')
+            print_exc(file=stdout)
+            nfailed += 1
+        else:
+            print('Passed  %.3f s' % round(test_time, 3))
+    print('%i%% passed, %i tests failed out of %i' % (int(round((float(ntests - nfailed)/ntests)*100)), nfailed, ntests))
+    print('total test time = %.3f s' % round(total_time, 3))
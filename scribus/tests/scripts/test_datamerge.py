@@ -0,0 +1,155 @@
+#!/usr/bin/env python
+
+"""
+Test script for the data merge.
+
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+
+Run this script from the Script menu. Each test merges a small CSV or JSON
+file into a new document and checks the written PDF files.
+
+Use check() to check a condition and fail(msg) to manually fail a test. The
+tests are run in a "fail fast" fashion; on failure, the test method will
+stop executing and testing move on to the next test method.
+"""
+
+import csv
+import json
+import os
+import re
+import tempfile
+from scribus import *
+from traceback import print_exc
+from sys import stdout
+from inspect import getmembers, ismethod
+from time import time
+
+RECORDS = [{"name": "Anna", "amount": "10.50"},
+           {"name": "Bert", "amount": "7.00"},
+           {"name": "Carla", "amount": "3.25"}]
+
+TEXT = "{{name}} owes {{amount}}"
+
+def pdf_pages(fileName):
+    """ Returns the number of pages of a PDF file """
+    with open(fileName, "rb") as f:
+        return len(re.findall(rb"/Type\s*/Page\b", f.read()))
+
+class DataMergeTests:
+    """ Tests for the data merge """
+    def __init__(self):
+        self.directory = tempfile.mkdtemp()
+        self.csvFile = os.path.join(self.directory, "records.csv")
+        with open(self.csvFile, "w", newline="", encoding="utf-8") as f:
+            writer = csv.DictWriter(f, fieldnames=["name", "amount"])
+            writer.writeheader()
+            writer.writerows(RECORDS)
+        self.jsonFile = os.path.join(self.directory, "records.json")
+        with open(self.jsonFile, "w", encoding="utf-8") as f:
+            json.dump(RECORDS, f)
+
+    def new_document(self, pages=1):
+        """ Creates a document with a text frame bound to the records on each page """
+        newDocument(PAPER_A4, (10, 10, 10, 10), PORTRAIT, 1, UNIT_POINTS, PAGE_1, 0, pages)
+        frames = []
+        for page in range(1, pages + 1):
+            gotoPage(page)
+            frame = createText(20, 20, 200, 30)
+            setText(TEXT, frame)
+            frames.append(frame)
+        return frames
+
+    def test_merged_file(self):
+        """ Merging all records into one file """
+        frames = self.new_document(2)
+        try:
+            fileName = os.path.join(self.directory, "merged.pdf")
+            files = dataMerge(self.csvFile, fileName)
+            check(files == [fileName])
+            check(pdf_pages(fileName) == 2 * len(RECORDS))
+            # The document is left unchanged
+            check(all(getAllText(frame) == TEXT for frame in frames))
+        finally:
+            closeDoc()
+
+    def test_merged_range(self):
+        """ Merging a range of records into one file """
+        self.new_document()
+        try:
+            fileName = os.path.join(self.directory, "range.pdf")
+            dataMerge(self.jsonFile, fileName, True, 1, 2)
+            check(pdf_pages(fileName) == 2)
+        finally:
+            closeDoc()
+
+    def test_separate_files(self):
+        """ Merging each record into a file of its own """
+        frames = self.new_document()
+        try:
+            pattern = os.path.join(self.directory, "record-%1-{{name}}.pdf")
+            files = dataMerge(self.jsonFile, pattern, False)
+            expected = [os.path.join(self.directory, "record-%i-%s.pdf" % (i + 1, record["name"]))
+                        for i, record in enumerate(RECORDS)]
+            check(files == expected)
+            check(all(pdf_pages(fileName) == 1 for fileName in files))
+            check(getAllText(frames[0]) == TEXT)
+        finally:
+            closeDoc()
+
+    def test_missing_record(self):
+        """ Merging a record beyond the data """
+        self.new_document()
+        try:
+            fileName = os.path.join(self.directory, "missing.pdf")
+            try:
+                dataMerge(self.csvFile, fileName, True, len(RECORDS), len(RECORDS))
+                fail('Merging a missing record did not raise')
+            except ScribusException:
+                pass
+        finally:
+            closeDoc()
+
+class TestFailure(Exception):
+    def __init__(self, msg):
+        self.msg = msg
+    def __str__(self):
+        return repr(self.msg)
+
+def check(condition):
+    """ Fails test if condition is false """
+    if not condition:
+        fail('Check failed')
+
+def fail(msg):
+    """ Fails test with msg """
+    raise TestFailure(msg)
+
+def is_test_method(obj):
+    """ Returns True if obj is a test method """
+    return ismethod(obj) and obj.__name__.startswith('test_')
+
+if __name__ == '__main__':
+    print('Running data merge tests...')
+    tests = DataMergeTests()
+    methods = getmembers(tests, is_test_method)
+    ntests = len(methods)
+    nfailed = 0
+    total_time = 0
+    for testnr, (name, method) in enumerate(methods):
+        print('\t%i/%i: %s()%s' % (testnr + 1, ntests, name, '.' * (30 - len(name))), end=' ')
+        try:
+            start_time = time()
+            method()
+            test_time = time() - start_time
+            total_time += test_time
+        except:
+            print('Failed')
+            print_exc(file=stdout)
+            nfailed += 1
+        else:
+            print('Passed  %.3f s' % round(test_time, 3))
+    print('%i%% passed, %i tests failed out of %i' % (int(round((float(ntests - nfailed)/ntests)*100)), nfailed, ntests))
+    print('total test time = %.3f s' % round(total_time, 3))
@@ -0,0 +1,118 @@
+#!/usr/bin/env python
+
+"""
+Test script for incremental saving.
+
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+
+Enable "Only Serialize Changed Items When Saving" on the Saving & Undo tab of
+the preferences, then run this script from the Script menu. Each test saves a
+document, changes an item, saves it again so that unchanged items are reused
+from the previous save, then opens the file again and checks that the change
+was written.
+
+Use check() to check a condition and fail(msg) to manually fail a test. The
+tests are run in a "fail fast" fashion; on failure, the test method will
+stop executing and testing move on to the next test method.
+"""
+
+import os
+import tempfile
+from scribus import *
+from traceback import print_exc
+from sys import stdout
+from inspect import getmembers, ismethod
+from time import time
+
+ATTRIBUTE = {"Name": "sku", "Type": "string", "Value": "A-1", "Parameter": "",
+             "Relationship": "none", "RelationshipTo": "", "AutoAddTo": "none"}
+
+class IncrementalSaveTests:
+    """ Tests for incremental saving """
+    def __init__(self):
+        self.fileName = os.path.join(tempfile.mkdtemp(), "incremental.sla")
+
+    def saved_document(self):
+        """ Creates a document with a few items and saves it twice """
+        newDocument(PAPER_A4, (10, 10, 10, 10), PORTRAIT, 1, UNIT_POINTS, PAGE_1, 0, 1)
+        items = [createRect(20 + 30 * i, 20, 20, 20) for i in range(5)]
+        check(saveDocAs(self.fileName))
+        saveDoc()
+        return items
+
+    def reopened_document(self):
+        """ Saves the changes and opens the document again """
+        saveDoc()
+        closeDoc()
+        check(openDoc(self.fileName))
+
+    def test_object_attributes(self):
+        """ Attributes are stored without an undo action """
+        items = self.saved_document()
+        setObjectAttributes([ATTRIBUTE], items[2])
+        self.reopened_document()
+        try:
+            attributes = getObjectAttributes(items[2])
+            check(len(attributes) == 1)
+            check(attributes[0]["Name"] == "sku")
+            check(attributes[0]["Value"] == "A-1")
+            check(len(getObjectAttributes(items[1])) == 0)
+        finally:
+            closeDoc()
+
+    def test_batch(self):
+        """ Changes made in a script batch """
+        items = self.saved_document()
+        beginBatch()
+        setFillColor("Red", items[3])
+        endBatch()
+        self.reopened_document()
+        try:
+            check(getFillColor(items[3]) == "Red")
+        finally:
+            closeDoc()
+
+class TestFailure(Exception):
+    def __init__(self, msg):
+        self.msg = msg
+    def __str__(self):
+        return repr(self.msg)
+
+def check(condition):
+    """ Fails test if condition is false """
+    if not condition:
+        fail('Check failed')
+
+def fail(msg):
+    """ Fails test with msg """
+    raise TestFailure(msg)
+
+def is_test_method(obj):
+    """ Returns True if obj is a test method """
+    return ismethod(obj) and obj.__name__.startswith('test_')
+
+if __name__ == '__main__':
+    print('Running incremental save tests...')
+    tests = IncrementalSaveTests()
+    methods = getmembers(tests, is_test_method)
+    ntests = len(methods)
+    nfailed = 0
+    total_time = 0
+    for testnr, (name, method) in enumerate(methods):
+        print('\t%i/%i: %s()%s' % (testnr + 1, ntests, name, '.' * (30 - len(name))), end=' ')
+        try:
+            start_time = time()
+            method()
+            test_time = time() - start_time
+            total_time += test_time
+        except:
+            print('Failed')
+            print_exc(file=stdout)
+            nfailed += 1
+        else:
+            print('Passed  %.3f s' % round(test_time, 3))
+    print('%i%% passed, %i tests failed out of %i' % (int(round((float(ntests - nfailed)/ntests)*100)), nfailed, ntests))
+    print('total test time = %.3f s' % round(total_time, 3))
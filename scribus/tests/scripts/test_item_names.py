@@ -0,0 +1,111 @@
+#!/usr/bin/env python
+
+"""
+Test script for looking up items by name.
+
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+
+Run this script from the Script menu. Each test creates and deletes items in a
+new document and checks that every item is still found by its name.
+
+Use check() to check a condition and fail(msg) to manually fail a test. The
+tests are run in a "fail fast" fashion; on failure, the test method will
+stop executing and testing move on to the next test method.
+"""
+
+from scribus import *
+from traceback import print_exc
+from sys import stdout
+from inspect import getmembers, ismethod
+from time import time
+
+class ItemNameTests:
+    """ Tests for looking up items by name """
+    def check_items(self, names):
+        """ Checks that all items of the document and names are found """
+        for name in getAllObjects() + names:
+            check(objectExists(name))
+            setFillColor("Black", name)
+
+    def test_delete_then_create(self):
+        """ Deleting an item then creating one """
+        newDocument(PAPER_A4, (10, 10, 10, 10), PORTRAIT, 1, UNIT_POINTS, PAGE_1, 0, 1)
+        try:
+            items = [createRect(20 * i, 20, 10, 10) for i in range(3)]
+            self.check_items(items)
+            deleteObject(items[1])
+            check(not objectExists(items[1]))
+            item = createRect(20, 60, 10, 10)
+            self.check_items([items[0], items[2], item])
+        finally:
+            closeDoc()
+
+    def test_delete_last_then_create(self):
+        """ Deleting the last item then creating one """
+        newDocument(PAPER_A4, (10, 10, 10, 10), PORTRAIT, 1, UNIT_POINTS, PAGE_1, 0, 1)
+        try:
+            items = [createRect(20 * i, 20, 10, 10) for i in range(3)]
+            self.check_items(items)
+            deleteObject(items[2])
+            item = createEllipse(20, 60, 10, 10)
+            self.check_items([items[0], items[1], item])
+        finally:
+            closeDoc()
+
+    def test_delete_then_create_in_batch(self):
+        """ Deleting an item then creating one in a script batch """
+        newDocument(PAPER_A4, (10, 10, 10, 10), PORTRAIT, 1, UNIT_POINTS, PAGE_1, 0, 1)
+        try:
+            items = [createRect(20 * i, 20, 10, 10) for i in range(3)]
+            with batch():
+                self.check_items(items)
+                deleteObject(items[0])
+                item = createRect(20, 60, 10, 10)
+                self.check_items([items[1], items[2], item])
+        finally:
+            closeDoc()
+
+class TestFailure(Exception):
+    def __init__(self, msg):
+        self.msg = msg
+    def __str__(self):
+        return repr(self.msg)
+
+def check(condition):
+    """ Fails test if condition is false """
+    if not condition:
+        fail('Check failed')
+
+def fail(msg):
+    """ Fails test with msg """
+    raise TestFailure(msg)
+
+def is_test_method(obj):
+    """ Returns True if obj is a test method """
+    return ismethod(obj) and obj.__name__.startswith('test_')
+
+if __name__ == '__main__':
+    print('Running item name tests...')
+    tests = ItemNameTests()
+    methods = getmembers(tests, is_test_method)
+    ntests = len(methods)
+    nfailed = 0
+    total_time = 0
+    for testnr, (name, method) in enumerate(methods):
+        print('\t%i/%i: %s()%s' % (testnr + 1, ntests, name, '.' * (30 - len(name))), end=' ')
+        try:
+            start_time = time()
+            method()
+            test_time = time() - start_time
+            total_time += test_time
+        except:
+            print('Failed')
+            print_exc(file=stdout)
+            nfailed += 1
+        else:
+            print('Passed  %.3f s' % round(test_time, 3))
+    print('%i%% passed, %i tests failed out of %i' % (int(round((float(ntests - nfailed)/ntests)*100)), nfailed, ntests))
+    print('total test time = %.3f s' % round(total_time, 3))
@@ -0,0 +1,131 @@
+#!/usr/bin/env python
+
+"""
+Test script for the PDF importer.
+
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+
+Run this script from the Script menu. It exports a PDF holding an image, imports
+it into a new document and checks the images of the imported items.
+
+Use check() to check a condition and fail(msg) to manually fail a test. The
+tests are run in a "fail fast" fashion; on failure, the test method will
+stop executing and testing move on to the next test method.
+"""
+
+import os
+import struct
+import tempfile
+import zlib
+from scribus import *
+from traceback import print_exc
+from sys import stdout
+from inspect import getmembers, ismethod
+from time import time, sleep
+
+# Longer than the interval at which the file watcher looks for deleted images
+WATCHER_WAIT = 12
+
+def png_file(fileName, width, height):
+    """ Writes an opaque red RGB image """
+    def chunk(kind, data):
+        return struct.pack(">I", len(data)) + kind + data + struct.pack(">I", zlib.crc32(kind + data) & 0xffffffff)
+    rows = b"".join(b"\x00" + b"\xff\x00\x00" * width for y in range(height))
+    with open(fileName, "wb") as f:
+        f.write(b"\x89PNG\r\n\x1a\n")
+        f.write(chunk(b"IHDR", struct.pack(">IIBBBBB", width, height, 8, 2, 0, 0, 0)))
+        f.write(chunk(b"IDAT", zlib.compress(rows)))
+        f.write(chunk(b"IEND", b""))
+
+def image_frames():
+    """ Returns the names of the image frames of the document, in groups too """
+    frames = []
+    for name in getAllObjects():
+        if getObjectType(name) == "ImageFrame":
+            frames.append(name)
+        elif getObjectType(name) == "Group":
+            frames += [item[0] for item in getGroupItems(name, True, 2)]
+    return frames
+
+class PdfImportTests:
+    """ Tests for the PDF importer """
+    def __init__(self):
+        self.directory = tempfile.mkdtemp()
+
+    def image_pdf(self):
+        """ Exports a page holding an image to PDF and returns the file name """
+        imageName = os.path.join(self.directory, "red.png")
+        pdfName = os.path.join(self.directory, "red.pdf")
+        png_file(imageName, 32, 32)
+        newDocument(PAPER_A4, (10, 10, 10, 10), PORTRAIT, 1, UNIT_POINTS, PAGE_1, 0, 1)
+        try:
+            frame = createImage(50, 50, 100, 100)
+            loadImage(imageName, frame)
+            pdf = PDFfile()
+            pdf.file = pdfName
+            pdf.save()
+        finally:
+            closeDoc()
+        return pdfName
+
+    def test_image_kept_in_memory(self):
+        """ Imported images are not dropped by the file watcher """
+        pdfName = self.image_pdf()
+        newDocument(PAPER_A4, (10, 10, 10, 10), PORTRAIT, 1, UNIT_POINTS, PAGE_1, 0, 1)
+        try:
+            placeVectorFile(pdfName, 0, 0)
+            frames = image_frames()
+            check(len(frames) > 0)
+            check(all(getImageColorSpace(frame) != -1 for frame in frames))
+            start_time = time()
+            while time() - start_time < WATCHER_WAIT:
+                processEvents()
+                sleep(0.1)
+            check(all(getImageColorSpace(frame) != -1 for frame in frames))
+        finally:
+            closeDoc()
+
+class TestFailure(Exception):
+    def __init__(self, msg):
+        self.msg = msg
+    def __str__(self):
+        return repr(self.msg)
+
+def check(condition):
+    """ Fails test if condition is false """
+    if not condition:
+        fail('Check failed')
+
+def fail(msg):
+    """ Fails test with msg """
+    raise TestFailure(msg)
+
+def is_test_method(obj):
+    """ Returns True if obj is a test method """
+    return ismethod(obj) and obj.__name__.startswith('test_')
+
+if __name__ == '__main__':
+    print('Running PDF import tests...')
+    tests = PdfImportTests()
+    methods = getmembers(tests, is_test_method)
+    ntests = len(methods)
+    nfailed = 0
+    total_time = 0
+    for testnr, (name, method) in enumerate(methods):
+        print('\t%i/%i: %s()%s' % (testnr + 1, ntests, name, '.' * (30 - len(name))), end=' ')
+        try:
+            start_time = time()
+            method()
+            test_time = time() - start_time
+            total_time += test_time
+        except:
+            print('Failed')
+            print_exc(file=stdout)
+            nfailed += 1
+        else:
+            print('Passed  %.3f s' % round(test_time, 3))
+    print('%i%% passed, %i tests failed out of %i' % (int(round((float(ntests - nfailed)/ntests)*100)), nfailed, ntests))
+    print('total test time = %.3f s' % round(total_time, 3))
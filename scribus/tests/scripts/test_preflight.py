@@ -0,0 +1,152 @@
+#!/usr/bin/env python
+
+"""
+Test script for the preflight verifier.
+
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+
+Run this script from the Script menu. Each test checks a new document, changes
+an item, then checks the document again, so that the results of unchanged
+items are reused from the previous check.
+
+Use check() to check a condition and fail(msg) to manually fail a test. The
+tests are run in a "fail fast" fashion; on failure, the test method will
+stop executing and testing move on to the next test method.
+"""
+
+import json
+from scribus import *
+from traceback import print_exc
+from sys import stdout
+from inspect import getmembers, ismethod
+from time import time
+
+# A profile checking transparency
+PROFILE = "PostScript"
+
+class PreflightTests:
+    """ Tests for the preflight verifier """
+    def item_errors(self, name):
+        """ Checks the document and returns the errors of item name """
+        report = json.loads(exportDocumentCheck("", checkProfileName=PROFILE))
+        errors = []
+        for page_errors in report["pages"].values():
+            errors += [e["error"] for e in page_errors if e["item"] == name]
+        return errors
+
+    def gradient_document(self):
+        """ Creates a document with an opaque gradient filled item """
+        newDocument(PAPER_A4, (10, 10, 10, 10), PORTRAIT, 1, UNIT_POINTS, PAGE_1, 0, 1)
+        createRect(20, 20, 20, 20)
+        item = createRect(60, 20, 20, 20)
+        setGradientFill(FILL_HORIZONTALG, "Black", 100, "White", 100, item)
+        return item
+
+    def test_gradient_stop(self):
+        """ Editing a gradient stop """
+        item = self.gradient_document()
+        try:
+            check("Transparency" not in self.item_errors(item))
+            setGradientStop("White", 100, 0.5, 1.0, item)
+            check("Transparency" in self.item_errors(item))
+            setGradientStop("White", 100, 1.0, 1.0, item)
+            check("Transparency" not in self.item_errors(item))
+        finally:
+            closeDoc()
+
+    def test_gradient_stop_in_batch(self):
+        """ Editing a gradient stop in a script batch """
+        item = self.gradient_document()
+        try:
+            check("Transparency" not in self.item_errors(item))
+            beginBatch()
+            setGradientStop("White", 100, 0.5, 1.0, item)
+            endBatch()
+            check("Transparency" in self.item_errors(item))
+        finally:
+            closeDoc()
+
+    def test_gradient_type(self):
+        """ Removing the gradient of an item """
+        item = self.gradient_document()
+        try:
+            setGradientStop("White", 100, 0.5, 1.0, item)
+            check("Transparency" in self.item_errors(item))
+            setGradientFill(FILL_NOG, "Black", 100, "White", 100, item)
+            check("Transparency" not in self.item_errors(item))
+        finally:
+            closeDoc()
+
+    def test_unchanged_item(self):
+        """ Editing another item """
+        item = self.gradient_document()
+        try:
+            setGradientStop("White", 100, 0.5, 1.0, item)
+            other = createRect(100, 20, 20, 20)
+            check("Transparency" in self.item_errors(item))
+            check("Transparency" not in self.item_errors(other))
+            setFillTransparency(0.5, other)
+            check("Transparency" in self.item_errors(other))
+            # The results of the unchanged item are taken from the previous check
+            check("Transparency" in self.item_errors(item))
+        finally:
+            closeDoc()
+
+    def test_text_overflow(self):
+        """ Editing the text of a frame """
+        newDocument(PAPER_A4, (10, 10, 10, 10), PORTRAIT, 1, UNIT_POINTS, PAGE_1, 0, 1)
+        try:
+            frame = createText(20, 20, 50, 20)
+            setText("Overflowing text " * 50, frame)
+            check("TextOverflow" in self.item_errors(frame))
+            setText("Text", frame)
+            check("TextOverflow" not in self.item_errors(frame))
+            insertText(" overflowing" * 50, -1, frame)
+            check("TextOverflow" in self.item_errors(frame))
+        finally:
+            closeDoc()
+
+class TestFailure(Exception):
+    def __init__(self, msg):
+        self.msg = msg
+    def __str__(self):
+        return repr(self.msg)
+
+def check(condition):
+    """ Fails test if condition is false """
+    if not condition:
+        fail('Check failed')
+
+def fail(msg):
+    """ Fails test with msg """
+    raise TestFailure(msg)
+
+def is_test_method(obj):
+    """ Returns True if obj is a test method """
+    return ismethod(obj) and obj.__name__.startswith('test_')
+
+if __name__ == '__main__':
+    print('Running preflight tests...')
+    tests = PreflightTests()
+    methods = getmembers(tests, is_test_method)
+    ntests = len(methods)
+    nfailed = 0
+    total_time = 0
+    for testnr, (name, method) in enumerate(methods):
+        print('\t%i/%i: %s()%s' % (testnr + 1, ntests, name, '.' * (30 - len(name))), end=' ')
+        try:
+            start_time = time()
+            method()
+            test_time = time() - start_time
+            total_time += test_time
+        except:
+            print('Failed')
+            print_exc(file=stdout)
+            nfailed += 1
+        else:
+            print('Passed  %.3f s' % round(test_time, 3))
+    print('%i%% passed, %i tests failed out of %i' % (int(round((float(ntests - nfailed)/ntests)*100)), nfailed, ntests))
+    print('total test time = %.3f s' % round(total_time, 3))
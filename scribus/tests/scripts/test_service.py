@@ -0,0 +1,162 @@
+#!/usr/bin/env python
+
+"""
+Test script for the headless export service.
+
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+
+Run this script with a regular Python interpreter, not from Scribus:
+
+    python test_service.py /path/to/scribus template.sla
+
+The template must hold at least one item. Each test starts Scribus with
+--service and a single worker, so that all jobs run one after the other in
+the same process, and checks that a job does not see what the jobs before it
+left behind.
+
+Use check() to check a condition and fail(msg) to manually fail a test. The
+tests are run in a "fail fast" fashion; on failure, the test method will
+stop executing and testing move on to the next test method.
+"""
+
+import json
+import os
+import subprocess
+import sys
+import tempfile
+from traceback import print_exc
+from sys import stdout
+from inspect import getmembers, ismethod
+from time import time
+
+# Counts the items of the document into the file given as first argument
+COUNT_SCRIPT = """
+import sys
+import scribus
+with open(sys.argv[1], "w") as f:
+    f.write(str(len(scribus.getAllObjects())))
+"""
+
+# Leaves globals, an imported module and a path entry behind, deletes the
+# items of the document and fails
+POLLUTE_SCRIPT = """
+import sys
+import scribus
+import service_test_module
+LEAKED = 1
+sys.path.append("/service-test-path")
+for name in scribus.getAllObjects():
+    scribus.deleteObject(name)
+raise RuntimeError("failing on purpose")
+"""
+
+# Fails if anything the polluting job left behind is seen
+CHECK_SCRIPT = """
+import sys
+import scribus
+if "LEAKED" in globals():
+    raise AssertionError("globals of a previous job are seen")
+if "service_test_module" in sys.modules:
+    raise AssertionError("modules of a previous job are seen")
+if "/service-test-path" in sys.path:
+    raise AssertionError("sys.path of a previous job is seen")
+with open(sys.argv[1]) as f:
+    if len(scribus.getAllObjects()) != int(f.read()):
+        raise AssertionError("the document was changed by a previous job")
+"""
+
+class ServiceTests:
+    """ Tests for the headless export service """
+    def __init__(self, scribus, template):
+        self.scribus = scribus
+        self.template = template
+        self.directory = tempfile.mkdtemp()
+        self.countFile = os.path.join(self.directory, "count.txt")
+        for name, text in (("count.py", COUNT_SCRIPT), ("pollute.py", POLLUTE_SCRIPT),
+                           ("check.py", CHECK_SCRIPT), ("service_test_module.py", "")):
+            with open(os.path.join(self.directory, name), "w") as f:
+                f.write(text)
+
+    def script_job(self, jobId, script, document=None):
+        """ Returns a job running script on the template """
+        return {"id": jobId, "document": document or self.template,
+                "script": os.path.join(self.directory, script), "args": [self.countFile]}
+
+    def run_jobs(self, jobs):
+        """ Runs jobs with a single worker and returns the responses by job id """
+        service = subprocess.Popen([self.scribus, "--service", "--service-workers", "1"],
+                                   stdin=subprocess.PIPE, stdout=subprocess.PIPE, text=True)
+        output, _ = service.communicate("".join(json.dumps(job) + "\n" for job in jobs))
+        responses = {}
+        for line in output.splitlines():
+            response = json.loads(line)
+            responses[response["id"]] = response
+        check(len(responses) == len(jobs))
+        return responses
+
+    def test_failed_script(self):
+        """ A job after a failing script """
+        responses = self.run_jobs([self.script_job(1, "count.py"),
+                                   self.script_job(2, "pollute.py"),
+                                   self.script_job(3, "check.py")])
+        check(responses[1]["ok"])
+        check(not responses[2]["ok"])
+        check(responses[3]["ok"])
+
+    def test_failed_open(self):
+        """ A job after a document failing to open """
+        missing = os.path.join(self.directory, "missing.sla")
+        responses = self.run_jobs([self.script_job(1, "count.py"),
+                                   self.script_job(2, "check.py", missing),
+                                   self.script_job(3, "check.py")])
+        check(responses[1]["ok"])
+        check(not responses[2]["ok"])
+        check(responses[3]["ok"])
+
+class TestFailure(Exception):
+    def __init__(self, msg):
+        self.msg = msg
+    def __str__(self):
+        return repr(self.msg)
+
+def check(condition):
+    """ Fails test if condition is false """
+    if not condition:
+        fail('Check failed')
+
+def fail(msg):
+    """ Fails test with msg """
+    raise TestFailure(msg)
+
+def is_test_method(obj):
+    """ Returns True if obj is a test method """
+    return ismethod(obj) and obj.__name__.startswith('test_')
+
+if __name__ == '__main__':
+    if len(sys.argv) < 3:
+        print(__doc__)
+        sys.exit(1)
+    print('Running service tests...')
+    tests = ServiceTests(sys.argv[1], os.path.abspath(sys.argv[2]))
+    methods = getmembers(tests, is_test_method)
+    ntests = len(methods)
+    nfailed = 0
+    total_time = 0
+    for testnr, (name, method) in enumerate(methods):
+        print('\t%i/%i: %s()%s' % (testnr + 1, ntests, name, '.' * (30 - len(name))), end=' ')
+        try:
+            start_time = time()
+            method()
+            test_time = time() - start_time
+            total_time += test_time
+        except:
+            print('Failed')
+            print_exc(file=stdout)
+            nfailed += 1
+        else:
+            print('Passed  %.3f s' % round(test_time, 3))
+    print('%i%% passed, %i tests failed out of %i' % (int(round((float(ntests - nfailed)/ntests)*100)), nfailed, ntests))
+    print('total test time = %.3f s' % round(total_time, 3))
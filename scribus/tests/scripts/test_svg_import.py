@@ -0,0 +1,144 @@
+#!/usr/bin/env python
+
+"""
+Test script for the SVG importer.
+
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+
+Run this script from the Script menu. Each test places a generated SVG file
+into a new document. The cancel tests place a file big enough for the import
+to show a progress dialog, and cancel it from a callable run by invokeLater()
+while the import processes events.
+
+Use check() to check a condition and fail(msg) to manually fail a test. The
+tests are run in a "fail fast" fashion; on failure, the test method will
+stop executing and testing move on to the next test method.
+"""
+
+import os
+import tempfile
+from scribus import *
+from traceback import print_exc
+from sys import stdout
+from inspect import getmembers, ismethod
+from time import time
+
+# Rectangles of a file bigger than the size from which the importer shows a progress dialog
+BIG_FILE_RECTS = 150000
+
+def svg_file(fileName, rects):
+    """ Writes an SVG file holding rects rectangles in a group """
+    with open(fileName, "w") as svg:
+        svg.write('<?xml version="1.0" encoding="UTF-8"?>\n')
+        svg.write('<svg xmlns="http://www.w3.org/2000/svg" width="500" height="500" viewBox="0 0 500 500">\n')
+        svg.write('<g style="fill:#c04020">\n')
+        for i in range(rects):
+            svg.write('<rect x="%i" y="%i" width="4" height="4"/>\n' % ((i * 5) % 500, (i // 100) % 500))
+        svg.write('</g>\n')
+        svg.write('</svg>\n')
+
+class SvgImportTests:
+    """ Tests for the SVG importer """
+    def __init__(self):
+        self.directory = tempfile.mkdtemp()
+        self.smallFile = os.path.join(self.directory, "small.svg")
+        svg_file(self.smallFile, 10)
+        self.bigFile = os.path.join(self.directory, "big.svg")
+        svg_file(self.bigFile, BIG_FILE_RECTS)
+
+    def new_document(self):
+        """ Creates a document holding one item """
+        newDocument(PAPER_A4, (10, 10, 10, 10), PORTRAIT, 1, UNIT_POINTS, PAGE_1, 0, 1)
+        createRect(20, 20, 20, 20)
+
+    def place_canceled(self, cancelWhen):
+        """ Places the big file, canceling it as soon as cancelWhen() is true """
+        state = {"importing": True, "canceled": False}
+        def cancel_import():
+            if not state["importing"]:
+                return
+            if cancelWhen() and cancelProgress():
+                state["canceled"] = True
+            else:
+                invokeLater(cancel_import)
+        invokeLater(cancel_import)
+        try:
+            placeSVG(self.bigFile, 0, 0)
+        finally:
+            state["importing"] = False
+        check(state["canceled"])
+
+    def test_import(self):
+        """ Importing a file """
+        self.new_document()
+        try:
+            items = getAllObjects()
+            placeSVG(self.smallFile, 0, 0)
+            check(len(getAllObjects()) > len(items))
+        finally:
+            closeDoc()
+
+    def test_cancel_reading(self):
+        """ Canceling an import while the file is read """
+        self.new_document()
+        try:
+            items = getAllObjects()
+            self.place_canceled(lambda: True)
+            check(getAllObjects() == items)
+        finally:
+            closeDoc()
+
+    def test_cancel_creating_items(self):
+        """ Canceling an import after items were created """
+        self.new_document()
+        try:
+            items = getAllObjects()
+            self.place_canceled(lambda: len(getAllObjects()) > len(items))
+            check(getAllObjects() == items)
+        finally:
+            closeDoc()
+
+class TestFailure(Exception):
+    def __init__(self, msg):
+        self.msg = msg
+    def __str__(self):
+        return repr(self.msg)
+
+def check(condition):
+    """ Fails test if condition is false """
+    if not condition:
+        fail('Check failed')
+
+def fail(msg):
+    """ Fails test with msg """
+    raise TestFailure(msg)
+
+def is_test_method(obj):
+    """ Returns True if obj is a test method """
+    return ismethod(obj) and obj.__name__.startswith('test_')
+
+if __name__ == '__main__':
+    print('Running SVG import tests...')
+    tests = SvgImportTests()
+    methods = getmembers(tests, is_test_method)
+    ntests = len(methods)
+    nfailed = 0
+    total_time = 0
+    for testnr, (name, method) in enumerate(methods):
+        print('\t%i/%i: %s()%s' % (testnr + 1, ntests, name, '.' * (30 - len(name))), end=' ')
+        try:
+            start_time = time()
+            method()
+            test_time = time() - start_time
+            total_time += test_time
+        except:
+            print('Failed')
+            print_exc(file=stdout)
+            nfailed += 1
+        else:
+            print('Passed  %.3f s' % round(test_time, 3))
+    print('%i%% passed, %i tests failed out of %i' % (int(round((float(ntests - nfailed)/ntests)*100)), nfailed, ntests))
+    print('total test time = %.3f s' % round(total_time, 3))
@@ -318,6 +318,29 @@ class TableTests:
                 if objectExists(table2):
                     deleteObject(table2)
 
+    def test_duplicate(self):
+        """ Test for duplicateObject(...) on a table """
+        table1 = createTable(50, 50, 90, 90, 3, 3)
+        mergeTableCells(1, 1, 2, 2, table1)
+        resizeTableRow(0, 20, table1)
+        setCellText(0, 2, 'Original', table1)
+        table2 = duplicateObject(table1)
+        check(table2 != table1)
+        check(getTableRows(table2) == 3)
+        check(getTableColumns(table2) == 3)
+        check(getTableRowHeight(0, table2) == 20)
+        check(getCellText(0, 2, table2) == 'Original')
+        area = set([(1, 1), (1, 2), (2, 1), (2, 2)])
+        self.check_spans(area, 2, 2, table2)
+
+        # The copy has its own cells.
+        setCellText(0, 2, 'Copy', table2)
+        check(getCellText(0, 2, table1) == 'Original')
+        check(getCellText(0, 2, table2) == 'Copy')
+        deleteObject(table1)
+        check(getCellText(0, 2, table2) == 'Copy')
+        deleteObject(table2)
+
     def check_spans(self, area, expected_row_span, expected_column_span, table):
         """
         Utility method for cell span checking.
@@ -9,6 +9,7 @@
 
 #include <QDebug>
 #include "testStoryText.h"
+#include "text/storytextbuilder.h"
 
 void TestStoryText::initST()
 {
@@ -127,3 +128,94 @@ void TestStoryText::removeCharStyle()
 	QCOMPARE(story.startOfRun(2), 5  + 26 + 1);
 	QCOMPARE(story.endOfRun(2), 11 + 26);
 }
+
+void TestStoryText::changedSince()
+{
+	StoryText story;
+	story.insertChars(0, QString("Hallo") + SpecialChars::PARSEP + QString("schöne") + SpecialChars::PARSEP + QString("Welt"));
+	quint64 revision = story.revision();
+	int firstChanged = -1;
+	int unchangedTail = -1;
+
+	story.insertChars(8, "xx");
+	QVERIFY(story.changedSince(revision, firstChanged, unchangedTail));
+	QCOMPARE(firstChanged, 8);
+	QCOMPARE(unchangedTail, story.length() - 10);
+
+	// Removed characters only move what follows
+	story.removeChars(1, 2);
+	QVERIFY(story.changedSince(revision, firstChanged, unchangedTail));
+	QCOMPARE(firstChanged, 1);
+	QCOMPARE(unchangedTail, story.length() - 8);
+	QCOMPARE(story.text(story.length() - unchangedTail, unchangedTail), QString("höne") + SpecialChars::PARSEP + QString("Welt"));
+
+	// Nothing changed since the current revision
+	QVERIFY(story.changedSince(story.revision(), firstChanged, unchangedTail));
+	QCOMPARE(firstChanged + unchangedTail, story.length());
+
+	// Replacing the whole text loses the changes
+	StoryText other;
+	other.insertChars(0, "Welt");
+	story = other;
+	QVERIFY(!story.changedSince(revision, firstChanged, unchangedTail));
+}
+
+void TestStoryText::storyTextBuilder()
+{
+	ParagraphStyle centered;
+	centered.setAlignment(ParagraphStyle::Centered);
+	ParagraphStyle right;
+	right.setAlignment(ParagraphStyle::RightAligned);
+	CharStyle small;
+	small.setFontSize(80);
+	CharStyle large;
+	large.setFontSize(240);
+
+	// Runs appended and styled the way text importers do
+	StoryText direct;
+	direct.insertChars(0, "Hallo ");
+	direct.applyStyle(0, centered);
+	direct.applyCharStyle(0, 6, small);
+	direct.insertChars(6, "Welt");
+	direct.applyCharStyle(6, 4, large);
+	direct.insertChars(10, SpecialChars::PARSEP);
+	direct.applyStyle(10, centered);
+	direct.insertChars(11, QString("schöne") + SpecialChars::PARSEP + QString("neue"));
+	direct.applyStyle(11, right);
+	direct.applyCharStyle(11, 11, small);
+
+	StoryText built;
+	QSignalSpy changedSpy(&built, SIGNAL(changed(int,int)));
+	{
+		StoryTextBuilder builder(built);
+		builder.append("Hallo ");
+		builder.applyStyle(0, centered);
+		builder.applyCharStyle(0, 6, small);
+		builder.append("Welt");
+		builder.applyCharStyle(6, 4, large);
+		builder.append(SpecialChars::PARSEP);
+		builder.applyStyle(10, centered);
+		QCOMPARE(builder.length(), 11);
+		builder.append(QString("schöne") + SpecialChars::PARSEP + QString("neue"));
+		builder.applyStyle(11, right);
+		builder.applyCharStyle(11, 11, small);
+		QCOMPARE(changedSpy.count(), 0);
+	}
+	QCOMPARE(changedSpy.count(), 1);
+	QCOMPARE(changedSpy.at(0).at(0).toInt(), 0);
+	QCOMPARE(changedSpy.at(0).at(1).toInt(), built.length());
+
+	QCOMPARE(built.text(0, built.length()), direct.text(0, direct.length()));
+	QCOMPARE(built.nrOfParagraphs(), direct.nrOfParagraphs());
+	QCOMPARE(built.nrOfRuns(), direct.nrOfRuns());
+	for (int i = 0; i < static_cast<int>(direct.nrOfRuns()); ++i)
+	{
+		QCOMPARE(built.startOfRun(i), direct.startOfRun(i));
+		QCOMPARE(built.endOfRun(i), direct.endOfRun(i));
+	}
+	for (int i = 0; i < direct.length(); ++i)
+	{
+		QCOMPARE(built.charStyle(i).fontSize(), direct.charStyle(i).fontSize());
+		QCOMPARE(built.paragraphStyle(i).alignment(), direct.paragraphStyle(i).alignment());
+	}
+}
@@ -27,4 +27,6 @@ private slots:
 	void removePars();
 	void applyCharStyle();
 	void removeCharStyle();
+	void changedSince();
+	void storyTextBuilder();
 };
@@ -5,6 +5,7 @@ a copyright and/or license notice that predates the release of Scribus 1.3.2
 for which a new license (GPL+exception) is in place.
 */
 
+#include <atomic>
 #include <cassert>  //added to make Fedora-5 happy
 
 //#include <QDebug>
@@ -16,6 +17,13 @@ for which a new license (GPL+exception) is in place.
 #include "sctext_shared.h"
 #include "util.h"
 
+namespace
+{
+	// Revisions stay unique when stories are changed from several threads
+	std::atomic<quint64> nextRevision { 1 };
+	const int maxChangeLogSize = 256;
+}
+
 ScText_Shared::ScText_Shared(const StyleContext* pstyles) :
 	pstyleContext(nullptr)
 {
@@ -23,6 +31,7 @@ ScText_Shared::ScText_Shared(const StyleContext* pstyles) :
 	defaultStyle.setContext( pstyles );
 	trailingStyle.setContext( &pstyleContext );
 	orphanedCharStyle.setContext( defaultStyle.charStyle().context() );
+	markChanged();
 //		qDebug() << QString("ScText_Shared() %1 %2 %3 %4").arg(reinterpret_cast<uint>(this)).arg(reinterpret_cast<uint>(&defaultStyle)).arg(reinterpret_cast<uint>(pstyles)).arg(reinterpret_cast<uint>(cstyles));
 }
 		
@@ -38,6 +47,7 @@ ScText_Shared::ScText_Shared(const ScText_Shared& other) :
 	pstyleContext.setDefaultStyle( &defaultStyle );
 	trailingStyle.setContext( &pstyleContext );
 	orphanedCharStyle.setContext( defaultStyle.charStyle().context() );
+	markChanged();
 
 	QListIterator<ScText*> it( other );
 	const ScText* elem;
@@ -68,6 +78,30 @@ void ScText_Shared::clear()
 	if (marksCount > 0)
 		marksCountChanged = true;
 	marksCount = 0;
+	markChanged();
+}
+
+void ScText_Shared::markChanged()
+{
+	revision = nextRevision.fetch_add(1);
+	// What changed is not known, forget the older changes
+	changeLog.clear();
+	changeLogStart = revision;
+}
+
+void ScText_Shared::markChanged(int first, int end)
+{
+	revision = nextRevision.fetch_add(1);
+	ChangeRecord record;
+	record.revision = revision;
+	record.first = qMax(0, first);
+	record.unchangedTail = qMax(0, static_cast<int>(count()) - qMax(first, end));
+	changeLog.append(record);
+	if (changeLog.count() > maxChangeLogSize)
+	{
+		changeLogStart = changeLog.first().revision;
+		changeLog.removeFirst();
+	}
 }
 
 ScText_Shared& ScText_Shared::operator= (const ScText_Shared& other) 
@@ -81,6 +115,7 @@ ScText_Shared& ScText_Shared::operator= (const ScText_Shared& other)
 		defaultStyle.setContext( other.defaultStyle.context() );
 		trailingStyle.setContext( &pstyleContext );
 		orphanedCharStyle.setContext( other.defaultStyle.charStyle().context() );
+		markChanged();
 		clear();
 		QListIterator<ScText*> it( other );
 		const ScText* elem;
@@ -4,6 +4,7 @@
 #include <QList>
 #include <QObject>
 #include <QString>
+#include <QVector>
 #include <cassert>
 
 //#include "text/paragraphlayout.h"
@@ -32,10 +33,26 @@ public:
 	int  selLast { -1 };
 	uint marksCount { 0 };
 	bool marksCountChanged { false };
+	/// Changed with the text, see StoryText::revision()
+	quint64 revision { 0 };
+	/// Range touched by a change, see StoryText::changedSince()
+	struct ChangeRecord
+	{
+		quint64 revision { 0 };
+		int first { 0 };
+		int unchangedTail { 0 };
+	};
+	/// Latest changes, the ones made after changeLogStart are all recorded
+	QVector<ChangeRecord> changeLog;
+	quint64 changeLogStart { 0 };
 	ParagraphStyle trailingStyle;
 	CharStyle orphanedCharStyle;
 
 	void clear();
+	/// Gives the text a new revision, unique for the whole application
+	void markChanged();
+	/// Same as markChanged() and records that only [first, end) changed
+	void markChanged(int first, int end);
 	
 	/**
 	   A char's stylecontext is the containing paragraph's style, 
@@ -144,6 +144,31 @@ bool StoryText::marksCountChanged() const
 	return false;
 }
 
+quint64 StoryText::revision() const
+{
+	return d ? d->revision : 0;
+}
+
+bool StoryText::changedSince(quint64 revision, int& firstChanged, int& unchangedTail) const
+{
+	if (!d || (revision == 0) || (revision < d->changeLogStart))
+		return false;
+	int len = length();
+	firstChanged = len;
+	unchangedTail = len;
+	for (int i = d->changeLog.count() - 1; i >= 0; --i)
+	{
+		const ScText_Shared::ChangeRecord& record = d->changeLog.at(i);
+		if (record.revision <= revision)
+			break;
+		firstChanged = qMin(firstChanged, record.first);
+		unchangedTail = qMin(unchangedTail, record.unchangedTail);
+	}
+	firstChanged = qMin(firstChanged, len);
+	unchangedTail = qMin(unchangedTail, len - firstChanged);
+	return true;
+}
+
 void StoryText::resetMarksCountChanged()
 {
 	d->marksCountChanged = false;
@@ -699,7 +724,8 @@ void StoryText::removeChars(int pos, uint len)
 		d->selFirst =  0;
 		d->selLast  = -1;
 	}
-	invalidate(pos, length());
+	// What follows the removed characters only moved
+	invalidate(pos, length(), pos);
 }
 
 void StoryText::trim()
@@ -1331,6 +1357,7 @@ void StoryText::replaceMark(int pos, Mark* mrk)
 
 	// Set marksCountChanged unconditionally to force text relayout
 	d->marksCountChanged = true;
+	d->markChanged(pos, pos + 1);
 }
 
 
@@ -1377,6 +1404,7 @@ void StoryText::setFlag(int pos, LayoutFlags flags)
 	assert((flags & ScStyle_UserStyles) == ScStyle_None);
 
 	d->at(pos)->setEffects(flags | d->at(pos)->effects().value);
+	d->markChanged(pos, pos + 1);
 }
 
 void StoryText::clearFlag(int pos, LayoutFlags flags)
@@ -1388,6 +1416,7 @@ void StoryText::clearFlag(int pos, LayoutFlags flags)
 	assert(pos < length());
 
 	d->at(pos)->setEffects(~(flags & ScStyle_NonUserStyles) & d->at(pos)->effects().value);
+	d->markChanged(pos, pos + 1);
 }
 
 
@@ -2254,6 +2283,12 @@ void StoryText::invalidateAll()
 
 void StoryText::invalidate(int firstItem, int endItem)
 {
+	invalidate(firstItem, endItem, endItem);
+}
+
+void StoryText::invalidate(int firstItem, int endItem, int changedEnd)
+{
+	d->markChanged(firstItem, changedEnd);
 	for (int i = firstItem; i < endItem; ++i)
 	{
 		ParagraphStyle* par = item(i)->parstyle;
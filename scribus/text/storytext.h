@@ -85,6 +85,16 @@ public:
 	bool hasBulletOrNum() const;
 	bool hasTextMarks() const;
 	bool marksCountChanged() const;
+	/// Changes whenever the text, its styles or its hyphenation change
+	quint64 revision() const;
+	/**
+	 * Tells which part of the text changed after the given revision: the
+	 * characters before firstChanged and the last unchangedTail characters
+	 * are the same, apart from their position. Returns false if this is not
+	 * known, because the whole text was replaced or too many changes were
+	 * made since.
+	 */
+	bool changedSince(quint64 revision, int& firstChanged, int& unchangedTail) const;
 	void resetMarksCountChanged();
 	
 	void setDoc(ScribusDoc *docin);
@@ -335,6 +345,8 @@ private:
 	
 	/// mark these runs as invalid, ie. need itemize and shaping
 	void invalidate(int firstRun, int lastRun);
+	/// same, when only [firstRun, changedEnd) changed and the runs after it only moved
+	void invalidate(int firstRun, int lastRun, int changedEnd);
 	void removeParSep(int pos);
 	void insertParSep(int pos);
 
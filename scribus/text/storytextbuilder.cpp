@@ -0,0 +1,94 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#include "storytextbuilder.h"
+
+#include "specialchars.h"
+#include "storytext.h"
+
+StoryTextBuilder::StoryTextBuilder(StoryText& story)
+	: m_story(story)
+{
+}
+
+StoryTextBuilder::~StoryTextBuilder()
+{
+	commit();
+}
+
+int StoryTextBuilder::length() const
+{
+	return m_story.length() + m_pending.length();
+}
+
+void StoryTextBuilder::append(QChar ch)
+{
+	begin(length());
+	m_pending.append(ch);
+}
+
+void StoryTextBuilder::append(const QString& text)
+{
+	if (text.isEmpty())
+		return;
+	begin(length());
+	m_pending.append(text);
+}
+
+void StoryTextBuilder::applyCharStyle(int pos, int len, const CharStyle& style)
+{
+	begin(pos);
+	flush();
+	m_story.applyCharStyle(pos, len, style);
+}
+
+void StoryTextBuilder::applyStyle(int pos, const ParagraphStyle& style)
+{
+	begin(pos);
+	flush();
+	m_story.applyStyle(pos, style);
+}
+
+void StoryTextBuilder::commit()
+{
+	if (m_firstChanged < 0)
+		return;
+	flush();
+	m_story.blockSignals(m_signalsWereBlocked);
+	// The edits already marked the story changed, only the signal was held back
+	emit m_story.changed(qMin(m_firstChanged, m_story.length()), m_story.length());
+	m_firstChanged = -1;
+}
+
+void StoryTextBuilder::begin(int pos)
+{
+	if (m_firstChanged < 0)
+	{
+		m_signalsWereBlocked = m_story.blockSignals(true);
+		m_firstChanged = pos;
+	}
+	else
+		m_firstChanged = qMin(m_firstChanged, pos);
+}
+
+void StoryTextBuilder::flush()
+{
+	if (m_pending.isEmpty())
+		return;
+	// A paragraph separator changes the style context of the characters
+	// following it, so insert each paragraph separately as inserting
+	// character by character would do.
+	int start = 0;
+	while (start < m_pending.length())
+	{
+		int end = m_pending.indexOf(SpecialChars::PARSEP, start);
+		end = (end < 0) ? m_pending.length() : end + 1;
+		m_story.insertChars(m_story.length(), m_pending.mid(start, end - start));
+		start = end;
+	}
+	m_pending.clear();
+}
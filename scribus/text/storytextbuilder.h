@@ -0,0 +1,65 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#ifndef STORYTEXTBUILDER_H
+#define STORYTEXTBUILDER_H
+
+#include <QChar>
+#include <QString>
+
+#include "scribusapi.h"
+
+class CharStyle;
+class ParagraphStyle;
+class StoryText;
+
+/**
+ * Appends text to a StoryText in bulk.
+ *
+ * Text importers build a story piece by piece, often one character at a
+ * time, and style what they just appended. Going through StoryText directly
+ * emits a change notification, and thus a relayout request, for every single
+ * edit. StoryTextBuilder buffers consecutive appends and performs all edits
+ * with the story's signals blocked. A single invalidation covering the whole
+ * modified range is emitted by commit(), which the destructor also calls.
+ *
+ * The result is the same as issuing the calls on the story directly and in
+ * the same order. While a builder is active on a story, the story must not
+ * be edited through other means without calling commit() first.
+ */
+class SCRIBUS_API StoryTextBuilder
+{
+public:
+	explicit StoryTextBuilder(StoryText& story);
+	~StoryTextBuilder();
+
+	StoryTextBuilder(const StoryTextBuilder&) = delete;
+	StoryTextBuilder& operator=(const StoryTextBuilder&) = delete;
+
+	/// Length of the story including text not yet inserted
+	int length() const;
+
+	void append(QChar ch);
+	void append(const QString& text);
+
+	void applyCharStyle(int pos, int len, const CharStyle& style);
+	void applyStyle(int pos, const ParagraphStyle& style);
+
+	/// Inserts buffered text, restores the story signals and notifies the story change
+	void commit();
+
+private:
+	StoryText& m_story;
+	QString m_pending;
+	int m_firstChanged { -1 };
+	bool m_signalsWereBlocked { false };
+
+	void begin(int pos);
+	void flush();
+};
+
+#endif
@@ -12,11 +12,18 @@
 #include "styles/charstyle.h"
 
 StoryTextSnapshot StoryTextSnapshot::create(const StoryText& story)
+{
+	return create(story, 0, story.length());
+}
+
+StoryTextSnapshot StoryTextSnapshot::create(const StoryText& story, int start, int end)
 {
 	StoryTextSnapshot snapshot;
 
-	int storyLength = story.length();
-	if (storyLength == 0)
+	start = qMax(0, start);
+	end = qMin(end, story.length());
+	int rangeLength = end - start;
+	if (rangeLength <= 0)
 		return snapshot;
 
 	// Build everything in a single pass over the StoryText.
@@ -24,17 +31,18 @@ StoryTextSnapshot StoryTextSnapshot::create(const StoryText& story)
 	// plainText, paragraph boundaries, and language runs all use
 	// consistent positions in the filtered text.
 
-	snapshot.plainText.reserve(storyLength);
-	snapshot.toOriginal.reserve(storyLength);
-	snapshot.paragraphs.reserve(story.nrOfParagraphs());
-	snapshot.languages.reserve(storyLength / 10);
+	snapshot.plainText.reserve(rangeLength);
+	snapshot.toOriginal.reserve(rangeLength);
+	if (rangeLength == story.length())
+		snapshot.paragraphs.reserve(story.nrOfParagraphs());
+	snapshot.languages.reserve(rangeLength / 10);
 
 	int outPos = 0;        // current position in filtered plainText
 	int paraStart = 0;     // start of current paragraph in filtered text
 	int langRunStart = 0;  // start of current language run in filtered text
 	QString currentLang;
 
-	for (int i = 0; i < storyLength; ++i)
+	for (int i = start; i < end; ++i)
 	{
 		QChar ch = story.text(i);
 
@@ -110,6 +110,15 @@ class SCRIBUS_API StoryTextSnapshot
 		 */
 		static StoryTextSnapshot create(const StoryText& story);
 
+		/**
+		 * @brief Create a snapshot of the characters [start, end) of a StoryText
+		 *
+		 * Positions in the snapshot start at 0 while toOriginal still gives
+		 * positions in the whole StoryText. The range should start and end
+		 * on paragraph boundaries.
+		 */
+		static StoryTextSnapshot create(const StoryText& story, int start, int end);
+
 		/**
 		 * @brief Get the text of a specific paragraph
 		 *
@@ -7,13 +7,13 @@
  *                                                                         *
  ***************************************************************************/
 
-#include <QCryptographicHash>
 #include <QDebug>
 
 #include "pageitem_textframe.h"
 #include "scribusdoc.h"
 #include "scribusview.h"
 #include "spellcheckfunctions.h"
+#include "text/specialchars.h"
 #include "text/storytext.h"
 #include "textframespellchecker.h"
 
@@ -52,6 +52,11 @@ TextFrameSpellChecker::TextFrameSpellChecker(QObject* parent)
 	m_debounceTimer.setInterval(m_debounceDelay);
 	connect(&m_debounceTimer, &QTimer::timeout, this, &TextFrameSpellChecker::onDebounceTimeout);
 
+	// Setup idle timer for the whole document pass
+	m_backgroundTimer.setSingleShot(true);
+	m_backgroundTimer.setInterval(100);
+	connect(&m_backgroundTimer, &QTimer::timeout, this, &TextFrameSpellChecker::onBackgroundTimeout);
+
 	// Create worker thread and worker object
 	m_workerThread = new QThread(this);
 	m_worker = new SpellCheckerWorker();
@@ -127,8 +132,9 @@ void TextFrameSpellChecker::pauseChecking()
 		QMetaObject::invokeMethod(m_worker, [this]() { m_worker->setPaused(true); }, Qt::QueuedConnection);
 	}
 	
-	// Stop debounce timer
+	// Stop debounce and background timers
 	m_debounceTimer.stop();
+	m_backgroundTimer.stop();
 }
 
 void TextFrameSpellChecker::resumeChecking()
@@ -151,6 +157,8 @@ void TextFrameSpellChecker::resumeChecking()
 		if (state.needsRecheck)
 			scheduleCheck(m_activeFrame);
 	}
+
+	scheduleBackgroundCheck();
 }
 
 bool TextFrameSpellChecker::isThreadRunning() const
@@ -178,14 +186,16 @@ void TextFrameSpellChecker::setEnabled(bool enabled)
 	
 	if (!enabled)
 	{
-		// Disable: stop debounce timer
+		// Disable: stop debounce and background timers
 		m_debounceTimer.stop();
+		m_backgroundTimer.stop();
 	}
 	else
 	{
 		// Enable: check active frame if any
 		if (m_activeFrame)
 			scheduleCheck(m_activeFrame);
+		scheduleBackgroundCheck();
 	}
 }
 
@@ -238,7 +248,6 @@ void TextFrameSpellChecker::frameActivated(PageItem_TextFrame* frame)
 	{
 		m_debounceTimer.stop();
 		m_activeFrame = frame;
-		m_currentSnapshot = StoryTextSnapshot();
 	}
 
 	FrameState& state = getFrameState(frame);
@@ -261,7 +270,6 @@ void TextFrameSpellChecker::frameDeactivated(PageItem_TextFrame* frame)
 		return;
 	m_activeFrame = nullptr;
 	m_debounceTimer.stop();
-	m_currentSnapshot = StoryTextSnapshot();
 }
 
 void TextFrameSpellChecker::frameTextChanged(PageItem_TextFrame* frame)
@@ -270,14 +278,10 @@ void TextFrameSpellChecker::frameTextChanged(PageItem_TextFrame* frame)
 	if (!frame || !m_enabled || m_paused)
 		return;
 	
-	// Mark as needing recheck
+	// Mark as needing recheck, only the changed paragraphs will be checked again
 	FrameState& state = getFrameState(frame);
-
-	QString currentHash = calculateTextHash(frame);
-	if (currentHash == state.textHash)
-		return;  // Formatting changed but not content — skip recheck
-	state.textHash = currentHash;
-
+	if (frame->itemText.revision() == state.checkedRevision)
+		return;
 	state.needsRecheck = true;
 	
 	// If this is the active frame, schedule a check
@@ -294,7 +298,7 @@ void TextFrameSpellChecker::frameLanguageChanged(PageItem_TextFrame* frame)
 	FrameState& state = getFrameState(frame);
 	state.needsRecheck = true;
 	state.cachedErrors.clear();
-	state.textHash.clear();
+	state.checkedRevision = 0;
 	
 	if (frame == m_activeFrame && !m_paused)
 		checkFrameNow(frame);
@@ -309,22 +313,57 @@ void TextFrameSpellChecker::frameDeleted(PageItem_TextFrame* frame)
 	{
 		m_activeFrame = nullptr;
 		m_debounceTimer.stop();
-		m_currentSnapshot = StoryTextSnapshot();
 	}
 	
 	if (m_checkingFrame == frame)
 		m_checkingFrame = nullptr;
+
+	m_backgroundQueue.removeAll(frame);
+	if (m_backgroundFrame == frame)
+	{
+		m_backgroundFrame = nullptr;
+		scheduleBackgroundCheck();
+	}
+
+	if (m_worker)
+		QMetaObject::invokeMethod(m_worker, [this, frame]() { m_worker->forgetFrame(frame); }, Qt::QueuedConnection);
 	
 	removeFrameState(frame);
 }
 
+void TextFrameSpellChecker::checkDocument(ScribusDoc* doc)
+{
+	if (!doc || !m_enabled)
+		return;
+
+	// Linked frames share their story, so queue the first frame of each chain only
+	const QList<PageItem*> allItems = doc->getAllItems(doc->DocItems);
+	for (PageItem* item : allItems)
+	{
+		if (!item->isTextFrame() || item->prevInChain() != nullptr)
+			continue;
+		PageItem_TextFrame* frame = item->asTextFrame();
+		if (!m_backgroundQueue.contains(frame))
+			m_backgroundQueue.append(frame);
+	}
+
+	// Keep room for the results of the whole document pass
+	m_backgroundCapacity = m_backgroundQueue.count() + 1;
+	scheduleBackgroundCheck();
+}
+
 void TextFrameSpellChecker::documentClosed()
 {
 	m_debounceTimer.stop();
+	m_backgroundTimer.stop();
 	m_activeFrame = nullptr;
 	m_checkingFrame = nullptr;
-	m_currentSnapshot = StoryTextSnapshot();
+	m_backgroundFrame = nullptr;
+	m_backgroundQueue.clear();
+	m_backgroundCapacity = 0;
 	m_frameStates.clear();
+	if (m_worker)
+		QMetaObject::invokeMethod(m_worker, [this]() { m_worker->clearParagraphCache(); }, Qt::QueuedConnection);
 	++m_generation;
 }
 
@@ -335,6 +374,7 @@ void TextFrameSpellChecker::dumpStats() const
 	qDebug() << "  Generation:" << m_generation;
 	qDebug() << "  Active frame:" << m_activeFrame;
 	qDebug() << "  Checking frame:" << m_checkingFrame;
+	qDebug() << "  Background queue:" << m_backgroundQueue.size();
 	qDebug() << "  Checks performed:" << m_checkCount;
 
 	int totalErrors = 0;
@@ -344,7 +384,6 @@ void TextFrameSpellChecker::dumpStats() const
 		totalErrors += it->cachedErrors.size();
 		for (const SpellError& e : it->cachedErrors)
 			totalStringBytes += (e.word.size() + e.language.size()) * sizeof(QChar);
-		totalStringBytes += it->textHash.size() * sizeof(QChar);
 	}
 
 	qDebug() << "  Total cached errors:" << totalErrors;
@@ -388,6 +427,51 @@ void TextFrameSpellChecker::onDebounceTimeout()
 		performCheck(m_activeFrame);
 }
 
+void TextFrameSpellChecker::scheduleBackgroundCheck()
+{
+	if (!m_enabled || m_paused || m_backgroundQueue.isEmpty())
+		return;
+	if (!m_backgroundTimer.isActive())
+		m_backgroundTimer.start();
+}
+
+void TextFrameSpellChecker::onBackgroundTimeout()
+{
+	if (!m_enabled || m_paused || !isThreadRunning())
+		return;
+
+	// The frame being edited always has priority, retry later
+	if (m_checkingFrame || m_backgroundFrame || m_debounceTimer.isActive())
+	{
+		scheduleBackgroundCheck();
+		return;
+	}
+
+	while (!m_backgroundQueue.isEmpty())
+	{
+		PageItem_TextFrame* frame = m_backgroundQueue.takeFirst();
+		if (frame == m_activeFrame)
+			continue;
+		if (frame->itemText.length() == 0)
+			continue;
+		auto it = m_frameStates.constFind(frame);
+		if (it != m_frameStates.constEnd() && !it->needsRecheck)
+			continue;
+
+		FrameState& state = getFrameState(frame);
+		SpellCheckRequest request = createRequest(frame, state);
+		state.needsRecheck = false;
+
+		m_backgroundFrame = frame;
+		m_backgroundRevision = frame->itemText.revision();
+		m_backgroundLength = frame->itemText.length();
+		emit requestCheck(frame, request, m_generation);
+		return;
+	}
+
+	m_backgroundCapacity = 0;
+}
+
 void TextFrameSpellChecker::performCheck(PageItem_TextFrame* frame)
 {
 	// qDebug()<<Q_FUNC_INFO;
@@ -401,7 +485,7 @@ void TextFrameSpellChecker::performCheck(PageItem_TextFrame* frame)
 	}
 
 	// Don't queue another snapshot if one is already pending for this frame
-	if (m_checkingFrame == frame)
+	if (m_checkingFrame == frame || m_backgroundFrame == frame)
 	{
 		// Mark it so we recheck after the current one completes
 		FrameState& state = getFrameState(frame);
@@ -411,26 +495,68 @@ void TextFrameSpellChecker::performCheck(PageItem_TextFrame* frame)
 
 	++m_checkCount;
 	
-	// Create snapshot
-	m_currentSnapshot = frame->itemText.createSnapshot();
-	
-	// Calculate and store text hash
+	// Snapshot of the paragraphs changed since the last check
 	FrameState& state = getFrameState(frame);
-	state.textHash = calculateTextHash(frame);
+	SpellCheckRequest request = createRequest(frame, state);
 	state.needsRecheck = false;
 	
-	// Remember which frame we're checking
+	// Remember which frame and text revision we're checking
 	m_checkingFrame = frame;
+	m_checkingRevision = frame->itemText.revision();
+	m_checkingLength = frame->itemText.length();
 	
 	// Emit signal
 	emit checkStarted(frame);
 	
 	// Send to worker thread via signal
-	// The snapshot is copied (safely) when emitted
-	emit requestCheck(frame, m_currentSnapshot, m_generation);
-	
-	// Clear snapshot in main thread (worker has its own copy)
-	m_currentSnapshot = StoryTextSnapshot();
+	// The request is copied (safely) when emitted
+	emit requestCheck(frame, request, m_generation);
+}
+
+SpellCheckRequest TextFrameSpellChecker::createRequest(PageItem_TextFrame* frame, const FrameState& state) const
+{
+	SpellCheckRequest request;
+	const StoryText& story = frame->itemText;
+	int firstChanged = 0;
+	int unchangedTail = 0;
+	if (!story.changedSince(state.checkedRevision, firstChanged, unchangedTail))
+	{
+		request.snapshot = story.createSnapshot();
+		return request;
+	}
+
+	// Extend the changed range to whole paragraphs
+	int storyLength = story.length();
+	int start = 0;
+	if (firstChanged > 0)
+	{
+		int parSep = story.prevParagraph(firstChanged);
+		if (story.text(parSep) == SpecialChars::PARSEP)
+			start = parSep + 1;
+	}
+	int end = qMax(firstChanged, storyLength - unchangedTail);
+	while (end < storyLength && story.text(end) != SpecialChars::PARSEP)
+		++end;
+	end = qMin(storyLength, end + 1);
+
+	// Keep the errors of the unchanged text around it, moved to their current position
+	int oldEnd = state.checkedLength - (storyLength - end);
+	int shift = storyLength - state.checkedLength;
+	for (const SpellError& error : state.cachedErrors)
+	{
+		if (error.position + error.length <= start)
+			request.keptBefore.append(error);
+		else if (error.position >= oldEnd)
+		{
+			SpellError moved = error;
+			moved.position += shift;
+			request.keptAfter.append(moved);
+		}
+	}
+
+	request.partial = true;
+	request.snapshot = StoryTextSnapshot::create(story, start, end);
+	return request;
 }
 
 void TextFrameSpellChecker::onCheckComplete(PageItem_TextFrame* frame, const QVector<SpellError>& errors, int generation)
@@ -443,9 +569,46 @@ void TextFrameSpellChecker::onCheckComplete(PageItem_TextFrame* frame, const QVe
 
 	if (!frame)
 		return;
+
+	if (frame == m_backgroundFrame)
+	{
+		m_backgroundFrame = nullptr;
+
+		// Share the results with every frame of the chain, repainting the frames whose errors changed
+		for (PageItem* item = frame; item != nullptr; item = item->nextInChain())
+		{
+			if (!item->isTextFrame())
+				continue;
+			PageItem_TextFrame* chainFrame = item->asTextFrame();
+			FrameState& chainState = getFrameState(chainFrame);
+			chainState.checkedRevision = m_backgroundRevision;
+			chainState.checkedLength = m_backgroundLength;
+			if (chainState.cachedErrors == errors)
+				continue;
+			chainState.cachedErrors = errors;
+			emit resultsReady(chainFrame, errors);
+			if (chainFrame->doc())
+				chainFrame->doc()->regionsChanged()->update(chainFrame->getBoundingRect());
+		}
+
+		// The frame may have been activated and edited while it was checked
+		if (getFrameState(frame).needsRecheck && frame == m_activeFrame)
+			performCheck(frame);
+		else
+			scheduleBackgroundCheck();
+		return;
+	}
+
+	if (frame != m_checkingFrame)
+	{
+		// Frame was deleted or its check cancelled meanwhile
+		return;
+	}
 	
 	// Store in cache
 	FrameState& state = getFrameState(frame);
+	state.checkedRevision = m_checkingRevision;
+	state.checkedLength = m_checkingLength;
 
 	// Don't trigger a repaint if nothing changed
 	if (state.cachedErrors.size() == errors.size() && state.cachedErrors == errors)
@@ -455,6 +618,8 @@ void TextFrameSpellChecker::onCheckComplete(PageItem_TextFrame* frame, const QVe
 		// Still check if a recheck was requested while we were busy
 		if (state.needsRecheck && frame == m_activeFrame)
 			performCheck(frame);
+		else
+			scheduleBackgroundCheck();
 		return;
 	}
 
@@ -474,6 +639,8 @@ void TextFrameSpellChecker::onCheckComplete(PageItem_TextFrame* frame, const QVe
 	// If text changed again while we were checking, go again
 	if (state.needsRecheck && frame == m_activeFrame)
 		performCheck(frame);
+	else
+		scheduleBackgroundCheck();
 }
 
 // ============================================================================
@@ -502,8 +669,10 @@ bool TextFrameSpellChecker::isCheckingFrame(PageItem_TextFrame* frame) const
 void TextFrameSpellChecker::cancelAll()
 {
 	m_debounceTimer.stop();
+	m_backgroundTimer.stop();
 	m_checkingFrame = nullptr;
-	m_currentSnapshot = StoryTextSnapshot();
+	m_backgroundFrame = nullptr;
+	m_backgroundQueue.clear();
 	
 	// Note: We can't cancel work already sent to the worker thread
 	// (it doesn't have a cancel mechanism built in yet)
@@ -513,15 +682,18 @@ void TextFrameSpellChecker::cancelAll()
 void TextFrameSpellChecker::clearCache()
 {
 	m_frameStates.clear();
+	if (m_worker)
+		QMetaObject::invokeMethod(m_worker, [this]() { m_worker->clearParagraphCache(); }, Qt::QueuedConnection);
+	clearSpellWordCache();
 }
 
 TextFrameSpellChecker::FrameState& TextFrameSpellChecker::getFrameState(PageItem_TextFrame* frame)
 {
-	if (!m_frameStates.contains(frame) && m_frameStates.size() >= m_maxCachedFrames)
+	if (!m_frameStates.contains(frame) && m_frameStates.size() >= qMax(m_maxCachedFrames, m_backgroundCapacity))
 	{
 		for (auto it = m_frameStates.begin(); it != m_frameStates.end(); ++it)
 		{
-			if (it.key() != m_activeFrame && it.key() != m_checkingFrame)
+			if (it.key() != m_activeFrame && it.key() != m_checkingFrame && it.key() != m_backgroundFrame)
 			{
 				m_frameStates.erase(it);
 				break;
@@ -537,19 +709,6 @@ void TextFrameSpellChecker::removeFrameState(PageItem_TextFrame* frame)
 	m_frameStates.remove(frame);
 }
 
-QString TextFrameSpellChecker::calculateTextHash(PageItem_TextFrame* frame) const
-{
-	if (!frame)
-		return QString();
-	
-	QString text = frame->itemText.plainText();
-	
-	QCryptographicHash hash(QCryptographicHash::Md5);
-	hash.addData(text.toUtf8());
-	
-	return QString::fromLatin1(hash.result().toHex());
-}
-
 // ============================================================================
 // Worker Implementation
 // ============================================================================
@@ -569,7 +728,84 @@ void SpellCheckerWorker::setPaused(bool paused)
 	m_paused = paused;
 }
 
-void SpellCheckerWorker::checkSnapshot(PageItem_TextFrame* frame, const StoryTextSnapshot& snapshot, int generation)
+void SpellCheckerWorker::forgetFrame(PageItem_TextFrame* frame)
+{
+	m_cachedParagraphs -= m_paragraphCache.take(frame).size();
+	m_paragraphCacheOrder.removeOne(frame);
+}
+
+void SpellCheckerWorker::clearParagraphCache()
+{
+	m_paragraphCache.clear();
+	m_paragraphCacheOrder.clear();
+	m_cachedParagraphs = 0;
+}
+
+void SpellCheckerWorker::storeParagraphCache(PageItem_TextFrame* frame, const ParagraphCache& cache)
+{
+	forgetFrame(frame);
+	m_paragraphCache.insert(frame, cache);
+	m_paragraphCacheOrder.append(frame);
+	m_cachedParagraphs += cache.size();
+
+	// The results of the frame just checked are always kept
+	while (m_cachedParagraphs > maxCachedParagraphs && m_paragraphCacheOrder.count() > 1)
+		forgetFrame(m_paragraphCacheOrder.first());
+}
+
+QVector<SpellError> SpellCheckerWorker::checkParagraph(const StoryTextSnapshot& snapshot, int paraIndex, const ParagraphCache& oldCache, ParagraphCache& newCache)
+{
+	const ParagraphInfo& para = snapshot.paragraphs.at(paraIndex);
+
+	ParagraphResult result;
+	result.text = snapshot.getParagraphText(paraIndex);
+	result.runs = snapshot.getLanguageRunsForParagraph(paraIndex);
+	for (LanguageRun& run : result.runs)
+		run.start -= para.start;
+	size_t key = qHash(result.text);
+	for (const LanguageRun& run : std::as_const(result.runs))
+		key = qHashMulti(key, run.start, run.length, run.language);
+
+	QVector<SpellError> errors;
+	bool found = false;
+	for (auto it = oldCache.constFind(key); it != oldCache.constEnd() && it.key() == key; ++it)
+	{
+		if (it->text != result.text || it->runs.size() != result.runs.size())
+			continue;
+		bool sameRuns = true;
+		for (int i = 0; i < it->runs.size() && sameRuns; ++i)
+		{
+			const LanguageRun& a = it->runs.at(i);
+			const LanguageRun& b = result.runs.at(i);
+			sameRuns = (a.start == b.start && a.length == b.length && a.language == b.language);
+		}
+		if (!sameRuns)
+			continue;
+		result.errors = it->errors;
+		found = true;
+		break;
+	}
+
+	if (found)
+	{
+		// Unchanged paragraph, only its position may have moved
+		errors = result.errors;
+		for (SpellError& error : errors)
+			error.position += para.start;
+	}
+	else
+	{
+		errors = performSpellCheckParagraph(snapshot, paraIndex);
+		result.errors = errors;
+		for (SpellError& error : result.errors)
+			error.position -= para.start;
+	}
+
+	newCache.insert(key, result);
+	return errors;
+}
+
+void SpellCheckerWorker::checkSnapshot(PageItem_TextFrame* frame, const SpellCheckRequest& request, int generation)
 {
 	// This runs in the WORKER thread
 	
@@ -579,8 +815,21 @@ void SpellCheckerWorker::checkSnapshot(PageItem_TextFrame* frame, const StoryTex
 		return;
 	}
 
-	// Perform spell check
-	QVector<SpellError> errors = performSpellCheck(snapshot);
+	// Perform spell check, only paragraphs which changed since the
+	// previous check of this frame are passed to the dictionaries
+	const StoryTextSnapshot& snapshot = request.snapshot;
+	QVector<SpellError> errors;
+	const ParagraphCache oldCache = m_paragraphCache.value(frame);
+	ParagraphCache newCache;
+	newCache.reserve(snapshot.paragraphCount());
+	for (int paraIndex = 0; paraIndex < snapshot.paragraphCount(); ++paraIndex)
+		errors.append(checkParagraph(snapshot, paraIndex, oldCache, newCache));
+	// Results of a partial check would only cover the changed paragraphs,
+	// the cache of the frame is replaced by the next full check
+	if (!request.partial)
+		storeParagraphCache(frame, newCache);
+	else if (m_paragraphCacheOrder.removeOne(frame))
+		m_paragraphCacheOrder.append(frame);
 	// qDebug()<<"Perform spell check";
 
 	// Map positions back to original StoryText coordinates
@@ -594,6 +843,17 @@ void SpellCheckerWorker::checkSnapshot(PageItem_TextFrame* frame, const StoryTex
 		}
 	}
 
+	// Add the results kept for the unchanged text
+	if (request.partial)
+	{
+		QVector<SpellError> allErrors;
+		allErrors.reserve(request.keptBefore.size() + errors.size() + request.keptAfter.size());
+		allErrors.append(request.keptBefore);
+		allErrors.append(errors);
+		allErrors.append(request.keptAfter);
+		errors = allErrors;
+	}
+
 	// Emit results back to main thread
 	emit checkComplete(frame, errors, generation);
 }
@@ -13,11 +13,13 @@
 #include <QObject>
 #include <QTimer>
 #include <QHash>
+#include <QList>
 #include <QThread>
 #include <QVector>
 #include "text/storytextsnapshot.h"
 
 class PageItem_TextFrame;
+class ScribusDoc;
 class SpellCheckerWorker;
 
 /**
@@ -39,6 +41,17 @@ struct SpellError
 	}
 };
 
+/**
+* @brief Text sent to the worker thread and the results kept from the previous check
+*/
+struct SpellCheckRequest
+{
+	StoryTextSnapshot snapshot;      // Whole story, or the paragraphs changed since the last check
+	bool partial {false};            // The snapshot only holds the changed paragraphs
+	QVector<SpellError> keptBefore;  // Errors of the unchanged text before the snapshot
+	QVector<SpellError> keptAfter;   // Errors of the unchanged text after it, at their new position
+};
+
 /**
 * @brief Singleton spell checker with dedicated worker thread
 *
@@ -172,6 +185,15 @@ class SCRIBUS_API TextFrameSpellChecker : public QObject
 		*/
 		void checkFrameNow(PageItem_TextFrame* frame);
 
+		/**
+		* @brief Queue a low priority check of every story in a document
+		*
+		* Stories are checked one at a time whenever the checker is otherwise
+		* idle, so that frames which are not being edited already have their
+		* results available when they become active.
+		*/
+		void checkDocument(ScribusDoc* doc);
+
 		/**
 		* @brief Clean up all state when a document is closed
 		* Must be called before document page items are destroyed
@@ -251,7 +273,7 @@ class SCRIBUS_API TextFrameSpellChecker : public QObject
 		* @brief Signal to worker to check a snapshot
 		* @internal Connected to worker's checkSnapshot slot
 		*/
-		void requestCheck(PageItem_TextFrame* frame, StoryTextSnapshot snapshot, int generation);
+		void requestCheck(PageItem_TextFrame* frame, SpellCheckRequest request, int generation);
 
 	private:
 		// Private constructor for singleton
@@ -263,7 +285,8 @@ class SCRIBUS_API TextFrameSpellChecker : public QObject
 		{
 			bool needsRecheck = true;
 			QVector<SpellError> cachedErrors;
-			QString textHash; // Hash of text when last checked
+			quint64 checkedRevision = 0; // Story revision of cachedErrors, 0 if none
+			int checkedLength = 0;       // Story length at that revision
 		};
 
 		// Singleton instance
@@ -272,8 +295,8 @@ class SCRIBUS_API TextFrameSpellChecker : public QObject
 		// Get or create state for a frame
 		FrameState& getFrameState(PageItem_TextFrame* frame);
 
-		// Calculate hash of frame's text
-		QString calculateTextHash(PageItem_TextFrame* frame) const;
+		// Prepare the check of the text changed since the last results of a frame
+		SpellCheckRequest createRequest(PageItem_TextFrame* frame, const FrameState& state) const;
 
 		// Schedule a check (with debouncing)
 		void scheduleCheck(PageItem_TextFrame* frame);
@@ -281,11 +304,15 @@ class SCRIBUS_API TextFrameSpellChecker : public QObject
 		// Perform the actual check
 		void performCheck(PageItem_TextFrame* frame);
 
+		// Start the next queued background check if the checker is idle
+		void scheduleBackgroundCheck();
+
 		// Cleanup state for a frame
 		void removeFrameState(PageItem_TextFrame* frame);
 
 	private slots:
 		void onDebounceTimeout();
+		void onBackgroundTimeout();
 		void onCheckComplete(PageItem_TextFrame* frame, const QVector<SpellError>& errors, int generation);
 
 	private:
@@ -302,17 +329,24 @@ class SCRIBUS_API TextFrameSpellChecker : public QObject
 		// Currently active frame (only one can be edited at a time)
 		PageItem_TextFrame* m_activeFrame {nullptr};
 
-		// Current snapshot (only for active frame while preparing to check)
-		StoryTextSnapshot m_currentSnapshot;
-
 		// Frame states (cached results, flags)
 		QHash<PageItem_TextFrame*, FrameState> m_frameStates;
 
 		// Debounce timer for the active frame
 		QTimer m_debounceTimer;
 
-		// Currently checking frame
+		// Currently checking frame and the story revision being checked
 		PageItem_TextFrame* m_checkingFrame {nullptr};
+		quint64 m_checkingRevision {0};
+		int m_checkingLength {0};
+
+		// Whole document pass: frames still to check and the one in flight
+		QList<PageItem_TextFrame*> m_backgroundQueue;
+		PageItem_TextFrame* m_backgroundFrame {nullptr};
+		quint64 m_backgroundRevision {0};
+		int m_backgroundLength {0};
+		QTimer m_backgroundTimer;
+		int m_backgroundCapacity {0};
 
 		// Generation counter — incremented on document close to discard stale results
 		int m_generation {0};
@@ -345,12 +379,22 @@ class SCRIBUS_API SpellCheckerWorker : public QObject
 		*/
 		void setPaused(bool paused);
 
+		/**
+		* @brief Drop the paragraph results kept for a frame
+		*/
+		void forgetFrame(PageItem_TextFrame* frame);
+
+		/**
+		* @brief Drop the paragraph results kept for all frames
+		*/
+		void clearParagraphCache();
+
 	public slots:
 		/**
 		* @brief Check a snapshot for spelling errors
 		* This runs in the worker thread
 		*/
-		void checkSnapshot(PageItem_TextFrame* frame, const StoryTextSnapshot& snapshot, int generation);
+		void checkSnapshot(PageItem_TextFrame* frame, const SpellCheckRequest& request, int generation);
 
 	signals:
 		/**
@@ -365,7 +409,28 @@ class SCRIBUS_API SpellCheckerWorker : public QObject
 		void progress(int percentage);
 
 	private:
+		// Results of the last check of a paragraph, positions relative to the paragraph start
+		struct ParagraphResult
+		{
+			QString text;
+			QVector<LanguageRun> runs;
+			QVector<SpellError> errors;
+		};
+		using ParagraphCache = QMultiHash<size_t, ParagraphResult>;
+
+		// Paragraph results kept for all frames together
+		static constexpr int maxCachedParagraphs = 10000;
+
+		// Return the errors of a paragraph, reusing the previous result if the paragraph is unchanged
+		QVector<SpellError> checkParagraph(const StoryTextSnapshot& snapshot, int paraIndex, const ParagraphCache& oldCache, ParagraphCache& newCache);
+
+		// Keep the paragraph results of a frame, forgetting the least recently checked frames if needed
+		void storeParagraphCache(PageItem_TextFrame* frame, const ParagraphCache& cache);
+
 		bool m_paused {false};
+		QHash<PageItem_TextFrame*, ParagraphCache> m_paragraphCache;
+		QList<PageItem_TextFrame*> m_paragraphCacheOrder; // Least recently checked first
+		int m_cachedParagraphs {0};
 };
 
 
@@ -26,12 +26,13 @@ for which a new license (GPL+exception) is in place.
 #include "prefsmanager.h"
 #include "scribusdoc.h"
 #include "selection.h"
+#include "text/storytextbuilder.h"
 #include "ui/missing.h"
 #include "util.h"
 
 namespace RtfReader
 {
-	SlaDocumentRtfOutput::SlaDocumentRtfOutput(PageItem *ite, ScribusDoc *doc, bool prefix) : AbstractRtfOutput()
+	SlaDocumentRtfOutput::SlaDocumentRtfOutput(PageItem *ite, ScribusDoc *doc, bool prefix) : AbstractRtfOutput(), m_story(ite->itemText)
 	{
 		m_item = ite;
 		m_Doc = doc;
@@ -88,7 +89,7 @@ namespace RtfReader
 
 	void SlaDocumentRtfOutput::appendText(const QByteArray &textBytes)
 	{
-		int posC = m_item->itemText.length();
+		int posC = m_story.length();
 		QString text = m_codec->toUnicode(textBytes);
 		if (text.size() > 0)
 		{
@@ -96,15 +97,15 @@ namespace RtfReader
 			text.replace(QChar(12), SpecialChars::FRAMEBREAK);
 			text.replace(QChar(30), SpecialChars::NBHYPHEN);
 			text.replace(QChar(160), SpecialChars::NBSPACE);
-			m_item->itemText.insertChars(posC, text);
-			m_item->itemText.applyStyle(posC, m_textStyle.top());
-			m_item->itemText.applyCharStyle(posC, text.length(), m_textCharStyle.top());
+			m_story.append(text);
+			m_story.applyStyle(posC, m_textStyle.top());
+			m_story.applyCharStyle(posC, text.length(), m_textCharStyle.top());
 		}
 	}
 
 	void SlaDocumentRtfOutput::appendUnicodeText(const QString &text)
 	{
-		int posC = m_item->itemText.length();
+		int posC = m_story.length();
 		QString m_txt = text;
 		if (text.length() > 0)
 		{
@@ -112,87 +113,95 @@ namespace RtfReader
 			m_txt.replace(QChar(12), SpecialChars::FRAMEBREAK);
 			m_txt.replace(QChar(30), SpecialChars::NBHYPHEN);
 			m_txt.replace(QChar(160), SpecialChars::NBSPACE);
-			m_item->itemText.insertChars(posC, m_txt);
-			m_item->itemText.applyStyle(posC, m_textStyle.top());
-			m_item->itemText.applyCharStyle(posC, m_txt.length(), m_textCharStyle.top());
+			m_story.append(m_txt);
+			m_story.applyStyle(posC, m_textStyle.top());
+			m_story.applyCharStyle(posC, m_txt.length(), m_textCharStyle.top());
 		}
 	}
 
 	void SlaDocumentRtfOutput::insertPar()
 	{
-		int posT = m_item->itemText.length();
+		int posT = m_story.length();
 		if (posT > 0)
 		{
-			m_item->itemText.insertChars(posT, SpecialChars::PARSEP);
-			m_item->itemText.applyStyle(posT, m_textStyle.top());
+			m_story.append(SpecialChars::PARSEP);
+			m_story.applyStyle(posT, m_textStyle.top());
 		}
 	}
 
 	void SlaDocumentRtfOutput::insertTab()
 	{
-		int posT = m_item->itemText.length();
-		m_item->itemText.insertChars(posT, SpecialChars::TAB);
-		m_item->itemText.applyStyle(posT, m_textStyle.top());
+		int posT = m_story.length();
+		m_story.append(SpecialChars::TAB);
+		m_story.applyStyle(posT, m_textStyle.top());
+	}
+
+	void SlaDocumentRtfOutput::insertAtCursor(QChar ch)
+	{
+		// Takes the style of the neighbour character, which needs the buffered text in the story
+		m_story.commit();
+		m_item->itemText.insertChars(QString(ch), true);
 	}
 
 	void SlaDocumentRtfOutput::insertLeftQuote()
 	{
-		m_item->itemText.insertChars(QString(QChar(0x2018)), true);
+		insertAtCursor(QChar(0x2018));
 	}
 
 	void SlaDocumentRtfOutput::insertRightQuote()
 	{
-		m_item->itemText.insertChars(QString(QChar(0x2019)), true);
+		insertAtCursor(QChar(0x2019));
 	}
 
 	void SlaDocumentRtfOutput::insertLeftDoubleQuote()
 	{
-		m_item->itemText.insertChars(QString(QChar(0x201c)), true);
+		insertAtCursor(QChar(0x201c));
 	}
 
 	void SlaDocumentRtfOutput::insertRightDoubleQuote()
 	{
-		m_item->itemText.insertChars(QString(QChar(0x201d)), true);
+		insertAtCursor(QChar(0x201d));
 	}
 
 	void SlaDocumentRtfOutput::insertEnDash()
 	{
-		m_item->itemText.insertChars(QString(QChar(0x2013)), true);
+		insertAtCursor(QChar(0x2013));
 	}
 
 	void SlaDocumentRtfOutput::insertEmDash()
 	{
-		m_item->itemText.insertChars(QString(QChar(0x2014)), true);
+		insertAtCursor(QChar(0x2014));
 	}
 
 	void SlaDocumentRtfOutput::insertEmSpace()
 	{
-		m_item->itemText.insertChars(QString(QChar(0x2003)), true);
+		insertAtCursor(QChar(0x2003));
 	}
 
 	void SlaDocumentRtfOutput::insertEnSpace()
 	{
-		m_item->itemText.insertChars(QString(QChar(0x2002)), true);
+		insertAtCursor(QChar(0x2002));
 	}
 
 	void SlaDocumentRtfOutput::insertBullet()
 	{
-		m_item->itemText.insertChars(QString(QChar(0x2022)), true);
+		insertAtCursor(QChar(0x2022));
 	}
 
 	void SlaDocumentRtfOutput::insertNewLine()
 	{
-		int posT = m_item->itemText.length();
+		int posT = m_story.length();
 		if (posT > 0)
 		{
-			m_item->itemText.insertChars(posT, SpecialChars::LINEBREAK);
-			m_item->itemText.applyStyle(posT, m_textStyle.top());
+			m_story.append(SpecialChars::LINEBREAK);
+			m_story.applyStyle(posT, m_textStyle.top());
 		}
 	}
 
 	void SlaDocumentRtfOutput::setFontItalic(const int value)
 	{
 		m_isItalic = (value != 0);
+		// The probe character is removed again, so text buffered by m_story is not disturbed
 		int posC = m_item->itemText.length();
 		m_item->itemText.insertChars(posC, "B");
 		m_item->itemText.applyStyle(posC, m_textStyle.top());
@@ -227,6 +236,7 @@ namespace RtfReader
 	void SlaDocumentRtfOutput::setFontBold(const int value)
 	{
 		m_isBold = (value != 0);
+		// The probe character is removed again, so text buffered by m_story is not disturbed
 		int posC = m_item->itemText.length();
 		m_item->itemText.insertChars(posC, "B");
 		m_item->itemText.applyStyle(posC, m_textStyle.top());
@@ -640,6 +650,7 @@ namespace RtfReader
 				tempFile.setAutoRemove(false);
 				tempFile.write(image);
 				tempFile.close();
+				m_story.commit();
 				int posT = m_item->itemText.length();
 				int z = m_Doc->itemAdd(PageItem::ImageFrame, PageItem::Rectangle, 0, 0, ww, hh, 0, CommonStrings::None, CommonStrings::None);
 				PageItem* item = m_Doc->Items->at(z);
@@ -687,6 +698,7 @@ namespace RtfReader
 						fmt->loadFile(fileName, LoadSavePlugin::lfUseCurrentPage|LoadSavePlugin::lfInteractive|LoadSavePlugin::lfScripted);
 						if (m_Doc->m_Selection->count() > 0)
 						{
+							m_story.commit();
 							int posT = m_item->itemText.length();
 							PageItem* item = m_Doc->groupObjectsSelection();
 							item->setWidthHeight(ww, hh, true);
@@ -22,6 +22,7 @@ for which a new license (GPL+exception) is in place.
 #include "AbstractRtfOutput.h"
 #include "styles/charstyle.h"
 #include "styles/paragraphstyle.h"
+#include "text/storytextbuilder.h"
 
 class CharStyle;
 class PageItem;
@@ -108,7 +109,10 @@ namespace RtfReader
 		QTextCodec *getCurrentCodec()  override { return m_codec; }
 
 	private:
+		void insertAtCursor(QChar ch);
+
 		PageItem* m_item { nullptr };
+		StoryTextBuilder m_story;
 		ScribusDoc* m_Doc { nullptr };
 		QTextCodec *m_codec { nullptr };
 		QStack<ParagraphStyle> m_textStyle;
@@ -15,6 +15,7 @@ for which a new license (GPL+exception) is in place.
 #include <QPixmap>
 #include <QPushButton>
 #include <QSpacerItem>
+#include <QTimer>
 #include <QToolTip>
 #include <QTreeWidget>
 #include <QTreeWidgetItem>
@@ -89,6 +90,12 @@ CheckDocument::CheckDocument( QWidget* parent, bool modal )
 	connect(ignoreErrors, SIGNAL(clicked()), this, SIGNAL(ignoreAllErrors()));
 	connect(curCheckProfile, SIGNAL(textActivated(QString)), this, SLOT(newScan(QString)));
 	connect(reScan, SIGNAL(clicked()), this, SLOT(doReScan()));
+
+	// Checks of unchanged items are reused, the report can follow the edits
+	reScanTimer = new QTimer(this);
+	reScanTimer->setSingleShot(true);
+	reScanTimer->setInterval(1000);
+	connect(reScanTimer, SIGNAL(timeout()), this, SLOT(liveReScan()));
 }
 
 void CheckDocument::changeEvent(QEvent *e)
@@ -191,6 +198,7 @@ QString CheckDocument::bestCheckerProfileForCheckMode(CheckMode mode, const QStr
 void CheckDocument::setDoc(ScribusDoc *doc)
 {
 	m_Doc = doc;
+	watchDocument(doc);
 	clearErrorList();
 	CheckerPrefsList::Iterator itend = doc->checkerProfiles().end();
 	for (auto it = doc->checkerProfiles().begin(); it != itend ; ++it)
@@ -269,6 +277,32 @@ void CheckDocument::newScan(const QString& name)
 	buildErrorList(m_Doc);
 }
 
+void CheckDocument::watchDocument(ScribusDoc *doc)
+{
+	if (docChangedConnection)
+		disconnect(docChangedConnection);
+	reScanTimer->stop();
+	if (doc != nullptr)
+		docChangedConnection = connect(doc, SIGNAL(docChanged()), this, SLOT(scheduleReScan()));
+}
+
+void CheckDocument::scheduleReScan()
+{
+	if ((m_Doc == nullptr) || !isVisible())
+		return;
+	// Checking may itself update the document, only changes made since are of interest
+	if (m_Doc->contentRevision() == checkedRevision)
+		return;
+	reScanTimer->start();
+}
+
+void CheckDocument::liveReScan()
+{
+	if ((m_Doc == nullptr) || !isVisible() || m_Doc->isLoading())
+		return;
+	doReScan();
+}
+
 void CheckDocument::clearErrorList()
 {
 	disconnect(reportDisplay, SIGNAL(itemClicked(QTreeWidgetItem*, int)), this, SLOT(slotSelect(QTreeWidgetItem*)));
@@ -417,6 +451,8 @@ void CheckDocument::buildItem(QTreeWidgetItem * item, PreflightError errorType,
 
 void CheckDocument::buildErrorList(ScribusDoc *doc)
 {
+	if (doc != m_Doc)
+		watchDocument(doc);
 	m_Doc = doc;
 	disconnect(curCheckProfile, SIGNAL(textActivated(QString)), this, SLOT(newScan(QString)));
 	curCheckProfile->clear();
@@ -424,6 +460,7 @@ void CheckDocument::buildErrorList(ScribusDoc *doc)
 
 	if (m_Doc == nullptr)
 		return;
+	checkedRevision = m_Doc->contentRevision();
 
 	minResDPI = qRound(doc->checkerProfiles()[doc->curCheckProfile()].minResolution);
 	maxResDPI = qRound(doc->checkerProfiles()[doc->curCheckProfile()].maxResolution);
@@ -17,6 +17,7 @@ class QHBoxLayout;
 class QLabel;
 class QPushButton;
 class QTreeWidget;
+class QTimer;
 class QTreeWidgetItem;
 class QVBoxLayout;
 
@@ -107,6 +108,9 @@ signals:
 protected slots:
 	void iconSetChange();
 	void languageChange();
+	/*! \brief Schedules a new check of the visible P.V. once the document stops changing. */
+	void scheduleReScan();
+	void liveReScan();
 
 protected:
 	QVBoxLayout* checkDocumentLayout { nullptr };
@@ -174,6 +178,14 @@ protected:
 	bool showPagesWithoutErrors { false };
 	bool showNonPrintingLayerErrors { true };
 
+	//! \brief Timer for checking the document again after changes
+	QTimer* reScanTimer { nullptr };
+	//! \brief Content revision of the document when it was last checked
+	quint64 checkedRevision { 0 };
+	QMetaObject::Connection docChangedConnection;
+	//! \brief Follows the changes of doc to keep the report up to date
+	void watchDocument(ScribusDoc *doc);
+
 	int minResDPI {0};
 	int maxResDPI {0};
 
@@ -151,6 +151,10 @@ class SCRIBUS_API MultiProgressDialog : public QDialog, Ui::MultiProgressDialog
 		 */
 		void setCancelButtonText(const QString& cancelButtonText);
 
+	public slots:
+		//! \brief Acts as if the cancel button was pressed
+		void emitCancel();
+
 	signals:
 		void canceled();
 
@@ -158,9 +162,6 @@ class SCRIBUS_API MultiProgressDialog : public QDialog, Ui::MultiProgressDialog
 		QStringList progressBarTitles;
 		QMap<QString, QProgressBar*> progressBars;
 		QMap<QString, QLabel*> progressLabels;
-
-	private slots:
-		void emitCancel();
 };
 
 #endif
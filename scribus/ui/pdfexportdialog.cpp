@@ -265,6 +265,7 @@ void PDFExportDialog::updateDocOptions()
 	m_opts.Compress = Options->Compression->isChecked();
 	m_opts.CompressMethod = (PDFOptions::PDFCompression) Options->CMethod->currentIndex();
 	m_opts.Quality = Options->CQuality->currentIndex();
+	m_opts.CompressionLevel = (PDFOptions::PDFCompressionLevel) Options->CLevel->currentIndex();
 	m_opts.Resolution = Options->Resolution->value();
 	m_opts.FontEmbedding = Options->fontEmbeddingMode();
 	m_opts.EmbedList = Options->fontsToEmbed();
@@ -129,6 +129,8 @@ void Prefs_DocumentSetup::languageChange()
 	pageOrientationComboBox->setToolTip( "<qt>" + tr( "Default orientation of document pages" ) + "</qt>" );
 	pageUnitsComboBox->setToolTip( "<qt>" + tr( "Default unit of measurement for document editing" ) + "</qt>" );
 	autosaveCheckBox->setToolTip( "<qt>" + tr( "When enabled, Scribus saves backup copies of your file each time the time period elapses" ) + "</qt>" );
+	saveIncrementalCheckBox->setToolTip( "<qt>" + tr( "When enabled, saving and autosaving reuse the data written for items that did not change since the previous save, which is much faster for large documents" ) + "</qt>" );
+	deferImageLoadingCheckBox->setToolTip( "<qt>" + tr( "When enabled, the images of an opened document are only loaded when their page is displayed or the document is exported, which makes opening large documents faster and uses less memory" ) + "</qt>" );
 	autosaveIntervalSpinBox->setToolTip( "<qt>" + tr( "Time period between saving automatically" ) + "</qt>" );
 	undoLengthSpinBox->setToolTip( "<qt>" + tr("Set the length of the action history in steps. If set to 0 infinite amount of actions will be stored.") + "</qt>");
 	applySizesToAllPagesCheckBox->setToolTip( "<qt>" + tr( "Apply the page size changes to all existing pages in the document" ) + "</qt>" );
@@ -206,6 +208,8 @@ void Prefs_DocumentSetup::restoreDefaults(struct ApplicationPrefs *prefsData)
 	bleedsWidget->setPageHeight(prefsData->docSetupPrefs.pageHeight);
 	bleedsWidget->setMarginPreset(prefsData->docSetupPrefs.marginPreset);
 	saveCompressedCheckBox->setChecked(prefsData->docSetupPrefs.saveCompressed);
+	saveIncrementalCheckBox->setChecked(prefsData->docSetupPrefs.saveIncremental);
+	deferImageLoadingCheckBox->setChecked(prefsData->docSetupPrefs.deferImageLoading);
 	emergencyCheckBox->setChecked(prefsData->miscPrefs.saveEmergencyFile);
 	autosaveCheckBox->setChecked( prefsData->docSetupPrefs.AutoSave );
 	autosaveIntervalSpinBox->setValue(prefsData->docSetupPrefs.AutoSaveTime / 1000 / 60);
@@ -241,6 +245,8 @@ void Prefs_DocumentSetup::saveGuiToPrefs(struct ApplicationPrefs *prefsData) con
 	prefsData->docSetupPrefs.margins = marginsWidget->margins();
 	prefsData->docSetupPrefs.bleeds = bleedsWidget->margins();
 	prefsData->docSetupPrefs.saveCompressed = saveCompressedCheckBox->isChecked();
+	prefsData->docSetupPrefs.saveIncremental = saveIncrementalCheckBox->isChecked();
+	prefsData->docSetupPrefs.deferImageLoading = deferImageLoadingCheckBox->isChecked();
 	prefsData->miscPrefs.saveEmergencyFile = emergencyCheckBox->isChecked();
 	prefsData->docSetupPrefs.AutoSave = autosaveCheckBox->isChecked();
 	prefsData->docSetupPrefs.AutoSaveTime = autosaveIntervalSpinBox->value() * 1000 * 60;
@@ -43,6 +43,7 @@ for which a new license (GPL+exception) is in place.
 #include <QTableWidget>
 #include <QTableWidgetItem>
 #include <QTextStream>
+#include <QTimer>
 #include <QToolTip>
 
 #include <cstdlib>
@@ -97,6 +98,11 @@ PrintPreview::PrintPreview(QWidget* parent, ScribusDoc *docu, const QString& pri
 	m_haveTiffSep  = ScCore->haveTIFFSep() && (m_ui->printLanguageCombo->hasPDF() || m_ui->printLanguageCombo->hasPostscript());
 	getNumericGSVersion(m_gsVersion);
 
+	m_prefetchTimer = new QTimer(this);
+	m_prefetchTimer->setSingleShot(true);
+	m_prefetchTimer->setInterval(200);
+	connect(m_prefetchTimer, &QTimer::timeout, this, &PrintPreview::prefetchPages);
+
 	m_previewLabel = new QLabel(this);
 	m_previewLabel->setSizePolicy(QSizePolicy::Maximum, QSizePolicy::Maximum);
 	m_ui->previewArea->setWidget(m_previewLabel);
@@ -553,13 +559,31 @@ QPixmap PrintPreview::createPreview(int pageIndex, int res)
 		}
 	}
 
-	pixmap = m_previewCreator->createPreview(pageIndex);
+	pixmap = m_previewCreator->preview(pageIndex);
 
 	qApp->restoreOverrideCursor();
 	getUserSelection(pageIndex);
+	m_prefetchTimer->start();
 	return pixmap;
 }
 
+void PrintPreview::prefetchPages()
+{
+	if ((m_previewCreator == nullptr) || (m_currentPage < 0))
+		return;
+	// Pages the user is most likely to look at next
+	const int pageIndexes[] = { m_currentPage + 1, m_currentPage - 1, m_currentPage + 2 };
+	for (int pageIndex : pageIndexes)
+	{
+		// Check again later while a page is being rendered
+		if (m_previewCreator->prefetch(pageIndex))
+		{
+			m_prefetchTimer->start();
+			return;
+		}
+	}
+}
+
 //-------------------------------------------------------------------------------------------------
 
 bool PrintPreview::usesGhostscript(const QString& printerName, PrintLanguage engine)
@@ -19,6 +19,7 @@ class QLabel;
 class QPushButton;
 class QScrollArea;
 class QTableWidget;
+class QTimer;
 namespace Ui { class PrintPreviewBase; }
 
 #include "ui/scrspinbox.h"
@@ -123,6 +124,8 @@ protected:
 
 	Ui::PrintPreviewBase *m_ui { nullptr };
 	QLabel* m_previewLabel { nullptr };
+	//! \brief Timer rendering the pages around the displayed one while the dialog is idle
+	QTimer* m_prefetchTimer { nullptr };
 
 	PrefsManager& m_prefsManager;
 
@@ -137,6 +140,8 @@ protected:
 protected slots:
 	void onPrintLanguageChange(int);
 	void onInkTableCellDoubleClicked(int row);
+	//! \brief Render the next and previous pages in background
+	void prefetchPages();
 
 	/*!
 	\author Petr Vanek
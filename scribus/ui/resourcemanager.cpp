@@ -38,6 +38,7 @@ for which a new license (GPL+exception) is in place.
 #include <QTextStream>
 
 #include "downloadmanager/scdlmgr.h"
+#include "hyphenator.h"
 #include "langmgr.h"
 #include "resourcemanager.h"
 #include "resourcemanagerlicense.h"
@@ -382,6 +383,8 @@ void ResourceManager::updateInstalledHyph()
 		return;
 	m_dictionaryMap.clear();
 	LanguageManager::instance()->findHyphDictionarySets(m_dictionaryPaths, m_dictionaryMap);
+	// Cached hyphenations may come from a removed or replaced dictionary
+	Hyphenator::clearWordCache();
 
 	installedTableWidget->clear();
 	installedTableWidget->setRowCount(m_dictionaryMap.count());
@@ -9,11 +9,13 @@ for which a new license (GPL+exception) is in place.
 
 #include <QAction>
 #include <QApplication>
+#include <QBuffer>
 #include <QByteArray>
 #include <QCursor>
 #include <QDataStream>
 #include <QDomDocument>
 #include <QDrag>
+#include <QElapsedTimer>
 #include <QDropEvent>
 #include <QEvent>
 #include <QFile>
@@ -79,6 +81,15 @@ BibView::BibView(QWidget* parent) : QListWidget(parent)
 	setSpacing(10);
 	setTextElideMode(Qt::ElideMiddle);
 	objectMap.clear();
+
+	m_previewTimer.setSingleShot(true);
+	m_previewTimer.setInterval(0);
+	connect(&m_previewTimer, SIGNAL(timeout()), this, SLOT(generateNextPreviews()));
+}
+
+BibView::~BibView()
+{
+	stopPreviewGeneration();
 }
 
  void BibView::startDrag(Qt::DropActions supportedActions)
@@ -505,17 +516,17 @@ void BibView::readOldContents(const QString& name, const QString& newName)
 
 void BibView::readContents(const QString& name)
 {
-	int fileCount = 0;
-	int readCount = 0;
 	QSet<QString> vectorFound;
 	QSet<QString> rasterFound;
 
+	stopPreviewGeneration();
 	clear();
 	objectMap.clear();
 
 	QString dirPath = QDir::cleanPath(QDir::toNativeSeparators(name));
 	while ((dirPath.length() > 1) && dirPath.endsWith("/"))
 		dirPath.chop(1);
+	m_dirPath = dirPath;
 
 	QDir thumbs(dirPath);
 	if (thumbs.exists())
@@ -524,17 +535,16 @@ void BibView::readContents(const QString& name)
 			thumbs.mkdir(".ScribusThumbs");
 		thumbs.cd(".ScribusThumbs");
 	}
+	m_previewCache.load(dirPath);
+
 	QDir dd(dirPath, "*", QDir::Name, QDir::Dirs | QDir::NoDotAndDotDot | QDir::Readable | QDir::NoSymLinks);
-	fileCount += dd.count();
 	QDir d(dirPath, "*.sce", QDir::Name, QDir::Files | QDir::Readable | QDir::NoSymLinks);
-	fileCount += d.count();
 
 	QStringList vectorFiles = LoadSavePlugin::getExtensionsForPreview(FORMATID_FIRSTUSER);
 	for (int v = 0; v < vectorFiles.count(); v++)
 	{
 		QString ext = "*." + vectorFiles[v];
 		QDir d4(dirPath, ext, QDir::Name, QDir::Files | QDir::Readable | QDir::NoSymLinks);
-		fileCount += d4.count();
 		if (d4.count() > 0)
 			vectorFound.insert(vectorFiles[v]);
 	}
@@ -545,28 +555,39 @@ void BibView::readContents(const QString& name)
 	{
 		QString ext = "*." + rasterFiles[v];
 		QDir d5(dirPath, ext, QDir::Name, QDir::Files | QDir::Readable | QDir::NoSymLinks);
-		fileCount += d5.count();
 		if (d5.count() > 0)
 			rasterFound.insert(rasterFiles[v]);
 	}
 
-	QProgressDialog *pgDia = nullptr;
+	// Previews are taken from the directory preview cache or from previews written by
+	// previous versions. Missing previews are generated once the entries are displayed.
 	QStringList previewFiles;
-	if (ScCore->initialized())
+	QSet<QString> cachedFiles;
+	QList<ScrapbookPreviewThread::Job> rasterJobs;
+	auto findPreview = [&](const QFileInfo& fi, const QString& legacyName, QPixmap& pm) -> bool
 	{
-		pgDia = new QProgressDialog("Reading Files...", QString(), 0, fileCount, this);
-		pgDia->setWindowModality(Qt::WindowModal);
-	}
+		QImage img;
+		const qint64 modified = fi.lastModified().toMSecsSinceEpoch();
+		cachedFiles.insert(fi.fileName());
+		if (m_previewCache.find(fi.fileName(), modified, img))
+		{
+			pm = QPixmap::fromImage(img);
+			return true;
+		}
+		QString legacyPath = fi.path() + "/.ScribusThumbs/" + legacyName + ".png";
+		if (QFile::exists(legacyPath) && img.load(legacyPath))
+		{
+			m_previewCache.insert(fi.fileName(), modified, img);
+			pm = QPixmap::fromImage(img);
+			return true;
+		}
+		return false;
+	};
 
 	if ((dd.exists()) && (dd.count() != 0))
 	{
 		for (uint dc = 0; dc < dd.count(); ++dc)
 		{
-			if (pgDia)
-			{
-				pgDia->setValue(readCount);
-				readCount++;
-			}
 			if (dd[dc].compare(".ScribusThumbs", Qt::CaseInsensitive) == 0)
 				continue;
 			QPixmap pm = IconManager::instance().loadPixmap("folder");
@@ -578,35 +599,21 @@ void BibView::readContents(const QString& name)
 	{
 		for (uint dc = 0; dc < d.count(); ++dc)
 		{
-			if (pgDia)
-			{
-				pgDia->setValue(readCount);
-				readCount++;
-			}
 			QPixmap pm;
-			QByteArray cf;
-			if (!loadRawText(QDir::cleanPath(dirPath + "/" + d[dc]), cf))
-				continue;
 			QFileInfo fi(QDir::cleanPath(dirPath + "/" + d[dc]));
 			QString filePath = QDir::cleanPath(QDir::toNativeSeparators(fi.path()));
-			bool pngExists = QFile::exists(filePath + "/.ScribusThumbs/" + fi.baseName() + ".png");
-			if (pngExists)
-				pm.load(filePath + "/.ScribusThumbs/" + fi.baseName() + ".png");
-			else
+			if (!findPreview(fi, fi.baseName(), pm))
 			{
-				pngExists = QFile::exists(filePath + "/" + fi.baseName() + ".png");
-				if (pngExists)
+				if (QFile::exists(filePath + "/" + fi.baseName() + ".png"))
 					pm.load(filePath + "/" + fi.baseName() + ".png");
 				else
 				{
-					QString f;
-					if (cf.left(16) == "<SCRIBUSELEMUTF8")
-						f = QString::fromUtf8(cf.data());
-					else
-						f = cf.data();
-					pm = QPixmap::fromImage(ScPreview::create(f));
-					if (canWrite && PrefsManager::instance().appPrefs.scrapbookPrefs.writePreviews)
-						pm.save(filePath + "/.ScribusThumbs/" + fi.baseName() + ".png", "PNG");
+					PendingPreview pending;
+					pending.name = fi.baseName();
+					pending.path = fi.filePath();
+					pending.fileName = fi.fileName();
+					pending.modified = fi.lastModified().toMSecsSinceEpoch();
+					m_pendingPreviews.append(pending);
 				}
 			}
 			previewFiles.append(fi.baseName() + ".png");
@@ -624,34 +631,17 @@ void BibView::readContents(const QString& name)
 			continue;
 		for (uint dc = 0; dc < d4.count(); ++dc)
 		{
-			if (pgDia)
-			{
-				pgDia->setValue(readCount);
-				readCount++;
-			}
 			QPixmap pm;
 			QFileInfo fi(QDir::cleanPath(dirPath + "/" + d4[dc]));
-			QString filePath = QDir::cleanPath(QDir::toNativeSeparators(fi.path()));
-			bool pngExists = QFile::exists(filePath + "/.ScribusThumbs/" + fi.fileName() + ".png");
-			if (pngExists)
-				pm.load(filePath + "/.ScribusThumbs/" + fi.fileName() + ".png");
-			else
+			if (!findPreview(fi, fi.fileName(), pm))
 			{
-				FileLoader *fileLoader = new FileLoader(QDir::cleanPath(dirPath + "/" + d4[dc]));
-				int testResult = fileLoader->testFile();
-				delete fileLoader;
-				if ((testResult != -1) && (testResult >= FORMATID_FIRSTUSER))
-				{
-					const FileFormat * fmt = LoadSavePlugin::getFormatById(testResult);
-					if (fmt)
-					{
-						QImage im = fmt->readThumbnail(dirPath + "/" + d4[dc]);
-						im = im.scaled(60, 60, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-						if (canWrite && PrefsManager::instance().appPrefs.scrapbookPrefs.writePreviews)
-							im.save(filePath + "/.ScribusThumbs/" + fi.fileName() + ".png", "PNG");
-						pm = QPixmap::fromImage(im);
-					}
-				}
+				PendingPreview pending;
+				pending.name = fi.fileName();
+				pending.path = fi.filePath();
+				pending.fileName = fi.fileName();
+				pending.modified = fi.lastModified().toMSecsSinceEpoch();
+				pending.isVector = true;
+				m_pendingPreviews.append(pending);
 			}
 			addObject(fi.fileName(), QDir::cleanPath(dirPath + "/" + d4[dc]), pm, false, false, true);
 		}
@@ -667,41 +657,24 @@ void BibView::readContents(const QString& name)
 			continue;
 		for (uint dc = 0; dc < d5.count(); ++dc)
 		{
-			if (pgDia)
-			{
-				pgDia->setValue(readCount);
-				readCount++;
-			}
 			if (previewFiles.contains(d5[dc]))
 				continue;
 			QPixmap pm;
 			QFileInfo fi(QDir::cleanPath(dirPath + "/" + d5[dc]));
-			QString filePath = QDir::cleanPath(QDir::toNativeSeparators(fi.path()));
-			bool pngExists = QFile::exists(filePath + "/.ScribusThumbs/" + fi.fileName() + ".png");
-			if (pngExists)
-				pm.load(filePath + "/.ScribusThumbs/" + fi.fileName() + ".png");
-			else
+			if (!findPreview(fi, fi.fileName(), pm))
 			{
-				bool mode = false;
-				ScImage im;
-				CMSettings cms(nullptr, "", Intent_Perceptual);
-				cms.allowColorManagement(false);
-				if (im.loadPicture(dirPath + "/" + d5[dc], 1, cms, ScImage::Thumbnail, 72, &mode))
-				{
-					QImage img = im.scaled(60, 60, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-					if (canWrite && PrefsManager::instance().appPrefs.scrapbookPrefs.writePreviews)
-						img.save(filePath + "/.ScribusThumbs/" + fi.fileName() + ".png", "PNG");
-					pm = QPixmap::fromImage(img);
-				}
+				PendingPreview pending;
+				pending.name = fi.fileName();
+				pending.path = fi.filePath();
+				pending.fileName = fi.fileName();
+				pending.modified = fi.lastModified().toMSecsSinceEpoch();
+				m_threadPreviews.insert(pending.name, pending);
+				rasterJobs.append({ pending.name, pending.path });
 			}
 			addObject(fi.fileName(), QDir::cleanPath(dirPath + "/" + d5[dc]), pm, false, true);
 		}
 	}
-	if (pgDia)
-	{
-		pgDia->setValue(fileCount);
-		delete pgDia;
-	}
+	m_previewCache.prune(cachedFiles);
 
 	for (auto itf = objectMap.begin(); itf != objectMap.end(); ++itf)
 	{
@@ -719,24 +692,260 @@ void BibView::readContents(const QString& name)
 		itf.value().widgetItem = item;
 	}
 
-	IconManager& iconManager = IconManager::instance();
+	// Entries without preview get a placeholder icon until theirs is generated
 	for (auto itf = objectMap.begin(); itf != objectMap.end(); ++itf)
 	{
 		if (itf.value().isDir)
 			continue;
-		auto& preview = itf.value().Preview;
-		preview = preview.scaled(60, 60, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-		QPixmap pm(60, 60);
-		pm.fill(palette().color(QPalette::Base));
-		QPainter p;
-		p.begin(&pm);
-		p.fillRect(0, 0, 60, 60, QBrush(iconManager.loadPixmap("testfill")));
-		p.drawPixmap(30 - preview.width() / 2, 30 - preview.height() / 2, preview);
-		p.end();
-		auto *item = new QListWidgetItem(QIcon(pm), itf.key(), this);
+		auto *item = new QListWidgetItem(previewIcon(itf.value().Preview), itf.key(), this);
 		item->setToolTip(itf.key());
 		itf.value().widgetItem = item;
 	}
+
+	if (!rasterJobs.isEmpty())
+	{
+		m_previewThread = new ScrapbookPreviewThread(m_previewGeneration, rasterJobs, this);
+		connect(m_previewThread, SIGNAL(previewReady(int,QString,QImage)), this, SLOT(setGeneratedPreview(int,QString,QImage)));
+		connect(m_previewThread, SIGNAL(finished()), this, SLOT(previewThreadFinished()));
+		m_previewThread->start(QThread::LowPriority);
+	}
+	if (!m_pendingPreviews.isEmpty())
+		m_previewTimer.start();
+	saveCacheIfDone();
+}
+
+QIcon BibView::previewIcon(QPixmap& preview) const
+{
+	if (!preview.isNull())
+		preview = preview.scaled(60, 60, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+	QPixmap pm(60, 60);
+	pm.fill(palette().color(QPalette::Base));
+	QPainter p;
+	p.begin(&pm);
+	p.fillRect(0, 0, 60, 60, QBrush(IconManager::instance().loadPixmap("testfill")));
+	if (!preview.isNull())
+		p.drawPixmap(30 - preview.width() / 2, 30 - preview.height() / 2, preview);
+	p.end();
+	return QIcon(pm);
+}
+
+void BibView::setPreview(const QString& name, const QImage& image)
+{
+	auto itf = objectMap.find(name);
+	if (itf == objectMap.end())
+		return;
+	itf.value().Preview = QPixmap::fromImage(image);
+	if (itf.value().widgetItem)
+		itf.value().widgetItem->setIcon(previewIcon(itf.value().Preview));
+}
+
+void BibView::generateNextPreviews()
+{
+	// Scrapbook entries and vector files can only be rendered in the GUI thread,
+	// generate them a few at a time so that the palette stays responsive
+	QElapsedTimer timer;
+	timer.start();
+	while (!m_pendingPreviews.isEmpty() && (timer.elapsed() < 40))
+	{
+		PendingPreview pending = m_pendingPreviews.takeFirst();
+		QImage img;
+		if (pending.isVector)
+		{
+			FileLoader fileLoader(pending.path);
+			int testResult = fileLoader.testFile();
+			if ((testResult != -1) && (testResult >= FORMATID_FIRSTUSER))
+			{
+				const FileFormat * fmt = LoadSavePlugin::getFormatById(testResult);
+				if (fmt)
+				{
+					img = fmt->readThumbnail(pending.path);
+					img = img.scaled(60, 60, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+				}
+			}
+		}
+		else
+		{
+			QByteArray cf;
+			if (!loadRawText(pending.path, cf))
+				continue;
+			QString f;
+			if (cf.left(16) == "<SCRIBUSELEMUTF8")
+				f = QString::fromUtf8(cf.data());
+			else
+				f = cf.data();
+			img = ScPreview::create(f);
+			if (!img.isNull())
+				img = img.scaled(60, 60, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+		}
+		if (img.isNull())
+			continue;
+		m_previewCache.insert(pending.fileName, pending.modified, img);
+		setPreview(pending.name, img);
+	}
+	if (!m_pendingPreviews.isEmpty())
+		m_previewTimer.start();
+	else
+		saveCacheIfDone();
+}
+
+void BibView::setGeneratedPreview(int generation, const QString& name, const QImage& image)
+{
+	if (generation != m_previewGeneration)
+		return;
+	auto it = m_threadPreviews.find(name);
+	if (it == m_threadPreviews.end())
+		return;
+	m_previewCache.insert(it->fileName, it->modified, image);
+	m_threadPreviews.erase(it);
+	setPreview(name, image);
+}
+
+void BibView::previewThreadFinished()
+{
+	if (sender() != m_previewThread)
+		return;
+	m_previewThread->deleteLater();
+	m_previewThread = nullptr;
+	m_threadPreviews.clear();
+	saveCacheIfDone();
+}
+
+void BibView::saveCacheIfDone()
+{
+	if (m_previewThread || !m_pendingPreviews.isEmpty() || !m_previewCache.isModified())
+		return;
+	if (canWrite && PrefsManager::instance().appPrefs.scrapbookPrefs.writePreviews)
+		m_previewCache.save(m_dirPath);
+}
+
+void BibView::stopPreviewGeneration()
+{
+	++m_previewGeneration;
+	m_previewTimer.stop();
+	m_pendingPreviews.clear();
+	m_threadPreviews.clear();
+	if (m_previewThread)
+	{
+		m_previewThread->disconnect(this);
+		m_previewThread->requestInterruption();
+		m_previewThread->wait();
+		delete m_previewThread;
+		m_previewThread = nullptr;
+	}
+	saveCacheIfDone();
+	m_previewCache.clear();
+}
+
+bool ScrapbookPreviewCache::load(const QString& dirPath)
+{
+	clear();
+	QFile file(dirPath + "/.ScribusThumbs/previews.cache");
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+	QDataStream ds(&file);
+	ds.setVersion(QDataStream::Qt_6_0);
+	quint32 magic = 0;
+	quint32 version = 0;
+	ds >> magic >> version;
+	if ((magic != 0x53435043) || (version != 1))
+		return false;
+	quint32 count = 0;
+	ds >> count;
+	for (quint32 i = 0; (i < count) && (ds.status() == QDataStream::Ok); ++i)
+	{
+		QString fileName;
+		Entry entry;
+		QByteArray png;
+		ds >> fileName >> entry.modified >> png;
+		if (entry.image.loadFromData(png, "PNG"))
+			m_entries.insert(fileName, entry);
+	}
+	m_modified = false;
+	return (ds.status() == QDataStream::Ok);
+}
+
+bool ScrapbookPreviewCache::save(const QString& dirPath) const
+{
+	QDir thumbs(dirPath);
+	if (!thumbs.exists(".ScribusThumbs") && !thumbs.mkdir(".ScribusThumbs"))
+		return false;
+	QFile file(dirPath + "/.ScribusThumbs/previews.cache");
+	if (!file.open(QIODevice::WriteOnly))
+		return false;
+	QDataStream ds(&file);
+	ds.setVersion(QDataStream::Qt_6_0);
+	ds << quint32(0x53435043) << quint32(1) << quint32(m_entries.count());
+	for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it)
+	{
+		QByteArray png;
+		QBuffer buffer(&png);
+		buffer.open(QIODevice::WriteOnly);
+		it->image.save(&buffer, "PNG");
+		ds << it.key() << it->modified << png;
+	}
+	return (ds.status() == QDataStream::Ok);
+}
+
+bool ScrapbookPreviewCache::find(const QString& fileName, qint64 modified, QImage& image) const
+{
+	auto it = m_entries.constFind(fileName);
+	if ((it == m_entries.constEnd()) || (it->modified != modified))
+		return false;
+	image = it->image;
+	return true;
+}
+
+void ScrapbookPreviewCache::insert(const QString& fileName, qint64 modified, const QImage& image)
+{
+	Entry entry;
+	entry.modified = modified;
+	entry.image = image;
+	m_entries.insert(fileName, entry);
+	m_modified = true;
+}
+
+void ScrapbookPreviewCache::prune(const QSet<QString>& fileNames)
+{
+	for (auto it = m_entries.begin(); it != m_entries.end();)
+	{
+		if (fileNames.contains(it.key()))
+			++it;
+		else
+		{
+			it = m_entries.erase(it);
+			m_modified = true;
+		}
+	}
+}
+
+void ScrapbookPreviewCache::clear()
+{
+	m_entries.clear();
+	m_modified = false;
+}
+
+ScrapbookPreviewThread::ScrapbookPreviewThread(int generation, const QList<Job>& jobs, QObject* parent)
+	: QThread(parent),
+	  m_generation(generation),
+	  m_jobs(jobs)
+{
+}
+
+void ScrapbookPreviewThread::run()
+{
+	CMSettings cms(nullptr, "", Intent_Perceptual);
+	cms.allowColorManagement(false);
+	for (const Job& job : std::as_const(m_jobs))
+	{
+		if (isInterruptionRequested())
+			return;
+		bool mode = false;
+		ScImage im;
+		if (!im.loadPicture(job.path, 1, cms, ScImage::Thumbnail, 72, &mode))
+			continue;
+		QImage img = im.scaled(60, 60, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+		emit previewReady(m_generation, job.name, img);
+	}
 }
 
 /* This is the main Dialog-Class for the Scrapbook */
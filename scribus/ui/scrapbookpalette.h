@@ -10,7 +10,13 @@ for which a new license (GPL+exception) is in place.
 #include <QDropEvent>
 #include <QDragMoveEvent>
 #include <QDragEnterEvent>
+#include <QHash>
+#include <QImage>
+#include <QList>
 #include <QListWidget>
+#include <QSet>
+#include <QThread>
+#include <QTimer>
 
 class QEvent;
 
@@ -26,6 +32,32 @@ class QToolBox;
 class QPixmap;
 class QListWidgetItem;
 class QDomElement;
+class ScrapbookPreviewThread;
+
+/*! Previews of the entries of a scrapbook directory, stored in a single file
+    of the .ScribusThumbs subdirectory and keyed on the entry modification time */
+class SCRIBUS_API ScrapbookPreviewCache
+{
+public:
+	bool load(const QString& dirPath);
+	bool save(const QString& dirPath) const;
+
+	bool find(const QString& fileName, qint64 modified, QImage& image) const;
+	void insert(const QString& fileName, qint64 modified, const QImage& image);
+	//! Remove entries of files which are not part of \a fileNames
+	void prune(const QSet<QString>& fileNames);
+	void clear();
+	bool isModified() const { return m_modified; }
+
+private:
+	struct Entry
+	{
+		qint64 modified { 0 };
+		QImage image;
+	};
+	QHash<QString, Entry> m_entries;
+	bool m_modified { false };
+};
 
 class SCRIBUS_API BibView : public QListWidget
 {
@@ -33,7 +65,7 @@ class SCRIBUS_API BibView : public QListWidget
 
 public:
 	BibView( QWidget* parent);
-	~BibView() {};
+	~BibView();
 
 	void addObject(const QString& name, const QString& daten, const QPixmap& Bild, bool isDir = false, bool isRaster = false, bool isVector = false);
 	void checkForImg(const QDomElement& elem, bool &hasImage);
@@ -56,6 +88,9 @@ public:
 	QString visibleName;
 	bool canWrite { true };
 
+	//! Stops generating pending previews
+	void stopPreviewGeneration();
+
 signals:
 	void objDropped(QString text);
 	void fileDropped(QString path, int testResult);
@@ -66,6 +101,59 @@ protected:
 	void dragMoveEvent(QDragMoveEvent *e) override;
 	void dropEvent(QDropEvent *e) override;
 	void startDrag(Qt::DropActions supportedActions) override;
+
+private slots:
+	void generateNextPreviews();
+	void setGeneratedPreview(int generation, const QString& name, const QImage& image);
+	void previewThreadFinished();
+
+private:
+	//! Entry whose preview has to be generated
+	struct PendingPreview
+	{
+		QString name;
+		QString path;
+		QString fileName;
+		qint64 modified { 0 };
+		bool isVector { false };
+	};
+
+	QIcon previewIcon(QPixmap& preview) const;
+	void setPreview(const QString& name, const QImage& image);
+	void saveCacheIfDone();
+
+	QString m_dirPath;
+	ScrapbookPreviewCache m_previewCache;
+	QList<PendingPreview> m_pendingPreviews;
+	QHash<QString, PendingPreview> m_threadPreviews;
+	QTimer m_previewTimer;
+	ScrapbookPreviewThread* m_previewThread { nullptr };
+	int m_previewGeneration { 0 };
+};
+
+/*! Thread creating the thumbnails of raster images of a scrapbook directory */
+class SCRIBUS_API ScrapbookPreviewThread : public QThread
+{
+	Q_OBJECT
+
+public:
+	struct Job
+	{
+		QString name;
+		QString path;
+	};
+
+	ScrapbookPreviewThread(int generation, const QList<Job>& jobs, QObject* parent = nullptr);
+
+signals:
+	void previewReady(int generation, const QString& name, const QImage& image);
+
+protected:
+	void run() override;
+
+private:
+	int m_generation { 0 };
+	QList<Job> m_jobs;
 };
 
 class SCRIBUS_API Biblio : public DockPanelBase
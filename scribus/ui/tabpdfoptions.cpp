@@ -215,6 +215,7 @@ TabPDFOptions::TabPDFOptions(QWidget* parent, PDFOptions & Optionen,
 	Compression->setToolTip( "<qt>" + tr( "Enables lossless compression of text and graphics. Unless you have a reason, leave this checked. This reduces PDF file size." ) + "</qt>" );
 	CMethod->setToolTip( "<qt>" + tr( "Method of compression to use for images. Automatic allows Scribus to choose the best method. ZIP is lossless and good for images with solid colors. JPEG is better at creating smaller PDF files which have many photos (with slight image quality loss possible). Leave it set to Automatic unless you have a need for special compression options." ) + "</qt>");
 	CQuality->setToolTip( "<qt>" + tr( "Compression quality levels for lossy compression methods: Minimum (25%), Low (50%), Medium (75%), High (85%), Maximum (95%). Note that a quality level does not directly determine the size of the resulting image - both size and quality loss vary from image to image at any given quality level. Even with Maximum selected, there is always some quality loss with jpeg." ) + "</qt>");
+	CLevel->setToolTip( "<qt>" + tr( "Trade-off between export speed and file size for lossless (ZIP) compression of text, vector graphics, fonts and images. Large streams are compressed on all processor cores at every level." ) + "</qt>");
 	DSColor->setToolTip( "<qt>" + tr( "Limits the resolution of your bitmap images to the selected DPI. Images with a lower resolution will be left untouched. Leaving this unchecked will render them at their native resolution. Enabling this will increase memory usage and slow down export." ) + "</qt>" );
 	ValC->setToolTip( "<qt>" + tr( "DPI (Dots Per Inch) for image export") + "</qt>" );
 
@@ -360,6 +361,7 @@ void TabPDFOptions::restoreDefaults(const PDFOptions & Optionen,
 	Compression->setChecked( Opts.Compress );
 	CMethod->setCurrentIndex(Opts.CompressMethod);
 	CQuality->setCurrentIndex(Opts.Quality);
+	CLevel->setCurrentIndex(Opts.CompressionLevel);
 	if (Opts.CompressMethod == 3)
 		CQuality->setEnabled(false);
 	DSColor->setChecked(Opts.RecalcPic);
@@ -653,6 +655,7 @@ void TabPDFOptions::storeValues(PDFOptions& pdfOptions) const
 	pdfOptions.Compress = Compression->isChecked();
 	pdfOptions.CompressMethod = (PDFOptions::PDFCompression) CMethod->currentIndex();
 	pdfOptions.Quality = CQuality->currentIndex();
+	pdfOptions.CompressionLevel = (PDFOptions::PDFCompressionLevel) CLevel->currentIndex();
 	pdfOptions.Resolution = Resolution->value();
 	pdfOptions.RecalcPic = DSColor->isChecked();
 	pdfOptions.PicRes = ValC->value();
@@ -326,6 +326,8 @@ void UndoManager::clearStack()
 
 void UndoManager::action(UndoObject* target, UndoState* state, QPixmap *targetPixmap)
 {
+	target->markChanged();
+
 	QPixmap *oldIcon = nullptr;
 	if (targetPixmap)
 	{
@@ -28,6 +28,7 @@ for which a new license (GPL+exception) is in place.
 #include "undostate.h"
 
 ulong UndoObject::m_nextId = 1;
+quint64 UndoObject::m_nextRevision = 1;
 
 
 UndoObject::UndoObject() 
@@ -36,6 +37,7 @@ UndoObject::UndoObject()
 	m_id = m_nextId;
 	++m_nextId;
 	m_upixmap = nullptr;
+	markChanged();
 }
 
 UndoObject::UndoObject(const UndoObject& other)
@@ -44,6 +46,7 @@ UndoObject::UndoObject(const UndoObject& other)
 	m_id = other.m_id;
 	m_uname = other.m_uname;
 	m_upixmap = other.m_upixmap;
+	markChanged();
 }
 
 UndoObject::UndoObject(const QString &objectName, QPixmap *objectIcon) 
@@ -53,6 +56,7 @@ UndoObject::UndoObject(const QString &objectName, QPixmap *objectIcon)
 	++m_nextId;
 	m_uname = objectName;
 	m_upixmap = objectIcon;
+	markChanged();
 }
 
 UndoObject::~UndoObject()
@@ -90,6 +94,12 @@ const ScGuardedPtr<UndoObject>& UndoObject::undoObjectPtr() const
 	return m_objectPtr;
 }
 
+void UndoObject::markChanged()
+{
+	m_changeRevision = m_nextRevision;
+	++m_nextRevision;
+}
+
 int UndoObject::undoStateCount() const
 {
 	if (m_objectPtr.refCount() > 1)
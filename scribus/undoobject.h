@@ -114,6 +114,21 @@ public:
 	 */
 	int undoStateCount() const;
 
+	/**
+	 * @brief Returns a number changed each time an action is recorded or restored for this object
+	 *
+	 * Revisions are unique for the whole application, an incremental saver can
+	 * compare the revision of an object with the one it last wrote.
+	 */
+	quint64 changeRevision() const { return m_changeRevision; }
+
+	/**
+	 * @brief Gives the object a new change revision
+	 *
+	 * Called by the undo system, and by code modifying the object without recording an action.
+	 */
+	void markChanged();
+
 	/**
 	 * @brief Method used when an undo/redo is requested.
 	 * 
@@ -128,9 +143,14 @@ public:
 private:
 	/** @brief id number to be used with the next UndoObject */
 	static ulong m_nextId;
+	/** @brief revision to be used with the next change */
+	static quint64 m_nextRevision;
 	
 	/** @brief unique id number */
 	ulong m_id { 1 };
+
+	/** @brief revision of the last change */
+	quint64 m_changeRevision { 0 };
 	
 	/**
 	 * @brief Name of the UndoObject
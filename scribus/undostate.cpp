@@ -68,14 +68,18 @@ void UndoState::setPixmap(QPixmap *pixmap)
 
 void UndoState::undo()
 {
-	if (m_undoObject) // if !m_undoObject there's an error, hmmm
-		m_undoObject->restore(this, true);
+	if (!m_undoObject) // if !m_undoObject there's an error, hmmm
+		return;
+	m_undoObject->markChanged();
+	m_undoObject->restore(this, true);
 }
 
 void UndoState::redo()
 {
-	if (m_undoObject)
-		m_undoObject->restore(this, false);
+	if (!m_undoObject)
+		return;
+	m_undoObject->markChanged();
+	m_undoObject->restore(this, false);
 }
 
 void UndoState::setUndoObject(UndoObject *object)
@@ -6,9 +6,8 @@ using PendingUpdate = QPair<UpdateManaged*, UpdateMemento*>;
 
 UpdateManager::~UpdateManager()
 {
-	foreach(PendingUpdate pair, m_pending) {
+	for (const PendingUpdate& pair : std::as_const(m_pending))
 		delete pair.second;
-	}
 }
 	
 void UpdateManager::setUpdatesEnabled(bool val)
@@ -19,10 +18,11 @@ void UpdateManager::setUpdatesEnabled(bool val)
 		{
 			if (--m_updatesDisabled == 0)
 			{
-				foreach(PendingUpdate pair, m_pending) {
+				QList<PendingUpdate> pending;
+				pending.swap(m_pending);
+				m_pendingSubjects.clear();
+				for (const PendingUpdate& pair : std::as_const(pending))
 					pair.first->updateNow(pair.second);
-				}
-				m_pending.clear();
 			}
 		}
 	}
@@ -35,7 +35,37 @@ void UpdateManager::setUpdatesEnabled(bool val)
 bool UpdateManager::requestUpdate(UpdateManaged* observable, UpdateMemento* what)
 {
 	if (m_updatesDisabled == 0)
-		return true;	
-	m_pending.insert(PendingUpdate(observable, what));
+		return true;
+	const void* subject = what->subject();
+	if (subject != nullptr)
+	{
+		QPair<UpdateManaged*, const void*> key(observable, subject);
+		UpdateMemento* pending = m_pendingSubjects.value(key, nullptr);
+		if (pending != nullptr)
+		{
+			pending->merge(what);
+			delete what;
+			return false;
+		}
+		m_pendingSubjects.insert(key, what);
+	}
+	m_pending.append(PendingUpdate(observable, what));
 	return false;
 }
+
+void UpdateManager::cancelUpdates(const void* subject)
+{
+	if (m_pending.isEmpty() || subject == nullptr)
+		return;
+	for (auto it = m_pending.begin(); it != m_pending.end(); )
+	{
+		if (it->second->subject() == subject)
+		{
+			m_pendingSubjects.remove(QPair<UpdateManaged*, const void*>(it->first, subject));
+			delete it->second;
+			it = m_pending.erase(it);
+		}
+		else
+			++it;
+	}
+}
@@ -18,6 +18,9 @@
 
 #include "scribusapi.h"
 
+#include <QHash>
+#include <QList>
+#include <QPair>
 #include <QSet>
 
 
@@ -29,6 +32,16 @@
 struct SCRIBUS_API UpdateMemento
 {
 	virtual ~UpdateMemento() = default;
+
+	/**
+	  Object the update is about. Pending updates of the same observable
+	  about the same non null subject are merged into a single notification.
+	 */
+	virtual const void* subject() const { return nullptr; }
+	/**
+	  Merges a later pending update about the same subject into this one.
+	 */
+	virtual void merge(const UpdateMemento* /*later*/) {}
 };
 
 
@@ -66,7 +79,8 @@ public:
 class SCRIBUS_API UpdateManager
 {
 	int m_updatesDisabled {0};
-	QSet<QPair<UpdateManaged*, UpdateMemento*> > m_pending;
+	QList<QPair<UpdateManaged*, UpdateMemento*> > m_pending;
+	QHash<QPair<UpdateManaged*, const void*>, UpdateMemento*> m_pendingSubjects;
 	
 public:
 	UpdateManager() = default;
@@ -79,6 +93,10 @@ public:
 		Returns true if updates are enabled, otherwise stores 'observable' for notification when updates get enabled again.
 	 */
 	bool requestUpdate(UpdateManaged* observable, UpdateMemento* what);
+	/**
+		Drops pending updates about 'subject', to be called before the subject gets deleted.
+	 */
+	void cancelUpdates(const void* subject);
 };
 
 
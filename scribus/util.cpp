@@ -38,6 +38,7 @@ for which a new license (GPL+exception) is in place.
 #include "scribusview.h"
 #include "scribusdoc.h"
 #include "scpainter.h"
+#include "scparalleldeflate.h"
 #include "ui/scmessagebox.h"
 
 #include <csignal>
@@ -267,19 +268,11 @@ QString CompressStr(QString *in)
 	return out;
 }
 
-QByteArray CompressArray(const QByteArray& in)
+QByteArray CompressArray(const QByteArray& in, int level)
 {
-	QByteArray out;
-	uLong exlen = uint(in.size() * 0.001 + 16) + in.size();
-	QByteArray temp(exlen, ' ');
-	int errcode = compress2((Byte*) temp.data(), &exlen, (const Byte*) in.data(), uLong(in.size()), 9);
-	if (errcode == Z_OK)
-	{
-		temp.resize(exlen);
-		out = temp;
-	}
-	else
-		qDebug("compress2 failed with code %i", errcode);
+	QByteArray out = ScParallelDeflate::compress(in, ScParallelDeflate::ZlibFormat, level);
+	if (out.isEmpty())
+		qDebug("CompressArray failed");
 	return out;
 }
 